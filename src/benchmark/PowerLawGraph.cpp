@@ -0,0 +1,54 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PowerLawGraph.h"
+#include <algorithm>
+#include <cmath>
+
+namespace triton {
+
+  PowerLawGraph::PowerLawGraph(uint64_t node_count, uint64_t relationship_count, double exponent, uint64_t seed) : node_count(node_count) {
+    // Chung Lu model, node i is picked with a weight of (i + 1) ^ (-1 / (exponent - 1)) for both ends
+    cumulative_weights.reserve(node_count);
+    double total = 0.0;
+    for (uint64_t node = 0; node < node_count; node++) {
+      total += std::pow(static_cast<double>(node + 1), -1.0 / (exponent - 1.0));
+      cumulative_weights.push_back(total);
+    }
+
+    std::mt19937_64 random(seed);
+    relationships.reserve(relationship_count);
+    while (node_count > 1 && relationships.size() < relationship_count) {
+      uint64_t from = sample(random);
+      uint64_t to = sample(random);
+      if (from != to) {
+        relationships.emplace_back(from, to);
+      }
+    }
+  }
+
+  std::string PowerLawGraph::key(uint64_t node) {
+    return "node" + std::to_string(node);
+  }
+
+  uint64_t PowerLawGraph::sample(std::mt19937_64 &random) const {
+    // Turn the 64 random bits into a double ourselves, the standard distributions differ between libraries
+    double point = static_cast<double>(random() >> 11U) * 0x1.0p-53 * cumulative_weights.back();
+    auto found = std::upper_bound(std::begin(cumulative_weights), std::end(cumulative_weights), point);
+    return std::min(static_cast<uint64_t>(found - std::begin(cumulative_weights)), node_count - 1);
+  }
+
+}// namespace triton
@@ -0,0 +1,45 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRITON_POWERLAWGRAPH_H
+#define TRITON_POWERLAWGRAPH_H
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace triton {
+  // A synthetic graph whose node degrees follow a power law, the same arguments always give the same graph.
+  // Nodes are numbered from zero, node 0 has the highest expected degree and it falls off from there.
+  class PowerLawGraph {
+  public:
+    PowerLawGraph(uint64_t node_count, uint64_t relationship_count, double exponent = 2.1, uint64_t seed = 42);
+
+    uint64_t node_count;
+    std::vector<std::pair<uint64_t, uint64_t>> relationships;// Starting and ending node of each relationship
+
+    static std::string key(uint64_t node);
+
+  private:
+    std::vector<double> cumulative_weights;
+
+    uint64_t sample(std::mt19937_64 &random) const;
+  };
+}// namespace triton
+
+#endif//TRITON_POWERLAWGRAPH_H
@@ -0,0 +1,137 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../PowerLawGraph.h"
+#include "../../main/server/JSON.h"
+#include <Graph.h>
+#include <algorithm>
+#include <boost/range/irange.hpp>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <seastar/core/app-template.hh>
+#include <seastar/core/semaphore.hh>
+#include <seastar/core/thread.hh>
+
+namespace bpo = boost::program_options;
+using namespace triton;
+
+// Runs the operation the given number of times with up to concurrency of them in flight, then prints its throughput and latencies
+template <typename Operation>
+static void measure(const std::string& name, uint64_t iterations, uint64_t concurrency, Operation operation) {
+  std::vector<uint64_t> latencies(iterations);
+  seastar::semaphore in_flight(concurrency);
+  auto start = std::chrono::steady_clock::now();
+  seastar::parallel_for_each(boost::irange<uint64_t>(0, iterations), [&] (uint64_t iteration) {
+    return seastar::with_semaphore(in_flight, 1, [&, iteration] {
+      auto began = std::chrono::steady_clock::now();
+      return operation(iteration).then([&, iteration, began] {
+        latencies[iteration] = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - began).count();
+      });
+    });
+  }).get();
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::sort(std::begin(latencies), std::end(latencies));
+  auto percentile = [&latencies] (double fraction) {
+    return latencies.empty() ? 0 : latencies[std::min(latencies.size() - 1, static_cast<size_t>(fraction * latencies.size()))];
+  };
+  std::cout << std::left << std::setw(36) << name << std::right
+            << std::setw(12) << static_cast<uint64_t>(iterations / seconds) << " ops/s"
+            << std::setw(10) << percentile(0.5) << " p50 us"
+            << std::setw(10) << percentile(0.99) << " p99 us"
+            << std::setw(10) << (latencies.empty() ? 0 : latencies.back()) << " max us" << '\n';
+}
+
+int main(int argc, char** argv) {
+  Graph graph("benchmark");
+  seastar::app_template app;
+
+  app.add_options()("nodes", bpo::value<uint64_t>()->default_value(100000), "Nodes of the synthetic graph");
+  app.add_options()("relationships", bpo::value<uint64_t>()->default_value(1000000), "Relationships of the synthetic graph");
+  app.add_options()("exponent", bpo::value<double>()->default_value(2.1), "Exponent of the power law of the node degrees");
+  app.add_options()("seed", bpo::value<uint64_t>()->default_value(42), "Seed of the graph and of the nodes each operation picks");
+  app.add_options()("iterations", bpo::value<uint64_t>()->default_value(10000), "Times each operation runs");
+  app.add_options()("concurrency", bpo::value<uint64_t>()->default_value(64), "Operations in flight at once");
+  app.add_options()("lua_vms", bpo::value<uint16_t>()->default_value(4), "Lua VMs per core");
+
+  return app.run(argc, argv, [&] {
+    return seastar::async([&] {
+      auto&& config = app.configuration();
+      uint64_t iterations = config["iterations"].as<uint64_t>();
+      uint64_t concurrency = std::max(config["concurrency"].as<uint64_t>(), uint64_t(1));
+      uint64_t seed = config["seed"].as<uint64_t>();
+      graph.start(static_cast<uint8_t>(std::clamp(config["lua_vms"].as<uint16_t>(), uint16_t(1), uint16_t(255)))).get();
+      Shard& shard = graph.shard.local();
+
+      // Load the same graph every run, in batches so no single message gets too big
+      PowerLawGraph power_law(config["nodes"].as<uint64_t>(), config["relationships"].as<uint64_t>(), config["exponent"].as<double>(), seed);
+      const uint64_t batch_size = 10000;
+      auto loading = std::chrono::steady_clock::now();
+      for (uint64_t first = 0; first < power_law.node_count; first += batch_size) {
+        std::vector<std::tuple<std::string, std::string, std::map<std::string, std::any>>> rows;
+        for (uint64_t node = first; node < std::min(first + batch_size, power_law.node_count); node++) {
+          rows.emplace_back("Node", PowerLawGraph::key(node), std::map<std::string, std::any>({{"age", std::any(int64_t(node % 100))}}));
+        }
+        shard.NodesAddPeered(std::move(rows)).get();
+      }
+      for (uint64_t first = 0; first < power_law.relationships.size(); first += batch_size) {
+        std::vector<std::tuple<std::string, std::string, std::string, std::string, std::string, std::map<std::string, std::any>>> rows;
+        for (uint64_t position = first; position < std::min(first + batch_size, static_cast<uint64_t>(power_law.relationships.size())); position++) {
+          const auto& [from, to] = power_law.relationships[position];
+          rows.emplace_back("KNOWS", "Node", PowerLawGraph::key(from), "Node", PowerLawGraph::key(to), std::map<std::string, std::any>());
+        }
+        shard.RelationshipsAddPeered(std::move(rows)).get();
+      }
+      std::cout << "Loaded " << power_law.node_count << " nodes and " << power_law.relationships.size() << " relationships on "
+                << seastar::smp::count << " cores in " << std::chrono::duration<double>(std::chrono::steady_clock::now() - loading).count() << " s\n";
+
+      // Every operation asks about the same nodes in the same order, picked from the ends of the relationships so hubs come up often
+      std::vector<std::string> keys;
+      keys.reserve(iterations);
+      std::mt19937_64 random(seed);
+      for (uint64_t iteration = 0; iteration < iterations && !power_law.relationships.empty(); iteration++) {
+        keys.push_back(PowerLawGraph::key(power_law.relationships[random() % power_law.relationships.size()].first));
+      }
+      iterations = keys.size();
+
+      measure("NodeGetNeighborsPeered", iterations, concurrency, [&] (uint64_t iteration) {
+        return shard.NodeGetNeighborsPeered("Node", keys[iteration]).discard_result();
+      });
+
+      measure("NodeGetNeighborsPeered to JSON", iterations, concurrency, [&] (uint64_t iteration) {
+        return shard.NodeGetNeighborsPeered("Node", keys[iteration]).then([&] (std::vector<Node> nodes) {
+          json_entities_builder json(graph, nodes.size());
+          for (Node& node : nodes) {
+            json.add(node);
+          }
+          return json.as_json().size();
+        }).discard_result();
+      });
+
+      measure("AllNodesPeered", iterations, concurrency, [&] (uint64_t iteration) {
+        return shard.AllNodesPeered(iteration * 100 % std::max(power_law.node_count, uint64_t(1)), 100).discard_result();
+      });
+
+      measure("RunLua", iterations, concurrency, [&] (uint64_t iteration) {
+        std::string script = R"({"script": "NodeGetDegree(\"Node\", params.key)", "params": {"key": ")" + keys[iteration] + R"("}})";
+        return shard.RunLua(script).discard_result();
+      });
+
+      graph.stop().get();
+    });
+  });
+}
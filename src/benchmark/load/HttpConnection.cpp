@@ -0,0 +1,110 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "HttpConnection.h"
+#include <boost/algorithm/string.hpp>
+
+namespace triton {
+
+  HttpConnection::HttpConnection(seastar::connected_socket socket) : socket(std::move(socket)) {
+    in = this->socket.input();
+    out = this->socket.output();
+  }
+
+  uint16_t HttpConnection::send(const std::string &method, const std::string &path, const std::string &body) {
+    std::string request = method + " " + path + " HTTP/1.1\r\nHost: triton\r\nContent-Type: application/json\r\nContent-Length: "
+                          + std::to_string(body.size()) + "\r\n\r\n" + body;
+    try {
+      out.write(request).get();
+      out.flush().get();
+
+      // Status line, then the headers up to the empty line
+      std::string line;
+      if (!readLine(line) || line.size() < 12) {
+        return 0;
+      }
+      auto status = static_cast<uint16_t>(std::stoi(line.substr(9, 3)));
+      size_t content_length = 0;
+      bool chunked = false;
+      while (readLine(line) && !line.empty()) {
+        std::string header = boost::algorithm::to_lower_copy(line);
+        if (boost::algorithm::starts_with(header, "content-length:")) {
+          content_length = std::stoull(header.substr(15));
+        } else if (boost::algorithm::starts_with(header, "transfer-encoding:") && header.find("chunked") != std::string::npos) {
+          chunked = true;
+        }
+      }
+
+      // Only the timing matters, so the body is read and thrown away
+      if (!chunked) {
+        return skip(content_length) ? status : 0;
+      }
+      while (readLine(line)) {
+        size_t chunk = std::stoull(line, nullptr, 16);
+        if (!skip(chunk) || !readLine(line)) {
+          return 0;
+        }
+        if (chunk == 0) {
+          return status;
+        }
+      }
+    } catch (...) {
+      // A broken connection or a reply we could not parse
+    }
+    return 0;
+  }
+
+  void HttpConnection::close() {
+    try {
+      out.close().get();
+      in.close().get();
+    } catch (...) {
+      // The server may have gone first
+    }
+  }
+
+  bool HttpConnection::fill() {
+    seastar::temporary_buffer<char> data = in.read().get0();
+    if (data.empty()) {
+      return false;
+    }
+    buffered.append(data.get(), data.size());
+    return true;
+  }
+
+  bool HttpConnection::readLine(std::string &line) {
+    size_t end;
+    while ((end = buffered.find("\r\n")) == std::string::npos) {
+      if (!fill()) {
+        return false;
+      }
+    }
+    line = buffered.substr(0, end);
+    buffered.erase(0, end + 2);
+    return true;
+  }
+
+  bool HttpConnection::skip(size_t count) {
+    while (buffered.size() < count) {
+      if (!fill()) {
+        return false;
+      }
+    }
+    buffered.erase(0, count);
+    return true;
+  }
+
+}// namespace triton
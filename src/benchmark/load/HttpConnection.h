@@ -0,0 +1,46 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRITON_HTTPCONNECTION_H
+#define TRITON_HTTPCONNECTION_H
+
+#include <seastar/core/iostream.hh>
+#include <seastar/net/api.hh>
+#include <string>
+
+namespace triton {
+  // A keep alive HTTP/1.1 client connection that sends one request at a time, its calls must run in a seastar thread
+  class HttpConnection {
+  public:
+    explicit HttpConnection(seastar::connected_socket socket);
+
+    // Sends the request and reads the whole reply, returns its status or 0 when the connection is broken
+    uint16_t send(const std::string &method, const std::string &path, const std::string &body);
+    void close();
+
+  private:
+    seastar::connected_socket socket;
+    seastar::input_stream<char> in;
+    seastar::output_stream<char> out;
+    std::string buffered;// Read from the socket but not yet parsed
+
+    bool fill();
+    bool readLine(std::string &line);
+    bool skip(size_t count);
+  };
+}// namespace triton
+
+#endif//TRITON_HTTPCONNECTION_H
@@ -0,0 +1,107 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Workload.h"
+#include <fstream>
+
+namespace triton {
+
+  void EndpointStats::merge(const EndpointStats &other) {
+    errors += other.errors;
+    latencies.insert(std::end(latencies), std::begin(other.latencies), std::end(other.latencies));
+  }
+
+  Workload::Workload(const std::string &graph, const PowerLawGraph &power_law, std::vector<std::string> lua_scripts,
+                     double read_ratio, double bulk_ratio, uint64_t bulk_size, uint32_t client_id) :
+        prefix("/db/" + graph), power_law(power_law), lua_scripts(std::move(lua_scripts)), read_ratio(read_ratio),
+        bulk_ratio(bulk_ratio), bulk_size(bulk_size), client_id(client_id) {}
+
+  WorkloadRequest Workload::next(std::mt19937_64 &random) {
+    double roll = uniform(random);
+    if (roll < read_ratio) {
+      // Reads: single nodes, neighbor fan out, degrees and Lua scripts
+      double read = roll / read_ratio;
+      if (read < 0.4) {
+        return {"GET node", "GET", prefix + "/node/Node/" + pick(random), ""};
+      }
+      if (read < 0.7) {
+        return {"GET neighbors", "GET", prefix + "/node/Node/" + pick(random) + "/neighbors?properties=false", ""};
+      }
+      if (read < 0.8 || lua_scripts.empty()) {
+        return {"GET degree", "GET", prefix + "/node/Node/" + pick(random) + "/degree", ""};
+      }
+      return {"POST lua", "POST", prefix + "/lua", lua_scripts[random() % lua_scripts.size()]};
+    }
+
+    // Writes: new nodes, new relationships between existing nodes, property updates and the odd bulk insert
+    double write = (roll - read_ratio) / (1.0 - read_ratio);
+    if (write < bulk_ratio) {
+      std::string body = "[";
+      for (uint64_t row = 0; row < bulk_size; row++) {
+        body += (row ? ",{" : "{") + std::string(R"("type":"Node","key":")") + newKey() + R"(","properties":{"age":)" + std::to_string(random() % 100) + "}}";
+      }
+      body += "]";
+      return {"POST nodes", "POST", prefix + "/nodes", body};
+    }
+    write = (write - bulk_ratio) / (1.0 - bulk_ratio);
+    if (write < 0.4) {
+      return {"POST node", "POST", prefix + "/node/Node/" + newKey(), R"({"age":)" + std::to_string(random() % 100) + "}"};
+    }
+    if (write < 0.8) {
+      return {"POST relationship", "POST", prefix + "/node/Node/" + pick(random) + "/relationship/Node/" + pick(random) + "/KNOWS", "{}"};
+    }
+    return {"PUT properties", "PUT", prefix + "/node/Node/" + pick(random) + "/properties", R"({"visited":)" + std::to_string(random() % 1000) + "}"};
+  }
+
+  std::vector<std::string> Workload::LuaScripts(const std::string &file_name) {
+    std::vector<std::string> scripts;
+    std::ifstream file(file_name);
+    std::string line;
+    std::string script;
+    while (std::getline(file, line)) {
+      if (line.find_first_not_of(" \t\r") == std::string::npos) {
+        if (!script.empty()) {
+          scripts.push_back(script);
+          script.clear();
+        }
+        continue;
+      }
+      script += (script.empty() ? "" : "\n") + line;
+    }
+    if (!script.empty()) {
+      scripts.push_back(script);
+    }
+    return scripts;
+  }
+
+  std::string Workload::pick(std::mt19937_64 &random) const {
+    // Either end of a random relationship, so nodes come up as often as they have relationships
+    if (power_law.relationships.empty()) {
+      return "Max";
+    }
+    const auto& [from, to] = power_law.relationships[random() % power_law.relationships.size()];
+    return PowerLawGraph::key(random() % 2 ? from : to);
+  }
+
+  std::string Workload::newKey() {
+    return "load" + std::to_string(client_id) + "_" + std::to_string(added++);
+  }
+
+  double Workload::uniform(std::mt19937_64 &random) {
+    return static_cast<double>(random() >> 11U) * 0x1.0p-53;
+  }
+
+}// namespace triton
@@ -0,0 +1,71 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRITON_WORKLOAD_H
+#define TRITON_WORKLOAD_H
+
+#include "../PowerLawGraph.h"
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace triton {
+
+  struct WorkloadRequest {
+    std::string endpoint;// What the latencies are reported under
+    std::string method;
+    std::string path;
+    std::string body;
+  };
+
+  struct EndpointStats {
+    uint64_t errors = 0;
+    std::vector<uint32_t> latencies;// Microseconds of each answered request
+
+    void merge(const EndpointStats &other);
+  };
+
+  // Picks the next request of a mixed workload, the nodes asked about follow the degrees of the power law graph so supernodes come up often
+  class Workload {
+  public:
+    Workload(const std::string &graph, const PowerLawGraph &power_law, std::vector<std::string> lua_scripts,
+             double read_ratio, double bulk_ratio, uint64_t bulk_size, uint32_t client_id);
+
+    WorkloadRequest next(std::mt19937_64 &random);
+
+    // The scripts of a file, separated by empty lines
+    static std::vector<std::string> LuaScripts(const std::string &file_name);
+
+  private:
+    std::string prefix;
+    const PowerLawGraph &power_law;
+    std::vector<std::string> lua_scripts;
+    double read_ratio;
+    double bulk_ratio;
+    uint64_t bulk_size;
+    uint32_t client_id;
+    uint64_t added = 0;// Nodes this client created, to give each one its own key
+
+    std::string pick(std::mt19937_64 &random) const;
+    std::string newKey();
+    static double uniform(std::mt19937_64 &random);
+  };
+
+}// namespace triton
+
+#endif//TRITON_WORKLOAD_H
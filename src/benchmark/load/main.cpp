@@ -0,0 +1,201 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "HttpConnection.h"
+#include "Workload.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <seastar/core/app-template.hh>
+#include <seastar/core/seastar.hh>
+#include <seastar/core/sharded.hh>
+#include <seastar/core/thread.hh>
+#include <seastar/net/inet_address.hh>
+
+namespace bpo = boost::program_options;
+using namespace triton;
+
+struct LoadOptions {
+  seastar::socket_address address;
+  std::string graph;
+  uint64_t nodes;
+  uint64_t relationships;
+  double exponent;
+  uint64_t seed;
+  uint64_t connections;
+  uint64_t duration;
+  double read_ratio;
+  double bulk_ratio;
+  uint64_t bulk_size;
+  std::vector<std::string> lua_scripts;
+};
+
+// The client of one core, each of its connections sends one request after the other until the time is up
+class LoadClient {
+public:
+  explicit LoadClient(LoadOptions options) : options(std::move(options)),
+        power_law(this->options.nodes, this->options.relationships, this->options.exponent, this->options.seed) {}
+
+  seastar::future<> run() {
+    return seastar::async([this] {
+      auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(options.duration);
+      std::vector<seastar::future<>> connections;
+      for (uint64_t connection = 0; connection < options.connections; connection++) {
+        connections.push_back(seastar::async([this, connection, deadline] {
+          auto client_id = static_cast<uint32_t>(seastar::this_shard_id() * options.connections + connection);
+          Workload workload(options.graph, power_law, options.lua_scripts, options.read_ratio, options.bulk_ratio, options.bulk_size, client_id);
+          std::mt19937_64 random(options.seed + client_id + 1);
+          HttpConnection http(seastar::connect(options.address).get0());
+          while (std::chrono::steady_clock::now() < deadline) {
+            WorkloadRequest request = workload.next(random);
+            auto start = std::chrono::steady_clock::now();
+            uint16_t status = http.send(request.method, request.path, request.body);
+            EndpointStats &endpoint = stats[request.endpoint];
+            if (status == 0) {
+              endpoint.errors++;
+              break;
+            }
+            if (status >= 400) {
+              endpoint.errors++;
+              continue;
+            }
+            endpoint.latencies.push_back(static_cast<uint32_t>(
+              std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count()));
+          }
+          http.close();
+        }));
+      }
+      seastar::when_all_succeed(std::begin(connections), std::end(connections)).get();
+    });
+  }
+
+  // Loads the power law graph and the nodes the Lua samples ask about with the bulk endpoints
+  seastar::future<> setup() {
+    return seastar::async([this] {
+      HttpConnection http(seastar::connect(options.address).get0());
+      const std::string prefix = "/db/" + options.graph;
+      const uint64_t batch_size = 10000;
+      http.send("POST", prefix + "/nodes", R"([{"type":"Node","key":"Max","properties":{"name":"Max"}},{"type":"Node","key":"Helene","properties":{"name":"Helene"}}])");
+      http.send("POST", prefix + "/node/Node/Max/relationship/Node/Helene/KNOWS", "{}");
+      for (uint64_t first = 0; first < power_law.node_count; first += batch_size) {
+        std::string body = "[";
+        for (uint64_t node = first; node < std::min(first + batch_size, power_law.node_count); node++) {
+          body += (node > first ? ",{" : "{") + std::string(R"("type":"Node","key":")") + PowerLawGraph::key(node)
+                  + R"(","properties":{"name":")" + PowerLawGraph::key(node) + R"(","age":)" + std::to_string(node % 100) + "}}";
+        }
+        http.send("POST", prefix + "/nodes", body + "]");
+      }
+      for (uint64_t first = 0; first < power_law.relationships.size(); first += batch_size) {
+        std::string body = "[";
+        for (uint64_t position = first; position < std::min(first + batch_size, static_cast<uint64_t>(power_law.relationships.size())); position++) {
+          const auto& [from, to] = power_law.relationships[position];
+          body += (position > first ? ",{" : "{") + std::string(R"("rel_type":"KNOWS","type":"Node","key":")") + PowerLawGraph::key(from)
+                  + R"(","type2":"Node","key2":")" + PowerLawGraph::key(to) + R"("})";
+        }
+        http.send("POST", prefix + "/relationships", body + "]");
+      }
+      http.close();
+    });
+  }
+
+  std::map<std::string, EndpointStats> getStats() {
+    return stats;
+  }
+
+  seastar::future<> stop() {
+    return seastar::make_ready_future<>();
+  }
+
+private:
+  LoadOptions options;
+  PowerLawGraph power_law;
+  std::map<std::string, EndpointStats> stats;
+};
+
+int main(int argc, char** argv) {
+  seastar::sharded<LoadClient> clients;
+  seastar::app_template app;
+
+  app.add_options()("address", bpo::value<seastar::sstring>()->default_value("127.0.0.1"), "HTTP Server address");
+  app.add_options()("port", bpo::value<uint16_t>()->default_value(10000), "HTTP Server port");
+  app.add_options()("graph", bpo::value<seastar::sstring>()->default_value("triton"), "Name of the graph");
+  app.add_options()("setup", bpo::value<bool>()->default_value(true), "Load the power law graph before the run");
+  app.add_options()("nodes", bpo::value<uint64_t>()->default_value(100000), "Nodes of the power law graph");
+  app.add_options()("relationships", bpo::value<uint64_t>()->default_value(1000000), "Relationships of the power law graph");
+  app.add_options()("exponent", bpo::value<double>()->default_value(2.1), "Exponent of the power law of the node degrees");
+  app.add_options()("seed", bpo::value<uint64_t>()->default_value(42), "Seed of the graph and of the requests");
+  app.add_options()("connections", bpo::value<uint64_t>()->default_value(16), "Connections per client core");
+  app.add_options()("duration", bpo::value<uint64_t>()->default_value(30), "Seconds to run");
+  app.add_options()("read_ratio", bpo::value<double>()->default_value(0.8), "Share of the requests that are reads");
+  app.add_options()("bulk_ratio", bpo::value<double>()->default_value(0.01), "Share of the writes that are bulk inserts");
+  app.add_options()("bulk_size", bpo::value<uint64_t>()->default_value(100), "Nodes in each bulk insert");
+  app.add_options()("lua_scripts", bpo::value<seastar::sstring>()->default_value("lua_script_samples.txt"), "File of the Lua scripts to mix in, separated by empty lines");
+
+  return app.run(argc, argv, [&] {
+    return seastar::async([&] {
+      auto&& config = app.configuration();
+      LoadOptions options;
+      options.address = seastar::socket_address(seastar::net::inet_address(config["address"].as<seastar::sstring>()), config["port"].as<uint16_t>());
+      options.graph = config["graph"].as<seastar::sstring>();
+      options.nodes = config["nodes"].as<uint64_t>();
+      options.relationships = config["relationships"].as<uint64_t>();
+      options.exponent = config["exponent"].as<double>();
+      options.seed = config["seed"].as<uint64_t>();
+      options.connections = std::max(config["connections"].as<uint64_t>(), uint64_t(1));
+      options.duration = config["duration"].as<uint64_t>();
+      options.read_ratio = std::clamp(config["read_ratio"].as<double>(), 0.0, 1.0);
+      options.bulk_ratio = std::clamp(config["bulk_ratio"].as<double>(), 0.0, 1.0);
+      options.bulk_size = std::max(config["bulk_size"].as<uint64_t>(), uint64_t(1));
+      options.lua_scripts = Workload::LuaScripts(config["lua_scripts"].as<seastar::sstring>());
+
+      clients.start(options).get();
+      if (config["setup"].as<bool>()) {
+        auto loading = std::chrono::steady_clock::now();
+        clients.local().setup().get();
+        std::cout << "Loaded " << options.nodes << " nodes and " << options.relationships << " relationships in "
+                  << std::chrono::duration<double>(std::chrono::steady_clock::now() - loading).count() << " s\n";
+      }
+
+      std::cout << "Running on " << seastar::smp::count << " cores with " << options.connections << " connections each for "
+                << options.duration << " s\n";
+      clients.invoke_on_all([] (LoadClient &client) {
+        return client.run();
+      }).get();
+
+      // Gather every core's latencies, then report each endpoint
+      std::map<std::string, EndpointStats> stats;
+      for (const auto& client_stats : clients.map([] (LoadClient &client) { return client.getStats(); }).get0()) {
+        for (const auto& [endpoint, endpoint_stats] : client_stats) {
+          stats[endpoint].merge(endpoint_stats);
+        }
+      }
+      std::cout << std::left << std::setw(20) << "endpoint" << std::right << std::setw(12) << "requests" << std::setw(10) << "errors"
+                << std::setw(12) << "req/s" << std::setw(10) << "p50 us" << std::setw(10) << "p99 us" << std::setw(10) << "p999 us" << '\n';
+      for (auto& [endpoint, endpoint_stats] : stats) {
+        auto& latencies = endpoint_stats.latencies;
+        std::sort(std::begin(latencies), std::end(latencies));
+        auto percentile = [&latencies] (double fraction) {
+          return latencies.empty() ? 0 : latencies[std::min(latencies.size() - 1, static_cast<size_t>(fraction * latencies.size()))];
+        };
+        std::cout << std::left << std::setw(20) << endpoint << std::right << std::setw(12) << latencies.size() << std::setw(10) << endpoint_stats.errors
+                  << std::setw(12) << latencies.size() / std::max(options.duration, uint64_t(1)) << std::setw(10) << percentile(0.5)
+                  << std::setw(10) << percentile(0.99) << std::setw(10) << percentile(0.999) << '\n';
+      }
+      clients.stop().get();
+    });
+  });
+}
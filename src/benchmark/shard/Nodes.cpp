@@ -0,0 +1,67 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../../lib/graph/Shard.h"
+#include "../PowerLawGraph.h"
+#include <catch2/catch.hpp>
+
+TEST_CASE("Shard node hot paths", "[benchmark]") {
+  // A single shard holding every node of a power law graph, node 0 is the biggest hub
+  triton::Shard shard(1);
+  shard.NodeTypeInsert("Node", 1);
+  shard.RelationshipTypeInsert("KNOWS", 1);
+  triton::PowerLawGraph graph(10000, 100000);
+  std::vector<uint64_t> ids;
+  ids.reserve(graph.node_count);
+  for (uint64_t node = 0; node < graph.node_count; node++) {
+    ids.push_back(shard.NodeAdd("Node", 1, triton::PowerLawGraph::key(node), R"({ "name":"max", "age":42, "weight":230.5 })"));
+  }
+  for (const auto& [from, to] : graph.relationships) {
+    shard.RelationshipAddEmptySameShard(1, ids[from], ids[to]);
+  }
+  uint64_t hub = ids[0];
+  uint64_t tail = ids[graph.node_count - 1];
+  uint64_t added = 0;
+
+  BENCHMARK("NodeAdd") {
+    return shard.NodeAdd("Node", 1, "added" + std::to_string(added++), R"({ "name":"max", "age":42 })");
+  };
+
+  BENCHMARK("NodePropertyGet") {
+    return shard.NodePropertyGet(tail, "age");
+  };
+
+  BENCHMARK("NodePropertyGet by type and key") {
+    return shard.NodePropertyGet("Node", "node9999", "name");
+  };
+
+  BENCHMARK("NodeGetDegree of the hub") {
+    return shard.NodeGetDegree(hub);
+  };
+
+  BENCHMARK("NodeGetDegree of the hub by direction and type") {
+    return shard.NodeGetDegree(hub, OUT, "KNOWS");
+  };
+
+  BENCHMARK("NodeGetShardedNodeIDs of the hub") {
+    return shard.NodeGetShardedNodeIDs(hub);
+  };
+
+  BENCHMARK("NodeGetShardedNodeIDs of a tail node") {
+    return shard.NodeGetShardedNodeIDs(tail);
+  };
+}
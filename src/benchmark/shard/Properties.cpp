@@ -0,0 +1,47 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../../lib/graph/Shard.h"
+#include <catch2/catch.hpp>
+#include <sstream>
+
+TEST_CASE("Shard property conversion and serialization", "[benchmark]") {
+  triton::Shard shard(1);
+  shard.NodeTypeInsert("Node", 1);
+  const std::string properties = R"({ "name":"max", "email":"maxdemarzi@example.com", "age":42, "weight":230.5, "active":true, "tags":["a","b","c"] })";
+  uint64_t id = shard.NodeAdd("Node", 1, "max", properties);
+
+  simdjson::dom::parser parser;
+  simdjson::dom::object object;
+  REQUIRE_FALSE(parser.parse(properties).get(object));
+
+  BENCHMARK("convertProperties") {
+    std::map<std::string, std::any> values;
+    shard.convertProperties(values, object);
+    return values;
+  };
+
+  BENCHMARK("NodeGet") {
+    return shard.NodeGet(id);
+  };
+
+  BENCHMARK("Node to JSON") {
+    std::stringstream out;
+    out << shard.NodeGet(id);
+    return out.str();
+  };
+}
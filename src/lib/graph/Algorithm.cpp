@@ -0,0 +1,133 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Algorithm.h"
+#include <algorithm>
+#include <cmath>
+
+namespace triton {
+
+  Algorithm::Algorithm(AlgorithmKind kind, size_t size) : kind(kind),
+        values(size, kind == AlgorithmKind::PAGERANK ? 1.0 : counting() ? 0.0 : UNREACHED),
+        messages(size, kind == AlgorithmKind::PAGERANK || counting() ? 0.0 : UNREACHED),
+        active(size, 0) {
+    if (counting()) {
+      higher.resize(size);
+      degrees.resize(size, 0);
+    }
+  }
+
+  bool Algorithm::counting() const {
+    return kind == AlgorithmKind::TRIANGLES || kind == AlgorithmKind::CLUSTERING;
+  }
+
+  void Algorithm::receive(uint64_t internal_id, double value) {
+    if (kind == AlgorithmKind::PAGERANK || counting()) {
+      messages[internal_id] += value;
+    } else if (value < messages[internal_id]) {
+      messages[internal_id] = value;
+    }
+  }
+
+  uint64_t Algorithm::update(double damping) {
+    uint64_t changed = 0;
+    if (kind == AlgorithmKind::PAGERANK) {
+      // Every node keeps sending its rank, so only the values move
+      for (size_t i = 0; i < values.size(); i++) {
+        double rank = (1.0 - damping) + damping * messages[i];
+        changed += std::abs(rank - values[i]) > TOLERANCE;
+        values[i] = rank;
+        messages[i] = 0.0;
+      }
+      return changed;
+    }
+
+    // Triangles are only counted once, nothing is left to change
+    if (counting()) {
+      for (size_t i = 0; i < values.size(); i++) {
+        values[i] += messages[i];
+        messages[i] = 0.0;
+      }
+      return changed;
+    }
+
+    // A node that found a shorter distance or a smaller component sends it on next
+    for (size_t i = 0; i < values.size(); i++) {
+      bool smaller = messages[i] < values[i];
+      if (smaller) {
+        values[i] = messages[i];
+        changed++;
+      }
+      active[i] = smaller;
+      messages[i] = UNREACHED;
+    }
+    return changed;
+  }
+
+  double Algorithm::coefficient(uint64_t internal_id) const {
+    double degree = static_cast<double>(degrees[internal_id]);
+    if (degree < 2) {
+      return 0.0;
+    }
+    return 2.0 * values[internal_id] / (degree * (degree - 1));
+  }
+
+  void Algorithm::intersect(const std::vector<uint64_t>& first, const std::vector<uint64_t>& second, std::vector<uint64_t>& common) {
+    const std::vector<uint64_t>& smaller = first.size() <= second.size() ? first : second;
+    const std::vector<uint64_t>& larger = first.size() <= second.size() ? second : first;
+    if (smaller.empty()) {
+      return;
+    }
+
+    if (larger.size() / smaller.size() < GALLOP_RATIO) {
+      auto small = std::begin(smaller);
+      auto large = std::begin(larger);
+      while (small != std::end(smaller) && large != std::end(larger)) {
+        if (*small < *large) {
+          small++;
+        } else if (*large < *small) {
+          large++;
+        } else {
+          common.push_back(*small);
+          small++;
+          large++;
+        }
+      }
+      return;
+    }
+
+    // Doubling steps find a range that holds the next id, a binary search finds it inside the range
+    auto from = std::begin(larger);
+    for (uint64_t id : smaller) {
+      size_t step = 1;
+      auto to = from;
+      while (to != std::end(larger) && *to < id) {
+        from = to;
+        to = static_cast<size_t>(std::end(larger) - to) > step ? to + step : std::end(larger);
+        step *= 2;
+      }
+      from = std::lower_bound(from, to, id);
+      if (from == std::end(larger)) {
+        return;
+      }
+      if (*from == id) {
+        common.push_back(id);
+        from++;
+      }
+    }
+  }
+
+}// namespace triton
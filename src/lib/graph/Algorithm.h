@@ -0,0 +1,59 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRITON_ALGORITHM_H
+#define TRITON_ALGORITHM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace triton {
+
+  enum class AlgorithmKind {
+    PAGERANK, BFS, WCC, TRIANGLES, CLUSTERING
+  };
+
+  // What a shard holds of a running algorithm, flat arrays indexed by the internal id of its nodes
+  class Algorithm {
+  public:
+    Algorithm(AlgorithmKind kind, size_t size);
+    AlgorithmKind kind;
+    std::vector<double> values;// The rank, distance or component of each node
+    std::vector<double> messages;// What each node received this superstep, summed for ranks and the smallest for the others
+    std::vector<uint8_t> active;// The nodes that send in the next superstep
+    std::vector<std::vector<uint64_t>> higher;// Triangles only, the sorted neighbors of each node with larger ids than its own
+    std::vector<uint64_t> degrees;// Triangles only, how many distinct neighbors each node has
+
+    bool counting() const;
+    void receive(uint64_t internal_id, double value);
+    // Folds the messages into the values, returns how many nodes changed
+    uint64_t update(double damping);
+    // The clustering coefficient of a node from its triangles and degree
+    double coefficient(uint64_t internal_id) const;
+
+    // Adds the ids in both sorted lists to common. Gallops through the larger list when the other one is much smaller
+    static void intersect(const std::vector<uint64_t>& first, const std::vector<uint64_t>& second, std::vector<uint64_t>& common);
+
+    inline static const double UNREACHED = std::numeric_limits<double>::infinity();
+    inline static const double TOLERANCE = 1e-9;
+    inline static const size_t GALLOP_RATIO = 32;
+  };
+
+}// namespace triton
+
+#endif//TRITON_ALGORITHM_H
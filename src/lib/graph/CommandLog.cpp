@@ -0,0 +1,254 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CommandLog.h"
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <seastar/core/fstream.hh>
+#include <seastar/core/seastar.hh>
+#include <seastar/util/log.hh>
+
+namespace triton {
+
+  CommandLog::CommandLog() : opened(false), logged(0), position(0), unflushed(0), flush_bytes(0), flush_lock(1), feed_limit(0), feed_size(0), feed_first(0) {}
+
+  bool CommandLog::isOpen() const {
+    return opened;
+  }
+
+  bool CommandLog::recording() const {
+    return opened || feed_limit > 0;
+  }
+
+  seastar::future<> CommandLog::open(const std::string &file_name, uint64_t flush_interval, uint64_t flush_bytes) {
+    return seastar::open_file_dma(file_name, seastar::open_flags::wo | seastar::open_flags::create | seastar::open_flags::truncate)
+      .then([flush_interval, flush_bytes, this] (seastar::file log_file) {
+        file = std::move(log_file);
+        opened = true;
+        position = 0;
+        pending.clear();
+        unflushed = 0;
+        this->flush_bytes = flush_bytes;
+        if (flush_interval > 0) {
+          flush_timer.set_callback([this] {
+            static_cast<void>(flush().handle_exception([] (std::exception_ptr e) { std::cerr << seastar::format("Exception in CommandLog::flush: {}\n", e); }));
+          });
+          flush_timer.arm_periodic(std::chrono::milliseconds(flush_interval));
+        }
+      });
+  }
+
+  seastar::future<> CommandLog::flush() {
+    // Only one write at a time, the next one picks up everything appended in the meantime
+    return seastar::with_semaphore(flush_lock, 1, [this] {
+      if (!opened || unflushed == 0) {
+        return seastar::make_ready_future<>();
+      }
+      return write();
+    });
+  }
+
+  seastar::future<> CommandLog::write() {
+    uint64_t written = unflushed;
+    size_t length = pending.size();
+    size_t alignment = file.disk_write_dma_alignment();
+
+    return write(file, position, pending).then([written, length, alignment, this] {
+      // Keep the unfinished last block, the next write fills in the rest of it
+      size_t full = length / alignment * alignment;
+      pending.erase(0, full);
+      position += full;
+      unflushed -= written;
+    });
+  }
+
+  seastar::future<> CommandLog::write(seastar::file log_file, uint64_t offset, const std::string &data) {
+    size_t length = data.size();
+    if (length == 0) {
+      return log_file.flush();
+    }
+    size_t alignment = log_file.disk_write_dma_alignment();
+    size_t aligned_length = (length + alignment - 1) / alignment * alignment;
+
+    // DMA writes whole blocks, so pad the last one with zeros
+    auto buffer = seastar::temporary_buffer<char>::aligned(log_file.memory_dma_alignment(), aligned_length);
+    std::memcpy(buffer.get_write(), data.data(), length);
+    std::memset(buffer.get_write() + length, 0, aligned_length - length);
+
+    return log_file.dma_write(offset, buffer.get(), aligned_length)
+      .then([buffer = std::move(buffer), log_file] (size_t) mutable {
+        return log_file.flush();
+      });
+  }
+
+  seastar::future<> CommandLog::close() {
+    if (!opened) {
+      return seastar::make_ready_future<>();
+    }
+    flush_timer.cancel();
+    return flush().then([this] {
+      opened = false;
+      return file.close();
+    });
+  }
+
+  seastar::future<> CommandLog::rotate(const std::string &file_name, std::function<void()> at_rotation) {
+    return seastar::with_semaphore(flush_lock, 1, [file_name, at_rotation = std::move(at_rotation), this] {
+      return seastar::open_file_dma(file_name, seastar::open_flags::wo | seastar::open_flags::create | seastar::open_flags::truncate)
+        .then([at_rotation, this] (seastar::file log_file) {
+          // Nothing can be appended between the callback and the switch
+          at_rotation();
+          seastar::file old_file = std::move(file);
+          std::string old_pending = std::move(pending);
+          uint64_t old_position = position;
+          file = std::move(log_file);
+          pending.clear();
+          position = 0;
+          unflushed = 0;
+
+          // Finish the old file, new records wait in pending until the lock is released
+          return write(old_file, old_position, old_pending).then([old_file] () mutable {
+            return old_file.close();
+          });
+        });
+    });
+  }
+
+  void CommandLog::append(const std::string &record) {
+    Serializer serializer(pending);
+    serializer.put(static_cast<uint32_t>(record.size()));
+    serializer.put(checksum(record.data(), record.size()));
+    pending.append(record);
+    unflushed += sizeof(uint32_t) * 2 + record.size();
+
+    if (unflushed >= flush_bytes) {
+      static_cast<void>(flush().handle_exception([] (std::exception_ptr e) { std::cerr << seastar::format("Exception in CommandLog::flush: {}\n", e); }));
+    }
+  }
+
+  void CommandLog::follow(uint64_t bytes) {
+    feed_limit = bytes;
+  }
+
+  uint64_t CommandLog::epoch() const {
+    return logged;
+  }
+
+  void CommandLog::publish(PublishedEpoch* published) {
+    this->published = published;
+    if (published != nullptr) {
+      published->epoch.store(logged, std::memory_order_release);
+    }
+  }
+
+  uint64_t CommandLog::sequence() const {
+    return feed_first + feed.size();
+  }
+
+  bool CommandLog::since(uint64_t sequence, uint64_t max_bytes, Serializer &serializer) const {
+    if (feed_limit == 0 || sequence < feed_first || sequence > this->sequence()) {
+      return false;
+    }
+    // Always at least one record, so a record larger than max_bytes still gets through
+    uint64_t last = sequence;
+    uint64_t bytes = 0;
+    while (last < this->sequence() && (last == sequence || bytes + feed[last - feed_first].size() <= max_bytes)) {
+      bytes += feed[last - feed_first].size();
+      last++;
+    }
+    serializer.put(this->sequence());
+    serializer.put(last - sequence);
+    for (uint64_t position = sequence; position < last; position++) {
+      serializer.put(feed[position - feed_first]);
+    }
+    return true;
+  }
+
+  void CommandLog::keep(std::string record) {
+    feed_size += record.size();
+    feed.push_back(std::move(record));
+    // Replicas further behind than this start over from a snapshot
+    while (feed_size > feed_limit && feed.size() > 1) {
+      feed_size -= feed.front().size();
+      feed.pop_front();
+      feed_first++;
+    }
+  }
+
+  uint32_t CommandLog::checksum(const char *data, size_t size) {
+    // FNV-1a, enough to tell a torn write from a record
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+      hash ^= static_cast<uint8_t>(data[i]);
+      hash *= 16777619u;
+    }
+    return hash;
+  }
+
+  std::map<uint64_t, std::string> CommandLog::files(const std::string &directory, const std::string &file_name) {
+    std::map<uint64_t, std::string> generations;
+    std::error_code error;
+    for (const auto &entry : std::filesystem::directory_iterator(directory, error)) {
+      std::string name = entry.path().filename().string();
+      if (name.size() > file_name.size() + 1 && name.compare(0, file_name.size() + 1, file_name + ".") == 0) {
+        std::string generation = name.substr(file_name.size() + 1);
+        if (generation.find_first_not_of("0123456789") == std::string::npos) {
+          generations.emplace(std::stoull(generation), entry.path().string());
+        }
+      }
+    }
+    return generations;
+  }
+
+  std::string CommandLog::path(const std::string &directory, const std::string &file_name, uint64_t generation) {
+    return (std::filesystem::path(directory) / (file_name + "." + std::to_string(generation))).string();
+  }
+
+  uint64_t CommandLog::replay(const std::string &file_name, const std::function<bool(Command, Deserializer&)> &apply) {
+    seastar::file log_file = seastar::open_file_dma(file_name, seastar::open_flags::ro).get0();
+    seastar::input_stream<char> input = seastar::make_file_input_stream(log_file);
+    uint64_t count = 0;
+
+    while (true) {
+      seastar::temporary_buffer<char> header = input.read_exactly(sizeof(uint32_t) * 2).get0();
+      if (header.size() < sizeof(uint32_t) * 2) {
+        break;
+      }
+      Deserializer header_reader(header.get(), header.size());
+      uint32_t size = header_reader.getUint32();
+      uint32_t sum = header_reader.getUint32();
+      // The zero padding after the last record
+      if (size == 0) {
+        break;
+      }
+      seastar::temporary_buffer<char> record = input.read_exactly(size).get0();
+      // A torn write at the end of the log
+      if (record.size() < size || checksum(record.get(), record.size()) != sum) {
+        break;
+      }
+      Deserializer reader(record.get(), record.size());
+      auto command = static_cast<Command>(reader.getUint8());
+      if (!apply(command, reader)) {
+        break;
+      }
+      count++;
+    }
+
+    input.close().get();
+    return count;
+  }
+}
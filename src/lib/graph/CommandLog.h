@@ -0,0 +1,166 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRITON_COMMANDLOG_H
+#define TRITON_COMMANDLOG_H
+
+#include "Serializer.h"
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <map>
+#include <seastar/core/file.hh>
+#include <seastar/core/future.hh>
+#include <seastar/core/semaphore.hh>
+#include <seastar/core/temporary_buffer.hh>
+#include <seastar/core/timer.hh>
+#include <string>
+
+namespace triton {
+  // The mutations a shard applies to itself, each is replayed by calling the same local method with the logged arguments
+  enum class Command : uint8_t {
+    CLEAR = 1,
+    RELATIONSHIP_TYPE_INSERT,
+    NODE_TYPE_INSERT,
+    NODE_ADD,
+    NODE_REMOVE,
+    NODE_REMOVE_DELETE_INCOMING,
+    NODE_REMOVE_DELETE_OUTGOING,
+    NODE_PROPERTY_SET,
+    NODE_PROPERTY_DELETE,
+    NODE_PROPERTIES_RESET,
+    NODE_PROPERTIES_DELETE,
+    RELATIONSHIP_ADD_SAME_SHARD,
+    RELATIONSHIP_ADD_TO_OUTGOING,
+    RELATIONSHIP_ADD_TO_INCOMING,
+    RELATIONSHIP_REMOVE_GET_INCOMING,
+    RELATIONSHIP_REMOVE_INCOMING,
+    RELATIONSHIP_PROPERTY_SET,
+    RELATIONSHIP_PROPERTY_DELETE,
+    RELATIONSHIP_PROPERTIES_RESET,
+    RELATIONSHIP_PROPERTIES_DELETE,
+    NODE_PROPERTY_INDEX_CREATE,
+    NODE_PROPERTY_INDEX_DROP,
+    NODE_PLACE,
+    NODE_REMOVE_TAKE_OUTGOING,
+    NODE_REMOVE_TAKE_INCOMING,
+    NODES_REMOVE_DELETE_INCOMING,
+    NODES_REMOVE_DELETE_OUTGOING,
+    NODE_VECTOR_PROPERTY_CREATE,
+    RELATIONSHIP_RECENCY_INDEX_CREATE,
+    RELATIONSHIP_RECENCY_INDEX_DROP
+  };
+
+  // Append only log of the commands of one shard.
+  // Records are buffered in memory and written with group commit: every flush writes and syncs all the records appended
+  // so far, so writes are acknowledged before they are durable and at most flush_interval milliseconds or flush_bytes
+  // bytes of them can be lost in a crash.
+  // Each record is [size][checksum][command][arguments], a torn or zeroed record marks the end of the log.
+  // The epoch of a command log where the other shards can read it, alone on its cache line so writing it does not slow them down
+  struct alignas(64) PublishedEpoch {
+    std::atomic<uint64_t> epoch{0};
+  };
+
+  class CommandLog {
+  public:
+    CommandLog();
+
+    [[nodiscard]] bool isOpen() const;
+
+    // True when records are written to the file or kept for replicas, so callers can skip building arguments nobody reads
+    [[nodiscard]] bool recording() const;
+
+    seastar::future<> open(const std::string &file_name, uint64_t flush_interval, uint64_t flush_bytes);
+
+    seastar::future<> flush();
+
+    seastar::future<> close();
+
+    // Switch to a new file, at_rotation runs at the moment the old one stops taking records
+    seastar::future<> rotate(const std::string &file_name, std::function<void()> at_rotation);
+
+    template <typename... Args>
+    void log(Command command, const Args&... args) {
+      logged++;
+      if (published != nullptr) {
+        published->epoch.store(logged, std::memory_order_release);
+      }
+      if (!opened && feed_limit == 0) {
+        return;
+      }
+      std::string record;
+      Serializer serializer(record);
+      serializer.put(static_cast<uint8_t>(command));
+      (serializer.put(args), ...);
+      if (opened) {
+        append(record);
+      }
+      if (feed_limit > 0) {
+        keep(std::move(record));
+      }
+    }
+
+    // Commands logged since the shard started, whether or not they were kept anywhere, so it changes whenever the shard does
+    [[nodiscard]] uint64_t epoch() const;
+
+    // Keep the epoch in published as well, for the other shards to read without asking
+    void publish(PublishedEpoch* published);
+
+    // Keep about the last bytes of records in memory for replicas to follow, whether or not the log is open
+    void follow(uint64_t bytes);
+
+    // Records logged since following started, the next record gets this sequence
+    [[nodiscard]] uint64_t sequence() const;
+
+    // Puts the next sequence, a count and the records from sequence on, up to about max_bytes of them.
+    // False when following is off or the records are no longer kept
+    bool since(uint64_t sequence, uint64_t max_bytes, Serializer &serializer) const;
+
+    // Logs are named file_name.generation, a new generation is started every time the shard starts or takes a snapshot
+    static std::map<uint64_t, std::string> files(const std::string &directory, const std::string &file_name);
+
+    static std::string path(const std::string &directory, const std::string &file_name, uint64_t generation);
+
+    // Calls apply with every intact record until it returns false, must run in a seastar thread
+    static uint64_t replay(const std::string &file_name, const std::function<bool(Command, Deserializer&)> &apply);
+
+    static uint32_t checksum(const char *data, size_t size);
+
+  private:
+    seastar::file file;
+    bool opened;
+    uint64_t logged;
+    PublishedEpoch* published = nullptr;
+    uint64_t position;           // Aligned offset of the start of pending in the file
+    std::string pending;         // The unfinished last block on disk followed by the records not yet written
+    uint64_t unflushed;          // Bytes appended since the last flush
+    uint64_t flush_bytes;
+    seastar::timer<> flush_timer;
+    seastar::semaphore flush_lock;
+
+    uint64_t feed_limit;         // Bytes of records kept for replicas, zero when not following
+    uint64_t feed_size;
+    uint64_t feed_first;         // Sequence of the first record kept
+    std::deque<std::string> feed;
+
+    void append(const std::string &record);
+    void keep(std::string record);
+    seastar::future<> write();
+    static seastar::future<> write(seastar::file log_file, uint64_t offset, const std::string &data);
+  };
+}
+
+#endif//TRITON_COMMANDLOG_H
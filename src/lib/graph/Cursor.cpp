@@ -0,0 +1,57 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Cursor.h"
+#include <sstream>
+
+namespace triton {
+  Cursor::Cursor() : shard(0), type_id(0), id(0), view(0), finished(false) {}
+
+  Cursor::Cursor(uint16_t shard, uint16_t type_id, uint64_t id, uint64_t view) : shard(shard), type_id(type_id), id(id), view(view), finished(false) {}
+
+  std::string Cursor::toString() const {
+    if (finished) {
+      return "";
+    }
+    std::stringstream out;
+    out << std::hex << shard << "-" << type_id << "-" << id;
+    // Scans of the live graph keep the shorter form
+    if (view > 0) {
+      out << "-" << view;
+    }
+    return out.str();
+  }
+
+  bool Cursor::fromString(const std::string &value, Cursor &cursor) {
+    if (value == "0") {
+      cursor = Cursor();
+      return true;
+    }
+    std::stringstream in(value);
+    uint64_t shard, type_id, id, view = 0;
+    char first, second, third = '-';
+    in >> std::hex >> shard >> first >> type_id >> second >> id;
+    if (!in.fail() && !in.eof()) {
+      in >> third >> view;
+    }
+    if (in.fail() || !in.eof() || first != '-' || second != '-' || third != '-' || shard > UINT16_MAX || type_id > UINT16_MAX) {
+      return false;
+    }
+    cursor = Cursor(shard, type_id, id, view);
+    return true;
+  }
+
+} // namespace triton
@@ -0,0 +1,44 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRITON_CURSOR_H
+#define TRITON_CURSOR_H
+
+#include <cstdint>
+#include <string>
+
+namespace triton {
+
+  // Where a paginated scan of all nodes or relationships stopped: the shard it was on, the type it was scanning
+  // (0 for all of them), the last internal id it returned on that shard and the read view it reads (0 for the live graph).
+  class Cursor {
+  public:
+    Cursor();
+    Cursor(uint16_t shard, uint16_t type_id, uint64_t id, uint64_t view = 0);
+    uint16_t shard;
+    uint16_t type_id;
+    uint64_t id;
+    uint64_t view;
+    bool finished;
+
+    // Opaque to clients, "0" starts a scan and an empty string means there is nothing left
+    [[nodiscard]] std::string toString() const;
+    static bool fromString(const std::string& value, Cursor& cursor);
+  };
+
+}// namespace triton
+
+#endif//TRITON_CURSOR_H
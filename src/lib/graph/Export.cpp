@@ -0,0 +1,297 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Export.h"
+#include <cstring>
+#include <filesystem>
+#include <seastar/core/seastar.hh>
+#include <sstream>
+#include <stdexcept>
+
+namespace triton {
+
+  void ExportBlock::write(Serializer &serializer) const {
+    serializer.put(static_cast<uint8_t>(kind));
+    serializer.put(type);
+    serializer.put(ids);
+    if (kind == RELATIONSHIPS) {
+      serializer.put(starting_ids);
+      serializer.put(ending_ids);
+    } else {
+      for (const auto &key : keys) {
+        serializer.put(key);
+      }
+    }
+
+    // A column takes the type of the first value of its property, like the property store does
+    std::map<std::string, Properties::ColumnType> schema;
+    for (const auto &row : properties) {
+      for (const auto &[key, value] : row) {
+        Properties::ColumnType type = Properties::getColumnType(value);
+        if (type != Properties::ColumnType::ANY) {
+          schema.emplace(key, type);
+        }
+      }
+    }
+
+    serializer.put(static_cast<uint16_t>(schema.size()));
+    for (const auto &[key, type] : schema) {
+      serializer.put(key);
+      serializer.put(static_cast<uint8_t>(type));
+      // One bit per row for the rows that have a value in the column, then the values of just those rows
+      std::string present((properties.size() + 7) / 8, '\0');
+      std::vector<int64_t> integers;
+      std::vector<double> doubles;
+      std::string booleans;
+      std::vector<const std::string *> strings;
+      for (size_t row = 0; row < properties.size(); row++) {
+        auto value = properties[row].find(key);
+        if (value == std::end(properties[row]) || Properties::getColumnType(value->second) != type) {
+          continue;
+        }
+        present[row / 8] = static_cast<char>(present[row / 8] | (1U << (row % 8)));
+        switch (type) {
+        case Properties::ColumnType::INTEGER:
+          integers.push_back(std::any_cast<int64_t>(value->second));
+          break;
+        case Properties::ColumnType::DOUBLE:
+          doubles.push_back(std::any_cast<double>(value->second));
+          break;
+        case Properties::ColumnType::BOOLEAN:
+          booleans.push_back(static_cast<char>(std::any_cast<bool>(value->second)));
+          break;
+        default:
+          strings.push_back(&std::any_cast<const std::string &>(value->second));
+        }
+      }
+      serializer.put(present);
+      if (type == Properties::ColumnType::INTEGER) {
+        serializer.put(integers);
+      } else if (type == Properties::ColumnType::DOUBLE) {
+        serializer.put(doubles);
+      } else if (type == Properties::ColumnType::BOOLEAN) {
+        serializer.put(booleans);
+      } else {
+        for (const std::string *value : strings) {
+          serializer.put(*value);
+        }
+      }
+    }
+
+    // Whatever has no typed column goes by row
+    std::vector<std::pair<uint64_t, std::map<std::string, std::any>>> others;
+    for (size_t row = 0; row < properties.size(); row++) {
+      std::map<std::string, std::any> values;
+      for (const auto &[key, value] : properties[row]) {
+        auto column = schema.find(key);
+        if (column == std::end(schema) || column->second != Properties::getColumnType(value)) {
+          values.emplace(key, value);
+        }
+      }
+      if (!values.empty()) {
+        others.emplace_back(row, std::move(values));
+      }
+    }
+    serializer.put(static_cast<uint64_t>(others.size()));
+    for (const auto &[row, values] : others) {
+      serializer.put(static_cast<uint64_t>(row));
+      serializer.put(values);
+    }
+  }
+
+  bool ExportBlock::read(Deserializer &reader) {
+    kind = static_cast<Kind>(reader.getUint8());
+    type = reader.getString();
+    ids = reader.getUint64s();
+    size_t rows = ids.size();
+    starting_ids.clear();
+    ending_ids.clear();
+    keys.clear();
+    if (kind == RELATIONSHIPS) {
+      starting_ids = reader.getUint64s();
+      ending_ids = reader.getUint64s();
+      if (starting_ids.size() != rows || ending_ids.size() != rows) {
+        return false;
+      }
+    } else if (kind == NODES) {
+      for (size_t row = 0; row < rows && !reader.failed(); row++) {
+        keys.emplace_back(reader.getString());
+      }
+    } else {
+      return false;
+    }
+
+    properties.assign(rows, {});
+    uint16_t columns = reader.getUint16();
+    for (uint16_t column = 0; column < columns && !reader.failed(); column++) {
+      std::string key = reader.getString();
+      auto type = static_cast<Properties::ColumnType>(reader.getUint8());
+      std::string present = reader.getString();
+      std::vector<int64_t> integers;
+      std::vector<double> doubles;
+      std::string booleans;
+      if (type == Properties::ColumnType::INTEGER) {
+        integers = reader.getInt64s();
+      } else if (type == Properties::ColumnType::DOUBLE) {
+        doubles = reader.getDoubles();
+      } else if (type == Properties::ColumnType::BOOLEAN) {
+        booleans = reader.getString();
+      } else if (type != Properties::ColumnType::STRING) {
+        return false;
+      }
+      if (present.size() != (rows + 7) / 8) {
+        return false;
+      }
+
+      size_t next = 0;
+      for (size_t row = 0; row < rows && !reader.failed(); row++) {
+        if (!(static_cast<uint8_t>(present[row / 8]) & (1U << (row % 8)))) {
+          continue;
+        }
+        if (type == Properties::ColumnType::STRING) {
+          properties[row].emplace(key, reader.getString());
+          continue;
+        }
+        // More rows than values is a damaged block
+        if ((type == Properties::ColumnType::INTEGER && next >= integers.size()) || (type == Properties::ColumnType::DOUBLE && next >= doubles.size())
+            || (type == Properties::ColumnType::BOOLEAN && next >= booleans.size())) {
+          return false;
+        }
+        if (type == Properties::ColumnType::INTEGER) {
+          properties[row].emplace(key, integers[next]);
+        } else if (type == Properties::ColumnType::DOUBLE) {
+          properties[row].emplace(key, doubles[next]);
+        } else {
+          properties[row].emplace(key, booleans[next] != 0);
+        }
+        next++;
+      }
+    }
+
+    uint64_t others = reader.getUint64();
+    for (uint64_t other = 0; other < others && !reader.failed(); other++) {
+      uint64_t row = reader.getUint64();
+      std::map<std::string, std::any> values = reader.getProperties();
+      if (row >= rows) {
+        return false;
+      }
+      properties[row].merge(values);
+    }
+    return !reader.failed();
+  }
+
+  ExportFile::ExportFile(const std::string &file_name) : file_name(file_name) {
+    file = seastar::open_file_dma(file_name + ".tmp", seastar::open_flags::wo | seastar::open_flags::create | seastar::open_flags::truncate).get0();
+    buffer = seastar::temporary_buffer<char>::aligned(file.memory_dma_alignment(), CHUNK_SIZE);
+  }
+
+  void ExportFile::write(std::string_view data) {
+    while (!data.empty()) {
+      size_t length = std::min(data.size(), CHUNK_SIZE - used);
+      std::memcpy(buffer.get_write() + used, data.data(), length);
+      used += length;
+      data.remove_prefix(length);
+      if (used == CHUNK_SIZE) {
+        if (file.dma_write(offset, buffer.get(), CHUNK_SIZE).get0() != CHUNK_SIZE) {
+          throw std::runtime_error("Short write to " + file_name);
+        }
+        offset += CHUNK_SIZE;
+        used = 0;
+      }
+    }
+  }
+
+  void ExportFile::close() {
+    // The last block is padded for the write and cut back off after
+    if (used > 0) {
+      size_t aligned = (used + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+      std::memset(buffer.get_write() + used, 0, aligned - used);
+      if (file.dma_write(offset, buffer.get(), aligned).get0() != aligned) {
+        throw std::runtime_error("Short write to " + file_name);
+      }
+    }
+    file.truncate(offset + used).get();
+    file.flush().get();
+    file.close().get();
+
+    seastar::rename_file(file_name + ".tmp", file_name).get();
+    seastar::sync_directory(std::filesystem::path(file_name).parent_path().string()).get();
+  }
+
+  std::string ExportFile::csvColumn(const std::string &name, Properties::ColumnType type) {
+    switch (type) {
+    case Properties::ColumnType::INTEGER:
+      return name + ":int";
+    case Properties::ColumnType::DOUBLE:
+      return name + ":double";
+    case Properties::ColumnType::BOOLEAN:
+      return name + ":bool";
+    default:
+      return name + ":string";
+    }
+  }
+
+  void ExportFile::appendCsvCell(std::string &line, std::string_view value) {
+    if (value.find_first_of(",\"\r\n") == std::string_view::npos) {
+      line.append(value);
+      return;
+    }
+    line.push_back('"');
+    for (char c : value) {
+      if (c == '"') {
+        line.push_back('"');
+      }
+      line.push_back(c);
+    }
+    line.push_back('"');
+  }
+
+  void ExportFile::appendCsvRow(std::string &line, const std::vector<std::string> &cells, const std::vector<std::pair<std::string, Properties::ColumnType>> &columns,
+                                const std::map<std::string, std::any> &properties) {
+    for (size_t i = 0; i < cells.size(); i++) {
+      if (i > 0) {
+        line.push_back(',');
+      }
+      appendCsvCell(line, cells[i]);
+    }
+    for (const auto &[name, type] : columns) {
+      line.push_back(',');
+      auto value = properties.find(name);
+      if (value == std::end(properties) || Properties::getColumnType(value->second) != type) {
+        continue;
+      }
+      switch (type) {
+      case Properties::ColumnType::INTEGER:
+        line.append(std::to_string(std::any_cast<int64_t>(value->second)));
+        break;
+      case Properties::ColumnType::DOUBLE: {
+        // Enough digits to read back the same double
+        std::ostringstream number;
+        number.precision(17);
+        number << std::any_cast<double>(value->second);
+        line.append(number.str());
+        break;
+      }
+      case Properties::ColumnType::BOOLEAN:
+        line.append(std::any_cast<bool>(value->second) ? "true" : "false");
+        break;
+      default:
+        appendCsvCell(line, std::any_cast<const std::string &>(value->second));
+      }
+    }
+    line.push_back('\n');
+  }
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRITON_EXPORT_H
+#define TRITON_EXPORT_H
+
+#include <any>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <seastar/core/file.hh>
+#include <seastar/core/temporary_buffer.hh>
+#include "Properties.h"
+#include "Serializer.h"
+
+namespace triton {
+
+  enum class ExportFormat {
+    CSV, BINARY
+  };
+
+  // The nodes or relationships of one type in a batch, stored column by column. Each property gets a typed column with
+  // the rows that have it, values that do not fit their column, arrays and objects, are kept by row instead.
+  class ExportBlock {
+  public:
+    enum Kind : uint8_t { NODES = 1, RELATIONSHIPS = 2 };
+
+    Kind kind = NODES;
+    std::string type;
+    std::vector<uint64_t> ids;
+    std::vector<uint64_t> starting_ids;// Relationships only
+    std::vector<uint64_t> ending_ids;// Relationships only
+    std::vector<std::string> keys;// Nodes only
+    std::vector<std::map<std::string, std::any>> properties;
+
+    void write(Serializer &serializer) const;
+    bool read(Deserializer &reader);
+  };
+
+  // Writes one export file through a single aligned buffer, every call must run in a seastar thread
+  class ExportFile {
+  public:
+    explicit ExportFile(const std::string &file_name);
+
+    void write(std::string_view data);
+    // Only a complete export ever has the final name
+    void close();
+
+    // CSV columns as the bulk loader reads them back, name:int, name:double, name:bool or name:string
+    static std::string csvColumn(const std::string &name, Properties::ColumnType type);
+    // Quoted only when the value holds a comma, a quote or a line break
+    static void appendCsvCell(std::string &line, std::string_view value);
+    // The cells of the columns the row has a value of the right type for, the rest are left empty
+    static void appendCsvRow(std::string &line, const std::vector<std::string> &cells, const std::vector<std::pair<std::string, Properties::ColumnType>> &columns,
+                             const std::map<std::string, std::any> &properties);
+
+    inline static const uint64_t MAGIC = 0x545058454E545254;// "TRTNEXPT"
+    inline static const uint32_t VERSION = 1;
+
+  private:
+    inline static const size_t BLOCK_SIZE = 4096;
+    inline static const size_t CHUNK_SIZE = 1024 * 1024;
+
+    std::string file_name;
+    seastar::file file;
+    seastar::temporary_buffer<char> buffer;
+    size_t used = 0;
+    uint64_t offset = 0;
+  };
+}
+
+#endif//TRITON_EXPORT_H
@@ -15,7 +15,9 @@
  */
 
 #include "Graph.h"
+#include <algorithm>
 #include <iostream>
+#include <numeric>
 
 namespace triton {
 
@@ -23,14 +25,85 @@ namespace triton {
     return name;
   }
 
-  seastar::future<> Graph::start() {
+  seastar::future<> Graph::start(uint8_t lua_vms, seastar::scheduling_group graph_group) {
     cpus = seastar::smp::count;
-    // Will create a shard instance on each core
-    return shard.start(cpus);
+    group = graph_group;
+    requests.resize(cpus);
+    mutation_epochs = std::make_unique<PublishedEpoch[]>(cpus);
+    // Will create a shard instance on each core, each with its own pool of Lua VMs and its own metrics
+    return shard.start(cpus, lua_vms).then([this] {
+      return shard.invoke_on_all([this](Shard &local_shard) {
+        local_shard.MetricsStart(name);
+        local_shard.ReadViewShare(&read_view_epochs);
+        local_shard.MutationEpochShare(mutation_epochs.get());
+      });
+    }).then([this] {
+      // Only take requests once every shard is there
+      return seastar::smp::invoke_on_all([this] {
+        requests[seastar::this_shard_id()] = std::make_unique<seastar::gate>();
+      });
+    });
   }
 
   seastar::future<> Graph::stop() {
-    return shard.stop();
+    // Let the requests already running finish and turn away the rest
+    return seastar::smp::invoke_on_all([this] {
+      if (requests.empty() || !requests[seastar::this_shard_id()]) {
+        return seastar::make_ready_future<>();
+      }
+      return requests[seastar::this_shard_id()]->close();
+    }).then([this] {
+      // Write out whatever is left in the command logs before the shards go away
+      return shard.invoke_on_all([](Shard &local_shard) {
+        local_shard.CompactionStop();
+        local_shard.MemoryStop();
+        return local_shard.CommandLogStop();
+      });
+    }).then([this] {
+      return shard.stop();
+    });
+  }
+
+  bool Graph::Running() const {
+    uint32_t core = seastar::this_shard_id();
+    return core < requests.size() && requests[core] && !requests[core]->is_closed();
+  }
+
+  seastar::gate& Graph::Requests() {
+    return *requests[seastar::this_shard_id()];
+  }
+
+  seastar::scheduling_group Graph::Group() const {
+    return group;
+  }
+
+  seastar::future<uint64_t> Graph::CommandLogStart(const std::string& directory, uint64_t flush_interval, uint64_t flush_bytes) {
+    // Every shard replays its own log in parallel, returns the number of commands replayed
+    seastar::future<std::vector<uint64_t>> v = shard.map([directory, flush_interval, flush_bytes](Shard &local_shard) {
+      return local_shard.CommandLogStart(directory, flush_interval, flush_bytes);
+    });
+
+    return v.then([] (std::vector<uint64_t> counts) {
+      return accumulate(std::begin(counts), std::end(counts), uint64_t(0));
+    });
+  }
+
+  seastar::future<> Graph::CompactionStart(seastar::scheduling_group compaction_group, uint64_t interval, uint64_t count, bool release_capacity) {
+    // One scheduling group shared by every shard of every graph, with a small share so compaction only takes what foreground work leaves
+    return shard.invoke_on_all([compaction_group, interval, count, release_capacity](Shard &local_shard) {
+      local_shard.CompactionStart(compaction_group, interval, count, release_capacity);
+    });
+  }
+
+  seastar::future<bool> Graph::Snapshot() {
+    // Every shard writes its own snapshot in parallel
+    seastar::future<std::vector<bool>> v = shard.map([](Shard &local_shard) {
+      return local_shard.SnapshotSave();
+    });
+
+    return v.then([] (std::vector<bool> saved) {
+      return std::all_of(std::begin(saved), std::end(saved), [](bool value) { return value; });
+    });
   }
 
   void Graph::GetGreetingMessage() {
@@ -66,4 +139,22 @@ namespace triton {
     }));
   }
 
+  void Graph::Freeze(bool compress) {
+    seastar::future<> freeze = shard.invoke_on_all([compress](Shard &local_shard) {
+           return local_shard.freeze(compress);
+    });
+    static_cast<void>(seastar::when_all_succeed(std::move(freeze))
+                        .discard_result()
+                        .handle_exception([](std::exception_ptr e) { std::cerr << "Exception in Graph::Freeze\n"; }));
+  }
+
+  void Graph::Thaw() {
+    seastar::future<> thaw = shard.invoke_on_all([](Shard &local_shard) {
+           return local_shard.thaw();
+    });
+    static_cast<void>(seastar::when_all_succeed(std::move(thaw))
+                        .discard_result()
+                        .handle_exception([](std::exception_ptr e) { std::cerr << "Exception in Graph::Thaw\n"; }));
+  }
+
 }// namespace triton
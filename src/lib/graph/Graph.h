@@ -18,6 +18,9 @@
 #define TRITON_GRAPH_H
 
 #include "Shard.h"
+#include <atomic>
+#include <memory>
+#include <seastar/core/gate.hh>
 
 namespace triton {
 
@@ -25,17 +28,30 @@ namespace triton {
   private:
     uint16_t cpus;
     std::string name;
+    seastar::scheduling_group group;// Requests for this graph run in this group, so other graphs keep their share of every core
+    std::vector<std::unique_ptr<seastar::gate>> requests;// Requests for this graph running on each core, closed while it is stopped
+    std::atomic<uint64_t> read_view_epochs{0};// Read views handed out by the shards of this graph
+    std::unique_ptr<PublishedEpoch[]> mutation_epochs;// The command log epoch of each shard of this graph
 
   public:
     seastar::sharded<Shard> shard;
     explicit Graph(std::string name) :name(std::move(name)) {}
 
     std::string GetName();
-    seastar::future<> start();
+    seastar::future<> start(uint8_t lua_vms = 4, seastar::scheduling_group graph_group = seastar::default_scheduling_group());
     seastar::future<> stop();
+    // Whether the graph takes requests on this core, a stopped graph can be started again
+    [[nodiscard]] bool Running() const;
+    seastar::gate& Requests();
+    [[nodiscard]] seastar::scheduling_group Group() const;
+    seastar::future<uint64_t> CommandLogStart(const std::string& directory, uint64_t flush_interval, uint64_t flush_bytes);
+    seastar::future<bool> Snapshot();
+    seastar::future<> CompactionStart(seastar::scheduling_group compaction_group, uint64_t interval, uint64_t count, bool release_capacity);
     void GetGreetingMessage(); // Change to Health Check
     void Clear();
     void Reserve(uint64_t reserved_nodes, uint64_t reserved_relationships);
+    void Freeze(bool compress = false);
+    void Thaw();
   };
 }// namespace triton
 
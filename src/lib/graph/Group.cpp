@@ -16,7 +16,47 @@
 
 #include "Group.h"
 
+#include <algorithm>
 #include <utility>
 namespace triton {
-  Group::Group(uint16_t rel_type_id, std::vector<triton::Ids> ids) : rel_type_id(rel_type_id), ids(std::move(ids)) {}
-}
\ No newline at end of file
+  Group::Group(uint16_t rel_type_id, IdsList ids) : rel_type_id(rel_type_id), ids(std::move(ids)) {}
+
+  std::vector<Group>::iterator findGroup(std::vector<Group>& groups, uint16_t rel_type_id) {
+    auto group = std::lower_bound(std::begin(groups), std::end(groups), rel_type_id,
+                                  [] (const Group& g, uint16_t type_id) { return g.rel_type_id < type_id; });
+    if (group != std::end(groups) && group->rel_type_id == rel_type_id) {
+      return group;
+    }
+    return std::end(groups);
+  }
+
+  std::vector<Group>::const_iterator findGroup(const std::vector<Group>& groups, uint16_t rel_type_id) {
+    auto group = std::lower_bound(std::begin(groups), std::end(groups), rel_type_id,
+                                  [] (const Group& g, uint16_t type_id) { return g.rel_type_id < type_id; });
+    if (group != std::end(groups) && group->rel_type_id == rel_type_id) {
+      return group;
+    }
+    return std::end(groups);
+  }
+
+  std::vector<Group>::iterator insertGroup(std::vector<Group>& groups, Group group) {
+    auto position = std::lower_bound(std::begin(groups), std::end(groups), group.rel_type_id,
+                                     [] (const Group& g, uint16_t type_id) { return g.rel_type_id < type_id; });
+    return groups.insert(position, std::move(group));
+  }
+
+  void sortGroups(std::vector<Group>& groups) {
+    std::sort(std::begin(groups), std::end(groups), [] (const Group& a, const Group& b) { return a.rel_type_id < b.rel_type_id; });
+  }
+
+  uint64_t findRelationship(const std::vector<Group>& groups, uint16_t rel_type_id, uint64_t node_id) {
+    auto group = findGroup(groups, rel_type_id);
+    if (group != std::end(groups)) {
+      auto ids = group->ids.find_node(node_id);
+      if (ids != std::end(group->ids)) {
+        return ids->rel_id;
+      }
+    }
+    return 0;
+  }
+}
@@ -17,15 +17,24 @@
 #ifndef TRITON_GROUP_H
 #define TRITON_GROUP_H
 
+#include <cstdint>
 #include <vector>
-#include "Ids.h"
+#include "IdsList.h"
 namespace triton {
 class Group {
 public:
-  Group(uint16_t rel_type_id, std::vector<triton::Ids> ids);
+  Group(uint16_t rel_type_id, IdsList ids);
   uint16_t rel_type_id;
-  std::vector<triton::Ids> ids;
+  IdsList ids;
 };
+
+// The groups of a node are kept sorted by rel_type_id, so a type is found with a binary search
+std::vector<Group>::iterator findGroup(std::vector<Group>& groups, uint16_t rel_type_id);
+std::vector<Group>::const_iterator findGroup(const std::vector<Group>& groups, uint16_t rel_type_id);
+std::vector<Group>::iterator insertGroup(std::vector<Group>& groups, Group group);
+void sortGroups(std::vector<Group>& groups);
+// The id of a relationship of the type to node_id in the groups, or 0 if there is none
+uint64_t findRelationship(const std::vector<Group>& groups, uint16_t rel_type_id, uint64_t node_id);
 }// namespace triton
 
 #endif//TRITON_GROUP_H
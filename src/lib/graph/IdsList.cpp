@@ -0,0 +1,411 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "IdsList.h"
+#include <algorithm>
+#include <cstring>
+
+namespace triton {
+
+  bool IdsList::sort_segments = false;
+
+  // Sorted lists are ordered by neighbor and then by relationship
+  static bool less(const Ids& a, const Ids& b) {
+    return a.node_id < b.node_id || (a.node_id == b.node_id && a.rel_id < b.rel_id);
+  }
+
+  IdsList::IdsList(std::initializer_list<Ids> list) {
+    reserve(list.size());
+    for (const Ids& ids : list) {
+      push_back(ids);
+    }
+  }
+
+  IdsList::IdsList(const std::vector<Ids>& list) {
+    if (list.size() > SEGMENT_SIZE) {
+      segment(list);
+      return;
+    }
+    reserve(list.size());
+    std::memcpy(data(), list.data(), list.size() * sizeof(Ids));
+    count = static_cast<uint32_t>(list.size());
+  }
+
+  IdsList::IdsList(const IdsList& other) {
+    copy(other);
+  }
+
+  IdsList::IdsList(IdsList&& other) noexcept : count(other.count), space(other.space), storage(other.storage) {
+    // The heap list or the segments now belong to this one
+    other.count = 0;
+    other.space = INLINE_SIZE;
+  }
+
+  IdsList& IdsList::operator=(const IdsList& other) {
+    if (this != &other) {
+      release();
+      count = 0;
+      space = INLINE_SIZE;
+      copy(other);
+    }
+    return *this;
+  }
+
+  IdsList& IdsList::operator=(IdsList&& other) noexcept {
+    if (this != &other) {
+      release();
+      count = other.count;
+      space = other.space;
+      storage = other.storage;
+      other.count = 0;
+      other.space = INLINE_SIZE;
+    }
+    return *this;
+  }
+
+  IdsList::~IdsList() {
+    release();
+  }
+
+  size_t IdsList::capacity() const {
+    if (isSegmented()) {
+      return storage.segments->list.size() * SEGMENT_SIZE;
+    }
+    return space;
+  }
+
+  size_t IdsList::bytes() const {
+    if (isSegmented()) {
+      auto& list = storage.segments->list;
+      return sizeof(Segments) + list.capacity() * sizeof(Segment*) + list.size() * sizeof(Segment);
+    }
+    return isInline() ? 0 : space * sizeof(Ids);
+  }
+
+  bool IdsList::sorted() const {
+    return isSegmented() && storage.segments->sorted;
+  }
+
+  Ids& IdsList::operator[](size_t position) {
+    return *at(position);
+  }
+
+  void IdsList::reserve(size_t size) {
+    // Segmented lists grow a segment at a time, so there is nothing to reserve past the first segment
+    if (!isSegmented() && size > space) {
+      grow(std::min(size, static_cast<size_t>(SEGMENT_SIZE)));
+    }
+  }
+
+  void IdsList::clear() {
+    if (isSegmented()) {
+      release();
+      space = INLINE_SIZE;
+    }
+    count = 0;
+  }
+
+  IdsList::iterator IdsList::erase(iterator position) {
+    return erase(position, std::next(position));
+  }
+
+  IdsList::iterator IdsList::erase(iterator first, iterator last) {
+    if (first == last) {
+      return first;
+    }
+    size_t position = offset(first);
+
+    if (!isSegmented()) {
+      std::memmove(first.position, last.position, (data() + count - last.position) * sizeof(Ids));
+      count -= static_cast<uint32_t>(last.position - first.position);
+      // Give back memory once the list is down to a quarter of its space, so deletes do not leave it oversized
+      if (!isInline() && count <= space / 4) {
+        shrink_to_fit();
+      }
+      return at(position);
+    }
+
+    // Only the segments at either end of the range move any ids, the ones in between are dropped whole
+    auto& list = storage.segments->list;
+    size_t first_segment = first.segment - list.data();
+    size_t last_segment = last.segment - list.data();
+    Segment* head = list[first_segment];
+    Segment* tail = list[last_segment];
+    size_t removed = 0;
+
+    if (first_segment == last_segment) {
+      removed = last.position - first.position;
+      std::memmove(first.position, last.position, (head->ids() + head->size - last.position) * sizeof(Ids));
+      head->size -= static_cast<uint32_t>(removed);
+    } else {
+      removed = head->ids() + head->size - first.position;
+      head->size = static_cast<uint32_t>(first.position - head->ids());
+      for (size_t i = first_segment + 1; i < last_segment; i++) {
+        removed += list[i]->size;
+        delete list[i];
+      }
+      size_t prefix = last.position - tail->ids();
+      removed += prefix;
+      std::memmove(tail->ids(), last.position, (tail->size - prefix) * sizeof(Ids));
+      tail->size -= static_cast<uint32_t>(prefix);
+      list.erase(list.begin() + first_segment + 1, list.begin() + last_segment);
+    }
+    count -= static_cast<uint32_t>(removed);
+
+    // Segments are never left empty, so iterators always have ids to point at
+    list.erase(std::remove_if(list.begin(), list.end(), [](Segment* segment) {
+      if (segment->size == 0) {
+        delete segment;
+        return true;
+      }
+      return false;
+    }), list.end());
+
+    // Go back to a single list once it is well below a segment, so it does not flip back and forth at the threshold
+    if (count < SEGMENT_SIZE / 4) {
+      unsegment();
+    }
+    return at(position);
+  }
+
+  void IdsList::shrink_to_fit() {
+    if (isSegmented()) {
+      // Merge neighboring segments that fit in one, keeping their order
+      auto& list = storage.segments->list;
+      std::vector<Segment*> merged;
+      merged.push_back(list.front());
+      for (size_t i = 1; i < list.size(); i++) {
+        Segment* previous = merged.back();
+        if (previous->size + list[i]->size <= SEGMENT_SIZE) {
+          std::memcpy(previous->ids() + previous->size, list[i]->ids(), list[i]->size * sizeof(Ids));
+          previous->size += list[i]->size;
+          delete list[i];
+        } else {
+          merged.push_back(list[i]);
+        }
+      }
+      merged.shrink_to_fit();
+      list.swap(merged);
+      return;
+    }
+    if (isInline() || count == space) {
+      return;
+    }
+    if (count <= INLINE_SIZE) {
+      Ids* heap = storage.heap;
+      std::memcpy(storage.inline_ids, heap, count * sizeof(Ids));
+      delete[] reinterpret_cast<unsigned char*>(heap);
+      space = INLINE_SIZE;
+      return;
+    }
+    grow(count);
+  }
+
+  IdsList::iterator IdsList::find(const Ids& ids) {
+    if (sorted()) {
+      iterator found = lowerBound(ids);
+      if (found != end() && found->node_id == ids.node_id && found->rel_id == ids.rel_id) {
+        return found;
+      }
+      return end();
+    }
+    return std::find_if(begin(), end(), [ids](const Ids& entry) {
+      return entry.node_id == ids.node_id && entry.rel_id == ids.rel_id;
+    });
+  }
+
+  IdsList::iterator IdsList::find_node(uint64_t node_id) {
+    if (sorted()) {
+      iterator found = lowerBound(Ids(node_id, 0));
+      if (found != end() && found->node_id == node_id) {
+        return found;
+      }
+      return end();
+    }
+    return std::find_if(begin(), end(), [node_id](const Ids& entry) {
+      return entry.node_id == node_id;
+    });
+  }
+
+  IdsList::iterator IdsList::at(size_t position) {
+    if (!isSegmented()) {
+      return iterator(data() + position, data() + count, nullptr, nullptr);
+    }
+    auto& list = storage.segments->list;
+    size_t segment = 0;
+    while (segment + 1 < list.size() && position >= list[segment]->size) {
+      position -= list[segment]->size;
+      segment++;
+    }
+    return segmentIterator<iterator>(segment, position);
+  }
+
+  size_t IdsList::offset(const iterator& position) const {
+    if (!isSegmented()) {
+      return position.position - data();
+    }
+    size_t before = 0;
+    for (Segment* const* segment = storage.segments->list.data(); segment != position.segment; segment++) {
+      before += (*segment)->size;
+    }
+    return before + (position.position - (*position.segment)->ids());
+  }
+
+  IdsList::iterator IdsList::lowerBound(const Ids& ids) {
+    auto& list = storage.segments->list;
+    // The first segment that ends at or after the ids holds them if anything does
+    auto segment = std::lower_bound(list.begin(), list.end(), ids, [](Segment* segment, const Ids& ids) {
+      return less(segment->ids()[segment->size - 1], ids);
+    });
+    if (segment == list.end()) {
+      return end();
+    }
+    Ids* found = std::lower_bound((*segment)->ids(), (*segment)->ids() + (*segment)->size, ids, less);
+    return segmentIterator<iterator>(segment - list.begin(), found - (*segment)->ids());
+  }
+
+  void IdsList::append(const Ids& ids) {
+    if (isSegmented()) {
+      insertSegmented(ids);
+      return;
+    }
+    // A full list of a segment turns into segments instead of growing again
+    if (space >= SEGMENT_SIZE) {
+      segment(std::vector<Ids>(data(), data() + count));
+      insertSegmented(ids);
+      return;
+    }
+    grow(std::min(space * 2, SEGMENT_SIZE));
+    data()[count++] = ids;
+  }
+
+  void IdsList::insertSegmented(const Ids& ids) {
+    auto& list = storage.segments->list;
+    bool sorted = storage.segments->sorted;
+    size_t index = list.size() - 1;
+    Segment* target = list[index];
+
+    // Sorted ids that do not go at the very end go in the first segment that ends after them
+    if (sorted && less(ids, target->ids()[target->size - 1])) {
+      index = std::lower_bound(list.begin(), list.end(), ids, [](Segment* segment, const Ids& ids) {
+        return less(segment->ids()[segment->size - 1], ids);
+      }) - list.begin();
+      target = list[index];
+    }
+
+    if (target->size == SEGMENT_SIZE) {
+      auto next = new Segment;
+      if (sorted && less(ids, target->ids()[target->size - 1])) {
+        // Split a full segment in half, only the half the ids go into is moved again
+        uint32_t half = SEGMENT_SIZE / 2;
+        next->size = SEGMENT_SIZE - half;
+        std::memcpy(next->ids(), target->ids() + half, next->size * sizeof(Ids));
+        target->size = half;
+        if (!less(ids, next->ids()[0])) {
+          target = next;
+        }
+      } else {
+        target = next;
+      }
+      list.insert(list.begin() + index + 1, next);
+    }
+
+    Ids* first = target->ids();
+    Ids* position = sorted ? std::upper_bound(first, first + target->size, ids, less) : first + target->size;
+    std::memmove(position + 1, position, (first + target->size - position) * sizeof(Ids));
+    *position = ids;
+    target->size++;
+    count++;
+  }
+
+  void IdsList::segment(std::vector<Ids> ids) {
+    release();
+    auto segments = new Segments();
+    segments->sorted = sort_segments;
+    if (segments->sorted) {
+      std::sort(ids.begin(), ids.end(), less);
+    }
+    for (size_t i = 0; i < ids.size(); i += SEGMENT_SIZE) {
+      auto segment = new Segment;
+      segment->size = static_cast<uint32_t>(std::min(ids.size() - i, static_cast<size_t>(SEGMENT_SIZE)));
+      std::memcpy(segment->ids(), ids.data() + i, segment->size * sizeof(Ids));
+      segments->list.push_back(segment);
+    }
+    storage.segments = segments;
+    space = SEGMENTED;
+    count = static_cast<uint32_t>(ids.size());
+  }
+
+  void IdsList::unsegment() {
+    Segments* segments = storage.segments;
+    Ids* target;
+    if (count > INLINE_SIZE) {
+      storage.heap = reinterpret_cast<Ids*>(new unsigned char[count * sizeof(Ids)]);
+      space = count;
+      target = storage.heap;
+    } else {
+      space = INLINE_SIZE;
+      target = reinterpret_cast<Ids*>(storage.inline_ids);
+    }
+    for (Segment* segment : segments->list) {
+      std::memcpy(target, segment->ids(), segment->size * sizeof(Ids));
+      target += segment->size;
+      delete segment;
+    }
+    delete segments;
+  }
+
+  void IdsList::copy(const IdsList& other) {
+    if (other.isSegmented()) {
+      auto segments = new Segments();
+      segments->sorted = other.storage.segments->sorted;
+      segments->list.reserve(other.storage.segments->list.size());
+      for (Segment* from : other.storage.segments->list) {
+        auto segment = new Segment;
+        segment->size = from->size;
+        std::memcpy(segment->ids(), from->ids(), from->size * sizeof(Ids));
+        segments->list.push_back(segment);
+      }
+      storage.segments = segments;
+      space = SEGMENTED;
+      count = other.count;
+      return;
+    }
+    reserve(other.count);
+    std::memcpy(data(), other.data(), other.count * sizeof(Ids));
+    count = other.count;
+  }
+
+  void IdsList::grow(size_t size) {
+    auto heap = reinterpret_cast<Ids*>(new unsigned char[size * sizeof(Ids)]);
+    std::memcpy(heap, data(), count * sizeof(Ids));
+    release();
+    storage.heap = heap;
+    space = static_cast<uint32_t>(size);
+  }
+
+  void IdsList::release() {
+    if (isSegmented()) {
+      for (Segment* segment : storage.segments->list) {
+        delete segment;
+      }
+      delete storage.segments;
+    } else if (!isInline()) {
+      delete[] reinterpret_cast<unsigned char*>(storage.heap);
+    }
+  }
+
+}// namespace triton
@@ -0,0 +1,278 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRITON_IDSLIST_H
+#define TRITON_IDSLIST_H
+
+#include "Ids.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace triton {
+
+  // The ids of the relationships of one type of a node. Most nodes have a single relationship of a type,
+  // so one is kept inline without an allocation, larger lists grow on the heap and give memory back as they shrink.
+  // Supernode lists are split into fixed size segments, so adding to them never copies more than one segment,
+  // and optionally kept sorted by (node_id, rel_id) so finding and removing a neighbor is a binary search.
+  class IdsList {
+    struct Segment;
+
+  public:
+    // Lists larger than this are kept in segments of this many ids
+    static constexpr uint32_t SEGMENT_SIZE = 4096;
+    // Keep segmented lists sorted by neighbor, set once at startup before any lists are segmented
+    static bool sort_segments;
+
+    template <typename T>
+    class Iterator {
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = Ids;
+      using difference_type = std::ptrdiff_t;
+      using pointer = T*;
+      using reference = T&;
+
+      Iterator() = default;
+      Iterator(T* position, T* segment_end, Segment* const* segment, Segment* const* last_segment)
+        : position(position), segment_end(segment_end), segment(segment), last_segment(last_segment) {}
+      template <typename U, typename = std::enable_if_t<std::is_const_v<T> && !std::is_const_v<U>>>
+      Iterator(const Iterator<U>& other) : position(other.position), segment_end(other.segment_end), segment(other.segment), last_segment(other.last_segment) {}
+
+      reference operator*() const { return *position; }
+      pointer operator->() const { return position; }
+
+      Iterator& operator++() {
+        // Contiguous lists have no segments, so they never jump
+        if (++position == segment_end && segment != last_segment) {
+          ++segment;
+          position = (*segment)->ids();
+          segment_end = position + (*segment)->size;
+        }
+        return *this;
+      }
+
+      Iterator operator++(int) {
+        Iterator previous = *this;
+        ++(*this);
+        return previous;
+      }
+
+      bool operator==(const Iterator& other) const { return position == other.position; }
+      bool operator!=(const Iterator& other) const { return position != other.position; }
+
+    private:
+      friend class IdsList;
+      template <typename U> friend class Iterator;
+      T* position = nullptr;
+      T* segment_end = nullptr;
+      Segment* const* segment = nullptr;
+      Segment* const* last_segment = nullptr;
+    };
+
+    using iterator = Iterator<Ids>;
+    using const_iterator = Iterator<const Ids>;
+
+    IdsList() = default;
+    IdsList(std::initializer_list<Ids> list);
+    IdsList(const std::vector<Ids>& list);
+    IdsList(const IdsList& other);
+    IdsList(IdsList&& other) noexcept;
+    IdsList& operator=(const IdsList& other);
+    IdsList& operator=(IdsList&& other) noexcept;
+    ~IdsList();
+
+    iterator begin() { return isSegmented() ? segmentIterator<iterator>(0, 0) : iterator(data(), data() + count, nullptr, nullptr); }
+    iterator end() { return isSegmented() ? segmentEnd<iterator>() : iterator(data() + count, data() + count, nullptr, nullptr); }
+    [[nodiscard]] const_iterator begin() const { return const_cast<IdsList*>(this)->begin(); }
+    [[nodiscard]] const_iterator end() const { return const_cast<IdsList*>(this)->end(); }
+    [[nodiscard]] size_t size() const { return count; }
+    [[nodiscard]] bool empty() const { return count == 0; }
+    [[nodiscard]] size_t capacity() const;
+    // Bytes held outside of the list itself, nothing while its ids fit inline
+    [[nodiscard]] size_t bytes() const;
+    [[nodiscard]] bool segmented() const { return isSegmented(); }
+    [[nodiscard]] bool sorted() const;
+    Ids& operator[](size_t position);
+    const Ids& operator[](size_t position) const { return (*const_cast<IdsList*>(this))[position]; }
+
+    void push_back(const Ids& ids) {
+      if (count < space) {
+        data()[count++] = ids;
+        return;
+      }
+      append(ids);
+    }
+
+    template <typename... Args>
+    void emplace_back(Args&&... args) {
+      push_back(Ids(std::forward<Args>(args)...));
+    }
+
+    void reserve(size_t size);
+    void clear();
+    iterator erase(iterator position);
+    iterator erase(iterator first, iterator last);
+    void shrink_to_fit();
+
+    // The entry with both ids, a binary search when the list is sorted
+    iterator find(const Ids& ids);
+    // The first entry to node_id, a binary search when the list is sorted
+    iterator find_node(uint64_t node_id);
+    [[nodiscard]] const_iterator find_node(uint64_t node_id) const { return const_cast<IdsList*>(this)->find_node(node_id); }
+
+    // Remove every relationship to node_id, calling visit on each one before it goes
+    template <typename Visitor>
+    size_t erase_node(uint64_t node_id, Visitor&& visit) {
+      iterator first;
+      iterator last;
+      if (sorted()) {
+        first = lowerBound(Ids(node_id, 0));
+        last = first;
+        while (last != end() && last->node_id == node_id) {
+          visit(*last);
+          ++last;
+        }
+      } else {
+        first = std::remove_if(begin(), end(), [node_id, &visit](const Ids& entry) {
+          if (entry.node_id == node_id) {
+            visit(entry);
+            return true;
+          }
+          return false;
+        });
+        last = end();
+      }
+      size_t removed = count;
+      erase(first, last);
+      return removed - count;
+    }
+
+    size_t erase_node(uint64_t node_id) {
+      return erase_node(node_id, [](const Ids&) {});
+    }
+
+    // Remove every relationship to any of the sorted node_ids in a single pass over the list, calling visit on each one
+    // before it goes. A sorted list looked up by only a few of them is searched for each one instead
+    template <typename Visitor>
+    size_t erase_nodes(const std::vector<uint64_t>& node_ids, Visitor&& visit) {
+      if (sorted() && node_ids.size() * SEGMENT_SIZE < count) {
+        size_t removed = 0;
+        for (uint64_t node_id : node_ids) {
+          removed += erase_node(node_id, visit);
+        }
+        return removed;
+      }
+      iterator first = std::remove_if(begin(), end(), [&node_ids, &visit](const Ids& entry) {
+        if (std::binary_search(node_ids.begin(), node_ids.end(), entry.node_id)) {
+          visit(entry);
+          return true;
+        }
+        return false;
+      });
+      size_t removed = count;
+      erase(first, end());
+      return removed - count;
+    }
+
+    size_t erase_nodes(const std::vector<uint64_t>& node_ids) {
+      return erase_nodes(node_ids, [](const Ids&) {});
+    }
+
+    // Remove up to limit entries from the end of the list, calling visit on each one before it goes
+    template <typename Visitor>
+    size_t erase_back(size_t limit, Visitor&& visit) {
+      size_t removed = std::min(limit, static_cast<size_t>(count));
+      iterator first = at(count - removed);
+      for (iterator entry = first; entry != end(); ++entry) {
+        visit(*entry);
+      }
+      erase(first, end());
+      return removed;
+    }
+
+    operator std::vector<Ids>() const { return std::vector<Ids>(begin(), end()); }
+
+  private:
+    static constexpr uint32_t INLINE_SIZE = 1;
+    // A space of zero marks a segmented list
+    static constexpr uint32_t SEGMENTED = 0;
+
+    struct Segment {
+      uint32_t size = 0;
+      alignas(Ids) unsigned char bytes[SEGMENT_SIZE * sizeof(Ids)];
+
+      Ids* ids() { return reinterpret_cast<Ids*>(bytes); }
+    };
+
+    struct Segments {
+      std::vector<Segment*> list;
+      bool sorted = false;
+    };
+
+    uint32_t count = 0;
+    uint32_t space = INLINE_SIZE;
+    union Storage {
+      Ids* heap;
+      Segments* segments;
+      alignas(Ids) unsigned char inline_ids[INLINE_SIZE * sizeof(Ids)];
+    } storage{};
+
+    [[nodiscard]] bool isInline() const { return space == INLINE_SIZE; }
+    [[nodiscard]] bool isSegmented() const { return space == SEGMENTED; }
+    Ids* data() { return isInline() ? reinterpret_cast<Ids*>(storage.inline_ids) : storage.heap; }
+    [[nodiscard]] const Ids* data() const { return isInline() ? reinterpret_cast<const Ids*>(storage.inline_ids) : storage.heap; }
+
+    template <typename It>
+    It segmentIterator(size_t segment, size_t offset) {
+      auto& list = storage.segments->list;
+      Segment* const* current = list.data() + segment;
+      // Step over the end of a segment, so every position has a single iterator
+      if (offset == (*current)->size && segment + 1 < list.size()) {
+        ++current;
+        offset = 0;
+      }
+      return It((*current)->ids() + offset, (*current)->ids() + (*current)->size, current, list.data() + list.size() - 1);
+    }
+
+    template <typename It>
+    It segmentEnd() {
+      auto& list = storage.segments->list;
+      return segmentIterator<It>(list.size() - 1, list.back()->size);
+    }
+
+    iterator at(size_t position);
+    [[nodiscard]] size_t offset(const iterator& position) const;
+    iterator lowerBound(const Ids& ids);
+    void append(const Ids& ids);
+    void insertSegmented(const Ids& ids);
+    void segment(std::vector<Ids> ids);
+    void unsegment();
+    void copy(const IdsList& other);
+    void grow(size_t size);
+    void release();
+
+    static_assert(std::is_trivially_copyable_v<Ids>, "Ids are copied as bytes");
+  };
+
+}// namespace triton
+
+#endif//TRITON_IDSLIST_H
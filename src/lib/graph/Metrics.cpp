@@ -0,0 +1,98 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Metrics.h"
+#include <seastar/core/metrics.hh>
+
+namespace triton {
+
+  void LatencyHistogram::record(std::chrono::steady_clock::time_point start) {
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+  }
+
+  void LatencyHistogram::record(uint64_t microseconds) {
+    // Bucket i holds everything up to 2^i microseconds, the last one also takes whatever is slower
+    size_t bucket = 0;
+    while (bucket + 1 < BUCKETS && (uint64_t(1) << bucket) < microseconds) {
+      bucket++;
+    }
+    counts[bucket]++;
+    count++;
+    sum += microseconds;
+  }
+
+  seastar::metrics::histogram LatencyHistogram::histogram() const {
+    seastar::metrics::histogram result;
+    result.sample_count = count;
+    result.sample_sum = static_cast<double>(sum);
+    result.buckets.resize(BUCKETS);
+    // Prometheus buckets are cumulative
+    uint64_t cumulative = 0;
+    for (size_t bucket = 0; bucket < BUCKETS; bucket++) {
+      cumulative += counts[bucket];
+      result.buckets[bucket].count = cumulative;
+      result.buckets[bucket].upper_bound = static_cast<double>(uint64_t(1) << bucket);
+    }
+    return result;
+  }
+
+  void Metrics::label(const std::string& graph) {
+    graph_name = graph;
+  }
+
+  OperationMetrics& Metrics::operation(const std::string& name) {
+    auto search = operations.find(name);
+    if (search != std::end(operations)) {
+      return search->second;
+    }
+
+    // Entries of an unordered map keep their address, so the metrics can point straight at them
+    OperationMetrics& entry = operations[name];
+    namespace sm = seastar::metrics;
+    sm::label operation_label("operation");
+    sm::label graph_label("graph");
+    metric_groups.add_group("peered", {
+      sm::make_counter("calls", sm::description("Calls to a shard by operation"), {operation_label(name), graph_label(graph_name)}, entry.calls),
+      sm::make_counter("remote_calls", sm::description("Calls to another shard by operation"), {operation_label(name), graph_label(graph_name)}, entry.remote_calls),
+      sm::make_histogram("latency", sm::description("Microseconds until the shard called answers by operation"), {operation_label(name), graph_label(graph_name)},
+                         [&entry] { return entry.latency.histogram(); }),
+    });
+    return entry;
+  }
+
+  LatencyHistogram& Metrics::route(const std::string& name) {
+    auto search = routes.find(name);
+    if (search != std::end(routes)) {
+      return search->second;
+    }
+
+    LatencyHistogram& entry = routes[name];
+    namespace sm = seastar::metrics;
+    sm::label route_label("route");
+    sm::label graph_label("graph");
+    metric_groups.add_group("route", {
+      sm::make_histogram("latency", sm::description("Microseconds to answer a request by route"), {route_label(name), graph_label(graph_name)},
+                         [&entry] { return entry.histogram(); }),
+    });
+    return entry;
+  }
+
+  seastar::metrics::metric_groups& Metrics::groups() {
+    return metric_groups;
+  }
+
+}// namespace triton
@@ -0,0 +1,70 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRITON_METRICS_H
+#define TRITON_METRICS_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <seastar/core/metrics_registration.hh>
+#include <seastar/core/metrics_types.hh>
+#include <string>
+#include <unordered_map>
+
+namespace triton {
+
+  // Counts of latencies in buckets that double from one microsecond, in the shape Prometheus expects
+  class LatencyHistogram {
+  public:
+    void record(std::chrono::steady_clock::time_point start);
+    void record(uint64_t microseconds);
+    seastar::metrics::histogram histogram() const;
+
+    inline static const size_t BUCKETS = 22;// The last bucket ends a little over two seconds
+
+  private:
+    std::array<uint64_t, BUCKETS> counts{};
+    uint64_t count = 0;
+    uint64_t sum = 0;
+  };
+
+  struct OperationMetrics {
+    uint64_t calls = 0;
+    uint64_t remote_calls = 0;// Calls that went to another shard
+    LatencyHistogram latency;
+  };
+
+  // The metrics of a shard, operations and routes register theirs the first time they are seen
+  class Metrics {
+  public:
+    // Every metric of the shard carries the name of its graph, so the shards of different graphs on a core do not collide
+    void label(const std::string& graph_name);
+    OperationMetrics& operation(const std::string& name);
+    LatencyHistogram& route(const std::string& name);
+    seastar::metrics::metric_groups& groups();
+
+  private:
+    seastar::metrics::metric_groups metric_groups;
+    std::string graph_name;
+    std::unordered_map<std::string, OperationMetrics> operations;
+    std::unordered_map<std::string, LatencyHistogram> routes;
+  };
+
+}// namespace triton
+
+#endif//TRITON_METRICS_H
@@ -50,52 +50,32 @@ namespace triton {
 
   std::map<std::string, std::any> Node::getProperties() {
     std::map<std::string, std::any> property_map;
-    for(auto prop : properties) {
+    for(const auto& prop : properties) {
       property_map.insert({prop.getKey(), prop.getValue()});
     }
     return property_map;
   }
 
-  sol::table Node::getPropertiesLua(sol::this_state ts) {
-    sol::state_view lua = ts;
-    sol::table property_map = lua.create_table();
-    for(auto prop : getProperties()) {
-      const auto& value_type = prop.second.type();
-
-      if(value_type == typeid(std::string)) {
-        property_map[prop.first] = sol::make_object(lua, std::any_cast<std::string>(prop.second));
-      }
-
-      if(value_type == typeid(int64_t)) {
-        property_map[prop.first] = sol::make_object(lua, std::any_cast<int64_t>(prop.second));
-      }
-
-      if(value_type == typeid(double)) {
-        property_map[prop.first] = sol::make_object(lua, std::any_cast<double>(prop.second));
-      }
-
-      if(value_type == typeid(bool)) {
-        property_map[prop.first] = sol::make_object(lua, std::any_cast<bool>(prop.second));
-      }
-
-      if(value_type == typeid(std::vector<std::string>)) {
-        return sol::make_object(lua, sol::as_table(std::any_cast<std::vector<std::string>>(prop.second)));
-      }
-
-      if(value_type == typeid(std::vector<int64_t>)) {
-        return sol::make_object(lua, sol::as_table(std::any_cast<std::vector<int64_t>>(prop.second)));
-      }
+  const std::vector<Property>& Node::getPropertyList() const {
+    return properties;
+  }
 
-      if(value_type == typeid(std::vector<double>)) {
-        return sol::make_object(lua, sol::as_table(std::any_cast<std::vector<double>>(prop.second)));
-      }
+  sol::table Node::getPropertiesLua(sol::this_state ts) {
+    // Straight from the property list, without an intermediate map
+    sol::table property_map = sol::state_view(ts).create_table(0, static_cast<int>(properties.size()));
+    for(const auto& prop : properties) {
+      property_map[prop.getKey()] = Property::toLua(prop.getValue(), ts);
+    }
+    return property_map;
+  }
 
-      if(value_type == typeid(std::vector<bool>)) {
-        return sol::make_object(lua, sol::as_table(std::any_cast<std::vector<bool>>(prop.second)));
+  sol::object Node::getPropertyLua(const std::string& property, sol::this_state ts) {
+    for(const auto& prop : properties) {
+      if (prop.getKey() == property) {
+        return Property::toLua(prop.getValue(), ts);
       }
-
     }
-    return sol::as_table(property_map);
+    return sol::make_object(ts, sol::lua_nil);
   }
 
   void Node::setProperties(const std::map<std::string, std::any> &new_properties) {
@@ -110,7 +90,7 @@ namespace triton {
   }
 
   std::any Node::getProperty(const std::string& property) {
-    auto result = std::find_if(std::begin(properties), std::end(properties), [property](const Property& prop) {
+    auto result = std::find_if(std::begin(properties), std::end(properties), [&property](const Property& prop) {
       return prop.getKey() == property;
     });
 
@@ -129,7 +109,7 @@ namespace triton {
   // return false if we didn't find it to erase, true otherwise.
     return properties.erase(std::remove_if(
       properties.begin(), properties.end(),
-      [property](const Property& x) {
+      [&property](const Property& x) {
              return x.getKey() == property;
       }), properties.end()) != properties.end();
 
@@ -0,0 +1,26 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRITON_NODEPROJECTION_H
+#define TRITON_NODEPROJECTION_H
+
+// How much of a node or relationship to copy out of its shard, KEY leaves the properties behind when only the id, type
+// and key of a node or the id, type and both ends of a relationship are needed
+enum class NodeProjection {
+  FULL, KEY
+};
+
+#endif//TRITON_NODEPROJECTION_H
@@ -0,0 +1,133 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PackedGroups.h"
+
+#include <algorithm>
+
+namespace triton {
+
+  PackedGroups::PackedGroups() = default;
+
+  void PackedGroups::pack(const std::vector<std::vector<Group>>& groups, bool compress) {
+    clear();
+    compressed = compress;
+
+    // Size everything up front so each array is a single allocation
+    uint64_t group_count = 0;
+    uint64_t ids_count = 0;
+    for (const auto& node_groups : groups) {
+      group_count += node_groups.size();
+      for (const auto& group : node_groups) {
+        ids_count += group.ids.size();
+      }
+    }
+
+    node_offsets.reserve(groups.size() + 1);
+    group_rel_type_ids.reserve(group_count);
+    group_offsets.reserve(group_count + 1);
+    if (compressed) {
+      group_bytes.reserve(group_count);
+    } else {
+      ids.reserve(ids_count);
+    }
+
+    uint64_t packed = 0;
+    for (const auto& node_groups : groups) {
+      node_offsets.push_back(group_rel_type_ids.size());
+      for (const auto& group : node_groups) {
+        group_rel_type_ids.push_back(group.rel_type_id);
+        group_offsets.push_back(packed);
+        packed += group.ids.size();
+        if (compressed) {
+          group_bytes.push_back(encoded.size());
+          uint64_t node_id = 0;
+          uint64_t rel_id = 0;
+          for (const auto& entry : group.ids) {
+            writeVarint(encoded, zigzag(entry.node_id - node_id));
+            writeVarint(encoded, zigzag(entry.rel_id - rel_id));
+            node_id = entry.node_id;
+            rel_id = entry.rel_id;
+          }
+        } else {
+          ids.insert(std::end(ids), std::begin(group.ids), std::end(group.ids));
+        }
+      }
+    }
+    node_offsets.push_back(group_rel_type_ids.size());
+    group_offsets.push_back(packed);
+    encoded.shrink_to_fit();
+  }
+
+  void PackedGroups::clear() {
+    std::vector<uint64_t>().swap(node_offsets);
+    std::vector<uint16_t>().swap(group_rel_type_ids);
+    std::vector<uint64_t>().swap(group_offsets);
+    std::vector<Ids>().swap(ids);
+    std::vector<uint8_t>().swap(encoded);
+    std::vector<uint64_t>().swap(group_bytes);
+    compressed = false;
+    invalidated.clear();
+  }
+
+  bool PackedGroups::isEmpty() const {
+    return node_offsets.empty();
+  }
+
+  bool PackedGroups::isCompressed() const {
+    return compressed;
+  }
+
+  uint64_t PackedGroups::bytes() const {
+    return node_offsets.capacity() * sizeof(uint64_t) + group_rel_type_ids.capacity() * sizeof(uint16_t)
+           + group_offsets.capacity() * sizeof(uint64_t) + ids.capacity() * sizeof(Ids)
+           + encoded.capacity() + group_bytes.capacity() * sizeof(uint64_t) + invalidated.getSizeInBytes();
+  }
+
+  bool PackedGroups::isPacked(uint64_t internal_id) const {
+    return internal_id + 1 < node_offsets.size() && !invalidated.contains(internal_id);
+  }
+
+  void PackedGroups::invalidate(uint64_t internal_id) {
+    if (internal_id + 1 < node_offsets.size()) {
+      invalidated.add(internal_id);
+    }
+  }
+
+  uint64_t PackedGroups::getCount(uint64_t internal_id) const {
+    return group_offsets[node_offsets[internal_id + 1]] - group_offsets[node_offsets[internal_id]];
+  }
+
+  uint64_t PackedGroups::getCount(uint64_t internal_id, uint16_t rel_type_id) const {
+    uint64_t group = findGroup(internal_id, rel_type_id);
+    if (group < node_offsets[internal_id + 1]) {
+      return group_offsets[group + 1] - group_offsets[group];
+    }
+    return 0;
+  }
+
+  uint64_t PackedGroups::findGroup(uint64_t internal_id, uint16_t rel_type_id) const {
+    // The groups were packed sorted by type, returns past the last group of the node when the type is missing
+    auto first = std::begin(group_rel_type_ids) + node_offsets[internal_id];
+    auto last = std::begin(group_rel_type_ids) + node_offsets[internal_id + 1];
+    auto group = std::lower_bound(first, last, rel_type_id);
+    if (group != last && *group == rel_type_id) {
+      return group - std::begin(group_rel_type_ids);
+    }
+    return node_offsets[internal_id + 1];
+  }
+
+} // namespace triton
@@ -0,0 +1,138 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRITON_PACKEDGROUPS_H
+#define TRITON_PACKEDGROUPS_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <roaring/roaring64map.hh>
+#include "Group.h"
+#include "Ids.h"
+
+namespace triton {
+  // Compressed sparse row copy of the relationship groups of every node of a shard.
+  // The groups of node i are [node_offsets[i], node_offsets[i+1]) and the ids of group g are [group_offsets[g], group_offsets[g+1]).
+  // Nodes written to after packing are invalidated and must be read from their nested groups again.
+  // Packed with compression, the ids of each group are zigzag deltas from the entry before them written as varints,
+  // starting at encoded[group_bytes[g]], which takes a few bytes per entry instead of sixteen.
+  class PackedGroups {
+  public:
+    PackedGroups();
+
+    void pack(const std::vector<std::vector<Group>>& groups, bool compress = false);
+
+    void clear();
+
+    [[nodiscard]] bool isEmpty() const;
+
+    [[nodiscard]] bool isCompressed() const;
+
+    // Bytes held by the packed copy
+    [[nodiscard]] uint64_t bytes() const;
+
+    [[nodiscard]] bool isPacked(uint64_t internal_id) const;
+
+    void invalidate(uint64_t internal_id);
+
+    [[nodiscard]] uint64_t getCount(uint64_t internal_id) const;
+
+    [[nodiscard]] uint64_t getCount(uint64_t internal_id, uint16_t rel_type_id) const;
+
+    // Visit the ids of a packed node in the order they were packed
+    template <typename Visitor>
+    void visit(uint64_t internal_id, Visitor& visit) const {
+      // The groups of a node are next to each other, so all of its ids are one range
+      visitGroups(node_offsets[internal_id], node_offsets[internal_id + 1], visit);
+    }
+
+    template <typename Visitor>
+    void visit(uint64_t internal_id, uint16_t rel_type_id, Visitor& visit) const {
+      uint64_t group = findGroup(internal_id, rel_type_id);
+      if (group < node_offsets[internal_id + 1]) {
+        visitGroups(group, group + 1, visit);
+      }
+    }
+
+  private:
+    [[nodiscard]] uint64_t findGroup(uint64_t internal_id, uint16_t rel_type_id) const;
+
+    template <typename Visitor>
+    void visitGroups(uint64_t first, uint64_t last, Visitor& visit) const {
+      if (!compressed) {
+        for (const Ids* entry = ids.data() + group_offsets[first]; entry != ids.data() + group_offsets[last]; ++entry) {
+          visit(*entry);
+        }
+        return;
+      }
+      for (uint64_t group = first; group < last; group++) {
+        const uint8_t* position = encoded.data() + group_bytes[group];
+        uint64_t node_id = 0;
+        uint64_t rel_id = 0;
+        for (uint64_t entry = group_offsets[group]; entry < group_offsets[group + 1]; entry++) {
+          node_id += unzigzag(readVarint(position));
+          rel_id += unzigzag(readVarint(position));
+          visit(Ids(node_id, rel_id));
+        }
+      }
+    }
+
+    static void writeVarint(std::vector<uint8_t>& out, uint64_t value) {
+      while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+      }
+      out.push_back(static_cast<uint8_t>(value));
+    }
+
+    static uint64_t readVarint(const uint8_t*& position) {
+      // Most deltas fit in a byte, so that case skips the loop
+      uint64_t value = *position++;
+      if (value < 0x80) {
+        return value;
+      }
+      value &= 0x7F;
+      for (unsigned shift = 7;; shift += 7) {
+        uint64_t byte = *position++;
+        value |= (byte & 0x7F) << shift;
+        if (byte < 0x80) {
+          return value;
+        }
+      }
+    }
+
+    // Deltas wrap around as unsigned numbers, zigzag keeps the small negative ones small
+    static uint64_t zigzag(uint64_t delta) {
+      return (delta << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(delta) >> 63);
+    }
+
+    static uint64_t unzigzag(uint64_t value) {
+      return (value >> 1) ^ (~(value & 1) + 1);
+    }
+
+    std::vector<uint64_t> node_offsets;
+    std::vector<uint16_t> group_rel_type_ids;
+    std::vector<uint64_t> group_offsets;
+    std::vector<Ids> ids;
+    bool compressed = false;
+    std::vector<uint8_t> encoded;// Ids of every group when compressed
+    std::vector<uint64_t> group_bytes;// Where the ids of each group start in encoded
+    Roaring64Map invalidated;// Nodes whose groups changed after packing
+  };
+} // namespace triton
+
+#endif//TRITON_PACKEDGROUPS_H
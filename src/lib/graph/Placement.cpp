@@ -0,0 +1,112 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Placement.h"
+#include <cstring>
+#include <functional>
+
+namespace triton {
+
+  std::string Placement::affinity_separator;
+
+  static const unsigned int SIXTY_FOUR = 64;
+
+  Placement::Placement(uint8_t cpus) : cpus(cpus) {}
+
+  uint8_t Placement::getShardId(const std::string &type, const std::string &key) const {
+    if (moved_count > 0) {
+      auto type_search = moved.find(type);
+      if (type_search != std::end(moved)) {
+        auto key_search = type_search->second.find(key);
+        if (key_search != std::end(type_search->second)) {
+          return key_search->second;
+        }
+      }
+    }
+    return getHashedShardId(type, key);
+  }
+
+  uint8_t Placement::getHashedShardId(const std::string &type, const std::string &key) const {
+    uint64_t x64;
+    size_t affinity = affinity_separator.empty() ? std::string::npos : key.find(affinity_separator);
+    if (affinity != std::string::npos) {
+      x64 = std::hash<std::string_view>()(std::string_view(key).substr(0, affinity));
+    } else {
+      // Hash the same bytes as type + '-' + key, which std::hash hashes just like a string_view of them,
+      // so nodes stay where earlier snapshots and command logs put them without building the string
+      char buffer[256];
+      size_t size = type.size() + 1 + key.size();
+      if (size <= sizeof(buffer)) {
+        std::memcpy(buffer, type.data(), type.size());
+        buffer[type.size()] = '-';
+        std::memcpy(buffer + type.size() + 1, key.data(), key.size());
+        x64 = std::hash<std::string_view>()(std::string_view(buffer, size));
+      } else {
+        x64 = std::hash<std::string>()(type + '-' + key);
+      }
+    }
+
+    // Then we bucket it into a shard depending on the number of cpus we have
+    return (uint8_t)(((__uint128_t)x64 * (__uint128_t)cpus) >> SIXTY_FOUR);
+  }
+
+  void Placement::setShardId(const std::string &type, const std::string &key, uint8_t shard_id) {
+    auto &keys = moved[type];
+    auto key_search = keys.find(key);
+    if (key_search != std::end(keys)) {
+      keys.erase(key_search);
+      moved_count--;
+    }
+    if (shard_id != getHashedShardId(type, key)) {
+      keys.emplace(key, shard_id);
+      moved_count++;
+    }
+  }
+
+  uint64_t Placement::getMovedCount() const {
+    return moved_count;
+  }
+
+  void Placement::clear() {
+    moved.clear();
+    moved_count = 0;
+  }
+
+  void Placement::write(Serializer &serializer) const {
+    serializer.put(moved_count);
+    for (const auto &[type, keys] : moved) {
+      for (const auto &[key, shard_id] : keys) {
+        serializer.put(type);
+        serializer.put(key);
+        serializer.put(shard_id);
+      }
+    }
+  }
+
+  bool Placement::read(Deserializer &reader) {
+    clear();
+    for (uint64_t count = reader.getUint64(); count > 0 && !reader.failed(); count--) {
+      std::string type = reader.getString();
+      std::string key = reader.getString();
+      uint8_t shard_id = reader.getUint8();
+      if (!reader.failed()) {
+        setShardId(type, key, shard_id);
+      }
+    }
+    return !reader.failed();
+  }
+
+}// namespace triton
@@ -0,0 +1,56 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRITON_PLACEMENT_H
+#define TRITON_PLACEMENT_H
+
+#include "Serializer.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace triton {
+  // Where a node lives. Nodes go to the shard their type and key hash to, or with an affinity separator, nodes whose keys
+  // share the part before it go together whatever their type. Nodes moved on purpose stay on the shard they were moved to.
+  class Placement {
+  public:
+    explicit Placement(uint8_t cpus);
+
+    // Set once at startup, before any nodes are added, since changing it strands the nodes already placed
+    static std::string affinity_separator;
+
+    [[nodiscard]] uint8_t getShardId(const std::string &type, const std::string &key) const;
+
+    // Pin a node to a shard, pinning it to the shard it hashes to removes the pin
+    void setShardId(const std::string &type, const std::string &key, uint8_t shard_id);
+
+    [[nodiscard]] uint64_t getMovedCount() const;
+
+    void clear();
+    void write(Serializer &serializer) const;
+    bool read(Deserializer &reader);
+
+  private:
+    uint8_t cpus;
+    uint64_t moved_count = 0;
+    std::unordered_map<std::string, std::unordered_map<std::string, uint8_t>> moved;// Pinned shards by type and then key
+
+    [[nodiscard]] uint8_t getHashedShardId(const std::string &type, const std::string &key) const;
+  };
+}// namespace triton
+
+#endif//TRITON_PLACEMENT_H
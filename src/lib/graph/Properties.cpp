@@ -0,0 +1,733 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Properties.h"
+
+#include <algorithm>
+
+namespace triton {
+
+  // Branch free comparisons over a contiguous column, so the compiler can vectorize each loop
+  template <typename T, typename V>
+  static void compareValues(const T *values, uint64_t count, ScanOperator scan_operator, V value, uint8_t *matches) {
+    switch (scan_operator) {
+      case ScanOperator::EQ:
+        for (uint64_t i = 0; i < count; i++) { matches[i] &= static_cast<uint8_t>(values[i] == value); }
+        break;
+      case ScanOperator::NE:
+        for (uint64_t i = 0; i < count; i++) { matches[i] &= static_cast<uint8_t>(values[i] != value); }
+        break;
+      case ScanOperator::LT:
+        for (uint64_t i = 0; i < count; i++) { matches[i] &= static_cast<uint8_t>(values[i] < value); }
+        break;
+      case ScanOperator::LE:
+        for (uint64_t i = 0; i < count; i++) { matches[i] &= static_cast<uint8_t>(values[i] <= value); }
+        break;
+      case ScanOperator::GT:
+        for (uint64_t i = 0; i < count; i++) { matches[i] &= static_cast<uint8_t>(values[i] > value); }
+        break;
+      case ScanOperator::GE:
+        for (uint64_t i = 0; i < count; i++) { matches[i] &= static_cast<uint8_t>(values[i] >= value); }
+        break;
+    }
+  }
+
+  template <typename T>
+  static bool compareValue(const T &left, ScanOperator scan_operator, const T &right) {
+    switch (scan_operator) {
+      case ScanOperator::EQ: return left == right;
+      case ScanOperator::NE: return left != right;
+      case ScanOperator::LT: return left < right;
+      case ScanOperator::LE: return left <= right;
+      case ScanOperator::GT: return left > right;
+      case ScanOperator::GE: return left >= right;
+    }
+    return false;
+  }
+
+  static bool isNumber(const std::any &value) {
+    return value.type() == typeid(int64_t) || value.type() == typeid(double);
+  }
+
+  static double toDouble(const std::any &value) {
+    if (value.type() == typeid(int64_t)) {
+      return static_cast<double>(std::any_cast<int64_t>(value));
+    }
+    return std::any_cast<double>(value);
+  }
+
+  Properties::Properties() : Properties(std::make_shared<PropertyKeys>()) {}
+
+  Properties::Properties(std::shared_ptr<PropertyKeys> keys) : size(0), keys(std::move(keys)) {}
+
+  uint64_t Properties::addRow() {
+    // If we have deleted rows, fill in the space by reusing them
+    if (deleted_rows.isEmpty()) {
+      return size++;
+    }
+    uint64_t row = deleted_rows.minimum();
+    deleted_rows.remove(row);
+    return row;
+  }
+
+  void Properties::removeRow(uint64_t row) {
+    deleteProperties(row);
+    deleted_rows.add(row);
+  }
+
+  Properties::ColumnType Properties::getColumnType(const std::any &value) {
+    if (value.type() == typeid(int64_t)) {
+      return INTEGER;
+    }
+    if (value.type() == typeid(double)) {
+      return DOUBLE;
+    }
+    if (value.type() == typeid(bool)) {
+      return BOOLEAN;
+    }
+    if (value.type() == typeid(std::string)) {
+      return STRING;
+    }
+    return ANY;
+  }
+
+  size_t Properties::columnOf(std::string_view key) const {
+    uint16_t key_id = keys->getKeyId(key);
+    if (key_id > 0 && key_id < key_to_column.size() && key_to_column[key_id] > 0) {
+      return key_to_column[key_id] - 1;
+    }
+    return columns.size();
+  }
+
+  const Properties::Column* Properties::findColumn(std::string_view key) const {
+    size_t column = columnOf(key);
+    return column < columns.size() ? &columns[column] : nullptr;
+  }
+
+  Properties::Column& Properties::findOrAddColumn(std::string_view key, ColumnType type) {
+    size_t found = columnOf(key);
+    if (found < columns.size()) {
+      return columns[found];
+    }
+    // The schema is discovered from the first value we see for a key
+    uint16_t key_id = keys->insertKey(key);
+    if (key_id == 0) {
+      overflow = Column();
+      overflow.type = type;
+      return overflow;
+    }
+    if (key_to_column.size() <= key_id) {
+      key_to_column.resize(key_id + 1);
+    }
+    key_to_column[key_id] = static_cast<uint16_t>(columns.size() + 1);
+    Column column;
+    column.key_id = key_id;
+    column.type = type;
+    columns.push_back(std::move(column));
+    return columns.back();
+  }
+
+  std::any Properties::getValue(const Column &column, uint64_t row) {
+    if (!column.present.contains(row)) {
+      return std::any();
+    }
+
+    if (!column.others.empty()) {
+      auto other_search = column.others.find(row);
+      if (other_search != std::end(column.others)) {
+        return other_search->second;
+      }
+    }
+
+    switch (column.type) {
+      case INTEGER:
+        return column.integers[row];
+      case DOUBLE:
+        return column.doubles[row];
+      case BOOLEAN:
+        return static_cast<bool>(column.booleans[row]);
+      case STRING:
+        return column.strings[row];
+      case VECTOR: {
+        const float *vector = column.floats.data() + row * column.dimensions;
+        return std::vector<double>(vector, vector + column.dimensions);
+      }
+      default:
+        return column.values[row];
+    }
+  }
+
+  const float* Properties::getVector(const Column &column, uint64_t row) {
+    if (column.type != VECTOR || !column.present.contains(row) || column.others.count(row) > 0) {
+      return nullptr;
+    }
+    return column.floats.data() + row * column.dimensions;
+  }
+
+  void Properties::clearValue(Column &column, uint64_t row) {
+    if (column.present.contains(row)) {
+      column.present.remove(row);
+      column.others.erase(row);
+      // Release any heap memory held by the value
+      if (column.type == STRING) {
+        std::string().swap(column.strings[row]);
+      }
+      if (column.type == ANY) {
+        column.values[row].reset();
+      }
+    }
+  }
+
+  std::any Properties::getProperty(uint64_t row, const std::string &key) const {
+    const Column* column = findColumn(key);
+    if (column != nullptr) {
+      return getValue(*column, row);
+    }
+    return std::any();
+  }
+
+  bool Properties::getIntegerProperty(uint64_t row, const std::string &key, int64_t &value) const {
+    const Column* column = findColumn(key);
+    if (column != nullptr && column->present.contains(row)) {
+      auto other_search = column->others.find(row);
+      if (other_search != std::end(column->others)) {
+        if (other_search->second.type() == typeid(int64_t)) {
+          value = std::any_cast<int64_t>(other_search->second);
+          return true;
+        }
+        return false;
+      }
+      if (column->type == INTEGER) {
+        value = column->integers[row];
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool Properties::getDoubleProperty(uint64_t row, const std::string &key, double &value) const {
+    const Column* column = findColumn(key);
+    if (column != nullptr && column->present.contains(row)) {
+      auto other_search = column->others.find(row);
+      if (other_search != std::end(column->others)) {
+        if (other_search->second.type() == typeid(double)) {
+          value = std::any_cast<double>(other_search->second);
+          return true;
+        }
+        return false;
+      }
+      if (column->type == DOUBLE) {
+        value = column->doubles[row];
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool Properties::getBooleanProperty(uint64_t row, const std::string &key, bool &value) const {
+    const Column* column = findColumn(key);
+    if (column != nullptr && column->present.contains(row)) {
+      auto other_search = column->others.find(row);
+      if (other_search != std::end(column->others)) {
+        if (other_search->second.type() == typeid(bool)) {
+          value = std::any_cast<bool>(other_search->second);
+          return true;
+        }
+        return false;
+      }
+      if (column->type == BOOLEAN) {
+        value = column->booleans[row];
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool Properties::getStringProperty(uint64_t row, const std::string &key, std::string &value) const {
+    const Column* column = findColumn(key);
+    if (column != nullptr && column->present.contains(row)) {
+      auto other_search = column->others.find(row);
+      if (other_search != std::end(column->others)) {
+        if (other_search->second.type() == typeid(std::string)) {
+          value = std::any_cast<std::string>(other_search->second);
+          return true;
+        }
+        return false;
+      }
+      if (column->type == STRING) {
+        value = column->strings[row];
+        return true;
+      }
+    }
+    return false;
+  }
+
+  Properties::Column& Properties::startValue(uint64_t row, std::string_view key, ColumnType type) {
+    Column& column = findOrAddColumn(key, type);
+    clearValue(column, row);
+    column.present.add(row);
+    return column;
+  }
+
+  void Properties::setProperty(uint64_t row, const std::string &key, const std::any &value) {
+    ColumnType type = getColumnType(value);
+    switch (type) {
+      case INTEGER:
+        setIntegerProperty(row, key, std::any_cast<int64_t>(value));
+        return;
+      case DOUBLE:
+        setDoubleProperty(row, key, std::any_cast<double>(value));
+        return;
+      case BOOLEAN:
+        setBooleanProperty(row, key, std::any_cast<bool>(value));
+        return;
+      case STRING:
+        setStringProperty(row, key, std::any_cast<const std::string&>(value));
+        return;
+      default:
+        break;
+    }
+
+    // Arrays of numbers go to the vector column of the key once there is one
+    if (value.type() == typeid(std::vector<double>) || value.type() == typeid(std::vector<int64_t>)) {
+      size_t column = columnOf(key);
+      if (column < columns.size() && columns[column].type == VECTOR) {
+        if (value.type() == typeid(std::vector<double>)) {
+          setVectorProperty(row, key, std::any_cast<const std::vector<double>&>(value));
+        } else {
+          const auto &integers = std::any_cast<const std::vector<int64_t>&>(value);
+          setVectorProperty(row, key, std::vector<double>(integers.begin(), integers.end()));
+        }
+        return;
+      }
+    }
+
+    Column& column = startValue(row, key, type);
+    // Values that do not match the column type are kept on the side
+    if (column.type != type) {
+      column.others.insert({row, value});
+      return;
+    }
+    if (column.values.size() <= row) {
+      column.values.resize(row + 1);
+    }
+    column.values[row] = value;
+  }
+
+  void Properties::setIntegerProperty(uint64_t row, std::string_view key, int64_t value) {
+    Column& column = startValue(row, key, INTEGER);
+    if (column.type != INTEGER) {
+      column.others.insert({row, value});
+      return;
+    }
+    if (column.integers.size() <= row) {
+      column.integers.resize(row + 1);
+    }
+    column.integers[row] = value;
+  }
+
+  void Properties::setDoubleProperty(uint64_t row, std::string_view key, double value) {
+    Column& column = startValue(row, key, DOUBLE);
+    if (column.type != DOUBLE) {
+      column.others.insert({row, value});
+      return;
+    }
+    if (column.doubles.size() <= row) {
+      column.doubles.resize(row + 1);
+    }
+    column.doubles[row] = value;
+  }
+
+  void Properties::setBooleanProperty(uint64_t row, std::string_view key, bool value) {
+    Column& column = startValue(row, key, BOOLEAN);
+    if (column.type != BOOLEAN) {
+      column.others.insert({row, value});
+      return;
+    }
+    if (column.booleans.size() <= row) {
+      column.booleans.resize(row + 1);
+    }
+    column.booleans[row] = value;
+  }
+
+  void Properties::setStringProperty(uint64_t row, std::string_view key, std::string_view value) {
+    Column& column = startValue(row, key, STRING);
+    if (column.type != STRING) {
+      column.others.insert({row, std::string(value)});
+      return;
+    }
+    if (column.strings.size() <= row) {
+      column.strings.resize(row + 1);
+    }
+    column.strings[row] = value;
+  }
+
+  void Properties::setVectorProperty(uint64_t row, std::string_view key, const std::vector<double> &value) {
+    size_t found = columnOf(key);
+    if (found == columns.size() || columns[found].type != VECTOR) {
+      setProperty(row, std::string(key), value);
+      return;
+    }
+    Column& column = startValue(row, key, VECTOR);
+    // Vectors of another size cannot be compared, they are kept on the side
+    if (value.size() != column.dimensions) {
+      column.others.insert({row, value});
+      return;
+    }
+    if (column.floats.size() < (row + 1) * column.dimensions) {
+      column.floats.resize((row + 1) * column.dimensions);
+    }
+    std::copy(value.begin(), value.end(), column.floats.begin() + row * column.dimensions);
+  }
+
+  bool Properties::addVectorColumn(const std::string &key, uint32_t dimensions) {
+    if (dimensions == 0) {
+      return false;
+    }
+    size_t found = columnOf(key);
+    if (found == columns.size()) {
+      findOrAddColumn(key, VECTOR).dimensions = dimensions;
+      return true;
+    }
+    Column& column = columns[found];
+    if (column.type != ANY) {
+      return column.type == VECTOR && column.dimensions == dimensions;
+    }
+
+    // Arrays already set move over, the ones that are not vectors of this size end up on the side
+    std::vector<std::pair<uint64_t, std::any>> values;
+    for (uint64_t row : column.present) {
+      values.emplace_back(row, getValue(column, row));
+    }
+    Column vectors;
+    vectors.key_id = column.key_id;
+    vectors.type = VECTOR;
+    vectors.dimensions = dimensions;
+    column = std::move(vectors);
+    for (const auto& [row, value] : values) {
+      setProperty(row, key, value);
+    }
+    return true;
+  }
+
+  uint32_t Properties::getVectorDimensions(const std::string &key) const {
+    const Column* column = findColumn(key);
+    if (column != nullptr && column->type == VECTOR) {
+      return column->dimensions;
+    }
+    return 0;
+  }
+
+  bool Properties::deleteProperty(uint64_t row, const std::string &key) {
+    size_t found = columnOf(key);
+    if (found < columns.size()) {
+      Column& column = columns[found];
+      if (column.present.contains(row)) {
+        clearValue(column, row);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  std::map<std::string, std::any> Properties::getProperties(uint64_t row) const {
+    std::map<std::string, std::any> property_map;
+    for (const auto& column : columns) {
+      if (column.present.contains(row)) {
+        property_map.insert({keys->getKey(column.key_id), getValue(column, row)});
+      }
+    }
+    return property_map;
+  }
+
+  void Properties::setProperties(uint64_t row, const std::map<std::string, std::any> &values) {
+    deleteProperties(row);
+    for (const auto& [key, value] : values) {
+      setProperty(row, key, value);
+    }
+  }
+
+  void Properties::deleteProperties(uint64_t row) {
+    for (auto& column : columns) {
+      clearValue(column, row);
+    }
+  }
+
+  std::map<std::string, Properties::ColumnType> Properties::getSchema() const {
+    std::map<std::string, ColumnType> schema;
+    for (const auto& column : columns) {
+      schema.emplace(keys->getKey(column.key_id), column.type);
+    }
+    return schema;
+  }
+
+  uint64_t Properties::bytes() const {
+    // Only the columns themselves, the text of long strings and of the other values lives elsewhere
+    uint64_t total = 0;
+    for (const auto& column : columns) {
+      total += column.present.getSizeInBytes();
+      total += column.integers.capacity() * sizeof(int64_t);
+      total += column.doubles.capacity() * sizeof(double);
+      total += column.booleans.capacity() / 8;
+      total += column.strings.capacity() * sizeof(std::string);
+      total += column.floats.capacity() * sizeof(float);
+      total += column.values.capacity() * sizeof(std::any);
+      total += column.others.size() * (sizeof(uint64_t) + sizeof(std::any));
+    }
+    return total + key_to_column.capacity() * sizeof(uint16_t);
+  }
+
+  void Properties::filterColumn(const Column &column, const ScanFilter &filter, std::vector<uint8_t> &selected) const {
+    // Start from the rows that have a value for the column
+    std::vector<uint8_t> matches(size, 0);
+    for (uint64_t row : column.present) {
+      matches[row] = 1;
+    }
+
+    const std::any &value = filter.value;
+    bool typed = false;
+    switch (column.type) {
+      case INTEGER: {
+        uint64_t count = std::min<uint64_t>(column.integers.size(), size);
+        if (value.type() == typeid(int64_t)) {
+          compareValues(column.integers.data(), count, filter.scan_operator, std::any_cast<int64_t>(value), matches.data());
+          typed = true;
+        } else if (value.type() == typeid(double)) {
+          compareValues(column.integers.data(), count, filter.scan_operator, std::any_cast<double>(value), matches.data());
+          typed = true;
+        }
+        break;
+      }
+      case DOUBLE:
+        if (isNumber(value)) {
+          uint64_t count = std::min<uint64_t>(column.doubles.size(), size);
+          compareValues(column.doubles.data(), count, filter.scan_operator, toDouble(value), matches.data());
+          typed = true;
+        }
+        break;
+      case BOOLEAN:
+        if (value.type() == typeid(bool)) {
+          bool boolean = std::any_cast<bool>(value);
+          uint64_t count = std::min<uint64_t>(column.booleans.size(), size);
+          for (uint64_t row = 0; row < count; row++) {
+            matches[row] &= static_cast<uint8_t>(compareValue(static_cast<bool>(column.booleans[row]), filter.scan_operator, boolean));
+          }
+          typed = true;
+        }
+        break;
+      case STRING:
+        if (value.type() == typeid(std::string)) {
+          const auto &text = std::any_cast<const std::string&>(value);
+          uint64_t count = std::min<uint64_t>(column.strings.size(), size);
+          for (uint64_t row = 0; row < count; row++) {
+            if (matches[row]) {
+              matches[row] = static_cast<uint8_t>(compareValue(column.strings[row], filter.scan_operator, text));
+            }
+          }
+          typed = true;
+        }
+        break;
+      default:
+        break;
+    }
+
+    // The typed column cannot match this value, only the values kept on the side might
+    if (!typed) {
+      std::fill(matches.begin(), matches.end(), 0);
+    }
+
+    // Values whose type does not match the column are stale in the typed vector
+    for (const auto &[row, other] : column.others) {
+      matches[row] = static_cast<uint8_t>(filter.matches(other));
+    }
+
+    uint8_t *selection = selected.data();
+    const uint8_t *matching = matches.data();
+    for (uint64_t row = 0; row < size; row++) {
+      selection[row] &= matching[row];
+    }
+  }
+
+  void Properties::scan(const std::vector<ScanFilter> &filters, const std::string &key, Aggregate &aggregate) const {
+    std::vector<uint8_t> selected(size, 1);
+    for (uint64_t row : deleted_rows) {
+      selected[row] = 0;
+    }
+
+    for (const auto &filter : filters) {
+      const Column* column = findColumn(filter.property);
+      // No node has this property so none can pass the filter
+      if (column == nullptr) {
+        return;
+      }
+      filterColumn(*column, filter, selected);
+    }
+
+    if (key.empty()) {
+      uint64_t count = 0;
+      for (uint64_t row = 0; row < size; row++) {
+        count += selected[row];
+      }
+      aggregate.count += count;
+      return;
+    }
+
+    const Column* column = findColumn(key);
+    if (column == nullptr) {
+      return;
+    }
+
+    // Only rows holding a typed number are aggregated in the loops, others are added one at a time
+    std::vector<uint8_t> numbers(size, 0);
+    for (uint64_t row : column->present) {
+      numbers[row] = selected[row];
+    }
+    for (const auto &[row, other] : column->others) {
+      if (numbers[row] && isNumber(other)) {
+        aggregate.add(toDouble(other));
+      }
+      numbers[row] = 0;
+    }
+
+    if (column->type == INTEGER) {
+      uint64_t count = std::min<uint64_t>(column->integers.size(), size);
+      for (uint64_t row = 0; row < count; row++) {
+        if (numbers[row]) {
+          aggregate.add(static_cast<double>(column->integers[row]));
+        }
+      }
+    } else if (column->type == DOUBLE) {
+      uint64_t count = std::min<uint64_t>(column->doubles.size(), size);
+      for (uint64_t row = 0; row < count; row++) {
+        if (numbers[row]) {
+          aggregate.add(column->doubles[row]);
+        }
+      }
+    }
+  }
+
+  bool Properties::matches(uint64_t row, const std::vector<ScanFilter> &filters) const {
+    for (const auto &filter : filters) {
+      if (!filter.matches(getProperty(row, filter.property))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void Properties::nearest(const std::string &key, const std::vector<float> &query, VectorMetric metric, const std::vector<ScanFilter> &filters,
+                           NearestNeighbors &neighbors) const {
+    const Column* column = findColumn(key);
+    if (column == nullptr || column->type != VECTOR || query.size() != column->dimensions) {
+      return;
+    }
+    for (uint64_t row : column->present) {
+      if (!column->others.empty() && column->others.count(row) > 0) {
+        continue;
+      }
+      if (matches(row, filters)) {
+        neighbors.add(row, VectorDistance(column->floats.data() + row * column->dimensions, query.data(), column->dimensions, metric));
+      }
+    }
+  }
+
+  bool Properties::vectorDistance(uint64_t row, const std::string &key, const std::vector<float> &query, VectorMetric metric, double &distance) const {
+    const Column* column = findColumn(key);
+    if (column == nullptr || query.size() != column->dimensions) {
+      return false;
+    }
+    const float *vector = getVector(*column, row);
+    if (vector == nullptr) {
+      return false;
+    }
+    distance = VectorDistance(vector, query.data(), column->dimensions, metric);
+    return true;
+  }
+
+  void Properties::write(Serializer &serializer) const {
+    serializer.put(size);
+    serializer.put(deleted_rows);
+    serializer.put(static_cast<uint64_t>(columns.size()));
+    for (const auto& column : columns) {
+      serializer.put(keys->getKey(column.key_id));
+      serializer.put(static_cast<uint8_t>(column.type));
+      serializer.put(column.present);
+      serializer.put(column.integers);
+      serializer.put(column.doubles);
+      serializer.put(static_cast<uint64_t>(column.booleans.size()));
+      for (bool value : column.booleans) {
+        serializer.put(value);
+      }
+      serializer.put(static_cast<uint64_t>(column.strings.size()));
+      for (const auto& value : column.strings) {
+        serializer.put(value);
+      }
+      serializer.put(static_cast<uint64_t>(column.values.size()));
+      for (const auto& value : column.values) {
+        serializer.put(value);
+      }
+      serializer.put(static_cast<uint64_t>(column.others.size()));
+      for (const auto& [row, value] : column.others) {
+        serializer.put(row);
+        serializer.put(value);
+      }
+      // Only vector columns have floats, so stores written before there were any read the same
+      if (column.type == VECTOR) {
+        serializer.put(column.dimensions);
+        serializer.put(column.floats);
+      }
+    }
+  }
+
+  bool Properties::read(Deserializer &reader) {
+    columns.clear();
+    key_to_column.clear();
+    size = reader.getUint64();
+    deleted_rows = reader.getBitmap();
+    for (uint64_t count = reader.getUint64(); count > 0 && !reader.failed(); count--) {
+      Column column;
+      column.key_id = keys->insertKey(reader.getString());
+      column.type = static_cast<ColumnType>(reader.getUint8());
+      column.present = reader.getBitmap();
+      column.integers = reader.getInt64s();
+      column.doubles = reader.getDoubles();
+      for (uint64_t values = reader.getUint64(); values > 0 && !reader.failed(); values--) {
+        column.booleans.push_back(reader.getBoolean());
+      }
+      for (uint64_t values = reader.getUint64(); values > 0 && !reader.failed(); values--) {
+        column.strings.emplace_back(reader.getString());
+      }
+      for (uint64_t values = reader.getUint64(); values > 0 && !reader.failed(); values--) {
+        column.values.emplace_back(reader.getAny());
+      }
+      for (uint64_t values = reader.getUint64(); values > 0 && !reader.failed(); values--) {
+        uint64_t row = reader.getUint64();
+        column.others.emplace(row, reader.getAny());
+      }
+      if (column.type == VECTOR) {
+        column.dimensions = reader.getUint32();
+        column.floats = reader.getFloats();
+      }
+      if (key_to_column.size() <= column.key_id) {
+        key_to_column.resize(column.key_id + 1);
+      }
+      key_to_column[column.key_id] = static_cast<uint16_t>(columns.size() + 1);
+      columns.push_back(std::move(column));
+    }
+    return !reader.failed();
+  }
+
+} // namespace triton
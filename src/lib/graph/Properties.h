@@ -0,0 +1,151 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRITON_PROPERTIES_H
+#define TRITON_PROPERTIES_H
+
+#include <any>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <roaring/roaring64map.hh>
+#include <tsl/sparse_map.h>
+#include "PropertyKeys.h"
+#include "Scan.h"
+#include "Serializer.h"
+#include "Vector.h"
+
+namespace triton {
+  // Columnar store of the properties of every node of a single node type.
+  // Each property key gets a typed column, the type is taken from the first value written to it.
+  // Vector columns are made up front with a fixed size, their arrays of numbers are kept as contiguous floats to be searched.
+  // Nodes are addressed by row, rows are handed out by addRow and recycled by removeRow.
+  // Columns are found by the id of their key, from the keys of the shard shared by the stores of all its types.
+  class Properties {
+  public:
+    enum ColumnType : uint8_t { INTEGER, DOUBLE, BOOLEAN, STRING, ANY, VECTOR };
+
+    // A store with keys of its own
+    Properties();
+    explicit Properties(std::shared_ptr<PropertyKeys> keys);
+
+    // The typed column a value goes to, ANY for arrays and objects
+    static ColumnType getColumnType(const std::any &value);
+
+    uint64_t addRow();
+
+    void removeRow(uint64_t row);
+
+    std::any getProperty(uint64_t row, const std::string &key) const;
+
+    bool getIntegerProperty(uint64_t row, const std::string &key, int64_t &value) const;
+
+    bool getDoubleProperty(uint64_t row, const std::string &key, double &value) const;
+
+    bool getBooleanProperty(uint64_t row, const std::string &key, bool &value) const;
+
+    bool getStringProperty(uint64_t row, const std::string &key, std::string &value) const;
+
+    void setProperty(uint64_t row, const std::string &key, const std::any &value);
+
+    // Scalars written straight into their column, without passing through a std::any
+    void setIntegerProperty(uint64_t row, std::string_view key, int64_t value);
+
+    void setDoubleProperty(uint64_t row, std::string_view key, double value);
+
+    void setBooleanProperty(uint64_t row, std::string_view key, bool value);
+
+    void setStringProperty(uint64_t row, std::string_view key, std::string_view value);
+
+    // Arrays of the vector column of the key, anything else is set like any other array
+    void setVectorProperty(uint64_t row, std::string_view key, const std::vector<double> &value);
+
+    // Keep the arrays of numbers of the key as vectors of this size, converting the ones already there.
+    // False when the key holds scalars or already has vectors of another size
+    bool addVectorColumn(const std::string &key, uint32_t dimensions);
+
+    // The size of the vectors of the key, 0 when it has no vector column
+    uint32_t getVectorDimensions(const std::string &key) const;
+
+    bool deleteProperty(uint64_t row, const std::string &key);
+
+    std::map<std::string, std::any> getProperties(uint64_t row) const;
+
+    void setProperties(uint64_t row, const std::map<std::string, std::any> &values);
+
+    void deleteProperties(uint64_t row);
+
+    std::map<std::string, ColumnType> getSchema() const;
+
+    // Bytes held by the columns, to watch the store grow
+    uint64_t bytes() const;
+
+    // Aggregate the numbers of a property over the rows that pass every filter, an empty key only counts rows
+    void scan(const std::vector<ScanFilter> &filters, const std::string &key, Aggregate &aggregate) const;
+
+    // True when the row has every filtered property and each passes its filter, to check one node at a time
+    bool matches(uint64_t row, const std::vector<ScanFilter> &filters) const;
+
+    // Offer every row with a vector of the key that passes the filters to the neighbors, by row
+    void nearest(const std::string &key, const std::vector<float> &query, VectorMetric metric, const std::vector<ScanFilter> &filters,
+                 NearestNeighbors &neighbors) const;
+
+    // How far the vector of the key of one row is from the query, false when the row has none
+    bool vectorDistance(uint64_t row, const std::string &key, const std::vector<float> &query, VectorMetric metric, double &distance) const;
+
+    // Copy the columns as they are, so a snapshot restores without re-inserting every value
+    void write(Serializer &serializer) const;
+    bool read(Deserializer &reader);
+
+  private:
+    struct Column {
+      uint16_t key_id = 0;
+      ColumnType type;
+      Roaring64Map present;                      // Rows that have a value for this column
+      std::vector<int64_t> integers;
+      std::vector<double> doubles;
+      std::vector<bool> booleans;
+      std::vector<std::string> strings;
+      uint32_t dimensions = 0;                   // Floats per row of a vector column
+      std::vector<float> floats;
+      std::vector<std::any> values;              // Arrays and objects that have no typed column
+      tsl::sparse_map<uint64_t, std::any> others;// Values whose type does not match the column type
+    };
+
+    // The index of the column of the key, the number of columns when there is none
+    [[nodiscard]] size_t columnOf(std::string_view key) const;
+    const Column* findColumn(std::string_view key) const;
+    Column& findOrAddColumn(std::string_view key, ColumnType type);
+    // The column of the key with the previous value of the row cleared, ready for the new one
+    Column& startValue(uint64_t row, std::string_view key, ColumnType type);
+    static std::any getValue(const Column &column, uint64_t row);
+    static void clearValue(Column &column, uint64_t row);
+    static const float* getVector(const Column &column, uint64_t row);
+    void filterColumn(const Column &column, const ScanFilter &filter, std::vector<uint8_t> &selected) const;
+
+    uint64_t size;
+    Roaring64Map deleted_rows;// Keep track of deleted rows in order to reuse them
+    std::vector<Column> columns;
+    std::shared_ptr<PropertyKeys> keys;
+    std::vector<uint16_t> key_to_column;// By key id, the index of its column plus one or 0 when it has none here
+    Column overflow;// Takes the values of keys past the last id, which writers refuse before they get here
+  };
+} // namespace triton
+
+#endif//TRITON_PROPERTIES_H
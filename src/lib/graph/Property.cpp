@@ -16,32 +16,83 @@
 
 #include "Property.h"
 
+#include <map>
 #include <utility>
+#include <vector>
 
 namespace triton {
 
   Property::Property() = default;
-  Property::Property(const std::string& key, std::any value) : value(std::move(value)) {
-    auto token_search = Property::token_to_id.find(key);
-    if (token_search != Property::token_to_id.end()) {
-      token_id = token_search->second;
-    } else {
-      token_id = std::hash<std::string>()(key);
-      Property::token_to_id.emplace(key, token_id);
-      Property::id_to_token.emplace(token_id, key);
-    }
-  }
+  Property::Property(const std::string& key, std::any value) : key(key), value(std::move(value)) {}
 
-  std::string Property::getKey() const {
-    auto id_search = Property::id_to_token.find(token_id);
-    if (id_search != Property::id_to_token.end()) {
-      return Property::id_to_token.at(token_id);
-    }
-    return EMPTY;
+  const std::string& Property::getKey() const {
+    return key;
   }
 
-  std::any Property::getValue() {
+  const std::any& Property::getValue() const {
     return value;
   }
 
-} // namespace triton
\ No newline at end of file
+  sol::object Property::toLua(const std::any& value, sol::this_state ts) {
+    const auto& value_type = value.type();
+
+    if(value_type == typeid(std::string)) {
+      return sol::make_object(ts, std::any_cast<const std::string&>(value));
+    }
+
+    if(value_type == typeid(int64_t)) {
+      return sol::make_object(ts, std::any_cast<int64_t>(value));
+    }
+
+    if(value_type == typeid(double)) {
+      return sol::make_object(ts, std::any_cast<double>(value));
+    }
+
+    if(value_type == typeid(bool)) {
+      return sol::make_object(ts, std::any_cast<bool>(value));
+    }
+
+    if(value_type == typeid(std::vector<std::string>)) {
+      return sol::make_object(ts, sol::as_table(std::any_cast<const std::vector<std::string>&>(value)));
+    }
+
+    if(value_type == typeid(std::vector<int64_t>)) {
+      return sol::make_object(ts, sol::as_table(std::any_cast<const std::vector<int64_t>&>(value)));
+    }
+
+    if(value_type == typeid(std::vector<double>)) {
+      return sol::make_object(ts, sol::as_table(std::any_cast<const std::vector<double>&>(value)));
+    }
+
+    if(value_type == typeid(std::vector<bool>)) {
+      return sol::make_object(ts, sol::as_table(std::any_cast<const std::vector<bool>&>(value)));
+    }
+
+    if(value_type == typeid(std::map<std::string, std::any>)) {
+      sol::table table = sol::state_view(ts).create_table();
+      for (const auto& [key, nested] : std::any_cast<const std::map<std::string, std::any>&>(value)) {
+        table[key] = toLua(nested, ts);
+      }
+      return sol::make_object(ts, table);
+    }
+
+    if(value_type == typeid(std::map<std::string, std::string>)) {
+      return sol::make_object(ts, sol::as_table(std::any_cast<const std::map<std::string, std::string>&>(value)));
+    }
+
+    if(value_type == typeid(std::map<std::string, int64_t>)) {
+      return sol::make_object(ts, sol::as_table(std::any_cast<const std::map<std::string, int64_t>&>(value)));
+    }
+
+    if(value_type == typeid(std::map<std::string, double>)) {
+      return sol::make_object(ts, sol::as_table(std::any_cast<const std::map<std::string, double>&>(value)));
+    }
+
+    if(value_type == typeid(std::map<std::string, bool>)) {
+      return sol::make_object(ts, sol::as_table(std::any_cast<const std::map<std::string, bool>&>(value)));
+    }
+
+    return sol::make_object(ts, sol::lua_nil);
+  }
+
+} // namespace triton
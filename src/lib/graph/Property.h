@@ -21,24 +21,24 @@
 #include <cstdint>
 #include <utility>
 #include <string>
-#include <tsl/sparse_map.h>
+#include <sol.hpp>
 
 namespace triton {
+  // A property of a relationship or of a node being returned, with its key in full since it leaves the shard
   class Property {
   private:
-    uint64_t token_id;
+    std::string key;
     std::any value;
-    inline static tsl::sparse_map<std::string, uint64_t> token_to_id;
-    inline static tsl::sparse_map<uint64_t, std::string> id_to_token;
-    inline static std::string EMPTY = "";
 
   public:
     Property();
     Property(const std::string& key, std::any value);
 
-    [[nodiscard]] std::string getKey() const;
-    uint64_t getTokenId();
-    std::any getValue();
+    [[nodiscard]] const std::string& getKey() const;
+    [[nodiscard]] const std::any& getValue() const;
+
+    // The value as a Lua value, arrays and objects as tables and anything else as nil
+    static sol::object toLua(const std::any& value, sol::this_state ts);
   };
 
 } // namespace triton
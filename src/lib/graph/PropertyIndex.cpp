@@ -0,0 +1,188 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PropertyIndex.h"
+
+#include <cmath>
+#include <limits>
+
+namespace triton {
+
+  PropertyIndex::PropertyIndex() : type(HASH) {}
+
+  PropertyIndex::PropertyIndex(IndexType type) : type(type) {}
+
+  PropertyIndex::IndexType PropertyIndex::getType() const {
+    return type;
+  }
+
+  bool PropertyIndex::toKey(const std::any &value, Key &key) {
+    if (value.type() == typeid(std::string)) {
+      key = std::any_cast<std::string>(value);
+      return true;
+    }
+    if (value.type() == typeid(int64_t)) {
+      key = std::any_cast<int64_t>(value);
+      return true;
+    }
+    if (value.type() == typeid(double)) {
+      double number = std::any_cast<double>(value);
+      if (std::isnan(number)) {
+        return false;
+      }
+      if (number == std::trunc(number) && number >= -9223372036854775808.0 && number < 9223372036854775808.0) {
+        key = static_cast<int64_t>(number);
+      } else {
+        key = number;
+      }
+      return true;
+    }
+    if (value.type() == typeid(bool)) {
+      key = std::any_cast<bool>(value);
+      return true;
+    }
+    return false;
+  }
+
+  void PropertyIndex::add(const std::any &value, uint64_t id) {
+    Key key;
+    if (!toKey(value, key)) {
+      return;
+    }
+    if (type == HASH) {
+      hashed[key].add(id);
+    } else {
+      sorted[key].add(id);
+    }
+  }
+
+  void PropertyIndex::remove(const std::any &value, uint64_t id) {
+    Key key;
+    if (!toKey(value, key)) {
+      return;
+    }
+    // Drop values no node has anymore so ranges do not walk over them
+    if (type == HASH) {
+      auto search = hashed.find(key);
+      if (search != std::end(hashed)) {
+        search->second.remove(id);
+        if (search->second.isEmpty()) {
+          hashed.erase(search);
+        }
+      }
+    } else {
+      auto search = sorted.find(key);
+      if (search != std::end(sorted)) {
+        search->second.remove(id);
+        if (search->second.isEmpty()) {
+          sorted.erase(search);
+        }
+      }
+    }
+  }
+
+  Roaring64Map PropertyIndex::find(const std::any &value) const {
+    Key key;
+    if (toKey(value, key)) {
+      if (type == HASH) {
+        auto search = hashed.find(key);
+        if (search != std::end(hashed)) {
+          return search->second;
+        }
+      } else {
+        auto search = sorted.find(key);
+        if (search != std::end(sorted)) {
+          return search->second;
+        }
+      }
+    }
+    return Roaring64Map();
+  }
+
+  Roaring64Map PropertyIndex::findRange(const std::any &min, const std::any &max) const {
+    Roaring64Map ids;
+    Key min_key;
+    Key max_key;
+    if (!toKey(min, min_key) || !toKey(max, max_key)) {
+      return ids;
+    }
+
+    // A hash index has no order, so every value is checked
+    if (type == HASH) {
+      for (const auto &[key, key_ids] : hashed) {
+        if (inRange(key, min_key, max_key)) {
+          ids |= key_ids;
+        }
+      }
+      return ids;
+    }
+
+    if (isNumber(min_key) && isNumber(max_key)) {
+      // Integers sort before doubles, so the numbers are two runs of keys
+      long double lowest = std::ceil(toNumber(min_key));
+      if (lowest <= static_cast<long double>(std::numeric_limits<int64_t>::max())) {
+        int64_t first = lowest < static_cast<long double>(std::numeric_limits<int64_t>::min()) ? std::numeric_limits<int64_t>::min() : static_cast<int64_t>(lowest);
+        addRange(sorted.lower_bound(Key(first)), min_key, max_key, ids);
+      }
+      addRange(sorted.lower_bound(Key(static_cast<double>(toNumber(min_key)))), min_key, max_key, ids);
+    } else if (min_key.index() == max_key.index()) {
+      addRange(sorted.lower_bound(min_key), min_key, max_key, ids);
+    }
+    return ids;
+  }
+
+  void PropertyIndex::addRange(std::map<Key, Roaring64Map>::const_iterator first, const Key &min, const Key &max, Roaring64Map &ids) const {
+    if (first == std::end(sorted)) {
+      return;
+    }
+    size_t index = first->first.index();
+    for (auto value = first; value != std::end(sorted) && value->first.index() == index; ++value) {
+      if (isAbove(value->first, max)) {
+        break;
+      }
+      if (inRange(value->first, min, max)) {
+        ids |= value->second;
+      }
+    }
+  }
+
+  bool PropertyIndex::isNumber(const Key &key) {
+    return std::holds_alternative<int64_t>(key) || std::holds_alternative<double>(key);
+  }
+
+  long double PropertyIndex::toNumber(const Key &key) {
+    // A long double holds every int64_t exactly, so integers and doubles compare without rounding
+    if (std::holds_alternative<int64_t>(key)) {
+      return static_cast<long double>(std::get<int64_t>(key));
+    }
+    return static_cast<long double>(std::get<double>(key));
+  }
+
+  bool PropertyIndex::isAbove(const Key &key, const Key &max) {
+    if (isNumber(key) && isNumber(max)) {
+      return toNumber(key) > toNumber(max);
+    }
+    return max < key;
+  }
+
+  bool PropertyIndex::inRange(const Key &key, const Key &min, const Key &max) {
+    if (isNumber(min) && isNumber(max)) {
+      return isNumber(key) && toNumber(min) <= toNumber(key) && toNumber(key) <= toNumber(max);
+    }
+    return key.index() == min.index() && min.index() == max.index() && !(key < min) && !(max < key);
+  }
+
+} // namespace triton
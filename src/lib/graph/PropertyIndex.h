@@ -0,0 +1,67 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRITON_PROPERTYINDEX_H
+#define TRITON_PROPERTYINDEX_H
+
+#include <any>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <roaring/roaring64map.hh>
+
+namespace triton {
+  // Secondary index of one property of the nodes of one type, from each value to the ids of the nodes that have it.
+  // A hash index is for equality, a sorted index also walks only the values inside a range.
+  // Whole doubles are keyed as integers, so 5 and 5.0 find the same nodes, arrays and objects are not indexed.
+  class PropertyIndex {
+  public:
+    enum IndexType : uint8_t { HASH, SORTED };
+    using Key = std::variant<bool, int64_t, double, std::string>;
+
+    PropertyIndex();
+
+    explicit PropertyIndex(IndexType type);
+
+    [[nodiscard]] IndexType getType() const;
+
+    void add(const std::any &value, uint64_t id);
+
+    void remove(const std::any &value, uint64_t id);
+
+    [[nodiscard]] Roaring64Map find(const std::any &value) const;
+
+    // Both bounds are included, they must both be numbers or both have the same type
+    [[nodiscard]] Roaring64Map findRange(const std::any &min, const std::any &max) const;
+
+    static bool toKey(const std::any &value, Key &key);
+
+  private:
+    static bool isNumber(const Key &key);
+    static long double toNumber(const Key &key);
+    static bool isAbove(const Key &key, const Key &max);
+    static bool inRange(const Key &key, const Key &min, const Key &max);
+    void addRange(std::map<Key, Roaring64Map>::const_iterator first, const Key &min, const Key &max, Roaring64Map &ids) const;
+
+    IndexType type;
+    std::unordered_map<Key, Roaring64Map> hashed;
+    std::map<Key, Roaring64Map> sorted;
+  };
+} // namespace triton
+
+#endif//TRITON_PROPERTYINDEX_H
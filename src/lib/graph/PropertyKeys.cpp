@@ -0,0 +1,65 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PropertyKeys.h"
+
+#include <limits>
+
+namespace triton {
+
+  PropertyKeys::PropertyKeys() : id_to_key(1) {}
+
+  uint16_t PropertyKeys::getKeyId(std::string_view key) const {
+    auto key_search = key_to_id.find(key);
+    if (key_search != key_to_id.end()) {
+      return key_search->second;
+    }
+    return 0;
+  }
+
+  uint16_t PropertyKeys::insertKey(std::string_view key) {
+    uint16_t id = getKeyId(key);
+    if (id > 0 || id_to_key.size() > std::numeric_limits<uint16_t>::max()) {
+      return id;
+    }
+    id = static_cast<uint16_t>(id_to_key.size());
+    id_to_key.emplace_back(key);
+    key_to_id.emplace(std::string(key), id);
+    return id;
+  }
+
+  const std::string& PropertyKeys::getKey(uint16_t key_id) const {
+    if (key_id < id_to_key.size()) {
+      return id_to_key[key_id];
+    }
+    return id_to_key[0];
+  }
+
+  uint16_t PropertyKeys::getSize() const {
+    return static_cast<uint16_t>(id_to_key.size() - 1);
+  }
+
+  uint64_t PropertyKeys::bytes() const {
+    // Every key is held twice, once by id and once to look its id up. Short ones live inside the string itself
+    uint64_t total = id_to_key.capacity() * sizeof(std::string) + key_to_id.size() * (sizeof(std::string) + sizeof(uint16_t));
+    for (const auto& key : id_to_key) {
+      if (key.capacity() > 15) {
+        total += 2 * key.capacity();
+      }
+    }
+    return total;
+  }
+}// namespace triton
@@ -0,0 +1,56 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRITON_PROPERTYKEYS_H
+#define TRITON_PROPERTYKEYS_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <tsl/sparse_map.h>
+
+namespace triton {
+  // The property keys of one shard of a graph, each with a dense id from 1 in the order it was first written.
+  // The property stores of every type on the shard key their columns by these ids. Only the shard uses its keys,
+  // so they need no lock, and ids never leave it: snapshots, logs and results carry the key itself.
+  class PropertyKeys {
+  public:
+    PropertyKeys();
+
+    // The id of a key, 0 if it was never added
+    [[nodiscard]] uint16_t getKeyId(std::string_view key) const;
+    // The id of a key, added the first time it is seen. 0 once all 65535 ids are taken
+    uint16_t insertKey(std::string_view key);
+    [[nodiscard]] const std::string& getKey(uint16_t key_id) const;
+    // Keys added so far, the highest id
+    [[nodiscard]] uint16_t getSize() const;
+    [[nodiscard]] uint64_t bytes() const;
+
+    // Lets a key be found with a string_view without building a std::string
+    struct KeyHash {
+      using is_transparent = void;
+      size_t operator()(std::string_view key) const { return std::hash<std::string_view>()(key); }
+    };
+
+  private:
+    std::vector<std::string> id_to_key;// Id 0 is the empty key
+    tsl::sparse_map<std::string, uint16_t, KeyHash, std::equal_to<>> key_to_id;
+  };
+}// namespace triton
+
+#endif//TRITON_PROPERTYKEYS_H
@@ -0,0 +1,97 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ReadView.h"
+#include <algorithm>
+
+namespace triton {
+  ReadView::ReadView(uint64_t node_count, uint64_t relationship_count, std::chrono::steady_clock::time_point expires)
+    : node_count(node_count), relationship_count(relationship_count), expires(expires) {}
+
+  uint64_t ReadView::getNodeCount() const {
+    return node_count;
+  }
+
+  uint64_t ReadView::getRelationshipCount() const {
+    return relationship_count;
+  }
+
+  bool ReadView::isExpired(std::chrono::steady_clock::time_point now) const {
+    return now >= expires;
+  }
+
+  void ReadView::setExpires(std::chrono::steady_clock::time_point when) {
+    expires = when;
+  }
+
+  bool ReadView::hasNode(uint64_t internal_id) const {
+    return nodes.find(internal_id) != nodes.end();
+  }
+
+  bool ReadView::hasRelationship(uint64_t internal_id) const {
+    return relationships.find(internal_id) != relationships.end();
+  }
+
+  void ReadView::saveNode(uint64_t internal_id, Node node) {
+    nodes.emplace(internal_id, std::move(node));
+  }
+
+  void ReadView::saveRelationship(uint64_t internal_id, Relationship relationship) {
+    relationships.emplace(internal_id, std::move(relationship));
+  }
+
+  const Node* ReadView::getNode(uint64_t internal_id) const {
+    auto found = nodes.find(internal_id);
+    if (found == nodes.end()) {
+      return nullptr;
+    }
+    return &found->second;
+  }
+
+  const Relationship* ReadView::getRelationship(uint64_t internal_id) const {
+    auto found = relationships.find(internal_id);
+    if (found == relationships.end()) {
+      return nullptr;
+    }
+    return &found->second;
+  }
+
+  std::vector<uint64_t> ReadView::getNodeIds(uint16_t type_id, uint64_t after) const {
+    std::vector<uint64_t> ids;
+    for (const auto& [internal_id, node] : nodes) {
+      if (internal_id > after && node.getTypeId() == type_id) {
+        ids.push_back(internal_id);
+      }
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+  }
+
+  std::vector<uint64_t> ReadView::getRelationshipIds(uint16_t type_id, uint64_t after) const {
+    std::vector<uint64_t> ids;
+    for (const auto& [internal_id, relationship] : relationships) {
+      if (internal_id > after && relationship.getTypeId() == type_id) {
+        ids.push_back(internal_id);
+      }
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+  }
+
+  uint64_t ReadView::getCopies() const {
+    return nodes.size() + relationships.size();
+  }
+}// namespace triton
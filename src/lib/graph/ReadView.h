@@ -0,0 +1,66 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRITON_READVIEW_H
+#define TRITON_READVIEW_H
+
+#include "Node.h"
+#include "Relationship.h"
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace triton {
+  // The nodes and relationships of a shard as they were when the view was opened, kept by copy on write.
+  // Writers save an entity the first time they change it while the view is open, readers take the saved copy when
+  // there is one and the live entity otherwise. Internal ids at or past the counts were added after the view opened.
+  class ReadView {
+  public:
+    ReadView(uint64_t node_count, uint64_t relationship_count, std::chrono::steady_clock::time_point expires);
+
+    [[nodiscard]] uint64_t getNodeCount() const;
+    [[nodiscard]] uint64_t getRelationshipCount() const;
+    [[nodiscard]] bool isExpired(std::chrono::steady_clock::time_point now) const;
+    void setExpires(std::chrono::steady_clock::time_point when);
+
+    // True when the entity was already saved, so only its first change is kept
+    [[nodiscard]] bool hasNode(uint64_t internal_id) const;
+    [[nodiscard]] bool hasRelationship(uint64_t internal_id) const;
+
+    void saveNode(uint64_t internal_id, Node node);
+    void saveRelationship(uint64_t internal_id, Relationship relationship);
+
+    // The saved copy, or nullptr when the entity has not changed since the view opened
+    [[nodiscard]] const Node* getNode(uint64_t internal_id) const;
+    [[nodiscard]] const Relationship* getRelationship(uint64_t internal_id) const;
+
+    // The internal ids after the given one of the saved copies of a type, in order, for scans that walk the ids of a type
+    [[nodiscard]] std::vector<uint64_t> getNodeIds(uint16_t type_id, uint64_t after) const;
+    [[nodiscard]] std::vector<uint64_t> getRelationshipIds(uint16_t type_id, uint64_t after) const;
+
+    [[nodiscard]] uint64_t getCopies() const;
+
+  private:
+    uint64_t node_count;
+    uint64_t relationship_count;
+    std::chrono::steady_clock::time_point expires;
+    std::unordered_map<uint64_t, Node> nodes;
+    std::unordered_map<uint64_t, Relationship> relationships;
+  };
+}// namespace triton
+
+#endif//TRITON_READVIEW_H
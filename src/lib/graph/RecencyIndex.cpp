@@ -0,0 +1,145 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "RecencyIndex.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace triton {
+
+  RecencyIndex::RecencyIndex() = default;
+
+  RecencyIndex::RecencyIndex(std::string property, bool stamp, uint64_t ttl) : property(std::move(property)), stamp(stamp), ttl(ttl) {}
+
+  const std::string& RecencyIndex::getProperty() const {
+    return property;
+  }
+
+  bool RecencyIndex::stamps() const {
+    return stamp;
+  }
+
+  uint64_t RecencyIndex::getTtl() const {
+    return ttl;
+  }
+
+  bool RecencyIndex::toKey(const std::any &value, int64_t &key) {
+    if (value.type() == typeid(int64_t)) {
+      key = std::any_cast<int64_t>(value);
+      return true;
+    }
+    if (value.type() == typeid(double)) {
+      double number = std::any_cast<double>(value);
+      // Outside of this range the cast is undefined
+      if (std::trunc(number) == number && number >= -9.2e18 && number <= 9.2e18) {
+        key = static_cast<int64_t>(number);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  int64_t RecencyIndex::now() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+  }
+
+  void RecencyIndex::add(uint64_t node_id, int64_t key, uint64_t rel_id) {
+    std::vector<Entry> &entries = nodes[node_id];
+    Entry entry{key, rel_id};
+    // Relationships mostly arrive newer than the ones before them, so this is usually an append
+    if (entries.empty() || entries.back() < entry) {
+      entries.push_back(entry);
+    } else {
+      auto position = std::lower_bound(entries.begin(), entries.end(), entry);
+      if (position != entries.end() && !(entry < *position)) {
+        return;
+      }
+      entries.insert(position, entry);
+    }
+    if (ttl > 0) {
+      expiring.insert(entry);
+    }
+    count++;
+  }
+
+  bool RecencyIndex::remove(uint64_t node_id, int64_t key, uint64_t rel_id) {
+    auto found = nodes.find(node_id);
+    if (found == nodes.end()) {
+      return false;
+    }
+    std::vector<Entry> &entries = found->second;
+    Entry entry{key, rel_id};
+    auto position = std::lower_bound(entries.begin(), entries.end(), entry);
+    if (position == entries.end() || entry < *position) {
+      return false;
+    }
+    entries.erase(position);
+    if (entries.empty()) {
+      nodes.erase(found);
+    }
+    expiring.erase(entry);
+    count--;
+    return true;
+  }
+
+  void RecencyIndex::clear() {
+    nodes.clear();
+    expiring.clear();
+    count = 0;
+  }
+
+  std::vector<RecencyIndex::Entry> RecencyIndex::newest(uint64_t node_id, int64_t since, int64_t until, uint64_t limit) const {
+    std::vector<Entry> found;
+    auto search = nodes.find(node_id);
+    if (search == nodes.end() || since > until) {
+      return found;
+    }
+    const std::vector<Entry> &entries = search->second;
+    // Walk back from the newest entry inside the window
+    auto first = std::lower_bound(entries.begin(), entries.end(), Entry{since, 0});
+    auto last = std::upper_bound(entries.begin(), entries.end(), Entry{until, std::numeric_limits<uint64_t>::max()});
+    found.reserve(std::min<uint64_t>(limit, static_cast<uint64_t>(last - first)));
+    while (last != first && found.size() < limit) {
+      --last;
+      found.push_back(*last);
+    }
+    return found;
+  }
+
+  std::vector<RecencyIndex::Entry> RecencyIndex::before(int64_t cutoff, uint64_t limit) const {
+    std::vector<Entry> found;
+    for (auto entry = expiring.begin(); entry != expiring.end() && entry->key < cutoff && found.size() < limit; ++entry) {
+      found.push_back(*entry);
+    }
+    return found;
+  }
+
+  uint64_t RecencyIndex::size() const {
+    return count;
+  }
+
+  uint64_t RecencyIndex::bytes() const {
+    // A tree node holds an entry, three pointers and a color
+    uint64_t total = nodes.bucket_count() * sizeof(void*) + expiring.size() * (sizeof(Entry) + 4 * sizeof(void*));
+    for (const auto &[node_id, entries] : nodes) {
+      total += sizeof(node_id) + sizeof(entries) + sizeof(void*) + entries.capacity() * sizeof(Entry);
+    }
+    return total;
+  }
+
+} // namespace triton
@@ -0,0 +1,79 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRITON_RECENCYINDEX_H
+#define TRITON_RECENCYINDEX_H
+
+#include <any>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace triton {
+  // Outgoing relationships of one type ordered by a numeric property, kept for each starting node so the newest of them, or
+  // the ones inside a window of the property, are found without reading the whole adjacency list of the node.
+  // Keys are meant to be milliseconds since the epoch, relationships without a number in the property are left out.
+  class RecencyIndex {
+  public:
+    struct Entry {
+      int64_t key;
+      uint64_t rel_id;
+
+      bool operator<(const Entry& other) const {
+        return key < other.key || (key == other.key && rel_id < other.rel_id);
+      }
+    };
+
+    RecencyIndex();
+    // Stamp writes the time a relationship arrives into the property when it comes without one,
+    // relationships whose key is more than ttl milliseconds old expire, zero keeps them
+    RecencyIndex(std::string property, bool stamp, uint64_t ttl);
+
+    [[nodiscard]] const std::string& getProperty() const;
+    [[nodiscard]] bool stamps() const;
+    [[nodiscard]] uint64_t getTtl() const;
+
+    // Integers and whole doubles are keys, anything else is not indexed
+    static bool toKey(const std::any& value, int64_t& key);
+    // Milliseconds since the epoch, what stamping indexes write and ttls are counted back from
+    static int64_t now();
+
+    void add(uint64_t node_id, int64_t key, uint64_t rel_id);
+    bool remove(uint64_t node_id, int64_t key, uint64_t rel_id);
+    void clear();
+
+    // The relationships of the node with a key from since to until, both included, newest first and at most limit of them
+    [[nodiscard]] std::vector<Entry> newest(uint64_t node_id, int64_t since, int64_t until, uint64_t limit) const;
+    // Relationships of any node with a key before cutoff, oldest first and at most limit of them
+    [[nodiscard]] std::vector<Entry> before(int64_t cutoff, uint64_t limit) const;
+
+    [[nodiscard]] uint64_t size() const;
+    [[nodiscard]] uint64_t bytes() const;
+
+  private:
+    std::string property;
+    bool stamp = false;
+    uint64_t ttl = 0;
+    uint64_t count = 0;
+    std::unordered_map<uint64_t, std::vector<Entry>> nodes;// Entries of each starting node sorted by key
+    std::set<Entry> expiring;// Every entry in key order, only kept when there is a ttl
+  };
+} // namespace triton
+
+#endif//TRITON_RECENCYINDEX_H
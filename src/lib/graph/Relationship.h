@@ -54,8 +54,13 @@ namespace triton {
 
     [[nodiscard]] std::map<std::string, std::any> getProperties();
 
+    [[nodiscard]] const std::vector<Property>& getPropertyList() const;
+
     sol::table getPropertiesLua(sol::this_state ts);
 
+    // One property read from the relationship without building the table of all of them
+    sol::object getPropertyLua(const std::string& property, sol::this_state ts);
+
     std::any getProperty(const std::string& property);
 
     void setProperty(const std::string& property, const std::any& value);
@@ -0,0 +1,165 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "RelationshipStore.h"
+
+namespace triton {
+
+  RelationshipStore::RelationshipStore() : keys(std::make_shared<PropertyKeys>()) {}
+
+  RelationshipStore::RelationshipStore(std::shared_ptr<PropertyKeys> keys) : keys(std::move(keys)) {}
+
+  void RelationshipStore::reserve(uint64_t count) {
+    type_ids.reserve(count);
+    starting_node_ids.reserve(count);
+    ending_node_ids.reserve(count);
+    property_rows.reserve(count);
+  }
+
+  void RelationshipStore::clear() {
+    type_ids.clear();
+    starting_node_ids.clear();
+    ending_node_ids.clear();
+    property_rows.clear();
+    properties.clear();
+  }
+
+  void RelationshipStore::shrink_to_fit() {
+    type_ids.shrink_to_fit();
+    starting_node_ids.shrink_to_fit();
+    ending_node_ids.shrink_to_fit();
+    property_rows.shrink_to_fit();
+  }
+
+  void RelationshipStore::pop_back() {
+    type_ids.pop_back();
+    starting_node_ids.pop_back();
+    ending_node_ids.pop_back();
+    property_rows.pop_back();
+  }
+
+  void RelationshipStore::set(uint64_t internal_id, uint16_t type_id, uint64_t starting_node_id, uint64_t ending_node_id,
+                              const std::map<std::string, std::any> &values) {
+    if (internal_id >= type_ids.size()) {
+      type_ids.resize(internal_id + 1, 0);
+      starting_node_ids.resize(internal_id + 1, 0);
+      ending_node_ids.resize(internal_id + 1, 0);
+      property_rows.resize(internal_id + 1, 0);
+    }
+    remove(internal_id);
+    type_ids[internal_id] = type_id;
+    starting_node_ids[internal_id] = starting_node_id;
+    ending_node_ids[internal_id] = ending_node_id;
+    // Empty slots have no row, every relationship has one even without properties
+    if (type_id == 0) {
+      property_rows[internal_id] = 0;
+      return;
+    }
+    Properties& store = storeOf(type_id);
+    property_rows[internal_id] = store.addRow();
+    for (const auto& [key, value] : values) {
+      store.setProperty(property_rows[internal_id], key, value);
+    }
+  }
+
+  void RelationshipStore::remove(uint64_t internal_id) {
+    uint16_t type_id = type_ids[internal_id];
+    if (type_id == 0) {
+      return;
+    }
+    storeOf(type_id).removeRow(property_rows[internal_id]);
+    type_ids[internal_id] = 0;
+    starting_node_ids[internal_id] = 0;
+    ending_node_ids[internal_id] = 0;
+    property_rows[internal_id] = 0;
+  }
+
+  Properties& RelationshipStore::storeOf(uint16_t type_id) {
+    return properties.try_emplace(type_id, keys).first->second;
+  }
+
+  const Properties* RelationshipStore::findStore(uint64_t internal_id) const {
+    auto store = properties.find(type_ids[internal_id]);
+    if (type_ids[internal_id] == 0 || store == std::end(properties)) {
+      return nullptr;
+    }
+    return &store->second;
+  }
+
+  Relationship RelationshipStore::get(uint64_t internal_id, uint64_t id) const {
+    if (type_ids[internal_id] == 0) {
+      return Relationship();
+    }
+    return Relationship(id, starting_node_ids[internal_id], ending_node_ids[internal_id], type_ids[internal_id], getProperties(internal_id));
+  }
+
+  Relationship RelationshipStore::getEndpoints(uint64_t internal_id, uint64_t id) const {
+    if (type_ids[internal_id] == 0) {
+      return Relationship();
+    }
+    return Relationship(id, starting_node_ids[internal_id], ending_node_ids[internal_id], type_ids[internal_id]);
+  }
+
+  std::any RelationshipStore::getProperty(uint64_t internal_id, const std::string &key) const {
+    const Properties* store = findStore(internal_id);
+    if (store == nullptr) {
+      return std::any();
+    }
+    return store->getProperty(property_rows[internal_id], key);
+  }
+
+  void RelationshipStore::setProperty(uint64_t internal_id, const std::string &key, const std::any &value) {
+    if (type_ids[internal_id] != 0) {
+      storeOf(type_ids[internal_id]).setProperty(property_rows[internal_id], key, value);
+    }
+  }
+
+  bool RelationshipStore::deleteProperty(uint64_t internal_id, const std::string &key) {
+    if (type_ids[internal_id] == 0) {
+      return false;
+    }
+    return storeOf(type_ids[internal_id]).deleteProperty(property_rows[internal_id], key);
+  }
+
+  std::map<std::string, std::any> RelationshipStore::getProperties(uint64_t internal_id) const {
+    const Properties* store = findStore(internal_id);
+    if (store == nullptr) {
+      return std::map<std::string, std::any>();
+    }
+    return store->getProperties(property_rows[internal_id]);
+  }
+
+  void RelationshipStore::setProperties(uint64_t internal_id, const std::map<std::string, std::any> &values) {
+    if (type_ids[internal_id] != 0) {
+      storeOf(type_ids[internal_id]).setProperties(property_rows[internal_id], values);
+    }
+  }
+
+  void RelationshipStore::deleteProperties(uint64_t internal_id) {
+    if (type_ids[internal_id] != 0) {
+      storeOf(type_ids[internal_id]).deleteProperties(property_rows[internal_id]);
+    }
+  }
+
+  uint64_t RelationshipStore::bytes() const {
+    uint64_t total = type_ids.capacity() * sizeof(uint16_t) + (starting_node_ids.capacity() + ending_node_ids.capacity() + property_rows.capacity()) * sizeof(uint64_t);
+    for (const auto& [type_id, store] : properties) {
+      total += store.bytes();
+    }
+    return total;
+  }
+
+} // namespace triton
@@ -0,0 +1,89 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRITON_RELATIONSHIPSTORE_H
+#define TRITON_RELATIONSHIPSTORE_H
+
+#include <any>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Properties.h"
+#include "Relationship.h"
+
+namespace triton {
+  // Relationships kept as parallel arrays of their type and of the nodes at both ends, indexed by internal id, so scans and
+  // expansions read only the fields they need. Their properties are in a columnar store for each relationship type.
+  // A slot of type 0 is empty: the zero relationship, a removed one or one that has not arrived yet.
+  class RelationshipStore {
+  public:
+    // A store with property keys of its own
+    RelationshipStore();
+    // A store whose property columns use the keys of its shard
+    explicit RelationshipStore(std::shared_ptr<PropertyKeys> keys);
+
+    [[nodiscard]] uint64_t size() const { return type_ids.size(); }
+    [[nodiscard]] bool empty() const { return type_ids.empty(); }
+    [[nodiscard]] uint64_t max_size() const { return type_ids.max_size(); }
+    void reserve(uint64_t count);
+    void clear();
+    void shrink_to_fit();
+    // Drop the last slot, which is empty
+    void pop_back();
+
+    // Put a relationship in an empty slot or one past the end
+    void set(uint64_t internal_id, uint16_t type_id, uint64_t starting_node_id, uint64_t ending_node_id,
+             const std::map<std::string, std::any>& values = std::map<std::string, std::any>());
+    // Empty the slot and let go of its properties
+    void remove(uint64_t internal_id);
+
+    [[nodiscard]] uint16_t getTypeId(uint64_t internal_id) const { return type_ids[internal_id]; }
+    [[nodiscard]] uint64_t getStartingNodeId(uint64_t internal_id) const { return starting_node_ids[internal_id]; }
+    [[nodiscard]] uint64_t getEndingNodeId(uint64_t internal_id) const { return ending_node_ids[internal_id]; }
+
+    // A copy with every property to hand out, an empty relationship for an empty slot
+    [[nodiscard]] Relationship get(uint64_t internal_id, uint64_t id) const;
+    // Only the type and both ends, the properties stay in their columns
+    [[nodiscard]] Relationship getEndpoints(uint64_t internal_id, uint64_t id) const;
+
+    [[nodiscard]] std::any getProperty(uint64_t internal_id, const std::string& key) const;
+    void setProperty(uint64_t internal_id, const std::string& key, const std::any& value);
+    bool deleteProperty(uint64_t internal_id, const std::string& key);
+    [[nodiscard]] std::map<std::string, std::any> getProperties(uint64_t internal_id) const;
+    void setProperties(uint64_t internal_id, const std::map<std::string, std::any>& values);
+    void deleteProperties(uint64_t internal_id);
+
+    // Bytes held by the arrays and by the property columns
+    [[nodiscard]] uint64_t bytes() const;
+
+  private:
+    std::vector<uint16_t> type_ids;
+    std::vector<uint64_t> starting_node_ids;
+    std::vector<uint64_t> ending_node_ids;
+    std::vector<uint64_t> property_rows;// Row of each relationship in the property store of its type
+    std::shared_ptr<PropertyKeys> keys;// Shared by the stores of every type
+    std::unordered_map<uint16_t, Properties> properties;// Columnar store of the properties by relationship type
+
+    const Properties* findStore(uint64_t internal_id) const;
+    // The store of a type, made with the shared keys the first time
+    Properties& storeOf(uint16_t type_id);
+  };
+} // namespace triton
+
+#endif//TRITON_RELATIONSHIPSTORE_H
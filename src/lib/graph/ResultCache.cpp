@@ -0,0 +1,102 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "ResultCache.h"
+
+namespace triton {
+  ResultCache::ResultCache(uint64_t max_bytes) : max_bytes(max_bytes) {}
+
+  void ResultCache::resize(uint64_t new_max_bytes) {
+    max_bytes = new_max_bytes;
+    while (bytes > max_bytes) {
+      erase(std::prev(entries.end()));
+      evictions++;
+    }
+  }
+
+  bool ResultCache::enabled() const {
+    return max_bytes > 0;
+  }
+
+  bool ResultCache::get(const std::string &key, uint64_t epoch, std::string &result) {
+    auto found = index.find(key);
+    if (found == index.end()) {
+      misses++;
+      return false;
+    }
+    if (found->second->epoch != epoch) {
+      // The graph changed since, so it will never be valid again
+      erase(found->second);
+      misses++;
+      return false;
+    }
+    entries.splice(entries.begin(), entries, found->second);
+    result = found->second->result;
+    hits++;
+    return true;
+  }
+
+  void ResultCache::put(const std::string &key, uint64_t epoch, std::string result) {
+    uint64_t size = key.size() + result.size();
+    auto found = index.find(key);
+    if (found != index.end()) {
+      erase(found->second);
+    }
+    if (size > max_bytes) {
+      return;
+    }
+    while (bytes + size > max_bytes) {
+      erase(std::prev(entries.end()));
+      evictions++;
+    }
+    entries.push_front({key, epoch, std::move(result)});
+    index.emplace(entries.front().key, entries.begin());
+    bytes += size;
+  }
+
+  void ResultCache::clear() {
+    index.clear();
+    entries.clear();
+    bytes = 0;
+  }
+
+  uint64_t ResultCache::getHits() const {
+    return hits;
+  }
+
+  uint64_t ResultCache::getMisses() const {
+    return misses;
+  }
+
+  uint64_t ResultCache::getEvictions() const {
+    return evictions;
+  }
+
+  uint64_t ResultCache::getBytes() const {
+    return bytes;
+  }
+
+  uint64_t ResultCache::getSize() const {
+    return entries.size();
+  }
+
+  void ResultCache::erase(std::list<Entry>::iterator entry) {
+    bytes -= entry->key.size() + entry->result.size();
+    index.erase(entry->key);
+    entries.erase(entry);
+  }
+}// namespace triton
@@ -0,0 +1,72 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef TRITON_RESULTCACHE_H
+#define TRITON_RESULTCACHE_H
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace triton {
+  // Least recently used results of read only requests, up to about max_bytes of keys and results.
+  // Every result is stamped with the mutation epoch of the graph it was computed at, a result from any other epoch is stale.
+  class ResultCache {
+  public:
+    explicit ResultCache(uint64_t max_bytes = 0);
+
+    // Zero disables the cache and drops every result
+    void resize(uint64_t max_bytes);
+
+    [[nodiscard]] bool enabled() const;
+
+    // False when the key is missing or its result is from another epoch, which drops it
+    bool get(const std::string &key, uint64_t epoch, std::string &result);
+
+    // Results larger than the whole cache are not kept
+    void put(const std::string &key, uint64_t epoch, std::string result);
+
+    void clear();
+
+    [[nodiscard]] uint64_t getHits() const;
+    [[nodiscard]] uint64_t getMisses() const;
+    [[nodiscard]] uint64_t getEvictions() const;
+    [[nodiscard]] uint64_t getBytes() const;
+    [[nodiscard]] uint64_t getSize() const;
+
+  private:
+    struct Entry {
+      std::string key;
+      uint64_t epoch;
+      std::string result;
+    };
+
+    uint64_t max_bytes;
+    uint64_t bytes = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    std::list<Entry> entries;// Most recently used first
+    std::unordered_map<std::string_view, std::list<Entry>::iterator> index;// Keys point into their entry
+
+    void erase(std::list<Entry>::iterator entry);
+  };
+}// namespace triton
+
+#endif//TRITON_RESULTCACHE_H
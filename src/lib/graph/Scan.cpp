@@ -0,0 +1,105 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Scan.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace triton {
+
+  template <typename T>
+  static bool compareValue(const T &left, ScanOperator scan_operator, const T &right) {
+    switch (scan_operator) {
+      case ScanOperator::EQ: return left == right;
+      case ScanOperator::NE: return left != right;
+      case ScanOperator::LT: return left < right;
+      case ScanOperator::LE: return left <= right;
+      case ScanOperator::GT: return left > right;
+      case ScanOperator::GE: return left >= right;
+    }
+    return false;
+  }
+
+  static bool isNumber(const std::any &value) {
+    return value.type() == typeid(int64_t) || value.type() == typeid(double);
+  }
+
+  static double toDouble(const std::any &value) {
+    if (value.type() == typeid(int64_t)) {
+      return static_cast<double>(std::any_cast<int64_t>(value));
+    }
+    return std::any_cast<double>(value);
+  }
+
+  ScanFilter::ScanFilter(std::string property, ScanOperator scan_operator, std::any value) : property(std::move(property)), scan_operator(scan_operator), value(std::move(value)) {}
+
+  bool ScanFilter::matches(const std::any &candidate) const {
+    if (candidate.type() == typeid(int64_t) && value.type() == typeid(int64_t)) {
+      return compareValue(std::any_cast<int64_t>(candidate), scan_operator, std::any_cast<int64_t>(value));
+    }
+    if (isNumber(candidate) && isNumber(value)) {
+      return compareValue(toDouble(candidate), scan_operator, toDouble(value));
+    }
+    if (candidate.type() == typeid(std::string) && value.type() == typeid(std::string)) {
+      return compareValue(std::any_cast<const std::string&>(candidate), scan_operator, std::any_cast<const std::string&>(value));
+    }
+    if (candidate.type() == typeid(bool) && value.type() == typeid(bool)) {
+      return compareValue(std::any_cast<bool>(candidate), scan_operator, std::any_cast<bool>(value));
+    }
+    return false;
+  }
+
+  bool ScanFilter::toOperator(std::string_view name, ScanOperator &scan_operator) {
+    if (name == "==") {
+      scan_operator = ScanOperator::EQ;
+    } else if (name == "!=") {
+      scan_operator = ScanOperator::NE;
+    } else if (name == "<") {
+      scan_operator = ScanOperator::LT;
+    } else if (name == "<=") {
+      scan_operator = ScanOperator::LE;
+    } else if (name == ">") {
+      scan_operator = ScanOperator::GT;
+    } else if (name == ">=") {
+      scan_operator = ScanOperator::GE;
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+  Aggregate::Aggregate() : count(0), sum(0), min(std::numeric_limits<double>::max()), max(std::numeric_limits<double>::lowest()) {}
+
+  void Aggregate::add(double value) {
+    count++;
+    sum += value;
+    min = std::min(min, value);
+    max = std::max(max, value);
+  }
+
+  void Aggregate::merge(const Aggregate &other) {
+    count += other.count;
+    sum += other.sum;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+  }
+
+  double Aggregate::average() const {
+    return count > 0 ? sum / count : 0;
+  }
+
+} // namespace triton
@@ -0,0 +1,63 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRITON_SCAN_H
+#define TRITON_SCAN_H
+
+#include <any>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+
+namespace triton {
+
+  enum class ScanOperator {
+    EQ, NE, LT, LE, GT, GE
+  };
+
+  // Keeps the rows whose property compares to the value, numbers compare with numbers and strings with strings
+  class ScanFilter {
+  public:
+    ScanFilter(std::string property, ScanOperator scan_operator, std::any value);
+    std::string property;
+    ScanOperator scan_operator;
+    std::any value;
+
+    // Numbers compare with numbers, strings with strings and booleans with booleans, anything else does not match
+    [[nodiscard]] bool matches(const std::any &candidate) const;
+
+    // From "==", "!=", "<", "<=", ">" or ">="
+    static bool toOperator(std::string_view name, ScanOperator &scan_operator);
+  };
+
+  // Count, sum, min and max of the numbers of one property, each shard makes one and they are merged
+  class Aggregate {
+  public:
+    Aggregate();
+    uint64_t count;
+    double sum;
+    double min;
+    double max;
+
+    void add(double value);
+    void merge(const Aggregate &other);
+    [[nodiscard]] double average() const;
+  };
+
+}// namespace triton
+
+#endif//TRITON_SCAN_H
@@ -0,0 +1,351 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Serializer.h"
+#include <cstring>
+
+namespace triton {
+
+  Serializer::Serializer(std::string &buffer) : buffer(buffer) {}
+
+  void Serializer::put(uint8_t value) {
+    buffer.push_back(static_cast<char>(value));
+  }
+
+  void Serializer::put(uint16_t value) {
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(value));
+  }
+
+  void Serializer::put(uint32_t value) {
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(value));
+  }
+
+  void Serializer::put(uint64_t value) {
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(value));
+  }
+
+  void Serializer::put(int64_t value) {
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(value));
+  }
+
+  void Serializer::put(double value) {
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(value));
+  }
+
+  void Serializer::put(bool value) {
+    put(static_cast<uint8_t>(value));
+  }
+
+  void Serializer::put(const std::string &value) {
+    put(static_cast<uint64_t>(value.size()));
+    buffer.append(value);
+  }
+
+  void Serializer::put(const std::any &value) {
+    // Tag each value with its type, these are the types convertProperties produces
+    if (value.type() == typeid(int64_t)) {
+      put(static_cast<uint8_t>(INTEGER));
+      put(std::any_cast<int64_t>(value));
+    } else if (value.type() == typeid(double)) {
+      put(static_cast<uint8_t>(DOUBLE));
+      put(std::any_cast<double>(value));
+    } else if (value.type() == typeid(bool)) {
+      put(static_cast<uint8_t>(BOOLEAN));
+      put(std::any_cast<bool>(value));
+    } else if (value.type() == typeid(std::string)) {
+      put(static_cast<uint8_t>(STRING));
+      put(std::any_cast<const std::string &>(value));
+    } else if (value.type() == typeid(std::map<std::string, std::any>)) {
+      put(static_cast<uint8_t>(OBJECT));
+      put(std::any_cast<const std::map<std::string, std::any> &>(value));
+    } else if (value.type() == typeid(std::vector<int64_t>)) {
+      put(static_cast<uint8_t>(INTEGER_ARRAY));
+      const auto &array = std::any_cast<const std::vector<int64_t> &>(value);
+      put(static_cast<uint64_t>(array.size()));
+      for (int64_t item : array) {
+        put(item);
+      }
+    } else if (value.type() == typeid(std::vector<double>)) {
+      put(static_cast<uint8_t>(DOUBLE_ARRAY));
+      const auto &array = std::any_cast<const std::vector<double> &>(value);
+      put(static_cast<uint64_t>(array.size()));
+      for (double item : array) {
+        put(item);
+      }
+    } else if (value.type() == typeid(std::vector<bool>)) {
+      put(static_cast<uint8_t>(BOOLEAN_ARRAY));
+      const auto &array = std::any_cast<const std::vector<bool> &>(value);
+      put(static_cast<uint64_t>(array.size()));
+      for (bool item : array) {
+        put(item);
+      }
+    } else if (value.type() == typeid(std::vector<std::string>)) {
+      put(static_cast<uint8_t>(STRING_ARRAY));
+      const auto &array = std::any_cast<const std::vector<std::string> &>(value);
+      put(static_cast<uint64_t>(array.size()));
+      for (const auto &item : array) {
+        put(item);
+      }
+    } else if (value.type() == typeid(std::vector<std::map<std::string, std::any>>)) {
+      put(static_cast<uint8_t>(OBJECT_ARRAY));
+      const auto &array = std::any_cast<const std::vector<std::map<std::string, std::any>> &>(value);
+      put(static_cast<uint64_t>(array.size()));
+      for (const auto &item : array) {
+        put(item);
+      }
+    } else {
+      // Anything else can not be stored
+      put(static_cast<uint8_t>(EMPTY));
+    }
+  }
+
+  void Serializer::put(const std::map<std::string, std::any> &values) {
+    put(static_cast<uint64_t>(values.size()));
+    for (const auto &[key, value] : values) {
+      put(key);
+      put(value);
+    }
+  }
+
+  void Serializer::put(const std::map<uint16_t, std::vector<uint64_t>> &grouped_ids) {
+    put(static_cast<uint64_t>(grouped_ids.size()));
+    for (const auto &[type_id, ids] : grouped_ids) {
+      put(type_id);
+      put(static_cast<uint64_t>(ids.size()));
+      for (uint64_t id : ids) {
+        put(id);
+      }
+    }
+  }
+
+  void Serializer::put(const std::vector<uint64_t> &values) {
+    // Plain arrays of numbers are copied as they are laid out in memory
+    put(static_cast<uint64_t>(values.size()));
+    buffer.append(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(uint64_t));
+  }
+
+  void Serializer::put(const std::vector<int64_t> &values) {
+    put(static_cast<uint64_t>(values.size()));
+    buffer.append(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(int64_t));
+  }
+
+  void Serializer::put(const std::vector<double> &values) {
+    put(static_cast<uint64_t>(values.size()));
+    buffer.append(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(double));
+  }
+
+  void Serializer::put(const std::vector<float> &values) {
+    put(static_cast<uint64_t>(values.size()));
+    buffer.append(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(float));
+  }
+
+  void Serializer::put(const Roaring64Map &bitmap) {
+    size_t length = bitmap.getSizeInBytes();
+    put(static_cast<uint64_t>(length));
+    size_t start = buffer.size();
+    buffer.resize(start + length);
+    bitmap.write(buffer.data() + start);
+  }
+
+  Deserializer::Deserializer(const char *data, size_t size) : data(data), size(size), position(0), error(false) {}
+
+  bool Deserializer::failed() const {
+    return error;
+  }
+
+  bool Deserializer::done() const {
+    return position == size;
+  }
+
+  bool Deserializer::read(void *value, size_t length) {
+    if (error || length > size - position) {
+      error = true;
+      return false;
+    }
+    std::memcpy(value, data + position, length);
+    position += length;
+    return true;
+  }
+
+  uint8_t Deserializer::getUint8() {
+    uint8_t value = 0;
+    read(&value, sizeof(value));
+    return value;
+  }
+
+  uint16_t Deserializer::getUint16() {
+    uint16_t value = 0;
+    read(&value, sizeof(value));
+    return value;
+  }
+
+  uint32_t Deserializer::getUint32() {
+    uint32_t value = 0;
+    read(&value, sizeof(value));
+    return value;
+  }
+
+  uint64_t Deserializer::getUint64() {
+    uint64_t value = 0;
+    read(&value, sizeof(value));
+    return value;
+  }
+
+  int64_t Deserializer::getInt64() {
+    int64_t value = 0;
+    read(&value, sizeof(value));
+    return value;
+  }
+
+  double Deserializer::getDouble() {
+    double value = 0;
+    read(&value, sizeof(value));
+    return value;
+  }
+
+  bool Deserializer::getBoolean() {
+    return getUint8() != 0;
+  }
+
+  std::string Deserializer::getString() {
+    uint64_t length = getUint64();
+    if (error || length > size - position) {
+      error = true;
+      return std::string();
+    }
+    std::string value(data + position, length);
+    position += length;
+    return value;
+  }
+
+  std::any Deserializer::getAny() {
+    switch (getUint8()) {
+    case Serializer::INTEGER:
+      return getInt64();
+    case Serializer::DOUBLE:
+      return getDouble();
+    case Serializer::BOOLEAN:
+      return getBoolean();
+    case Serializer::STRING:
+      return getString();
+    case Serializer::OBJECT:
+      return getProperties();
+    case Serializer::INTEGER_ARRAY: {
+      std::vector<int64_t> array;
+      for (uint64_t count = getUint64(); count > 0 && !error; count--) {
+        array.emplace_back(getInt64());
+      }
+      return array;
+    }
+    case Serializer::DOUBLE_ARRAY: {
+      std::vector<double> array;
+      for (uint64_t count = getUint64(); count > 0 && !error; count--) {
+        array.emplace_back(getDouble());
+      }
+      return array;
+    }
+    case Serializer::BOOLEAN_ARRAY: {
+      std::vector<bool> array;
+      for (uint64_t count = getUint64(); count > 0 && !error; count--) {
+        array.emplace_back(getBoolean());
+      }
+      return array;
+    }
+    case Serializer::STRING_ARRAY: {
+      std::vector<std::string> array;
+      for (uint64_t count = getUint64(); count > 0 && !error; count--) {
+        array.emplace_back(getString());
+      }
+      return array;
+    }
+    case Serializer::OBJECT_ARRAY: {
+      std::vector<std::map<std::string, std::any>> array;
+      for (uint64_t count = getUint64(); count > 0 && !error; count--) {
+        array.emplace_back(getProperties());
+      }
+      return array;
+    }
+    default:
+      return std::any();
+    }
+  }
+
+  std::map<std::string, std::any> Deserializer::getProperties() {
+    std::map<std::string, std::any> values;
+    for (uint64_t count = getUint64(); count > 0 && !error; count--) {
+      std::string key = getString();
+      std::any value = getAny();
+      if (value.has_value()) {
+        values.emplace(key, value);
+      }
+    }
+    return values;
+  }
+
+  std::map<uint16_t, std::vector<uint64_t>> Deserializer::getGroupedIds() {
+    std::map<uint16_t, std::vector<uint64_t>> grouped_ids;
+    for (uint64_t count = getUint64(); count > 0 && !error; count--) {
+      uint16_t type_id = getUint16();
+      std::vector<uint64_t> ids;
+      for (uint64_t id_count = getUint64(); id_count > 0 && !error; id_count--) {
+        ids.emplace_back(getUint64());
+      }
+      grouped_ids.emplace(type_id, ids);
+    }
+    return grouped_ids;
+  }
+
+  template <typename T>
+  std::vector<T> Deserializer::readArray() {
+    uint64_t count = getUint64();
+    if (error || count > (size - position) / sizeof(T)) {
+      error = true;
+      return std::vector<T>();
+    }
+    std::vector<T> values(count);
+    if (count > 0) {
+      read(values.data(), count * sizeof(T));
+    }
+    return values;
+  }
+
+  std::vector<uint64_t> Deserializer::getUint64s() {
+    return readArray<uint64_t>();
+  }
+
+  std::vector<int64_t> Deserializer::getInt64s() {
+    return readArray<int64_t>();
+  }
+
+  std::vector<double> Deserializer::getDoubles() {
+    return readArray<double>();
+  }
+
+  std::vector<float> Deserializer::getFloats() {
+    return readArray<float>();
+  }
+
+  Roaring64Map Deserializer::getBitmap() {
+    uint64_t length = getUint64();
+    if (error || length > size - position) {
+      error = true;
+      return Roaring64Map();
+    }
+    Roaring64Map bitmap = Roaring64Map::read(data + position);
+    position += length;
+    return bitmap;
+  }
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRITON_SERIALIZER_H
+#define TRITON_SERIALIZER_H
+
+#include <any>
+#include <cstdint>
+#include <map>
+#include <roaring/roaring64map.hh>
+#include <string>
+#include <vector>
+
+namespace triton {
+  // Little endian binary encoding of ids, strings and property values, used by the command log and snapshots.
+  class Serializer {
+  public:
+    explicit Serializer(std::string &buffer);
+
+    void put(uint8_t value);
+    void put(uint16_t value);
+    void put(uint32_t value);
+    void put(uint64_t value);
+    void put(int64_t value);
+    void put(double value);
+    void put(bool value);
+    void put(const std::string &value);
+    void put(const std::any &value);
+    void put(const std::map<std::string, std::any> &values);
+    void put(const std::map<uint16_t, std::vector<uint64_t>> &grouped_ids);
+    void put(const std::vector<uint64_t> &values);
+    void put(const std::vector<int64_t> &values);
+    void put(const std::vector<double> &values);
+    void put(const std::vector<float> &values);
+    void put(const Roaring64Map &bitmap);
+
+  private:
+    enum ValueType : uint8_t { EMPTY, INTEGER, DOUBLE, BOOLEAN, STRING, OBJECT, INTEGER_ARRAY, DOUBLE_ARRAY, BOOLEAN_ARRAY, STRING_ARRAY, OBJECT_ARRAY };
+    friend class Deserializer;
+
+    std::string &buffer;
+  };
+
+  // Reads back what a Serializer wrote, reading past the end marks it as failed instead of throwing.
+  class Deserializer {
+  public:
+    Deserializer(const char *data, size_t size);
+
+    [[nodiscard]] bool failed() const;
+    [[nodiscard]] bool done() const;
+
+    uint8_t getUint8();
+    uint16_t getUint16();
+    uint32_t getUint32();
+    uint64_t getUint64();
+    int64_t getInt64();
+    double getDouble();
+    bool getBoolean();
+    std::string getString();
+    std::any getAny();
+    std::map<std::string, std::any> getProperties();
+    std::map<uint16_t, std::vector<uint64_t>> getGroupedIds();
+    std::vector<uint64_t> getUint64s();
+    std::vector<int64_t> getInt64s();
+    std::vector<double> getDoubles();
+    std::vector<float> getFloats();
+    Roaring64Map getBitmap();
+
+  private:
+    const char *data;
+    size_t size;
+    size_t position;
+    bool error;
+
+    bool read(void *value, size_t length);
+    template <typename T>
+    std::vector<T> readArray();
+  };
+}
+
+#endif//TRITON_SERIALIZER_H
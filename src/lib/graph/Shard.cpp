@@ -15,7 +15,12 @@
  */
 
 #include "Shard.h"
+#include <deque>
 #include <iostream>
+#include <stdexcept>
+#include <seastar/core/memory.hh>
+#include <seastar/core/metrics.hh>
+#include <seastar/util/defer.hh>
 #include <simdjson/error.h>
 #include <utilities/StringUtils.h>
 
@@ -25,8 +30,11 @@ namespace triton {
 
   static const unsigned int SHIFTED_BITS = 8U;
   static const unsigned int MASK = 0x00000000000000FFU;
-  static const unsigned int SIXTY_FOUR = 64U;
   static const std::string EXCEPTION = "An exception has occurred: ";
+  static const std::string LUA_PRELUDE = "local json = require('json') local params = ... ";
+  // A reduce script sees the single value each map returned, one per shard in shard order, as the partials table
+  static const std::string LUA_REDUCE_PRELUDE = "local json = require('json') local params, encoded = ... "
+                                                "local partials = {} for i = 1, #encoded do partials[i] = json.decode(encoded[i])[1] end ";
   
   void Shard::speak() {
     std::stringstream ss;
@@ -42,25 +50,40 @@ namespace triton {
   }
 
   void Shard::clear() {
+    command_log.log(Command::CLEAR);
     node_keys.clear();
+    placement.clear();
     nodes.clear();
     nodes.shrink_to_fit();
+    node_property_rows.clear();
+    node_property_rows.shrink_to_fit();
+    node_properties.clear();
+    node_property_indexes.clear();
+    relationship_recency_indexes.clear();
     relationships.clear();
     relationships.shrink_to_fit();
+    // With every store gone the key ids can start over
+    *property_keys = PropertyKeys();
     outgoing_relationships.clear();
     outgoing_relationships.shrink_to_fit();
     incoming_relationships.clear();
     incoming_relationships.shrink_to_fit();
+    packed_outgoing_relationships.clear();
+    packed_incoming_relationships.clear();
+    // Nothing the views saw is left to read against
+    read_views.clear();
     deleted_nodes.clear();
     deleted_nodes.shrinkToFit();
     deleted_relationships.clear();
     deleted_relationships.shrinkToFit();
+    compaction_position = 1;
     node_types = Types();
     relationship_types = Types();
 
     // Reset Node zero
     nodes.emplace_back();
-    relationships.emplace_back();
+    node_property_rows.emplace_back(0);
+    relationships.set(0, 0, 0, 0);
     outgoing_relationships.emplace_back();
     incoming_relationships.emplace_back();
   }
@@ -71,899 +94,3591 @@ namespace triton {
       ++reserved_nodes;
       ++reserved_relationships;
       nodes.reserve(reserved_nodes);
+      node_property_rows.reserve(reserved_nodes);
       relationships.reserve(reserved_relationships);
       outgoing_relationships.reserve(reserved_nodes);
       incoming_relationships.reserve(reserved_nodes);
     }
   }
 
-  // Shard Ids =================================================================================================================================
-
-  seastar::future<uint8_t> Shard::getShardId() {
-    return seastar::make_ready_future<uint8_t>(shard_id);
-  }
-
-  seastar::future<std::vector<uint8_t>> Shard::getShardIds() {
-    return container().map([](Shard &local_shard) {
-           return local_shard.getShardId();
-    });
+  void Shard::freeze(bool compress) {
+    // Pack the relationship groups into contiguous arrays, later writes invalidate the packed copy of the nodes they touch
+    packed_outgoing_relationships.pack(outgoing_relationships, compress);
+    packed_incoming_relationships.pack(incoming_relationships, compress);
   }
 
-  sol::as_table_t<std::vector<std::uint8_t>> Shard::ShardIdsGet() {
-    return sol::as_table(getShardIds().get0());
+  void Shard::thaw() {
+    packed_outgoing_relationships.clear();
+    packed_incoming_relationships.clear();
   }
 
-  // Lua
-
-  seastar::future<std::string> Shard::RunLua(const std::string &script) {
+  // Metrics ===================================================================================================================================
 
-    return seastar::async([script, this] () {
-
-       // Inject json encoding
-       std::stringstream ss(script);
-       std::string line;
-       std::vector<std::string> lines;
-       while(std::getline(ss,line,'\n')){
-         lines.emplace_back(line);
-       }
-
-       std::string json_function2 = "local json = require('json')";
-       lines.back() = "return json.encode({" + lines.back() + "})";
-
-       std::string executable = json_function2 + join(lines, " ");
-       sol::protected_function_result script_result;
-        // We only have one Lua VM for each Core, so lock it during use.
-       this->lua_lock.for_write().lock().get();
-       try {
-         script_result = state.script(executable, [] (lua_State *, sol::protected_function_result pfr) {
-                return pfr;
-         });
-         this->lua_lock.for_write().unlock();
-         if (script_result.valid()) {
-           return script_result.get<std::string>();
-         }
-
-         sol::error err = script_result;
-         std::string what = err.what();
-
-         return EXCEPTION + what;
-       } catch (...) {
-         sol::error err = script_result;
-         std::string what = err.what();
-         // Unlock if we get an exception.
-         this->lua_lock.for_write().unlock();
-         return EXCEPTION + what;
-       }
+  void Shard::MetricsStart(const std::string& graph) {
+    namespace sm = seastar::metrics;
+    metrics.label(graph);
+    sm::label graph_label("graph");
+    std::vector<sm::label_instance> labels = {graph_label(graph)};
+    metrics.groups().add_group("graph", {
+      sm::make_gauge("nodes", [this] { return nodes.size() - 1 - deleted_nodes.cardinality(); }, sm::description("Nodes on this shard"), labels),
+      sm::make_gauge("relationships", [this] { return relationships.size() - 1 - deleted_relationships.cardinality(); }, sm::description("Relationships starting on this shard"), labels),
+      sm::make_gauge("node_property_bytes", [this] {
+        uint64_t bytes = 0;
+        for (const auto& [type_id, properties] : node_properties) {
+          bytes += properties.bytes();
+        }
+        return bytes;
+      }, sm::description("Bytes held by the node property columns"), labels),
+      sm::make_gauge("frozen_adjacency_bytes", [this] { return packed_outgoing_relationships.bytes() + packed_incoming_relationships.bytes(); }, sm::description("Bytes held by the frozen copy of the relationships"), labels),
+      sm::make_gauge("adjacency_entries", adjacency_entries, sm::description("Relationship entries of every node as of the last compaction pass"), labels),
+      sm::make_gauge("moved_nodes", [this] { return placement.getMovedCount(); }, sm::description("Nodes moved off the shard they hash to"), labels),
+      sm::make_gauge("running_traversals", [this] { return traversals.size() + paths.size() + algorithms.size(); }, sm::description("Traversals, path searches and algorithms running"), labels),
+    });
+    metrics.groups().add_group("compaction", {
+      sm::make_counter("passes", compaction_passes, sm::description("Passes of the compaction over every node"), labels),
+      sm::make_counter("groups_dropped", compaction_groups_dropped, sm::description("Empty relationship groups dropped"), labels),
+      sm::make_counter("slots_released", compaction_slots_released, sm::description("Deleted node and relationship slots released"), labels),
+      sm::make_counter("relationships_expired", relationships_expired, sm::description("Relationships removed for outliving the ttl of their recency index"), labels),
+      sm::make_gauge("position", compaction_position, sm::description("Next node the compaction looks at"), labels),
+    });
+    metrics.groups().add_group("lua", {
+      sm::make_counter("executions", lua_executions, sm::description("Lua scripts run"), labels),
+      sm::make_counter("preemptions", lua_preemptions, sm::description("Times a running script gave the reactor back to other work"), labels),
+      sm::make_counter("aborts", lua_aborts, sm::description("Scripts stopped for going over their instruction or memory budget"), labels),
+      sm::make_gauge("busy_vms", [this] { return lua_states.size() - free_lua_states.size(); }, sm::description("Lua VMs running a script"), labels),
+      sm::make_histogram("wait", sm::description("Microseconds scripts waited for a free Lua VM"), labels, [this] { return lua_wait.histogram(); }),
+    });
+    metrics.groups().add_group("read_view", {
+      sm::make_gauge("open", [this] { return read_views.size(); }, sm::description("Read views pinned on this shard"), labels),
+      sm::make_counter("copies", read_view_copies, sm::description("Nodes and relationships saved by writes for the open read views"), labels),
+    });
+    metrics.groups().add_group("result_cache", {
+      sm::make_counter("hits", [this] { return result_cache.getHits(); }, sm::description("Requests answered from the result cache"), labels),
+      sm::make_counter("misses", [this] { return result_cache.getMisses(); }, sm::description("Requests the result cache could not answer"), labels),
+      sm::make_counter("evictions", [this] { return result_cache.getEvictions(); }, sm::description("Results evicted to make room for newer ones"), labels),
+      sm::make_gauge("bytes", [this] { return result_cache.getBytes(); }, sm::description("Bytes of keys and results in the result cache"), labels),
+    });
+    metrics.groups().add_group("memory", {
+      sm::make_gauge("allocated", [] { return seastar::memory::stats().allocated_memory(); }, sm::description("Bytes allocated on this core"), labels),
+      sm::make_gauge("nodes", [this] { return MemoryNodes(); }, sm::description("Estimated bytes held by the nodes"), labels),
+      sm::make_gauge("relationships", [this] { return MemoryRelationships(); }, sm::description("Estimated bytes held by the relationships and their properties"), labels),
+      sm::make_gauge("properties", [this] { return MemoryProperties(); }, sm::description("Bytes held by the node property columns"), labels),
+      sm::make_gauge("adjacency", [this] { return MemoryAdjacency(); }, sm::description("Estimated bytes held by the relationship lists of the nodes and their frozen copy"), labels),
+      sm::make_gauge("keys", [this] { return MemoryKeys(); }, sm::description("Estimated bytes held by the node key index"), labels),
+      sm::make_gauge("lua", [this] { return MemoryLua(); }, sm::description("Bytes held by the Lua VMs"), labels),
+      sm::make_gauge("level", [this] { return static_cast<uint64_t>(memory_levels[shard_id]); }, sm::description("Memory pressure of this shard, 1 past the soft limit and 2 past the hard limit"), labels),
+      sm::make_counter("rejections", memory_rejections, sm::description("Requests turned away for lack of memory"), labels),
+    });
+    metrics.groups().add_group("requests", {
+      sm::make_counter("slow", slow_queries, sm::description("Requests that took longer than the slow query threshold"), labels),
+      sm::make_gauge("slow_logged", [this] { return slow_log.size(); }, sm::description("Slow and traced requests kept in the slow query log"), labels),
     });
   }
 
-  // Ids =================================================================================================================================
+  LatencyHistogram& Shard::RouteLatency(const std::string& route) {
+    return metrics.route(route);
+  }
 
-  uint64_t Shard::externalToInternal(uint64_t id) {
-    return (id >> SHIFTED_BITS);
+  OperationMetrics& Shard::PeerBroadcast(const std::string& operation) {
+    OperationMetrics& entry = metrics.operation(operation);
+    entry.calls += cpus;
+    entry.remote_calls += cpus - 1U;
+    return entry;
   }
 
-  uint64_t Shard::internalToExternal(uint64_t internal_id) const {
-    return (internal_id << SHIFTED_BITS) + shard_id;
+  void Shard::TraceLimits(uint64_t slow_microseconds, uint64_t slow_every, uint64_t trace_every) {
+    slow_threshold = slow_microseconds;
+    slow_sample = std::max(slow_every, uint64_t(1));
+    trace_sample = trace_every;
   }
 
-  uint8_t Shard::CalculateShardId(uint64_t id) {
-    if(id < MASK) {
-      return 0;
+  seastar::lw_shared_ptr<Trace> Shard::TraceStart(bool asked) {
+    if (!asked && (trace_sample == 0 || ++trace_seen % trace_sample != 0)) {
+      return nullptr;
     }
-    return id & MASK;
+    auto trace = seastar::make_lw_shared<Trace>();
+    trace->id = (++trace_count << SHIFTED_BITS) + shard_id;
+    trace->start = Trace::now();
+    return trace;
   }
 
-  uint8_t Shard::CalculateShardId(const std::string &type, const std::string &key) const {
-    // We need to find where the node goes, so we use the type and key to create a 64 bit number
-    uint64_t x64 = std::hash<std::string>()((type + '-' + key));
+  void Shard::SlowQueryRecord(const std::string& route, uint64_t script_hash, std::chrono::steady_clock::time_point start, const seastar::lw_shared_ptr<Trace>& trace, bool asked) {
+    if (slow_threshold == 0 && !asked) {
+      return;
+    }
+    auto microseconds = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+    bool slow = slow_threshold > 0 && microseconds >= slow_threshold;
+    if (slow) {
+      slow_queries++;
+    }
+    // A trace that was asked for is always kept, so whoever asked can find it
+    if (!asked && !(slow && slow_seen++ % slow_sample == 0)) {
+      return;
+    }
 
-    // Then we bucket it into a shard depending on the number of cpus we have
-    return (uint8_t)(((__uint128_t)x64 * (__uint128_t)cpus) >> SIXTY_FOUR);
+    std::string name = route;
+    if (script_hash != 0) {
+      std::stringstream hash;
+      hash << std::hex << script_hash;
+      name += " " + hash.str();
+    }
+    slow_log.emplace_back(std::move(name), shard_id, microseconds, trace.get());
+    if (slow_log.size() > SLOW_LOG_SIZE) {
+      slow_log.pop_front();
+    }
   }
 
-  // Relationship Types ===================================================================================================================
-  uint16_t Shard::RelationshipTypesGetCount() {
-    return relationship_types.getSize();
+  std::vector<SlowQuery> Shard::SlowQueries(uint64_t trace_id) {
+    std::vector<SlowQuery> queries;
+    for (auto query = slow_log.rbegin(); query != slow_log.rend(); query++) {
+      if (trace_id == 0 || query->trace_id == trace_id) {
+        queries.push_back(*query);
+      }
+    }
+    return queries;
   }
 
-  uint64_t Shard::RelationshipTypesGetCount(uint16_t type_id) {
-    if (relationship_types.ValidTypeId(type_id)) {
-      return relationship_types.getCount(type_id);
+  seastar::future<std::vector<SlowQuery>> Shard::SlowQueriesPeered(uint64_t trace_id) {
+    // A trace is kept on the shard it started on, which is the last byte of its id
+    if (trace_id != 0) {
+      return PeerOn("SlowQueries", static_cast<uint16_t>(trace_id & MASK) % cpus, [trace_id] (Shard &local_shard) {
+             return local_shard.SlowQueries(trace_id);
+      });
     }
-    // Not a valid Relationship Type
-    return 0;
+    return PeerMap("SlowQueries", [] (Shard &local_shard) {
+           return local_shard.SlowQueries();
+    }).then([] (std::vector<std::vector<SlowQuery>> sharded) {
+           std::vector<SlowQuery> queries;
+           for (auto& shard_queries : sharded) {
+             std::move(std::begin(shard_queries), std::end(shard_queries), std::back_inserter(queries));
+           }
+           // The slowest first
+           std::stable_sort(std::begin(queries), std::end(queries), [] (const SlowQuery& a, const SlowQuery& b) {
+             return a.microseconds > b.microseconds;
+           });
+           return queries;
+    });
   }
 
-  uint64_t Shard::RelationshipTypesGetCount(const std::string &type) {
-    uint16_t type_id = relationship_types.getTypeId(type);
-    return RelationshipTypesGetCount(type_id);
-  }
+  // Compaction ================================================================================================================================
 
-  std::set<std::string> Shard::RelationshipTypesGet() {
-    return relationship_types.getTypes();
+  // Drop the empty groups of a node and give back the space its lists no longer use, returns the number of groups dropped
+  static uint64_t CompactGroups(std::vector<Group>& groups) {
+    auto first_empty = std::remove_if(std::begin(groups), std::end(groups), [](const Group& group) {
+      return group.ids.empty();
+    });
+    auto dropped = static_cast<uint64_t>(std::end(groups) - first_empty);
+    groups.erase(first_empty, std::end(groups));
+    if (groups.capacity() > 2 * groups.size()) {
+      groups.shrink_to_fit();
+    }
+    for (auto& group : groups) {
+      if (group.ids.capacity() > 2 * group.ids.size()) {
+        group.ids.shrink_to_fit();
+      }
+    }
+    return dropped;
+  }
+
+  uint64_t Shard::Compact(uint64_t count, bool release_capacity) {
+    // Only look at the next few nodes so a slice never holds the core for long
+    uint64_t groups_dropped = 0;
+    uint64_t last = std::min(compaction_position + count, static_cast<uint64_t>(nodes.size()));
+    for (uint64_t internal_id = compaction_position; internal_id < last; internal_id++) {
+      if (deleted_nodes.contains(internal_id)) {
+        std::vector<Group>().swap(outgoing_relationships.at(internal_id));
+        std::vector<Group>().swap(incoming_relationships.at(internal_id));
+        continue;
+      }
+      groups_dropped += CompactGroups(outgoing_relationships.at(internal_id));
+      groups_dropped += CompactGroups(incoming_relationships.at(internal_id));
+      for (const auto& group : outgoing_relationships.at(internal_id)) {
+        compaction_adjacency += group.ids.size();
+      }
+      for (const auto& group : incoming_relationships.at(internal_id)) {
+        compaction_adjacency += group.ids.size();
+      }
+    }
+    compaction_position = last;
+    compaction_groups_dropped += groups_dropped;
+
+    if (compaction_position < nodes.size()) {
+      return groups_dropped;
+    }
+
+    // At the end of a pass let go of the deleted slots at the tail, new ones get the same ids reusing them would have given
+    uint64_t slots_released = 0;
+    while (nodes.size() > 1 && deleted_nodes.contains(nodes.size() - 1)) {
+      uint64_t internal_id = nodes.size() - 1;
+      NodeGroupsChanged(internal_id);
+      deleted_nodes.remove(internal_id);
+      nodes.pop_back();
+      node_property_rows.pop_back();
+      outgoing_relationships.pop_back();
+      incoming_relationships.pop_back();
+      slots_released++;
+    }
+    while (relationships.size() > 1 && deleted_relationships.contains(relationships.size() - 1)) {
+      deleted_relationships.remove(relationships.size() - 1);
+      relationships.pop_back();
+      slots_released++;
+    }
+    // Giving back the capacity also gives back whatever reserve set aside
+    if (release_capacity) {
+      nodes.shrink_to_fit();
+      node_property_rows.shrink_to_fit();
+      outgoing_relationships.shrink_to_fit();
+      incoming_relationships.shrink_to_fit();
+      relationships.shrink_to_fit();
+      deleted_nodes.shrinkToFit();
+      deleted_relationships.shrinkToFit();
+    }
+    compaction_slots_released += slots_released;
+    adjacency_entries = compaction_adjacency;
+    compaction_adjacency = 0;
+    compaction_position = 1;
+    compaction_passes++;
+
+    return groups_dropped + slots_released;
+  }
+
+  void Shard::CompactionStart(seastar::scheduling_group group, uint64_t interval, uint64_t count, bool release_capacity) {
+    compaction_timer.set_callback([group, count, release_capacity, this] {
+      // Slices run in their own scheduling group so foreground requests keep their share of the core
+      static_cast<void>(seastar::with_scheduling_group(group, [count, release_capacity, this] {
+        Compact(count, release_capacity);
+        // Expired relationships go a slice at a time as well, replicas drop them when their primary logs it
+        if (read_only || expiring || relationship_recency_indexes.empty()) {
+          return seastar::make_ready_future<>();
+        }
+        expiring = true;
+        return RelationshipsExpirePeered(count).then([this] (uint64_t expired) {
+          relationships_expired += expired;
+        }).finally([this] {
+          expiring = false;
+        });
+      }));
+    });
+    compaction_timer.arm_periodic(std::chrono::milliseconds(interval));
   }
 
-  // Relationship Type ====================================================================================================================
-  std::string Shard::RelationshipTypeGetType(uint16_t type_id) {
-    return relationship_types.getType(type_id);
+  void Shard::CompactionStop() {
+    compaction_timer.cancel();
   }
 
-  uint16_t Shard::RelationshipTypeGetTypeId(const std::string &type) {
-    uint16_t type_id = relationship_types.getTypeId(type);
-    if (relationship_types.ValidTypeId(type_id)) {
-      return type_id;
+  seastar::future<uint64_t> Shard::RelationshipsExpirePeered(uint64_t limit) {
+    // Removing them needs the shards of their ending nodes as well
+    std::vector<seastar::future<bool>> futures;
+    for (uint64_t id : RelationshipsExpired(limit)) {
+      futures.push_back(RelationshipRemovePeered(id));
     }
-    // Not a valid Relationship Type
-    return 0;
-  }
-
-  bool Shard::RelationshipTypeInsert(const std::string& type, uint16_t type_id) {
-    return relationship_types.addTypeId(type, type_id);
-  }
 
-  // Node Types ===========================================================================================================================
-  uint16_t Shard::NodeTypesGetCount() {
-    return node_types.getSize();
+    auto p = make_shared(std::move(futures));
+    return seastar::when_all_succeed(p->begin(), p->end()).then([] (const std::vector<bool>& results) {
+           return static_cast<uint64_t>(std::count(std::begin(results), std::end(results), true));
+    });
   }
 
-  uint64_t Shard::NodeTypesGetCount(uint16_t type_id) {
-    return node_types.getCount(type_id);
-  }
+  // Command Log ===============================================================================================================================
 
-  uint64_t Shard::NodeTypesGetCount(const std::string &type) {
-    uint16_t type_id = node_types.getTypeId(type);
-    return NodeTypesGetCount(type_id);
-  }
+  seastar::future<uint64_t> Shard::CommandLogStart(const std::string &directory, uint64_t flush_interval, uint64_t flush_bytes) {
+    return seastar::async([directory, flush_interval, flush_bytes, this] {
+      // Start from the latest snapshot, it holds everything logged before its generation
+      uint64_t generation = 0;
+      std::map<uint64_t, std::string> snapshots = CommandLog::files(directory, snapshot_file_name);
+      if (!snapshots.empty()) {
+        std::vector<std::string> sections;
+        if (!Snapshot::read(snapshots.rbegin()->second, sections) || !SnapshotRestore(sections)) {
+          throw std::runtime_error("Could not restore the snapshot " + snapshots.rbegin()->second);
+        }
+        generation = snapshots.rbegin()->first;
+      }
 
-  std::set<std::string> Shard::NodeTypesGet() {
-    return node_types.getTypes();
+      // Replay every generation written since in order, then continue in a new one
+      uint64_t count = 0;
+      for (const auto &[file_generation, file_name] : CommandLog::files(directory, command_log_file_name)) {
+        if (file_generation < generation) {
+          continue;
+        }
+        count += CommandLog::replay(file_name, [this](Command command, Deserializer &reader) {
+          return CommandReplay(command, reader);
+        });
+        generation = file_generation + 1;
+      }
+      command_log_directory = directory;
+      command_log_generation = generation;
+      command_log.open(CommandLog::path(directory, command_log_file_name, generation), flush_interval, flush_bytes).get();
+      return count;
+    });
   }
 
-  // Node Type ============================================================================================================================
-  std::string Shard::NodeTypeGetType(uint16_t type_id) {
-    return node_types.getType(type_id);
+  seastar::future<> Shard::CommandLogFlush() {
+    return command_log.flush();
   }
 
-  uint16_t Shard::NodeTypeGetTypeId(const std::string &type) {
-    return node_types.getTypeId(type);
+  seastar::future<> Shard::CommandLogStop() {
+    return command_log.close();
   }
 
-  bool Shard::NodeTypeInsert(const std::string& type, uint16_t type_id) {
-    tsl::sparse_map<std::string, uint64_t> empty;
-    node_keys.emplace(type, empty);
-    return node_types.addTypeId(type, type_id);
-  }
+  // Snapshots ================================================================================================================================
 
-  // Helpers ==============================================================================================================================
-  bool Shard::NodeRemoveDeleteIncoming(uint64_t id, const std::map<uint16_t, std::vector<uint64_t>>&grouped_relationships) {
-    for (const auto& rel_type_node_ids : grouped_relationships) {
-      uint16_t rel_type_id = rel_type_node_ids.first;
-      for (auto node_id : rel_type_node_ids.second) {
-        uint64_t internal_id = externalToInternal(node_id);
+  seastar::future<bool> Shard::SnapshotSave() {
+    return seastar::async([this] {
+      // Snapshots live next to the command log, without one there is nothing to recover them with
+      if (!command_log.isOpen()) {
+        return false;
+      }
+      uint64_t generation = ++command_log_generation;
 
-        auto group = find_if(std::begin(incoming_relationships.at(internal_id)), std::end(incoming_relationships.at(internal_id)),
-          [rel_type_id] (const Group& g) { return g.rel_type_id == rel_type_id; } );
+      // Encode the shard at the same moment the log moves on, so the snapshot and the new log generation never overlap
+      std::vector<std::string> sections;
+      command_log.rotate(CommandLog::path(command_log_directory, command_log_file_name, generation), [&sections, this] {
+        sections = SnapshotSections();
+      }).get();
+      Snapshot::write(CommandLog::path(command_log_directory, snapshot_file_name, generation), std::move(sections));
 
-        if (group != std::end(incoming_relationships.at(internal_id))) {
-          group->ids.erase(std::remove_if(std::begin(group->ids), std::end(group->ids), [id](Ids entry) {
-                 return entry.node_id == id;
-          }), std::end(group->ids));
+      // Everything older is covered by the new snapshot
+      for (const auto &[file_generation, file_name] : CommandLog::files(command_log_directory, command_log_file_name)) {
+        if (file_generation < generation) {
+          seastar::remove_file(file_name).get();
         }
       }
-    }
-
-    return true;
-  }
-
-  std::map<uint16_t, std::map<uint16_t, std::vector<uint64_t>>> Shard::NodeRemoveGetIncoming(uint64_t internal_id) {
-    std::map<uint16_t, std::map<uint16_t, std::vector<uint64_t>>> relationships_to_delete;
-
-    // Go through all the outgoing relationships and return the counterparts that I do not own
-    for (auto &types : outgoing_relationships.at(internal_id)) {
-      // Get the Relationship Type of the list
-      uint16_t rel_type = types.rel_type_id;
-
-      for (Ids ids : types.ids) {
-        std::map<uint16_t, std::vector<uint64_t>> node_ids;
-        for (int i = 0; i < cpus; i++) {
-          node_ids.insert({ i, std::vector<uint64_t>() });
+      for (const auto &[file_generation, file_name] : CommandLog::files(command_log_directory, snapshot_file_name)) {
+        if (file_generation < generation) {
+          seastar::remove_file(file_name).get();
         }
+      }
+      return true;
+    });
+  }
 
-        // Remove relationship from other node that I own
-        uint16_t node_shard_id = CalculateShardId(ids.node_id);
-        if ( node_shard_id != shard_id) {
-          node_ids.at(node_shard_id).push_back(ids.node_id);
+  std::vector<std::string> Shard::SnapshotSections() {
+    std::vector<std::string> sections(10);
+
+    // Types and their ids
+    Serializer types(sections[0]);
+    node_types.write(types);
+    relationship_types.write(types);
+
+    // Nodes
+    Serializer node_section(sections[1]);
+    node_section.put(static_cast<uint64_t>(nodes.size()));
+    for (const auto &node : nodes) {
+      node_section.put(node.getId());
+      node_section.put(node.getTypeId());
+      node_section.put(node.getKey());
+    }
+    node_section.put(node_property_rows);
+    node_section.put(deleted_nodes);
+
+    // Node properties by type
+    Serializer property_section(sections[2]);
+    property_section.put(static_cast<uint64_t>(node_properties.size()));
+    for (const auto &[type_id, properties] : node_properties) {
+      property_section.put(type_id);
+      properties.write(property_section);
+    }
+
+    // Relationships
+    Serializer relationship_section(sections[3]);
+    relationship_section.put(static_cast<uint64_t>(relationships.size()));
+    for (uint64_t internal_id = 0; internal_id < relationships.size(); internal_id++) {
+      // Empty slots keep the id of the zero relationship
+      uint16_t type_id = relationships.getTypeId(internal_id);
+      relationship_section.put(type_id == 0 ? uint64_t(0) : internalToExternal(internal_id));
+      relationship_section.put(type_id);
+      relationship_section.put(relationships.getStartingNodeId(internal_id));
+      relationship_section.put(relationships.getEndingNodeId(internal_id));
+      relationship_section.put(relationships.getProperties(internal_id));
+    }
+    relationship_section.put(deleted_relationships);
+
+    // Adjacency lists
+    SnapshotGroups(sections[4], outgoing_relationships);
+    SnapshotGroups(sections[5], incoming_relationships);
+
+    // Keys
+    Serializer key_section(sections[6]);
+    std::set<uint16_t> key_type_ids = node_types.getTypeIds();
+    key_section.put(static_cast<uint64_t>(key_type_ids.size()));
+    for (uint16_t type_id : key_type_ids) {
+      const NodeKeys &keys = node_keys.at(type_id);
+      key_section.put(node_types.getType(type_id));
+      key_section.put(static_cast<uint64_t>(keys.size()));
+      for (const auto &[key, id] : keys) {
+        key_section.put(key);
+        key_section.put(id);
+      }
+    }
+
+    // Node property indexes, only what was declared since their values are rebuilt from the properties
+    Serializer index_section(sections[7]);
+    uint64_t index_count = 0;
+    for (const auto &[type_id, indexes] : node_property_indexes) {
+      index_count += indexes.size();
+    }
+    index_section.put(index_count);
+    for (const auto &[type_id, indexes] : node_property_indexes) {
+      for (const auto &[property, index] : indexes) {
+        index_section.put(type_id);
+        index_section.put(property);
+        index_section.put(static_cast<uint8_t>(index.getType()));
+      }
+    }
+
+    // Nodes moved off the shard they hash to
+    Serializer placement_section(sections[8]);
+    placement.write(placement_section);
+
+    // Relationship recency indexes, rebuilt from the relationships like the node property indexes
+    Serializer recency_section(sections[9]);
+    recency_section.put(static_cast<uint64_t>(relationship_recency_indexes.size()));
+    for (const auto &[type_id, index] : relationship_recency_indexes) {
+      recency_section.put(type_id);
+      recency_section.put(index.getProperty());
+      recency_section.put(static_cast<uint8_t>(index.stamps()));
+      recency_section.put(index.getTtl());
+    }
+
+    return sections;
+  }
+
+  void Shard::SnapshotGroups(std::string &section, const std::vector<std::vector<Group>> &node_groups) {
+    Serializer serializer(section);
+    serializer.put(static_cast<uint64_t>(node_groups.size()));
+    for (const auto &groups : node_groups) {
+      serializer.put(static_cast<uint64_t>(groups.size()));
+      for (const auto &group : groups) {
+        serializer.put(group.rel_type_id);
+        serializer.put(static_cast<uint64_t>(group.ids.size()));
+        for (const auto &ids : group.ids) {
+          serializer.put(ids.node_id);
+          serializer.put(ids.rel_id);
         }
+      }
+    }
+  }
 
-        for (int i = 0; i < cpus; i++) {
-          if(node_ids.at(i).empty()) {
-            node_ids.erase(i);
-          }
+  bool Shard::SnapshotRestoreGroups(const std::string &section, std::vector<std::vector<Group>> &node_groups) {
+    Deserializer reader(section.data(), section.size());
+    node_groups.clear();
+    node_groups.resize(reader.getUint64());
+    for (auto &groups : node_groups) {
+      for (uint64_t count = reader.getUint64(); count > 0 && !reader.failed(); count--) {
+        uint16_t rel_type_id = reader.getUint16();
+        IdsList ids;
+        uint64_t size = reader.getUint64();
+        ids.reserve(std::min(size, static_cast<uint64_t>(section.size())));
+        for (; size > 0 && !reader.failed(); size--) {
+          uint64_t node_id = reader.getUint64();
+          uint64_t rel_id = reader.getUint64();
+          ids.emplace_back(node_id, rel_id);
         }
-
-        relationships_to_delete.insert({ rel_type, node_ids });
+        groups.emplace_back(rel_type_id, std::move(ids));
       }
+      // Older snapshots kept the groups in the order their types were first used
+      sortGroups(groups);
     }
-
-    return relationships_to_delete;
+    return !reader.failed() && reader.done();
   }
 
-  std::map<uint16_t, std::map<uint16_t, std::vector<uint64_t>>> Shard::NodeRemoveGetOutgoing(uint64_t internal_id) {
-    std::map<uint16_t, std::map<uint16_t, std::vector<uint64_t>>> relationships_to_delete;
-
-    // Go through all the incoming relationships and return the counterparts that I do not own
-    for (auto &types : incoming_relationships.at(internal_id)) {
-      // Get the Relationship Type of the list
-      uint16_t rel_type = types.rel_type_id;
-
-      for (Ids ids : types.ids) {
-        std::map<uint16_t, std::vector<uint64_t>> node_ids;
-        for (int i = 0; i < cpus; i++) {
-          node_ids.insert({ i, std::vector<uint64_t>() });
-        }
+  bool Shard::SnapshotRestore(const std::vector<std::string> &sections) {
+    // Snapshots taken before property indexes, placement or recency indexes have no section for them
+    if (sections.size() < 7 || sections.size() > 10) {
+      return false;
+    }
+    clear();
+    nodes.clear();
+    node_property_rows.clear();
+    relationships.clear();
 
-        // Remove relationship from other node that I own
-        uint16_t node_shard_id = CalculateShardId(ids.node_id);
-        if ( node_shard_id != shard_id) {
-          node_ids.at(node_shard_id).push_back(ids.node_id);
-        }
+    // Types and their ids
+    Deserializer types(sections[0].data(), sections[0].size());
+    if (!node_types.read(types) || !relationship_types.read(types) || !types.done()) {
+      return false;
+    }
 
-        for (int i = 0; i < cpus; i++) {
-          if(node_ids.at(i).empty()) {
-            node_ids.erase(i);
-          }
-        }
+    // Nodes
+    Deserializer node_section(sections[1].data(), sections[1].size());
+    uint64_t node_count = node_section.getUint64();
+    nodes.reserve(std::min(node_count, static_cast<uint64_t>(sections[1].size())));
+    for (; node_count > 0 && !node_section.failed(); node_count--) {
+      uint64_t id = node_section.getUint64();
+      uint16_t type_id = node_section.getUint16();
+      std::string key = node_section.getString();
+      nodes.emplace_back(id, type_id, std::move(key));
+    }
+    node_property_rows = node_section.getUint64s();
+    deleted_nodes = node_section.getBitmap();
+    if (node_section.failed() || !node_section.done() || nodes.empty() || node_property_rows.size() != nodes.size()) {
+      return false;
+    }
 
-        relationships_to_delete.insert({ rel_type, node_ids });
+    // Node properties by type
+    Deserializer property_section(sections[2].data(), sections[2].size());
+    for (uint64_t count = property_section.getUint64(); count > 0 && !property_section.failed(); count--) {
+      uint16_t type_id = property_section.getUint16();
+      if (!NodeTypePropertyStore(type_id).read(property_section)) {
+        return false;
       }
     }
+    if (property_section.failed() || !property_section.done()) {
+      return false;
+    }
 
-    return relationships_to_delete;
-  }
-
-  bool Shard::NodeRemoveDeleteOutgoing(uint64_t id, const std::map<uint16_t, std::vector<uint64_t>> &grouped_relationships) {
-    for (const auto& rel_type_node_ids : grouped_relationships) {
-      uint16_t rel_type_id = rel_type_node_ids.first;
-      for (auto node_id : rel_type_node_ids.second) {
-        uint64_t internal_id = externalToInternal(node_id);
+    // Relationships
+    Deserializer relationship_section(sections[3].data(), sections[3].size());
+    uint64_t relationship_count = relationship_section.getUint64();
+    relationships.reserve(std::min(relationship_count, static_cast<uint64_t>(sections[3].size())));
+    for (; relationship_count > 0 && !relationship_section.failed(); relationship_count--) {
+      // The id is kept for older readers, a relationship lives at the slot of its position
+      relationship_section.getUint64();
+      uint16_t type_id = relationship_section.getUint16();
+      uint64_t starting_node_id = relationship_section.getUint64();
+      uint64_t ending_node_id = relationship_section.getUint64();
+      std::map<std::string, std::any> properties = relationship_section.getProperties();
+      relationships.set(relationships.size(), type_id, starting_node_id, ending_node_id, properties);
+    }
+    deleted_relationships = relationship_section.getBitmap();
+    if (relationship_section.failed() || !relationship_section.done() || relationships.empty()) {
+      return false;
+    }
 
-        auto group = find_if(std::begin(outgoing_relationships.at(internal_id)), std::end(outgoing_relationships.at(internal_id)),
-                             [rel_type_id] (const Group& g) { return g.rel_type_id == rel_type_id; } );
+    // Adjacency lists
+    if (!SnapshotRestoreGroups(sections[4], outgoing_relationships) || !SnapshotRestoreGroups(sections[5], incoming_relationships)
+        || outgoing_relationships.size() != nodes.size() || incoming_relationships.size() != nodes.size()) {
+      return false;
+    }
 
-        if (group != std::end(outgoing_relationships.at(internal_id))) {
-          // Look in the relationship chain for any relationships of the node to be removed and delete them.
-          group->ids.erase(std::remove_if(std::begin(group->ids), std::end(group->ids), [id, rel_type_id, this](Ids entry) {
-            if (entry.node_id == id) {
-              uint64_t internal_id = externalToInternal(entry.rel_id);
-              deleted_relationships.add(internal_id);
-              // Update the relationship type counts
-              relationship_types.removeId(rel_type_id, entry.rel_id);
-              // Clear the relationship
-              relationships.at(internal_id) = Relationship();
-              return true;
-            }
+    // Keys
+    Deserializer key_section(sections[6].data(), sections[6].size());
+    for (uint64_t count = key_section.getUint64(); count > 0 && !key_section.failed(); count--) {
+      uint16_t type_id = node_types.getTypeId(key_section.getString());
+      if (type_id == 0) {
+        return false;
+      }
+      if (node_keys.size() <= type_id) {
+        node_keys.resize(type_id + 1);
+      }
+      NodeKeys &keys = node_keys[type_id];
+      uint64_t size = key_section.getUint64();
+      keys.reserve(std::min(size, static_cast<uint64_t>(sections[6].size())));
+      for (; size > 0 && !key_section.failed(); size--) {
+        std::string key = key_section.getString();
+        uint64_t id = key_section.getUint64();
+        keys.emplace(std::move(key), id);
+      }
+    }
+    if (key_section.failed() || !key_section.done()) {
+      return false;
+    }
 
-            return false;
-          }), std::end(group->ids));
+    // Node property indexes
+    if (sections.size() >= 8) {
+      Deserializer index_section(sections[7].data(), sections[7].size());
+      for (uint64_t count = index_section.getUint64(); count > 0 && !index_section.failed(); count--) {
+        uint16_t type_id = index_section.getUint16();
+        std::string property = index_section.getString();
+        auto index_type = static_cast<PropertyIndex::IndexType>(index_section.getUint8());
+        if (!index_section.failed()) {
+          PropertyIndex &index = node_property_indexes[type_id].emplace(property, PropertyIndex(index_type)).first->second;
+          NodePropertyIndexBuild(type_id, property, index);
         }
+      }
+      if (index_section.failed() || !index_section.done()) {
+        return false;
+      }
+    }
 
+    // Placement
+    if (sections.size() >= 9) {
+      Deserializer placement_section(sections[8].data(), sections[8].size());
+      if (!placement.read(placement_section) || !placement_section.done()) {
+        return false;
       }
     }
 
+    // Relationship recency indexes
+    if (sections.size() == 10) {
+      Deserializer recency_section(sections[9].data(), sections[9].size());
+      for (uint64_t count = recency_section.getUint64(); count > 0 && !recency_section.failed(); count--) {
+        uint16_t type_id = recency_section.getUint16();
+        std::string property = recency_section.getString();
+        bool stamp = recency_section.getUint8() != 0;
+        uint64_t ttl = recency_section.getUint64();
+        if (!recency_section.failed()) {
+          relationship_recency_indexes.insert_or_assign(type_id, RecencyIndex(property, stamp, ttl));
+          RelationshipRecencyIndexBuild(type_id);
+        }
+      }
+      if (recency_section.failed() || !recency_section.done()) {
+        return false;
+      }
+    }
     return true;
   }
 
-  // Nodes ================================================================================================================================
-  uint64_t Shard::NodeAddEmpty(const std::string& type, uint16_t node_type, const std::string &key) {
-    uint64_t internal_id = nodes.size();
-    uint64_t external_id = 0;
-
-    auto type_search = node_keys.find(type);
-    // The Label will always exist
-    if (type_search != std::end(node_keys)) {
-      // Check if the key exists
-      auto key_search = type_search->second.find(key);
-      if (key_search == std::end(type_search->second)) {
-        // If we have deleted nodes, fill in the space by adding the new node here
-        if (deleted_nodes.isEmpty()) {
-          external_id = internalToExternal(internal_id);
-          // Set Metadata properties
-          // Add the node to the end and prepare a place for its relationships
-          nodes.emplace_back(external_id, node_type, key);
-          outgoing_relationships.emplace_back();
-          incoming_relationships.emplace_back();
-          node_types.addId(node_type, external_id);
-        } else {
-          internal_id = deleted_nodes.minimum();
-          external_id = internalToExternal(internal_id);
-          // Set Metadata properties
-          Node node(external_id, node_type, key);
-          // Replace the deleted node and remove it from the list
-          nodes.at(internal_id) = node;
-          deleted_nodes.remove(internal_id);
-          node_types.addId(node_type, external_id);
+  bool Shard::CommandReplay(Command command, Deserializer &reader) {
+    switch (command) {
+      case Command::CLEAR: {
+        clear();
+        return !reader.failed();
+      }
+      case Command::RELATIONSHIP_TYPE_INSERT: {
+        std::string type = reader.getString();
+        uint16_t type_id = reader.getUint16();
+        if (reader.failed()) {
+          return false;
+        }
+        // Inserting a type reports false even when it is added
+        RelationshipTypeInsert(type, type_id);
+        return true;
+      }
+      case Command::NODE_TYPE_INSERT: {
+        std::string type = reader.getString();
+        uint16_t type_id = reader.getUint16();
+        if (reader.failed()) {
+          return false;
+        }
+        // Inserting a type reports false even when it is added
+        NodeTypeInsert(type, type_id);
+        return true;
+      }
+      case Command::NODE_ADD: {
+        std::string type = reader.getString();
+        uint16_t node_type = reader.getUint16();
+        std::string key = reader.getString();
+        std::map<std::string, std::any> values = reader.getProperties();
+        uint64_t external_id = reader.getUint64();
+        // The node must land on the same id it had, or the relationships that follow would point elsewhere
+        return !reader.failed() && NodeAdd(type, node_type, key, values) == external_id;
+      }
+      case Command::NODE_REMOVE: {
+        uint64_t external_id = reader.getUint64();
+        return !reader.failed() && NodeRemove(external_id);
+      }
+      case Command::NODE_REMOVE_DELETE_INCOMING: {
+        uint64_t id = reader.getUint64();
+        std::map<uint16_t, std::vector<uint64_t>> grouped_relationships = reader.getGroupedIds();
+        return !reader.failed() && NodeRemoveDeleteIncoming(id, grouped_relationships);
+      }
+      case Command::NODE_REMOVE_DELETE_OUTGOING: {
+        uint64_t id = reader.getUint64();
+        std::map<uint16_t, std::vector<uint64_t>> grouped_relationships = reader.getGroupedIds();
+        return !reader.failed() && NodeRemoveDeleteOutgoing(id, grouped_relationships);
+      }
+      case Command::NODE_PROPERTY_SET: {
+        uint64_t id = reader.getUint64();
+        std::string property = reader.getString();
+        std::any value = reader.getAny();
+        if (reader.failed() || !ValidNodeId(id)) {
+          return false;
+        }
+        uint64_t internal_id = externalToInternal(id);
+        NodePreserve(internal_id);
+        UnindexNodeProperty(internal_id, property);
+        NodePropertyStore(internal_id).setProperty(node_property_rows.at(internal_id), property, value);
+        IndexNodeProperty(internal_id, property);
+        return true;
+      }
+      case Command::NODE_PROPERTY_DELETE: {
+        uint64_t id = reader.getUint64();
+        std::string property = reader.getString();
+        if (reader.failed()) {
+          return false;
+        }
+        // Deleting a property the node never had is not an error
+        NodePropertyDelete(id, property);
+        return true;
+      }
+      case Command::NODE_PROPERTIES_RESET: {
+        uint64_t id = reader.getUint64();
+        std::map<std::string, std::any> values = reader.getProperties();
+        return !reader.failed() && NodePropertiesReset(id, values);
+      }
+      case Command::NODE_PROPERTIES_DELETE: {
+        uint64_t id = reader.getUint64();
+        return !reader.failed() && NodePropertiesDelete(id);
+      }
+      case Command::RELATIONSHIP_ADD_SAME_SHARD: {
+        uint16_t rel_type = reader.getUint16();
+        uint64_t id1 = reader.getUint64();
+        uint64_t id2 = reader.getUint64();
+        std::map<std::string, std::any> values = reader.getProperties();
+        uint64_t external_id = reader.getUint64();
+        return !reader.failed() && RelationshipAddSameShard(rel_type, id1, id2, values) == external_id;
+      }
+      case Command::RELATIONSHIP_ADD_TO_OUTGOING: {
+        uint16_t rel_type = reader.getUint16();
+        uint64_t id1 = reader.getUint64();
+        uint64_t id2 = reader.getUint64();
+        std::map<std::string, std::any> values = reader.getProperties();
+        uint64_t external_id = reader.getUint64();
+        return !reader.failed() && RelationshipAddToOutgoing(rel_type, id1, id2, values) == external_id;
+      }
+      case Command::RELATIONSHIP_ADD_TO_INCOMING: {
+        uint16_t rel_type = reader.getUint16();
+        uint64_t rel_id = reader.getUint64();
+        uint64_t id1 = reader.getUint64();
+        uint64_t id2 = reader.getUint64();
+        return !reader.failed() && RelationshipAddToIncoming(rel_type, rel_id, id1, id2) == rel_id;
+      }
+      case Command::RELATIONSHIP_REMOVE_GET_INCOMING: {
+        uint64_t internal_id = reader.getUint64();
+        if (reader.failed() || internal_id == 0 || internal_id >= relationships.size()) {
+          return false;
+        }
+        RelationshipRemoveGetIncoming(internal_id);
+        return true;
+      }
+      case Command::RELATIONSHIP_REMOVE_INCOMING: {
+        uint16_t rel_type_id = reader.getUint16();
+        uint64_t external_id = reader.getUint64();
+        uint64_t node_id = reader.getUint64();
+        return !reader.failed() && RelationshipRemoveIncoming(rel_type_id, external_id, node_id);
+      }
+      case Command::RELATIONSHIP_PROPERTY_SET: {
+        uint64_t id = reader.getUint64();
+        std::string property = reader.getString();
+        std::any value = reader.getAny();
+        if (reader.failed() || !ValidRelationshipId(id)) {
+          return false;
+        }
+        uint64_t internal_id = externalToInternal(id);
+        UnindexRelationship(internal_id);
+        relationships.setProperty(internal_id, property, value);
+        IndexRelationship(internal_id);
+        return true;
+      }
+      case Command::RELATIONSHIP_PROPERTY_DELETE: {
+        uint64_t id = reader.getUint64();
+        std::string property = reader.getString();
+        if (reader.failed()) {
+          return false;
+        }
+        RelationshipPropertyDelete(id, property);
+        return true;
+      }
+      case Command::RELATIONSHIP_PROPERTIES_RESET: {
+        uint64_t id = reader.getUint64();
+        std::map<std::string, std::any> values = reader.getProperties();
+        return !reader.failed() && RelationshipPropertiesReset(id, values);
+      }
+      case Command::RELATIONSHIP_PROPERTIES_DELETE: {
+        uint64_t id = reader.getUint64();
+        return !reader.failed() && RelationshipPropertiesDelete(id);
+      }
+      case Command::NODE_PROPERTY_INDEX_CREATE: {
+        std::string type = reader.getString();
+        std::string property = reader.getString();
+        auto index_type = static_cast<PropertyIndex::IndexType>(reader.getUint8());
+        return !reader.failed() && NodePropertyIndexCreate(type, property, index_type);
+      }
+      case Command::NODE_PROPERTY_INDEX_DROP: {
+        std::string type = reader.getString();
+        std::string property = reader.getString();
+        return !reader.failed() && NodePropertyIndexDrop(type, property);
+      }
+      case Command::NODE_PLACE: {
+        std::string type = reader.getString();
+        std::string key = reader.getString();
+        uint8_t node_shard_id = reader.getUint8();
+        return !reader.failed() && NodePlace(type, key, node_shard_id);
+      }
+      case Command::NODE_REMOVE_TAKE_OUTGOING: {
+        uint64_t id = reader.getUint64();
+        uint64_t limit = reader.getUint64();
+        if (reader.failed() || !ValidNodeId(id)) {
+          return false;
+        }
+        // The neighbors it hands back were logged by their own shards when they dropped it
+        NodeRemoveTakeOutgoing(id, limit);
+        return true;
+      }
+      case Command::NODE_REMOVE_TAKE_INCOMING: {
+        uint64_t id = reader.getUint64();
+        uint64_t limit = reader.getUint64();
+        if (reader.failed() || !ValidNodeId(id)) {
+          return false;
         }
-        type_search->second.insert({ key, external_id });
+        NodeRemoveTakeIncoming(id, limit);
+        return true;
+      }
+      case Command::NODES_REMOVE_DELETE_INCOMING: {
+        std::vector<uint64_t> ids = reader.getUint64s();
+        std::map<uint16_t, std::vector<uint64_t>> grouped_relationships = reader.getGroupedIds();
+        return !reader.failed() && NodesRemoveDeleteIncoming(ids, grouped_relationships);
+      }
+      case Command::NODES_REMOVE_DELETE_OUTGOING: {
+        std::vector<uint64_t> ids = reader.getUint64s();
+        std::map<uint16_t, std::vector<uint64_t>> grouped_relationships = reader.getGroupedIds();
+        return !reader.failed() && NodesRemoveDeleteOutgoing(ids, grouped_relationships);
+      }
+      case Command::NODE_VECTOR_PROPERTY_CREATE: {
+        std::string type = reader.getString();
+        std::string property = reader.getString();
+        uint32_t dimensions = reader.getUint32();
+        return !reader.failed() && NodeVectorPropertyCreate(type, property, dimensions);
+      }
+      case Command::RELATIONSHIP_RECENCY_INDEX_CREATE: {
+        std::string rel_type = reader.getString();
+        std::string property = reader.getString();
+        bool stamp = reader.getUint8() != 0;
+        uint64_t ttl = reader.getUint64();
+        return !reader.failed() && RelationshipRecencyIndexCreate(rel_type, property, stamp, ttl);
+      }
+      case Command::RELATIONSHIP_RECENCY_INDEX_DROP: {
+        std::string rel_type = reader.getString();
+        return !reader.failed() && RelationshipRecencyIndexDrop(rel_type);
       }
     }
-
-    return external_id;
+    // Unknown command, the log was written by something else
+    return false;
   }
 
-  uint64_t Shard::NodeAdd(const std::string &type, uint16_t node_type, const std::string &key, const std::string &properties) {
-    uint64_t internal_id = nodes.size();
-    uint64_t external_id = 0;
+  // Replication ================================================================================================================================
 
-    auto type_search = node_keys.find(type);
-    // The Label will always exist
-    if (type_search != std::end(node_keys)) {
-      // Check if the key exists
-      auto key_search = type_search->second.find(key);
-      if (key_search == std::end(type_search->second)) {
-
-        std::map<std::string, std::any> values;
-        if (!properties.empty()) {
-          // Get the properties
-          simdjson::error_code error;
-
-          dom::object object;
-          error = Shard::parser.parse(properties).get(object);
-          if (!error) {
-            // Add the node properties
-            convertProperties(values, object);
-          } else {
-            return 0;
-          }
-        }
+  // Lua functions that change the graph, replicas leave them out
+  static const std::vector<std::string> LUA_WRITES = {
+    "RelationshipTypeInsert", "NodeTypeInsert", "NodeAddEmpty", "NodeAdd", "NodesAdd", "NodeRemove", "NodeRemoveById", "NodesRemove",
+    "NodesRemoveForType", "NodeMove",
+    "NodePropertySet", "NodePropertySetById", "NodePropertiesSetFromJson", "NodePropertiesSetFromJsonById", "NodePropertiesResetFromJson",
+    "NodePropertiesResetFromJsonById", "NodePropertyDelete", "NodePropertyDeleteById", "NodePropertiesDelete", "NodePropertiesDeleteById",
+    "NodePropertyIndexCreate", "NodePropertyIndexDrop", "NodeVectorPropertyCreate", "RelationshipAddEmpty", "RelationshipAddEmptyByTypeIdByIds", "RelationshipAddEmptyByIds",
+    "RelationshipAdd", "RelationshipAddByTypeIdByIds", "RelationshipAddByIds", "RelationshipsAdd", "RelationshipRemove", "RelationshipMerge",
+    "RelationshipMergeByIds", "RelationshipPropertySet", "RelationshipPropertySetFromJson", "RelationshipPropertyDelete",
+    "RelationshipPropertiesSetFromJson", "RelationshipPropertiesResetFromJson", "RelationshipPropertiesDelete", "RelationshipRecencyIndexCreate",
+    "RelationshipRecencyIndexDrop"
+  };
 
+  void Shard::ReplicationFollow(uint64_t bytes) {
+    command_log.follow(bytes);
+  }
 
-        // If we have deleted nodes, fill in the space by adding the new node here
-        if (deleted_nodes.isEmpty()) {
-          external_id = internalToExternal(internal_id);
-          // Set Metadata properties
-          // Add the node to the end and prepare a place for its relationships
-          nodes.emplace_back(external_id, node_type, key, values);
-          outgoing_relationships.emplace_back();
-          incoming_relationships.emplace_back();
-          node_types.addId(node_type, external_id);
-        } else {
-          internal_id = deleted_nodes.minimum();
-          external_id = internalToExternal(internal_id);
-          // Set Metadata properties
-          Node node(external_id, node_type, key, values);
-          // Replace the deleted node and remove it from the list
-          nodes.at(internal_id) = node;
-          deleted_nodes.remove(internal_id);
-          node_types.addId(node_type, external_id);
-        }
-        type_search->second.insert({ key, external_id });
-      }
-    }
+  bool Shard::ReplicationRecords(uint64_t sequence, uint64_t max_bytes, Serializer &serializer) {
+    return command_log.since(sequence, max_bytes, serializer);
+  }
 
-    return external_id;
+  bool Shard::ReplicationSnapshot(Serializer &serializer) {
+    // An empty batch of records at the current sequence, the records from there on come after the sections
+    if (!command_log.since(command_log.sequence(), 0, serializer)) {
+      return false;
+    }
+    std::vector<std::string> sections = SnapshotSections();
+    serializer.put(static_cast<uint64_t>(sections.size()));
+    for (const auto &section : sections) {
+      serializer.put(section);
+    }
+    return true;
   }
 
-  uint64_t Shard::NodeGetID(const std::string &type, const std::string &key) {
-    // Check if the Type exists
-    auto type_search = node_keys.find(type);
-    if (type_search != std::end(node_keys)) {
-      // Check if the key exists
-      auto key_search = type_search->second.find(key);
-      if (key_search != std::end(type_search->second)) {
-        return key_search->second;
+  bool Shard::ReplicationApply(Deserializer &reader) {
+    uint64_t primary_sequence = reader.getUint64();
+    uint64_t count = reader.getUint64();
+    for (; count > 0 && !reader.failed(); count--) {
+      std::string record = reader.getString();
+      if (reader.failed()) {
+        return false;
       }
+      Deserializer record_reader(record.data(), record.size());
+      auto command = static_cast<Command>(record_reader.getUint8());
+      if (!CommandReplay(command, record_reader)) {
+        return false;
+      }
+      replica_sequence++;
     }
-    // Invalid Type or Key
-    return 0;
+    if (reader.failed()) {
+      return false;
+    }
+    replica_primary_sequence = primary_sequence;
+    if (replica_sequence == replica_primary_sequence) {
+      replica_caught_up = std::chrono::steady_clock::now();
+    }
+    return true;
   }
 
-  Node Shard::NodeGet(uint64_t id) {
-    if (ValidNodeId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      return nodes.at(internal_id);
+  bool Shard::ReplicationRestore(Deserializer &reader) {
+    // The sequence of the snapshot and an empty batch of records, then the sections
+    uint64_t sequence = reader.getUint64();
+    reader.getUint64();
+    std::vector<std::string> sections;
+    for (uint64_t count = reader.getUint64(); count > 0 && !reader.failed(); count--) {
+      sections.emplace_back(reader.getString());
     }
-
-    // Return the invalid zero node
-    return nodes.at(0);
+    if (reader.failed() || !reader.done() || !SnapshotRestore(sections)) {
+      return false;
+    }
+    replica_sequence = sequence;
+    replica_primary_sequence = sequence;
+    replica_caught_up = std::chrono::steady_clock::now();
+    return true;
   }
 
-  Node Shard::NodeGet(const std::string &type, const std::string &key) {
-      return NodeGet(NodeGetID(type, key));
+  uint64_t Shard::ReplicationSequence() const {
+    return replica_sequence;
   }
 
-  bool Shard::NodeRemove(const std::string &type, const std::string &key) {
-    // Check if the type exists
-    auto type_search = node_keys.find(type);
-    if (type_search != std::end(node_keys)) {
-      uint16_t node_type = node_types.getTypeId(type);
-      // Check if the key exists
-      auto key_search = type_search->second.find(key);
-      uint64_t external_id = key_search->second;
-      uint64_t internal_id = externalToInternal(external_id);
-      // Leave Zero node alone
-      if (internal_id > 0) {
-        // remove the key
-        type_search->second.erase(key);
-        // empty the node
-        nodes.at(internal_id) = Node();
-        // add id to deleted nodes for reuse
-        deleted_nodes.add(internal_id);
-        // remove id from type
-        node_types.removeId(node_type, external_id);
+  std::map<std::string, std::any> Shard::ReplicationStatus() {
+    std::map<std::string, std::any> status;
+    status.emplace("shard", static_cast<int64_t>(shard_id));
+    if (read_only) {
+      auto staleness = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - replica_caught_up);
+      status.emplace("sequence", static_cast<int64_t>(replica_sequence));
+      status.emplace("lag", static_cast<int64_t>(replica_primary_sequence - replica_sequence));
+      status.emplace("staleness", static_cast<int64_t>(staleness.count()));
+    } else {
+      status.emplace("sequence", static_cast<int64_t>(command_log.sequence()));
+      status.emplace("lag", int64_t(0));
+      status.emplace("staleness", int64_t(0));
+    }
+    return status;
+  }
 
-        // Go through all the outgoing relationships and delete them and their counterparts that I own
-        for (auto &types : outgoing_relationships.at(internal_id)) {
-          // Get the Relationship Type of the list
-          uint16_t relType = types.rel_type_id;
+  seastar::future<std::vector<std::map<std::string, std::any>>> Shard::ReplicationStatusPeered() {
+    return PeerMap("ReplicationStatus", [] (Shard &local_shard) {
+      return local_shard.ReplicationStatus();
+    });
+  }
 
-          for (Ids ids : types.ids) {
-            uint64_t internal_rel_id = externalToInternal(ids.rel_id);
-            // Add the relationship to be recycled
-            deleted_relationships.add(internal_rel_id);
-            // Decrement the relationship type counts
-            relationship_types.removeId(relType, ids.rel_id);
+  void Shard::ReadOnly() {
+    read_only = true;
+    replica_caught_up = std::chrono::steady_clock::now();
+    for (auto &state : lua_states) {
+      for (const auto &name : LUA_WRITES) {
+        state[name] = sol::lua_nil;
+      }
+    }
+  }
 
-            // Clear the relationship properties
-            Relationship emptyRelationship;
-            relationships.at(internal_rel_id) = emptyRelationship;
+  bool Shard::IsReadOnly() const {
+    return read_only;
+  }
 
-            // Remove relationship from other node that I own
-            if (CalculateShardId(ids.node_id) == shard_id) {
-              uint64_t other_internal_id = externalToInternal(ids.node_id);
+  // Result Cache ==============================================================================================================================
 
-              auto group = find_if(std::begin(incoming_relationships.at(other_internal_id)), std::end(incoming_relationships.at(other_internal_id)),
-                                   [relType] (const Group& g) { return g.rel_type_id == relType; } );
+  void Shard::ResultCacheResize(uint64_t max_bytes) {
+    result_cache.resize(max_bytes);
+  }
 
-              if (group != std::end(incoming_relationships.at(other_internal_id))) {
-                group->ids.erase(std::remove_if(std::begin(group->ids), std::end(group->ids), [ids](Ids entry) {
-                       return entry.rel_id == ids.rel_id;
-                }), std::end(group->ids));
-              }
+  bool Shard::ResultCacheEnabled() const {
+    return result_cache.enabled();
+  }
 
-            }
-          }
-        }
+  bool Shard::ResultCacheGet(const std::string &key, uint64_t epoch, std::string &result) {
+    return result_cache.get(key, epoch, result);
+  }
 
-        // Empty outgoing relationships
-        std::vector<Group> emptyOut;
-        outgoing_relationships.at(internal_id).swap(emptyOut);
+  void Shard::ResultCachePut(const std::string &key, uint64_t epoch, std::string result) {
+    result_cache.put(key, epoch, std::move(result));
+  }
 
-        // Go through all the incoming relationships and delete them and their counterpart
-        for (auto &types : incoming_relationships.at(internal_id)) {
-          // Get the Relationship Type of the list
-          uint16_t relType = types.rel_type_id;
+  uint64_t Shard::MutationEpoch() const {
+    // Every change of the shard goes through its command log
+    return command_log.epoch();
+  }
 
-          for (Ids ids : types.ids) {
-            if (ids.node_id != external_id) {
-              // Add the relationship to be recycled
-              deleted_relationships.add(ids.rel_id);
-              // Decrement the relationship type counts
-              relationship_types.removeId(relType, ids.rel_id);
+  void Shard::MutationEpochShare(PublishedEpoch* epochs) {
+    mutation_epochs = epochs;
+    command_log.publish(epochs == nullptr ? nullptr : &epochs[shard_id]);
+  }
 
-              // Clear the relationship properties
-              Relationship emptyRelationship;
-              uint64_t internal_rel_id = externalToInternal(ids.rel_id);
-              relationships.at(internal_rel_id) = emptyRelationship;
+  uint64_t Shard::MutationEpochs() const {
+    if (mutation_epochs == nullptr) {
+      return MutationEpoch();
+    }
+    // Epochs only go up, so their sum stays the same only while no shard changes
+    uint64_t sum = 0;
+    for (uint16_t i = 0; i < cpus; i++) {
+      sum += mutation_epochs[i].epoch.load(std::memory_order_acquire);
+    }
+    return sum;
+  }
 
-              // Remove relationship from other node that I own
-              if (CalculateShardId(ids.node_id) == shard_id) {
-                uint64_t other_internal_id = externalToInternal(ids.node_id);
+  // Memory ====================================================================================================================================
 
-                auto group = find_if(std::begin(outgoing_relationships.at(other_internal_id)), std::end(outgoing_relationships.at(other_internal_id)),
-                                     [relType] (const Group& g) { return g.rel_type_id == relType; } );
+  static const uint64_t MEMORY_SAMPLES = 4096;// Items looked at to estimate what a vector holds outside of itself
+  static const uint64_t SHORT_STRING = 15;// Strings up to this long live inside the string itself
 
-                if (group != std::end(outgoing_relationships.at(other_internal_id))) {
-                  group->ids.erase(std::remove_if(std::begin(group->ids), std::end(group->ids), [ids](Ids entry) {
-                         return entry.rel_id == ids.rel_id;
-                  }), std::end(group->ids));
-                }
+  static uint64_t StringHeapBytes(size_t length) {
+    return length > SHORT_STRING ? length + 1 : 0;
+  }
 
-              }
-            }
-          }
-        }
+  // Bytes the items of a vector hold outside of it, from a few of them spread evenly so large shards are not walked on every scrape
+  template <typename T, typename Function>
+  static uint64_t SampledBytes(const std::vector<T>& items, Function bytes) {
+    if (items.empty()) {
+      return 0;
+    }
+    uint64_t stride = std::max<uint64_t>(1, items.size() / MEMORY_SAMPLES);
+    uint64_t sampled = 0;
+    uint64_t total = 0;
+    for (uint64_t position = 0; position < items.size(); position += stride) {
+      total += bytes(items[position]);
+      sampled++;
+    }
+    return static_cast<uint64_t>(static_cast<double>(total) * static_cast<double>(items.size()) / static_cast<double>(sampled));
+  }
 
-        // Empty incoming relationships
-        std::vector<Group> emptyIn;
-        incoming_relationships.at(internal_id).swap(emptyIn);
+  uint64_t Shard::MemoryNodes() const {
+    uint64_t bytes = nodes.capacity() * sizeof(Node) + node_property_rows.capacity() * sizeof(uint64_t);
+    return bytes + SampledBytes(nodes, [] (const Node& node) {
+      return StringHeapBytes(node.getKey().size());
+    });
+  }
 
-        return true;
-      }
+  uint64_t Shard::MemoryRelationships() const {
+    // The arrays, the property columns and the recency indexes are counted exactly, there is nothing per relationship to sample
+    uint64_t bytes = relationships.bytes();
+    for (const auto& [type_id, index] : relationship_recency_indexes) {
+      bytes += index.bytes();
     }
-    return false;
+    return bytes;
   }
 
-  bool Shard::NodeRemove(uint64_t id) {
-    if (ValidNodeId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      Node node = nodes.at(internal_id);
-      std::string type = node_types.getType(node.getTypeId());
-      std::string key = node.getKey();
-      return NodeRemove(type, key);
+  uint64_t Shard::MemoryProperties() const {
+    // The keys are counted once here though the relationship columns use them too
+    uint64_t bytes = property_keys->bytes();
+    for (const auto& [type_id, properties] : node_properties) {
+      bytes += properties.bytes();
     }
+    return bytes;
+  }
 
-    return false;
+  uint64_t Shard::MemoryAdjacency() const {
+    auto groups_bytes = [] (const std::vector<Group>& groups) {
+      uint64_t held = groups.capacity() * sizeof(Group);
+      for (const auto& group : groups) {
+        held += group.ids.bytes();
+      }
+      return held;
+    };
+    uint64_t bytes = (outgoing_relationships.capacity() + incoming_relationships.capacity()) * sizeof(std::vector<Group>);
+    bytes += SampledBytes(outgoing_relationships, groups_bytes) + SampledBytes(incoming_relationships, groups_bytes);
+    return bytes + packed_outgoing_relationships.bytes() + packed_incoming_relationships.bytes();
   }
 
-  uint16_t Shard::NodeGetTypeId(uint64_t id) {
-    if (ValidNodeId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      Node node = nodes.at(internal_id);
-      return node.getTypeId();
+  uint64_t Shard::MemoryKeys() const {
+    // The index keeps its own copy of every key
+    uint64_t bytes = node_keys.capacity() * sizeof(NodeKeys);
+    for (const auto& keys : node_keys) {
+      bytes += keys.bucket_count() / 8 + keys.size() * (sizeof(std::string) + sizeof(uint64_t));
     }
-    // Invalid Node Id
-    return 0;
+    return bytes + SampledBytes(nodes, [] (const Node& node) {
+      return StringHeapBytes(node.getKey().size());
+    });
   }
 
-  std::string Shard::NodeGetType(uint64_t id) {
-    if (ValidNodeId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      Node node = nodes.at(internal_id);
-      uint16_t type_id = node.getTypeId();
-      return node_types.getType(type_id);
+  uint64_t Shard::MemoryLua() {
+    uint64_t bytes = 0;
+    for (auto& state : lua_states) {
+      bytes += static_cast<uint64_t>(lua_gc(state.lua_state(), LUA_GCCOUNT, 0)) * 1024 + lua_gc(state.lua_state(), LUA_GCCOUNTB, 0);
     }
-    // Invalid Node Id
-    return node_types.getType(0);
+    return bytes;
   }
 
-  std::string Shard::NodeGetKey(uint64_t id) {
-    if (ValidNodeId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      Node node = nodes.at(internal_id);
-      return node.getKey();
-    }
-    // Invalid Node Id
-    return nodes.at(0).getKey();
+  uint64_t Shard::MemoryUsed() {
+    return MemoryNodes() + MemoryRelationships() + MemoryProperties() + MemoryAdjacency() + MemoryKeys() + MemoryLua() + result_cache.getBytes();
   }
 
-  // Node Properties
+  std::map<std::string, std::any> Shard::MemoryStatus() {
+    std::map<std::string, std::any> status;
+    status.emplace("shard", static_cast<int64_t>(shard_id));
+    status.emplace("allocated", static_cast<int64_t>(seastar::memory::stats().allocated_memory()));
+    status.emplace("nodes", static_cast<int64_t>(MemoryNodes()));
+    status.emplace("relationships", static_cast<int64_t>(MemoryRelationships()));
+    status.emplace("properties", static_cast<int64_t>(MemoryProperties()));
+    status.emplace("adjacency", static_cast<int64_t>(MemoryAdjacency()));
+    status.emplace("keys", static_cast<int64_t>(MemoryKeys()));
+    status.emplace("lua", static_cast<int64_t>(MemoryLua()));
+    status.emplace("result_cache", static_cast<int64_t>(result_cache.getBytes()));
+    status.emplace("estimated", memory_estimated);
+    status.emplace("soft_limit", static_cast<int64_t>(memory_soft_limit));
+    status.emplace("hard_limit", static_cast<int64_t>(memory_hard_limit));
+    status.emplace("level", static_cast<int64_t>(memory_levels[shard_id]));
+    status.emplace("rejections", static_cast<int64_t>(memory_rejections));
+    return status;
+  }
 
-  std::any Shard::NodePropertyGet(const std::string &type, const std::string &key, const std::string &property) {
-    uint64_t id = NodeGetID(type, key);
-    return NodePropertyGet(id, property);
+  seastar::future<std::vector<std::map<std::string, std::any>>> Shard::MemoryStatusPeered() {
+    return PeerMap("MemoryStatus", [] (Shard &local_shard) {
+      return local_shard.MemoryStatus();
+    });
   }
 
-  std::string Shard::NodePropertyGetString(const std::string &type, const std::string &key, const std::string &property) {
-    uint64_t id = NodeGetID(type, key);
-    return NodePropertyGetString(id, property);
+  void Shard::MemoryLimits(uint64_t soft_limit, uint64_t hard_limit, uint64_t interval, bool estimated) {
+    memory_soft_limit = soft_limit;
+    memory_hard_limit = hard_limit;
+    memory_estimated = estimated;
+    memory_timer.cancel();
+    if ((soft_limit > 0 || hard_limit > 0) && interval > 0) {
+      memory_timer.set_callback([this] {
+        MemoryCheck();
+      });
+      memory_timer.arm_periodic(std::chrono::milliseconds(interval));
+    }
   }
 
-  int64_t Shard::NodePropertyGetInteger(const std::string &type, const std::string &key, const std::string &property) {
-    uint64_t id = NodeGetID(type, key);
-    return NodePropertyGetInteger(id, property);
+  void Shard::MemoryStop() {
+    memory_timer.cancel();
   }
 
-  double Shard::NodePropertyGetDouble(const std::string &type, const std::string &key, const std::string &property) {
-    uint64_t id = NodeGetID(type, key);
-    return NodePropertyGetDouble(id, property);
+  uint8_t Shard::MemoryLevel(uint64_t allocated) const {
+    if (memory_hard_limit > 0 && allocated >= memory_hard_limit) {
+      return MEMORY_HARD;
+    }
+    if (memory_soft_limit > 0 && allocated >= memory_soft_limit) {
+      return MEMORY_SOFT;
+    }
+    return 0;
   }
 
-  bool Shard::NodePropertyGetBoolean(const std::string &type, const std::string &key, const std::string &property) {
-    uint64_t id = NodeGetID(type, key);
-    return NodePropertyGetBoolean(id, property);
+  void Shard::MemoryCheck() {
+    uint8_t level = MemoryLevel(memory_estimated ? MemoryUsed() : seastar::memory::stats().allocated_memory());
+    if (level == memory_levels[shard_id]) {
+      return;
+    }
+    // A write for this shard can come in on any core, so every core needs to know
+    static_cast<void>(PeerOnAll("MemoryLevelSet", [from = shard_id, level] (Shard &local_shard) {
+      local_shard.MemoryLevelSet(from, level);
+    }));
   }
 
-  std::map<std::string, std::any> Shard::NodePropertyGetObject(const std::string &type, const std::string &key, const std::string &property) {
-    uint64_t id = NodeGetID(type, key);
-    return NodePropertyGetObject(id, property);
+  void Shard::MemoryLevelSet(uint8_t from_shard, uint8_t level) {
+    memory_levels[from_shard] = level;
   }
 
-  std::any Shard::NodePropertyGet(uint64_t id, const std::string &property) {
-    // If the node is valid
-    if (ValidNodeId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      // Look for the property
-      return nodes.at(internal_id).getProperty(property);
-    }
-    // Invalid node id, property name or type
-    return tombstone_any;
+  uint8_t Shard::MemoryPressure() const {
+    return *std::max_element(memory_levels.begin(), memory_levels.end());
   }
 
-  std::string Shard::NodePropertyGetString(uint64_t id, const std::string &property) {
-    // If the node is valid
-    if (ValidNodeId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      // Look for the property
-      std::any value = nodes.at(internal_id).getProperty(property);
-      if (value.type() == typeid(std::string) ) {
-        return std::any_cast<std::string>(value);
-      }
+  bool Shard::MemoryRejects(uint8_t level) {
+    if (MemoryPressure() < level) {
+      return false;
     }
-    // Invalid node id, property name or type
-    return tombstone_string;
+    memory_rejections++;
+    return true;
   }
 
-  int64_t Shard::NodePropertyGetInteger(uint64_t id, const std::string &property) {
-    // If the node is valid
-    if (ValidNodeId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      // Look for the property
-      std::any value = nodes.at(internal_id).getProperty(property);
-      if (value.type() == typeid(int64_t) ) {
-        return std::any_cast<int64_t>(value);
-      }
+  // Read Views ================================================================================================================================
+
+  bool Shard::ReadViewOpen(uint64_t view_id, uint64_t ttl_seconds) {
+    // Views nobody closed go away once they expire, so forgotten exports do not keep copies forever
+    auto now = std::chrono::steady_clock::now();
+    for (auto view = std::begin(read_views); view != std::end(read_views);) {
+      view = view->second.isExpired(now) ? read_views.erase(view) : std::next(view);
     }
-    // Invalid node id, property name or type
-    return tombstone_int;
+    return read_views.try_emplace(view_id, nodes.size(), relationships.size(), now + std::chrono::seconds(ttl_seconds)).second;
   }
 
-  double Shard::NodePropertyGetDouble(uint64_t id, const std::string &property) {
-    // If the node is valid
-    if (ValidNodeId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      // Look for the property
-      std::any value = nodes.at(internal_id).getProperty(property);
-      if (value.type() == typeid(double) ) {
-        return std::any_cast<double>(value);
-      }
+  bool Shard::ReadViewClose(uint64_t view_id) {
+    return read_views.erase(view_id) > 0;
+  }
+
+  bool Shard::ReadViewExists(uint64_t view_id) {
+    return ReadViewOf(view_id) != nullptr;
+  }
+
+  uint64_t Shard::ReadViewCount() const {
+    return read_views.size();
+  }
+
+  ReadView* Shard::ReadViewOf(uint64_t view_id) {
+    auto view_search = read_views.find(view_id);
+    if (view_search == std::end(read_views)) {
+      return nullptr;
     }
-    // Invalid node id, property name or type
-    return tombstone_double;
+    if (view_search->second.isExpired(std::chrono::steady_clock::now())) {
+      read_views.erase(view_search);
+      return nullptr;
+    }
+    return &view_search->second;
   }
 
-  bool Shard::NodePropertyGetBoolean(uint64_t id, const std::string &property) {
-    // If the node is valid
-    if (ValidNodeId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      // Look for the property
-      std::any value = nodes.at(internal_id).getProperty(property);
-      if (value.type() == typeid(bool) ) {
-        return std::any_cast<bool>(value);
+  void Shard::NodePreserve(uint64_t internal_id) {
+    // Only the first change is saved, it is the version every view opened before it saw
+    for (auto &[view_id, view] : read_views) {
+      if (internal_id < view.getNodeCount() && !view.hasNode(internal_id)) {
+        view.saveNode(internal_id, nodes.at(internal_id).getId() == 0 ? Node() : NodeCopy(internal_id));
+        read_view_copies++;
       }
     }
-    // Invalid node id, property name or type
-    return tombstone_boolean;
   }
 
-  std::map<std::string, std::any> Shard::NodePropertyGetObject(uint64_t id, const std::string &property) {
-    // If the node is valid
-    if (ValidNodeId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      // Look for the property
-      std::any value = nodes.at(internal_id).getProperty(property);
-      if (value.type() == typeid(std::map<std::string, std::any>) ) {
-        return std::any_cast<std::map<std::string, std::any>>(value);
+  void Shard::RelationshipPreserve(uint64_t internal_id) {
+    for (auto &[view_id, view] : read_views) {
+      if (internal_id < view.getRelationshipCount() && !view.hasRelationship(internal_id)) {
+        view.saveRelationship(internal_id, RelationshipCopy(internal_id));
+        read_view_copies++;
       }
     }
-    // Invalid node id, property name or type
-    return tombstone_object;
   }
 
-  bool Shard::NodePropertySet(const std::string &type, const std::string &key, const std::string &property, std::string value) {
-    uint64_t id = NodeGetID(type, key);
-    return NodePropertySet(id, property, std::move(value));
+  void Shard::ReadViewShare(std::atomic<uint64_t>* epochs) {
+    read_view_epochs = epochs;
+    read_view_epoch = epochs->load(std::memory_order_acquire);
   }
 
-  bool Shard::NodePropertySet(const std::string &type, const std::string &key, const std::string &property, const char *value) {
-    uint64_t id = NodeGetID(type, key);
-    return NodePropertySet(id, property, std::string((value)));
+  seastar::future<uint64_t> Shard::ReadViewOpenPeered(uint64_t ttl_seconds) {
+    // The view is handed out first, then each shard pins it the first time it hears of it: from the open, or from a call
+    // or an answer of a shard that already pinned it. A write that spans shards is in the view on all of them or on none
+    uint64_t view_id = read_view_epochs->fetch_add(1, std::memory_order_acq_rel) + 1;
+    ReadViewCatchUp();
+    return PeerOnAll("ReadViewOpen", [view_id, ttl_seconds] (Shard &local_shard) {
+      local_shard.ReadViewCatchUp();
+      ReadView* view = local_shard.ReadViewOf(view_id);
+      if (view != nullptr) {
+        view->setExpires(std::chrono::steady_clock::now() + std::chrono::seconds(ttl_seconds));
+      }
+    }).then([view_id] {
+      return view_id;
+    });
   }
 
-  bool Shard::NodePropertySet(const std::string &type, const std::string &key, const std::string &property, int64_t value) {
-    uint64_t id = NodeGetID(type, key);
-    return NodePropertySet(id, property, value);
+  seastar::future<bool> Shard::ReadViewClosePeered(uint64_t view_id) {
+    return PeerMapReduce("ReadViewClose", [view_id] (Shard &local_shard) {
+      return local_shard.ReadViewClose(view_id);
+    }, false, std::logical_or<bool>());
   }
 
-  bool Shard::NodePropertySet(const std::string &type, const std::string &key, const std::string &property, double value) {
-    uint64_t id = NodeGetID(type, key);
-    return NodePropertySet(id, property, value);
+  seastar::future<bool> Shard::ReadViewExistsPeered(uint64_t view_id) {
+    // A view is only whole while every shard still has it
+    return PeerMapReduce("ReadViewExists", [view_id] (Shard &local_shard) {
+      return local_shard.ReadViewExists(view_id);
+    }, true, std::logical_and<bool>());
   }
 
-  bool Shard::NodePropertySet(const std::string &type, const std::string &key, const std::string &property, bool value) {
-    uint64_t id = NodeGetID(type, key);
-    return NodePropertySet(id, property, value);
-  }
+  // Shard Ids =================================================================================================================================
 
-  bool Shard::NodePropertySet(const std::string &type, const std::string &key, const std::string &property, std::map<std::string, std::any> value) {
-    uint64_t id = NodeGetID(type, key);
-    return NodePropertySet(id, property, std::move(value));
+  seastar::future<uint8_t> Shard::getShardId() {
+    return seastar::make_ready_future<uint8_t>(shard_id);
   }
 
-  bool Shard::NodePropertySetFromJson(const std::string &type, const std::string &key, const std::string &property, const std::string &value) {
+  seastar::future<std::vector<uint8_t>> Shard::getShardIds() {
+    return PeerMap("getShardIds", [](Shard &local_shard) {
+           return local_shard.getShardId();
+    });
+  }
+
+  sol::as_table_t<std::vector<std::uint8_t>> Shard::ShardIdsGet() {
+    return sol::as_table(getShardIds().get0());
+  }
+
+  // Lua
+
+  seastar::future<std::string> Shard::RunLua(const std::string &script) {
+    // A JSON body carries the script and its parameters separately, anything else is the script itself
+    size_t first = script.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos || script[first] != '{') {
+      return RunLua(script, std::map<std::string, std::any>());
+    }
+
+    std::map<std::string, std::any> params;
+    dom::object object;
+    if (parser.parse(script).get(object)) {
+      return seastar::make_ready_future<std::string>(EXCEPTION + "Invalid JSON");
+    }
+    dom::object params_object;
+    if (!object["params"].get(params_object)) {
+      convertProperties(params, params_object);
+    }
+    // A map script runs on every shard and needs a reduce script to put the results together
+    std::string_view map;
+    if (!object["map"].get(map)) {
+      std::string_view reduce;
+      if (map.empty() || object["reduce"].get(reduce) || reduce.empty()) {
+        return seastar::make_ready_future<std::string>(EXCEPTION + "Missing map or reduce script");
+      }
+      return RunLuaMapReduce(std::string(map), std::string(reduce), params);
+    }
+    std::string_view text;
+    if (object["script"].get(text) || text.empty()) {
+      return seastar::make_ready_future<std::string>(EXCEPTION + "Missing script");
+    }
+    return RunLua(std::string(text), params);
+  }
+
+  seastar::future<std::string> Shard::RunLua(const std::string &script, const std::map<std::string, std::any> &params) {
+    return RunLuaScript(LUA_PRELUDE, script, params, std::vector<std::string>());
+  }
+
+  seastar::future<std::string> Shard::RunLuaMapReduce(std::string map, std::string reduce, std::map<std::string, std::any> params) {
+    // The map runs on every shard at once against the data it holds, only its JSON result crosses over to this shard
+    std::vector<std::string> partials = co_await PeerMap("RunLuaMap", [map = std::move(map), params] (Shard &local_shard) {
+      return local_shard.RunLua(map, params);
+    });
+    for (const auto& partial : partials) {
+      if (partial.rfind(EXCEPTION, 0) == 0) {
+        co_return partial;
+      }
+    }
+    co_return co_await RunLuaScript(LUA_REDUCE_PRELUDE, std::move(reduce), std::move(params), std::move(partials));
+  }
+
+  seastar::future<std::string> Shard::RunLuaScript(std::string prelude, std::string script, std::map<std::string, std::any> params, std::vector<std::string> partials) {
+
+    // Take a free Lua VM, or wait in line until one is given back. Waiting happens before the thread starts,
+    // so only the scripts that are running hold a thread stack and the ones in line are a suspended coroutine each.
+    // The script still runs in a thread, its calls into the graph wait with get0 from inside the Lua stack
+    auto waiting = std::chrono::steady_clock::now();
+    seastar::lw_shared_ptr<Trace> trace = CurrentTrace();
+    int64_t traced_waiting = trace ? Trace::now() : 0;
+    seastar::semaphore_units<> units = co_await seastar::get_units(lua_states_available, 1);
+    lua_wait.record(waiting);
+    if (trace) {
+      trace->stage("lua_wait", traced_waiting);
+    }
+    seastar::thread_attributes attributes;
+    attributes.sched_group = lua_group;
+    // The coroutine holds the script, its parameters and the VM until the thread is done, so the thread borrows them
+    co_return co_await seastar::async(std::move(attributes), [&] () {
+      // The calls the script makes count against the trace of its request, whichever request is running when they are made
+      seastar::thread_context* thread = seastar::thread_impl::get();
+      int64_t traced_running = 0;
+      if (trace) {
+        traced_threads[thread] = trace;
+        traced_running = Trace::now();
+      }
+      auto untrace = seastar::defer([thread, &trace, this] () noexcept {
+        if (trace) {
+          traced_threads.erase(thread);
+        }
+      });
+      std::string result = LuaExecute(prelude, script, params, partials);
+      if (trace) {
+        trace->stage("lua", traced_running);
+      }
+      return result;
+    });
+  }
+
+  std::string Shard::LuaExecute(const std::string &prelude, const std::string &script, const std::map<std::string, std::any> &params, const std::vector<std::string> &partials) {
+    std::string result;
+    lua_executions++;
+    uint8_t vm = free_lua_states.back();
+    free_lua_states.pop_back();
+    sol::state &state = lua_states[vm];
+    auto &scripts = lua_scripts[vm];
+    lua_budgets[vm].instructions = 0;
+    lua_budgets[vm].memory_base = state.memory_used();
+
+    sol::protected_function_result script_result;
+    try {
+      // Compile each script once per VM, the parameters are passed in as the params table.
+      // The prelude is part of the key, a reduce script may have the same text as a plain one
+      std::string key = prelude + script;
+      auto script_search = scripts.find(key);
+      if (script_search == std::end(scripts)) {
+        // Inject json encoding
+        std::stringstream ss(script);
+        std::string line;
+        std::vector<std::string> lines;
+        while(std::getline(ss,line,'\n')){
+          lines.emplace_back(line);
+        }
+
+        lines.back() = "return json.encode({" + lines.back() + "})";
+
+        std::string executable = prelude + join(lines, "\n");
+        sol::load_result loaded = state.load(executable);
+        if (!loaded.valid()) {
+          sol::error err = loaded;
+          std::string what = err.what();
+          free_lua_states.push_back(vm);
+          return EXCEPTION + what;
+        }
+        // Keep the cache bounded, most traffic is a few shapes of script
+        if (scripts.size() >= LUA_SCRIPTS_SIZE) {
+          scripts.clear();
+        }
+        script_search = scripts.emplace(key, loaded.get<sol::protected_function>()).first;
+      }
+
+      sol::table lua_params = state.create_table();
+      for (const auto& [key, value] : params) {
+        lua_params[key] = Property::toLua(value, sol::this_state(state.lua_state()));
+      }
+      script_result = script_search->second(lua_params, sol::as_table(partials));
+      if (script_result.valid()) {
+        result = script_result.get<std::string>();
+      } else {
+        sol::error err = script_result;
+        std::string what = err.what();
+        result = EXCEPTION + what;
+      }
+    } catch (...) {
+      sol::error err = script_result;
+      std::string what = err.what();
+      result = EXCEPTION + what;
+    }
+    free_lua_states.push_back(vm);
+    return result;
+  }
+
+  void Shard::LuaLimits(uint64_t max_instructions, uint64_t max_memory, seastar::scheduling_group group, bool preempt) {
+    lua_max_instructions = max_instructions;
+    lua_max_memory = max_memory;
+    lua_group = group;
+
+    // LuaJIT does not run the count hook inside the traces it compiles, so a VM the hook watches is only interpreted
+    bool hooked = preempt || max_instructions > 0 || max_memory > 0;
+    for (sol::state &state : lua_states) {
+      if (hooked) {
+        lua_sethook(state.lua_state(), &Shard::LuaHook, LUA_MASKCOUNT, LUA_HOOK_INSTRUCTIONS);
+      } else {
+        lua_sethook(state.lua_state(), nullptr, 0, 0);
+      }
+      luaJIT_setmode(state.lua_state(), 0, LUAJIT_MODE_ENGINE | (hooked ? LUAJIT_MODE_OFF : LUAJIT_MODE_ON));
+    }
+  }
+
+  void Shard::LuaHook(lua_State *state, lua_Debug *) {
+    lua_getfield(state, LUA_REGISTRYINDEX, LUA_BUDGET);
+    auto *budget = static_cast<LuaBudget *>(lua_touserdata(state, -1));
+    lua_pop(state, 1);
+    if (budget == nullptr) {
+      return;
+    }
+    Shard &shard = *budget->shard;
+
+    budget->instructions += LUA_HOOK_INSTRUCTIONS;
+    if (shard.lua_max_instructions > 0 && budget->instructions > shard.lua_max_instructions) {
+      shard.lua_aborts++;
+      luaL_error(state, "Script ran over its budget of %llu instructions", static_cast<unsigned long long>(shard.lua_max_instructions));
+    }
+    if (shard.lua_max_memory > 0) {
+      // Garbage counts until it is collected, so collect before giving up on the script
+      auto used = [state] { return static_cast<uint64_t>(lua_gc(state, LUA_GCCOUNT, 0)) * 1024 + lua_gc(state, LUA_GCCOUNTB, 0); };
+      if (used() > budget->memory_base + shard.lua_max_memory) {
+        lua_gc(state, LUA_GCCOLLECT, 0);
+        if (used() > budget->memory_base + shard.lua_max_memory) {
+          shard.lua_aborts++;
+          luaL_error(state, "Script ran over its budget of %llu bytes", static_cast<unsigned long long>(shard.lua_max_memory));
+        }
+      }
+    }
+
+    // Scripts run in a seastar thread, so the reactor can take its turn in the middle of a long loop
+    if (seastar::thread::running_in_thread() && seastar::need_preempt()) {
+      shard.lua_preemptions++;
+      seastar::thread::yield();
+    }
+  }
+
+  std::any Shard::LuaAny(const sol::object &value) {
+    // Lua numbers are all doubles, indexes key whole ones as integers
+    if (value.get_type() == sol::type::string) {
+      return value.as<std::string>();
+    }
+    if (value.get_type() == sol::type::number) {
+      return value.as<double>();
+    }
+    if (value.get_type() == sol::type::boolean) {
+      return value.as<bool>();
+    }
+    return std::any();
+  }
+
+  // Ids =================================================================================================================================
+
+  uint64_t Shard::externalToInternal(uint64_t id) {
+    return (id >> SHIFTED_BITS);
+  }
+
+  uint64_t Shard::internalToExternal(uint64_t internal_id) const {
+    return (internal_id << SHIFTED_BITS) + shard_id;
+  }
+
+  uint8_t Shard::CalculateShardId(uint64_t id) {
+    if(id < MASK) {
+      return 0;
+    }
+    return id & MASK;
+  }
+
+  uint8_t Shard::CalculateShardId(const std::string &type, const std::string &key) const {
+    return placement.getShardId(type, key);
+  }
+
+  // Relationship Types ===================================================================================================================
+  uint16_t Shard::RelationshipTypesGetCount() {
+    return relationship_types.getSize();
+  }
+
+  uint64_t Shard::RelationshipTypesGetCount(uint16_t type_id) {
+    if (relationship_types.ValidTypeId(type_id)) {
+      return relationship_types.getCount(type_id);
+    }
+    // Not a valid Relationship Type
+    return 0;
+  }
+
+  uint64_t Shard::RelationshipTypesGetCount(const std::string &type) {
+    uint16_t type_id = relationship_types.getTypeId(type);
+    return RelationshipTypesGetCount(type_id);
+  }
+
+  std::set<std::string> Shard::RelationshipTypesGet() {
+    return relationship_types.getTypes();
+  }
+
+  // Relationship Type ====================================================================================================================
+  const std::string& Shard::RelationshipTypeGetType(uint16_t type_id) {
+    return relationship_types.getType(type_id);
+  }
+
+  uint16_t Shard::RelationshipTypeGetTypeId(const std::string &type) {
+    uint16_t type_id = relationship_types.getTypeId(type);
+    if (relationship_types.ValidTypeId(type_id)) {
+      return type_id;
+    }
+    // Not a valid Relationship Type
+    return 0;
+  }
+
+  bool Shard::RelationshipTypeInsert(const std::string& type, uint16_t type_id) {
+    command_log.log(Command::RELATIONSHIP_TYPE_INSERT, type, type_id);
+    return relationship_types.addTypeId(type, type_id);
+  }
+
+  // Node Types ===========================================================================================================================
+  uint16_t Shard::NodeTypesGetCount() {
+    return node_types.getSize();
+  }
+
+  uint64_t Shard::NodeTypesGetCount(uint16_t type_id) {
+    return node_types.getCount(type_id);
+  }
+
+  uint64_t Shard::NodeTypesGetCount(const std::string &type) {
+    uint16_t type_id = node_types.getTypeId(type);
+    return NodeTypesGetCount(type_id);
+  }
+
+  std::set<std::string> Shard::NodeTypesGet() {
+    return node_types.getTypes();
+  }
+
+  // Node Type ============================================================================================================================
+  const std::string& Shard::NodeTypeGetType(uint16_t type_id) {
+    return node_types.getType(type_id);
+  }
+
+  uint16_t Shard::NodeTypeGetTypeId(const std::string &type) {
+    return node_types.getTypeId(type);
+  }
+
+  bool Shard::NodeTypeInsert(const std::string& type, uint16_t type_id) {
+    command_log.log(Command::NODE_TYPE_INSERT, type, type_id);
+    if (node_keys.size() <= type_id) {
+      node_keys.resize(type_id + 1);
+    }
+    NodeTypePropertyStore(type_id);
+    return node_types.addTypeId(type, type_id);
+  }
+
+  // Helpers ==============================================================================================================================
+  Shard::NodeKeys* Shard::NodeKeysOf(uint16_t type_id) {
+    // A gap left by a type that has not arrived yet has no keys
+    if (type_id < node_keys.size() && node_types.ValidTypeId(type_id)) {
+      return &node_keys[type_id];
+    }
+    return nullptr;
+  }
+
+  Properties& Shard::NodePropertyStore(uint64_t internal_id) {
+    return NodeTypePropertyStore(nodes.at(internal_id).getTypeId());
+  }
+
+  Properties& Shard::NodeTypePropertyStore(uint16_t type_id) {
+    return node_properties.try_emplace(type_id, property_keys).first->second;
+  }
+
+  void Shard::IndexNode(uint64_t internal_id) {
+    const Node& node = nodes.at(internal_id);
+    auto indexes = node_property_indexes.find(node.getTypeId());
+    if (indexes != std::end(node_property_indexes)) {
+      const Properties& store = NodePropertyStore(internal_id);
+      for (auto &[property, index] : indexes->second) {
+        index.add(store.getProperty(node_property_rows.at(internal_id), property), node.getId());
+      }
+    }
+  }
+
+  void Shard::UnindexNode(uint64_t internal_id) {
+    const Node& node = nodes.at(internal_id);
+    auto indexes = node_property_indexes.find(node.getTypeId());
+    if (indexes != std::end(node_property_indexes)) {
+      const Properties& store = NodePropertyStore(internal_id);
+      for (auto &[property, index] : indexes->second) {
+        index.remove(store.getProperty(node_property_rows.at(internal_id), property), node.getId());
+      }
+    }
+  }
+
+  void Shard::IndexNodeProperty(uint64_t internal_id, const std::string &property) {
+    const Node& node = nodes.at(internal_id);
+    auto indexes = node_property_indexes.find(node.getTypeId());
+    if (indexes != std::end(node_property_indexes)) {
+      auto index = indexes->second.find(property);
+      if (index != std::end(indexes->second)) {
+        index->second.add(NodePropertyStore(internal_id).getProperty(node_property_rows.at(internal_id), property), node.getId());
+      }
+    }
+  }
+
+  void Shard::UnindexNodeProperty(uint64_t internal_id, const std::string &property) {
+    const Node& node = nodes.at(internal_id);
+    auto indexes = node_property_indexes.find(node.getTypeId());
+    if (indexes != std::end(node_property_indexes)) {
+      auto index = indexes->second.find(property);
+      if (index != std::end(indexes->second)) {
+        index->second.remove(NodePropertyStore(internal_id).getProperty(node_property_rows.at(internal_id), property), node.getId());
+      }
+    }
+  }
+
+  void Shard::NodePropertyIndexBuild(uint16_t type_id, const std::string &property, PropertyIndex &index) {
+    const Properties& store = NodeTypePropertyStore(type_id);
+    for (uint64_t id : node_types.getIds(type_id)) {
+      index.add(store.getProperty(node_property_rows.at(externalToInternal(id)), property), id);
+    }
+  }
+
+  void Shard::IndexRelationship(uint64_t internal_id) {
+    auto index = relationship_recency_indexes.find(relationships.getTypeId(internal_id));
+    if (index != std::end(relationship_recency_indexes)) {
+      int64_t key;
+      if (RecencyIndex::toKey(relationships.getProperty(internal_id, index->second.getProperty()), key)) {
+        index->second.add(relationships.getStartingNodeId(internal_id), key, internal_id);
+      }
+    }
+  }
+
+  void Shard::UnindexRelationship(uint64_t internal_id) {
+    auto index = relationship_recency_indexes.find(relationships.getTypeId(internal_id));
+    if (index != std::end(relationship_recency_indexes)) {
+      int64_t key;
+      if (RecencyIndex::toKey(relationships.getProperty(internal_id, index->second.getProperty()), key)) {
+        index->second.remove(relationships.getStartingNodeId(internal_id), key, internal_id);
+      }
+    }
+  }
+
+  void Shard::RelationshipRecencyIndexBuild(uint16_t type_id) {
+    for (uint64_t id : relationship_types.getIds(type_id)) {
+      IndexRelationship(externalToInternal(id));
+    }
+  }
+
+  bool Shard::RelationshipStamp(uint16_t rel_type, const std::map<std::string, std::any> &values, std::map<std::string, std::any> &stamped) const {
+    auto index = relationship_recency_indexes.find(rel_type);
+    if (index == std::end(relationship_recency_indexes) || !index->second.stamps() || values.find(index->second.getProperty()) != std::end(values)) {
+      return false;
+    }
+    stamped = values;
+    stamped.emplace(index->second.getProperty(), RecencyIndex::now());
+    return true;
+  }
+
+  Node Shard::NodeCopy(uint64_t internal_id) {
+    // Nodes are stored without their properties, so fill them in from the property store
+    Node node = nodes.at(internal_id);
+    if (internal_id > 0) {
+      node.setProperties(NodePropertyStore(internal_id).getProperties(node_property_rows.at(internal_id)));
+    }
+    return node;
+  }
+
+  Relationship Shard::RelationshipCopy(uint64_t internal_id, NodeProjection projection) const {
+    // Relationships are stored as parallel arrays, so put one back together, with its properties unless only the ends are wanted
+    if (projection == NodeProjection::KEY) {
+      return relationships.getEndpoints(internal_id, internalToExternal(internal_id));
+    }
+    return relationships.get(internal_id, internalToExternal(internal_id));
+  }
+
+  void Shard::NodeGroupsChanged(uint64_t internal_id) {
+    packed_outgoing_relationships.invalidate(internal_id);
+    packed_incoming_relationships.invalidate(internal_id);
+  }
+
+  uint64_t Shard::NodeCountIds(uint64_t internal_id, Direction direction) {
+    uint64_t count = 0;
+    // Use the two ifs to handle ALL for a direction
+    if (direction != IN) {
+      if (packed_outgoing_relationships.isPacked(internal_id)) {
+        count += packed_outgoing_relationships.getCount(internal_id);
+      } else {
+        for (const auto &[key, value] : outgoing_relationships.at(internal_id)) {
+          count += value.size();
+        }
+      }
+    }
+    if (direction != OUT) {
+      if (packed_incoming_relationships.isPacked(internal_id)) {
+        count += packed_incoming_relationships.getCount(internal_id);
+      } else {
+        for (const auto &[key, value] : incoming_relationships.at(internal_id)) {
+          count += value.size();
+        }
+      }
+    }
+    return count;
+  }
+
+  uint64_t Shard::NodeCountIds(uint64_t internal_id, Direction direction, uint16_t type_id) {
+    uint64_t count = 0;
+    // Use the two ifs to handle ALL for a direction
+    if (direction != IN) {
+      if (packed_outgoing_relationships.isPacked(internal_id)) {
+        count += packed_outgoing_relationships.getCount(internal_id, type_id);
+      } else {
+        auto group = findGroup(outgoing_relationships.at(internal_id), type_id);
+
+        if (group != std::end(outgoing_relationships.at(internal_id))) {
+          count += group->ids.size();
+        }
+      }
+    }
+    if (direction != OUT) {
+      if (packed_incoming_relationships.isPacked(internal_id)) {
+        count += packed_incoming_relationships.getCount(internal_id, type_id);
+      } else {
+        auto group = findGroup(incoming_relationships.at(internal_id), type_id);
+
+        if (group != std::end(incoming_relationships.at(internal_id))) {
+          count += group->ids.size();
+        }
+      }
+    }
+    return count;
+  }
+
+  bool Shard::NodeRemoveDeleteIncoming(uint64_t id, const std::map<uint16_t, std::vector<uint64_t>>&grouped_relationships) {
+    command_log.log(Command::NODE_REMOVE_DELETE_INCOMING, id, grouped_relationships);
+    for (const auto& rel_type_node_ids : grouped_relationships) {
+      uint16_t rel_type_id = rel_type_node_ids.first;
+      for (auto node_id : rel_type_node_ids.second) {
+        uint64_t internal_id = externalToInternal(node_id);
+
+        NodeGroupsChanged(internal_id);
+        auto group = findGroup(incoming_relationships.at(internal_id), rel_type_id);
+
+        if (group != std::end(incoming_relationships.at(internal_id))) {
+          group->ids.erase_node(id);
+        }
+      }
+    }
+
+    return true;
+  }
+
+  std::map<uint16_t, std::map<uint16_t, std::vector<uint64_t>>> Shard::NodeRemoveGetIncoming(uint64_t internal_id) {
+    std::map<uint16_t, std::map<uint16_t, std::vector<uint64_t>>> relationships_to_delete;
+
+    // Go through all the outgoing relationships and return the counterparts that I do not own
+    for (auto &types : outgoing_relationships.at(internal_id)) {
+      // Get the Relationship Type of the list
+      uint16_t rel_type = types.rel_type_id;
+
+      for (Ids ids : types.ids) {
+        // The other node is removed from by its own shard, grouped by shard and then by relationship type
+        uint16_t node_shard_id = CalculateShardId(ids.node_id);
+        if (node_shard_id != shard_id) {
+          std::vector<uint64_t>& node_ids = relationships_to_delete[node_shard_id][rel_type];
+          // A node linked many times is only sent once, it loses all of them at once
+          if (node_ids.empty() || node_ids.back() != ids.node_id) {
+            node_ids.push_back(ids.node_id);
+          }
+        }
+      }
+    }
+
+    return relationships_to_delete;
+  }
+
+  std::map<uint16_t, std::map<uint16_t, std::vector<uint64_t>>> Shard::NodeRemoveGetOutgoing(uint64_t internal_id) {
+    std::map<uint16_t, std::map<uint16_t, std::vector<uint64_t>>> relationships_to_delete;
+
+    // Go through all the incoming relationships and return the counterparts that I do not own
+    for (auto &types : incoming_relationships.at(internal_id)) {
+      // Get the Relationship Type of the list
+      uint16_t rel_type = types.rel_type_id;
+
+      for (Ids ids : types.ids) {
+        // The other node is removed from by its own shard, grouped by shard and then by relationship type
+        uint16_t node_shard_id = CalculateShardId(ids.node_id);
+        if (node_shard_id != shard_id) {
+          std::vector<uint64_t>& node_ids = relationships_to_delete[node_shard_id][rel_type];
+          // A node linked many times is only sent once, it loses all of them at once
+          if (node_ids.empty() || node_ids.back() != ids.node_id) {
+            node_ids.push_back(ids.node_id);
+          }
+        }
+      }
+    }
+
+    return relationships_to_delete;
+  }
+
+  bool Shard::NodeRemoveDeleteOutgoing(uint64_t id, const std::map<uint16_t, std::vector<uint64_t>> &grouped_relationships) {
+    command_log.log(Command::NODE_REMOVE_DELETE_OUTGOING, id, grouped_relationships);
+    for (const auto& rel_type_node_ids : grouped_relationships) {
+      uint16_t rel_type_id = rel_type_node_ids.first;
+      for (auto node_id : rel_type_node_ids.second) {
+        uint64_t internal_id = externalToInternal(node_id);
+
+        NodeGroupsChanged(internal_id);
+        auto group = findGroup(outgoing_relationships.at(internal_id), rel_type_id);
+
+        if (group != std::end(outgoing_relationships.at(internal_id))) {
+          // Look in the relationship chain for any relationships of the node to be removed and delete them.
+          group->ids.erase_node(id, [rel_type_id, this](const Ids& entry) {
+            uint64_t internal_id = externalToInternal(entry.rel_id);
+            deleted_relationships.add(internal_id);
+            // Update the relationship type counts
+            relationship_types.removeId(rel_type_id, entry.rel_id);
+            // Clear the relationship
+            RelationshipPreserve(internal_id);
+            UnindexRelationship(internal_id);
+            relationships.remove(internal_id);
+          });
+        }
+
+      }
+    }
+
+    return true;
+  }
+
+  // Relationships a node being removed gives up on each step, and neighbors gathered before they are sent their batch
+  static const uint64_t REMOVE_BATCH = 4096;
+
+  // Neighbors go once per relationship type, however many of the removed nodes they were linked to
+  static void SortNeighbors(std::map<uint16_t, std::map<uint16_t, std::vector<uint64_t>>>& sharded_grouped_ids) {
+    for (auto& [their_shard, grouped_ids] : sharded_grouped_ids) {
+      for (auto& [rel_type_id, node_ids] : grouped_ids) {
+        std::sort(std::begin(node_ids), std::end(node_ids));
+        node_ids.erase(std::unique(std::begin(node_ids), std::end(node_ids)), std::end(node_ids));
+      }
+    }
+  }
+
+  std::map<uint16_t, std::map<uint16_t, std::vector<uint64_t>>> Shard::NodeRemoveTakeOutgoing(uint64_t id, uint64_t limit) {
+    command_log.log(Command::NODE_REMOVE_TAKE_OUTGOING, id, limit);
+    std::map<uint16_t, std::map<uint16_t, std::vector<uint64_t>>> relationships_to_delete;
+    uint64_t internal_id = externalToInternal(id);
+    NodeGroupsChanged(internal_id);
+    std::vector<Group>& groups = outgoing_relationships.at(internal_id);
+
+    // Taken from the end so nothing left behind moves, and any added while the neighbors are told are taken next time
+    while (limit > 0 && !groups.empty()) {
+      uint16_t rel_type_id = groups.back().rel_type_id;
+      limit -= groups.back().ids.erase_back(limit, [rel_type_id, &relationships_to_delete, this](const Ids& entry) {
+        // The relationships start here, so they are freed here
+        uint64_t internal_rel_id = externalToInternal(entry.rel_id);
+        deleted_relationships.add(internal_rel_id);
+        relationship_types.removeId(rel_type_id, entry.rel_id);
+        RelationshipPreserve(internal_rel_id);
+        UnindexRelationship(internal_rel_id);
+        relationships.remove(internal_rel_id);
+        relationships_to_delete[CalculateShardId(entry.node_id)][rel_type_id].push_back(entry.node_id);
+      });
+      if (groups.back().ids.empty()) {
+        groups.pop_back();
+      }
+    }
+
+    return relationships_to_delete;
+  }
+
+  std::map<uint16_t, std::map<uint16_t, std::vector<uint64_t>>> Shard::NodeRemoveTakeIncoming(uint64_t id, uint64_t limit) {
+    command_log.log(Command::NODE_REMOVE_TAKE_INCOMING, id, limit);
+    std::map<uint16_t, std::map<uint16_t, std::vector<uint64_t>>> relationships_to_delete;
+    uint64_t internal_id = externalToInternal(id);
+    NodeGroupsChanged(internal_id);
+    std::vector<Group>& groups = incoming_relationships.at(internal_id);
+
+    while (limit > 0 && !groups.empty()) {
+      uint16_t rel_type_id = groups.back().rel_type_id;
+      // The relationships start at the neighbors, they are freed there when the neighbors let go of them
+      limit -= groups.back().ids.erase_back(limit, [rel_type_id, &relationships_to_delete, this](const Ids& entry) {
+        relationships_to_delete[CalculateShardId(entry.node_id)][rel_type_id].push_back(entry.node_id);
+      });
+      if (groups.back().ids.empty()) {
+        groups.pop_back();
+      }
+    }
+
+    return relationships_to_delete;
+  }
+
+  bool Shard::NodesRemoveDeleteIncoming(const std::vector<uint64_t>& ids, const std::map<uint16_t, std::vector<uint64_t>>& grouped_relationships) {
+    command_log.log(Command::NODES_REMOVE_DELETE_INCOMING, ids, grouped_relationships);
+    for (const auto& [rel_type_id, node_ids] : grouped_relationships) {
+      for (uint64_t node_id : node_ids) {
+        // The neighbor may be gone already
+        if (!ValidNodeId(node_id)) {
+          continue;
+        }
+        uint64_t internal_id = externalToInternal(node_id);
+
+        NodeGroupsChanged(internal_id);
+        auto group = findGroup(incoming_relationships.at(internal_id), rel_type_id);
+
+        if (group != std::end(incoming_relationships.at(internal_id))) {
+          group->ids.erase_nodes(ids);
+        }
+      }
+    }
+
+    return true;
+  }
+
+  bool Shard::NodesRemoveDeleteOutgoing(const std::vector<uint64_t>& ids, const std::map<uint16_t, std::vector<uint64_t>>& grouped_relationships) {
+    command_log.log(Command::NODES_REMOVE_DELETE_OUTGOING, ids, grouped_relationships);
+    for (const auto& [rel_type_id, node_ids] : grouped_relationships) {
+      for (uint64_t node_id : node_ids) {
+        if (!ValidNodeId(node_id)) {
+          continue;
+        }
+        uint64_t internal_id = externalToInternal(node_id);
+
+        NodeGroupsChanged(internal_id);
+        auto group = findGroup(outgoing_relationships.at(internal_id), rel_type_id);
+
+        if (group != std::end(outgoing_relationships.at(internal_id))) {
+          // One pass over the chain takes the relationships to every node of the batch
+          group->ids.erase_nodes(ids, [rel_type_id = rel_type_id, this](const Ids& entry) {
+            uint64_t internal_rel_id = externalToInternal(entry.rel_id);
+            deleted_relationships.add(internal_rel_id);
+            relationship_types.removeId(rel_type_id, entry.rel_id);
+            RelationshipPreserve(internal_rel_id);
+            UnindexRelationship(internal_rel_id);
+            relationships.remove(internal_rel_id);
+          });
+        }
+      }
+    }
+
+    return true;
+  }
+
+  seastar::future<uint64_t> Shard::NodesRemoveLocal(std::vector<uint64_t> ids) {
+    return seastar::async([ids = std::move(ids), this] () mutable {
+      std::sort(std::begin(ids), std::end(ids));
+      ids.erase(std::unique(std::begin(ids), std::end(ids)), std::end(ids));
+      // Ids of other shards are not valid here
+      ids.erase(std::remove_if(std::begin(ids), std::end(ids), [this] (uint64_t id) { return !ValidNodeId(id); }), std::end(ids));
+
+      std::deque<uint64_t> working(std::begin(ids), std::end(ids));
+      std::vector<uint64_t> batch;     // The nodes the gathered neighbors have to let go of
+      std::vector<uint64_t> emptied;   // Nodes with nothing left, removed once their batch has been let go of
+      std::map<uint16_t, std::map<uint16_t, std::vector<uint64_t>>> incoming_to_delete;
+      std::map<uint16_t, std::map<uint16_t, std::vector<uint64_t>>> outgoing_to_delete;
+      uint64_t gathered = 0;
+      uint64_t removed = 0;
+
+      auto gather = [&gathered] (std::map<uint16_t, std::map<uint16_t, std::vector<uint64_t>>>& into, std::map<uint16_t, std::map<uint16_t, std::vector<uint64_t>>>&& taken) {
+        for (auto& [their_shard, grouped_ids] : taken) {
+          for (auto& [rel_type_id, node_ids] : grouped_ids) {
+            std::vector<uint64_t>& neighbors = into[their_shard][rel_type_id];
+            neighbors.insert(std::end(neighbors), std::begin(node_ids), std::end(node_ids));
+            gathered += node_ids.size();
+          }
+        }
+      };
+
+      auto flush = [&] () {
+        std::sort(std::begin(batch), std::end(batch));
+        batch.erase(std::unique(std::begin(batch), std::end(batch)), std::end(batch));
+        SortNeighbors(incoming_to_delete);
+        SortNeighbors(outgoing_to_delete);
+
+        std::vector<seastar::future<bool>> futures;
+        for (auto& [their_shard, grouped_ids] : incoming_to_delete) {
+          futures.push_back(PeerOn("NodesRemove", their_shard, [batch, grouped_ids = std::move(grouped_ids)] (Shard &local_shard) {
+                 return local_shard.NodesRemoveDeleteIncoming(batch, grouped_ids);
+          }));
+        }
+        for (auto& [their_shard, grouped_ids] : outgoing_to_delete) {
+          futures.push_back(PeerOn("NodesRemove", their_shard, [batch, grouped_ids = std::move(grouped_ids)] (Shard &local_shard) {
+                 return local_shard.NodesRemoveDeleteOutgoing(batch, grouped_ids);
+          }));
+        }
+        seastar::when_all_succeed(std::begin(futures), std::end(futures)).get();
+
+        incoming_to_delete.clear();
+        outgoing_to_delete.clear();
+        batch.clear();
+        gathered = 0;
+
+        // A node that picked up relationships while its batch was out goes around again
+        for (uint64_t id : emptied) {
+          uint64_t internal_id = externalToInternal(id);
+          if (outgoing_relationships.at(internal_id).empty() && incoming_relationships.at(internal_id).empty()) {
+            removed += NodeRemove(id);
+          } else {
+            working.push_back(id);
+          }
+        }
+        emptied.clear();
+      };
+
+      while (!working.empty() || !emptied.empty()) {
+        if (working.empty()) {
+          flush();
+          continue;
+        }
+        uint64_t id = working.front();
+        if (!ValidNodeId(id)) {
+          working.pop_front();
+          continue;
+        }
+        gather(incoming_to_delete, NodeRemoveTakeOutgoing(id, REMOVE_BATCH));
+        gather(outgoing_to_delete, NodeRemoveTakeIncoming(id, REMOVE_BATCH));
+        batch.push_back(id);
+
+        uint64_t internal_id = externalToInternal(id);
+        if (outgoing_relationships.at(internal_id).empty() && incoming_relationships.at(internal_id).empty()) {
+          working.pop_front();
+          emptied.push_back(id);
+        }
+        if (gathered >= REMOVE_BATCH) {
+          flush();
+        }
+        seastar::thread::maybe_yield();
+      }
+
+      return removed;
+    });
+  }
+
+  // Nodes ================================================================================================================================
+  uint64_t Shard::NodeInsert(uint16_t node_type, const std::string &key) {
+    uint64_t internal_id = nodes.size();
+
+    NodeKeys *keys = NodeKeysOf(node_type);
+    // The Label will always exist
+    if (keys == nullptr) {
+      return 0;
+    }
+    // Check if the key exists
+    auto key_search = keys->find(key);
+    if (key_search != std::end(*keys)) {
+      return 0;
+    }
+    // If we have deleted nodes, fill in the space by adding the new node here
+    if (deleted_nodes.isEmpty()) {
+      uint64_t external_id = internalToExternal(internal_id);
+      // Set Metadata properties
+      // Add the node to the end and prepare a place for its properties and relationships
+      nodes.emplace_back(external_id, node_type, key);
+      node_property_rows.emplace_back(NodeTypePropertyStore(node_type).addRow());
+      outgoing_relationships.emplace_back();
+      incoming_relationships.emplace_back();
+    } else {
+      internal_id = deleted_nodes.minimum();
+      // Set Metadata properties
+      Node node(internalToExternal(internal_id), node_type, key);
+      // Replace the deleted node and remove it from the list, views opened while it was deleted keep it deleted
+      NodePreserve(internal_id);
+      nodes.at(internal_id) = node;
+      node_property_rows.at(internal_id) = NodeTypePropertyStore(node_type).addRow();
+      deleted_nodes.remove(internal_id);
+    }
+    node_types.addId(node_type, internalToExternal(internal_id));
+    keys->insert({ key, internalToExternal(internal_id) });
+    return internal_id;
+  }
+
+  uint64_t Shard::NodeAddEmpty(const std::string& type, uint16_t node_type, const std::string &key) {
+    uint64_t internal_id = NodeInsert(node_type, key);
+    if (internal_id == 0) {
+      return 0;
+    }
+    uint64_t external_id = internalToExternal(internal_id);
+    command_log.log(Command::NODE_ADD, type, node_type, key, std::map<std::string, std::any>(), external_id);
+    return external_id;
+  }
+
+  uint64_t Shard::NodeAdd(const std::string &type, uint16_t node_type, const std::string &key, const std::string &properties) {
+    dom::object object;
+    if (!properties.empty() && (Shard::parser.parse(properties).get(object) || !PropertyKeysFit(object))) {
+      return 0;
+    }
+
+    uint64_t internal_id = NodeInsert(node_type, key);
+    if (internal_id == 0) {
+      return 0;
+    }
+    uint64_t external_id = internalToExternal(internal_id);
+    // The properties are decoded straight into the store, the log reads them back only when something keeps its records
+    Properties &store = NodeTypePropertyStore(node_type);
+    if (!properties.empty()) {
+      setPropertiesFromJson(store, node_property_rows.at(internal_id), object);
+    }
+    IndexNode(internal_id);
+    command_log.log(Command::NODE_ADD, type, node_type, key,
+                    command_log.recording() ? store.getProperties(node_property_rows.at(internal_id)) : std::map<std::string, std::any>(), external_id);
+    return external_id;
+  }
+
+  uint64_t Shard::NodeAdd(const std::string &type, uint16_t node_type, const std::string &key, const std::map<std::string, std::any> &values) {
+    if (!PropertyKeysFit(values)) {
+      return 0;
+    }
+    uint64_t internal_id = NodeInsert(node_type, key);
+    if (internal_id == 0) {
+      return 0;
+    }
+    uint64_t external_id = internalToExternal(internal_id);
+    NodeTypePropertyStore(node_type).setProperties(node_property_rows.at(internal_id), values);
+    IndexNode(internal_id);
+    command_log.log(Command::NODE_ADD, type, node_type, key, values, external_id);
+    return external_id;
+  }
+
+  std::vector<uint64_t> Shard::NodesAdd(const std::vector<std::tuple<std::string, std::string, std::map<std::string, std::any>>> &rows) {
+    std::vector<uint64_t> ids;
+    ids.reserve(rows.size());
+    for (const auto &[type, key, values] : rows) {
+      uint16_t node_type_id = node_types.getTypeId(type);
+      if (node_type_id > 0) {
+        ids.emplace_back(NodeAdd(type, node_type_id, key, values));
+      } else {
+        // Invalid Type
+        ids.emplace_back(0);
+      }
+    }
+
+    return ids;
+  }
+
+  uint64_t Shard::NodeGetID(std::string_view type, std::string_view key) {
+    return NodeGetID(node_types.getTypeId(type), key);
+  }
+
+  uint64_t Shard::NodeGetID(uint16_t type_id, std::string_view key) {
+    // Check if the Type exists
+    const NodeKeys *keys = NodeKeysOf(type_id);
+    if (keys != nullptr) {
+      // Check if the key exists
+      auto key_search = keys->find(key);
+      if (key_search != std::end(*keys)) {
+        return key_search->second;
+      }
+    }
+    // Invalid Type or Key
+    return 0;
+  }
+
+  std::vector<uint64_t> Shard::NodeGetIDs(const std::vector<std::pair<std::string, std::string>> &keys) {
+    std::vector<uint64_t> ids;
+    ids.reserve(keys.size());
+    for (const auto &[type, key] : keys) {
+      ids.emplace_back(NodeGetID(type, key));
+    }
+
+    return ids;
+  }
+
+  Node Shard::NodeGet(uint64_t id) {
+    if (ValidNodeId(id)) {
+      uint64_t internal_id = externalToInternal(id);
+      return NodeCopy(internal_id);
+    }
+
+    // Return the invalid zero node
+    return nodes.at(0);
+  }
+
+  Node Shard::NodeGet(const std::string &type, const std::string &key) {
+      return NodeGet(NodeGetID(type, key));
+  }
+
+  bool Shard::NodeRemove(const std::string &type, const std::string &key) {
+    // Check if the type exists
+    uint16_t node_type = node_types.getTypeId(type);
+    NodeKeys *keys = NodeKeysOf(node_type);
+    if (keys != nullptr) {
+      // Check if the key exists
+      auto key_search = keys->find(key);
+      if (key_search == std::end(*keys)) {
+        return false;
+      }
+      uint64_t external_id = key_search->second;
+      uint64_t internal_id = externalToInternal(external_id);
+      // Leave Zero node alone
+      if (internal_id > 0) {
+        command_log.log(Command::NODE_REMOVE, external_id);
+        // remove the key
+        keys->erase(key_search);
+        // empty the node and release its properties
+        NodePreserve(internal_id);
+        UnindexNode(internal_id);
+        NodeTypePropertyStore(node_type).removeRow(node_property_rows.at(internal_id));
+        nodes.at(internal_id) = Node();
+        // add id to deleted nodes for reuse
+        deleted_nodes.add(internal_id);
+        // remove id from type
+        node_types.removeId(node_type, external_id);
+
+        // Go through all the outgoing relationships and delete them and their counterparts that I own
+        for (auto &types : outgoing_relationships.at(internal_id)) {
+          // Get the Relationship Type of the list
+          uint16_t relType = types.rel_type_id;
+
+          for (Ids ids : types.ids) {
+            uint64_t internal_rel_id = externalToInternal(ids.rel_id);
+            // Add the relationship to be recycled
+            deleted_relationships.add(internal_rel_id);
+            // Decrement the relationship type counts
+            relationship_types.removeId(relType, ids.rel_id);
+
+            // Clear the relationship properties
+            RelationshipPreserve(internal_rel_id);
+            UnindexRelationship(internal_rel_id);
+            relationships.remove(internal_rel_id);
+
+            // Remove relationship from other node that I own
+            if (CalculateShardId(ids.node_id) == shard_id) {
+              uint64_t other_internal_id = externalToInternal(ids.node_id);
+
+              NodeGroupsChanged(other_internal_id);
+              auto group = findGroup(incoming_relationships.at(other_internal_id), relType);
+
+              if (group != std::end(incoming_relationships.at(other_internal_id))) {
+                auto rel_to_delete = group->ids.find(Ids(external_id, ids.rel_id));
+                if (rel_to_delete != std::end(group->ids)) {
+                  group->ids.erase(rel_to_delete);
+                }
+              }
+
+            }
+          }
+        }
+
+        // Empty outgoing relationships
+        NodeGroupsChanged(internal_id);
+        std::vector<Group> emptyOut;
+        outgoing_relationships.at(internal_id).swap(emptyOut);
+
+        // Go through all the incoming relationships and delete them and their counterpart
+        for (auto &types : incoming_relationships.at(internal_id)) {
+          // Get the Relationship Type of the list
+          uint16_t relType = types.rel_type_id;
+
+          for (Ids ids : types.ids) {
+            // Relationships live with their starting node, the ones from other shards are removed there
+            if (ids.node_id != external_id && CalculateShardId(ids.node_id) == shard_id) {
+              uint64_t internal_rel_id = externalToInternal(ids.rel_id);
+              // Add the relationship to be recycled
+              deleted_relationships.add(internal_rel_id);
+              // Decrement the relationship type counts
+              relationship_types.removeId(relType, ids.rel_id);
+
+              // Clear the relationship properties
+              RelationshipPreserve(internal_rel_id);
+              UnindexRelationship(internal_rel_id);
+              relationships.remove(internal_rel_id);
+
+              // Remove relationship from other node that I own
+              uint64_t other_internal_id = externalToInternal(ids.node_id);
+
+              NodeGroupsChanged(other_internal_id);
+              auto group = findGroup(outgoing_relationships.at(other_internal_id), relType);
+
+              if (group != std::end(outgoing_relationships.at(other_internal_id))) {
+                auto rel_to_delete = group->ids.find(Ids(external_id, ids.rel_id));
+                if (rel_to_delete != std::end(group->ids)) {
+                  group->ids.erase(rel_to_delete);
+                }
+              }
+            }
+          }
+        }
+
+        // Empty incoming relationships
+        std::vector<Group> emptyIn;
+        incoming_relationships.at(internal_id).swap(emptyIn);
+
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool Shard::NodeRemove(uint64_t id) {
+    if (ValidNodeId(id)) {
+      uint64_t internal_id = externalToInternal(id);
+      const Node& node = nodes.at(internal_id);
+      std::string type = node_types.getType(node.getTypeId());
+      std::string key = node.getKey();
+      return NodeRemove(type, key);
+    }
+
+    return false;
+  }
+
+  bool Shard::NodePlace(const std::string &type, const std::string &key, uint8_t node_shard_id) {
+    if (node_shard_id >= cpus) {
+      return false;
+    }
+    command_log.log(Command::NODE_PLACE, type, key, node_shard_id);
+    placement.setShardId(type, key, node_shard_id);
+    return true;
+  }
+
+  void Shard::NodeWritesBlock(uint64_t id) {
+    blocked_nodes.insert(id);
+  }
+
+  void Shard::NodeWritesUnblock(uint64_t id) {
+    blocked_nodes.erase(id);
+  }
+
+  bool Shard::NodeWritesBlocked(uint64_t id) const {
+    return !moving_relationships && blocked_nodes.count(id) > 0;
+  }
+
+  std::vector<uint64_t> Shard::RelationshipsMoveToOutgoing(const std::vector<std::tuple<uint16_t, uint64_t, uint64_t, std::map<std::string, std::any>>>& rows) {
+    moving_relationships = true;
+    auto unmoving = seastar::defer([this] () noexcept {
+      moving_relationships = false;
+    });
+    return RelationshipsAddToOutgoing(rows);
+  }
+
+  uint16_t Shard::NodeGetTypeId(uint64_t id) {
+    if (ValidNodeId(id)) {
+      uint64_t internal_id = externalToInternal(id);
+      const Node& node = nodes.at(internal_id);
+      return node.getTypeId();
+    }
+    // Invalid Node Id
+    return 0;
+  }
+
+  std::string Shard::NodeGetType(uint64_t id) {
+    if (ValidNodeId(id)) {
+      uint64_t internal_id = externalToInternal(id);
+      const Node& node = nodes.at(internal_id);
+      uint16_t type_id = node.getTypeId();
+      return node_types.getType(type_id);
+    }
+    // Invalid Node Id
+    return node_types.getType(0);
+  }
+
+  std::string Shard::NodeGetKey(uint64_t id) {
+    if (ValidNodeId(id)) {
+      uint64_t internal_id = externalToInternal(id);
+      const Node& node = nodes.at(internal_id);
+      return node.getKey();
+    }
+    // Invalid Node Id
+    return nodes.at(0).getKey();
+  }
+
+  // Node Properties
+
+  std::any Shard::NodePropertyGet(const std::string &type, const std::string &key, const std::string &property) {
+    uint64_t id = NodeGetID(type, key);
+    return NodePropertyGet(id, property);
+  }
+
+  std::string Shard::NodePropertyGetString(const std::string &type, const std::string &key, const std::string &property) {
+    uint64_t id = NodeGetID(type, key);
+    return NodePropertyGetString(id, property);
+  }
+
+  int64_t Shard::NodePropertyGetInteger(const std::string &type, const std::string &key, const std::string &property) {
+    uint64_t id = NodeGetID(type, key);
+    return NodePropertyGetInteger(id, property);
+  }
+
+  double Shard::NodePropertyGetDouble(const std::string &type, const std::string &key, const std::string &property) {
+    uint64_t id = NodeGetID(type, key);
+    return NodePropertyGetDouble(id, property);
+  }
+
+  bool Shard::NodePropertyGetBoolean(const std::string &type, const std::string &key, const std::string &property) {
+    uint64_t id = NodeGetID(type, key);
+    return NodePropertyGetBoolean(id, property);
+  }
+
+  std::map<std::string, std::any> Shard::NodePropertyGetObject(const std::string &type, const std::string &key, const std::string &property) {
+    uint64_t id = NodeGetID(type, key);
+    return NodePropertyGetObject(id, property);
+  }
+
+  std::any Shard::NodePropertyGet(uint64_t id, const std::string &property) {
+    // If the node is valid
+    if (ValidNodeId(id)) {
+      uint64_t internal_id = externalToInternal(id);
+      // Look for the property
+      return NodePropertyStore(internal_id).getProperty(node_property_rows.at(internal_id), property);
+    }
+    // Invalid node id, property name or type
+    return tombstone_any;
+  }
+
+  std::string Shard::NodePropertyGetString(uint64_t id, const std::string &property) {
+    // If the node is valid
+    if (ValidNodeId(id)) {
+      uint64_t internal_id = externalToInternal(id);
+      // Look for the property in its typed column
+      std::string value;
+      if (NodePropertyStore(internal_id).getStringProperty(node_property_rows.at(internal_id), property, value)) {
+        return value;
+      }
+    }
+    // Invalid node id, property name or type
+    return tombstone_string;
+  }
+
+  int64_t Shard::NodePropertyGetInteger(uint64_t id, const std::string &property) {
+    // If the node is valid
+    if (ValidNodeId(id)) {
+      uint64_t internal_id = externalToInternal(id);
+      // Look for the property in its typed column
+      int64_t value;
+      if (NodePropertyStore(internal_id).getIntegerProperty(node_property_rows.at(internal_id), property, value)) {
+        return value;
+      }
+    }
+    // Invalid node id, property name or type
+    return tombstone_int;
+  }
+
+  double Shard::NodePropertyGetDouble(uint64_t id, const std::string &property) {
+    // If the node is valid
+    if (ValidNodeId(id)) {
+      uint64_t internal_id = externalToInternal(id);
+      // Look for the property in its typed column
+      double value;
+      if (NodePropertyStore(internal_id).getDoubleProperty(node_property_rows.at(internal_id), property, value)) {
+        return value;
+      }
+    }
+    // Invalid node id, property name or type
+    return tombstone_double;
+  }
+
+  bool Shard::NodePropertyGetBoolean(uint64_t id, const std::string &property) {
+    // If the node is valid
+    if (ValidNodeId(id)) {
+      uint64_t internal_id = externalToInternal(id);
+      // Look for the property in its typed column
+      bool value;
+      if (NodePropertyStore(internal_id).getBooleanProperty(node_property_rows.at(internal_id), property, value)) {
+        return value;
+      }
+    }
+    // Invalid node id, property name or type
+    return tombstone_boolean;
+  }
+
+  std::map<std::string, std::any> Shard::NodePropertyGetObject(uint64_t id, const std::string &property) {
+    // If the node is valid
+    if (ValidNodeId(id)) {
+      uint64_t internal_id = externalToInternal(id);
+      // Look for the property
+      std::any value = NodePropertyStore(internal_id).getProperty(node_property_rows.at(internal_id), property);
+      if (value.type() == typeid(std::map<std::string, std::any>) ) {
+        return std::any_cast<std::map<std::string, std::any>>(value);
+      }
+    }
+    // Invalid node id, property name or type
+    return tombstone_object;
+  }
+
+  bool Shard::NodePropertySet(const std::string &type, const std::string &key, const std::string &property, std::string value) {
+    uint64_t id = NodeGetID(type, key);
+    return NodePropertySet(id, property, std::move(value));
+  }
+
+  bool Shard::NodePropertySet(const std::string &type, const std::string &key, const std::string &property, const char *value) {
+    uint64_t id = NodeGetID(type, key);
+    return NodePropertySet(id, property, std::string((value)));
+  }
+
+  bool Shard::NodePropertySet(const std::string &type, const std::string &key, const std::string &property, int64_t value) {
+    uint64_t id = NodeGetID(type, key);
+    return NodePropertySet(id, property, value);
+  }
+
+  bool Shard::NodePropertySet(const std::string &type, const std::string &key, const std::string &property, double value) {
+    uint64_t id = NodeGetID(type, key);
+    return NodePropertySet(id, property, value);
+  }
+
+  bool Shard::NodePropertySet(const std::string &type, const std::string &key, const std::string &property, bool value) {
+    uint64_t id = NodeGetID(type, key);
+    return NodePropertySet(id, property, value);
+  }
+
+  bool Shard::NodePropertySet(const std::string &type, const std::string &key, const std::string &property, std::map<std::string, std::any> value) {
+    uint64_t id = NodeGetID(type, key);
+    return NodePropertySet(id, property, std::move(value));
+  }
+
+  bool Shard::NodePropertySetFromJson(const std::string &type, const std::string &key, const std::string &property, const std::string &value) {
+    uint64_t id = NodeGetID(type, key);
+    return NodePropertySetFromJson(id, property, value);
+  }
+
+  bool Shard::NodePropertySet(uint64_t id, const std::string &property, std::string value) {
+    // If the node is valid
+    if (ValidNodeId(id) && !NodeWritesBlocked(id) && PropertyKeysFit(property)) {
+      uint64_t internal_id = externalToInternal(id);
+      NodePreserve(internal_id);
+      UnindexNodeProperty(internal_id, property);
+      NodePropertyStore(internal_id).setProperty(node_property_rows.at(internal_id), property, value);
+      IndexNodeProperty(internal_id, property);
+      command_log.log(Command::NODE_PROPERTY_SET, id, property, std::any(value));
+      return true;
+    } else {
+      return false;
+    }
+  }
+
+  bool Shard::NodePropertiesDelete(const std::string &type, const std::string &key) {
+    uint64_t id = NodeGetID(type, key);
+    return NodePropertiesDelete(id);
+  }
+
+  bool Shard::NodePropertySet(uint64_t id, const std::string &property, const char *value) {
+    // If the node is valid
+    if (ValidNodeId(id) && !NodeWritesBlocked(id) && PropertyKeysFit(property)) {
+      uint64_t internal_id = externalToInternal(id);
+      NodePreserve(internal_id);
+      UnindexNodeProperty(internal_id, property);
+      NodePropertyStore(internal_id).setProperty(node_property_rows.at(internal_id), property, std::string(value));
+      IndexNodeProperty(internal_id, property);
+      command_log.log(Command::NODE_PROPERTY_SET, id, property, std::any(std::string(value)));
+      return true;
+    } else {
+      return false;
+    }
+  }
+
+  bool Shard::NodePropertySet(uint64_t id, const std::string &property, int64_t value) {
+    // If the node is valid
+    if (ValidNodeId(id) && !NodeWritesBlocked(id) && PropertyKeysFit(property)) {
+      uint64_t internal_id = externalToInternal(id);
+      NodePreserve(internal_id);
+      UnindexNodeProperty(internal_id, property);
+      NodePropertyStore(internal_id).setProperty(node_property_rows.at(internal_id), property, value);
+      IndexNodeProperty(internal_id, property);
+      command_log.log(Command::NODE_PROPERTY_SET, id, property, std::any(value));
+      return true;
+    } else {
+      return false;
+    }
+  }
+
+  bool Shard::NodePropertySet(uint64_t id, const std::string &property, double value) {
+    // If the node is valid
+    if (ValidNodeId(id) && !NodeWritesBlocked(id) && PropertyKeysFit(property)) {
+      uint64_t internal_id = externalToInternal(id);
+      NodePreserve(internal_id);
+      UnindexNodeProperty(internal_id, property);
+      NodePropertyStore(internal_id).setProperty(node_property_rows.at(internal_id), property, value);
+      IndexNodeProperty(internal_id, property);
+      command_log.log(Command::NODE_PROPERTY_SET, id, property, std::any(value));
+      return true;
+    } else {
+      return false;
+    }
+  }
+
+  bool Shard::NodePropertySet(uint64_t id, const std::string &property, bool value) {
+    // If the node is valid
+    if (ValidNodeId(id) && !NodeWritesBlocked(id) && PropertyKeysFit(property)) {
+      uint64_t internal_id = externalToInternal(id);
+      NodePreserve(internal_id);
+      UnindexNodeProperty(internal_id, property);
+      NodePropertyStore(internal_id).setProperty(node_property_rows.at(internal_id), property, value);
+      IndexNodeProperty(internal_id, property);
+      command_log.log(Command::NODE_PROPERTY_SET, id, property, std::any(value));
+      return true;
+    } else {
+      return false;
+    }
+  }
+
+  bool Shard::NodePropertySet(uint64_t id, const std::string &property, std::map<std::string, std::any> value) {
+    // If the node is valid
+    if (ValidNodeId(id) && !NodeWritesBlocked(id) && PropertyKeysFit(property)) {
+      uint64_t internal_id = externalToInternal(id);
+      NodePreserve(internal_id);
+      UnindexNodeProperty(internal_id, property);
+      NodePropertyStore(internal_id).setProperty(node_property_rows.at(internal_id), property, value);
+      IndexNodeProperty(internal_id, property);
+      command_log.log(Command::NODE_PROPERTY_SET, id, property, std::any(value));
+      return true;
+    } else {
+      return false;
+    }
+  }
+
+  bool Shard::NodePropertySetFromJson(uint64_t id, const std::string &property, const std::string &value) {
+    // If the node is valid
+    if (ValidNodeId(id) && !NodeWritesBlocked(id) && PropertyKeysFit(property)) {
+      std::map<std::string, std::any> values;
+      if (!value.empty()) {
+        // Get the properties
+        simdjson::error_code error;
+
+        dom::object object;
+        error = parser.parse(value).get(object);
+        if (!error) {
+          // Add the node properties
+          convertProperties(values, object);
+        } else {
+          return false;
+        }
+      }
+      uint64_t internal_id = externalToInternal(id);
+      NodePreserve(internal_id);
+      UnindexNodeProperty(internal_id, property);
+      NodePropertyStore(internal_id).setProperty(node_property_rows.at(internal_id), property, values);
+      IndexNodeProperty(internal_id, property);
+      command_log.log(Command::NODE_PROPERTY_SET, id, property, std::any(values));
+      return true;
+    } else {
+      return false;
+    }
+  }
+
+  bool Shard::NodePropertyDelete(const std::string &type, const std::string &key, const std::string &property) {
+    uint64_t id = NodeGetID(type, key);
+    return NodePropertyDelete(id, property);
+  }
+
+  bool Shard::NodePropertyDelete(uint64_t id, const std::string &property) {
+    // If the node is valid
+    if (ValidNodeId(id) && !NodeWritesBlocked(id)) {
+      uint64_t internal_id = externalToInternal(id);
+      command_log.log(Command::NODE_PROPERTY_DELETE, id, property);
+      NodePreserve(internal_id);
+      UnindexNodeProperty(internal_id, property);
+      return NodePropertyStore(internal_id).deleteProperty(node_property_rows.at(internal_id), property);
+    } else {
+      return false;
+    }
+  }
+
+  std::map<std::string, std::any> Shard::NodePropertiesGet(const std::string &type, const std::string &key) {
+    uint64_t id = NodeGetID(type, key);
+    return NodePropertiesGet(id);
+  }
+
+  bool Shard::NodePropertiesSet(const std::string &type, const std::string &key, std::map<std::string, std::any> &value) {
+    uint64_t id = NodeGetID(type, key);
+    return NodePropertiesSet(id, value);
+  }
+
+  bool Shard::NodePropertiesSetFromJson(const std::string &type, const std::string &key, const std::string &value) {
+    uint64_t id = NodeGetID(type, key);
+    return NodePropertiesSetFromJson(id, value);
+  }
+
+  std::map<std::string, std::any> Shard::NodePropertiesGet(uint64_t id) {
+    // If the node is valid
+    if (ValidNodeId(id)) {
+      uint64_t internal_id = externalToInternal(id);
+      return NodePropertyStore(internal_id).getProperties(node_property_rows.at(internal_id));
+    } else {
+      return tombstone_object;
+    }
+  }
+
+  bool Shard::NodePropertiesSet(uint64_t id, std::map<std::string, std::any> &value) {
+    // If the node is valid
+    if (ValidNodeId(id) && !NodeWritesBlocked(id) && PropertyKeysFit(value)) {
+      uint64_t internal_id = externalToInternal(id);
+      std::map<std::string, std::any> values = NodePropertyStore(internal_id).getProperties(node_property_rows.at(internal_id));
+      value.merge(values);
+      NodePreserve(internal_id);
+      UnindexNode(internal_id);
+      NodePropertyStore(internal_id).setProperties(node_property_rows.at(internal_id), value);
+      IndexNode(internal_id);
+      command_log.log(Command::NODE_PROPERTIES_RESET, id, value);
+      return true;
+    } else {
+      return false;
+    }
+  }
+
+  bool Shard::NodePropertiesSetFromJson(uint64_t id, const std::string &value) {
+    // If the node is valid
+    if (ValidNodeId(id) && !NodeWritesBlocked(id)) {
+      dom::object object;
+      if (!value.empty() && (parser.parse(value).get(object) || !PropertyKeysFit(object))) {
+        return false;
+      }
+
+      // Only the fields sent are written, over the values the node already has
+      uint64_t internal_id = externalToInternal(id);
+      Properties &store = NodePropertyStore(internal_id);
+      uint64_t row = node_property_rows.at(internal_id);
+      NodePreserve(internal_id);
+      UnindexNode(internal_id);
+      if (!value.empty()) {
+        setPropertiesFromJson(store, row, object);
+      }
+      IndexNode(internal_id);
+      command_log.log(Command::NODE_PROPERTIES_RESET, id, command_log.recording() ? store.getProperties(row) : std::map<std::string, std::any>());
+      return true;
+    } else {
+      return false;
+    }
+  }
+
+  bool Shard::NodePropertiesReset(const std::string &type, const std::string &key, const std::map<std::string, std::any> &value) {
     uint64_t id = NodeGetID(type, key);
-    return NodePropertySetFromJson(id, property, value);
+    return NodePropertiesReset(id, value);
+  }
+
+  bool Shard::NodePropertiesResetFromJson(const std::string &type, const std::string &key, const std::string &value) {
+    uint64_t id = NodeGetID(type, key);
+    return NodePropertiesResetFromJson(id, value);
+  }
+
+  bool Shard::NodePropertiesReset(uint64_t id, const std::map<std::string, std::any> &value) {
+    // If the node is valid
+    if (ValidNodeId(id) && !NodeWritesBlocked(id) && PropertyKeysFit(value)) {
+      uint64_t internal_id = externalToInternal(id);
+      NodePreserve(internal_id);
+      UnindexNode(internal_id);
+      NodePropertyStore(internal_id).setProperties(node_property_rows.at(internal_id), value);
+      IndexNode(internal_id);
+      command_log.log(Command::NODE_PROPERTIES_RESET, id, value);
+      return true;
+    } else {
+      return false;
+    }
+  }
+
+  bool Shard::NodePropertiesResetFromJson(uint64_t id, const std::string &value) {
+    // If the node is valid
+    if (ValidNodeId(id) && !NodeWritesBlocked(id)) {
+      dom::object object;
+      if (!value.empty() && (parser.parse(value).get(object) || !PropertyKeysFit(object))) {
+        return false;
+      }
+
+      uint64_t internal_id = externalToInternal(id);
+      Properties &store = NodePropertyStore(internal_id);
+      uint64_t row = node_property_rows.at(internal_id);
+      NodePreserve(internal_id);
+      UnindexNode(internal_id);
+      store.deleteProperties(row);
+      if (!value.empty()) {
+        setPropertiesFromJson(store, row, object);
+      }
+      IndexNode(internal_id);
+      command_log.log(Command::NODE_PROPERTIES_RESET, id, command_log.recording() ? store.getProperties(row) : std::map<std::string, std::any>());
+      return true;
+    } else {
+      return false;
+    }
+  }
+
+  bool Shard::NodePropertiesDelete(uint64_t id) {
+    // If the node is valid
+    if (ValidNodeId(id) && !NodeWritesBlocked(id)) {
+      uint64_t internal_id = externalToInternal(id);
+      NodePreserve(internal_id);
+      UnindexNode(internal_id);
+      NodePropertyStore(internal_id).deleteProperties(node_property_rows.at(internal_id));
+      command_log.log(Command::NODE_PROPERTIES_DELETE, id);
+      return true;
+    } else {
+      return false;
+    }
+  }
+
+  // Node Property Indexes
+  bool Shard::NodePropertyIndexCreate(const std::string &type, const std::string &property, PropertyIndex::IndexType index_type) {
+    uint16_t type_id = node_types.getTypeId(type);
+    if (type_id == 0) {
+      return false;
+    }
+    auto [index, inserted] = node_property_indexes[type_id].emplace(property, PropertyIndex(index_type));
+    if (!inserted) {
+      // Creating the same index again is fine, changing its kind needs a drop first
+      return index->second.getType() == index_type;
+    }
+    NodePropertyIndexBuild(type_id, property, index->second);
+    command_log.log(Command::NODE_PROPERTY_INDEX_CREATE, type, property, static_cast<uint8_t>(index_type));
+    return true;
+  }
+
+  bool Shard::NodePropertyIndexDrop(const std::string &type, const std::string &property) {
+    uint16_t type_id = node_types.getTypeId(type);
+    auto indexes = node_property_indexes.find(type_id);
+    if (indexes == std::end(node_property_indexes) || indexes->second.erase(property) == 0) {
+      return false;
+    }
+    if (indexes->second.empty()) {
+      node_property_indexes.erase(indexes);
+    }
+    command_log.log(Command::NODE_PROPERTY_INDEX_DROP, type, property);
+    return true;
+  }
+
+  std::map<std::string, PropertyIndex::IndexType> Shard::NodePropertyIndexesGet(const std::string &type) {
+    std::map<std::string, PropertyIndex::IndexType> index_types;
+    auto indexes = node_property_indexes.find(node_types.getTypeId(type));
+    if (indexes != std::end(node_property_indexes)) {
+      for (const auto &[property, index] : indexes->second) {
+        index_types.emplace(property, index.getType());
+      }
+    }
+    return index_types;
+  }
+
+  Roaring64Map Shard::NodePropertyIndexFind(const std::string &type, const std::string &property, const std::any &value) {
+    auto indexes = node_property_indexes.find(node_types.getTypeId(type));
+    if (indexes != std::end(node_property_indexes)) {
+      auto index = indexes->second.find(property);
+      if (index != std::end(indexes->second)) {
+        return index->second.find(value);
+      }
+    }
+    return Roaring64Map();
+  }
+
+  Roaring64Map Shard::NodePropertyIndexFindRange(const std::string &type, const std::string &property, const std::any &min, const std::any &max) {
+    auto indexes = node_property_indexes.find(node_types.getTypeId(type));
+    if (indexes != std::end(node_property_indexes)) {
+      auto index = indexes->second.find(property);
+      if (index != std::end(indexes->second)) {
+        return index->second.findRange(min, max);
+      }
+    }
+    return Roaring64Map();
+  }
+
+  // Node Property Aggregates
+  Aggregate Shard::NodesAggregate(const std::string &type, const std::vector<ScanFilter> &filters, const std::string &property) {
+    Aggregate aggregate;
+    uint16_t type_id = node_types.getTypeId(type);
+    auto store = node_properties.find(type_id);
+    if (type_id > 0 && store != std::end(node_properties)) {
+      store->second.scan(filters, property, aggregate);
+    }
+    return aggregate;
+  }
+
+  // Node Vectors
+  bool Shard::NodeVectorPropertyCreate(const std::string &type, const std::string &property, uint32_t dimensions) {
+    uint16_t type_id = node_types.getTypeId(type);
+    if (type_id == 0 || dimensions == 0 || !PropertyKeysFit(property)) {
+      return false;
+    }
+    Properties& store = NodeTypePropertyStore(type_id);
+    // Creating the same vectors again is fine, changing their size is not
+    if (store.getVectorDimensions(property) == dimensions) {
+      return true;
+    }
+    if (!store.addVectorColumn(property, dimensions)) {
+      return false;
+    }
+    command_log.log(Command::NODE_VECTOR_PROPERTY_CREATE, type, property, dimensions);
+    return true;
+  }
+
+  std::vector<Neighbor> Shard::NodesNearest(const std::string &type, const std::string &property, const std::vector<float> &query, uint64_t k,
+                                            VectorMetric metric, const std::vector<ScanFilter> &filters) {
+    uint16_t type_id = node_types.getTypeId(type);
+    auto store = node_properties.find(type_id);
+    if (type_id == 0 || store == std::end(node_properties)) {
+      return std::vector<Neighbor>();
+    }
+    NearestNeighbors neighbors(k);
+    store->second.nearest(property, query, metric, filters, neighbors);
+    std::vector<Neighbor> closest = neighbors.sorted();
+    if (closest.empty()) {
+      return closest;
+    }
+
+    // The store knows rows, only the rows of the closest few are turned back into node ids
+    std::unordered_map<uint64_t, size_t> positions;
+    for (size_t position = 0; position < closest.size(); position++) {
+      positions.emplace(closest[position].id, position);
+    }
+    size_t found = 0;
+    for (uint64_t id : node_types.getIds(type_id)) {
+      auto position = positions.find(node_property_rows.at(externalToInternal(id)));
+      if (position != std::end(positions)) {
+        closest[position->second].id = id;
+        if (++found == closest.size()) {
+          break;
+        }
+      }
+    }
+    return closest;
+  }
+
+  std::vector<Neighbor> Shard::NodesNearest(const Roaring64Map &ids, const std::string &property, const std::vector<float> &query, uint64_t k, VectorMetric metric) {
+    NearestNeighbors neighbors(k);
+    for (uint64_t id : ids) {
+      if (ValidNodeId(id)) {
+        uint64_t internal_id = externalToInternal(id);
+        double distance;
+        if (NodePropertyStore(internal_id).vectorDistance(node_property_rows.at(internal_id), property, query, metric, distance)) {
+          neighbors.add(id, distance);
+        }
+      }
+    }
+    return neighbors.sorted();
+  }
+
+  // Relationships
+  uint64_t Shard::RelationshipAddEmptySameShard(uint16_t rel_type, uint64_t id1, uint64_t id2) {
+    // Once stamped with the time it arrived the relationship is no longer empty
+    std::map<std::string, std::any> stamped;
+    if (RelationshipStamp(rel_type, std::map<std::string, std::any>(), stamped)) {
+      return RelationshipAddSameShard(rel_type, id1, id2, stamped);
+    }
+    uint64_t internal_id1 = externalToInternal(id1);
+    uint64_t internal_id2 = externalToInternal(id2);
+    uint64_t external_id = 0;
+
+    if (ValidNodeId(id1) && ValidNodeId(id2) && !NodeWritesBlocked(id1) && !NodeWritesBlocked(id2)) {
+      uint64_t internal_id = relationships.size();
+      // If we have deleted relationships, fill in the space by reusing the new relationship
+      if (!deleted_relationships.isEmpty()) {
+        internal_id = deleted_relationships.minimum();
+        external_id = internalToExternal(internal_id);
+        RelationshipPreserve(internal_id);
+        relationships.set(internal_id, rel_type, id1, id2);
+        deleted_relationships.remove(internal_id);
+      } else {
+        external_id = internalToExternal(internal_id);
+        relationships.set(internal_id, rel_type, id1, id2);
+      }
+
+      // Add the relationship to the outgoing node
+      NodeGroupsChanged(internal_id1);
+      auto group = findGroup(outgoing_relationships.at(internal_id1), rel_type);
+      // See if the relationship type is already there
+      if (group != std::end(outgoing_relationships.at(internal_id1))) {
+        group->ids.emplace_back(id2, external_id);
+      } else {
+        // otherwise create a new type with the ids
+        insertGroup(outgoing_relationships.at(internal_id1), Group(rel_type, {Ids(id2, external_id)}));
+      }
+
+      // Add the relationship to the incoming node
+      NodeGroupsChanged(internal_id2);
+      group = findGroup(incoming_relationships.at(internal_id2), rel_type);
+      // See if the relationship type is already there
+      if (group != std::end(incoming_relationships.at(internal_id2))) {
+        group->ids.emplace_back(id1, external_id);
+      } else {
+        // otherwise create a new type with the ids
+        insertGroup(incoming_relationships.at(internal_id2), Group(rel_type, {Ids(id1, external_id)}));
+      }
+
+      // Add relationship id to Types
+      relationship_types.addId(rel_type, external_id);
+      command_log.log(Command::RELATIONSHIP_ADD_SAME_SHARD, rel_type, id1, id2, std::map<std::string, std::any>(), external_id);
+
+      return external_id;
+    }
+    // Invalid node ids
+    return 0;
+  }
+
+  uint64_t Shard::RelationshipAddSameShard(uint16_t rel_type, uint64_t id1, uint64_t id2, const std::string& properties) {
+    std::map<std::string, std::any> values;
+    if (!properties.empty()) {
+      // Get the properties
+      simdjson::error_code error;
+
+      dom::object object;
+      error = Shard::parser.parse(properties).get(object);
+      if (!error) {
+        // Add the node properties
+        convertProperties(values, object);
+      } else {
+        return 0;
+      }
+    }
+
+    return RelationshipAddSameShard(rel_type, id1, id2, values);
+  }
+
+  uint64_t Shard::RelationshipAddSameShard(uint16_t rel_type, uint64_t id1, uint64_t id2, const std::map<std::string, std::any>& values) {
+    if (!PropertyKeysFit(values)) {
+      return 0;
+    }
+    // A stamping recency index of the type puts the time of arrival in the values, so it is logged and replayed with them
+    std::map<std::string, std::any> stamped;
+    if (RelationshipStamp(rel_type, values, stamped)) {
+      return RelationshipAddSameShard(rel_type, id1, id2, stamped);
+    }
+    uint64_t internal_id1 = externalToInternal(id1);
+    uint64_t internal_id2 = externalToInternal(id2);
+    uint64_t external_id = 0;
+
+    if (ValidNodeId(id1) && ValidNodeId(id2) && !NodeWritesBlocked(id1) && !NodeWritesBlocked(id2)) {
+      uint64_t internal_id = relationships.size();
+
+      // If we have deleted relationships, fill in the space by reusing the new relationship
+      if (!deleted_relationships.isEmpty()) {
+        internal_id = deleted_relationships.minimum();
+        external_id = internalToExternal(internal_id);
+        RelationshipPreserve(internal_id);
+        relationships.set(internal_id, rel_type, id1, id2, values);
+        deleted_relationships.remove(internal_id);
+      } else {
+        external_id = internalToExternal(internal_id);
+        relationships.set(internal_id, rel_type, id1, id2, values);
+      }
+
+      // Add the relationship to the outgoing node
+      NodeGroupsChanged(internal_id1);
+      auto group = findGroup(outgoing_relationships.at(internal_id1), rel_type);
+      // See if the relationship type is already there
+      if (group != std::end(outgoing_relationships.at(internal_id1))) {
+        group->ids.emplace_back(id2, external_id);
+      } else {
+        // otherwise create a new type with the ids
+        insertGroup(outgoing_relationships.at(internal_id1), Group(rel_type, {Ids(id2, external_id)}));
+      }
+
+      // Add the relationship to the incoming node
+      NodeGroupsChanged(internal_id2);
+      group = findGroup(incoming_relationships.at(internal_id2), rel_type);
+      // See if the relationship type is already there
+      if (group != std::end(incoming_relationships.at(internal_id2))) {
+        group->ids.emplace_back(id1, external_id);
+      } else {
+        // otherwise create a new type with the ids
+        insertGroup(incoming_relationships.at(internal_id2), Group(rel_type, {Ids(id1, external_id)}));
+      }
+
+      // Add relationship id to Types
+      relationship_types.addId(rel_type, external_id);
+      IndexRelationship(internal_id);
+      command_log.log(Command::RELATIONSHIP_ADD_SAME_SHARD, rel_type, id1, id2, values, external_id);
+
+      return external_id;
+    }
+    // Invalid node ids
+    return 0;
+  }
+
+  uint64_t Shard::RelationshipAddEmptySameShard(uint16_t rel_type, const std::string &type1, const std::string &key1, const std::string &type2, const std::string &key2) {
+    uint64_t id1 = NodeGetID(type1, key1);
+    uint64_t id2 = NodeGetID(type2, key2);
+
+    return RelationshipAddEmptySameShard(rel_type, id1, id2);
+  }
+
+  uint64_t Shard::RelationshipAddSameShard(uint16_t rel_type, const std::string &type1, const std::string &key1, const std::string &type2, const std::string &key2, const std::string& properties) {
+    uint64_t id1 = NodeGetID(type1, key1);
+    uint64_t id2 = NodeGetID(type2, key2);
+
+    return RelationshipAddSameShard(rel_type, id1, id2, properties);
+  }
+
+  uint64_t Shard::RelationshipAddEmptyToOutgoing(uint16_t rel_type, uint64_t id1, uint64_t id2) {
+    // Either end may be the node that is moving, the ending node is blocked on every shard too
+    if (NodeWritesBlocked(id1) || NodeWritesBlocked(id2)) {
+      return 0;
+    }
+    // Once stamped with the time it arrived the relationship is no longer empty
+    std::map<std::string, std::any> stamped;
+    if (RelationshipStamp(rel_type, std::map<std::string, std::any>(), stamped)) {
+      return RelationshipAddToOutgoing(rel_type, id1, id2, stamped);
+    }
+    uint64_t internal_id = relationships.size();
+    uint64_t external_id = 0;
+    // If we have deleted relationships, fill in the space by reusing the new relationship
+    if (!deleted_relationships.isEmpty()) {
+      internal_id = deleted_relationships.minimum();
+      external_id = internalToExternal(internal_id);
+      RelationshipPreserve(internal_id);
+      relationships.set(internal_id, rel_type, id1, id2);
+      deleted_relationships.remove(internal_id);
+    } else {
+      external_id = internalToExternal(internal_id);
+      relationships.set(internal_id, rel_type, id1, id2);
+    }
+
+    uint64_t internal_id1 = externalToInternal(id1);
+
+    // Add the relationship to the outgoing node
+    NodeGroupsChanged(internal_id1);
+    auto group = findGroup(outgoing_relationships.at(internal_id1), rel_type);
+    // See if the relationship type is already there
+    if (group != std::end(outgoing_relationships.at(internal_id1))) {
+      group->ids.emplace_back(id2, external_id);
+    } else {
+      // otherwise create a new type with the ids
+      insertGroup(outgoing_relationships.at(internal_id1), Group(rel_type, {Ids(id2, external_id)}));
+    }
+
+    // Add relationship id to Types
+    relationship_types.addId(rel_type, external_id);
+    command_log.log(Command::RELATIONSHIP_ADD_TO_OUTGOING, rel_type, id1, id2, std::map<std::string, std::any>(), external_id);
+
+    return external_id;
+  }
+
+  uint64_t Shard::RelationshipAddToOutgoing(uint16_t rel_type, uint64_t id1, uint64_t id2, const std::string& properties) {
+    std::map<std::string, std::any> values;
+    if (!properties.empty()) {
+      // Get the properties
+      simdjson::error_code error;
+
+      dom::object object;
+      error = Shard::parser.parse(properties).get(object);
+      if (!error) {
+        // Add the node properties
+        convertProperties(values, object);
+      } else {
+        return 0;
+      }
+    }
+
+    return RelationshipAddToOutgoing(rel_type, id1, id2, values);
   }
 
-  bool Shard::NodePropertySet(uint64_t id, const std::string &property, std::string value) {
-    // If the node is valid
-    if (ValidNodeId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      nodes.at(internal_id).setProperty(property, value);
-      return true;
+  uint64_t Shard::RelationshipAddToOutgoing(uint16_t rel_type, uint64_t id1, uint64_t id2, const std::map<std::string, std::any>& values) {
+    if (!PropertyKeysFit(values)) {
+      return 0;
+    }
+    // Either end may be the node that is moving, the ending node is blocked on every shard too
+    if (NodeWritesBlocked(id1) || NodeWritesBlocked(id2)) {
+      return 0;
+    }
+    // A stamping recency index of the type puts the time of arrival in the values, so it is logged and replayed with them
+    std::map<std::string, std::any> stamped;
+    if (RelationshipStamp(rel_type, values, stamped)) {
+      return RelationshipAddToOutgoing(rel_type, id1, id2, stamped);
+    }
+    uint64_t internal_id = relationships.size();
+    uint64_t external_id = 0;
+
+    // If we have deleted relationships, fill in the space by reusing the new relationship
+    if (!deleted_relationships.isEmpty()) {
+      internal_id = deleted_relationships.minimum();
+      external_id = internalToExternal(internal_id);
+      RelationshipPreserve(internal_id);
+      relationships.set(internal_id, rel_type, id1, id2, values);
+      deleted_relationships.remove(internal_id);
     } else {
-      return false;
+      external_id = internalToExternal(internal_id);
+      relationships.set(internal_id, rel_type, id1, id2, values);
+    }
+
+    uint64_t internal_id1 = externalToInternal(id1);
+
+    // Add the relationship to the outgoing node
+    NodeGroupsChanged(internal_id1);
+    auto group = findGroup(outgoing_relationships.at(internal_id1), rel_type);
+    // See if the relationship type is already there
+    if (group != std::end(outgoing_relationships.at(internal_id1))) {
+      group->ids.emplace_back(id2, external_id);
+    } else {
+      // otherwise create a new type with the ids
+      insertGroup(outgoing_relationships.at(internal_id1), Group(rel_type, {Ids(id2, external_id)}));
     }
+
+    // Add relationship id to Types
+    relationship_types.addId(rel_type, external_id);
+    IndexRelationship(internal_id);
+    command_log.log(Command::RELATIONSHIP_ADD_TO_OUTGOING, rel_type, id1, id2, values, external_id);
+
+    return external_id;
   }
 
-  bool Shard::NodePropertiesDelete(const std::string &type, const std::string &key) {
-    uint64_t id = NodeGetID(type, key);
-    return NodePropertiesDelete(id);
+  std::vector<uint64_t> Shard::RelationshipsAddToOutgoing(const std::vector<std::tuple<uint16_t, uint64_t, uint64_t, std::map<std::string, std::any>>>& rows) {
+    std::vector<uint64_t> ids;
+    ids.reserve(rows.size());
+    for (const auto &[rel_type, id1, id2, values] : rows) {
+      // The ending node lives on another shard, so only the starting node can be checked here
+      if (relationship_types.ValidTypeId(rel_type) && ValidNodeId(id1) && id2 > 0) {
+        ids.emplace_back(RelationshipAddToOutgoing(rel_type, id1, id2, values));
+      } else {
+        ids.emplace_back(0);
+      }
+    }
+
+    return ids;
   }
 
-  bool Shard::NodePropertySet(uint64_t id, const std::string &property, const char *value) {
-    // If the node is valid
-    if (ValidNodeId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      nodes.at(internal_id).setProperty(property, std::string(value));
-      return true;
+  uint64_t Shard::RelationshipAddToIncoming(uint16_t rel_type, uint64_t rel_id, uint64_t id1, uint64_t id2) {
+    command_log.log(Command::RELATIONSHIP_ADD_TO_INCOMING, rel_type, rel_id, id1, id2);
+    uint64_t internal_id2 = externalToInternal(id2);
+    // Add the relationship to the incoming node
+    NodeGroupsChanged(internal_id2);
+    auto group = findGroup(incoming_relationships.at(internal_id2), rel_type);
+    // See if the relationship type is already there
+    if (group != std::end(incoming_relationships.at(internal_id2))) {
+      group->ids.emplace_back(id1, rel_id);
     } else {
-      return false;
+      // otherwise create a new type with the ids
+      insertGroup(incoming_relationships.at(internal_id2), Group(rel_type, {Ids(id1, rel_id)}));
     }
+
+    return rel_id;
   }
 
-  bool Shard::NodePropertySet(uint64_t id, const std::string &property, int64_t value) {
-    // If the node is valid
-    if (ValidNodeId(id)) {
+  bool Shard::RelationshipsAddToIncoming(const std::vector<std::tuple<uint16_t, uint64_t, uint64_t, uint64_t>>& rows) {
+    bool valid = true;
+    for (const auto &[rel_type, rel_id, id1, id2] : rows) {
+      if (ValidNodeId(id2)) {
+        RelationshipAddToIncoming(rel_type, rel_id, id1, id2);
+      } else {
+        valid = false;
+      }
+    }
+
+    return valid;
+  }
+
+  Relationship Shard::RelationshipGet(uint64_t rel_id) {
+    if (ValidRelationshipId(rel_id)) {
+      uint64_t internal_id = externalToInternal(rel_id);
+      return RelationshipCopy(internal_id);
+    }       // Invalid Relationship
+    return Relationship();
+  }
+
+  bool Shard::ValidNodeId(uint64_t id) {
+    // Node must be greater than zero,
+    // less than maximum node id,
+    // belong to this shard
+    // and not deleted
+    return id > 0 && externalToInternal(id) < nodes.size() && internalToExternal(externalToInternal(id)) == id;
+  }
+
+  bool Shard::ValidRelationshipId(uint64_t id) {
+    // Relationship must be greater than zero,
+    // less than maximum relationship id,
+    // belong to this shard
+    // and not deleted
+    uint64_t internal_id = externalToInternal(id);
+    return id > 0 && externalToInternal(id) < relationships.size() && internalToExternal(externalToInternal(id)) == id;
+  }
+
+  std::string Shard::RelationshipGetType(uint64_t id) {
+    if (ValidRelationshipId(id)) {
       uint64_t internal_id = externalToInternal(id);
-      nodes.at(internal_id).setProperty(property, value);
-      return true;
-    } else {
-      return false;
+      return relationship_types.getType(relationships.getTypeId(internal_id));
     }
+    // Invalid Relationship Id
+    return relationship_types.getType(0);
   }
 
-  bool Shard::NodePropertySet(uint64_t id, const std::string &property, double value) {
-    // If the node is valid
-    if (ValidNodeId(id)) {
+  uint16_t Shard::RelationshipGetTypeId(uint64_t id) {
+    if (ValidRelationshipId(id)) {
       uint64_t internal_id = externalToInternal(id);
-      nodes.at(internal_id).setProperty(property, value);
-      return true;
-    } else {
-      return false;
+      return relationships.getTypeId(internal_id);
     }
+    // Invalid Relationship Id
+    return 0;
   }
 
-  bool Shard::NodePropertySet(uint64_t id, const std::string &property, bool value) {
-    // If the node is valid
-    if (ValidNodeId(id)) {
+  uint64_t Shard::RelationshipGetStartingNodeId(uint64_t id) {
+    if (ValidRelationshipId(id)) {
       uint64_t internal_id = externalToInternal(id);
-      nodes.at(internal_id).setProperty(property, value);
-      return true;
-    } else {
-      return false;
+      return relationships.getStartingNodeId(internal_id);
     }
+    // Invalid Relationship Id
+    return 0;
   }
 
-  bool Shard::NodePropertySet(uint64_t id, const std::string &property, std::map<std::string, std::any> value) {
-    // If the node is valid
-    if (ValidNodeId(id)) {
+  uint64_t Shard::RelationshipGetEndingNodeId(uint64_t id) {
+    if (ValidRelationshipId(id)) {
       uint64_t internal_id = externalToInternal(id);
-      nodes.at(internal_id).setProperty(property, value);
-      return true;
+      return relationships.getEndingNodeId(internal_id);
+    }
+    // Invalid Relationship Id
+    return 0;
+  }
+
+  uint64_t Shard::RelationshipGetID(uint64_t id1, uint64_t id2, uint16_t rel_type_id, Direction direction) {
+    if (ValidNodeId(id1)) {
+      uint64_t internal_id = externalToInternal(id1);
+      // Both sides of the relationships of id1 are here, and supernode lists can be searched instead of scanned
+      if (direction != IN) {
+        uint64_t rel_id = findRelationship(outgoing_relationships.at(internal_id), rel_type_id, id2);
+        if (rel_id > 0) {
+          return rel_id;
+        }
+      }
+      if (direction != OUT) {
+        return findRelationship(incoming_relationships.at(internal_id), rel_type_id, id2);
+      }
+    }
+    return 0;
+  }
+
+  std::vector<bool> Shard::RelationshipsExist(const std::vector<std::pair<uint64_t, uint64_t>>& pairs, uint16_t rel_type_id, Direction direction) {
+    std::vector<bool> exist;
+    exist.reserve(pairs.size());
+    for (const auto& [id1, id2] : pairs) {
+      exist.push_back(RelationshipGetID(id1, id2, rel_type_id, direction) > 0);
+    }
+    return exist;
+  }
+
+  std::pair<uint64_t, bool> Shard::RelationshipMergeToOutgoing(uint16_t rel_type_id, uint64_t id1, uint64_t id2, const std::string& properties) {
+    if (!ValidNodeId(id1)) {
+      return {0, false};
+    }
+    // Checking and adding without yielding means two merges of the same relationship cannot both add it
+    uint64_t rel_id = RelationshipGetID(id1, id2, rel_type_id, OUT);
+    if (rel_id > 0) {
+      return {rel_id, false};
+    }
+    if (CalculateShardId(id2) == shard_id) {
+      rel_id = RelationshipAddSameShard(rel_type_id, id1, id2, properties);
     } else {
-      return false;
+      rel_id = RelationshipAddToOutgoing(rel_type_id, id1, id2, properties);
     }
+    return {rel_id, rel_id > 0};
   }
 
-  bool Shard::NodePropertySetFromJson(uint64_t id, const std::string &property, const std::string &value) {
-    // If the node is valid
-    if (ValidNodeId(id)) {
-      std::map<std::string, std::any> values;
-      if (!value.empty()) {
-        // Get the properties
-        simdjson::error_code error;
+  std::pair <uint16_t, uint64_t> Shard::RelationshipRemoveGetIncoming(uint64_t internal_id) {
+    command_log.log(Command::RELATIONSHIP_REMOVE_GET_INCOMING, internal_id);
+    Relationship relationship = RelationshipCopy(internal_id, NodeProjection::KEY);
+    uint64_t id1 = relationship.getStartingNodeId();
+    uint64_t id2 = relationship.getEndingNodeId();
+    uint64_t external_id = relationship.getId();
+    uint16_t rel_type_id = relationship.getTypeId();
 
-        dom::object object;
-        error = parser.parse(value).get(object);
-        if (!error) {
-          // Add the node properties
-          convertProperties(values, object);
-        } else {
-          return false;
-        }
+    // Update the relationship type counts
+    relationship_types.removeId(relationship.getTypeId(), external_id);
+    uint64_t internal_id1 = externalToInternal(id1);
+
+    // Add to deleted relationships bitmap
+    deleted_relationships.add(internal_id);
+
+    // Remove relationship from Node 1
+    NodeGroupsChanged(internal_id1);
+    auto group = findGroup(outgoing_relationships.at(internal_id1), rel_type_id);
+    if (group != std::end(outgoing_relationships.at(internal_id1))) {
+      auto rel_to_delete = group->ids.find(Ids(id2, external_id));
+      if (rel_to_delete != std::end(group->ids)) {
+        group->ids.erase(rel_to_delete);
+      }
+    }
+
+    // Clear the relationship
+    RelationshipPreserve(internal_id);
+    UnindexRelationship(internal_id);
+    relationships.remove(internal_id);
+
+    // Return the rel_type and other node Id
+    return std::pair <uint16_t ,uint64_t> (rel_type_id, id2);
+  }
+
+  bool Shard::RelationshipRemoveIncoming(uint16_t rel_type_id, uint64_t external_id, uint64_t node_id) {
+    command_log.log(Command::RELATIONSHIP_REMOVE_INCOMING, rel_type_id, external_id, node_id);
+    // Remove relationship from Node 2
+    uint64_t internal_id2 = externalToInternal(node_id);
+
+    NodeGroupsChanged(internal_id2);
+    auto group = findGroup(incoming_relationships.at(internal_id2), rel_type_id);
+
+    // The other node is not known here, so this is a scan, segments keep the erase itself small
+    auto rel_to_delete = std::find_if(std::begin(group->ids), std::end(group->ids), [external_id](Ids entry) {
+           return entry.rel_id == external_id;
+    });
+    if (rel_to_delete != std::end(group->ids)) {
+      group->ids.erase(rel_to_delete);
+    }
+
+    return true;
+  }
+
+  // Relationship Properties
+  std::any Shard::RelationshipPropertyGet(uint64_t id, const std::string &property) {
+    // If the relationship is valid
+    if (ValidRelationshipId(id)) {
+      uint64_t internal_id = externalToInternal(id);
+      // Look for the property
+      return relationships.getProperty(internal_id, property);
+    }
+    // Invalid relationship id, property name or type
+    return tombstone_any;
+  }
+
+  std::string Shard::RelationshipPropertyGetString(uint64_t id, const std::string &property) {
+    if (ValidRelationshipId(id)) {
+      uint64_t internal_id = externalToInternal(id);
+      // Look for the property
+      std::any value = relationships.getProperty(internal_id, property);
+      if (value.type() == typeid(std::string) ) {
+        return std::any_cast<std::string>(value);
       }
+    }
+
+    // Invalid relationship id, property name, or type
+    return tombstone_string;
+  }
+
+  int64_t Shard::RelationshipPropertyGetInteger(uint64_t id, const std::string &property) {
+    if (ValidRelationshipId(id)) {
       uint64_t internal_id = externalToInternal(id);
-      nodes.at(internal_id).setProperty(property, values);
-      return true;
-    } else {
-      return false;
+      // Look for the property
+      std::any value = relationships.getProperty(internal_id, property);
+      if (value.type() == typeid(int64_t) ) {
+        return std::any_cast<int64_t>(value);
+      }
     }
+
+    // Invalid relationship id, property name, or type
+    return tombstone_int;
   }
 
-  bool Shard::NodePropertyDelete(const std::string &type, const std::string &key, const std::string &property) {
-    uint64_t id = NodeGetID(type, key);
-    return NodePropertyDelete(id, property);
+  double Shard::RelationshipPropertyGetDouble(uint64_t id, const std::string &property) {
+    if (ValidRelationshipId(id)) {
+      uint64_t internal_id = externalToInternal(id);
+      // Look for the property
+      std::any value = relationships.getProperty(internal_id, property);
+      if (value.type() == typeid(double) ) {
+        return std::any_cast<double>(value);
+      }
+    }
+
+    // Invalid relationship id, property name, or type
+    return tombstone_double;
   }
 
-  bool Shard::NodePropertyDelete(uint64_t id, const std::string &property) {
-    // If the node is valid
-    if (ValidNodeId(id)) {
+  bool Shard::RelationshipPropertyGetBoolean(uint64_t id, const std::string &property) {
+    if (ValidRelationshipId(id)) {
       uint64_t internal_id = externalToInternal(id);
-      return nodes.at(internal_id).deleteProperty(property);
-    } else {
-      return false;
+      // Look for the property
+      std::any value = relationships.getProperty(internal_id, property);
+      if (value.type() == typeid(bool) ) {
+        return std::any_cast<bool>(value);
+      }
     }
-  }
 
-  std::map<std::string, std::any> Shard::NodePropertiesGet(const std::string &type, const std::string &key) {
-    uint64_t id = NodeGetID(type, key);
-    return NodePropertiesGet(id);
+    // Invalid relationship id, property name, or type
+    return tombstone_boolean;
   }
 
-  bool Shard::NodePropertiesSet(const std::string &type, const std::string &key, std::map<std::string, std::any> &value) {
-    uint64_t id = NodeGetID(type, key);
-    return NodePropertiesSet(id, value);
-  }
+  std::map<std::string, std::any> Shard::RelationshipPropertyGetObject(uint64_t id, const std::string &property) {
+    if (ValidRelationshipId(id)) {
+      uint64_t internal_id = externalToInternal(id);
+      // Look for the property
+      std::any value = relationships.getProperty(internal_id, property);
+      if (value.type() == typeid(std::map<std::string, std::any>) ) {
+        return std::any_cast<std::map<std::string, std::any>>(value);
+      }
+    }
 
-  bool Shard::NodePropertiesSetFromJson(const std::string &type, const std::string &key, const std::string &value) {
-    uint64_t id = NodeGetID(type, key);
-    return NodePropertiesSetFromJson(id, value);
+    // Invalid relationship id, property name, or type
+    return tombstone_object;
   }
 
-  std::map<std::string, std::any> Shard::NodePropertiesGet(uint64_t id) {
-    // If the node is valid
-    if (ValidNodeId(id)) {
+  bool Shard::RelationshipPropertySet(uint64_t id, const std::string &property, std::string value) {
+    // If the relationship is valid
+    if (ValidRelationshipId(id) && PropertyKeysFit(property)) {
       uint64_t internal_id = externalToInternal(id);
-      return nodes.at(internal_id).getProperties();
-    } else {
-      return tombstone_object;
+      RelationshipPreserve(internal_id);
+      UnindexRelationship(internal_id);
+      relationships.setProperty(internal_id, property, value);
+      IndexRelationship(internal_id);
+      command_log.log(Command::RELATIONSHIP_PROPERTY_SET, id, property, std::any(value));
+      return true;
     }
+    // Invalid relationship id
+    return false;
   }
 
-  bool Shard::NodePropertiesSet(uint64_t id, std::map<std::string, std::any> &value) {
-    // If the node is valid
-    if (ValidNodeId(id)) {
+  bool Shard::RelationshipPropertySet(uint64_t id, const std::string &property, const char *value) {
+    // If the relationship is valid
+    if (ValidRelationshipId(id) && PropertyKeysFit(property)) {
       uint64_t internal_id = externalToInternal(id);
-      std::map<std::string, std::any> values = nodes.at(internal_id).getProperties();
-      value.merge(values);
-      nodes.at(internal_id).setProperties(value);
+      RelationshipPreserve(internal_id);
+      UnindexRelationship(internal_id);
+      relationships.setProperty(internal_id, property, std::string(value));
+      IndexRelationship(internal_id);
+      command_log.log(Command::RELATIONSHIP_PROPERTY_SET, id, property, std::any(std::string(value)));
       return true;
-    } else {
-      return false;
     }
+    // Invalid relationship id
+    return false;
   }
 
-  bool Shard::NodePropertiesSetFromJson(uint64_t id, const std::string &value) {
-    // If the node is valid
-    if (ValidNodeId(id)) {
+  bool Shard::RelationshipPropertySet(uint64_t id, const std::string &property, int64_t value) {
+    // If the relationship is valid
+    if (ValidRelationshipId(id) && PropertyKeysFit(property)) {
       uint64_t internal_id = externalToInternal(id);
-      std::map<std::string, std::any> values = nodes.at(internal_id).getProperties();
-      if (!value.empty()) {
-        // Get the properties
-        simdjson::error_code error;
-
-        dom::object object;
-        error = parser.parse(value).get(object);
-        if (!error) {
-          // Add the node properties
-          convertProperties(values, object);
-        } else {
-          return false;
-        }
-      }
-
-      nodes.at(internal_id).setProperties(values);
+      RelationshipPreserve(internal_id);
+      UnindexRelationship(internal_id);
+      relationships.setProperty(internal_id, property, value);
+      IndexRelationship(internal_id);
+      command_log.log(Command::RELATIONSHIP_PROPERTY_SET, id, property, std::any(value));
       return true;
-    } else {
-      return false;
     }
+    // Invalid relationship id
+    return false;
   }
 
-  bool Shard::NodePropertiesReset(const std::string &type, const std::string &key, const std::map<std::string, std::any> &value) {
-    uint64_t id = NodeGetID(type, key);
-    return NodePropertiesReset(id, value);
+  bool Shard::RelationshipPropertySet(uint64_t id, const std::string &property, double value) {
+    // If the relationship is valid
+    if (ValidRelationshipId(id) && PropertyKeysFit(property)) {
+      uint64_t internal_id = externalToInternal(id);
+      RelationshipPreserve(internal_id);
+      UnindexRelationship(internal_id);
+      relationships.setProperty(internal_id, property, value);
+      IndexRelationship(internal_id);
+      command_log.log(Command::RELATIONSHIP_PROPERTY_SET, id, property, std::any(value));
+      return true;
+    }
+    // Invalid relationship id
+    return false;
   }
 
-  bool Shard::NodePropertiesResetFromJson(const std::string &type, const std::string &key, const std::string &value) {
-    uint64_t id = NodeGetID(type, key);
-    return NodePropertiesResetFromJson(id, value);
+  bool Shard::RelationshipPropertySet(uint64_t id, const std::string &property, bool value) {
+    // If the relationship is valid
+    if (ValidRelationshipId(id) && PropertyKeysFit(property)) {
+      uint64_t internal_id = externalToInternal(id);
+      RelationshipPreserve(internal_id);
+      UnindexRelationship(internal_id);
+      relationships.setProperty(internal_id, property, value);
+      IndexRelationship(internal_id);
+      command_log.log(Command::RELATIONSHIP_PROPERTY_SET, id, property, std::any(value));
+      return true;
+    }
+    // Invalid relationship id
+    return false;
   }
 
-  bool Shard::NodePropertiesReset(uint64_t id, const std::map<std::string, std::any> &value) {
-    // If the node is valid
-    if (ValidNodeId(id)) {
+  bool Shard::RelationshipPropertySet(uint64_t id, const std::string &property, std::map<std::string, std::any> value) {
+    // If the relationship is valid
+    if (ValidRelationshipId(id) && PropertyKeysFit(property)) {
       uint64_t internal_id = externalToInternal(id);
-      nodes.at(internal_id).setProperties(value);
+      RelationshipPreserve(internal_id);
+      UnindexRelationship(internal_id);
+      relationships.setProperty(internal_id, property, value);
+      IndexRelationship(internal_id);
+      command_log.log(Command::RELATIONSHIP_PROPERTY_SET, id, property, std::any(value));
       return true;
-    } else {
-      return false;
     }
+    // Invalid relationship id
+    return false;
   }
 
-  bool Shard::NodePropertiesResetFromJson(uint64_t id, const std::string &value) {
-    // If the node is valid
-    if (ValidNodeId(id)) {
+  bool Shard::RelationshipPropertySetFromJson(uint64_t id, const std::string &property, const std::string &value) {
+    // If the relationship is valid
+    if (ValidRelationshipId(id) && PropertyKeysFit(property)) {
       std::map<std::string, std::any> values;
       if (!value.empty()) {
         // Get the properties
@@ -972,835 +3687,1022 @@ namespace triton {
         dom::object object;
         error = parser.parse(value).get(object);
         if (!error) {
-          // Add the node properties
+          // Add the relationship properties
           convertProperties(values, object);
         } else {
           return false;
         }
       }
       uint64_t internal_id = externalToInternal(id);
-      nodes.at(internal_id).setProperties(values);
+      RelationshipPreserve(internal_id);
+      UnindexRelationship(internal_id);
+      relationships.setProperty(internal_id, property, values);
+      IndexRelationship(internal_id);
+      command_log.log(Command::RELATIONSHIP_PROPERTY_SET, id, property, std::any(values));
       return true;
-    } else {
-      return false;
     }
+    // Invalid relationship id
+    return false;
   }
 
-  bool Shard::NodePropertiesDelete(uint64_t id) {
-    // If the node is valid
-    if (ValidNodeId(id)) {
+  bool Shard::RelationshipPropertyDelete(uint64_t id, const std::string &property) {
+    // If the relationship is valid
+    if (ValidRelationshipId(id)) {
       uint64_t internal_id = externalToInternal(id);
-      nodes.at(internal_id).deleteProperties();
-      return true;
-    } else {
-      return false;
+      command_log.log(Command::RELATIONSHIP_PROPERTY_DELETE, id, property);
+      RelationshipPreserve(internal_id);
+      UnindexRelationship(internal_id);
+      bool deleted = relationships.deleteProperty(internal_id, property);
+      IndexRelationship(internal_id);
+      return deleted;
     }
+    // Invalid relationship id
+    return false;
   }
 
-  // Relationships
-  uint64_t Shard::RelationshipAddEmptySameShard(uint16_t rel_type, uint64_t id1, uint64_t id2) {
-    uint64_t internal_id1 = externalToInternal(id1);
-    uint64_t internal_id2 = externalToInternal(id2);
-    uint64_t external_id = 0;
-
-    if (ValidNodeId(id1) && ValidNodeId(id2)) {
-      uint64_t internal_id = relationships.size();
-      // If we have deleted relationships, fill in the space by reusing the new relationship
-      if (!deleted_relationships.isEmpty()) {
-        internal_id = deleted_relationships.minimum();
-        external_id = internalToExternal(internal_id);
-        Relationship relationship = Relationship(external_id, id1, id2, rel_type);
-        relationships.at(internal_id) = relationship;
-        deleted_relationships.remove(internal_id);
-      } else {
-        external_id = internalToExternal(internal_id);
-        relationships.emplace_back(external_id, id1, id2, rel_type);
-      }
-
-      // Add the relationship to the outgoing node
-      auto group = find_if(std::begin(outgoing_relationships.at(internal_id1)), std::end(outgoing_relationships.at(internal_id1)),
-                           [rel_type] (const Group& g) { return g.rel_type_id == rel_type; } );
-      // See if the relationship type is already there
-      if (group != std::end(outgoing_relationships.at(internal_id1))) {
-        group->ids.emplace_back(id2, external_id);
-      } else {
-        // otherwise create a new type with the ids
-        outgoing_relationships.at(internal_id1).emplace_back(Group(rel_type, std::vector<triton::Ids>({Ids(id2, external_id)})));
-      }
-
-      // Add the relationship to the incoming node
-      group = find_if(std::begin(incoming_relationships.at(internal_id2)), std::end(incoming_relationships.at(internal_id2)),
-                      [rel_type] (const Group& g) { return g.rel_type_id == rel_type; } );
-      // See if the relationship type is already there
-      if (group != std::end(incoming_relationships.at(internal_id2))) {
-        group->ids.emplace_back(id1, external_id);
-      } else {
-        // otherwise create a new type with the ids
-        incoming_relationships.at(internal_id2).emplace_back(Group(rel_type, std::vector<triton::Ids>({Ids(id1, external_id)})));
-      }
-
-      // Add relationship id to Types
-      relationship_types.addId(rel_type, external_id);
-
-      return external_id;
+  std::map<std::string, std::any> Shard::RelationshipPropertiesGet(uint64_t id) {
+    // If the relationship is valid
+    if (ValidRelationshipId(id)) {
+      uint64_t internal_id = externalToInternal(id);
+      return relationships.getProperties(internal_id);
+    } else {
+      return tombstone_object;
     }
-    // Invalid node ids
-    return 0;
   }
 
-  uint64_t Shard::RelationshipAddSameShard(uint16_t rel_type, uint64_t id1, uint64_t id2, const std::string& properties) {
-    uint64_t internal_id1 = externalToInternal(id1);
-    uint64_t internal_id2 = externalToInternal(id2);
-    uint64_t external_id = 0;
-
-    if (ValidNodeId(id1) && ValidNodeId(id2)) {
-      uint64_t internal_id = relationships.size();
+  bool Shard::RelationshipPropertiesSet(uint64_t id, std::map<std::string, std::any> &value) {
+    // If the relationship is valid
+    if (ValidRelationshipId(id) && PropertyKeysFit(value)) {
+      uint64_t internal_id = externalToInternal(id);
+      std::map<std::string, std::any> values = relationships.getProperties(internal_id);
+      value.merge(values);
+      RelationshipPreserve(internal_id);
+      UnindexRelationship(internal_id);
+      relationships.setProperties(internal_id, value);
+      IndexRelationship(internal_id);
+      command_log.log(Command::RELATIONSHIP_PROPERTIES_RESET, id, value);
+      return true;
+    }
+    // Invalid relationship id
+    return false;
+  }
 
-      std::map<std::string, std::any> values;
-      if (!properties.empty()) {
+  bool Shard::RelationshipPropertiesSetFromJson(uint64_t id, const std::string &value) {
+    // If the relationship is valid
+    if (ValidRelationshipId(id)) {
+      uint64_t internal_id = externalToInternal(id);
+      std::map<std::string, std::any> values = relationships.getProperties(internal_id);
+      if (!value.empty()) {
         // Get the properties
         simdjson::error_code error;
 
         dom::object object;
-        error = Shard::parser.parse(properties).get(object);
+        error = parser.parse(value).get(object);
         if (!error) {
           // Add the node properties
           convertProperties(values, object);
         } else {
-          return 0;
+          return false;
         }
       }
-
-      // If we have deleted relationships, fill in the space by reusing the new relationship
-      if (!deleted_relationships.isEmpty()) {
-        internal_id = deleted_relationships.minimum();
-        external_id = internalToExternal(internal_id);
-        Relationship relationship = Relationship(external_id, id1, id2, rel_type, values);
-        relationships.at(internal_id) = relationship;
-        deleted_relationships.remove(internal_id);
-      } else {
-        external_id = internalToExternal(internal_id);
-        relationships.emplace_back(external_id, id1, id2, rel_type, values);
-      }
-
-      // Add the relationship to the outgoing node
-      auto group = find_if(std::begin(outgoing_relationships.at(internal_id1)), std::end(outgoing_relationships.at(internal_id1)),
-                           [rel_type] (const Group& g) { return g.rel_type_id == rel_type; } );
-      // See if the relationship type is already there
-      if (group != std::end(outgoing_relationships.at(internal_id1))) {
-        group->ids.emplace_back(id2, external_id);
-      } else {
-        // otherwise create a new type with the ids
-        outgoing_relationships.at(internal_id1).emplace_back(Group(rel_type, std::vector<triton::Ids>({Ids(id2, external_id)})));
-      }
-
-      // Add the relationship to the incoming node
-      group = find_if(std::begin(incoming_relationships.at(internal_id2)), std::end(incoming_relationships.at(internal_id2)),
-                      [rel_type] (const Group& g) { return g.rel_type_id == rel_type; } );
-      // See if the relationship type is already there
-      if (group != std::end(incoming_relationships.at(internal_id2))) {
-        group->ids.emplace_back(id1, external_id);
-      } else {
-        // otherwise create a new type with the ids
-        incoming_relationships.at(internal_id2).emplace_back(Group(rel_type, std::vector<triton::Ids>({Ids(id1, external_id)})));
+      if (!PropertyKeysFit(values)) {
+        return false;
       }
-
-      // Add relationship id to Types
-      relationship_types.addId(rel_type, external_id);
-
-      return external_id;
-    }
-    // Invalid node ids
-    return 0;
-  }
-
-  uint64_t Shard::RelationshipAddEmptySameShard(uint16_t rel_type, const std::string &type1, const std::string &key1, const std::string &type2, const std::string &key2) {
-    uint64_t id1 = NodeGetID(type1, key1);
-    uint64_t id2 = NodeGetID(type2, key2);
-
-    return RelationshipAddEmptySameShard(rel_type, id1, id2);
-  }
-
-  uint64_t Shard::RelationshipAddSameShard(uint16_t rel_type, const std::string &type1, const std::string &key1, const std::string &type2, const std::string &key2, const std::string& properties) {
-    uint64_t id1 = NodeGetID(type1, key1);
-    uint64_t id2 = NodeGetID(type2, key2);
-
-    return RelationshipAddSameShard(rel_type, id1, id2, properties);
-  }
-
-  uint64_t Shard::RelationshipAddEmptyToOutgoing(uint16_t rel_type, uint64_t id1, uint64_t id2) {
-    uint64_t internal_id = relationships.size();
-    uint64_t external_id = 0;
-    // If we have deleted relationships, fill in the space by reusing the new relationship
-    if (!deleted_relationships.isEmpty()) {
-      internal_id = deleted_relationships.minimum();
-      external_id = internalToExternal(internal_id);
-      Relationship relationship = Relationship(external_id, id1, id2, rel_type);
-      relationships.at(internal_id) = relationship;
-      deleted_relationships.remove(internal_id);
-    } else {
-      external_id = internalToExternal(internal_id);
-      relationships.emplace_back(external_id, id1, id2, rel_type);
-    }
-
-    uint64_t internal_id1 = externalToInternal(id1);
-
-    // Add the relationship to the outgoing node
-    auto group = find_if(std::begin(outgoing_relationships.at(internal_id1)), std::end(outgoing_relationships.at(internal_id1)),
-                         [rel_type] (const Group& g) { return g.rel_type_id == rel_type; } );
-    // See if the relationship type is already there
-    if (group != std::end(outgoing_relationships.at(internal_id1))) {
-      group->ids.emplace_back(id2, external_id);
+
+      RelationshipPreserve(internal_id);
+      UnindexRelationship(internal_id);
+      relationships.setProperties(internal_id, values);
+      IndexRelationship(internal_id);
+      command_log.log(Command::RELATIONSHIP_PROPERTIES_RESET, id, values);
+      return true;
     } else {
-      // otherwise create a new type with the ids
-      outgoing_relationships.at(internal_id1).emplace_back(Group(rel_type, std::vector<triton::Ids>({Ids(id2, external_id)})));
+      return false;
     }
-
-    // Add relationship id to Types
-    relationship_types.addId(rel_type, external_id);
-
-    return external_id;
   }
 
-  uint64_t Shard::RelationshipAddToOutgoing(uint16_t rel_type, uint64_t id1, uint64_t id2, const std::string& properties) {
-    uint64_t internal_id = relationships.size();
-    uint64_t external_id = 0;
+  bool Shard::RelationshipPropertiesReset(uint64_t id, const std::map<std::string, std::any> &value) {
+    // If the relationship is valid
+    if (ValidRelationshipId(id) && PropertyKeysFit(value)) {
+      uint64_t internal_id = externalToInternal(id);
+      RelationshipPreserve(internal_id);
+      UnindexRelationship(internal_id);
+      relationships.setProperties(internal_id, value);
+      IndexRelationship(internal_id);
+      command_log.log(Command::RELATIONSHIP_PROPERTIES_RESET, id, value);
+      return true;
+    }
+    // Invalid relationship id
+    return false;
+  }
 
-    std::map<std::string, std::any> values;
-    if (!properties.empty()) {
-      // Get the properties
-      simdjson::error_code error;
+  bool Shard::RelationshipPropertiesResetFromJson(uint64_t id, const std::string &value) {
+    // If the relationship is valid
+    if (ValidRelationshipId(id)) {
+      uint64_t internal_id = externalToInternal(id);
+      std::map<std::string, std::any> values;
+      if (!value.empty()) {
+        // Get the properties
+        simdjson::error_code error;
 
-      dom::object object;
-      error = Shard::parser.parse(properties).get(object);
-      if (!error) {
-        // Add the node properties
-        convertProperties(values, object);
-      } else {
-        return 0;
+        dom::object object;
+        error = parser.parse(value).get(object);
+        if (!error) {
+          // Add the node properties
+          convertProperties(values, object);
+        } else {
+          return false;
+        }
+      }
+      if (!PropertyKeysFit(values)) {
+        return false;
       }
-    }
 
-    // If we have deleted relationships, fill in the space by reusing the new relationship
-    if (!deleted_relationships.isEmpty()) {
-      internal_id = deleted_relationships.minimum();
-      external_id = internalToExternal(internal_id);
-      Relationship relationship = Relationship(external_id, id1, id2, rel_type, values);
-      relationships.at(internal_id) = relationship;
-      deleted_relationships.remove(internal_id);
+      RelationshipPreserve(internal_id);
+      UnindexRelationship(internal_id);
+      relationships.setProperties(internal_id, values);
+      IndexRelationship(internal_id);
+      command_log.log(Command::RELATIONSHIP_PROPERTIES_RESET, id, values);
+      return true;
     } else {
-      external_id = internalToExternal(internal_id);
-      relationships.emplace_back(external_id, id1, id2, rel_type, values);
+      return false;
     }
+  }
 
-    uint64_t internal_id1 = externalToInternal(id1);
+  bool Shard::RelationshipPropertiesDelete(uint64_t id) {
+    // If the relationship is valid
+    if (ValidRelationshipId(id)) {
+      uint64_t internal_id = externalToInternal(id);
+      RelationshipPreserve(internal_id);
+      UnindexRelationship(internal_id);
+      relationships.deleteProperties(internal_id);
+      IndexRelationship(internal_id);
+      command_log.log(Command::RELATIONSHIP_PROPERTIES_DELETE, id);
+      return true;
+    }
+    // Invalid relationship id
+    return false;
+  }
 
-    // Add the relationship to the outgoing node
-    auto group = find_if(std::begin(outgoing_relationships.at(internal_id1)), std::end(outgoing_relationships.at(internal_id1)),
-                         [rel_type] (const Group& g) { return g.rel_type_id == rel_type; } );
-    // See if the relationship type is already there
-    if (group != std::end(outgoing_relationships.at(internal_id1))) {
-      group->ids.emplace_back(id2, external_id);
-    } else {
-      // otherwise create a new type with the ids
-      outgoing_relationships.at(internal_id1).emplace_back(Group(rel_type, std::vector<triton::Ids>({Ids(id2, external_id)})));
+  // Relationship Recency Indexes
+  bool Shard::RelationshipRecencyIndexCreate(const std::string &rel_type, const std::string &property, bool stamp, uint64_t ttl) {
+    uint16_t type_id = relationship_types.getTypeId(rel_type);
+    if (type_id == 0 || property.empty()) {
+      return false;
     }
+    auto [index, inserted] = relationship_recency_indexes.emplace(type_id, RecencyIndex(property, stamp, ttl));
+    if (!inserted) {
+      // Creating the same index again is fine, changing it needs a drop first
+      return index->second.getProperty() == property && index->second.stamps() == stamp && index->second.getTtl() == ttl;
+    }
+    RelationshipRecencyIndexBuild(type_id);
+    command_log.log(Command::RELATIONSHIP_RECENCY_INDEX_CREATE, rel_type, property, static_cast<uint8_t>(stamp), ttl);
+    return true;
+  }
 
-    // Add relationship id to Types
-    relationship_types.addId(rel_type, external_id);
+  bool Shard::RelationshipRecencyIndexDrop(const std::string &rel_type) {
+    if (relationship_recency_indexes.erase(relationship_types.getTypeId(rel_type)) == 0) {
+      return false;
+    }
+    command_log.log(Command::RELATIONSHIP_RECENCY_INDEX_DROP, rel_type);
+    return true;
+  }
 
-    return external_id;
+  std::vector<Relationship> Shard::NodeGetRecentRelationships(const std::string &type, const std::string &key, const std::string &rel_type, int64_t since, int64_t until, uint64_t limit, NodeProjection projection) {
+    return NodeGetRecentRelationships(NodeGetID(type, key), rel_type, since, until, limit, projection);
   }
 
-  uint64_t Shard::RelationshipAddToIncoming(uint16_t rel_type, uint64_t rel_id, uint64_t id1, uint64_t id2) {
-    uint64_t internal_id2 = externalToInternal(id2);
-    // Add the relationship to the incoming node
-    auto group = find_if(std::begin(incoming_relationships.at(internal_id2)), std::end(incoming_relationships.at(internal_id2)),
-                    [rel_type] (const Group& g) { return g.rel_type_id == rel_type; } );
-    // See if the relationship type is already there
-    if (group != std::end(incoming_relationships.at(internal_id2))) {
-      group->ids.emplace_back(id1, rel_id);
-    } else {
-      // otherwise create a new type with the ids
-      incoming_relationships.at(internal_id2).emplace_back(Group(rel_type, std::vector<triton::Ids>({Ids(id1, rel_id)})));
+  std::vector<Relationship> Shard::NodeGetRecentRelationships(uint64_t id, const std::string &rel_type, int64_t since, int64_t until, uint64_t limit, NodeProjection projection) {
+    std::vector<Relationship> recent;
+    auto index = relationship_recency_indexes.find(relationship_types.getTypeId(rel_type));
+    if (!ValidNodeId(id) || index == std::end(relationship_recency_indexes)) {
+      return recent;
     }
+    // Outgoing relationships live on the shard of their starting node, so only the ones asked for are copied
+    std::vector<RecencyIndex::Entry> entries = index->second.newest(id, since, until, limit);
+    recent.reserve(entries.size());
+    for (const auto &entry : entries) {
+      recent.emplace_back(RelationshipCopy(entry.rel_id, projection));
+    }
+    return recent;
+  }
 
-    return rel_id;
+  std::vector<uint64_t> Shard::RelationshipsExpired(uint64_t limit) {
+    std::vector<uint64_t> expired;
+    int64_t now = RecencyIndex::now();
+    for (const auto &[type_id, index] : relationship_recency_indexes) {
+      if (index.getTtl() == 0 || expired.size() >= limit) {
+        continue;
+      }
+      // A ttl longer than the clock has run expires nothing
+      int64_t cutoff = index.getTtl() >= static_cast<uint64_t>(now) ? std::numeric_limits<int64_t>::min() : now - static_cast<int64_t>(index.getTtl());
+      for (const auto &entry : index.before(cutoff, limit - expired.size())) {
+        expired.emplace_back(internalToExternal(entry.rel_id));
+      }
+    }
+    return expired;
   }
 
-  Relationship Shard::RelationshipGet(uint64_t rel_id) {
-    if (ValidRelationshipId(rel_id)) {
-      uint64_t internal_id = externalToInternal(rel_id);
-      return relationships.at(internal_id);
-    }       // Invalid Relationship
-    return relationships.at(0);
+  // Node Degree
+  uint64_t Shard::NodeGetDegree(const std::string &type, const std::string &key) {
+    uint64_t id = NodeGetID(type, key);
+    return NodeGetDegree(id);
   }
 
-  bool Shard::ValidNodeId(uint64_t id) {
-    // Node must be greater than zero,
-    // less than maximum node id,
-    // belong to this shard
-    // and not deleted
-    return id > 0 && externalToInternal(id) < nodes.size() && internalToExternal(externalToInternal(id)) == id;
+  uint64_t Shard::NodeGetDegree(const std::string &type, const std::string &key, Direction direction) {
+    uint64_t id = NodeGetID(type, key);
+    return NodeGetDegree(id, direction);
   }
 
-  bool Shard::ValidRelationshipId(uint64_t id) {
-    // Relationship must be greater than zero,
-    // less than maximum relationship id,
-    // belong to this shard
-    // and not deleted
-    uint64_t internal_id = externalToInternal(id);
-    return id > 0 && externalToInternal(id) < relationships.size() && internalToExternal(externalToInternal(id)) == id;
+  uint64_t Shard::NodeGetDegree(const std::string &type, const std::string &key, Direction direction, const std::string &rel_type) {
+    uint64_t id = NodeGetID(type, key);
+    return NodeGetDegree(id, direction, rel_type);
   }
 
-  std::string Shard::RelationshipGetType(uint64_t id) {
-    if (ValidRelationshipId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      return relationship_types.getType(relationships.at(internal_id).getTypeId());
-    }
-    // Invalid Relationship Id
-    return relationship_types.getType(0);
+  uint64_t Shard::NodeGetDegree(const std::string &type, const std::string &key, Direction direction, const std::vector<std::string> &rel_types) {
+    uint64_t id = NodeGetID(type, key);
+    return NodeGetDegree(id, direction, rel_types);
   }
 
-  uint16_t Shard::RelationshipGetTypeId(uint64_t id) {
-    if (ValidRelationshipId(id)) {
+  uint64_t Shard::NodeGetDegree(uint64_t id) {
+    return NodeGetDegree(id, BOTH);
+  }
+
+  uint64_t Shard::NodeGetDegree(uint64_t id, Direction direction) {
+    if (ValidNodeId(id)) {
       uint64_t internal_id = externalToInternal(id);
-      return relationships.at(internal_id).getTypeId();
+      return NodeCountIds(internal_id, direction);
     }
-    // Invalid Relationship Id
+
     return 0;
   }
 
-  uint64_t Shard::RelationshipGetStartingNodeId(uint64_t id) {
-    if (ValidRelationshipId(id)) {
+  uint64_t Shard::NodeGetDegree(uint64_t id, Direction direction, const std::string &rel_type) {
+    if (ValidNodeId(id)) {
       uint64_t internal_id = externalToInternal(id);
-      return relationships.at(internal_id).getStartingNodeId();
+      uint16_t type_id = relationship_types.getTypeId(rel_type);
+      if (type_id > 0) {
+        return NodeCountIds(internal_id, direction, type_id);
+      }
     }
-    // Invalid Relationship Id
+
     return 0;
   }
 
-  uint64_t Shard::RelationshipGetEndingNodeId(uint64_t id) {
-    if (ValidRelationshipId(id)) {
+  uint64_t Shard::NodeGetDegree(uint64_t id, Direction direction, const std::vector<std::string> &rel_types) {
+    if (ValidNodeId(id)) {
       uint64_t internal_id = externalToInternal(id);
-      return relationships.at(internal_id).getEndingNodeId();
+      uint64_t count = 0;
+      // For each requested type sum up the values
+      for (const auto &rel_type : rel_types) {
+        uint16_t type_id = relationship_types.getTypeId(rel_type);
+        if (type_id > 0) {
+          count += NodeCountIds(internal_id, direction, type_id);
+        }
+      }
+      return count;
     }
-    // Invalid Relationship Id
+
     return 0;
   }
 
-  std::pair <uint16_t, uint64_t> Shard::RelationshipRemoveGetIncoming(uint64_t internal_id) {
-    Relationship relationship = relationships.at(internal_id);
-    uint64_t id1 = relationship.getStartingNodeId();
-    uint64_t id2 = relationship.getEndingNodeId();
-    uint64_t external_id = relationship.getId();
-    uint16_t rel_type_id = relationship.getTypeId();
+  // Traversing
+  std::vector<Ids> Shard::NodeGetRelationshipsIDs(const std::string &type, const std::string &key) {
+    uint64_t id = NodeGetID(type, key);
+    return NodeGetRelationshipsIDs(id);
+  }
 
-    // Update the relationship type counts
-    relationship_types.removeId(relationship.getTypeId(), external_id);
-    uint64_t internal_id1 = externalToInternal(id1);
+  std::vector<Ids> Shard::NodeGetRelationshipsIDs(const std::string &type, const std::string &key, Direction direction) {
+    uint64_t id = NodeGetID(type, key);
+    return NodeGetRelationshipsIDs(id, direction);
+  }
 
-    // Add to deleted relationships bitmap
-    deleted_relationships.add(internal_id);
+  std::vector<Ids> Shard::NodeGetRelationshipsIDs(const std::string &type, const std::string &key, Direction direction, const std::string &rel_type) {
+    uint64_t id = NodeGetID(type, key);
+    return NodeGetRelationshipsIDs(id, direction, rel_type);
+  }
 
-    // Remove relationship from Node 1
-    auto group = find_if(std::begin(outgoing_relationships.at(internal_id1)), std::end(outgoing_relationships.at(internal_id1)),
-                         [rel_type_id] (const Group& g) { return g.rel_type_id == rel_type_id; } );
-    if (group != std::end(outgoing_relationships.at(internal_id1))) {
-      auto rel_to_delete = find_if(std::begin(group->ids), std::end(group->ids), [external_id](Ids entry) {
-             return entry.rel_id == external_id;
-      });
-      if (rel_to_delete != std::end(group->ids)) {
-        group->ids.erase(rel_to_delete);
+  std::vector<Ids> Shard::NodeGetRelationshipsIDs(const std::string &type, const std::string &key, Direction direction, uint16_t type_id) {
+    uint64_t id = NodeGetID(type, key);
+    return NodeGetRelationshipsIDs(id, direction, type_id);
+  }
+
+  std::vector<Ids> Shard::NodeGetRelationshipsIDs(const std::string &type, const std::string &key, Direction direction, const std::vector<std::string> &rel_types) {
+    uint64_t id = NodeGetID(type, key);
+    return NodeGetRelationshipsIDs(id, direction, rel_types);
+  }
+
+  std::vector<Ids> Shard::NodeGetRelationshipsIDs(uint64_t id) {
+    if (ValidNodeId(id)) {
+      uint64_t internal_id = externalToInternal(id);
+      std::vector<Ids> ids;
+      for (const auto &[type, list] : outgoing_relationships.at(internal_id)) {
+        std::copy(std::begin(list), std::end(list), std::back_inserter(ids));
+      }
+      for (const auto &[type, list] : incoming_relationships.at(internal_id)) {
+        std::copy(std::begin(list), std::end(list), std::back_inserter(ids));
       }
+      return ids;
     }
+    return std::vector<Ids>();
+  }
 
-    // Clear the relationship
-    relationships.at(internal_id) = Relationship();
-
-    // Return the rel_type and other node Id
-    return std::pair <uint16_t ,uint64_t> (rel_type_id, id2);
+  std::vector<Node> Shard::NodesGet(const std::vector<uint64_t>& node_ids) {
+    return NodesGet(node_ids, NodeProjection::FULL);
   }
 
-  bool Shard::RelationshipRemoveIncoming(uint16_t rel_type_id, uint64_t external_id, uint64_t node_id) {
-    // Remove relationship from Node 2
-    uint64_t internal_id2 = externalToInternal(node_id);
+  std::vector<Node> Shard::NodesGet(const std::vector<uint64_t>& node_ids, NodeProjection projection) {
+    std::vector<Node> sharded_nodes;
+    sharded_nodes.reserve(node_ids.size());
 
-    auto group = find_if(std::begin(incoming_relationships.at(internal_id2)), std::end(incoming_relationships.at(internal_id2)),
-                         [rel_type_id] (const Group& g) { return g.rel_type_id == rel_type_id; } );
+    for(uint64_t id : node_ids) {
+      // Invalid ids get the empty node at zero so the results line up with the request
+      uint64_t internal_id = ValidNodeId(id) ? externalToInternal(id) : 0;
+      if (projection == NodeProjection::KEY) {
+        // The stored node has no properties, so this only copies the key
+        sharded_nodes.push_back(nodes.at(internal_id));
+      } else {
+        sharded_nodes.push_back(NodeCopy(internal_id));
+      }
+    }
 
-    auto rel_to_delete = find_if(std::begin(group->ids), std::end(group->ids), [external_id](Ids entry) {
-           return entry.rel_id == external_id;
-    });
-    if (rel_to_delete != std::end(group->ids)) {
-      group->ids.erase(rel_to_delete);
+    return sharded_nodes;
+  }
+
+  std::vector<Node> Shard::NodesGet(const std::vector<std::pair<std::string, std::string>>& type_keys, NodeProjection projection) {
+    std::vector<uint64_t> node_ids;
+    node_ids.reserve(type_keys.size());
+
+    for(const auto& [type, key] : type_keys) {
+      node_ids.push_back(NodeGetID(type, key));
     }
 
-    return true;
+    return NodesGet(node_ids, projection);
   }
 
-  // Relationship Properties
-  std::any Shard::RelationshipPropertyGet(uint64_t id, const std::string &property) {
-    // If the relationship is valid
-    if (ValidRelationshipId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      // Look for the property
-      return relationships.at(internal_id).getProperty(property);
+  std::vector<Relationship> Shard::RelationshipsGet(const std::vector<uint64_t>& rel_ids) {
+    return RelationshipsGet(rel_ids, NodeProjection::FULL);
+  }
+
+  std::vector<Relationship> Shard::RelationshipsGet(const std::vector<uint64_t>& rel_ids, NodeProjection projection) {
+    std::vector<Relationship> sharded_relationships;
+    sharded_relationships.reserve(rel_ids.size());
+
+    for(uint64_t id : rel_ids) {
+      uint64_t internal_id = ValidRelationshipId(id) ? externalToInternal(id) : 0;
+      sharded_relationships.push_back(RelationshipCopy(internal_id, projection));
     }
-    // Invalid relationship id, property name or type
-    return tombstone_any;
+
+    return sharded_relationships;
   }
 
-  std::string Shard::RelationshipPropertyGetString(uint64_t id, const std::string &property) {
-    if (ValidRelationshipId(id)) {
+  std::vector<Node> Shard::NodesGet(const std::vector<uint64_t>& node_ids, uint16_t node_type_id, const std::vector<ScanFilter>& filters, uint64_t limit, NodeProjection projection) {
+    std::vector<Node> sharded_nodes;
+
+    for (uint64_t id : node_ids) {
+      if (sharded_nodes.size() >= limit) {
+        break;
+      }
+      if (!ValidNodeId(id)) {
+        continue;
+      }
       uint64_t internal_id = externalToInternal(id);
-      // Look for the property
-      std::any value = relationships.at(internal_id).getProperty(property);
-      if (value.type() == typeid(std::string) ) {
-        return std::any_cast<std::string>(value);
+      // The type and the filters are checked before anything is copied
+      if (node_type_id > 0 && nodes.at(internal_id).getTypeId() != node_type_id) {
+        continue;
+      }
+      if (!filters.empty() && !NodePropertyStore(internal_id).matches(node_property_rows.at(internal_id), filters)) {
+        continue;
+      }
+      if (projection == NodeProjection::KEY) {
+        sharded_nodes.push_back(nodes.at(internal_id));
+      } else {
+        sharded_nodes.push_back(NodeCopy(internal_id));
       }
     }
 
-    // Invalid relationship id, property name, or type
-    return tombstone_string;
+    return sharded_nodes;
   }
 
-  int64_t Shard::RelationshipPropertyGetInteger(uint64_t id, const std::string &property) {
-    if (ValidRelationshipId(id)) {
+  std::vector<Relationship> Shard::RelationshipsGet(const std::vector<uint64_t>& rel_ids, const std::vector<ScanFilter>& filters, uint64_t limit, NodeProjection projection) {
+    std::vector<Relationship> sharded_relationships;
+
+    for (uint64_t id : rel_ids) {
+      if (sharded_relationships.size() >= limit) {
+        break;
+      }
+      if (!ValidRelationshipId(id)) {
+        continue;
+      }
       uint64_t internal_id = externalToInternal(id);
-      // Look for the property
-      std::any value = relationships.at(internal_id).getProperty(property);
-      if (value.type() == typeid(int64_t) ) {
-        return std::any_cast<int64_t>(value);
+      // The filters read the property columns, only a match is copied
+      bool matched = std::all_of(filters.begin(), filters.end(), [this, internal_id] (const ScanFilter& filter) {
+        return filter.matches(relationships.getProperty(internal_id, filter.property));
+      });
+      if (matched) {
+        sharded_relationships.push_back(RelationshipCopy(internal_id, projection));
       }
     }
 
-    // Invalid relationship id, property name, or type
-    return tombstone_int;
+    return sharded_relationships;
   }
 
-  double Shard::RelationshipPropertyGetDouble(uint64_t id, const std::string &property) {
-    if (ValidRelationshipId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      // Look for the property
-      std::any value = relationships.at(internal_id).getProperty(property);
-      if (value.type() == typeid(double) ) {
-        return std::any_cast<double>(value);
-      }
+  std::vector<uint64_t> Shard::NodesGetDegree(const std::vector<uint64_t>& ids, Direction direction, const std::vector<std::string>& rel_types) {
+    std::vector<uint64_t> degrees;
+    degrees.reserve(ids.size());
+
+    for(uint64_t id : ids) {
+      degrees.push_back(rel_types.empty() ? NodeGetDegree(id, direction) : NodeGetDegree(id, direction, rel_types));
     }
 
-    // Invalid relationship id, property name, or type
-    return tombstone_double;
+    return degrees;
   }
 
-  bool Shard::RelationshipPropertyGetBoolean(uint64_t id, const std::string &property) {
-    if (ValidRelationshipId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      // Look for the property
-      std::any value = relationships.at(internal_id).getProperty(property);
-      if (value.type() == typeid(bool) ) {
-        return std::any_cast<bool>(value);
-      }
+  std::vector<std::any> Shard::NodesGetProperty(const std::vector<uint64_t>& ids, const std::string& property) {
+    std::vector<std::any> values;
+    values.reserve(ids.size());
+
+    for(uint64_t id : ids) {
+      values.push_back(NodePropertyGet(id, property));
     }
 
-    // Invalid relationship id, property name, or type
-    return tombstone_boolean;
+    return values;
   }
 
-  std::map<std::string, std::any> Shard::RelationshipPropertyGetObject(uint64_t id, const std::string &property) {
-    if (ValidRelationshipId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      // Look for the property
-      std::any value = relationships.at(internal_id).getProperty(property);
-      if (value.type() == typeid(std::map<std::string, std::any>) ) {
-        return std::any_cast<std::map<std::string, std::any>>(value);
+  std::vector<int64_t> Shard::NodesGetIntegerProperty(const std::vector<uint64_t>& ids, const std::string& property, int64_t missing) {
+    return NodesGetTypedProperty(ids, missing, [&property] (const Properties& store, uint64_t row, int64_t& value) {
+      store.getIntegerProperty(row, property, value);
+    });
+  }
+
+  std::vector<double> Shard::NodesGetDoubleProperty(const std::vector<uint64_t>& ids, const std::string& property, double missing) {
+    return NodesGetTypedProperty(ids, missing, [&property] (const Properties& store, uint64_t row, double& value) {
+      int64_t integer;
+      if (!store.getDoubleProperty(row, property, value) && store.getIntegerProperty(row, property, integer)) {
+        value = static_cast<double>(integer);
       }
-    }
+    });
+  }
 
-    // Invalid relationship id, property name, or type
-    return tombstone_object;
+  std::vector<std::string> Shard::NodesGetStringProperty(const std::vector<uint64_t>& ids, const std::string& property, const std::string& missing) {
+    return NodesGetTypedProperty(ids, missing, [&property] (const Properties& store, uint64_t row, std::string& value) {
+      store.getStringProperty(row, property, value);
+    });
   }
 
-  bool Shard::RelationshipPropertySet(uint64_t id, const std::string &property, std::string value) {
-    // If the relationship is valid
-    if (ValidRelationshipId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      relationships.at(internal_id).setProperty(property, value);
-      return true;
+  // Traversals
+
+  void Shard::TraverseReceive(uint64_t traversal_id, size_t hop, uint16_t node_type_id, TraverseDedup dedup, const std::vector<uint64_t>& ids) {
+    Traversal& traversal = traversals[traversal_id];
+    if (traversal.frontiers.size() <= hop) {
+      traversal.frontiers.resize(hop + 1);
     }
-    // Invalid relationship id
-    return false;
-  }
+    Roaring64Map& frontier = traversal.frontiers.at(hop);
 
-  bool Shard::RelationshipPropertySet(uint64_t id, const std::string &property, const char *value) {
-    // If the relationship is valid
-    if (ValidRelationshipId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      relationships.at(internal_id).setProperty(property, std::string(value));
-      return true;
+    for (uint64_t id : ids) {
+      if (!ValidNodeId(id)) {
+        continue;
+      }
+      // Deleted nodes are left as the zero node
+      const Node& node = nodes.at(externalToInternal(id));
+      if (node.getId() == 0 || (node_type_id > 0 && node.getTypeId() != node_type_id)) {
+        continue;
+      }
+      if (dedup == TraverseDedup::GLOBAL) {
+        if (traversal.visited.contains(id)) {
+          continue;
+        }
+        traversal.visited.add(id);
+      }
+      frontier.add(id);
     }
-    // Invalid relationship id
-    return false;
   }
 
-  bool Shard::RelationshipPropertySet(uint64_t id, const std::string &property, int64_t value) {
-    // If the relationship is valid
-    if (ValidRelationshipId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      relationships.at(internal_id).setProperty(property, value);
-      return true;
+  seastar::future<uint64_t> Shard::TraverseExpand(uint64_t traversal_id, size_t hop, const TraverseStep& step, TraverseDedup dedup) {
+    auto traversal = traversals.find(traversal_id);
+    if (traversal == std::end(traversals) || traversal->second.frontiers.size() <= hop) {
+      return seastar::make_ready_future<uint64_t>(0);
     }
-    // Invalid relationship id
-    return false;
-  }
+    // This hop is done once it is expanded
+    Roaring64Map frontier = std::move(traversal->second.frontiers.at(hop));
 
-  bool Shard::RelationshipPropertySet(uint64_t id, const std::string &property, double value) {
-    // If the relationship is valid
-    if (ValidRelationshipId(id)) {
+    std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids;
+    auto add_node = [&sharded_nodes_ids] (const Ids& ids) {
+      sharded_nodes_ids[CalculateShardId(ids.node_id)].push_back(ids.node_id);
+    };
+    for (uint64_t id : frontier) {
       uint64_t internal_id = externalToInternal(id);
-      relationships.at(internal_id).setProperty(property, value);
-      return true;
+      if (step.rel_type_ids.empty()) {
+        NodeVisitIds(internal_id, step.direction, add_node);
+      } else {
+        for (uint16_t type_id : step.rel_type_ids) {
+          NodeVisitIds(internal_id, step.direction, type_id, add_node);
+        }
+      }
     }
-    // Invalid relationship id
-    return false;
+
+    // Send each node straight to the shard that owns it for the next hop
+    uint64_t count = 0;
+    std::vector<seastar::future<>> futures;
+    for (auto& [their_shard, grouped_node_ids] : sharded_nodes_ids) {
+      std::sort(std::begin(grouped_node_ids), std::end(grouped_node_ids));
+      grouped_node_ids.erase(std::unique(std::begin(grouped_node_ids), std::end(grouped_node_ids)), std::end(grouped_node_ids));
+      count += grouped_node_ids.size();
+      auto future = PeerOn("TraverseExpand", their_shard, [traversal_id, hop, node_type_id = step.node_type_id, dedup, grouped_node_ids = std::move(grouped_node_ids)] (Shard &local_shard) {
+             local_shard.TraverseReceive(traversal_id, hop + 1, node_type_id, dedup, grouped_node_ids);
+      });
+      futures.push_back(std::move(future));
+    }
+
+    auto p = make_shared(std::move(futures));
+    return seastar::when_all_succeed(p->begin(), p->end()).then([count] () {
+           return count;
+    });
   }
 
-  bool Shard::RelationshipPropertySet(uint64_t id, const std::string &property, bool value) {
-    // If the relationship is valid
-    if (ValidRelationshipId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      relationships.at(internal_id).setProperty(property, value);
-      return true;
+  std::vector<Node> Shard::TraverseCollect(uint64_t traversal_id, size_t hop) {
+    std::vector<Node> found_nodes;
+    auto traversal = traversals.find(traversal_id);
+    if (traversal == std::end(traversals)) {
+      return found_nodes;
     }
-    // Invalid relationship id
-    return false;
+    if (hop < traversal->second.frontiers.size()) {
+      const Roaring64Map& frontier = traversal->second.frontiers.at(hop);
+      found_nodes.reserve(frontier.cardinality());
+      for (uint64_t id : frontier) {
+        found_nodes.push_back(NodeCopy(externalToInternal(id)));
+      }
+    }
+    traversals.erase(traversal);
+    return found_nodes;
   }
 
-  bool Shard::RelationshipPropertySet(uint64_t id, const std::string &property, std::map<std::string, std::any> value) {
-    // If the relationship is valid
-    if (ValidRelationshipId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      relationships.at(internal_id).setProperty(property, value);
-      return true;
+  TraverseStep Shard::TraverseStepFor(std::string_view direction, const std::vector<std::string>& rel_types, const std::string& node_type) {
+    std::vector<uint16_t> rel_type_ids;
+    for (const auto& rel_type : rel_types) {
+      // An unknown relationship type matches nothing, rather than everything like an empty list
+      rel_type_ids.push_back(relationship_types.getTypeId(rel_type));
     }
-    // Invalid relationship id
-    return false;
+    uint16_t node_type_id = node_type.empty() ? 0 : node_types.getTypeId(node_type);
+    if (!node_type.empty() && node_type_id == 0) {
+      // Nothing has an unknown node type, so keep no nodes at all
+      node_type_id = std::numeric_limits<uint16_t>::max();
+    }
+    if (direction == "in") {
+      return TraverseStep(IN, rel_type_ids, node_type_id);
+    }
+    if (direction == "out") {
+      return TraverseStep(OUT, rel_type_ids, node_type_id);
+    }
+    return TraverseStep(BOTH, rel_type_ids, node_type_id);
   }
 
-  bool Shard::RelationshipPropertySetFromJson(uint64_t id, const std::string &property, const std::string &value) {
-    // If the relationship is valid
-    if (ValidRelationshipId(id)) {
-      std::map<std::string, std::any> values;
-      if (!value.empty()) {
-        // Get the properties
-        simdjson::error_code error;
+  // Sampling
 
-        dom::object object;
-        error = parser.parse(value).get(object);
-        if (!error) {
-          // Add the relationship properties
-          convertProperties(values, object);
-        } else {
-          return false;
-        }
-      }
-      uint64_t internal_id = externalToInternal(id);
-      relationships.at(internal_id).setProperty(property, values);
-      return true;
-    }
-    // Invalid relationship id
-    return false;
+  // Random numbers that only depend on the seed and what they are drawn for, so a seeded walk or sample comes out the same
+  // whichever shard draws them and in whatever order the shards answer
+  static uint64_t SplitMix(uint64_t value) {
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27U)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31U);
   }
 
-  bool Shard::RelationshipPropertyDelete(uint64_t id, const std::string &property) {
-    // If the relationship is valid
-    if (ValidRelationshipId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      return relationships.at(internal_id).deleteProperty(property);
-    }
-    // Invalid relationship id
-    return false;
+  static uint64_t RandomKey(uint64_t seed, uint64_t what, uint64_t step) {
+    return SplitMix(SplitMix(seed ^ SplitMix(what)) ^ step);
   }
 
-  std::map<std::string, std::any> Shard::RelationshipPropertiesGet(uint64_t id) {
-    // If the relationship is valid
-    if (ValidRelationshipId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      return relationships.at(internal_id).getProperties();
-    } else {
-      return tombstone_object;
+  // The draw-th number of a key scaled below bound, without the bias of a modulo
+  static uint64_t RandomBelow(uint64_t key, uint64_t draw, uint64_t bound) {
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(SplitMix(key + draw)) * bound) >> 64U);
+  }
+
+  static double RandomUnit(uint64_t key) {
+    return static_cast<double>(SplitMix(key) >> 11U) * 0x1.0p-53;
+  }
+
+  // Requests without a seed get a new one every time
+  static uint64_t RandomSeed(uint64_t seed) {
+    if (seed == 0) {
+      std::random_device device;
+      seed = (static_cast<uint64_t>(device()) << 32U) | device();
     }
+    return seed;
   }
 
-  bool Shard::RelationshipPropertiesSet(uint64_t id, std::map<std::string, std::any> &value) {
-    // If the relationship is valid
-    if (ValidRelationshipId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      std::map<std::string, std::any> values = relationships.at(internal_id).getProperties();
-      value.merge(values);
-      relationships.at(internal_id).setProperties(value);
-      return true;
+  void Shard::NodeNeighborIds(uint64_t internal_id, Direction direction, const std::vector<uint16_t>& rel_type_ids, std::vector<uint64_t>& neighbors) {
+    neighbors.clear();
+    auto add_neighbor = [&neighbors] (const Ids& ids) {
+      neighbors.push_back(ids.node_id);
+    };
+    if (rel_type_ids.empty()) {
+      NodeVisitIds(internal_id, direction, add_neighbor);
+    } else {
+      for (uint16_t type_id : rel_type_ids) {
+        NodeVisitIds(internal_id, direction, type_id, add_neighbor);
+      }
     }
-    // Invalid relationship id
-    return false;
   }
 
-  bool Shard::RelationshipPropertiesSetFromJson(uint64_t id, const std::string &value) {
-    // If the relationship is valid
-    if (ValidRelationshipId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      std::map<std::string, std::any> values = relationships.at(internal_id).getProperties();
-      if (!value.empty()) {
-        // Get the properties
-        simdjson::error_code error;
+  std::vector<Walker> Shard::RandomWalkStep(std::vector<Walker> walkers, uint64_t step, Direction direction, const std::vector<uint16_t>& rel_type_ids, double p, double q, uint64_t seed) {
+    bool biased = p != 1.0 || q != 1.0;
+    std::vector<uint64_t> neighbors;
+    std::vector<double> weights;
+    for (Walker& walker : walkers) {
+      // A start that is not a node comes back with no previous node, a walk whose node was removed just ends
+      if (!ValidNodeId(walker.current)) {
+        walker.current = 0;
+        continue;
+      }
+      NodeNeighborIds(externalToInternal(walker.current), direction, rel_type_ids, neighbors);
+      uint64_t previous = walker.previous;
+      walker.previous = walker.current;
+      if (neighbors.empty()) {
+        walker.current = 0;
+        continue;
+      }
 
-        dom::object object;
-        error = parser.parse(value).get(object);
-        if (!error) {
-          // Add the node properties
-          convertProperties(values, object);
-        } else {
-          return false;
+      uint64_t key = RandomKey(seed, walker.walk, step);
+      if (!biased || previous == 0) {
+        walker.current = neighbors[RandomBelow(key, 0, neighbors.size())];
+      } else {
+        // Weights add up as they go, so the pick is a binary search for a point along the total
+        weights.clear();
+        double total = 0;
+        for (uint64_t neighbor : neighbors) {
+          if (neighbor == previous) {
+            total += 1 / p;
+          } else if (std::binary_search(std::begin(walker.previous_neighbors), std::end(walker.previous_neighbors), neighbor)) {
+            total += 1;
+          } else {
+            total += 1 / q;
+          }
+          weights.push_back(total);
         }
+        size_t picked = std::upper_bound(std::begin(weights), std::end(weights), RandomUnit(key) * total) - std::begin(weights);
+        walker.current = neighbors[std::min(picked, neighbors.size() - 1)];
       }
 
-      nodes.at(internal_id).setProperties(values);
-      return true;
-    } else {
-      return false;
+      if (biased) {
+        std::sort(std::begin(neighbors), std::end(neighbors));
+        neighbors.erase(std::unique(std::begin(neighbors), std::end(neighbors)), std::end(neighbors));
+        walker.previous_neighbors = neighbors;
+      }
     }
+    return walkers;
   }
 
-  bool Shard::RelationshipPropertiesReset(uint64_t id, const std::map<std::string, std::any> &value) {
-    // If the relationship is valid
-    if (ValidRelationshipId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      relationships.at(internal_id).setProperties(value);
-      return true;
+  std::vector<std::pair<uint64_t, std::vector<uint64_t>>> Shard::SampleNeighbors(const std::vector<uint64_t>& ids, uint64_t fanout, uint64_t hop, Direction direction,
+                                                                                 const std::vector<uint16_t>& rel_type_ids, uint64_t seed) {
+    std::vector<std::pair<uint64_t, std::vector<uint64_t>>> sampled;
+    std::vector<uint64_t> neighbors;
+    for (uint64_t id : ids) {
+      if (!ValidNodeId(id)) {
+        continue;
+      }
+      NodeNeighborIds(externalToInternal(id), direction, rel_type_ids, neighbors);
+      // Without replacement: a partial shuffle that stops once fanout neighbors are in front
+      uint64_t key = RandomKey(seed, id, hop);
+      size_t taken = std::min(static_cast<size_t>(fanout), neighbors.size());
+      for (size_t i = 0; i < taken; i++) {
+        std::swap(neighbors[i], neighbors[i + RandomBelow(key, i, neighbors.size() - i)]);
+      }
+      sampled.emplace_back(id, std::vector<uint64_t>(std::begin(neighbors), std::begin(neighbors) + taken));
     }
-    // Invalid relationship id
-    return false;
+    return sampled;
   }
 
-  bool Shard::RelationshipPropertiesResetFromJson(uint64_t id, const std::string &value) {
-    // If the relationship is valid
-    if (ValidRelationshipId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      std::map<std::string, std::any> values;
-      if (!value.empty()) {
-        // Get the properties
-        simdjson::error_code error;
+  // Algorithms
 
-        dom::object object;
-        error = parser.parse(value).get(object);
-        if (!error) {
-          // Add the node properties
-          convertProperties(values, object);
-        } else {
-          return false;
+  uint64_t Shard::AlgorithmStart(uint64_t algorithm_id, AlgorithmKind kind, const std::vector<uint64_t>& sources) {
+    Algorithm& algorithm = algorithms.insert_or_assign(algorithm_id, Algorithm(kind, nodes.size())).first->second;
+    uint64_t count = 0;
+    if (kind == AlgorithmKind::BFS) {
+      // Only the sources this shard owns start at distance zero
+      for (uint64_t id : sources) {
+        if (ValidNodeId(id) && nodes.at(externalToInternal(id)).getId() != 0) {
+          algorithm.values[externalToInternal(id)] = 0;
+          algorithm.active[externalToInternal(id)] = 1;
+          count++;
         }
       }
+      return count;
+    }
 
-      nodes.at(internal_id).setProperties(values);
-      return true;
-    } else {
-      return false;
+    // Every node sends its rank, or its own id as the first guess of its component
+    for (uint64_t internal_id = 1; internal_id < nodes.size(); internal_id++) {
+      if (nodes.at(internal_id).getId() == 0) {
+        continue;
+      }
+      if (kind == AlgorithmKind::WCC) {
+        algorithm.values[internal_id] = static_cast<double>(internalToExternal(internal_id));
+      }
+      algorithm.active[internal_id] = 1;
+      count++;
     }
+    return count;
   }
 
-  bool Shard::RelationshipPropertiesDelete(uint64_t id) {
-    // If the relationship is valid
-    if (ValidRelationshipId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      relationships.at(internal_id).deleteProperties();
-      return true;
+  seastar::future<> Shard::AlgorithmSend(uint64_t algorithm_id, Direction direction, const std::vector<uint16_t>& rel_type_ids) {
+    auto found = algorithms.find(algorithm_id);
+    if (found == std::end(algorithms)) {
+      return seastar::make_ready_future<>();
     }
-    // Invalid relationship id
-    return false;
-  }
+    const Algorithm& algorithm = found->second;
 
-  // Node Degree
-  uint64_t Shard::NodeGetDegree(const std::string &type, const std::string &key) {
-    uint64_t id = NodeGetID(type, key);
-    return NodeGetDegree(id);
-  }
+    // One batch of messages per shard, reusing the same neighbor buffer for every node
+    std::vector<std::vector<std::pair<uint64_t, double>>> sharded_messages(cpus);
+    std::vector<uint64_t> neighbors;
+    for (uint64_t internal_id = 1; internal_id < algorithm.active.size(); internal_id++) {
+      if (!algorithm.active[internal_id] || nodes.at(internal_id).getId() == 0) {
+        continue;
+      }
+      NodeNeighborIds(internal_id, direction, rel_type_ids, neighbors);
+      if (neighbors.empty()) {
+        continue;
+      }
 
-  uint64_t Shard::NodeGetDegree(const std::string &type, const std::string &key, Direction direction) {
-    uint64_t id = NodeGetID(type, key);
-    return NodeGetDegree(id, direction);
-  }
+      double value = algorithm.values[internal_id];
+      if (algorithm.kind == AlgorithmKind::PAGERANK) {
+        value /= static_cast<double>(neighbors.size());
+      } else if (algorithm.kind == AlgorithmKind::BFS) {
+        value += 1;
+      }
+      for (uint64_t neighbor_id : neighbors) {
+        sharded_messages[CalculateShardId(neighbor_id)].emplace_back(neighbor_id, value);
+      }
+    }
+
+    std::vector<seastar::future<>> futures;
+    for (uint16_t their_shard = 0; their_shard < cpus; their_shard++) {
+      if (sharded_messages[their_shard].empty()) {
+        continue;
+      }
+      auto future = PeerOn("AlgorithmSend", their_shard, [algorithm_id, messages = std::move(sharded_messages[their_shard])] (Shard &local_shard) {
+             local_shard.AlgorithmReceive(algorithm_id, messages);
+      });
+      futures.push_back(std::move(future));
+    }
 
-  uint64_t Shard::NodeGetDegree(const std::string &type, const std::string &key, Direction direction, const std::string &rel_type) {
-    uint64_t id = NodeGetID(type, key);
-    return NodeGetDegree(id, direction, rel_type);
+    auto p = make_shared(std::move(futures));
+    return seastar::when_all_succeed(p->begin(), p->end());
   }
 
-  uint64_t Shard::NodeGetDegree(const std::string &type, const std::string &key, Direction direction, const std::vector<std::string> &rel_types) {
-    uint64_t id = NodeGetID(type, key);
-    return NodeGetDegree(id, direction, rel_types);
+  void Shard::AlgorithmReceive(uint64_t algorithm_id, const std::vector<std::pair<uint64_t, double>>& messages) {
+    auto found = algorithms.find(algorithm_id);
+    if (found == std::end(algorithms)) {
+      return;
+    }
+    for (const auto& [id, value] : messages) {
+      // Nodes added after the start are left out
+      if (ValidNodeId(id) && externalToInternal(id) < found->second.values.size()) {
+        found->second.receive(externalToInternal(id), value);
+      }
+    }
   }
 
-  uint64_t Shard::NodeGetDegree(uint64_t id) {
-    if (ValidNodeId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      return outgoing_relationships.at(internal_id).size() + incoming_relationships.at(internal_id).size();
+  uint64_t Shard::AlgorithmUpdate(uint64_t algorithm_id, double damping) {
+    auto found = algorithms.find(algorithm_id);
+    if (found == std::end(algorithms)) {
+      return 0;
     }
-    return 0;
+    return found->second.update(damping);
   }
 
-  uint64_t Shard::NodeGetDegree(uint64_t id, Direction direction) {
-    if (ValidNodeId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      uint64_t count = 0;
-      // Use the two ifs to handle ALL for a direction
-      if (direction != IN) {
-        // For each type sum up the values
-        for (const auto &[key, value] : outgoing_relationships.at(internal_id)) {
-          count += value.size();
-        }
+  std::vector<std::pair<uint64_t, double>> Shard::AlgorithmFinish(uint64_t algorithm_id, const std::string& property) {
+    std::vector<std::pair<uint64_t, double>> results;
+    auto found = algorithms.find(algorithm_id);
+    if (found == std::end(algorithms)) {
+      return results;
+    }
+    const Algorithm& algorithm = found->second;
+
+    for (uint64_t internal_id = 1; internal_id < algorithm.values.size(); internal_id++) {
+      // Deleted nodes and nodes a search never reached have no result
+      double value = algorithm.kind == AlgorithmKind::CLUSTERING ? algorithm.coefficient(internal_id) : algorithm.values[internal_id];
+      if (nodes.at(internal_id).getId() == 0 || value == Algorithm::UNREACHED) {
+        continue;
       }
-      if (direction != OUT) {
-        // For each type sum up the values
-        for (const auto &[key, value] : incoming_relationships.at(internal_id)) {
-          count += value.size();
-        }
+      uint64_t id = internalToExternal(internal_id);
+      if (property.empty()) {
+        results.emplace_back(id, value);
+      } else if (algorithm.kind == AlgorithmKind::PAGERANK || algorithm.kind == AlgorithmKind::CLUSTERING) {
+        NodePropertySet(id, property, value);
+      } else {
+        NodePropertySet(id, property, static_cast<int64_t>(value));
       }
-      return count;
     }
 
-    return 0;
+    algorithms.erase(found);
+    return results;
   }
 
-  uint64_t Shard::NodeGetDegree(uint64_t id, Direction direction, const std::string &rel_type) {
-    if (ValidNodeId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      uint16_t type_id = relationship_types.getTypeId(rel_type);
-      if (type_id > 0) {
-        uint64_t count = 0;
-        // Use the two ifs to handle ALL for a direction
-        if (direction != IN) {
-          auto group = find_if(std::begin(outgoing_relationships.at(internal_id)), std::end(outgoing_relationships.at(internal_id)),
-                               [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
-
-          if (group != std::end(outgoing_relationships.at(internal_id))) {
-            count += group->ids.size();
-          }
-        }
-        if (direction != OUT) {
-          auto group = find_if(std::begin(incoming_relationships.at(internal_id)), std::end(incoming_relationships.at(internal_id)),
-                               [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
+  // Triangles count each one once from its smallest node, u < v < w, by intersecting the larger neighbors of u and v
 
-          if (group != std::end(incoming_relationships.at(internal_id))) {
-            count += group->ids.size();
-          }
-        }
-        return count;
+  uint64_t Shard::TriangleStart(uint64_t algorithm_id, AlgorithmKind kind, const std::vector<uint16_t>& rel_type_ids) {
+    Algorithm& algorithm = algorithms.insert_or_assign(algorithm_id, Algorithm(kind, nodes.size())).first->second;
+    uint64_t count = 0;
+    std::vector<uint64_t> neighbors;
+    for (uint64_t internal_id = 1; internal_id < nodes.size(); internal_id++) {
+      if (nodes.at(internal_id).getId() == 0) {
+        continue;
       }
+      // Directions and parallel relationships do not make more triangles, loops do not make any
+      uint64_t id = internalToExternal(internal_id);
+      NodeNeighborIds(internal_id, BOTH, rel_type_ids, neighbors);
+      std::sort(std::begin(neighbors), std::end(neighbors));
+      neighbors.erase(std::unique(std::begin(neighbors), std::end(neighbors)), std::end(neighbors));
+      neighbors.erase(std::remove(std::begin(neighbors), std::end(neighbors), id), std::end(neighbors));
+      algorithm.degrees[internal_id] = neighbors.size();
+      algorithm.higher[internal_id].assign(std::upper_bound(std::begin(neighbors), std::end(neighbors), id), std::end(neighbors));
+      count++;
     }
-
-    return 0;
+    return count;
   }
 
-  uint64_t Shard::NodeGetDegree(uint64_t id, Direction direction, const std::vector<std::string> &rel_types) {
-    if (ValidNodeId(id)) {
-      uint64_t internal_id = externalToInternal(id);
-      uint64_t count = 0;
-      // Use the two ifs to handle ALL for a direction
-      if (direction != IN) {
-        // For each requested type sum up the values
-        for (const auto &rel_type : rel_types) {
-          uint16_t type_id = relationship_types.getTypeId(rel_type);
-          if (type_id > 0) {
-            auto group = find_if(std::begin(outgoing_relationships.at(internal_id)), std::end(outgoing_relationships.at(internal_id)),
-                                 [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
-
-            if (group != std::end(outgoing_relationships.at(internal_id))) {
-              count += group->ids.size();
-            }
-          }
-        }
+  std::vector<std::pair<uint64_t, std::vector<uint64_t>>> Shard::TriangleNeighbors(uint64_t algorithm_id, const std::vector<uint64_t>& ids) {
+    std::vector<std::pair<uint64_t, std::vector<uint64_t>>> neighbors;
+    auto found = algorithms.find(algorithm_id);
+    if (found == std::end(algorithms) || !found->second.counting()) {
+      return neighbors;
+    }
+    for (uint64_t id : ids) {
+      if (ValidNodeId(id) && externalToInternal(id) < found->second.higher.size()) {
+        neighbors.emplace_back(id, found->second.higher[externalToInternal(id)]);
       }
-      if (direction != OUT) {
-        // For each requested type sum up the values
-        for (const auto &rel_type : rel_types) {
-          uint16_t type_id = relationship_types.getTypeId(rel_type);
-          if (type_id > 0) {
-            auto group = find_if(std::begin(incoming_relationships.at(internal_id)), std::end(incoming_relationships.at(internal_id)),
-                                 [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
+    }
+    return neighbors;
+  }
 
-            if (group != std::end(incoming_relationships.at(internal_id))) {
-              count += group->ids.size();
-            }
-          }
+  seastar::future<> Shard::TriangleCount(uint64_t algorithm_id) {
+    auto found = algorithms.find(algorithm_id);
+    if (found == std::end(algorithms) || !found->second.counting()) {
+      return seastar::make_ready_future<>();
+    }
+
+    // The larger neighbors of the nodes on other shards are asked for once, all in one batch per shard
+    std::map<uint16_t, std::vector<uint64_t>> sharded_ids;
+    for (const auto& higher : found->second.higher) {
+      for (uint64_t id : higher) {
+        uint16_t their_shard = CalculateShardId(id);
+        if (their_shard != shard_id) {
+          sharded_ids[their_shard].push_back(id);
         }
       }
-      return count;
+    }
+    for (auto& [their_shard, ids] : sharded_ids) {
+      std::sort(std::begin(ids), std::end(ids));
+      ids.erase(std::unique(std::begin(ids), std::end(ids)), std::end(ids));
     }
 
-    return 0;
-  }
+    return PeerScatter<std::pair<uint64_t, std::vector<uint64_t>>>("Triangles", std::move(sharded_ids), [algorithm_id] (Shard &local_shard, const std::vector<uint64_t>& part) {
+             return local_shard.TriangleNeighbors(algorithm_id, part);
+      })
+      .then([algorithm_id, this] (std::vector<std::pair<uint64_t, std::vector<uint64_t>>> fetched) {
+             auto found = algorithms.find(algorithm_id);
+             if (found == std::end(algorithms)) {
+               return seastar::make_ready_future<>();
+             }
+             const Algorithm& algorithm = found->second;
+             std::unordered_map<uint64_t, std::vector<uint64_t>> remote(std::make_move_iterator(std::begin(fetched)), std::make_move_iterator(std::end(fetched)));
+             static const std::vector<uint64_t> none;
+
+             // Every node of a triangle gets one, added up by shard before they are sent
+             std::vector<std::unordered_map<uint64_t, double>> sharded_counts(cpus);
+             std::vector<uint64_t> common;
+             for (uint64_t internal_id = 1; internal_id < algorithm.higher.size(); internal_id++) {
+               const std::vector<uint64_t>& higher = algorithm.higher[internal_id];
+               if (higher.size() < 2) {
+                 continue;
+               }
+               uint64_t id = internalToExternal(internal_id);
+               for (uint64_t neighbor_id : higher) {
+                 const std::vector<uint64_t>* neighbor_higher = &none;
+                 if (CalculateShardId(neighbor_id) == shard_id) {
+                   if (externalToInternal(neighbor_id) < algorithm.higher.size()) {
+                     neighbor_higher = &algorithm.higher[externalToInternal(neighbor_id)];
+                   }
+                 } else if (auto neighbor = remote.find(neighbor_id); neighbor != std::end(remote)) {
+                   neighbor_higher = &neighbor->second;
+                 }
+                 common.clear();
+                 Algorithm::intersect(higher, *neighbor_higher, common);
+                 if (common.empty()) {
+                   continue;
+                 }
+                 sharded_counts[shard_id][id] += static_cast<double>(common.size());
+                 sharded_counts[CalculateShardId(neighbor_id)][neighbor_id] += static_cast<double>(common.size());
+                 for (uint64_t third_id : common) {
+                   sharded_counts[CalculateShardId(third_id)][third_id] += 1;
+                 }
+               }
+             }
 
-  // Traversing
-  std::vector<Ids> Shard::NodeGetRelationshipsIDs(const std::string &type, const std::string &key) {
-    uint64_t id = NodeGetID(type, key);
-    return NodeGetRelationshipsIDs(id);
-  }
+             std::vector<seastar::future<>> futures;
+             for (uint16_t their_shard = 0; their_shard < cpus; their_shard++) {
+               if (sharded_counts[their_shard].empty()) {
+                 continue;
+               }
+               std::vector<std::pair<uint64_t, double>> messages(std::begin(sharded_counts[their_shard]), std::end(sharded_counts[their_shard]));
+               auto future = PeerOn("Triangles", their_shard, [algorithm_id, messages = std::move(messages)] (Shard &local_shard) {
+                      local_shard.AlgorithmReceive(algorithm_id, messages);
+               });
+               futures.push_back(std::move(future));
+             }
 
-  std::vector<Ids> Shard::NodeGetRelationshipsIDs(const std::string &type, const std::string &key, Direction direction) {
-    uint64_t id = NodeGetID(type, key);
-    return NodeGetRelationshipsIDs(id, direction);
+             auto p = make_shared(std::move(futures));
+             return seastar::when_all_succeed(p->begin(), p->end());
+      });
   }
 
-  std::vector<Ids> Shard::NodeGetRelationshipsIDs(const std::string &type, const std::string &key, Direction direction, const std::string &rel_type) {
-    uint64_t id = NodeGetID(type, key);
-    return NodeGetRelationshipsIDs(id, direction, rel_type);
-  }
+  // Shortest Paths
 
-  std::vector<Ids> Shard::NodeGetRelationshipsIDs(const std::string &type, const std::string &key, Direction direction, uint16_t type_id) {
-    uint64_t id = NodeGetID(type, key);
-    return NodeGetRelationshipsIDs(id, direction, type_id);
+  bool Shard::PathStart(uint64_t path_id, uint8_t side, uint64_t id) {
+    if (!ValidNodeId(id) || nodes.at(externalToInternal(id)).getId() == 0) {
+      return false;
+    }
+    PathSide& path_side = paths[path_id].sides[side];
+    path_side.reached.emplace(id, PathStep{0, 0, 0});
+    path_side.frontier.push_back(id);
+    return true;
   }
 
-  std::vector<Ids> Shard::NodeGetRelationshipsIDs(const std::string &type, const std::string &key, Direction direction, const std::vector<std::string> &rel_types) {
-    uint64_t id = NodeGetID(type, key);
-    return NodeGetRelationshipsIDs(id, direction, rel_types);
-  }
+  seastar::future<> Shard::PathExpand(uint64_t path_id, uint8_t side, Direction direction, const std::vector<uint16_t>& rel_type_ids) {
+    auto path = paths.find(path_id);
+    if (path == std::end(paths)) {
+      return seastar::make_ready_future<>();
+    }
+    // This hop is done once it is expanded
+    std::vector<uint64_t> frontier = std::move(path->second.sides[side].frontier);
 
-  std::vector<Ids> Shard::NodeGetRelationshipsIDs(uint64_t id) {
-    if (ValidNodeId(id)) {
+    // Each reached node goes to the shard that owns it with the node and relationship it was reached from
+    std::map<uint16_t, std::vector<std::tuple<uint64_t, uint64_t, uint64_t>>> sharded_reached;
+    for (uint64_t id : frontier) {
+      auto add_node = [&sharded_reached, id] (const Ids& ids) {
+        sharded_reached[CalculateShardId(ids.node_id)].emplace_back(ids.node_id, id, ids.rel_id);
+      };
       uint64_t internal_id = externalToInternal(id);
-      std::vector<Ids> ids;
-      for (const auto &[type, list] : outgoing_relationships.at(internal_id)) {
-        std::copy(std::begin(list), std::end(list), std::back_inserter(ids));
-      }
-      for (const auto &[type, list] : incoming_relationships.at(internal_id)) {
-        std::copy(std::begin(list), std::end(list), std::back_inserter(ids));
+      if (rel_type_ids.empty()) {
+        NodeVisitIds(internal_id, direction, add_node);
+      } else {
+        for (uint16_t type_id : rel_type_ids) {
+          NodeVisitIds(internal_id, direction, type_id, add_node);
+        }
       }
-      return ids;
     }
-    return std::vector<Ids>();
+
+    std::vector<seastar::future<>> futures;
+    for (auto& [their_shard, grouped_reached] : sharded_reached) {
+      auto future = PeerOn("PathExpand", their_shard, [path_id, side, grouped_reached = std::move(grouped_reached)] (Shard &local_shard) {
+             local_shard.PathReceive(path_id, side, grouped_reached);
+      });
+      futures.push_back(std::move(future));
+    }
+
+    auto p = make_shared(std::move(futures));
+    return seastar::when_all_succeed(p->begin(), p->end());
   }
 
-  std::vector<Node> Shard::NodesGet(const std::vector<uint64_t>& node_ids) {
-    std::vector<Node> sharded_nodes;
+  void Shard::PathReceive(uint64_t path_id, uint8_t side, const std::vector<std::tuple<uint64_t, uint64_t, uint64_t>>& reached) {
+    PathSearch& path = paths[path_id];
+    PathSide& this_side = path.sides[side];
+    const PathSide& other_side = path.sides[1 - side];
 
-    for(uint64_t id : node_ids) {
-      uint64_t internal_id = externalToInternal(id);
-      sharded_nodes.push_back(nodes.at(internal_id));
+    for (const auto& [id, from_id, rel_id] : reached) {
+      if (!ValidNodeId(id) || !this_side.reached.emplace(id, PathStep{from_id, rel_id, this_side.depth + 1}).second) {
+        continue;
+      }
+      this_side.next.push_back(id);
+      // The sides met, keep the shortest of the ways they did
+      auto met = other_side.reached.find(id);
+      if (met != std::end(other_side.reached) && this_side.depth + 1 + met->second.depth < path.meeting_length) {
+        path.meeting_length = this_side.depth + 1 + met->second.depth;
+        path.meeting_id = id;
+      }
     }
-
-    return sharded_nodes;
   }
 
-  std::vector<Relationship> Shard::RelationshipsGet(const std::vector<uint64_t>& rel_ids) {
-    std::vector<Relationship> sharded_relationships;
+  std::tuple<uint64_t, uint64_t, uint64_t> Shard::PathAdvance(uint64_t path_id, uint8_t side) {
+    PathSearch& path = paths[path_id];
+    PathSide& path_side = path.sides[side];
+    path_side.frontier = std::move(path_side.next);
+    path_side.next.clear();
+    path_side.depth++;
+    return {path_side.frontier.size(), path.meeting_length, path.meeting_id};
+  }
 
-    for(uint64_t id : rel_ids) {
-      uint64_t internal_id = externalToInternal(id);
-      sharded_relationships.push_back(relationships.at(internal_id));
+  PathStep Shard::PathGetStep(uint64_t path_id, uint8_t side, uint64_t id) {
+    auto path = paths.find(path_id);
+    if (path != std::end(paths)) {
+      auto step = path->second.sides[side].reached.find(id);
+      if (step != std::end(path->second.sides[side].reached)) {
+        return step->second;
+      }
     }
+    return PathStep{0, 0, 0};
+  }
 
-    return sharded_relationships;
+  void Shard::PathFinish(uint64_t path_id) {
+    paths.erase(path_id);
   }
 
   std::map<uint16_t, std::vector<uint64_t>> Shard::NodeGetShardedRelationshipIDs(const std::string& type, const std::string& key) {
@@ -1869,8 +4771,7 @@ namespace triton {
         sharded_relationships_ids.insert({i, std::vector<uint64_t>() });
       }
 
-      auto group = find_if(std::begin(outgoing_relationships.at(internal_id)), std::end(outgoing_relationships.at(internal_id)),
-                           [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
+      auto group = findGroup(outgoing_relationships.at(internal_id), type_id);
 
       if (group != std::end(outgoing_relationships.at(internal_id))) {
         for(Ids ids : group->ids) {
@@ -1878,8 +4779,7 @@ namespace triton {
         }
       }
 
-      group = find_if(std::begin(incoming_relationships.at(internal_id)), std::end(incoming_relationships.at(internal_id)),
-                      [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
+      group = findGroup(incoming_relationships.at(internal_id), type_id);
 
       if (group != std::end(incoming_relationships.at(internal_id))) {
         for(Ids ids : group->ids) {
@@ -1907,8 +4807,7 @@ namespace triton {
         sharded_relationships_ids.insert({i, std::vector<uint64_t>() });
       }
 
-      auto group = find_if(std::begin(outgoing_relationships.at(internal_id)), std::end(outgoing_relationships.at(internal_id)),
-                           [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
+      auto group = findGroup(outgoing_relationships.at(internal_id), type_id);
 
       if (group != std::end(outgoing_relationships.at(internal_id))) {
         for(Ids ids : group->ids) {
@@ -1916,8 +4815,7 @@ namespace triton {
         }
       }
 
-      group = find_if(std::begin(incoming_relationships.at(internal_id)), std::end(incoming_relationships.at(internal_id)),
-                      [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
+      group = findGroup(incoming_relationships.at(internal_id), type_id);
 
       if (group != std::end(incoming_relationships.at(internal_id))) {
         for(Ids ids : group->ids) {
@@ -1949,8 +4847,7 @@ namespace triton {
         uint16_t type_id = relationship_types.getTypeId(rel_type);
         if (type_id > 0) {
 
-          auto group = find_if(std::begin(outgoing_relationships.at(internal_id)), std::end(outgoing_relationships.at(internal_id)),
-                               [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
+          auto group = findGroup(outgoing_relationships.at(internal_id), type_id);
 
           if (group != std::end(outgoing_relationships.at(internal_id))) {
             for(Ids ids : group->ids) {
@@ -1958,8 +4855,7 @@ namespace triton {
             }
           }
 
-          group = find_if(std::begin(incoming_relationships.at(internal_id)), std::end(incoming_relationships.at(internal_id)),
-                          [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
+          group = findGroup(incoming_relationships.at(internal_id), type_id);
 
           if (group != std::end(incoming_relationships.at(internal_id))) {
             for(Ids ids : group->ids) {
@@ -2015,19 +4911,10 @@ namespace triton {
         sharded_nodes_ids.insert({i, std::vector<uint64_t>() });
       }
 
-      for (auto &types : outgoing_relationships.at(internal_id)) {
-        for (Ids ids : types.ids) {
-          uint16_t node_shard_id = CalculateShardId(ids.node_id);
-          sharded_nodes_ids.at(node_shard_id).push_back(ids.node_id);
-        }
-      }
-
-      for (auto &types : incoming_relationships.at(internal_id)) {
-        for (Ids ids : types.ids) {
-          uint16_t node_shard_id = CalculateShardId(ids.node_id);
-          sharded_nodes_ids.at(node_shard_id).push_back(ids.node_id);
-        }
-      }
+      auto add_node = [&sharded_nodes_ids] (const Ids& ids) {
+        sharded_nodes_ids.at(CalculateShardId(ids.node_id)).push_back(ids.node_id);
+      };
+      NodeVisitIds(internal_id, BOTH, add_node);
 
       for (int i = 0; i < cpus; i++) {
         if (sharded_nodes_ids.at(i).empty()) {
@@ -2049,24 +4936,10 @@ namespace triton {
         sharded_nodes_ids.insert({i, std::vector<uint64_t>() });
       }
 
-      auto group = find_if(std::begin(outgoing_relationships.at(internal_id)), std::end(outgoing_relationships.at(internal_id)),
-                           [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
-
-      if (group != std::end(outgoing_relationships.at(internal_id))) {
-        for(Ids ids : group->ids) {
-          sharded_nodes_ids.at(shard_id).emplace_back(ids.node_id);
-        }
-      }
-
-      group = find_if(std::begin(incoming_relationships.at(internal_id)), std::end(incoming_relationships.at(internal_id)),
-                      [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
-
-      if (group != std::end(incoming_relationships.at(internal_id))) {
-        for(Ids ids : group->ids) {
-          uint16_t node_shard_id = CalculateShardId(ids.node_id);
-          sharded_nodes_ids.at(node_shard_id).emplace_back(ids.node_id);
-        }
-      }
+      auto add_node = [&sharded_nodes_ids] (const Ids& ids) {
+        sharded_nodes_ids.at(CalculateShardId(ids.node_id)).push_back(ids.node_id);
+      };
+      NodeVisitIds(internal_id, BOTH, type_id, add_node);
 
       for (int i = 0; i < cpus; i++) {
         if (sharded_nodes_ids.at(i).empty()) {
@@ -2087,27 +4960,13 @@ namespace triton {
         sharded_nodes_ids.insert({i, std::vector<uint64_t>() });
       }
 
-      auto group = find_if(std::begin(outgoing_relationships.at(internal_id)), std::end(outgoing_relationships.at(internal_id)),
-                           [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
-
-      if (group != std::end(outgoing_relationships.at(internal_id))) {
-        for(Ids ids : group->ids) {
-          sharded_nodes_ids.at(shard_id).emplace_back(ids.node_id);
-        }
-      }
-
-      group = find_if(std::begin(incoming_relationships.at(internal_id)), std::end(incoming_relationships.at(internal_id)),
-                      [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
-
-      if (group != std::end(incoming_relationships.at(internal_id))) {
-        for(Ids ids : group->ids) {
-          uint16_t node_shard_id = CalculateShardId(ids.node_id);
-          sharded_nodes_ids.at(node_shard_id).emplace_back(ids.node_id);
-        }
-      }
+      auto add_node = [&sharded_nodes_ids] (const Ids& ids) {
+        sharded_nodes_ids.at(CalculateShardId(ids.node_id)).push_back(ids.node_id);
+      };
+      NodeVisitIds(internal_id, BOTH, type_id, add_node);
 
       for (int i = 0; i < cpus; i++) {
-        if(sharded_nodes_ids.at(i).empty()) {
+        if (sharded_nodes_ids.at(i).empty()) {
           sharded_nodes_ids.erase(i);
         }
       }
@@ -2125,32 +4984,18 @@ namespace triton {
         sharded_nodes_ids.insert({i, std::vector<uint64_t>() });
       }
 
+      auto add_node = [&sharded_nodes_ids] (const Ids& ids) {
+        sharded_nodes_ids.at(CalculateShardId(ids.node_id)).push_back(ids.node_id);
+      };
       for (const auto &rel_type : rel_types) {
         uint16_t type_id = relationship_types.getTypeId(rel_type);
         if (type_id > 0) {
-          auto group = find_if(std::begin(outgoing_relationships.at(internal_id)), std::end(outgoing_relationships.at(internal_id)),
-                               [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
-
-          if (group != std::end(outgoing_relationships.at(internal_id))) {
-            for(Ids ids : group->ids) {
-              sharded_nodes_ids.at(shard_id).emplace_back(ids.node_id);
-            }
-          }
-
-          group = find_if(std::begin(incoming_relationships.at(internal_id)), std::end(incoming_relationships.at(internal_id)),
-                          [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
-
-          if (group != std::end(incoming_relationships.at(internal_id))) {
-            for(Ids ids : group->ids) {
-              uint16_t node_shard_id = CalculateShardId(ids.node_id);
-              sharded_nodes_ids.at(node_shard_id).emplace_back(ids.node_id);
-            }
-          }
+          NodeVisitIds(internal_id, BOTH, type_id, add_node);
         }
       }
 
       for (int i = 0; i < cpus; i++) {
-        if(sharded_nodes_ids.at(i).empty()) {
+        if (sharded_nodes_ids.at(i).empty()) {
           sharded_nodes_ids.erase(i);
         }
       }
@@ -2160,6 +5005,100 @@ namespace triton {
     return std::map<uint16_t , std::vector<uint64_t>>();
   }
 
+  // Skip offset ids and keep limit of the rest, walking the shards in order
+  static void ShardedIdsWindow(std::map<uint16_t, std::vector<uint64_t>>& sharded_ids, uint64_t offset, uint64_t limit) {
+    for (auto it = sharded_ids.begin(); it != sharded_ids.end();) {
+      std::vector<uint64_t>& ids = it->second;
+      uint64_t skipped = std::min<uint64_t>(offset, ids.size());
+      ids.erase(ids.begin(), ids.begin() + skipped);
+      offset -= skipped;
+      if (ids.size() > limit) {
+        ids.resize(limit);
+      }
+      limit -= ids.size();
+      if (ids.empty()) {
+        it = sharded_ids.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  std::map<uint16_t, std::vector<uint64_t>> Shard::NodeGetShardedNodeIDs(uint64_t id, Direction direction, const std::vector<std::string> &rel_types, uint64_t offset, uint64_t limit) {
+    std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids;
+    if (ValidNodeId(id)) {
+      uint64_t internal_id = externalToInternal(id);
+      auto add_node = [&sharded_nodes_ids] (const Ids& ids) {
+        sharded_nodes_ids[CalculateShardId(ids.node_id)].push_back(ids.node_id);
+      };
+      if (rel_types.empty()) {
+        NodeVisitIds(internal_id, direction, add_node);
+      }
+      for (const auto &rel_type : rel_types) {
+        uint16_t type_id = relationship_types.getTypeId(rel_type);
+        if (type_id > 0) {
+          NodeVisitIds(internal_id, direction, type_id, add_node);
+        }
+      }
+      ShardedIdsWindow(sharded_nodes_ids, offset, limit);
+    }
+    return sharded_nodes_ids;
+  }
+
+  std::map<uint16_t, std::vector<uint64_t>> Shard::NodeGetShardedRelationshipIDs(uint64_t id, Direction direction, const std::vector<std::string> &rel_types, uint64_t offset, uint64_t limit) {
+    std::map<uint16_t, std::vector<uint64_t>> sharded_relationships_ids;
+    if (ValidNodeId(id)) {
+      uint64_t internal_id = externalToInternal(id);
+      auto add_relationship = [&sharded_relationships_ids] (const Ids& ids) {
+        sharded_relationships_ids[CalculateShardId(ids.rel_id)].push_back(ids.rel_id);
+      };
+      if (rel_types.empty()) {
+        NodeVisitIds(internal_id, direction, add_relationship);
+      }
+      for (const auto &rel_type : rel_types) {
+        uint16_t type_id = relationship_types.getTypeId(rel_type);
+        if (type_id > 0) {
+          NodeVisitIds(internal_id, direction, type_id, add_relationship);
+        }
+      }
+      ShardedIdsWindow(sharded_relationships_ids, offset, limit);
+    }
+    return sharded_relationships_ids;
+  }
+
+  std::map<uint16_t, Roaring64Map> Shard::NodeGetShardedNodeIdsMap(uint64_t id, Direction direction) {
+    std::map<uint16_t, Roaring64Map> sharded_nodes_ids;
+    if (ValidNodeId(id)) {
+      auto add_node = [&sharded_nodes_ids] (const Ids& ids) {
+        sharded_nodes_ids[CalculateShardId(ids.node_id)].add(ids.node_id);
+      };
+      NodeVisitIds(externalToInternal(id), direction, add_node);
+    }
+    return sharded_nodes_ids;
+  }
+
+  std::map<uint16_t, Roaring64Map> Shard::NodeGetShardedNodeIdsMap(uint64_t id, Direction direction, const std::vector<std::string> &rel_types) {
+    std::map<uint16_t, Roaring64Map> sharded_nodes_ids;
+    if (ValidNodeId(id)) {
+      uint64_t internal_id = externalToInternal(id);
+      auto add_node = [&sharded_nodes_ids] (const Ids& ids) {
+        sharded_nodes_ids[CalculateShardId(ids.node_id)].add(ids.node_id);
+      };
+      for (const auto &rel_type : rel_types) {
+        uint16_t type_id = relationship_types.getTypeId(rel_type);
+        if (type_id > 0) {
+          NodeVisitIds(internal_id, direction, type_id, add_node);
+        }
+      }
+    }
+    return sharded_nodes_ids;
+  }
+
+  Roaring64Map Shard::NodeIdsMapFilter(const Roaring64Map& ids, const std::string& type) {
+    uint16_t type_id = node_types.getTypeId(type);
+    return node_types.getIds(type_id, ids);
+  }
+
   std::vector<Relationship> Shard::NodeGetOutgoingRelationships(const std::string& type, const std::string& key) {
     uint64_t id = NodeGetID(type, key);
     return NodeGetOutgoingRelationships(id);
@@ -2186,7 +5125,7 @@ namespace triton {
       uint64_t internal_id = externalToInternal(id);
       for (auto &types : outgoing_relationships.at(internal_id)) {
         for (Ids ids : types.ids) {
-          node_relationships.push_back(relationships.at(ids.rel_id));
+          node_relationships.push_back(RelationshipCopy(externalToInternal(ids.rel_id)));
         }
       }
     }
@@ -2199,12 +5138,11 @@ namespace triton {
       uint16_t type_id = relationship_types.getTypeId(rel_type);
       uint64_t internal_id = externalToInternal(id);
 
-      auto group = find_if(std::begin(outgoing_relationships.at(internal_id)), std::end(outgoing_relationships.at(internal_id)),
-                           [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
+      auto group = findGroup(outgoing_relationships.at(internal_id), type_id);
 
       if (group != std::end(outgoing_relationships.at(internal_id))) {
         for(Ids ids : group->ids) {
-          node_relationships.emplace_back(relationships.at(ids.rel_id));
+          node_relationships.emplace_back(RelationshipCopy(externalToInternal(ids.rel_id)));
         }
       }
 
@@ -2217,12 +5155,11 @@ namespace triton {
     if (ValidNodeId(id)) {
       uint64_t internal_id = externalToInternal(id);
 
-      auto group = find_if(std::begin(outgoing_relationships.at(internal_id)), std::end(outgoing_relationships.at(internal_id)),
-                           [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
+      auto group = findGroup(outgoing_relationships.at(internal_id), type_id);
 
       if (group != std::end(outgoing_relationships.at(internal_id))) {
         for(Ids ids : group->ids) {
-          node_relationships.emplace_back(relationships.at(ids.rel_id));
+          node_relationships.emplace_back(RelationshipCopy(externalToInternal(ids.rel_id)));
         }
       }
 
@@ -2237,12 +5174,11 @@ namespace triton {
       for (const auto &rel_type : rel_types) {
         uint16_t type_id = relationship_types.getTypeId(rel_type);
         if (type_id > 0) {
-          auto group = find_if(std::begin(outgoing_relationships.at(internal_id)), std::end(outgoing_relationships.at(internal_id)),
-                               [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
+          auto group = findGroup(outgoing_relationships.at(internal_id), type_id);
 
           if (group != std::end(outgoing_relationships.at(internal_id))) {
             for(Ids ids : group->ids) {
-              node_relationships.emplace_back(relationships.at(ids.rel_id));
+              node_relationships.emplace_back(RelationshipCopy(externalToInternal(ids.rel_id)));
             }
           }
         }
@@ -2306,8 +5242,7 @@ namespace triton {
         sharded_relationships_ids.insert({i, std::vector<uint64_t>() });
       }
 
-      auto group = find_if(std::begin(incoming_relationships.at(internal_id)), std::end(incoming_relationships.at(internal_id)),
-                      [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
+      auto group = findGroup(incoming_relationships.at(internal_id), type_id);
 
       if (group != std::end(incoming_relationships.at(internal_id))) {
         for(Ids ids : group->ids) {
@@ -2335,8 +5270,7 @@ namespace triton {
         sharded_relationships_ids.insert({i, std::vector<uint64_t>() });
       }
 
-      auto group = find_if(std::begin(incoming_relationships.at(internal_id)), std::end(incoming_relationships.at(internal_id)),
-                           [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
+      auto group = findGroup(incoming_relationships.at(internal_id), type_id);
 
       if (group != std::end(incoming_relationships.at(internal_id))) {
         for(Ids ids : group->ids) {
@@ -2366,8 +5300,7 @@ namespace triton {
       for (const auto &rel_type : rel_types) {
         uint16_t type_id = relationship_types.getTypeId(rel_type);
         if (type_id > 0) {
-          auto group = find_if(std::begin(incoming_relationships.at(internal_id)), std::end(incoming_relationships.at(internal_id)),
-                               [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
+          auto group = findGroup(incoming_relationships.at(internal_id), type_id);
 
           if (group != std::end(incoming_relationships.at(internal_id))) {
             for(Ids ids : group->ids) {
@@ -2417,15 +5350,13 @@ namespace triton {
         sharded_nodes_ids.insert({i, std::vector<uint64_t>() });
       }
 
-      for (auto &types : incoming_relationships.at(internal_id)) {
-        for (Ids ids : types.ids) {
-          uint16_t node_shard_id = CalculateShardId(ids.node_id);
-          sharded_nodes_ids.at(node_shard_id).emplace_back(ids.node_id);
-        }
-      }
+      auto add_node = [&sharded_nodes_ids] (const Ids& ids) {
+        sharded_nodes_ids.at(CalculateShardId(ids.node_id)).push_back(ids.node_id);
+      };
+      NodeVisitIds(internal_id, IN, add_node);
 
       for (int i = 0; i < cpus; i++) {
-        if(sharded_nodes_ids.at(i).empty()) {
+        if (sharded_nodes_ids.at(i).empty()) {
           sharded_nodes_ids.erase(i);
         }
       }
@@ -2441,21 +5372,16 @@ namespace triton {
       uint64_t internal_id = externalToInternal(id);
       std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids;
       for (int i = 0; i < cpus; i++) {
-        sharded_nodes_ids.insert({i, std::vector<uint64_t>() });
-      }
-
-      auto group = find_if(std::begin(incoming_relationships.at(internal_id)), std::end(incoming_relationships.at(internal_id)),
-                      [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
-
-      if (group != std::end(incoming_relationships.at(internal_id))) {
-        for(Ids ids : group->ids) {
-          uint16_t node_shard_id = CalculateShardId(ids.node_id);
-          sharded_nodes_ids.at(node_shard_id).emplace_back(ids.node_id);
-        }
+        sharded_nodes_ids.insert({i, std::vector<uint64_t>() });
       }
 
+      auto add_node = [&sharded_nodes_ids] (const Ids& ids) {
+        sharded_nodes_ids.at(CalculateShardId(ids.node_id)).push_back(ids.node_id);
+      };
+      NodeVisitIds(internal_id, IN, type_id, add_node);
+
       for (int i = 0; i < cpus; i++) {
-        if(sharded_nodes_ids.at(i).empty()) {
+        if (sharded_nodes_ids.at(i).empty()) {
           sharded_nodes_ids.erase(i);
         }
       }
@@ -2473,18 +5399,13 @@ namespace triton {
         sharded_nodes_ids.insert({i, std::vector<uint64_t>() });
       }
 
-      auto group = find_if(std::begin(incoming_relationships.at(internal_id)), std::end(incoming_relationships.at(internal_id)),
-                           [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
-
-      if (group != std::end(incoming_relationships.at(internal_id))) {
-        for(Ids ids : group->ids) {
-          uint16_t node_shard_id = CalculateShardId(ids.node_id);
-          sharded_nodes_ids.at(node_shard_id).emplace_back(ids.node_id);
-        }
-      }
+      auto add_node = [&sharded_nodes_ids] (const Ids& ids) {
+        sharded_nodes_ids.at(CalculateShardId(ids.node_id)).push_back(ids.node_id);
+      };
+      NodeVisitIds(internal_id, IN, type_id, add_node);
 
       for (int i = 0; i < cpus; i++) {
-        if(sharded_nodes_ids.at(i).empty()) {
+        if (sharded_nodes_ids.at(i).empty()) {
           sharded_nodes_ids.erase(i);
         }
       }
@@ -2501,23 +5422,19 @@ namespace triton {
       for (int i = 0; i < cpus; i++) {
         sharded_nodes_ids.insert({i, std::vector<uint64_t>() });
       }
+
+      auto add_node = [&sharded_nodes_ids] (const Ids& ids) {
+        sharded_nodes_ids.at(CalculateShardId(ids.node_id)).push_back(ids.node_id);
+      };
       for (const auto &rel_type : rel_types) {
         uint16_t type_id = relationship_types.getTypeId(rel_type);
         if (type_id > 0) {
-          auto group = find_if(std::begin(incoming_relationships.at(internal_id)), std::end(incoming_relationships.at(internal_id)),
-                               [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
-
-          if (group != std::end(incoming_relationships.at(internal_id))) {
-            for(Ids ids : group->ids) {
-              uint16_t node_shard_id = CalculateShardId(ids.node_id);
-              sharded_nodes_ids.at(node_shard_id).emplace_back(ids.node_id);
-            }
-          }
+          NodeVisitIds(internal_id, IN, type_id, add_node);
         }
       }
 
       for (int i = 0; i < cpus; i++) {
-        if(sharded_nodes_ids.at(i).empty()) {
+        if (sharded_nodes_ids.at(i).empty()) {
           sharded_nodes_ids.erase(i);
         }
       }
@@ -2555,15 +5472,13 @@ namespace triton {
         sharded_nodes_ids.insert({i, std::vector<uint64_t>() });
       }
 
-      for (auto &types : outgoing_relationships.at(internal_id)) {
-        for (Ids ids : types.ids) {
-          uint16_t node_shard_id = CalculateShardId(ids.node_id);
-          sharded_nodes_ids.at(node_shard_id).push_back(ids.node_id);
-        }
-      }
+      auto add_node = [&sharded_nodes_ids] (const Ids& ids) {
+        sharded_nodes_ids.at(CalculateShardId(ids.node_id)).push_back(ids.node_id);
+      };
+      NodeVisitIds(internal_id, OUT, add_node);
 
       for (int i = 0; i < cpus; i++) {
-        if(sharded_nodes_ids.at(i).empty()) {
+        if (sharded_nodes_ids.at(i).empty()) {
           sharded_nodes_ids.erase(i);
         }
       }
@@ -2582,17 +5497,13 @@ namespace triton {
         sharded_nodes_ids.insert({i, std::vector<uint64_t>() });
       }
 
-      auto group = find_if(std::begin(outgoing_relationships.at(internal_id)), std::end(outgoing_relationships.at(internal_id)),
-                           [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
-
-      if (group != std::end(outgoing_relationships.at(internal_id))) {
-        for(Ids ids : group->ids) {
-          sharded_nodes_ids.at(shard_id).emplace_back(ids.node_id);
-        }
-      }
+      auto add_node = [&sharded_nodes_ids] (const Ids& ids) {
+        sharded_nodes_ids.at(CalculateShardId(ids.node_id)).push_back(ids.node_id);
+      };
+      NodeVisitIds(internal_id, OUT, type_id, add_node);
 
       for (int i = 0; i < cpus; i++) {
-        if(sharded_nodes_ids.at(i).empty()) {
+        if (sharded_nodes_ids.at(i).empty()) {
           sharded_nodes_ids.erase(i);
         }
       }
@@ -2610,17 +5521,13 @@ namespace triton {
         sharded_nodes_ids.insert({i, std::vector<uint64_t>() });
       }
 
-      auto group = find_if(std::begin(outgoing_relationships.at(internal_id)), std::end(outgoing_relationships.at(internal_id)),
-                           [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
-
-      if (group != std::end(outgoing_relationships.at(internal_id))) {
-        for(Ids ids : group->ids) {
-          sharded_nodes_ids.at(shard_id).emplace_back(ids.node_id);
-        }
-      }
+      auto add_node = [&sharded_nodes_ids] (const Ids& ids) {
+        sharded_nodes_ids.at(CalculateShardId(ids.node_id)).push_back(ids.node_id);
+      };
+      NodeVisitIds(internal_id, OUT, type_id, add_node);
 
       for (int i = 0; i < cpus; i++) {
-        if(sharded_nodes_ids.at(i).empty()) {
+        if (sharded_nodes_ids.at(i).empty()) {
           sharded_nodes_ids.erase(i);
         }
       }
@@ -2637,22 +5544,19 @@ namespace triton {
       for (int i = 0; i < cpus; i++) {
         sharded_nodes_ids.insert({i, std::vector<uint64_t>() });
       }
+
+      auto add_node = [&sharded_nodes_ids] (const Ids& ids) {
+        sharded_nodes_ids.at(CalculateShardId(ids.node_id)).push_back(ids.node_id);
+      };
       for (const auto &rel_type : rel_types) {
         uint16_t type_id = relationship_types.getTypeId(rel_type);
         if (type_id > 0) {
-          auto group = find_if(std::begin(outgoing_relationships.at(internal_id)), std::end(outgoing_relationships.at(internal_id)),
-                               [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
-
-          if (group != std::end(outgoing_relationships.at(internal_id))) {
-            for(Ids ids : group->ids) {
-              sharded_nodes_ids.at(shard_id).emplace_back(ids.node_id);
-            }
-          }
+          NodeVisitIds(internal_id, OUT, type_id, add_node);
         }
       }
 
       for (int i = 0; i < cpus; i++) {
-        if(sharded_nodes_ids.at(i).empty()) {
+        if (sharded_nodes_ids.at(i).empty()) {
           sharded_nodes_ids.erase(i);
         }
       }
@@ -2690,15 +5594,13 @@ namespace triton {
       std::vector<Ids> ids;
       uint64_t size = 0;
       // Use the two ifs to handle ALL for a direction
-      auto out_group = find_if(std::begin(outgoing_relationships.at(internal_id)), std::end(outgoing_relationships.at(internal_id)),
-                           [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
+      auto out_group = findGroup(outgoing_relationships.at(internal_id), type_id);
 
       if (out_group != std::end(outgoing_relationships.at(internal_id))) {
         size += out_group->ids.size();
       }
 
-      auto in_group = find_if(std::begin(incoming_relationships.at(internal_id)), std::end(incoming_relationships.at(internal_id)),
-                           [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
+      auto in_group = findGroup(incoming_relationships.at(internal_id), type_id);
 
       if (in_group != std::end(incoming_relationships.at(internal_id))) {
         size += in_group->ids.size();
@@ -2723,8 +5625,7 @@ namespace triton {
       uint64_t internal_id = externalToInternal(id);
       if (direction == IN) {
 
-        auto in_group = find_if(std::begin(incoming_relationships.at(internal_id)), std::end(incoming_relationships.at(internal_id)),
-                                [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
+        auto in_group = findGroup(incoming_relationships.at(internal_id), type_id);
 
         if (in_group != std::end(incoming_relationships.at(internal_id))) {
           return in_group->ids;
@@ -2732,8 +5633,7 @@ namespace triton {
       }
 
       if (direction == OUT) {
-        auto out_group = find_if(std::begin(outgoing_relationships.at(internal_id)), std::end(outgoing_relationships.at(internal_id)),
-                                 [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
+        auto out_group = findGroup(outgoing_relationships.at(internal_id), type_id);
 
         if (out_group != std::end(outgoing_relationships.at(internal_id))) {
           return out_group->ids;
@@ -2742,15 +5642,13 @@ namespace triton {
 
       std::vector<Ids> ids;
       uint64_t size = 0;
-      auto out_group = find_if(std::begin(outgoing_relationships.at(internal_id)), std::end(outgoing_relationships.at(internal_id)),
-                               [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
+      auto out_group = findGroup(outgoing_relationships.at(internal_id), type_id);
 
       if (out_group != std::end(outgoing_relationships.at(internal_id))) {
         size += out_group->ids.size();
       }
 
-      auto in_group = find_if(std::begin(incoming_relationships.at(internal_id)), std::end(incoming_relationships.at(internal_id)),
-                              [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
+      auto in_group = findGroup(incoming_relationships.at(internal_id), type_id);
 
       if (in_group != std::end(incoming_relationships.at(internal_id))) {
         size += in_group->ids.size();
@@ -2776,8 +5674,7 @@ namespace triton {
         for (const auto &rel_type : rel_types) {
           uint16_t type_id = relationship_types.getTypeId(rel_type);
           if (type_id > 0) {
-            auto out_group = find_if(std::begin(outgoing_relationships.at(internal_id)), std::end(outgoing_relationships.at(internal_id)),
-                                     [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
+            auto out_group = findGroup(outgoing_relationships.at(internal_id), type_id);
 
             if (out_group != std::end(outgoing_relationships.at(internal_id))) {
               std::copy(std::begin(out_group->ids), std::end(out_group->ids), std::back_inserter(ids));
@@ -2791,8 +5688,7 @@ namespace triton {
         for (const auto &rel_type : rel_types) {
           uint16_t type_id = relationship_types.getTypeId(rel_type);
           if (type_id > 0) {
-            auto in_group = find_if(std::begin(incoming_relationships.at(internal_id)), std::end(incoming_relationships.at(internal_id)),
-                                    [type_id] (const Group& g) { return g.rel_type_id == type_id; } );
+            auto in_group = findGroup(incoming_relationships.at(internal_id), type_id);
 
             if (in_group != std::end(incoming_relationships.at(internal_id))) {
               std::copy(std::begin(in_group->ids), std::end(in_group->ids), std::back_inserter(ids));
@@ -2807,87 +5703,229 @@ namespace triton {
 
   void Shard::convertProperties(std::map<std::string, std::any> &values, const dom::object &object) const {
     for (auto[key, value] : object) {
-      auto property = static_cast<std::string>(key);
+      std::any property = convertProperty(value);
+      if (property.has_value()) {
+        values.insert({ static_cast<std::string>(key), std::move(property) });
+      }
+    }
+  }
+
+  bool Shard::convertFilters(const dom::object &object, std::vector<ScanFilter> &filters) const {
+    // [{ "property": "...", "op": ">", "value": ... }, ...], a query without filters has nothing to check
+    dom::array filter_array;
+    if (object["filters"].get(filter_array)) {
+      return true;
+    }
+    for (dom::element element : filter_array) {
+      dom::object filter;
+      std::string_view op;
+      ScanOperator scan_operator;
+      if (element.get(filter) || filter["op"].get(op) || !ScanFilter::toOperator(op, scan_operator)) {
+        return false;
+      }
+      std::map<std::string, std::any> fields;
+      convertProperties(fields, filter);
+      auto filter_property = fields.find("property");
+      auto value = fields.find("value");
+      if (filter_property == std::end(fields) || filter_property->second.type() != typeid(std::string) || value == std::end(fields)) {
+        return false;
+      }
+      filters.emplace_back(std::any_cast<std::string>(filter_property->second), scan_operator, value->second);
+    }
+    return true;
+  }
+
+  bool Shard::PropertyKeysFit(const std::string &key) {
+    return property_keys->insertKey(key) > 0;
+  }
+
+  bool Shard::PropertyKeysFit(const std::map<std::string, std::any> &values) {
+    for (const auto& [key, value] : values) {
+      if (!PropertyKeysFit(key)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool Shard::PropertyKeysFit(const dom::object &object) {
+    for (auto [key, value] : object) {
+      if (!PropertyKeysFit(std::string(key))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::any Shard::convertProperty(const dom::element &value) const {
+    switch (value.type()) {
+    case dom::element_type::INT64:
+      return int64_t(value);
+    case dom::element_type::UINT64:
+      // Unsigned Integer Values are not allowed, convert to signed
+      return static_cast<std::make_signed_t<uint64_t>>(value);
+    case dom::element_type::DOUBLE:
+      return double(value);
+    case dom::element_type::STRING:
+      return std::string(value);
+    case dom::element_type::BOOL:
+      return bool(value);
+    case dom::element_type::NULL_VALUE:
+      // Null Values are not allowed, just ignore them
+      return std::any();
+    case dom::element_type::OBJECT: {
+      std::map<std::string, std::any> nested;
+      convertProperties(nested, value);
+      return nested;
+    }
+    case dom::element_type::ARRAY:
+      // TODO: Finish this to Support Array properties
+      auto array = dom::array(value);
+      if (array.size() > 0) {
+        dom::element first = array.at(0);
+        std::vector<int64_t> int_vector;
+        std::vector<double> double_vector;
+        std::vector<std::string> string_vector;
+        std::vector<bool> bool_vector;
+        switch (first.type()) {
+        case dom::element_type::ARRAY:
+          break;
+        case dom::element_type::OBJECT:
+          break;
+        case dom::element_type::INT64:
+          for (dom::element child : dom::array(value)) {
+            // Numbers like [0, 0.5] are doubles, whole ones only where every one of them is
+            if (child.type() == dom::element_type::DOUBLE) {
+              for (dom::element number : dom::array(value)) {
+                double_vector.emplace_back(double(number));
+              }
+              return double_vector;
+            }
+            int_vector.emplace_back(int64_t(child));
+          }
+          return int_vector;
+        case dom::element_type::UINT64:
+          for (dom::element child : dom::array(value)) {
+            int_vector.emplace_back(static_cast<std::make_signed_t<uint64_t>>(child));
+          }
+          return int_vector;
+        case dom::element_type::DOUBLE:
+          for (dom::element child : dom::array(value)) {
+            double_vector.emplace_back(double(child));
+          }
+          return double_vector;
+        case dom::element_type::STRING:
+          for (dom::element child : dom::array(value)) {
+            string_vector.emplace_back(child);
+          }
+          return string_vector;
+        case dom::element_type::BOOL:
+          for (dom::element child : dom::array(value)) {
+            bool_vector.emplace_back(bool(child));
+          }
+          return bool_vector;
+        case dom::element_type::NULL_VALUE:
+          // Null Values are not allowed, just ignore them
+          break;
+        }
+      }
+      break;
+    }
+    return std::any();
+  }
+
+  void Shard::setPropertiesFromJson(Properties &store, uint64_t row, const dom::object &object) const {
+    // Scalars go straight into their columns, only arrays and objects are built up as a std::any first
+    for (auto[key, value] : object) {
       switch (value.type()) {
       case dom::element_type::INT64:
-        values.insert({ property, int64_t(value) });
+        store.setIntegerProperty(row, key, int64_t(value));
         break;
       case dom::element_type::UINT64:
-        // Unsigned Integer Values are not allowed, convert to signed
-        values.insert({ property, static_cast<std::make_signed_t<uint64_t>>(value) });
+        store.setIntegerProperty(row, key, static_cast<std::make_signed_t<uint64_t>>(value));
         break;
       case dom::element_type::DOUBLE:
-        values.insert({ property, double(value) });
+        store.setDoubleProperty(row, key, double(value));
         break;
       case dom::element_type::STRING:
-        values.insert({ property, std::string(value) });
+        store.setStringProperty(row, key, std::string_view(value));
         break;
       case dom::element_type::BOOL:
-        values.insert({ property, bool(value) });
+        store.setBooleanProperty(row, key, bool(value));
         break;
       case dom::element_type::NULL_VALUE:
-        // Null Values are not allowed, just ignore them
-        break;
-      case dom::element_type::OBJECT: {
-        std::map<std::string, std::any> nested;
-        convertProperties(nested, value);
-        values.insert({ property, nested });
         break;
+      default:
+        std::any property = convertProperty(value);
+        if (property.has_value()) {
+          store.setProperty(row, static_cast<std::string>(key), property);
+        }
       }
-      case dom::element_type::ARRAY:
-        // TODO: Finish this to Support Array properties
-        auto array = dom::array(value);
-        if (array.size() > 0) {
-          dom::element first = array.at(0);
-          std::vector<std::any> any_vector;
-          std::vector<int64_t> int_vector;
-          std::vector<double> double_vector;
-          std::vector<std::string> string_vector;
-          std::vector<bool> bool_vector;
-          std::vector<std::map<std::string, std::any>> object_vector;
-          switch (first.type()) {
-          case dom::element_type::ARRAY:
-            break;
-          case dom::element_type::OBJECT:
-            break;
-          case dom::element_type::INT64:
-            for (dom::element child : dom::array(value)) {
-              int_vector.emplace_back(int64_t(child));
-            }
-            values.insert({ property, int_vector });
-            break;
-          case dom::element_type::UINT64:
-            for (dom::element child : dom::array(value)) {
-              int_vector.emplace_back(static_cast<std::make_signed_t<uint64_t>>(child));
-            }
-            values.insert({ property, int_vector });
-            break;
-          case dom::element_type::DOUBLE:
-            for (dom::element child : dom::array(value)) {
-              double_vector.emplace_back(double(child));
-            }
-            values.insert({ property, double_vector });
-            break;
-          case dom::element_type::STRING:
-            for (dom::element child : dom::array(value)) {
-              string_vector.emplace_back(child);
-            }
-            values.insert({ property, string_vector });
-            break;
-          case dom::element_type::BOOL:
-            for (dom::element child : dom::array(value)) {
-              bool_vector.emplace_back(bool(child));
-            }
-            values.insert({ property, bool_vector });
-            break;
-          case dom::element_type::NULL_VALUE:
-            // Null Values are not allowed, just ignore them
-            break;
-          }
+    }
+  }
+
+  std::vector<std::pair<std::string, Properties::ColumnType>> Shard::CsvHeader(csvmonkey::CsvCursor &row) {
+    // Columns are name:type, where type is int, double or bool and anything else is a string
+    std::vector<std::pair<std::string, Properties::ColumnType>> header;
+    for (size_t i = 0; i < row.count; i++) {
+      std::string name = row.cells[i].as_str();
+      Properties::ColumnType type = Properties::ColumnType::STRING;
+      size_t colon = name.rfind(':');
+      if (colon != std::string::npos) {
+        std::string suffix = name.substr(colon + 1);
+        if (suffix == "int" || suffix == "integer") {
+          type = Properties::ColumnType::INTEGER;
+        } else if (suffix == "double" || suffix == "float") {
+          type = Properties::ColumnType::DOUBLE;
+        } else if (suffix == "bool" || suffix == "boolean") {
+          type = Properties::ColumnType::BOOLEAN;
         }
+        if (suffix == "string" || type != Properties::ColumnType::STRING) {
+          name.resize(colon);
+        }
+      }
+      header.emplace_back(name, type);
+    }
+
+    return header;
+  }
+
+  size_t Shard::CsvColumn(std::vector<std::pair<std::string, Properties::ColumnType>> &header, const std::string &name) {
+    for (size_t i = 0; i < header.size(); i++) {
+      if (header.at(i).first == name && header.at(i).second != Properties::ColumnType::ANY) {
+        // Claim the column so it is not added as a property
+        header.at(i).second = Properties::ColumnType::ANY;
+        return i;
+      }
+    }
+    // Missing column
+    return header.size();
+  }
+
+  std::map<std::string, std::any> Shard::CsvProperties(const std::vector<std::pair<std::string, Properties::ColumnType>> &header, csvmonkey::CsvCursor &row) {
+    std::map<std::string, std::any> values;
+    for (size_t i = 0; i < header.size(); i++) {
+      // Empty cells are missing properties, not empty values
+      if (header.at(i).second == Properties::ColumnType::ANY || row.cells[i].size == 0) {
+        continue;
+      }
+      std::string value = row.cells[i].as_str();
+      switch (header.at(i).second) {
+      case Properties::ColumnType::INTEGER:
+        values.insert({ header.at(i).first, int64_t(std::strtoll(value.c_str(), nullptr, 10)) });
+        break;
+      case Properties::ColumnType::DOUBLE:
+        values.insert({ header.at(i).first, std::strtod(value.c_str(), nullptr) });
         break;
+      case Properties::ColumnType::BOOLEAN:
+        values.insert({ header.at(i).first, value == "true" || value == "1" });
+        break;
+      default:
+        values.insert({ header.at(i).first, value });
       }
     }
+
+    return values;
   }
 
   // All Node Ids
@@ -2951,8 +5989,7 @@ namespace triton {
     int current = 1;
     for (unsigned long i : bitmap) {
       if (current > skip && current <= (skip + limit)) {
-        Node node = nodes.at(externalToInternal(i));
-        some_nodes.push_back(node);
+        some_nodes.push_back(NodeCopy(externalToInternal(i)));
       }
       current++;
     }
@@ -2970,14 +6007,70 @@ namespace triton {
     int current = 1;
     for (unsigned long i : bitmap) {
       if (current > skip && current <= (skip + limit)) {
-        Node node = nodes.at(externalToInternal(i));
-        some_nodes.push_back(node);
+        some_nodes.push_back(NodeCopy(externalToInternal(i)));
       }
       current++;
     }
     return some_nodes;
   }
 
+  std::vector<Node> Shard::AllNodes(const Cursor& cursor, uint64_t limit) {
+    std::vector<Node> some_nodes;
+    // A scan of a read view goes as far as the shard did when it opened, taking what writers saved over what is here now
+    const ReadView *view = nullptr;
+    uint64_t count = nodes.size();
+    if (cursor.view > 0) {
+      view = ReadViewOf(cursor.view);
+      if (view == nullptr) {
+        return some_nodes;
+      }
+      count = view->getNodeCount();
+    }
+    if (cursor.type_id > 0) {
+      // A typed scan walks the ids of its type from where the cursor stopped, so a page costs what it returns.
+      // Nodes removed since the view opened are gone from the ids, so the copies it saved are walked alongside them.
+      const Roaring64Map& ids = node_types.getIdsOf(cursor.type_id);
+      auto live = ids.begin();
+      live.move(internalToExternal(cursor.id + 1));
+      std::vector<uint64_t> saved_ids = view == nullptr ? std::vector<uint64_t>() : view->getNodeIds(cursor.type_id, cursor.id);
+      auto saved_id = saved_ids.begin();
+      while (some_nodes.size() < limit) {
+        uint64_t live_id = live == ids.end() ? count : externalToInternal(*live);
+        uint64_t internal_id = std::min(live_id, saved_id == saved_ids.end() ? count : *saved_id);
+        if (internal_id >= count) {
+          break;
+        }
+        if (live_id == internal_id) {
+          ++live;
+        }
+        if (saved_id != saved_ids.end() && *saved_id == internal_id) {
+          ++saved_id;
+        }
+        const Node *saved = view == nullptr ? nullptr : view->getNode(internal_id);
+        if (saved == nullptr) {
+          some_nodes.push_back(NodeCopy(internal_id));
+        } else if (saved->getId() != 0 && saved->getTypeId() == cursor.type_id) {
+          some_nodes.push_back(*saved);
+        }
+      }
+      return some_nodes;
+    }
+    for (uint64_t internal_id = cursor.id + 1; internal_id < count && some_nodes.size() < limit; internal_id++) {
+      const Node *saved = view == nullptr ? nullptr : view->getNode(internal_id);
+      if (saved == nullptr && internal_id >= nodes.size()) {
+        // Deleted before the view opened and released by the compaction since
+        continue;
+      }
+      const Node& node = saved == nullptr ? nodes.at(internal_id) : *saved;
+      // Deleted nodes are left as the zero node
+      if (node.getId() == 0) {
+        continue;
+      }
+      some_nodes.push_back(saved == nullptr ? NodeCopy(internal_id) : node);
+    }
+    return some_nodes;
+  }
+
   Roaring64Map Shard::AllRelationshipIdsMap() {
     return relationship_types.getIds();
   }
@@ -3037,8 +6130,7 @@ namespace triton {
     int current = 1;
     for (unsigned long i : bitmap) {
       if (current > skip && current <= (skip + limit)) {
-        Relationship relationship = relationships.at(externalToInternal(i));
-        some_relationships.push_back(relationship);
+        some_relationships.push_back(RelationshipCopy(externalToInternal(i)));
       }
       current++;
     }
@@ -3050,20 +6142,77 @@ namespace triton {
     return AllRelationships(type_id, skip, limit);
   }
 
-  std::vector<Relationship> Shard::AllRelationships(uint16_t type_id, uint64_t skip, uint64_t limit) {
+  std::vector<Relationship> Shard::AllRelationships(uint16_t type_id, uint64_t skip, uint64_t limit, NodeProjection projection) {
     std::vector<Relationship> some_relationships;
     Roaring64Map bitmap = relationship_types.getIds(type_id);
     int current = 1;
     for (unsigned long i : bitmap) {
       if (current > skip && current <= (skip + limit)) {
-        Relationship relationship = relationships.at(externalToInternal(i));
-        some_relationships.push_back(relationship);
+        some_relationships.push_back(RelationshipCopy(externalToInternal(i), projection));
       }
       current++;
     }
     return some_relationships;
   }
 
+  std::vector<Relationship> Shard::AllRelationships(const Cursor& cursor, uint64_t limit, NodeProjection projection) {
+    std::vector<Relationship> some_relationships;
+    const ReadView *view = nullptr;
+    uint64_t count = relationships.size();
+    if (cursor.view > 0) {
+      view = ReadViewOf(cursor.view);
+      if (view == nullptr) {
+        return some_relationships;
+      }
+      count = view->getRelationshipCount();
+    }
+    if (cursor.type_id > 0) {
+      // Walks the ids of the type and the copies the view saved of it, the same as a typed scan of nodes
+      const Roaring64Map& ids = relationship_types.getIdsOf(cursor.type_id);
+      auto live = ids.begin();
+      live.move(internalToExternal(cursor.id + 1));
+      std::vector<uint64_t> saved_ids = view == nullptr ? std::vector<uint64_t>() : view->getRelationshipIds(cursor.type_id, cursor.id);
+      auto saved_id = saved_ids.begin();
+      while (some_relationships.size() < limit) {
+        uint64_t live_id = live == ids.end() ? count : externalToInternal(*live);
+        uint64_t internal_id = std::min(live_id, saved_id == saved_ids.end() ? count : *saved_id);
+        if (internal_id >= count) {
+          break;
+        }
+        if (live_id == internal_id) {
+          ++live;
+        }
+        if (saved_id != saved_ids.end() && *saved_id == internal_id) {
+          ++saved_id;
+        }
+        const Relationship *saved = view == nullptr ? nullptr : view->getRelationship(internal_id);
+        if (saved == nullptr) {
+          some_relationships.push_back(RelationshipCopy(internal_id, projection));
+        } else if (saved->getId() != 0 && saved->getTypeId() == cursor.type_id) {
+          some_relationships.push_back(projection == NodeProjection::KEY ? Relationship(saved->getId(), saved->getStartingNodeId(), saved->getEndingNodeId(), saved->getTypeId()) : *saved);
+        }
+      }
+      return some_relationships;
+    }
+    for (uint64_t internal_id = cursor.id + 1; internal_id < count && some_relationships.size() < limit; internal_id++) {
+      const Relationship *saved = view == nullptr ? nullptr : view->getRelationship(internal_id);
+      if (saved == nullptr) {
+        // Only the type array is read until a relationship is kept, deleted slots are left with type 0
+        if (internal_id >= relationships.size() || relationships.getTypeId(internal_id) == 0) {
+          continue;
+        }
+        some_relationships.push_back(RelationshipCopy(internal_id, projection));
+        continue;
+      }
+      // Deleted relationships are saved as the zero relationship
+      if (saved->getId() == 0) {
+        continue;
+      }
+      some_relationships.push_back(projection == NodeProjection::KEY ? Relationship(saved->getId(), saved->getStartingNodeId(), saved->getEndingNodeId(), saved->getTypeId()) : *saved);
+    }
+    return some_relationships;
+  }
+
   // Counts
   std::map<uint16_t, uint64_t> Shard::AllNodeIdCounts() {
     return node_types.getCounts();
@@ -3101,7 +6250,7 @@ namespace triton {
   }
 
   seastar::future<uint64_t> Shard::RelationshipTypesGetCountPeered(uint16_t type_id) {
-    seastar::future<std::vector<uint64_t>> v = container().map([type_id] (Shard &local) {
+    seastar::future<std::vector<uint64_t>> v = PeerMap("RelationshipTypesGetCount", [type_id] (Shard &local) {
            return local.RelationshipTypesGetCount(type_id);
     });
 
@@ -3111,7 +6260,7 @@ namespace triton {
   }
 
   seastar::future<uint64_t> Shard::RelationshipTypesGetCountPeered(const std::string &type) {
-    seastar::future<std::vector<uint64_t>> v = container().map([type] (Shard &local) {
+    seastar::future<std::vector<uint64_t>> v = PeerMap("RelationshipTypesGetCount", [type] (Shard &local) {
            return local.RelationshipTypesGetCount(type);
     });
 
@@ -3125,7 +6274,7 @@ namespace triton {
   }
 
   // Relationship Type ====================================================================================================================
-  std::string Shard::RelationshipTypeGetTypePeered(uint16_t type_id) {
+  const std::string& Shard::RelationshipTypeGetTypePeered(uint16_t type_id) {
     return relationship_types.getType(type_id);
   }
 
@@ -3134,24 +6283,41 @@ namespace triton {
   }
 
   seastar::future<uint16_t> Shard::RelationshipTypeInsertPeered(const std::string &rel_type) {
-    // rel_type_id is global, so we need to calculate it here
     uint16_t rel_type_id = relationship_types.getTypeId(rel_type);
-    if (rel_type_id == 0) {
-      // rel_type_id is global so unfortunately we need to lock here
-      this->rel_type_lock.for_write().lock().get();
-
-      // The relationship type was not found and must therefore be new, add it to all shards.
-      rel_type_id = relationship_types.insertOrGetTypeId(rel_type);
-      this->rel_type_lock.for_write().unlock();
-      return container().invoke_on_all([rel_type, rel_type_id](Shard &local_shard) {
-                          local_shard.RelationshipTypeInsert(rel_type, rel_type_id);
-                        })
-        .then([rel_type_id] {
-          return seastar::make_ready_future<uint16_t>(rel_type_id);
-        });
+    if (rel_type_id > 0) {
+      return seastar::make_ready_future<uint16_t>(rel_type_id);
+    }
+
+    // rel_type_id is global, so only Shard 0 hands them out
+    if (seastar::this_shard_id() != 0) {
+      return PeerOn("RelationshipTypeInsert", 0, [rel_type](Shard &local_shard) {
+        return local_shard.RelationshipTypeInsertPeered(rel_type);
+      });
     }
 
-    return seastar::make_ready_future<uint16_t>(rel_type_id);
+    // New types are handed out one at a time, so ids stay dense and the same type never gets two
+    return seastar::with_semaphore(type_allocation, 1, [rel_type, this] {
+      uint16_t type_id = relationship_types.getTypeId(rel_type);
+      if (type_id > 0) {
+        return seastar::make_ready_future<uint16_t>(type_id);
+      }
+
+      // The slot past the highest id, counting the types would hand out a taken id when there are gaps, 0 once 65535 is used
+      type_id = relationship_types.getNextTypeId();
+      if (type_id == 0) {
+        return seastar::make_ready_future<uint16_t>(uint16_t(0));
+      }
+      return PeerOnAll("RelationshipTypeInsert", [rel_type, type_id](Shard &local_shard) {
+          // Shard 0 goes last so the type is known everywhere before anyone is told its id
+          if (seastar::this_shard_id() != 0) {
+            local_shard.RelationshipTypeInsert(rel_type, type_id);
+          }
+        })
+        .then([rel_type, type_id, this] {
+          RelationshipTypeInsert(rel_type, type_id);
+          return seastar::make_ready_future<uint16_t>(type_id);
+        });
+    });
   }
 
   // Node Types ===========================================================================================================================
@@ -3160,7 +6326,7 @@ namespace triton {
   }
 
   seastar::future<uint64_t> Shard::NodeTypesGetCountPeered(uint16_t type_id) {
-    seastar::future<std::vector<uint64_t>> v = container().map([type_id] (Shard &local) {
+    seastar::future<std::vector<uint64_t>> v = PeerMap("NodeTypesGetCount", [type_id] (Shard &local) {
            return local.NodeTypesGetCount(type_id);
     });
 
@@ -3170,7 +6336,7 @@ namespace triton {
   }
 
   seastar::future<uint64_t> Shard::NodeTypesGetCountPeered(const std::string &type) {
-    seastar::future<std::vector<uint64_t>> v = container().map([type] (Shard &local) {
+    seastar::future<std::vector<uint64_t>> v = PeerMap("NodeTypesGetCount", [type] (Shard &local) {
            return local.NodeTypesGetCount(type);
     });
 
@@ -3184,7 +6350,7 @@ namespace triton {
   }
 
   // Node Type ===========================================================================================================================
-  std::string Shard::NodeTypeGetTypePeered(uint16_t type_id) {
+  const std::string& Shard::NodeTypeGetTypePeered(uint16_t type_id) {
     return node_types.getType(type_id);
   }
 
@@ -3194,21 +6360,40 @@ namespace triton {
 
   seastar::future<uint16_t> Shard::NodeTypeInsertPeered(const std::string &type) {
     uint16_t node_type_id = node_types.getTypeId(type);
-    if (node_type_id == 0) {
-      // node_type_id is global so unfortunately we need to lock here
-      this->node_type_lock.for_write().lock().get();
-      // The node type was not found and must therefore be new, add it to all shards.
-      node_type_id = node_types.insertOrGetTypeId(type);
-      return container().invoke_on_all([type, node_type_id](Shard &local_shard) {
-                          local_shard.NodeTypeInsert(type, node_type_id);
-                        })
-        .then([node_type_id, this] {
-          this->node_type_lock.for_write().unlock();
-          return seastar::make_ready_future<uint16_t>(node_type_id);
-        });
+    if (node_type_id > 0) {
+      return seastar::make_ready_future<uint16_t>(node_type_id);
+    }
+
+    // node_type_id is global, so only Shard 0 hands them out
+    if (seastar::this_shard_id() != 0) {
+      return PeerOn("NodeTypeInsert", 0, [type](Shard &local_shard) {
+        return local_shard.NodeTypeInsertPeered(type);
+      });
     }
 
-    return seastar::make_ready_future<uint16_t>(node_type_id);
+    // New types are handed out one at a time, so ids stay dense and the same type never gets two
+    return seastar::with_semaphore(type_allocation, 1, [type, this] {
+      uint16_t type_id = node_types.getTypeId(type);
+      if (type_id > 0) {
+        return seastar::make_ready_future<uint16_t>(type_id);
+      }
+
+      // The slot past the highest id, counting the types would hand out a taken id when there are gaps, 0 once 65535 is used
+      type_id = node_types.getNextTypeId();
+      if (type_id == 0) {
+        return seastar::make_ready_future<uint16_t>(uint16_t(0));
+      }
+      return PeerOnAll("NodeTypeInsert", [type, type_id](Shard &local_shard) {
+          // Shard 0 goes last so the type is known everywhere before anyone is told its id
+          if (seastar::this_shard_id() != 0) {
+            local_shard.NodeTypeInsert(type, type_id);
+          }
+        })
+        .then([type, type_id, this] {
+          NodeTypeInsert(type, type_id);
+          return seastar::make_ready_future<uint16_t>(type_id);
+        });
+    });
   }
 
   // Nodes ===============================================================================================================================
@@ -3219,15 +6404,15 @@ namespace triton {
 
     // The node type exists, so continue on
     if (node_type_id > 0) {
-        return container().invoke_on(node_shard_id, [type, node_type_id, key](Shard &local_shard) {
+        return PeerOn("NodeAddEmpty", node_shard_id, [type, node_type_id, key](Shard &local_shard) {
             return local_shard.NodeAddEmpty(type, node_type_id, key);
         });
     }
 
     // The node type needs to be set by Shard 0 and propagated
-    return container().invoke_on(0, [node_shard_id, type, key, this] (Shard &local_shard) {
+    return PeerOn("NodeAddEmpty", 0, [node_shard_id, type, key, this] (Shard &local_shard) {
       return local_shard.NodeTypeInsertPeered(type).then([node_shard_id, type, key, this] (uint16_t node_type_id) {
-        return container().invoke_on(node_shard_id, [type, node_type_id, key](Shard &local_shard) {
+        return PeerOn("NodeAddEmpty", node_shard_id, [type, node_type_id, key](Shard &local_shard) {
           return local_shard.NodeAddEmpty(type, node_type_id, key);
         });
       });
@@ -3241,15 +6426,15 @@ namespace triton {
 
     // The node type exists, so continue on
     if (node_type_id > 0) {
-      return container().invoke_on(node_shard_id, [type, node_type_id, key, properties](Shard &local_shard) {
+      return PeerOn("NodeAdd", node_shard_id, [type, node_type_id, key, properties](Shard &local_shard) {
         return local_shard.NodeAdd(type, node_type_id, key, properties);
       });
     }
 
     // The node type needs to be set by Shard 0 and propagated
-    return container().invoke_on(0, [node_shard_id, type, key, properties, this](Shard &local_shard) {
+    return PeerOn("NodeAdd", 0, [node_shard_id, type, key, properties, this](Shard &local_shard) {
       return local_shard.NodeTypeInsertPeered(type).then([node_shard_id, type, key, properties, this](uint16_t node_type_id) {
-        return container().invoke_on(node_shard_id, [type, node_type_id, key, properties](Shard &local_shard) {
+        return PeerOn("NodeAdd", node_shard_id, [type, node_type_id, key, properties](Shard &local_shard) {
           return local_shard.NodeAdd(type, node_type_id, key, properties);
         });
       });
@@ -3257,6 +6442,126 @@ namespace triton {
 
   }
 
+  seastar::future<std::vector<uint64_t>> Shard::NodesAddPeered(std::vector<std::tuple<std::string, std::string, std::map<std::string, std::any>>> rows) {
+    return seastar::async([rows = std::move(rows), this] () mutable {
+      // Node types are global, so any new ones are inserted by Shard 0 before the nodes are added
+      std::set<std::string> new_types;
+      for (const auto &row : rows) {
+        if (node_types.getTypeId(std::get<0>(row)) == 0) {
+          new_types.insert(std::get<0>(row));
+        }
+      }
+
+      for (const auto &type : new_types) {
+        PeerOn("NodesAdd", 0, [type] (Shard &local_shard) {
+          return local_shard.NodeTypeInsertPeered(type);
+        }).get();
+      }
+
+      // Send each shard all of its nodes in one message
+      std::vector<std::vector<std::tuple<std::string, std::string, std::map<std::string, std::any>>>> sharded_rows(cpus);
+      std::vector<std::vector<size_t>> sharded_positions(cpus);
+      for (size_t position = 0; position < rows.size(); position++) {
+        uint16_t node_shard_id = CalculateShardId(std::get<0>(rows.at(position)), std::get<1>(rows.at(position)));
+        sharded_rows.at(node_shard_id).emplace_back(std::move(rows.at(position)));
+        sharded_positions.at(node_shard_id).emplace_back(position);
+      }
+
+      std::vector<uint16_t> node_shard_ids;
+      std::vector<seastar::future<std::vector<uint64_t>>> futures;
+      for (int i = 0; i < cpus; i++) {
+        if (!sharded_rows.at(i).empty()) {
+          node_shard_ids.emplace_back(i);
+          futures.push_back(PeerOn("NodesAdd", i, [batch = std::move(sharded_rows.at(i))] (Shard &local_shard) {
+            return local_shard.NodesAdd(batch);
+          }));
+        }
+      }
+
+      auto p = make_shared(std::move(futures));
+      std::vector<std::vector<uint64_t>> results = seastar::when_all_succeed(p->begin(), p->end()).get0();
+
+      // Put the ids back in the order the nodes were given
+      std::vector<uint64_t> ids(rows.size(), 0);
+      for (size_t i = 0; i < node_shard_ids.size(); i++) {
+        for (size_t j = 0; j < results.at(i).size(); j++) {
+          ids.at(sharded_positions.at(node_shard_ids.at(i)).at(j)) = results.at(i).at(j);
+        }
+      }
+
+      return ids;
+    });
+  }
+
+  seastar::future<std::vector<uint64_t>> Shard::NodesAddFromJsonPeered(const std::string &json) {
+    // An array of { "type": ..., "key": ..., "properties": { ... } } objects
+    std::vector<std::tuple<std::string, std::string, std::map<std::string, std::any>>> rows;
+    dom::array array;
+    if (Shard::parser.parse(json).get(array)) {
+      // Invalid JSON
+      return seastar::make_ready_future<std::vector<uint64_t>>(std::vector<uint64_t>());
+    }
+
+    rows.reserve(array.size());
+    for (dom::element element : array) {
+      dom::object object;
+      std::string_view type;
+      std::string_view key;
+      if (element.get(object) || object["type"].get(type) || object["key"].get(key)) {
+        // Missing type or key
+        return seastar::make_ready_future<std::vector<uint64_t>>(std::vector<uint64_t>());
+      }
+      std::map<std::string, std::any> values;
+      dom::object properties;
+      if (!object["properties"].get(properties)) {
+        convertProperties(values, properties);
+      }
+      rows.emplace_back(std::string(type), std::string(key), std::move(values));
+    }
+
+    return NodesAddPeered(std::move(rows));
+  }
+
+  seastar::future<std::vector<uint64_t>> Shard::NodeGetIDsPeered(std::vector<std::pair<std::string, std::string>> keys) {
+    return seastar::async([keys = std::move(keys), this] () {
+      // Ask each shard for all of its nodes in one message
+      std::vector<std::vector<std::pair<std::string, std::string>>> sharded_keys(cpus);
+      std::vector<std::vector<size_t>> sharded_positions(cpus);
+      for (size_t position = 0; position < keys.size(); position++) {
+        // Skip keys of types that do not exist
+        if (node_types.getTypeId(keys.at(position).first) > 0) {
+          uint16_t node_shard_id = CalculateShardId(keys.at(position).first, keys.at(position).second);
+          sharded_keys.at(node_shard_id).emplace_back(keys.at(position));
+          sharded_positions.at(node_shard_id).emplace_back(position);
+        }
+      }
+
+      std::vector<uint16_t> node_shard_ids;
+      std::vector<seastar::future<std::vector<uint64_t>>> futures;
+      for (int i = 0; i < cpus; i++) {
+        if (!sharded_keys.at(i).empty()) {
+          node_shard_ids.emplace_back(i);
+          futures.push_back(PeerOn("NodeGetIDs", i, [batch = std::move(sharded_keys.at(i))] (Shard &local_shard) {
+            return local_shard.NodeGetIDs(batch);
+          }));
+        }
+      }
+
+      auto p = make_shared(std::move(futures));
+      std::vector<std::vector<uint64_t>> results = seastar::when_all_succeed(p->begin(), p->end()).get0();
+
+      // Put the ids back in the order the keys were given
+      std::vector<uint64_t> ids(keys.size(), 0);
+      for (size_t i = 0; i < node_shard_ids.size(); i++) {
+        for (size_t j = 0; j < results.at(i).size(); j++) {
+          ids.at(sharded_positions.at(node_shard_ids.at(i)).at(j)) = results.at(i).at(j);
+        }
+      }
+
+      return ids;
+    });
+  }
+
   seastar::future<uint64_t> Shard::NodeGetIDPeered(const std::string &type, const std::string &key) {
     // Check if the type even exists
     if (node_types.getTypeId(type) > 0) {
@@ -3266,7 +6571,7 @@ namespace triton {
         return seastar::make_ready_future<uint64_t>(NodeGetID(type, key));
       }
 
-      return container().invoke_on(node_shard_id, [type, key](Shard &local_shard) {
+      return PeerOn("NodeGetID", node_shard_id, [type, key](Shard &local_shard) {
              return local_shard.NodeGetID(type, key);
       });
     }
@@ -3282,7 +6587,7 @@ namespace triton {
       return seastar::make_ready_future<Node>(NodeGet(type, key));
     }
 
-    return container().invoke_on(node_shard_id, [type, key](Shard &local_shard) {
+    return PeerOn("NodeGet", node_shard_id, [type, key](Shard &local_shard) {
            return local_shard.NodeGet(type, key);
     });
   }
@@ -3294,7 +6599,7 @@ namespace triton {
       return seastar::make_ready_future<Node>(NodeGet(id));
     }
 
-    return container().invoke_on(node_shard_id, [id](Shard &local_shard) {
+    return PeerOn("NodeGet", node_shard_id, [id](Shard &local_shard) {
            return local_shard.NodeGet(id);
     });
   }
@@ -3307,7 +6612,7 @@ namespace triton {
       return NodeRemovePeered(external_id);
     }
 
-    return container().invoke_on(node_shard_id, [type, key] (Shard &local_shard) {
+    return PeerOn("NodeRemove", node_shard_id, [type, key] (Shard &local_shard) {
            return local_shard.NodeGetID(type, key);
     }).then([this] (uint64_t external_id) {
            return NodeRemovePeered(external_id);
@@ -3317,18 +6622,18 @@ namespace triton {
   seastar::future<bool> Shard::NodeRemovePeered(uint64_t external_id) {
     uint16_t node_shard_id = CalculateShardId(external_id);
 
-    return container().invoke_on(node_shard_id, [external_id](Shard &local_shard) {
+    return PeerOn("NodeRemove", node_shard_id, [external_id](Shard &local_shard) {
            return local_shard.ValidNodeId(external_id);
     }).then([node_shard_id, external_id, this] (bool valid) {
            if(valid) {
              uint64_t internal_id = externalToInternal(external_id);
 
-             seastar::future<std::vector<bool>> incoming = container().invoke_on(node_shard_id, [internal_id] (Shard &local_shard) {
+             seastar::future<std::vector<bool>> incoming = PeerOn("NodeRemove", node_shard_id, [internal_id] (Shard &local_shard) {
                     return local_shard.NodeRemoveGetIncoming(internal_id);
              }).then([external_id, this] (auto sharded_grouped_rels) {
                     std::vector<seastar::future<bool>> futures;
                     for (auto const& [their_shard, grouped_rels] : sharded_grouped_rels ) {
-                      auto future = container().invoke_on(their_shard, [external_id, grouped_rels = std::move(grouped_rels)] (Shard &local_shard) {
+                      auto future = PeerOn("NodeRemove", their_shard, [external_id, grouped_rels = std::move(grouped_rels)] (Shard &local_shard) {
                              return local_shard.NodeRemoveDeleteIncoming(external_id, grouped_rels);
                       });
                       futures.push_back(std::move(future));
@@ -3338,31 +6643,206 @@ namespace triton {
                     return seastar::when_all_succeed(p->begin(), p->end());
              });
 
-             seastar::future<std::vector<bool>> outgoing = container().invoke_on(shard_id, [internal_id] (Shard &local_shard) {
+             seastar::future<std::vector<bool>> outgoing = PeerOn("NodeRemove", node_shard_id, [internal_id] (Shard &local_shard) {
                     return local_shard.NodeRemoveGetOutgoing(internal_id);
              }).then([external_id, this] (auto sharded_grouped_rels) {
                     std::vector<seastar::future<bool>> futures;
                     for (auto const& [their_shard, grouped_rels] : sharded_grouped_rels ) {
-                      auto future = container().invoke_on(their_shard, [external_id, grouped_rels = grouped_rels] (Shard &local_shard) {
+                      auto future = PeerOn("NodeRemove", their_shard, [external_id, grouped_rels = grouped_rels] (Shard &local_shard) {
                              return local_shard.NodeRemoveDeleteOutgoing(external_id, grouped_rels);
                       });
                       futures.push_back(std::move(future));
                     }
 
-                    auto p = make_shared(std::move(futures));
-                    return seastar::when_all_succeed(p->begin(), p->end());
-             });
+                    auto p = make_shared(std::move(futures));
+                    return seastar::when_all_succeed(p->begin(), p->end());
+             });
+
+             return seastar::when_all(std::move(incoming), std::move(outgoing)).then([node_shard_id, external_id, this] (auto tup) {
+                    if(std::get<0>(tup).failed() || std::get<1>(tup).failed()) {
+                      return seastar::make_ready_future<bool>(false);
+                    }
+                    return PeerOn("NodeRemove", node_shard_id, [external_id] (Shard &local_shard) {
+                           return local_shard.NodeRemove(external_id);
+                    });
+             });
+           }
+           return seastar::make_ready_future<bool>(false);
+    });
+  }
+
+  seastar::future<uint64_t> Shard::NodesRemovePeered(const std::vector<uint64_t>& ids) {
+    std::map<uint16_t, std::vector<uint64_t>> sharded_ids;
+    for (uint64_t id : ids) {
+      sharded_ids[CalculateShardId(id)].push_back(id);
+    }
+
+    return PeerScatter<uint64_t>("NodesRemove", std::move(sharded_ids), [] (Shard &local_shard, const std::vector<uint64_t>& part) {
+             return local_shard.NodesRemoveLocal(part).then([] (uint64_t removed) {
+                    return std::vector<uint64_t>({ removed });
+             });
+      }).then([] (std::vector<uint64_t> removed) {
+             uint64_t count = 0;
+             for (uint64_t shard_removed : removed) {
+               count += shard_removed;
+             }
+             return count;
+      });
+  }
+
+  seastar::future<uint64_t> Shard::NodesRemoveForTypePeered(const std::string& type) {
+    return PeerMapReduce("NodesRemove", [type] (Shard &local_shard) {
+           Roaring64Map ids = local_shard.AllNodeIdsMap(type);
+           return local_shard.NodesRemoveLocal(std::vector<uint64_t>(ids.begin(), ids.end()));
+    }, uint64_t(0), std::plus<uint64_t>());
+  }
+
+  seastar::future<uint64_t> Shard::NodeMovePeered(const std::string &type, const std::string &key, uint8_t node_shard_id) {
+    // Moves go one at a time through Shard 0, two connected nodes moving together would each drop the relationship between them
+    if (seastar::this_shard_id() != 0) {
+      return PeerOn("NodeMove", 0, [type, key, node_shard_id] (Shard &local_shard) {
+        return local_shard.NodeMovePeered(type, key, node_shard_id);
+      });
+    }
+
+    return seastar::with_semaphore(node_moves, 1, [type, key, node_shard_id, this] {
+      return NodeMoveLocked(type, key, node_shard_id);
+    });
+  }
+
+  seastar::future<uint64_t> Shard::NodeMoveLocked(const std::string &type, const std::string &key, uint8_t node_shard_id) {
+    return seastar::async([type, key, node_shard_id, this] () {
+      if (node_shard_id >= cpus) {
+        return uint64_t(0);
+      }
+      uint64_t old_id = NodeGetIDPeered(type, key).get0();
+      uint8_t old_shard_id = CalculateShardId(type, key);
+      if (old_id == 0 || old_shard_id == node_shard_id) {
+        return old_id;
+      }
+
+      // Nothing can change the node from here on, so the copy taken next is the one that arrives
+      auto block = [this] (std::vector<uint64_t> ids, bool blocked) {
+        PeerOnAll("NodeMove", [ids, blocked] (Shard &local_shard) {
+          for (uint64_t id : ids) {
+            if (blocked) {
+              local_shard.NodeWritesBlock(id);
+            } else {
+              local_shard.NodeWritesUnblock(id);
+            }
+          }
+        }).get();
+      };
+      block({old_id}, true);
+
+      Node node = NodeGetPeered(old_id).get0();
+      // Relationships to itself show up on both sides
+      std::vector<Relationship> relationships_to_move;
+      std::set<uint64_t> seen;
+      for (auto &relationship : NodeGetRelationshipsPeered(old_id).get0()) {
+        if (seen.insert(relationship.getId()).second) {
+          relationships_to_move.emplace_back(std::move(relationship));
+        }
+      }
+
+      // Add it to its new shard first, a move that fails there leaves the node where it was
+      uint64_t new_id = node.getId() == 0 ? 0 : PeerOn("NodeMove", node_shard_id, [type, type_id = node.getTypeId(), key, properties = node.getProperties()] (Shard &local_shard) {
+        return local_shard.NodeAdd(type, type_id, key, properties);
+      }).get0();
+      if (new_id == 0) {
+        block({old_id}, false);
+        return uint64_t(0);
+      }
+      block({new_id}, true);
+
+      // The copy gets the relationships with new ids, on the shard of their starting node as always,
+      // while the old node still has its own. Anything that goes wrong takes the copy out again
+      std::vector<uint64_t> added;
+      auto undo = [&added, old_id, new_id, &block, this] () {
+        for (uint64_t rel_id : added) {
+          RelationshipRemovePeered(rel_id).get();
+        }
+        NodeRemovePeered(new_id).get();
+        block({old_id, new_id}, false);
+        return uint64_t(0);
+      };
+
+      std::vector<std::vector<std::tuple<uint16_t, uint64_t, uint64_t, std::map<std::string, std::any>>>> sharded_outgoing(cpus);
+      std::vector<std::vector<std::tuple<uint16_t, uint64_t, uint64_t>>> sharded_ends(cpus);
+      for (auto &relationship : relationships_to_move) {
+        uint64_t id1 = relationship.getStartingNodeId() == old_id ? new_id : relationship.getStartingNodeId();
+        uint64_t id2 = relationship.getEndingNodeId() == old_id ? new_id : relationship.getEndingNodeId();
+        uint16_t shard_id1 = CalculateShardId(id1);
+        sharded_outgoing.at(shard_id1).emplace_back(relationship.getTypeId(), id1, id2, relationship.getProperties());
+        sharded_ends.at(shard_id1).emplace_back(relationship.getTypeId(), id1, id2);
+      }
+
+      std::vector<uint16_t> outgoing_shard_ids;
+      std::vector<seastar::future<std::vector<uint64_t>>> futures;
+      for (int i = 0; i < cpus; i++) {
+        if (!sharded_outgoing.at(i).empty()) {
+          outgoing_shard_ids.emplace_back(i);
+          futures.push_back(PeerOn("NodeMove", i, [batch = std::move(sharded_outgoing.at(i))] (Shard &local_shard) {
+            return local_shard.RelationshipsMoveToOutgoing(batch);
+          }));
+        }
+      }
+
+      auto p = make_shared(std::move(futures));
+      std::vector<std::vector<uint64_t>> results = seastar::when_all_succeed(p->begin(), p->end()).get0();
+
+      // Then add them to the incoming side of their ending nodes, once every one of them made it to the outgoing side
+      bool complete = true;
+      std::vector<std::vector<std::tuple<uint16_t, uint64_t, uint64_t, uint64_t>>> sharded_incoming(cpus);
+      for (size_t i = 0; i < outgoing_shard_ids.size(); i++) {
+        const auto &ends = sharded_ends.at(outgoing_shard_ids.at(i));
+        for (size_t j = 0; j < results.at(i).size(); j++) {
+          uint64_t rel_id = results.at(i).at(j);
+          if (rel_id == 0) {
+            complete = false;
+            continue;
+          }
+          added.emplace_back(rel_id);
+          auto [rel_type_id, id1, id2] = ends.at(j);
+          sharded_incoming.at(CalculateShardId(id2)).emplace_back(rel_type_id, rel_id, id1, id2);
+        }
+      }
+      if (!complete) {
+        return undo();
+      }
+
+      std::vector<seastar::future<bool>> incoming_futures;
+      for (int i = 0; i < cpus; i++) {
+        if (!sharded_incoming.at(i).empty()) {
+          incoming_futures.push_back(PeerOn("NodeMove", i, [batch = std::move(sharded_incoming.at(i))] (Shard &local_shard) {
+            return local_shard.RelationshipsAddToIncoming(batch);
+          }));
+        }
+      }
 
-             return seastar::when_all(std::move(incoming), std::move(outgoing)).then([node_shard_id, external_id, this] (auto tup) {
-                    if(std::get<0>(tup).failed() || std::get<1>(tup).failed()) {
-                      return seastar::make_ready_future<bool>(false);
-                    }
-                    return container().invoke_on(node_shard_id, [external_id] (Shard &local_shard) {
-                           return local_shard.NodeRemove(external_id);
-                    });
-             });
-           }
-           return seastar::make_ready_future<bool>(false);
+      auto p2 = make_shared(std::move(incoming_futures));
+      for (bool valid : seastar::when_all_succeed(p2->begin(), p2->end()).get0()) {
+        complete = complete && valid;
+      }
+      if (!complete) {
+        return undo();
+      }
+
+      // Only now pin it to its new shard everywhere and take out the old one, putting the pin back when it was removed along the way
+      PeerOnAll("NodeMove", [type, key, node_shard_id] (Shard &local_shard) {
+        local_shard.NodePlace(type, key, node_shard_id);
+      }).get();
+      if (!NodeRemovePeered(old_id).get0()) {
+        PeerOnAll("NodeMove", [type, key, old_shard_id] (Shard &local_shard) {
+          local_shard.NodePlace(type, key, old_shard_id);
+        }).get();
+        // Its relationships go with it
+        added.clear();
+        return undo();
+      }
+
+      block({old_id, new_id}, false);
+      return new_id;
     });
   }
 
@@ -3373,7 +6853,7 @@ namespace triton {
       return seastar::make_ready_future<uint16_t>(NodeGetTypeId(id));
     }
 
-    return container().invoke_on(node_shard_id, [id](Shard &local_shard) {
+    return PeerOn("NodeGetTypeId", node_shard_id, [id](Shard &local_shard) {
            return local_shard.NodeGetTypeId(id);
     });
   }
@@ -3385,14 +6865,14 @@ namespace triton {
       return seastar::make_ready_future<std::string>(NodeGetType(id));
     }
 
-    return container().invoke_on(node_shard_id, [id](Shard &local_shard) {
+    return PeerOn("NodeGetType", node_shard_id, [id](Shard &local_shard) {
            return local_shard.NodeGetType(id);
     });
   }
 
   seastar::future<std::string> Shard::NodeGetKeyPeered(uint64_t id) {
     uint16_t node_shard_id = CalculateShardId(id);
-    return container().invoke_on(node_shard_id, [id](Shard &local_shard) {
+    return PeerOn("NodeGetKey", node_shard_id, [id](Shard &local_shard) {
            return local_shard.NodeGetKey(id);
     });
   }
@@ -3405,7 +6885,7 @@ namespace triton {
       return seastar::make_ready_future<std::any>(NodePropertyGet(type, key, property));
     }
 
-    return container().invoke_on(node_shard_id, [type, key, property](Shard &local_shard) {
+    return PeerOn("NodePropertyGet", node_shard_id, [type, key, property](Shard &local_shard) {
            return local_shard.NodePropertyGet(type, key, property);
     });
   }
@@ -3417,7 +6897,7 @@ namespace triton {
       return seastar::make_ready_future<std::string>(NodePropertyGetString(type, key, property));
     }
 
-    return container().invoke_on(node_shard_id, [type, key, property](Shard &local_shard) {
+    return PeerOn("NodePropertyGetString", node_shard_id, [type, key, property](Shard &local_shard) {
            return local_shard.NodePropertyGetString(type, key, property);
     });
   }
@@ -3429,7 +6909,7 @@ namespace triton {
       return seastar::make_ready_future<int64_t>(NodePropertyGetInteger(type, key, property));
     }
 
-    return container().invoke_on(node_shard_id, [type, key, property](Shard &local_shard) {
+    return PeerOn("NodePropertyGetInteger", node_shard_id, [type, key, property](Shard &local_shard) {
            return local_shard.NodePropertyGetInteger(type, key, property);
     });
   }
@@ -3441,7 +6921,7 @@ namespace triton {
       return seastar::make_ready_future<double>(NodePropertyGetDouble(type, key, property));
     }
 
-    return container().invoke_on(node_shard_id, [type, key, property](Shard &local_shard) {
+    return PeerOn("NodePropertyGetDouble", node_shard_id, [type, key, property](Shard &local_shard) {
            return local_shard.NodePropertyGetDouble(type, key, property);
     });
   }
@@ -3453,7 +6933,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(NodePropertyGetBoolean(type, key, property));
     }
 
-    return container().invoke_on(node_shard_id, [type, key, property](Shard &local_shard) {
+    return PeerOn("NodePropertyGetBoolean", node_shard_id, [type, key, property](Shard &local_shard) {
            return local_shard.NodePropertyGetBoolean(type, key, property);
     });
   }
@@ -3465,7 +6945,7 @@ namespace triton {
       return seastar::make_ready_future<std::map<std::string, std::any>>(NodePropertyGetObject(type, key, property));
     }
 
-    return container().invoke_on(node_shard_id, [type, key, property](Shard &local_shard) {
+    return PeerOn("NodePropertyGetBoolean", node_shard_id, [type, key, property](Shard &local_shard) {
            return local_shard.NodePropertyGetObject(type, key, property);
     });
   }
@@ -3477,7 +6957,7 @@ namespace triton {
       return seastar::make_ready_future<std::any>(NodePropertyGet(id, property));
     }
 
-    return container().invoke_on(node_shard_id, [id, property](Shard &local_shard) {
+    return PeerOn("NodePropertyGet", node_shard_id, [id, property](Shard &local_shard) {
            return local_shard.NodePropertyGet(id, property);
     });
   }
@@ -3489,7 +6969,7 @@ namespace triton {
       return seastar::make_ready_future<std::string>(NodePropertyGetString(id, property));
     }
 
-    return container().invoke_on(node_shard_id, [id, property](Shard &local_shard) {
+    return PeerOn("NodePropertyGetString", node_shard_id, [id, property](Shard &local_shard) {
            return local_shard.NodePropertyGetString(id, property);
     });
   }
@@ -3501,7 +6981,7 @@ namespace triton {
       return seastar::make_ready_future<int64_t>(NodePropertyGetInteger(id, property));
     }
 
-    return container().invoke_on(node_shard_id, [id, property](Shard &local_shard) {
+    return PeerOn("NodePropertyGetInteger", node_shard_id, [id, property](Shard &local_shard) {
            return local_shard.NodePropertyGetInteger(id, property);
     });
   }
@@ -3513,7 +6993,7 @@ namespace triton {
       return seastar::make_ready_future<double>(NodePropertyGetDouble(id, property));
     }
 
-    return container().invoke_on(node_shard_id, [id, property](Shard &local_shard) {
+    return PeerOn("NodePropertyGetDouble", node_shard_id, [id, property](Shard &local_shard) {
            return local_shard.NodePropertyGetDouble(id, property);
     });
   }
@@ -3525,7 +7005,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(NodePropertyGetBoolean(id, property));
     }
 
-    return container().invoke_on(node_shard_id, [id, property](Shard &local_shard) {
+    return PeerOn("NodePropertyGetBoolean", node_shard_id, [id, property](Shard &local_shard) {
            return local_shard.NodePropertyGetBoolean(id, property);
     });
   }
@@ -3537,7 +7017,7 @@ namespace triton {
       return seastar::make_ready_future<std::map<std::string, std::any>>(NodePropertyGetObject(id, property));
     }
 
-    return container().invoke_on(node_shard_id, [id, property](Shard &local_shard) {
+    return PeerOn("NodePropertyGetBoolean", node_shard_id, [id, property](Shard &local_shard) {
            return local_shard.NodePropertyGetObject(id, property);
     });
   }
@@ -3549,7 +7029,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(NodePropertySet(type, key, property, value));
     }
 
-    return container().invoke_on(node_shard_id, [type, key, property, value](Shard &local_shard) {
+    return PeerOn("NodePropertySet", node_shard_id, [type, key, property, value](Shard &local_shard) {
            return local_shard.NodePropertySet(type, key, property, value);
     });
   }
@@ -3561,7 +7041,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(NodePropertySet(type, key, property, value));
     }
 
-    return container().invoke_on(node_shard_id, [type, key, property, value](Shard &local_shard) {
+    return PeerOn("NodePropertySet", node_shard_id, [type, key, property, value](Shard &local_shard) {
            return local_shard.NodePropertySet(type, key, property, value);
     });
   }
@@ -3573,7 +7053,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(NodePropertySet(type, key, property, value));
     }
 
-    return container().invoke_on(node_shard_id, [type, key, property, value](Shard &local_shard) {
+    return PeerOn("NodePropertySet", node_shard_id, [type, key, property, value](Shard &local_shard) {
            return local_shard.NodePropertySet(type, key, property, value);
     });
   }
@@ -3585,7 +7065,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(NodePropertySet(type, key, property, value));
     }
 
-    return container().invoke_on(node_shard_id, [type, key, property, value](Shard &local_shard) {
+    return PeerOn("NodePropertySet", node_shard_id, [type, key, property, value](Shard &local_shard) {
            return local_shard.NodePropertySet(type, key, property, value);
     });;
   }
@@ -3597,7 +7077,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(NodePropertySet(type, key, property, value));
     }
 
-    return container().invoke_on(node_shard_id, [type, key, property, value](Shard &local_shard) {
+    return PeerOn("NodePropertySet", node_shard_id, [type, key, property, value](Shard &local_shard) {
            return local_shard.NodePropertySet(type, key, property, value);
     });
   }
@@ -3609,7 +7089,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(NodePropertySet(type, key, property, value));
     }
 
-    return container().invoke_on(node_shard_id, [type, key, property, value](Shard &local_shard) {
+    return PeerOn("NodePropertySet", node_shard_id, [type, key, property, value](Shard &local_shard) {
            return local_shard.NodePropertySet(type, key, property, value);
     });
   }
@@ -3621,7 +7101,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(NodePropertySetFromJson(type, key, property, value));
     }
 
-    return container().invoke_on(node_shard_id, [type, key, property, value](Shard &local_shard) {
+    return PeerOn("NodePropertySetFromJson", node_shard_id, [type, key, property, value](Shard &local_shard) {
            return local_shard.NodePropertySetFromJson(type, key, property, value);
     });
   }
@@ -3633,7 +7113,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(NodePropertySet(id, property, value));
     }
 
-    return container().invoke_on(node_shard_id, [id, property, value](Shard &local_shard) {
+    return PeerOn("NodePropertySet", node_shard_id, [id, property, value](Shard &local_shard) {
            return local_shard.NodePropertySet(id, property, value);
     });
   }
@@ -3645,7 +7125,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(NodePropertiesDelete(type, key));
     }
 
-    return container().invoke_on(node_shard_id, [type, key](Shard &local_shard) {
+    return PeerOn("NodePropertiesDelete", node_shard_id, [type, key](Shard &local_shard) {
            return local_shard.NodePropertiesDelete(type, key);
     });
   }
@@ -3657,7 +7137,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(NodePropertySet(id, property, value));
     }
 
-    return container().invoke_on(node_shard_id, [id, property, value](Shard &local_shard) {
+    return PeerOn("NodePropertySet", node_shard_id, [id, property, value](Shard &local_shard) {
            return local_shard.NodePropertySet(id, property, value);
     });
   }
@@ -3669,7 +7149,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(NodePropertySet(id, property, value));
     }
 
-    return container().invoke_on(node_shard_id, [id, property, value](Shard &local_shard) {
+    return PeerOn("NodePropertySet", node_shard_id, [id, property, value](Shard &local_shard) {
            return local_shard.NodePropertySet(id, property, value);
     });
   }
@@ -3681,7 +7161,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(NodePropertySet(id, property, value));
     }
 
-    return container().invoke_on(node_shard_id, [id, property, value](Shard &local_shard) {
+    return PeerOn("NodePropertySet", node_shard_id, [id, property, value](Shard &local_shard) {
            return local_shard.NodePropertySet(id, property, value);
     });
   }
@@ -3693,7 +7173,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(NodePropertySet(id, property, value));
     }
 
-    return container().invoke_on(node_shard_id, [id, property, value](Shard &local_shard) {
+    return PeerOn("NodePropertySet", node_shard_id, [id, property, value](Shard &local_shard) {
            return local_shard.NodePropertySet(id, property, value);
     });
   }
@@ -3705,7 +7185,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(NodePropertySet(id, property, value));
     }
 
-    return container().invoke_on(node_shard_id, [id, property, value](Shard &local_shard) {
+    return PeerOn("NodePropertySet", node_shard_id, [id, property, value](Shard &local_shard) {
            return local_shard.NodePropertySet(id, property, value);
     });
   }
@@ -3717,7 +7197,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(NodePropertySetFromJson(id, property, value));
     }
 
-    return container().invoke_on(node_shard_id, [id, property, value](Shard &local_shard) {
+    return PeerOn("NodePropertySetFromJson", node_shard_id, [id, property, value](Shard &local_shard) {
            return local_shard.NodePropertySetFromJson(id, property, value);
     });
   }
@@ -3729,7 +7209,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(NodePropertyDelete(type, key, property));
     }
 
-    return container().invoke_on(node_shard_id, [type, key, property](Shard &local_shard) {
+    return PeerOn("NodePropertyDelete", node_shard_id, [type, key, property](Shard &local_shard) {
            return local_shard.NodePropertyDelete(type, key, property);
     });
   }
@@ -3742,7 +7222,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(NodePropertyDelete(id, property));
     }
 
-    return container().invoke_on(node_shard_id, [id, property](Shard &local_shard) {
+    return PeerOn("NodePropertyDelete", node_shard_id, [id, property](Shard &local_shard) {
            return local_shard.NodePropertyDelete(id, property);
     });
   }
@@ -3754,7 +7234,7 @@ namespace triton {
       return seastar::make_ready_future<std::map<std::string, std::any>>(NodePropertiesGet(type, key));
     }
 
-    return container().invoke_on(node_shard_id, [type, key](Shard &local_shard) {
+    return PeerOn("NodePropertyDelete", node_shard_id, [type, key](Shard &local_shard) {
            return local_shard.NodePropertiesGet(type, key);
     });
   }
@@ -3766,7 +7246,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(NodePropertiesSet(type, key, value));
     }
 
-    return container().invoke_on(node_shard_id, [type, key, value](Shard &local_shard) mutable {
+    return PeerOn("NodePropertiesSet", node_shard_id, [type, key, value](Shard &local_shard) mutable {
            return local_shard.NodePropertiesSet(type, key, value);
     });
   }
@@ -3778,7 +7258,7 @@ namespace triton {
       return seastar::make_ready_future<std::map<std::string, std::any>>(NodePropertiesGet(id));
     }
 
-    return container().invoke_on(node_shard_id, [id](Shard &local_shard) {
+    return PeerOn("NodePropertiesSet", node_shard_id, [id](Shard &local_shard) {
            return local_shard.NodePropertiesGet(id);
     });
   }
@@ -3790,7 +7270,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(NodePropertiesSet(id, value));
     }
 
-    return container().invoke_on(node_shard_id, [id, value](Shard &local_shard) mutable {
+    return PeerOn("NodePropertiesSet", node_shard_id, [id, value](Shard &local_shard) mutable {
            return local_shard.NodePropertiesSet(id, value);
     });
   }
@@ -3802,7 +7282,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(NodePropertiesSetFromJson(type, key, value));
     }
 
-    return container().invoke_on(node_shard_id, [type, key, value](Shard &local_shard) {
+    return PeerOn("NodePropertiesSetFromJson", node_shard_id, [type, key, value](Shard &local_shard) {
            return local_shard.NodePropertiesSetFromJson(type, key, value);
     });
   }
@@ -3814,7 +7294,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(NodePropertiesReset(id, value));
     }
 
-    return container().invoke_on(node_shard_id, [id, value](Shard &local_shard) {
+    return PeerOn("NodePropertiesReset", node_shard_id, [id, value](Shard &local_shard) {
            return local_shard.NodePropertiesReset(id, value);
     });
   }
@@ -3826,7 +7306,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(NodePropertiesResetFromJson(type, key, value));
     }
 
-    return container().invoke_on(node_shard_id, [type, key, value](Shard &local_shard) {
+    return PeerOn("NodePropertiesResetFromJson", node_shard_id, [type, key, value](Shard &local_shard) {
            return local_shard.NodePropertiesResetFromJson(type, key, value);
     });
   }
@@ -3838,7 +7318,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(NodePropertiesResetFromJson(id, value));
     }
 
-    return container().invoke_on(node_shard_id, [id, value](Shard &local_shard) {
+    return PeerOn("NodePropertiesResetFromJson", node_shard_id, [id, value](Shard &local_shard) {
            return local_shard.NodePropertiesResetFromJson(id, value);
     });
   }
@@ -3850,7 +7330,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(NodePropertiesSetFromJson(id, value));
     }
 
-    return container().invoke_on(node_shard_id, [id, value](Shard &local_shard) {
+    return PeerOn("NodePropertiesSetFromJson", node_shard_id, [id, value](Shard &local_shard) {
            return local_shard.NodePropertiesSetFromJson(id, value);
     });
   }
@@ -3862,11 +7342,173 @@ namespace triton {
       return seastar::make_ready_future<bool>(NodePropertiesDelete(id));
     }
 
-    return container().invoke_on(node_shard_id, [id](Shard &local_shard) {
+    return PeerOn("NodePropertiesDelete", node_shard_id, [id](Shard &local_shard) {
            return local_shard.NodePropertiesDelete(id);
     });
   }
 
+  // Node Property Indexes
+  seastar::future<bool> Shard::NodePropertyIndexCreatePeered(const std::string &type, const std::string &property, PropertyIndex::IndexType index_type) {
+    // Every shard indexes the nodes it holds
+    return PeerMap("NodePropertyIndexCreate", [type, property, index_type] (Shard &local_shard) {
+             return local_shard.NodePropertyIndexCreate(type, property, index_type);
+      })
+      .then([] (const std::vector<bool>& results) {
+             return std::all_of(std::begin(results), std::end(results), [] (bool created) { return created; });
+      });
+  }
+
+  seastar::future<bool> Shard::NodePropertyIndexDropPeered(const std::string &type, const std::string &property) {
+    return PeerMap("NodePropertyIndexDrop", [type, property] (Shard &local_shard) {
+             return local_shard.NodePropertyIndexDrop(type, property);
+      })
+      .then([] (const std::vector<bool>& results) {
+             return std::all_of(std::begin(results), std::end(results), [] (bool dropped) { return dropped; });
+      });
+  }
+
+  seastar::future<Roaring64Map> Shard::NodePropertyIndexFindPeered(const std::string &type, const std::string &property, const std::any &value) {
+    return PeerMap("NodePropertyIndexFind", [type, property, value] (Shard &local_shard) {
+             return local_shard.NodePropertyIndexFind(type, property, value);
+      })
+      .then([] (const std::vector<Roaring64Map>& results) {
+             Roaring64Map combined;
+             for (const Roaring64Map& sharded : results) {
+               combined |= sharded;
+             }
+             return combined;
+      });
+  }
+
+  seastar::future<Roaring64Map> Shard::NodePropertyIndexFindRangePeered(const std::string &type, const std::string &property, const std::any &min, const std::any &max) {
+    return PeerMap("NodePropertyIndexFindRange", [type, property, min, max] (Shard &local_shard) {
+             return local_shard.NodePropertyIndexFindRange(type, property, min, max);
+      })
+      .then([] (const std::vector<Roaring64Map>& results) {
+             Roaring64Map combined;
+             for (const Roaring64Map& sharded : results) {
+               combined |= sharded;
+             }
+             return combined;
+      });
+  }
+
+  // Node Property Aggregates
+  seastar::future<Aggregate> Shard::NodesAggregatePeered(const std::string &type, const std::vector<ScanFilter> &filters, const std::string &property) {
+    return PeerMapReduce("NodesAggregate", [type, filters, property] (Shard &local_shard) {
+             return local_shard.NodesAggregate(type, filters, property);
+      },
+      Aggregate(),
+      [] (Aggregate combined, const Aggregate& sharded) {
+             combined.merge(sharded);
+             return combined;
+      });
+  }
+
+  seastar::future<Aggregate> Shard::NodesAggregatePeered(const std::string &query) {
+    // { "type": "...", "property": "...", "filters": [{ "property": "...", "op": ">", "value": ... }, ...] }
+    dom::object object;
+    std::string_view type;
+    if (parser.parse(query).get(object) || object["type"].get(type)) {
+      return seastar::make_ready_future<Aggregate>();
+    }
+
+    std::string_view property;
+    if (object["property"].get(property)) {
+      property = "";
+    }
+
+    std::vector<ScanFilter> filters;
+    if (!convertFilters(object, filters)) {
+      return seastar::make_ready_future<Aggregate>();
+    }
+
+    return NodesAggregatePeered(std::string(type), filters, std::string(property));
+  }
+
+  // Node Vectors
+  seastar::future<bool> Shard::NodeVectorPropertyCreatePeered(const std::string &type, const std::string &property, uint32_t dimensions) {
+    // Every shard keeps the vectors of the nodes it holds
+    return PeerMap("NodeVectorPropertyCreate", [type, property, dimensions] (Shard &local_shard) {
+             return local_shard.NodeVectorPropertyCreate(type, property, dimensions);
+      })
+      .then([] (const std::vector<bool>& results) {
+             return std::all_of(std::begin(results), std::end(results), [] (bool created) { return created; });
+      });
+  }
+
+  seastar::future<std::vector<Neighbor>> Shard::NodesNearestPeered(const std::string &type, const std::string &property, const std::vector<float> &query, uint64_t k,
+                                                                   VectorMetric metric, const std::vector<ScanFilter> &filters) {
+    return PeerMapReduce("NodesNearest", [type, property, query, k, metric, filters] (Shard &local_shard) {
+             return local_shard.NodesNearest(type, property, query, k, metric, filters);
+      },
+      NearestNeighbors(k),
+      [] (NearestNeighbors combined, const std::vector<Neighbor>& sharded) {
+             combined.merge(sharded);
+             return combined;
+      })
+      .then([] (const NearestNeighbors& combined) {
+             return combined.sorted();
+      });
+  }
+
+  seastar::future<std::vector<Neighbor>> Shard::NodesNearestPeered(const Roaring64Map &ids, const std::string &property, const std::vector<float> &query, uint64_t k,
+                                                                   VectorMetric metric) {
+    // Each shard only has the vectors of its own nodes
+    std::map<uint16_t, Roaring64Map> sharded_nodes_ids;
+    for (uint64_t id : ids) {
+      sharded_nodes_ids[CalculateShardId(id)].add(id);
+    }
+
+    return PeerScatter<Neighbor>("NodeIdsMapNearest", std::move(sharded_nodes_ids), [property, query, k, metric] (Shard &local_shard, const Roaring64Map& part) {
+             return local_shard.NodesNearest(part, property, query, k, metric);
+      })
+      .then([k] (const std::vector<Neighbor>& sharded) {
+             NearestNeighbors combined(k);
+             combined.merge(sharded);
+             return combined.sorted();
+      });
+  }
+
+  seastar::future<std::vector<Neighbor>> Shard::NodesNearestPeered(const std::string &query) {
+    // { "type": "...", "property": "...", "vector": [...], "k": 10, "metric": "cosine", "filters": [...] }
+    dom::object object;
+    std::string_view type;
+    std::string_view property;
+    dom::array vector_array;
+    if (parser.parse(query).get(object) || object["type"].get(type) || object["property"].get(property) || object["vector"].get(vector_array)) {
+      return seastar::make_ready_future<std::vector<Neighbor>>();
+    }
+
+    std::vector<float> vector;
+    vector.reserve(vector_array.size());
+    for (dom::element element : vector_array) {
+      double value;
+      if (element.get(value)) {
+        return seastar::make_ready_future<std::vector<Neighbor>>();
+      }
+      vector.push_back(static_cast<float>(value));
+    }
+
+    uint64_t k;
+    if (object["k"].get(k)) {
+      k = 10;
+    }
+
+    VectorMetric metric = VectorMetric::COSINE;
+    std::string_view metric_name;
+    if (!object["metric"].get(metric_name) && !toVectorMetric(metric_name, metric)) {
+      return seastar::make_ready_future<std::vector<Neighbor>>();
+    }
+
+    std::vector<ScanFilter> filters;
+    if (!convertFilters(object, filters)) {
+      return seastar::make_ready_future<std::vector<Neighbor>>();
+    }
+
+    return NodesNearestPeered(std::string(type), std::string(property), vector, k, metric, filters);
+  }
+
   // Relationships ==========================================================================================================================
   seastar::future<uint64_t> Shard::RelationshipAddEmptyPeered(const std::string &rel_type, const std::string &type1, const std::string &key1, const std::string &type2, const std::string &key2) {
     uint16_t shard_id1 = CalculateShardId(type1, key1);
@@ -3876,17 +7518,17 @@ namespace triton {
     // The rel type exists, continue on
     if (rel_type_id > 0) {
       if(shard_id1 == shard_id2) {
-        return container().invoke_on(shard_id1, [rel_type_id, type1, key1, type2, key2](Shard &local_shard) {
+        return PeerOn("RelationshipAddEmpty", shard_id1, [rel_type_id, type1, key1, type2, key2](Shard &local_shard) {
           return local_shard.RelationshipAddEmptySameShard(rel_type_id, type1, key1, type2, key2);
         });
       }
 
       // Get node id1, get node id 2 and call add Empty with ids
-      seastar::future<uint64_t> getId1 = container().invoke_on(shard_id1, [type1, key1](Shard &local_shard) {
+      seastar::future<uint64_t> getId1 = PeerOn("RelationshipAddEmpty", shard_id1, [type1, key1](Shard &local_shard) {
         return local_shard.NodeGetID(type1, key1);
       });
 
-      seastar::future<uint64_t> getId2 = container().invoke_on(shard_id2, [type2, key2](Shard &local_shard) {
+      seastar::future<uint64_t> getId2 = PeerOn("RelationshipAddEmpty", shard_id2, [type2, key2](Shard &local_shard) {
         return local_shard.NodeGetID(type2, key2);
       });
 
@@ -3906,21 +7548,25 @@ namespace triton {
     }
 
     // The relationship type needs to be set by Shard 0 and propagated
-    return container().invoke_on(0, [shard_id1, shard_id2, rel_type, type1, key1, type2, key2, this] (Shard &local_shard) {
+    return PeerOn("RelationshipAddEmpty", 0, [shard_id1, shard_id2, rel_type, type1, key1, type2, key2, this] (Shard &local_shard) {
            return local_shard.RelationshipTypeInsertPeered(rel_type)
         .then([shard_id1, shard_id2, rel_type, type1, key1, type2, key2, this] (uint16_t rel_type_id) {
+           // No type ids are left
+           if (rel_type_id == 0) {
+             return seastar::make_ready_future<uint64_t>(uint64_t(0));
+           }
            if(shard_id1 == shard_id2) {
-             return container().invoke_on(shard_id1, [rel_type_id, type1, key1, type2, key2](Shard &local_shard) {
+             return PeerOn("RelationshipAddEmpty", shard_id1, [rel_type_id, type1, key1, type2, key2](Shard &local_shard) {
                     return local_shard.RelationshipAddEmptySameShard(rel_type_id, type1, key1, type2, key2);
              });
            }
 
            // Get node id1, get node id 2 and call add Empty with ids
-           seastar::future<uint64_t> getId1 = container().invoke_on(shard_id1, [type1, key1](Shard &local_shard) {
+           seastar::future<uint64_t> getId1 = PeerOn("RelationshipAddEmpty", shard_id1, [type1, key1](Shard &local_shard) {
                   return local_shard.NodeGetID(type1, key1);
            });
 
-           seastar::future<uint64_t> getId2 = container().invoke_on(shard_id2, [type2, key2](Shard &local_shard) {
+           seastar::future<uint64_t> getId2 = PeerOn("RelationshipAddEmpty", shard_id2, [type2, key2](Shard &local_shard) {
                   return local_shard.NodeGetID(type2, key2);
            });
 
@@ -3952,17 +7598,17 @@ namespace triton {
     // The rel type exists, continue on
     if (rel_type_id > 0) {
       if(shard_id1 == shard_id2) {
-        return container().invoke_on(shard_id1, [rel_type_id, type1, key1, type2, key2, properties](Shard &local_shard) {
+        return PeerOn("RelationshipAdd", shard_id1, [rel_type_id, type1, key1, type2, key2, properties](Shard &local_shard) {
                return local_shard.RelationshipAddSameShard(rel_type_id, type1, key1, type2, key2, properties);
         });
       }
 
       // Get node id1, get node id 2 and call add Empty with ids
-      seastar::future<uint64_t> getId1 = container().invoke_on(shard_id1, [type1, key1](Shard &local_shard) {
+      seastar::future<uint64_t> getId1 = PeerOn("RelationshipAdd", shard_id1, [type1, key1](Shard &local_shard) {
              return local_shard.NodeGetID(type1, key1);
       });
 
-      seastar::future<uint64_t> getId2 = container().invoke_on(shard_id2, [type2, key2](Shard &local_shard) {
+      seastar::future<uint64_t> getId2 = PeerOn("RelationshipAdd", shard_id2, [type2, key2](Shard &local_shard) {
              return local_shard.NodeGetID(type2, key2);
       });
 
@@ -3982,21 +7628,25 @@ namespace triton {
     }
 
     // The relationship type needs to be set by Shard 0 and propagated
-    return container().invoke_on(0, [shard_id1, shard_id2, rel_type, type1, key1, type2, key2, properties, this] (Shard &local_shard) {
+    return PeerOn("RelationshipAdd", 0, [shard_id1, shard_id2, rel_type, type1, key1, type2, key2, properties, this] (Shard &local_shard) {
          return local_shard.RelationshipTypeInsertPeered(rel_type)
            .then([shard_id1, shard_id2, rel_type, type1, key1, type2, key2, properties, this] (uint16_t rel_type_id) {
+              // No type ids are left
+              if (rel_type_id == 0) {
+                return seastar::make_ready_future<uint64_t>(uint64_t(0));
+              }
               if(shard_id1 == shard_id2) {
-                return container().invoke_on(shard_id1, [rel_type_id, type1, key1, type2, key2, properties](Shard &local_shard) {
+                return PeerOn("RelationshipAdd", shard_id1, [rel_type_id, type1, key1, type2, key2, properties](Shard &local_shard) {
                        return local_shard.RelationshipAddSameShard(rel_type_id, type1, key1, type2, key2, properties);
                 });
               }
 
               // Get node id1, get node id 2 and call add Empty with ids
-              seastar::future<uint64_t> getId1 = container().invoke_on(shard_id1, [type1, key1](Shard &local_shard) {
+              seastar::future<uint64_t> getId1 = PeerOn("RelationshipAdd", shard_id1, [type1, key1](Shard &local_shard) {
                 return local_shard.NodeGetID(type1, key1);
               });
 
-              seastar::future<uint64_t> getId2 = container().invoke_on(shard_id2, [type2, key2](Shard &local_shard) {
+              seastar::future<uint64_t> getId2 = PeerOn("RelationshipAdd", shard_id2, [type2, key2](Shard &local_shard) {
                 return local_shard.NodeGetID(type2, key2);
               });
 
@@ -4025,7 +7675,7 @@ namespace triton {
     // The rel type exists, continue on
     if (rel_type_id > 0) {
       if (shard_id1 == shard_id2) {
-        return container().invoke_on(shard_id1, [rel_type_id, id1, id2](Shard &local_shard) {
+        return PeerOn("RelationshipAddEmpty", shard_id1, [rel_type_id, id1, id2](Shard &local_shard) {
           return local_shard.RelationshipAddEmptySameShard(rel_type_id, id1, id2);
         });
       }
@@ -4033,21 +7683,25 @@ namespace triton {
       return RelationshipAddEmptyPeered(rel_type_id, id1, id2);
     }
     // The relationship type needs to be set by Shard 0 and propagated
-    return container().invoke_on(0, [shard_id1, shard_id2, rel_type, id1, id2, this](Shard &local_shard) {
+    return PeerOn("RelationshipAddEmpty", 0, [shard_id1, shard_id2, rel_type, id1, id2, this](Shard &local_shard) {
       return local_shard.RelationshipTypeInsertPeered(rel_type)
         .then([shard_id1, shard_id2, rel_type, id1, id2, this](uint16_t rel_type_id) {
+          // No type ids are left
+          if (rel_type_id == 0) {
+            return seastar::make_ready_future<uint64_t>(uint64_t(0));
+          }
           if (shard_id1 == shard_id2) {
-            return container().invoke_on(shard_id1, [rel_type_id, id1, id2](Shard &local_shard) {
+            return PeerOn("RelationshipAddEmpty", shard_id1, [rel_type_id, id1, id2](Shard &local_shard) {
               return local_shard.RelationshipAddEmptySameShard(rel_type_id, id1, id2);
             });
           }
 
           // Get node id1, get node id 2 and call add Empty with ids
-          seastar::future<bool> validateId1 = container().invoke_on(shard_id1, [id1](Shard &local_shard) {
+          seastar::future<bool> validateId1 = PeerOn("RelationshipAddEmpty", shard_id1, [id1](Shard &local_shard) {
             return local_shard.ValidNodeId(id1);
           });
 
-          seastar::future<bool> validateId2 = container().invoke_on(shard_id2, [id2](Shard &local_shard) {
+          seastar::future<bool> validateId2 = PeerOn("RelationshipAddEmpty", shard_id2, [id2](Shard &local_shard) {
             return local_shard.ValidNodeId(id2);
           });
 
@@ -4060,10 +7714,10 @@ namespace triton {
           return seastar::when_all_succeed(p->begin(), p->end())
             .then([rel_type_id, shard_id1, shard_id2, id1, id2, this](const std::vector<bool>& valid) {
               if (valid.at(0) && valid.at(1)) {
-                return container().invoke_on(shard_id1, [rel_type_id, shard_id2, id1, id2, this](Shard &local_shard) {
+                return PeerOn("RelationshipAddEmpty", shard_id1, [rel_type_id, shard_id2, id1, id2, this](Shard &local_shard) {
                   return seastar::make_ready_future<uint64_t>(local_shard.RelationshipAddEmptyToOutgoing(rel_type_id, id1, id2))
                     .then([rel_type_id, shard_id2, id1, id2, this](uint64_t rel_id) {
-                      return container().invoke_on(shard_id2, [rel_type_id, id1, id2, rel_id](Shard &local_shard) {
+                      return PeerOn("RelationshipAddEmpty", shard_id2, [rel_type_id, id1, id2, rel_id](Shard &local_shard) {
                         return local_shard.RelationshipAddToIncoming(rel_type_id, rel_id, id1, id2);
                       });
                     });
@@ -4084,7 +7738,7 @@ namespace triton {
     // The rel type exists, continue on
     if (rel_type_id > 0) {
       if (shard_id1 == shard_id2) {
-        return container().invoke_on(shard_id1, [rel_type_id, id1, id2, properties](Shard &local_shard) {
+        return PeerOn("RelationshipAdd", shard_id1, [rel_type_id, id1, id2, properties](Shard &local_shard) {
                return local_shard.RelationshipAddSameShard(rel_type_id, id1, id2, properties);
         });
       }
@@ -4093,21 +7747,25 @@ namespace triton {
     }
 
     // The relationship type needs to be set by Shard 0 and propagated
-    return container().invoke_on(0, [shard_id1, shard_id2, rel_type, id1, id2, properties, this](Shard &local_shard) {
+    return PeerOn("RelationshipAdd", 0, [shard_id1, shard_id2, rel_type, id1, id2, properties, this](Shard &local_shard) {
            return local_shard.RelationshipTypeInsertPeered(rel_type)
              .then([shard_id1, shard_id2, rel_type, id1, id2, properties, this](uint16_t rel_type_id) {
+                    // No type ids are left
+                    if (rel_type_id == 0) {
+                      return seastar::make_ready_future<uint64_t>(uint64_t(0));
+                    }
                     if (shard_id1 == shard_id2) {
-                      return container().invoke_on(shard_id1, [rel_type_id, id1, id2, properties](Shard &local_shard) {
+                      return PeerOn("RelationshipAdd", shard_id1, [rel_type_id, id1, id2, properties](Shard &local_shard) {
                              return local_shard.RelationshipAddSameShard(rel_type_id, id1, id2, properties);
                       });
                     }
 
                     // Get node id1, get node id 2 and call add Empty with ids
-                    seastar::future<bool> validateId1 = container().invoke_on(shard_id1, [id1](Shard &local_shard) {
+                    seastar::future<bool> validateId1 = PeerOn("RelationshipAdd", shard_id1, [id1](Shard &local_shard) {
                            return local_shard.ValidNodeId(id1);
                     });
 
-                    seastar::future<bool> validateId2 = container().invoke_on(shard_id2, [id2](Shard &local_shard) {
+                    seastar::future<bool> validateId2 = PeerOn("RelationshipAdd", shard_id2, [id2](Shard &local_shard) {
                            return local_shard.ValidNodeId(id2);
                     });
 
@@ -4120,10 +7778,10 @@ namespace triton {
                     return seastar::when_all_succeed(p->begin(), p->end())
                       .then([rel_type_id, shard_id1, shard_id2, id1, id2, properties, this](const std::vector<bool>& valid) {
                          if (valid.at(0) && valid.at(1)) {
-                           return container().invoke_on(shard_id1, [rel_type_id, shard_id2, id1, id2, properties, this](Shard &local_shard) {
+                           return PeerOn("RelationshipAdd", shard_id1, [rel_type_id, shard_id2, id1, id2, properties, this](Shard &local_shard) {
                               return seastar::make_ready_future<uint64_t>(local_shard.RelationshipAddToOutgoing(rel_type_id, id1, id2, properties))
                                 .then([rel_type_id, shard_id2, id1, id2, this](uint64_t rel_id) {
-                                   return container().invoke_on(shard_id2, [rel_type_id, id1, id2, rel_id](Shard &local_shard) {
+                                   return PeerOn("RelationshipAdd", shard_id2, [rel_type_id, id1, id2, rel_id](Shard &local_shard) {
                                       return local_shard.RelationshipAddToIncoming(rel_type_id, rel_id, id1, id2);
                                    });
                                 });
@@ -4142,11 +7800,11 @@ namespace triton {
 
     if (relationship_types.ValidTypeId(rel_type_id)) {
     // Get node id1, get node id 2 and call add Empty with ids
-    seastar::future<bool> validateId1 = container().invoke_on(shard_id1, [id1] (Shard &local_shard) {
+    seastar::future<bool> validateId1 = PeerOn("RelationshipAddEmpty", shard_id1, [id1] (Shard &local_shard) {
            return local_shard.ValidNodeId(id1);
     });
 
-    seastar::future<bool> validateId2 = container().invoke_on(shard_id2, [id2] (Shard &local_shard) {
+    seastar::future<bool> validateId2 = PeerOn("RelationshipAddEmpty", shard_id2, [id2] (Shard &local_shard) {
            return local_shard.ValidNodeId(id2);
     });
 
@@ -4159,10 +7817,10 @@ namespace triton {
     return seastar::when_all_succeed(p->begin(), p->end())
       .then([rel_type_id, shard_id1, shard_id2, id1, id2, this] (const std::vector<bool>& valid) {
              if(valid.at(0) && valid.at(1)) {
-               return container().invoke_on(shard_id1, [rel_type_id, shard_id2, id1, id2, this] (Shard &local_shard) {
+               return PeerOn("RelationshipAddEmpty", shard_id1, [rel_type_id, shard_id2, id1, id2, this] (Shard &local_shard) {
                       return seastar::make_ready_future<uint64_t>(local_shard.RelationshipAddEmptyToOutgoing(rel_type_id, id1, id2))
                         .then([rel_type_id, shard_id2, id1, id2, this] (uint64_t rel_id) {
-                               return container().invoke_on(shard_id2, [rel_type_id, id1, id2, rel_id] (Shard &local_shard) {
+                               return PeerOn("RelationshipAddEmpty", shard_id2, [rel_type_id, id1, id2, rel_id] (Shard &local_shard) {
                                       return local_shard.RelationshipAddToIncoming(rel_type_id, rel_id, id1, id2);
                                });
                         });
@@ -4182,11 +7840,11 @@ namespace triton {
     uint16_t shard_id2 = CalculateShardId(id2);
     if (relationship_types.ValidTypeId(rel_type_id)) {
       // Get node id1, get node id 2 and call add with ids
-      seastar::future<bool> validateId1 = container().invoke_on(shard_id1, [id1](Shard &local_shard) {
+      seastar::future<bool> validateId1 = PeerOn("RelationshipAdd", shard_id1, [id1](Shard &local_shard) {
         return local_shard.ValidNodeId(id1);
       });
 
-      seastar::future<bool> validateId2 = container().invoke_on(shard_id2, [id2](Shard &local_shard) {
+      seastar::future<bool> validateId2 = PeerOn("RelationshipAdd", shard_id2, [id2](Shard &local_shard) {
         return local_shard.ValidNodeId(id2);
       });
 
@@ -4199,10 +7857,10 @@ namespace triton {
       return seastar::when_all_succeed(p->begin(), p->end())
         .then([rel_type_id, shard_id1, shard_id2, properties, id1, id2, this](const std::vector<bool> valid) {
           if (valid.at(0) && valid.at(1)) {
-            return container().invoke_on(shard_id1, [rel_type_id, shard_id2, id1, id2, properties, this](Shard &local_shard) {
+            return PeerOn("RelationshipAdd", shard_id1, [rel_type_id, shard_id2, id1, id2, properties, this](Shard &local_shard) {
               return seastar::make_ready_future<uint64_t>(local_shard.RelationshipAddToOutgoing(rel_type_id, id1, id2, properties))
                 .then([rel_type_id, shard_id2, id1, id2, this](uint64_t rel_id) {
-                  return container().invoke_on(shard_id2, [rel_type_id, id1, id2, rel_id](Shard &local_shard) {
+                  return PeerOn("RelationshipAdd", shard_id2, [rel_type_id, id1, id2, rel_id](Shard &local_shard) {
                     return local_shard.RelationshipAddToIncoming(rel_type_id, rel_id, id1, id2);
                   });
                 });
@@ -4217,6 +7875,127 @@ namespace triton {
     return seastar::make_ready_future<uint64_t>(uint64_t(0));
   }
 
+  seastar::future<std::vector<uint64_t>> Shard::RelationshipsAddPeered(std::vector<std::tuple<std::string, std::string, std::string, std::string, std::string, std::map<std::string, std::any>>> rows) {
+    return seastar::async([rows = std::move(rows), this] () mutable {
+      // Relationship types are global, so any new ones are inserted by Shard 0 before the relationships are added
+      std::set<std::string> new_types;
+      for (const auto &row : rows) {
+        if (relationship_types.getTypeId(std::get<0>(row)) == 0) {
+          new_types.insert(std::get<0>(row));
+        }
+      }
+
+      for (const auto &rel_type : new_types) {
+        PeerOn("RelationshipsAdd", 0, [rel_type] (Shard &local_shard) {
+          return local_shard.RelationshipTypeInsertPeered(rel_type);
+        }).get();
+      }
+
+      // Look up the starting and ending node of every relationship together
+      std::vector<std::pair<std::string, std::string>> keys;
+      keys.reserve(2 * rows.size());
+      for (const auto &row : rows) {
+        keys.emplace_back(std::get<1>(row), std::get<2>(row));
+        keys.emplace_back(std::get<3>(row), std::get<4>(row));
+      }
+      std::vector<uint64_t> node_ids = NodeGetIDsPeered(std::move(keys)).get0();
+
+      // The relationship belongs to the shard of its starting node, send each shard all of its relationships in one message
+      std::vector<uint16_t> rel_type_ids(rows.size(), 0);
+      std::vector<std::vector<std::tuple<uint16_t, uint64_t, uint64_t, std::map<std::string, std::any>>>> sharded_outgoing(cpus);
+      std::vector<std::vector<size_t>> sharded_positions(cpus);
+      for (size_t position = 0; position < rows.size(); position++) {
+        uint64_t id1 = node_ids.at(2 * position);
+        uint64_t id2 = node_ids.at(2 * position + 1);
+        rel_type_ids.at(position) = relationship_types.getTypeId(std::get<0>(rows.at(position)));
+        if (rel_type_ids.at(position) > 0 && id1 > 0 && id2 > 0) {
+          uint16_t shard_id1 = CalculateShardId(id1);
+          sharded_outgoing.at(shard_id1).emplace_back(rel_type_ids.at(position), id1, id2, std::move(std::get<5>(rows.at(position))));
+          sharded_positions.at(shard_id1).emplace_back(position);
+        }
+      }
+
+      std::vector<uint16_t> outgoing_shard_ids;
+      std::vector<seastar::future<std::vector<uint64_t>>> futures;
+      for (int i = 0; i < cpus; i++) {
+        if (!sharded_outgoing.at(i).empty()) {
+          outgoing_shard_ids.emplace_back(i);
+          futures.push_back(PeerOn("RelationshipsAdd", i, [batch = std::move(sharded_outgoing.at(i))] (Shard &local_shard) {
+            return local_shard.RelationshipsAddToOutgoing(batch);
+          }));
+        }
+      }
+
+      auto p = make_shared(std::move(futures));
+      std::vector<std::vector<uint64_t>> results = seastar::when_all_succeed(p->begin(), p->end()).get0();
+
+      // Put the ids back in the order the relationships were given
+      std::vector<uint64_t> ids(rows.size(), 0);
+      for (size_t i = 0; i < outgoing_shard_ids.size(); i++) {
+        for (size_t j = 0; j < results.at(i).size(); j++) {
+          ids.at(sharded_positions.at(outgoing_shard_ids.at(i)).at(j)) = results.at(i).at(j);
+        }
+      }
+
+      // Then add the relationships to the incoming side of their ending nodes
+      std::vector<std::vector<std::tuple<uint16_t, uint64_t, uint64_t, uint64_t>>> sharded_incoming(cpus);
+      for (size_t position = 0; position < rows.size(); position++) {
+        if (ids.at(position) > 0) {
+          uint64_t id1 = node_ids.at(2 * position);
+          uint64_t id2 = node_ids.at(2 * position + 1);
+          sharded_incoming.at(CalculateShardId(id2)).emplace_back(rel_type_ids.at(position), ids.at(position), id1, id2);
+        }
+      }
+
+      std::vector<seastar::future<bool>> incoming_futures;
+      for (int i = 0; i < cpus; i++) {
+        if (!sharded_incoming.at(i).empty()) {
+          incoming_futures.push_back(PeerOn("RelationshipsAdd", i, [batch = std::move(sharded_incoming.at(i))] (Shard &local_shard) {
+            return local_shard.RelationshipsAddToIncoming(batch);
+          }));
+        }
+      }
+
+      auto p2 = make_shared(std::move(incoming_futures));
+      seastar::when_all_succeed(p2->begin(), p2->end()).get0();
+
+      return ids;
+    });
+  }
+
+  seastar::future<std::vector<uint64_t>> Shard::RelationshipsAddFromJsonPeered(const std::string &json) {
+    // An array of { "rel_type": ..., "type": ..., "key": ..., "type2": ..., "key2": ..., "properties": { ... } } objects
+    std::vector<std::tuple<std::string, std::string, std::string, std::string, std::string, std::map<std::string, std::any>>> rows;
+    dom::array array;
+    if (Shard::parser.parse(json).get(array)) {
+      // Invalid JSON
+      return seastar::make_ready_future<std::vector<uint64_t>>(std::vector<uint64_t>());
+    }
+
+    rows.reserve(array.size());
+    for (dom::element element : array) {
+      dom::object object;
+      std::string_view rel_type;
+      std::string_view type1;
+      std::string_view key1;
+      std::string_view type2;
+      std::string_view key2;
+      if (element.get(object) || object["rel_type"].get(rel_type) || object["type"].get(type1) || object["key"].get(key1)
+          || object["type2"].get(type2) || object["key2"].get(key2)) {
+        // Missing relationship type or node
+        return seastar::make_ready_future<std::vector<uint64_t>>(std::vector<uint64_t>());
+      }
+      std::map<std::string, std::any> values;
+      dom::object properties;
+      if (!object["properties"].get(properties)) {
+        convertProperties(values, properties);
+      }
+      rows.emplace_back(std::string(rel_type), std::string(type1), std::string(key1), std::string(type2), std::string(key2), std::move(values));
+    }
+
+    return RelationshipsAddPeered(std::move(rows));
+  }
+
   seastar::future<Relationship> Shard::RelationshipGetPeered(uint64_t id) {
     uint16_t rel_shard_id = CalculateShardId(id);
 
@@ -4224,7 +8003,7 @@ namespace triton {
       return seastar::make_ready_future<Relationship>(RelationshipGet(id));
     }
 
-    return container().invoke_on(rel_shard_id, [id] (Shard &local_shard) {
+    return PeerOn("RelationshipGet", rel_shard_id, [id] (Shard &local_shard) {
            return local_shard.RelationshipGet(id);
     });
   }
@@ -4232,17 +8011,17 @@ namespace triton {
   seastar::future<bool> Shard::RelationshipRemovePeered(uint64_t external_id) {
     uint16_t rel_shard_id = CalculateShardId(external_id);
 
-    return container().invoke_on(rel_shard_id, [external_id] (Shard &local_shard) {
+    return PeerOn("RelationshipRemove", rel_shard_id, [external_id] (Shard &local_shard) {
            return local_shard.ValidRelationshipId(external_id);
     }).then([rel_shard_id, external_id, this] (bool valid) {
            if(valid) {
              uint64_t internal_id = externalToInternal(external_id);
-             return container().invoke_on(rel_shard_id, [internal_id] (Shard &local_shard) {
+             return PeerOn("RelationshipRemove", rel_shard_id, [internal_id] (Shard &local_shard) {
                     return local_shard.RelationshipRemoveGetIncoming(internal_id);
              }).then([external_id, this] (std::pair <uint16_t, uint64_t> rel_type_incoming_node_id) {
 
                     uint16_t shard_id2 = CalculateShardId(rel_type_incoming_node_id.second);
-                    return container().invoke_on(shard_id2, [rel_type_incoming_node_id, external_id] (Shard &local_shard) {
+                    return PeerOn("RelationshipRemove", shard_id2, [rel_type_incoming_node_id, external_id] (Shard &local_shard) {
                            return local_shard.RelationshipRemoveIncoming(rel_type_incoming_node_id.first, external_id, rel_type_incoming_node_id.second);
                     });
              });
@@ -4258,7 +8037,7 @@ namespace triton {
       return seastar::make_ready_future<std::string>(RelationshipGetType(id));
     }
 
-    return container().invoke_on(rel_shard_id, [id] (Shard &local_shard) {
+    return PeerOn("RelationshipGetType", rel_shard_id, [id] (Shard &local_shard) {
            return local_shard.RelationshipGetType(id);
     });
   }
@@ -4270,7 +8049,7 @@ namespace triton {
       return seastar::make_ready_future<uint16_t>(RelationshipGetTypeId(id));
     }
 
-    return container().invoke_on(rel_shard_id, [id] (Shard &local_shard) {
+    return PeerOn("RelationshipGetTypeId", rel_shard_id, [id] (Shard &local_shard) {
            return local_shard.RelationshipGetTypeId(id);
     });
   }
@@ -4282,7 +8061,7 @@ namespace triton {
       return seastar::make_ready_future<uint64_t>(RelationshipGetStartingNodeId(id));
     }
 
-    return container().invoke_on(rel_shard_id, [id] (Shard &local_shard) {
+    return PeerOn("RelationshipGetStartingNodeId", rel_shard_id, [id] (Shard &local_shard) {
            return local_shard.RelationshipGetStartingNodeId(id);
     });
   }
@@ -4294,11 +8073,135 @@ namespace triton {
       return seastar::make_ready_future<uint64_t>(RelationshipGetEndingNodeId(id));
     }
 
-    return container().invoke_on(rel_shard_id, [id] (Shard &local_shard) {
+    return PeerOn("RelationshipGetEndingNodeId", rel_shard_id, [id] (Shard &local_shard) {
            return local_shard.RelationshipGetEndingNodeId(id);
     });
   }
 
+  seastar::future<uint64_t> Shard::RelationshipGetIDPeered(uint64_t id1, uint64_t id2, const std::string& rel_type, Direction direction) {
+    uint16_t rel_type_id = relationship_types.getTypeId(rel_type);
+    uint16_t node_shard_id = CalculateShardId(id1);
+
+    if (rel_type_id == 0) {
+      return seastar::make_ready_future<uint64_t>(uint64_t(0));
+    }
+
+    if (node_shard_id == seastar::this_shard_id()) {
+      return seastar::make_ready_future<uint64_t>(RelationshipGetID(id1, id2, rel_type_id, direction));
+    }
+
+    return PeerOn("RelationshipGetID", node_shard_id, [id1, id2, rel_type_id, direction] (Shard &local_shard) {
+           return local_shard.RelationshipGetID(id1, id2, rel_type_id, direction);
+    });
+  }
+
+  seastar::future<bool> Shard::RelationshipExistsPeered(uint64_t id1, uint64_t id2, const std::string& rel_type, Direction direction) {
+    return RelationshipGetIDPeered(id1, id2, rel_type, direction).then([] (uint64_t rel_id) {
+           return rel_id > 0;
+    });
+  }
+
+  seastar::future<std::vector<bool>> Shard::RelationshipsExistPeered(const std::vector<std::pair<uint64_t, uint64_t>>& pairs, const std::string& rel_type, Direction direction) {
+    uint16_t rel_type_id = relationship_types.getTypeId(rel_type);
+
+    if (rel_type_id == 0) {
+      return seastar::make_ready_future<std::vector<bool>>(std::vector<bool>(pairs.size(), false));
+    }
+
+    // Each shard checks the pairs whose first node it owns in one message
+    std::vector<std::vector<std::pair<uint64_t, uint64_t>>> sharded_pairs(cpus);
+    std::vector<std::vector<size_t>> sharded_positions(cpus);
+    for (size_t position = 0; position < pairs.size(); position++) {
+      uint16_t node_shard_id = CalculateShardId(pairs.at(position).first);
+      sharded_pairs.at(node_shard_id).emplace_back(pairs.at(position));
+      sharded_positions.at(node_shard_id).emplace_back(position);
+    }
+
+    std::vector<uint16_t> shard_ids;
+    std::vector<seastar::future<std::vector<bool>>> futures;
+    for (int i = 0; i < cpus; i++) {
+      if (!sharded_pairs.at(i).empty()) {
+        shard_ids.emplace_back(i);
+        futures.push_back(PeerOn("RelationshipsExist", i, [batch = std::move(sharded_pairs.at(i)), rel_type_id, direction] (Shard &local_shard) {
+               return local_shard.RelationshipsExist(batch, rel_type_id, direction);
+        }));
+      }
+    }
+
+    auto p = make_shared(std::move(futures));
+    return seastar::when_all_succeed(p->begin(), p->end())
+      .then([size = pairs.size(), shard_ids = std::move(shard_ids), sharded_positions = std::move(sharded_positions)] (const std::vector<std::vector<bool>>& results) {
+             // Put the answers back in the order the pairs were given
+             std::vector<bool> exist(size, false);
+             for (size_t i = 0; i < shard_ids.size(); i++) {
+               for (size_t j = 0; j < results.at(i).size(); j++) {
+                 exist.at(sharded_positions.at(shard_ids.at(i)).at(j)) = results.at(i).at(j);
+               }
+             }
+             return exist;
+      });
+  }
+
+  seastar::future<std::pair<uint64_t, bool>> Shard::RelationshipMergePeered(const std::string& rel_type, const std::string& type1, const std::string& key1,
+                                                                           const std::string& type2, const std::string& key2, const std::string& properties) {
+    std::vector<std::pair<std::string, std::string>> keys = {{type1, key1}, {type2, key2}};
+    return NodeGetIDsPeered(std::move(keys)).then([rel_type, properties, this] (const std::vector<uint64_t>& node_ids) {
+           if (node_ids.at(0) > 0 && node_ids.at(1) > 0) {
+             return RelationshipMergePeered(rel_type, node_ids.at(0), node_ids.at(1), properties);
+           }
+           // Invalid node keys
+           return seastar::make_ready_future<std::pair<uint64_t, bool>>(std::pair<uint64_t, bool>(0, false));
+    });
+  }
+
+  seastar::future<std::pair<uint64_t, bool>> Shard::RelationshipMergePeered(const std::string& rel_type, uint64_t id1, uint64_t id2, const std::string& properties) {
+    uint16_t rel_type_id = relationship_types.getTypeId(rel_type);
+
+    if (rel_type_id > 0) {
+      return RelationshipMergePeered(rel_type_id, id1, id2, properties);
+    }
+
+    // The relationship type needs to be set by Shard 0 and propagated
+    return PeerOn("RelationshipMerge", 0, [rel_type] (Shard &local_shard) {
+           return local_shard.RelationshipTypeInsertPeered(rel_type);
+    }).then([id1, id2, properties, this] (uint16_t rel_type_id) {
+           return RelationshipMergePeered(rel_type_id, id1, id2, properties);
+    });
+  }
+
+  seastar::future<std::pair<uint64_t, bool>> Shard::RelationshipMergePeered(uint16_t rel_type_id, uint64_t id1, uint64_t id2, const std::string& properties) {
+    uint16_t shard_id1 = CalculateShardId(id1);
+    uint16_t shard_id2 = CalculateShardId(id2);
+
+    if (!relationship_types.ValidTypeId(rel_type_id)) {
+      // Invalid rel type id
+      return seastar::make_ready_future<std::pair<uint64_t, bool>>(std::pair<uint64_t, bool>(0, false));
+    }
+
+    // Validate node id2 first, so finding or adding the relationship on the shard of node id1 is a single step
+    return PeerOn("RelationshipMerge", shard_id2, [id2] (Shard &local_shard) {
+           return local_shard.ValidNodeId(id2);
+    }).then([rel_type_id, shard_id1, shard_id2, id1, id2, properties, this] (bool valid) {
+           if (!valid) {
+             // Invalid node ids
+             return seastar::make_ready_future<std::pair<uint64_t, bool>>(std::pair<uint64_t, bool>(0, false));
+           }
+           return PeerOn("RelationshipMerge", shard_id1, [rel_type_id, id1, id2, properties] (Shard &local_shard) {
+                  return local_shard.RelationshipMergeToOutgoing(rel_type_id, id1, id2, properties);
+           }).then([rel_type_id, shard_id1, shard_id2, id1, id2, this] (std::pair<uint64_t, bool> merged) {
+                  // A new relationship between shards still has to be added to the incoming side of node id2
+                  if (merged.second && shard_id1 != shard_id2) {
+                    return PeerOn("RelationshipMerge", shard_id2, [rel_type_id, id1, id2, rel_id = merged.first] (Shard &local_shard) {
+                           return local_shard.RelationshipAddToIncoming(rel_type_id, rel_id, id1, id2);
+                    }).then([merged] (uint64_t) {
+                           return merged;
+                    });
+                  }
+                  return seastar::make_ready_future<std::pair<uint64_t, bool>>(merged);
+           });
+    });
+  }
+
   // Relationship Properties
   seastar::future<std::any> Shard::RelationshipPropertyGetPeered(uint64_t id, const std::string &property) {
     uint16_t rel_shard_id = CalculateShardId(id);
@@ -4307,7 +8210,7 @@ namespace triton {
       return seastar::make_ready_future<std::any>(RelationshipPropertyGet(id, property));
     }
 
-    return container().invoke_on(rel_shard_id, [id, property](Shard &local_shard) {
+    return PeerOn("RelationshipPropertyGet", rel_shard_id, [id, property](Shard &local_shard) {
            return local_shard.RelationshipPropertyGet(id, property);
     });
   }
@@ -4319,7 +8222,7 @@ namespace triton {
       return seastar::make_ready_future<std::string>(RelationshipPropertyGetString(id, property));
     }
 
-    return container().invoke_on(rel_shard_id, [id, property](Shard &local_shard) {
+    return PeerOn("RelationshipPropertyGetString", rel_shard_id, [id, property](Shard &local_shard) {
            return local_shard.RelationshipPropertyGetString(id, property);
     });
   }
@@ -4331,7 +8234,7 @@ namespace triton {
       return seastar::make_ready_future<int64_t>(RelationshipPropertyGetInteger(id, property));
     }
 
-    return container().invoke_on(rel_shard_id, [id, property](Shard &local_shard) {
+    return PeerOn("RelationshipPropertyGetInteger", rel_shard_id, [id, property](Shard &local_shard) {
            return local_shard.RelationshipPropertyGetInteger(id, property);
     });
   }
@@ -4343,7 +8246,7 @@ namespace triton {
       return seastar::make_ready_future<double>(RelationshipPropertyGetDouble(id, property));
     }
 
-    return container().invoke_on(rel_shard_id, [id, property](Shard &local_shard) {
+    return PeerOn("RelationshipPropertyGetDouble", rel_shard_id, [id, property](Shard &local_shard) {
            return local_shard.RelationshipPropertyGetDouble(id, property);
     });
   }
@@ -4355,7 +8258,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(RelationshipPropertyGetBoolean(id, property));
     }
 
-    return container().invoke_on(rel_shard_id, [id, property](Shard &local_shard) {
+    return PeerOn("RelationshipPropertyGetBoolean", rel_shard_id, [id, property](Shard &local_shard) {
            return local_shard.RelationshipPropertyGetBoolean(id, property);
     });
   }
@@ -4367,7 +8270,7 @@ namespace triton {
       return seastar::make_ready_future<std::map<std::string, std::any>>(RelationshipPropertyGetObject(id, property));
     }
 
-    return container().invoke_on(rel_shard_id, [id, property](Shard &local_shard) {
+    return PeerOn("RelationshipPropertyGetBoolean", rel_shard_id, [id, property](Shard &local_shard) {
            return local_shard.RelationshipPropertyGetObject(id, property);
     });
   }
@@ -4379,7 +8282,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(RelationshipPropertySet(id, property, value));
     }
 
-    return container().invoke_on(rel_shard_id, [id, property, value](Shard &local_shard) {
+    return PeerOn("RelationshipPropertySet", rel_shard_id, [id, property, value](Shard &local_shard) {
            return local_shard.RelationshipPropertySet(id, property, value);
     });
   }
@@ -4391,7 +8294,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(RelationshipPropertySet(id, property, value));
     }
 
-    return container().invoke_on(rel_shard_id, [id, property, value](Shard &local_shard) {
+    return PeerOn("RelationshipPropertySet", rel_shard_id, [id, property, value](Shard &local_shard) {
            return local_shard.RelationshipPropertySet(id, property, value);
     });
   }
@@ -4403,7 +8306,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(RelationshipPropertySet(id, property, value));
     }
 
-    return container().invoke_on(rel_shard_id, [id, property, value](Shard &local_shard) {
+    return PeerOn("RelationshipPropertySet", rel_shard_id, [id, property, value](Shard &local_shard) {
            return local_shard.RelationshipPropertySet(id, property, value);
     });
   }
@@ -4415,7 +8318,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(RelationshipPropertySet(id, property, value));
     }
 
-    return container().invoke_on(rel_shard_id, [id, property, value](Shard &local_shard) {
+    return PeerOn("RelationshipPropertySet", rel_shard_id, [id, property, value](Shard &local_shard) {
            return local_shard.RelationshipPropertySet(id, property, value);
     });
   }
@@ -4427,7 +8330,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(RelationshipPropertySet(id, property, value));
     }
 
-    return container().invoke_on(rel_shard_id, [id, property, value](Shard &local_shard) {
+    return PeerOn("RelationshipPropertySet", rel_shard_id, [id, property, value](Shard &local_shard) {
            return local_shard.RelationshipPropertySet(id, property, value);
     });
   }
@@ -4439,7 +8342,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(RelationshipPropertySet(id, property, value));
     }
 
-    return container().invoke_on(rel_shard_id, [id, property, value](Shard &local_shard) {
+    return PeerOn("RelationshipPropertySet", rel_shard_id, [id, property, value](Shard &local_shard) {
            return local_shard.RelationshipPropertySet(id, property, value);
     });
   }
@@ -4451,7 +8354,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(RelationshipPropertySetFromJson(id, property, value));
     }
 
-    return container().invoke_on(rel_shard_id, [id, property, value](Shard &local_shard) {
+    return PeerOn("RelationshipPropertySetFromJson", rel_shard_id, [id, property, value](Shard &local_shard) {
            return local_shard.RelationshipPropertySetFromJson(id, property, value);
     });
   }
@@ -4463,7 +8366,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(RelationshipPropertyDelete(id, property));
     }
 
-    return container().invoke_on(rel_shard_id, [id, property](Shard &local_shard) {
+    return PeerOn("RelationshipPropertyDelete", rel_shard_id, [id, property](Shard &local_shard) {
            return local_shard.RelationshipPropertyDelete(id, property);
     });
   }
@@ -4475,7 +8378,7 @@ namespace triton {
       return seastar::make_ready_future<std::map<std::string, std::any>>(RelationshipPropertiesGet(id));
     }
 
-    return container().invoke_on(rel_shard_id, [id](Shard &local_shard) {
+    return PeerOn("RelationshipPropertyDelete", rel_shard_id, [id](Shard &local_shard) {
            return local_shard.RelationshipPropertiesGet(id);
     });
   }
@@ -4487,7 +8390,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(RelationshipPropertiesSet(id, value));
     }
 
-    return container().invoke_on(rel_shard_id, [id, value](Shard &local_shard) mutable {
+    return PeerOn("RelationshipPropertiesSet", rel_shard_id, [id, value](Shard &local_shard) mutable {
            return local_shard.RelationshipPropertiesSet(id, value);
     });
   }
@@ -4499,7 +8402,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(RelationshipPropertiesReset(id, value));
     }
 
-    return container().invoke_on(rel_shard_id, [id, value](Shard &local_shard) {
+    return PeerOn("RelationshipPropertiesReset", rel_shard_id, [id, value](Shard &local_shard) {
            return local_shard.RelationshipPropertiesReset(id, value);
     });
   }
@@ -4511,7 +8414,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(RelationshipPropertiesSetFromJson(id, value));
     }
 
-    return container().invoke_on(rel_shard_id, [id, value](Shard &local_shard) mutable {
+    return PeerOn("RelationshipPropertiesSetFromJson", rel_shard_id, [id, value](Shard &local_shard) mutable {
            return local_shard.RelationshipPropertiesSetFromJson(id, value);
     });
   }
@@ -4523,7 +8426,7 @@ namespace triton {
       return seastar::make_ready_future<bool>(RelationshipPropertiesResetFromJson(id, value));
     }
 
-    return container().invoke_on(rel_shard_id, [id, value](Shard &local_shard) {
+    return PeerOn("RelationshipPropertiesResetFromJson", rel_shard_id, [id, value](Shard &local_shard) {
            return local_shard.RelationshipPropertiesResetFromJson(id, value);
     });
   }
@@ -4535,11 +8438,47 @@ namespace triton {
       return seastar::make_ready_future<bool>(RelationshipPropertiesDelete(id));
     }
 
-    return container().invoke_on(rel_shard_id, [id](Shard &local_shard) {
+    return PeerOn("RelationshipPropertiesDelete", rel_shard_id, [id](Shard &local_shard) {
            return local_shard.RelationshipPropertiesDelete(id);
     });
   }
 
+  // Relationship Recency Indexes
+  seastar::future<bool> Shard::RelationshipRecencyIndexCreatePeered(const std::string &rel_type, const std::string &property, bool stamp, uint64_t ttl) {
+    // Every shard orders the relationships that start on it
+    return PeerMap("RelationshipRecencyIndexCreate", [rel_type, property, stamp, ttl] (Shard &local_shard) {
+             return local_shard.RelationshipRecencyIndexCreate(rel_type, property, stamp, ttl);
+      })
+      .then([] (const std::vector<bool>& results) {
+             return std::all_of(std::begin(results), std::end(results), [] (bool created) { return created; });
+      });
+  }
+
+  seastar::future<bool> Shard::RelationshipRecencyIndexDropPeered(const std::string &rel_type) {
+    return PeerMap("RelationshipRecencyIndexDrop", [rel_type] (Shard &local_shard) {
+             return local_shard.RelationshipRecencyIndexDrop(rel_type);
+      })
+      .then([] (const std::vector<bool>& results) {
+             return std::all_of(std::begin(results), std::end(results), [] (bool dropped) { return dropped; });
+      });
+  }
+
+  seastar::future<std::vector<Relationship>> Shard::NodeGetRecentRelationshipsPeered(const std::string &type, const std::string &key, const std::string &rel_type, int64_t since, int64_t until, uint64_t limit, NodeProjection projection) {
+    uint16_t node_shard_id = CalculateShardId(type, key);
+
+    return PeerOn("NodeGetRecentRelationships", node_shard_id, [type, key, rel_type, since, until, limit, projection] (Shard &local_shard) {
+           return local_shard.NodeGetRecentRelationships(type, key, rel_type, since, until, limit, projection);
+    });
+  }
+
+  seastar::future<std::vector<Relationship>> Shard::NodeGetRecentRelationshipsPeered(uint64_t id, const std::string &rel_type, int64_t since, int64_t until, uint64_t limit, NodeProjection projection) {
+    uint16_t node_shard_id = CalculateShardId(id);
+
+    return PeerOn("NodeGetRecentRelationships", node_shard_id, [id, rel_type, since, until, limit, projection] (Shard &local_shard) {
+           return local_shard.NodeGetRecentRelationships(id, rel_type, since, until, limit, projection);
+    });
+  }
+
   // Node Degree
   seastar::future<uint64_t> Shard::NodeGetDegreePeered(const std::string &type, const std::string &key) {
     uint16_t node_shard_id = CalculateShardId(type, key);
@@ -4548,7 +8487,7 @@ namespace triton {
       return seastar::make_ready_future<uint64_t>(NodeGetDegree(type, key));
     }
 
-    return container().invoke_on(node_shard_id, [type, key](Shard &local_shard) {
+    return PeerOn("NodeGetDegree", node_shard_id, [type, key](Shard &local_shard) {
            return local_shard.NodeGetDegree(type, key);
     });
   }
@@ -4560,7 +8499,7 @@ namespace triton {
       return seastar::make_ready_future<uint64_t>(NodeGetDegree(type, key, direction));
     }
 
-    return container().invoke_on(node_shard_id, [type, key, direction](Shard &local_shard) {
+    return PeerOn("NodeGetDegree", node_shard_id, [type, key, direction](Shard &local_shard) {
            return local_shard.NodeGetDegree(type, key, direction);
     });
   }
@@ -4572,7 +8511,7 @@ namespace triton {
       return seastar::make_ready_future<uint64_t>(NodeGetDegree(type, key, direction, rel_type));
     }
 
-    return container().invoke_on(node_shard_id, [type, key, direction, rel_type](Shard &local_shard) {
+    return PeerOn("NodeGetDegree", node_shard_id, [type, key, direction, rel_type](Shard &local_shard) {
            return local_shard.NodeGetDegree(type, key, direction, rel_type);
     });
   }
@@ -4584,7 +8523,7 @@ namespace triton {
       return seastar::make_ready_future<uint64_t>(NodeGetDegree(type, key, BOTH, rel_type));
     }
 
-    return container().invoke_on(node_shard_id, [type, key, rel_type](Shard &local_shard) {
+    return PeerOn("NodeGetDegree", node_shard_id, [type, key, rel_type](Shard &local_shard) {
            return local_shard.NodeGetDegree(type, key, BOTH, rel_type);
     });
   }
@@ -4596,7 +8535,7 @@ namespace triton {
       return seastar::make_ready_future<uint64_t>(NodeGetDegree(type, key, direction, rel_types));
     }
 
-    return container().invoke_on(node_shard_id, [type, key, direction, rel_types](Shard &local_shard) {
+    return PeerOn("NodeGetDegree", node_shard_id, [type, key, direction, rel_types](Shard &local_shard) {
            return local_shard.NodeGetDegree(type, key, direction, rel_types);
     });
   }
@@ -4608,7 +8547,7 @@ namespace triton {
       return seastar::make_ready_future<uint64_t>(NodeGetDegree(type, key, BOTH, rel_types));
     }
 
-    return container().invoke_on(node_shard_id, [type, key, rel_types](Shard &local_shard) {
+    return PeerOn("NodeGetDegree", node_shard_id, [type, key, rel_types](Shard &local_shard) {
            return local_shard.NodeGetDegree(type, key, BOTH, rel_types);
     });
   }
@@ -4620,7 +8559,7 @@ namespace triton {
       return seastar::make_ready_future<uint64_t>(NodeGetDegree(external_id));
     }
 
-    return container().invoke_on(node_shard_id, [external_id](Shard &local_shard) {
+    return PeerOn("NodeGetDegree", node_shard_id, [external_id](Shard &local_shard) {
            return local_shard.NodeGetDegree(external_id);
     });
   }
@@ -4632,7 +8571,7 @@ namespace triton {
       return seastar::make_ready_future<uint64_t>(NodeGetDegree(external_id, direction));
     }
 
-    return container().invoke_on(node_shard_id, [external_id, direction](Shard &local_shard) {
+    return PeerOn("NodeGetDegree", node_shard_id, [external_id, direction](Shard &local_shard) {
            return local_shard.NodeGetDegree(external_id, direction);
     });
   }
@@ -4644,7 +8583,7 @@ namespace triton {
       return seastar::make_ready_future<uint64_t>(NodeGetDegree(external_id, direction, rel_type));
     }
 
-    return container().invoke_on(node_shard_id, [external_id, direction, rel_type](Shard &local_shard) {
+    return PeerOn("NodeGetDegree", node_shard_id, [external_id, direction, rel_type](Shard &local_shard) {
            return local_shard.NodeGetDegree(external_id, direction, rel_type);
     });
   }
@@ -4656,7 +8595,7 @@ namespace triton {
       return seastar::make_ready_future<uint64_t>(NodeGetDegree(external_id, BOTH, rel_type));
     }
 
-    return container().invoke_on(node_shard_id, [external_id, rel_type](Shard &local_shard) {
+    return PeerOn("NodeGetDegree", node_shard_id, [external_id, rel_type](Shard &local_shard) {
            return local_shard.NodeGetDegree(external_id, BOTH, rel_type);
     });
   }
@@ -4668,7 +8607,7 @@ namespace triton {
       return seastar::make_ready_future<uint64_t>(NodeGetDegree(external_id, direction, rel_types));
     }
 
-    return container().invoke_on(node_shard_id, [external_id, direction, rel_types](Shard &local_shard) {
+    return PeerOn("NodeGetDegree", node_shard_id, [external_id, direction, rel_types](Shard &local_shard) {
            return local_shard.NodeGetDegree(external_id, direction, rel_types);
     });
   }
@@ -4680,7 +8619,7 @@ namespace triton {
       return seastar::make_ready_future<uint64_t>(NodeGetDegree(external_id, BOTH, rel_types));
     }
 
-    return container().invoke_on(node_shard_id, [external_id, rel_types](Shard &local_shard) {
+    return PeerOn("NodeGetDegree", node_shard_id, [external_id, rel_types](Shard &local_shard) {
            return local_shard.NodeGetDegree(external_id, BOTH, rel_types);
     });
   }
@@ -4694,7 +8633,7 @@ namespace triton {
       return seastar::make_ready_future<std::vector<Ids>>(NodeGetRelationshipsIDs(type, key));
     }
 
-    return container().invoke_on(node_shard_id, [type, key](Shard &local_shard) {
+    return PeerOn("NodeGetRelationshipsIDs", node_shard_id, [type, key](Shard &local_shard) {
            return local_shard.NodeGetRelationshipsIDs(type, key);
     });
   }
@@ -4706,7 +8645,7 @@ namespace triton {
       return seastar::make_ready_future<std::vector<Ids>>(NodeGetRelationshipsIDs(type, key, direction));
     }
 
-    return container().invoke_on(node_shard_id, [type, key, direction](Shard &local_shard) {
+    return PeerOn("NodeGetRelationshipsIDs", node_shard_id, [type, key, direction](Shard &local_shard) {
            return local_shard.NodeGetRelationshipsIDs(type, key, direction);
     });
   }
@@ -4718,7 +8657,7 @@ namespace triton {
       return seastar::make_ready_future<std::vector<Ids>>(NodeGetRelationshipsIDs(type, key, direction, rel_type));
     }
 
-    return container().invoke_on(node_shard_id, [type, key, direction, rel_type](Shard &local_shard) {
+    return PeerOn("NodeGetRelationshipsIDs", node_shard_id, [type, key, direction, rel_type](Shard &local_shard) {
            return local_shard.NodeGetRelationshipsIDs(type, key, direction, rel_type);
     });
   }
@@ -4730,7 +8669,7 @@ namespace triton {
       return seastar::make_ready_future<std::vector<Ids>>(NodeGetRelationshipsIDs(type, key, direction, type_id));
     }
 
-    return container().invoke_on(node_shard_id, [type, key, direction, type_id](Shard &local_shard) {
+    return PeerOn("NodeGetRelationshipsIDs", node_shard_id, [type, key, direction, type_id](Shard &local_shard) {
            return local_shard.NodeGetRelationshipsIDs(type, key, direction, type_id);
     });
   }
@@ -4742,7 +8681,7 @@ namespace triton {
       return seastar::make_ready_future<std::vector<Ids>>(NodeGetRelationshipsIDs(type, key, direction, rel_types));
     }
 
-    return container().invoke_on(node_shard_id, [type, key, direction, rel_types](Shard &local_shard) {
+    return PeerOn("NodeGetRelationshipsIDs", node_shard_id, [type, key, direction, rel_types](Shard &local_shard) {
            return local_shard.NodeGetRelationshipsIDs(type, key, direction, rel_types);
     });
   }
@@ -4754,7 +8693,7 @@ namespace triton {
       return seastar::make_ready_future<std::vector<Ids>>(NodeGetRelationshipsIDs(type, key, BOTH, rel_type));
     }
 
-    return container().invoke_on(node_shard_id, [type, key, rel_type](Shard &local_shard) {
+    return PeerOn("NodeGetRelationshipsIDs", node_shard_id, [type, key, rel_type](Shard &local_shard) {
            return local_shard.NodeGetRelationshipsIDs(type, key, BOTH, rel_type);
     });
   }
@@ -4766,7 +8705,7 @@ namespace triton {
       return seastar::make_ready_future<std::vector<Ids>>(NodeGetRelationshipsIDs(type, key, BOTH, type_id));
     }
 
-    return container().invoke_on(node_shard_id, [type, key, type_id](Shard &local_shard) {
+    return PeerOn("NodeGetRelationshipsIDs", node_shard_id, [type, key, type_id](Shard &local_shard) {
            return local_shard.NodeGetRelationshipsIDs(type, key, BOTH, type_id);
     });
   }
@@ -4778,7 +8717,7 @@ namespace triton {
       return seastar::make_ready_future<std::vector<Ids>>(NodeGetRelationshipsIDs(type, key, BOTH, rel_types));
     }
 
-    return container().invoke_on(node_shard_id, [type, key, rel_types](Shard &local_shard) {
+    return PeerOn("NodeGetRelationshipsIDs", node_shard_id, [type, key, rel_types](Shard &local_shard) {
            return local_shard.NodeGetRelationshipsIDs(type, key, BOTH, rel_types);
     });
   }
@@ -4790,7 +8729,7 @@ namespace triton {
       return seastar::make_ready_future<std::vector<Ids>>(NodeGetRelationshipsIDs(external_id));
     }
 
-    return container().invoke_on(node_shard_id, [external_id](Shard &local_shard) {
+    return PeerOn("NodeGetRelationshipsIDs", node_shard_id, [external_id](Shard &local_shard) {
            return local_shard.NodeGetRelationshipsIDs(external_id);
     });
   }
@@ -4802,7 +8741,7 @@ namespace triton {
       return seastar::make_ready_future<std::vector<Ids>>(NodeGetRelationshipsIDs(external_id, direction));
     }
 
-    return container().invoke_on(node_shard_id, [external_id, direction](Shard &local_shard) {
+    return PeerOn("NodeGetRelationshipsIDs", node_shard_id, [external_id, direction](Shard &local_shard) {
            return local_shard.NodeGetRelationshipsIDs(external_id, direction);
     });
   }
@@ -4814,7 +8753,7 @@ namespace triton {
       return seastar::make_ready_future<std::vector<Ids>>(NodeGetRelationshipsIDs(external_id, direction, rel_type));
     }
 
-    return container().invoke_on(node_shard_id, [external_id, direction, rel_type](Shard &local_shard) {
+    return PeerOn("NodeGetRelationshipsIDs", node_shard_id, [external_id, direction, rel_type](Shard &local_shard) {
            return local_shard.NodeGetRelationshipsIDs(external_id, direction, rel_type);
     });
   }
@@ -4826,7 +8765,7 @@ namespace triton {
       return seastar::make_ready_future<std::vector<Ids>>(NodeGetRelationshipsIDs(external_id, direction, type_id));
     }
 
-    return container().invoke_on(node_shard_id, [external_id, direction, type_id](Shard &local_shard) {
+    return PeerOn("NodeGetRelationshipsIDs", node_shard_id, [external_id, direction, type_id](Shard &local_shard) {
            return local_shard.NodeGetRelationshipsIDs(external_id, direction, type_id);
     });
   }
@@ -4838,7 +8777,7 @@ namespace triton {
       return seastar::make_ready_future<std::vector<Ids>>(NodeGetRelationshipsIDs(external_id, direction, rel_types));
     }
 
-    return container().invoke_on(node_shard_id, [external_id, direction, rel_types](Shard &local_shard) {
+    return PeerOn("NodeGetRelationshipsIDs", node_shard_id, [external_id, direction, rel_types](Shard &local_shard) {
            return local_shard.NodeGetRelationshipsIDs(external_id, direction, rel_types);
     });
   }
@@ -4850,7 +8789,7 @@ namespace triton {
       return seastar::make_ready_future<std::vector<Ids>>(NodeGetRelationshipsIDs(external_id, BOTH, rel_type));
     }
 
-    return container().invoke_on(node_shard_id, [external_id, rel_type](Shard &local_shard) {
+    return PeerOn("NodeGetRelationshipsIDs", node_shard_id, [external_id, rel_type](Shard &local_shard) {
            return local_shard.NodeGetRelationshipsIDs(external_id, BOTH, rel_type);
     });
   }
@@ -4862,7 +8801,7 @@ namespace triton {
       return seastar::make_ready_future<std::vector<Ids>>(NodeGetRelationshipsIDs(external_id, BOTH, type_id));
     }
 
-    return container().invoke_on(node_shard_id, [external_id, type_id](Shard &local_shard) {
+    return PeerOn("NodeGetRelationshipsIDs", node_shard_id, [external_id, type_id](Shard &local_shard) {
            return local_shard.NodeGetRelationshipsIDs(external_id, BOTH, type_id);
     });
   }
@@ -4874,7 +8813,7 @@ namespace triton {
       return seastar::make_ready_future<std::vector<Ids>>(NodeGetRelationshipsIDs(external_id, BOTH, rel_types));
     }
 
-    return container().invoke_on(node_shard_id, [external_id, rel_types](Shard &local_shard) {
+    return PeerOn("NodeGetRelationshipsIDs", node_shard_id, [external_id, rel_types](Shard &local_shard) {
            return local_shard.NodeGetRelationshipsIDs(external_id, BOTH, rel_types);
     });
   }
@@ -4882,25 +8821,11 @@ namespace triton {
   seastar::future<std::vector<Relationship>> Shard::NodeGetRelationshipsPeered(const std::string& type, const std::string& key) {
     uint16_t node_shard_id = CalculateShardId(type, key);
 
-    return container().invoke_on(node_shard_id, [type, key](Shard &local_shard) {
+    return PeerOn("NodeGetRelationships", node_shard_id, [type, key](Shard &local_shard) {
              return local_shard.NodeGetShardedRelationshipIDs(type, key); })
-      .then([this] (const std::map<uint16_t, std::vector<uint64_t>>& sharded_relationships_ids) {
-             std::vector<seastar::future<std::vector<Relationship>>> futures;
-             for (auto const& [their_shard, grouped_rel_ids] : sharded_relationships_ids ) {
-               auto future = container().invoke_on(their_shard, [grouped_rel_ids = grouped_rel_ids] (Shard &local_shard) {
-                      return local_shard.RelationshipsGet(grouped_rel_ids);
-               });
-               futures.push_back(std::move(future));
-             }
-
-             auto p = make_shared(std::move(futures));
-             return seastar::when_all_succeed(p->begin(), p->end()).then([] (const std::vector<std::vector<Relationship>>& results) {
-                    std::vector<Relationship> combined;
-
-                    for(const std::vector<Relationship>& sharded : results) {
-                      combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                    }
-                    return combined;
+      .then([this] (std::map<uint16_t, std::vector<uint64_t>> sharded_relationships_ids) {
+             return PeerScatter<Relationship>("NodeGetRelationships", std::move(sharded_relationships_ids), [] (Shard &local_shard, const std::vector<uint64_t>& grouped_rel_ids) {
+                    return local_shard.RelationshipsGet(grouped_rel_ids);
              });
       });
   }
@@ -4910,24 +8835,10 @@ namespace triton {
     uint16_t rel_type_id = relationship_types.getTypeId(rel_type);
 
     if (rel_type_id > 0) {
-      return container().invoke_on(node_shard_id, [type, key, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedRelationshipIDs(type, key, rel_type_id); })
-        .then([this](const std::map<uint16_t, std::vector<uint64_t>> &sharded_relationships_ids) {
-               std::vector<seastar::future<std::vector<Relationship>>> futures;
-               for (auto const &[their_shard, grouped_rel_ids] : sharded_relationships_ids) {
-                 auto future = container().invoke_on(their_shard, [grouped_rel_ids = grouped_rel_ids](Shard &local_shard) {
-                        return local_shard.RelationshipsGet(grouped_rel_ids);
-                 });
-                 futures.push_back(std::move(future));
-               }
-
-               auto p = make_shared(std::move(futures));
-               return seastar::when_all_succeed(p->begin(), p->end()).then([](const std::vector<std::vector<Relationship>> &results) {
-                      std::vector<Relationship> combined;
-
-                      for (const std::vector<Relationship> &sharded : results) {
-                        combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                      }
-                      return combined;
+      return PeerOn("NodeGetRelationships", node_shard_id, [type, key, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedRelationshipIDs(type, key, rel_type_id); })
+        .then([this](std::map<uint16_t, std::vector<uint64_t>> sharded_relationships_ids) {
+               return PeerScatter<Relationship>("NodeGetRelationships", std::move(sharded_relationships_ids), [] (Shard &local_shard, const std::vector<uint64_t>& grouped_rel_ids) {
+                      return local_shard.RelationshipsGet(grouped_rel_ids);
                });
         });
     }
@@ -4939,24 +8850,10 @@ namespace triton {
     uint16_t node_shard_id = CalculateShardId(type, key);
 
     if (rel_type_id > 0) {
-      return container().invoke_on(node_shard_id, [type, key, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedRelationshipIDs(type, key, rel_type_id); })
-        .then([this](const std::map<uint16_t, std::vector<uint64_t>> &sharded_relationships_ids) {
-               std::vector<seastar::future<std::vector<Relationship>>> futures;
-               for (auto const &[their_shard, grouped_rel_ids] : sharded_relationships_ids) {
-                 auto future = container().invoke_on(their_shard, [grouped_rel_ids = grouped_rel_ids](Shard &local_shard) {
-                        return local_shard.RelationshipsGet(grouped_rel_ids);
-                 });
-                 futures.push_back(std::move(future));
-               }
-
-               auto p = make_shared(std::move(futures));
-               return seastar::when_all_succeed(p->begin(), p->end()).then([](const std::vector<std::vector<Relationship>> &results) {
-                      std::vector<Relationship> combined;
-
-                      for (const std::vector<Relationship> &sharded : results) {
-                        combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                      }
-                      return combined;
+      return PeerOn("NodeGetRelationships", node_shard_id, [type, key, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedRelationshipIDs(type, key, rel_type_id); })
+        .then([this](std::map<uint16_t, std::vector<uint64_t>> sharded_relationships_ids) {
+               return PeerScatter<Relationship>("NodeGetRelationships", std::move(sharded_relationships_ids), [] (Shard &local_shard, const std::vector<uint64_t>& grouped_rel_ids) {
+                      return local_shard.RelationshipsGet(grouped_rel_ids);
                });
         });
     }
@@ -4967,24 +8864,10 @@ namespace triton {
   seastar::future<std::vector<Relationship>> Shard::NodeGetRelationshipsPeered(const std::string& type, const std::string& key, const std::vector<std::string> &rel_types) {
     uint16_t node_shard_id = CalculateShardId(type, key);
 
-    return container().invoke_on(node_shard_id, [type, key, rel_types](Shard &local_shard) { return local_shard.NodeGetShardedRelationshipIDs(type, key, rel_types); })
-      .then([this](const std::map<uint16_t, std::vector<uint64_t>> &sharded_relationships_ids) {
-             std::vector<seastar::future<std::vector<Relationship>>> futures;
-             for (auto const &[their_shard, grouped_rel_ids] : sharded_relationships_ids) {
-               auto future = container().invoke_on(their_shard, [grouped_rel_ids = grouped_rel_ids](Shard &local_shard) {
-                      return local_shard.RelationshipsGet(grouped_rel_ids);
-               });
-               futures.push_back(std::move(future));
-             }
-
-             auto p = make_shared(std::move(futures));
-             return seastar::when_all_succeed(p->begin(), p->end()).then([](const std::vector<std::vector<Relationship>> &results) {
-                    std::vector<Relationship> combined;
-
-                    for (const std::vector<Relationship> &sharded : results) {
-                      combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                    }
-                    return combined;
+    return PeerOn("NodeGetRelationships", node_shard_id, [type, key, rel_types](Shard &local_shard) { return local_shard.NodeGetShardedRelationshipIDs(type, key, rel_types); })
+      .then([this](std::map<uint16_t, std::vector<uint64_t>> sharded_relationships_ids) {
+             return PeerScatter<Relationship>("NodeGetRelationships", std::move(sharded_relationships_ids), [] (Shard &local_shard, const std::vector<uint64_t>& grouped_rel_ids) {
+                    return local_shard.RelationshipsGet(grouped_rel_ids);
              });
       });
   }
@@ -4992,25 +8875,11 @@ namespace triton {
   seastar::future<std::vector<Relationship>> Shard::NodeGetRelationshipsPeered(uint64_t external_id) {
     uint16_t node_shard_id = CalculateShardId(external_id);
 
-    return container().invoke_on(node_shard_id, [external_id](Shard &local_shard) {
+    return PeerOn("NodeGetRelationships", node_shard_id, [external_id](Shard &local_shard) {
              return local_shard.NodeGetShardedRelationshipIDs(external_id); })
-      .then([this] (const std::map<uint16_t, std::vector<uint64_t>>& sharded_relationships_ids) {
-             std::vector<seastar::future<std::vector<Relationship>>> futures;
-             for (auto const& [their_shard, grouped_rel_ids] : sharded_relationships_ids ) {
-               auto future = container().invoke_on(their_shard, [grouped_rel_ids = grouped_rel_ids] (Shard &local_shard) {
-                      return local_shard.RelationshipsGet(grouped_rel_ids);
-               });
-               futures.push_back(std::move(future));
-             }
-
-             auto p = make_shared(std::move(futures));
-             return seastar::when_all_succeed(p->begin(), p->end()).then([] (const std::vector<std::vector<Relationship>>& results) {
-                    std::vector<Relationship> combined;
-
-                    for(const std::vector<Relationship>& sharded : results) {
-                      combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                    }
-                    return combined;
+      .then([this] (std::map<uint16_t, std::vector<uint64_t>> sharded_relationships_ids) {
+             return PeerScatter<Relationship>("NodeGetRelationships", std::move(sharded_relationships_ids), [] (Shard &local_shard, const std::vector<uint64_t>& grouped_rel_ids) {
+                    return local_shard.RelationshipsGet(grouped_rel_ids);
              });
       });
   }
@@ -5020,24 +8889,10 @@ namespace triton {
     uint16_t rel_type_id = relationship_types.getTypeId(rel_type);
 
     if (rel_type_id > 0) {
-      return container().invoke_on(node_shard_id, [external_id, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedRelationshipIDs(external_id, rel_type_id); })
-        .then([this](const std::map<uint16_t, std::vector<uint64_t>> &sharded_relationships_ids) {
-               std::vector<seastar::future<std::vector<Relationship>>> futures;
-               for (auto const &[their_shard, grouped_rel_ids] : sharded_relationships_ids) {
-                 auto future = container().invoke_on(their_shard, [grouped_rel_ids = grouped_rel_ids](Shard &local_shard) {
-                        return local_shard.RelationshipsGet(grouped_rel_ids);
-                 });
-                 futures.push_back(std::move(future));
-               }
-
-               auto p = make_shared(std::move(futures));
-               return seastar::when_all_succeed(p->begin(), p->end()).then([](const std::vector<std::vector<Relationship>> &results) {
-                      std::vector<Relationship> combined;
-
-                      for (const std::vector<Relationship> &sharded : results) {
-                        combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                      }
-                      return combined;
+      return PeerOn("NodeGetRelationships", node_shard_id, [external_id, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedRelationshipIDs(external_id, rel_type_id); })
+        .then([this](std::map<uint16_t, std::vector<uint64_t>> sharded_relationships_ids) {
+               return PeerScatter<Relationship>("NodeGetRelationships", std::move(sharded_relationships_ids), [] (Shard &local_shard, const std::vector<uint64_t>& grouped_rel_ids) {
+                      return local_shard.RelationshipsGet(grouped_rel_ids);
                });
         });
     }
@@ -5049,52 +8904,24 @@ namespace triton {
     uint16_t node_shard_id = CalculateShardId(external_id);
 
     if (rel_type_id > 0) {
-      return container().invoke_on(node_shard_id, [external_id, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedRelationshipIDs(external_id, rel_type_id); })
-        .then([this](const std::map<uint16_t, std::vector<uint64_t>> &sharded_relationships_ids) {
-               std::vector<seastar::future<std::vector<Relationship>>> futures;
-               for (auto const &[their_shard, grouped_rel_ids] : sharded_relationships_ids) {
-                 auto future = container().invoke_on(their_shard, [grouped_rel_ids = grouped_rel_ids](Shard &local_shard) {
-                        return local_shard.RelationshipsGet(grouped_rel_ids);
-                 });
-                 futures.push_back(std::move(future));
-               }
-
-               auto p = make_shared(std::move(futures));
-               return seastar::when_all_succeed(p->begin(), p->end()).then([](const std::vector<std::vector<Relationship>> &results) {
-                      std::vector<Relationship> combined;
-
-                      for (const std::vector<Relationship> &sharded : results) {
-                        combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                      }
-                      return combined;
+      return PeerOn("NodeGetRelationships", node_shard_id, [external_id, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedRelationshipIDs(external_id, rel_type_id); })
+        .then([this](std::map<uint16_t, std::vector<uint64_t>> sharded_relationships_ids) {
+               return PeerScatter<Relationship>("NodeGetRelationships", std::move(sharded_relationships_ids), [] (Shard &local_shard, const std::vector<uint64_t>& grouped_rel_ids) {
+                      return local_shard.RelationshipsGet(grouped_rel_ids);
                });
         });
     }
 
-    return seastar::make_ready_future<std::vector<Relationship>>();
-  }
-
-  seastar::future<std::vector<Relationship>> Shard::NodeGetRelationshipsPeered(uint64_t external_id, const std::vector<std::string> &rel_types) {
-    uint16_t node_shard_id = CalculateShardId(external_id);
-
-    return container().invoke_on(node_shard_id, [external_id, rel_types](Shard &local_shard) { return local_shard.NodeGetShardedRelationshipIDs(external_id, rel_types); })
-      .then([this](const std::map<uint16_t, std::vector<uint64_t>> &sharded_relationships_ids) {
-             std::vector<seastar::future<std::vector<Relationship>>> futures;
-             for (auto const &[their_shard, grouped_rel_ids] : sharded_relationships_ids) {
-               auto future = container().invoke_on(their_shard, [grouped_rel_ids = grouped_rel_ids](Shard &local_shard) {
-                      return local_shard.RelationshipsGet(grouped_rel_ids);
-               });
-               futures.push_back(std::move(future));
-             }
-
-             auto p = make_shared(std::move(futures));
-             return seastar::when_all_succeed(p->begin(), p->end()).then([](const std::vector<std::vector<Relationship>> &results) {
-                    std::vector<Relationship> combined;
+    return seastar::make_ready_future<std::vector<Relationship>>();
+  }
 
-                    for (const std::vector<Relationship> &sharded : results) {
-                      combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                    }
-                    return combined;
+  seastar::future<std::vector<Relationship>> Shard::NodeGetRelationshipsPeered(uint64_t external_id, const std::vector<std::string> &rel_types) {
+    uint16_t node_shard_id = CalculateShardId(external_id);
+
+    return PeerOn("NodeGetRelationships", node_shard_id, [external_id, rel_types](Shard &local_shard) { return local_shard.NodeGetShardedRelationshipIDs(external_id, rel_types); })
+      .then([this](std::map<uint16_t, std::vector<uint64_t>> sharded_relationships_ids) {
+             return PeerScatter<Relationship>("NodeGetRelationships", std::move(sharded_relationships_ids), [] (Shard &local_shard, const std::vector<uint64_t>& grouped_rel_ids) {
+                    return local_shard.RelationshipsGet(grouped_rel_ids);
              });
       });
   }
@@ -5104,29 +8931,15 @@ namespace triton {
 
     switch(direction) {
     case OUT: {
-      return container().invoke_on(node_shard_id, [type, key](Shard &local_shard) {
+      return PeerOn("NodeGetRelationships", node_shard_id, [type, key](Shard &local_shard) {
              return local_shard.NodeGetOutgoingRelationships(type, key); });
     }
     case IN: {
-      return container().invoke_on(node_shard_id, [type, key](Shard &local_shard) {
+      return PeerOn("NodeGetRelationships", node_shard_id, [type, key](Shard &local_shard) {
                return local_shard.NodeGetShardedIncomingRelationshipIDs(type, key); })
-        .then([this] (const std::map<uint16_t, std::vector<uint64_t>>& sharded_relationships_ids) {
-               std::vector<seastar::future<std::vector<Relationship>>> futures;
-               for (auto const& [their_shard, grouped_rel_ids] : sharded_relationships_ids ) {
-                 auto future = container().invoke_on(their_shard, [grouped_rel_ids = grouped_rel_ids] (Shard &local_shard) {
-                        return local_shard.RelationshipsGet(grouped_rel_ids);
-                 });
-                 futures.push_back(std::move(future));
-               }
-
-               auto p = make_shared(std::move(futures));
-               return seastar::when_all_succeed(p->begin(), p->end()).then([] (const std::vector<std::vector<Relationship>>& results) {
-                      std::vector<Relationship> combined;
-
-                      for(const std::vector<Relationship>& sharded : results) {
-                        combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                      }
-                      return combined;
+        .then([this] (std::map<uint16_t, std::vector<uint64_t>> sharded_relationships_ids) {
+               return PeerScatter<Relationship>("NodeGetRelationships", std::move(sharded_relationships_ids), [] (Shard &local_shard, const std::vector<uint64_t>& grouped_rel_ids) {
+                      return local_shard.RelationshipsGet(grouped_rel_ids);
                });
         });
     }
@@ -5140,27 +8953,13 @@ namespace triton {
     if (rel_type_id != 0) {
       switch (direction) {
       case OUT: {
-        return container().invoke_on(node_shard_id, [type, key, rel_type_id](Shard &local_shard) { return local_shard.NodeGetOutgoingRelationships(type, key, rel_type_id); });
+        return PeerOn("NodeGetRelationships", node_shard_id, [type, key, rel_type_id](Shard &local_shard) { return local_shard.NodeGetOutgoingRelationships(type, key, rel_type_id); });
       }
       case IN: {
-        return container().invoke_on(node_shard_id, [type, key, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedIncomingRelationshipIDs(type, key, rel_type_id); })
-          .then([this](const std::map<uint16_t, std::vector<uint64_t>>& sharded_relationships_ids) {
-                 std::vector<seastar::future<std::vector<Relationship>>> futures;
-                 for (auto const &[their_shard, grouped_rel_ids] : sharded_relationships_ids) {
-                   auto future = container().invoke_on(their_shard, [grouped_rel_ids = grouped_rel_ids](Shard &local_shard) {
-                          return local_shard.RelationshipsGet(grouped_rel_ids);
-                   });
-                   futures.push_back(std::move(future));
-                 }
-
-                 auto p = make_shared(std::move(futures));
-                 return seastar::when_all_succeed(p->begin(), p->end()).then([](const std::vector<std::vector<Relationship>>& results) {
-                        std::vector<Relationship> combined;
-
-                        for (const std::vector<Relationship>& sharded : results) {
-                          combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                        }
-                        return combined;
+        return PeerOn("NodeGetRelationships", node_shard_id, [type, key, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedIncomingRelationshipIDs(type, key, rel_type_id); })
+          .then([this](std::map<uint16_t, std::vector<uint64_t>> sharded_relationships_ids) {
+                 return PeerScatter<Relationship>("NodeGetRelationships", std::move(sharded_relationships_ids), [] (Shard &local_shard, const std::vector<uint64_t>& grouped_rel_ids) {
+                        return local_shard.RelationshipsGet(grouped_rel_ids);
                  });
           });
       }
@@ -5177,27 +8976,13 @@ namespace triton {
     if (rel_type_id != 0) {
       switch (direction) {
       case OUT: {
-        return container().invoke_on(node_shard_id, [type, key, rel_type_id](Shard &local_shard) { return local_shard.NodeGetOutgoingRelationships(type, key, rel_type_id); });
+        return PeerOn("NodeGetRelationships", node_shard_id, [type, key, rel_type_id](Shard &local_shard) { return local_shard.NodeGetOutgoingRelationships(type, key, rel_type_id); });
       }
       case IN: {
-        return container().invoke_on(node_shard_id, [type, key, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedIncomingRelationshipIDs(type, key, rel_type_id); })
-          .then([this](const std::map<uint16_t, std::vector<uint64_t>>& sharded_relationships_ids) {
-                 std::vector<seastar::future<std::vector<Relationship>>> futures;
-                 for (auto const &[their_shard, grouped_rel_ids] : sharded_relationships_ids) {
-                   auto future = container().invoke_on(their_shard, [grouped_rel_ids = grouped_rel_ids](Shard &local_shard) {
-                          return local_shard.RelationshipsGet(grouped_rel_ids);
-                   });
-                   futures.push_back(std::move(future));
-                 }
-
-                 auto p = make_shared(std::move(futures));
-                 return seastar::when_all_succeed(p->begin(), p->end()).then([](const std::vector<std::vector<Relationship>>& results) {
-                        std::vector<Relationship> combined;
-
-                        for (const std::vector<Relationship>& sharded : results) {
-                          combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                        }
-                        return combined;
+        return PeerOn("NodeGetRelationships", node_shard_id, [type, key, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedIncomingRelationshipIDs(type, key, rel_type_id); })
+          .then([this](std::map<uint16_t, std::vector<uint64_t>> sharded_relationships_ids) {
+                 return PeerScatter<Relationship>("NodeGetRelationships", std::move(sharded_relationships_ids), [] (Shard &local_shard, const std::vector<uint64_t>& grouped_rel_ids) {
+                        return local_shard.RelationshipsGet(grouped_rel_ids);
                  });
           });
       }
@@ -5214,29 +8999,15 @@ namespace triton {
 
     switch(direction) {
     case OUT: {
-      return container().invoke_on(node_shard_id, [type, key, rel_types](Shard &local_shard) {
+      return PeerOn("NodeGetRelationships", node_shard_id, [type, key, rel_types](Shard &local_shard) {
              return local_shard.NodeGetOutgoingRelationships(type, key, rel_types); });
     }
     case IN: {
-      return container().invoke_on(node_shard_id, [type, key, rel_types](Shard &local_shard) {
+      return PeerOn("NodeGetRelationships", node_shard_id, [type, key, rel_types](Shard &local_shard) {
                return local_shard.NodeGetShardedIncomingRelationshipIDs(type, key, rel_types); })
-        .then([this] (const std::map<uint16_t, std::vector<uint64_t>>& sharded_relationships_ids) {
-               std::vector<seastar::future<std::vector<Relationship>>> futures;
-               for (auto const& [their_shard, grouped_rel_ids] : sharded_relationships_ids ) {
-                 auto future = container().invoke_on(their_shard, [grouped_rel_ids = grouped_rel_ids] (Shard &local_shard) {
-                        return local_shard.RelationshipsGet(grouped_rel_ids);
-                 });
-                 futures.push_back(std::move(future));
-               }
-
-               auto p = make_shared(std::move(futures));
-               return seastar::when_all_succeed(p->begin(), p->end()).then([] (const std::vector<std::vector<Relationship>>& results) {
-                      std::vector<Relationship> combined;
-
-                      for(const std::vector<Relationship>& sharded : results) {
-                        combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                      }
-                      return combined;
+        .then([this] (std::map<uint16_t, std::vector<uint64_t>> sharded_relationships_ids) {
+               return PeerScatter<Relationship>("NodeGetRelationships", std::move(sharded_relationships_ids), [] (Shard &local_shard, const std::vector<uint64_t>& grouped_rel_ids) {
+                      return local_shard.RelationshipsGet(grouped_rel_ids);
                });
         });
     }
@@ -5250,29 +9021,15 @@ namespace triton {
 
     switch(direction) {
     case OUT: {
-      return container().invoke_on(node_shard_id, [external_id](Shard &local_shard) {
+      return PeerOn("NodeGetRelationships", node_shard_id, [external_id](Shard &local_shard) {
              return local_shard.NodeGetOutgoingRelationships(external_id); });
     }
     case IN: {
-      return container().invoke_on(node_shard_id, [external_id](Shard &local_shard) {
+      return PeerOn("NodeGetRelationships", node_shard_id, [external_id](Shard &local_shard) {
                return local_shard.NodeGetShardedIncomingRelationshipIDs(external_id); })
-        .then([this] (const std::map<uint16_t, std::vector<uint64_t>>& sharded_relationships_ids) {
-               std::vector<seastar::future<std::vector<Relationship>>> futures;
-               for (auto const& [their_shard, grouped_rel_ids] : sharded_relationships_ids ) {
-                 auto future = container().invoke_on(their_shard, [grouped_rel_ids = grouped_rel_ids] (Shard &local_shard) {
-                        return local_shard.RelationshipsGet(grouped_rel_ids);
-                 });
-                 futures.push_back(std::move(future));
-               }
-
-               auto p = make_shared(std::move(futures));
-               return seastar::when_all_succeed(p->begin(), p->end()).then([] (const std::vector<std::vector<Relationship>>& results) {
-                      std::vector<Relationship> combined;
-
-                      for(const std::vector<Relationship>& sharded : results) {
-                        combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                      }
-                      return combined;
+        .then([this] (std::map<uint16_t, std::vector<uint64_t>> sharded_relationships_ids) {
+               return PeerScatter<Relationship>("NodeGetRelationships", std::move(sharded_relationships_ids), [] (Shard &local_shard, const std::vector<uint64_t>& grouped_rel_ids) {
+                      return local_shard.RelationshipsGet(grouped_rel_ids);
                });
         });
     }
@@ -5286,27 +9043,13 @@ namespace triton {
     if (rel_type_id != 0) {
       switch (direction) {
       case OUT: {
-        return container().invoke_on(node_shard_id, [external_id, rel_type_id](Shard &local_shard) { return local_shard.NodeGetOutgoingRelationships(external_id, rel_type_id); });
+        return PeerOn("NodeGetRelationships", node_shard_id, [external_id, rel_type_id](Shard &local_shard) { return local_shard.NodeGetOutgoingRelationships(external_id, rel_type_id); });
       }
       case IN: {
-        return container().invoke_on(node_shard_id, [external_id, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedIncomingRelationshipIDs(external_id, rel_type_id); })
-          .then([this](const std::map<uint16_t, std::vector<uint64_t>>& sharded_relationships_ids) {
-                 std::vector<seastar::future<std::vector<Relationship>>> futures;
-                 for (auto const &[their_shard, grouped_rel_ids] : sharded_relationships_ids) {
-                   auto future = container().invoke_on(their_shard, [grouped_rel_ids = grouped_rel_ids](Shard &local_shard) {
-                          return local_shard.RelationshipsGet(grouped_rel_ids);
-                   });
-                   futures.push_back(std::move(future));
-                 }
-
-                 auto p = make_shared(std::move(futures));
-                 return seastar::when_all_succeed(p->begin(), p->end()).then([](const std::vector<std::vector<Relationship>>& results) {
-                        std::vector<Relationship> combined;
-
-                        for (const std::vector<Relationship>& sharded : results) {
-                          combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                        }
-                        return combined;
+        return PeerOn("NodeGetRelationships", node_shard_id, [external_id, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedIncomingRelationshipIDs(external_id, rel_type_id); })
+          .then([this](std::map<uint16_t, std::vector<uint64_t>> sharded_relationships_ids) {
+                 return PeerScatter<Relationship>("NodeGetRelationships", std::move(sharded_relationships_ids), [] (Shard &local_shard, const std::vector<uint64_t>& grouped_rel_ids) {
+                        return local_shard.RelationshipsGet(grouped_rel_ids);
                  });
           });
       }
@@ -5323,27 +9066,13 @@ namespace triton {
     if (rel_type_id != 0) {
       switch (direction) {
       case OUT: {
-        return container().invoke_on(node_shard_id, [external_id, rel_type_id](Shard &local_shard) { return local_shard.NodeGetOutgoingRelationships(external_id, rel_type_id); });
+        return PeerOn("NodeGetRelationships", node_shard_id, [external_id, rel_type_id](Shard &local_shard) { return local_shard.NodeGetOutgoingRelationships(external_id, rel_type_id); });
       }
       case IN: {
-        return container().invoke_on(node_shard_id, [external_id, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedIncomingRelationshipIDs(external_id, rel_type_id); })
-          .then([this](const std::map<uint16_t, std::vector<uint64_t>>& sharded_relationships_ids) {
-                 std::vector<seastar::future<std::vector<Relationship>>> futures;
-                 for (auto const &[their_shard, grouped_rel_ids] : sharded_relationships_ids) {
-                   auto future = container().invoke_on(their_shard, [grouped_rel_ids = grouped_rel_ids](Shard &local_shard) {
-                          return local_shard.RelationshipsGet(grouped_rel_ids);
-                   });
-                   futures.push_back(std::move(future));
-                 }
-
-                 auto p = make_shared(std::move(futures));
-                 return seastar::when_all_succeed(p->begin(), p->end()).then([](const std::vector<std::vector<Relationship>>& results) {
-                        std::vector<Relationship> combined;
-
-                        for (const std::vector<Relationship>& sharded : results) {
-                          combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                        }
-                        return combined;
+        return PeerOn("NodeGetRelationships", node_shard_id, [external_id, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedIncomingRelationshipIDs(external_id, rel_type_id); })
+          .then([this](std::map<uint16_t, std::vector<uint64_t>> sharded_relationships_ids) {
+                 return PeerScatter<Relationship>("NodeGetRelationships", std::move(sharded_relationships_ids), [] (Shard &local_shard, const std::vector<uint64_t>& grouped_rel_ids) {
+                        return local_shard.RelationshipsGet(grouped_rel_ids);
                  });
           });
       }
@@ -5360,29 +9089,15 @@ namespace triton {
 
     switch(direction) {
     case OUT: {
-      return container().invoke_on(node_shard_id, [external_id, rel_types](Shard &local_shard) {
+      return PeerOn("NodeGetRelationships", node_shard_id, [external_id, rel_types](Shard &local_shard) {
              return local_shard.NodeGetOutgoingRelationships(external_id, rel_types); });
     }
     case IN: {
-      return container().invoke_on(node_shard_id, [external_id, rel_types](Shard &local_shard) {
+      return PeerOn("NodeGetRelationships", node_shard_id, [external_id, rel_types](Shard &local_shard) {
                return local_shard.NodeGetShardedIncomingRelationshipIDs(external_id, rel_types); })
-        .then([this] (const std::map<uint16_t, std::vector<uint64_t>>& sharded_relationships_ids) {
-               std::vector<seastar::future<std::vector<Relationship>>> futures;
-               for (auto const& [their_shard, grouped_rel_ids] : sharded_relationships_ids ) {
-                 auto future = container().invoke_on(their_shard, [grouped_rel_ids = grouped_rel_ids] (Shard &local_shard) {
-                        return local_shard.RelationshipsGet(grouped_rel_ids);
-                 });
-                 futures.push_back(std::move(future));
-               }
-
-               auto p = make_shared(std::move(futures));
-               return seastar::when_all_succeed(p->begin(), p->end()).then([] (const std::vector<std::vector<Relationship>>& results) {
-                      std::vector<Relationship> combined;
-
-                      for(const std::vector<Relationship>& sharded : results) {
-                        combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                      }
-                      return combined;
+        .then([this] (std::map<uint16_t, std::vector<uint64_t>> sharded_relationships_ids) {
+               return PeerScatter<Relationship>("NodeGetRelationships", std::move(sharded_relationships_ids), [] (Shard &local_shard, const std::vector<uint64_t>& grouped_rel_ids) {
+                      return local_shard.RelationshipsGet(grouped_rel_ids);
                });
         });
     }
@@ -5391,54 +9106,82 @@ namespace triton {
   }
 
 
-  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(const std::string& type, const std::string& key) {
+  seastar::future<std::vector<Relationship>> Shard::NodeGetRelationshipsPeered(const std::string& type, const std::string& key, Direction direction, const std::vector<std::string> &rel_types, const std::vector<ScanFilter>& filters, uint64_t offset, uint64_t limit, NodeProjection projection) {
     uint16_t node_shard_id = CalculateShardId(type, key);
+    // Without filters the node shard cuts the page out of the ids itself
+    uint64_t ids_offset = filters.empty() ? offset : 0;
+    uint64_t ids_limit = filters.empty() ? limit : std::numeric_limits<uint64_t>::max();
+
+    return PeerOn("NodeGetRelationships", node_shard_id, [type, key, direction, rel_types, ids_offset, ids_limit](Shard &local_shard) {
+             return local_shard.NodeGetShardedRelationshipIDs(local_shard.NodeGetID(type, key), direction, rel_types, ids_offset, ids_limit); })
+      .then([filters, offset, limit, projection, this] (std::map<uint16_t, std::vector<uint64_t>> sharded_relationships_ids) {
+             return RelationshipsGetPagePeered(std::move(sharded_relationships_ids), filters, offset, limit, projection);
+      });
+  }
 
-    return container().invoke_on(node_shard_id, [type, key](Shard &local_shard) {
-             return local_shard.NodeGetShardedNodeIDs(type, key); })
-      .then([this] (const std::map<uint16_t, std::vector<uint64_t>>& sharded_nodes_ids) {
-             std::vector<seastar::future<std::vector<Node>>> futures;
-             for (auto const& [their_shard, grouped_node_ids] : sharded_nodes_ids ) {
-               auto future = container().invoke_on(their_shard, [grouped_node_ids = grouped_node_ids] (Shard &local_shard) {
-                      return local_shard.NodesGet(grouped_node_ids);
-               });
-               futures.push_back(std::move(future));
-             }
+  seastar::future<std::vector<Relationship>> Shard::NodeGetRelationshipsPeered(uint64_t external_id, Direction direction, const std::vector<std::string> &rel_types, const std::vector<ScanFilter>& filters, uint64_t offset, uint64_t limit, NodeProjection projection) {
+    uint16_t node_shard_id = CalculateShardId(external_id);
+    uint64_t ids_offset = filters.empty() ? offset : 0;
+    uint64_t ids_limit = filters.empty() ? limit : std::numeric_limits<uint64_t>::max();
 
-             auto p = make_shared(std::move(futures));
-             return seastar::when_all_succeed(p->begin(), p->end()).then([] (const std::vector<std::vector<Node>>& results) {
-                    std::vector<Node> combined;
+    return PeerOn("NodeGetRelationships", node_shard_id, [external_id, direction, rel_types, ids_offset, ids_limit](Shard &local_shard) {
+             return local_shard.NodeGetShardedRelationshipIDs(external_id, direction, rel_types, ids_offset, ids_limit); })
+      .then([filters, offset, limit, projection, this] (std::map<uint16_t, std::vector<uint64_t>> sharded_relationships_ids) {
+             return RelationshipsGetPagePeered(std::move(sharded_relationships_ids), filters, offset, limit, projection);
+      });
+  }
 
-                    for(const std::vector<Node>& sharded : results) {
-                      combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                    }
-                    return combined;
+  seastar::future<std::vector<Relationship>> Shard::RelationshipsGetPagePeered(std::map<uint16_t, std::vector<uint64_t>> sharded_relationships_ids, const std::vector<ScanFilter>& filters, uint64_t offset, uint64_t limit, NodeProjection projection) {
+    if (filters.empty()) {
+      return PeerScatter<Relationship>("NodeGetRelationships", std::move(sharded_relationships_ids), [projection] (Shard &local_shard, const std::vector<uint64_t>& grouped_rel_ids) {
+             return local_shard.RelationshipsGet(grouped_rel_ids, projection);
+      });
+    }
+
+    // Every shard stops once it has enough for the page, which is cut from their answers in shard order
+    uint64_t wanted = limit > std::numeric_limits<uint64_t>::max() - offset ? std::numeric_limits<uint64_t>::max() : offset + limit;
+    return PeerScatter<Relationship>("NodeGetRelationships", std::move(sharded_relationships_ids), [filters, wanted, projection] (Shard &local_shard, const std::vector<uint64_t>& grouped_rel_ids) {
+           return local_shard.RelationshipsGet(grouped_rel_ids, filters, wanted, projection);
+    }, wanted).then([offset] (std::vector<Relationship> page) {
+           page.erase(page.begin(), page.begin() + std::min<uint64_t>(offset, page.size()));
+           return page;
+    });
+  }
+
+  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(const std::string& type, const std::string& key, NodeProjection projection) {
+    uint16_t node_shard_id = CalculateShardId(type, key);
+
+    return PeerOn("NodeGetNeighbors", node_shard_id, [type, key](Shard &local_shard) {
+             return local_shard.NodeGetShardedNodeIDs(type, key); })
+      .then([projection, this] (std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids) {
+             return PeerScatter<Node>("NodeGetNeighbors", std::move(sharded_nodes_ids), [projection] (Shard &local_shard, const std::vector<uint64_t>& grouped_node_ids) {
+                    return local_shard.NodesGet(grouped_node_ids, projection);
              });
       });
   }
 
-  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(const std::string& type, const std::string& key, const std::string& rel_type) {
+  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(const std::string& type, const std::string& key, const std::string& rel_type, NodeProjection projection) {
     uint16_t node_shard_id = CalculateShardId(type, key);
     uint16_t rel_type_id = relationship_types.getTypeId(rel_type);
     if (rel_type_id > 0) {
-      return container().invoke_on(node_shard_id, [type, key, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedNodeIDs(type, key, rel_type_id); })
-        .then([this](const std::map<uint16_t, std::vector<uint64_t>> &sharded_nodes_ids) {
-               std::vector<seastar::future<std::vector<Node>>> futures;
-               for (auto const &[their_shard, grouped_node_ids] : sharded_nodes_ids) {
-                 auto future = container().invoke_on(their_shard, [grouped_node_ids = grouped_node_ids](Shard &local_shard) {
-                        return local_shard.NodesGet(grouped_node_ids);
-                 });
-                 futures.push_back(std::move(future));
-               }
+      return PeerOn("NodeGetNeighbors", node_shard_id, [type, key, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedNodeIDs(type, key, rel_type_id); })
+        .then([projection, this](std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids) {
+               return PeerScatter<Node>("NodeGetNeighbors", std::move(sharded_nodes_ids), [projection] (Shard &local_shard, const std::vector<uint64_t>& grouped_node_ids) {
+                      return local_shard.NodesGet(grouped_node_ids, projection);
+               });
+        });
+    }
 
-               auto p = make_shared(std::move(futures));
-               return seastar::when_all_succeed(p->begin(), p->end()).then([](const std::vector<std::vector<Node>> &results) {
-                      std::vector<Node> combined;
+    return seastar::make_ready_future<std::vector<Node>>();
+  }
 
-                      for (const std::vector<Node> &sharded : results) {
-                        combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                      }
-                      return combined;
+  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(const std::string& type, const std::string& key, uint16_t rel_type_id, NodeProjection projection) {
+    uint16_t node_shard_id = CalculateShardId(type, key);
+    if (rel_type_id > 0) {
+      return PeerOn("NodeGetNeighbors", node_shard_id, [type, key, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedNodeIDs(type, key, rel_type_id); })
+        .then([projection, this](std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids) {
+               return PeerScatter<Node>("NodeGetNeighbors", std::move(sharded_nodes_ids), [projection] (Shard &local_shard, const std::vector<uint64_t>& grouped_node_ids) {
+                      return local_shard.NodesGet(grouped_node_ids, projection);
                });
         });
     }
@@ -5446,607 +9189,1217 @@ namespace triton {
     return seastar::make_ready_future<std::vector<Node>>();
   }
 
-  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(const std::string& type, const std::string& key, uint16_t rel_type_id) {
+  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(const std::string& type, const std::string& key, const std::vector<std::string> &rel_types, NodeProjection projection) {
     uint16_t node_shard_id = CalculateShardId(type, key);
+    return PeerOn("NodeGetNeighbors", node_shard_id, [type, key, rel_types](Shard &local_shard) { return local_shard.NodeGetShardedNodeIDs(type, key, rel_types); })
+      .then([projection, this](std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids) {
+             return PeerScatter<Node>("NodeGetNeighbors", std::move(sharded_nodes_ids), [projection] (Shard &local_shard, const std::vector<uint64_t>& grouped_node_ids) {
+                    return local_shard.NodesGet(grouped_node_ids, projection);
+             });
+      });
+  }
+
+  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(uint64_t external_id, NodeProjection projection) {
+    uint16_t node_shard_id = CalculateShardId(external_id);
+
+    return PeerOn("NodeGetNeighbors", node_shard_id, [external_id](Shard &local_shard) {
+             return local_shard.NodeGetShardedNodeIDs(external_id); })
+      .then([projection, this] (std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids) {
+             return PeerScatter<Node>("NodeGetNeighbors", std::move(sharded_nodes_ids), [projection] (Shard &local_shard, const std::vector<uint64_t>& grouped_node_ids) {
+                    return local_shard.NodesGet(grouped_node_ids, projection);
+             });
+      });
+  }
+
+  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(uint64_t external_id, const std::string& rel_type, NodeProjection projection) {
+    uint16_t node_shard_id = CalculateShardId(external_id);
+    uint16_t rel_type_id = relationship_types.getTypeId(rel_type);
+    if (rel_type_id > 0) {
+      return PeerOn("NodeGetNeighbors", node_shard_id, [external_id, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedNodeIDs(external_id, rel_type_id); })
+        .then([projection, this](std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids) {
+               return PeerScatter<Node>("NodeGetNeighbors", std::move(sharded_nodes_ids), [projection] (Shard &local_shard, const std::vector<uint64_t>& grouped_node_ids) {
+                      return local_shard.NodesGet(grouped_node_ids, projection);
+               });
+        });
+    }
+
+    return seastar::make_ready_future<std::vector<Node>>();
+  }
+
+  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(uint64_t external_id,  uint16_t rel_type_id, NodeProjection projection) {
+    uint16_t node_shard_id = CalculateShardId(external_id);
     if (rel_type_id > 0) {
-      return container().invoke_on(node_shard_id, [type, key, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedNodeIDs(type, key, rel_type_id); })
-        .then([this](const std::map<uint16_t, std::vector<uint64_t>> &sharded_nodes_ids) {
-               std::vector<seastar::future<std::vector<Node>>> futures;
-               for (auto const &[their_shard, grouped_node_ids] : sharded_nodes_ids) {
-                 auto future = container().invoke_on(their_shard, [grouped_node_ids = grouped_node_ids](Shard &local_shard) {
-                        return local_shard.NodesGet(grouped_node_ids);
+      return PeerOn("NodeGetNeighbors", node_shard_id, [external_id, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedNodeIDs(external_id, rel_type_id); })
+        .then([projection, this](std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids) {
+               return PeerScatter<Node>("NodeGetNeighbors", std::move(sharded_nodes_ids), [projection] (Shard &local_shard, const std::vector<uint64_t>& grouped_node_ids) {
+                      return local_shard.NodesGet(grouped_node_ids, projection);
+               });
+        });
+    }
+
+    return seastar::make_ready_future<std::vector<Node>>();
+  }
+
+  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(uint64_t external_id, const std::vector<std::string> &rel_types, NodeProjection projection) {
+    uint16_t node_shard_id = CalculateShardId(external_id);
+    return PeerOn("NodeGetNeighbors", node_shard_id, [external_id, rel_types](Shard &local_shard) { return local_shard.NodeGetShardedNodeIDs(external_id, rel_types); })
+      .then([projection, this](std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids) {
+             return PeerScatter<Node>("NodeGetNeighbors", std::move(sharded_nodes_ids), [projection] (Shard &local_shard, const std::vector<uint64_t>& grouped_node_ids) {
+                    return local_shard.NodesGet(grouped_node_ids, projection);
+             });
+      });
+  }
+
+
+  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(const std::string& type, const std::string& key, Direction direction, NodeProjection projection) {
+    uint16_t node_shard_id = CalculateShardId(type, key);
+
+    switch(direction) {
+    case OUT: {
+      return PeerOn("NodeGetNeighbors", node_shard_id, [type, key](Shard &local_shard) {
+               return local_shard.NodeGetShardedOutgoingNodeIDs(type, key); })
+        .then([projection, this] (std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids) {
+               return PeerScatter<Node>("NodeGetNeighbors", std::move(sharded_nodes_ids), [projection] (Shard &local_shard, const std::vector<uint64_t>& grouped_node_ids) {
+                      return local_shard.NodesGet(grouped_node_ids, projection);
+               });
+        });
+    }
+    case IN: {
+      return PeerOn("NodeGetNeighbors", node_shard_id, [type, key](Shard &local_shard) {
+               return local_shard.NodeGetShardedIncomingNodeIDs(type, key); })
+        .then([projection, this] (std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids) {
+               return PeerScatter<Node>("NodeGetNeighbors", std::move(sharded_nodes_ids), [projection] (Shard &local_shard, const std::vector<uint64_t>& grouped_node_ids) {
+                      return local_shard.NodesGet(grouped_node_ids, projection);
+               });
+        });
+    }
+    default: return NodeGetNeighborsPeered(type, key, projection);
+    }
+  }
+
+  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(const std::string& type, const std::string& key, Direction direction, const std::string& rel_type, NodeProjection projection) {
+    uint16_t node_shard_id = CalculateShardId(type, key);
+    uint16_t rel_type_id = relationship_types.getTypeId(rel_type);
+    if (rel_type_id != 0) {
+      switch (direction) {
+      case OUT: {
+        return PeerOn("NodeGetNeighbors", node_shard_id, [type, key, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedOutgoingNodeIDs(type, key, rel_type_id); })
+          .then([projection, this](std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids) {
+                 return PeerScatter<Node>("NodeGetNeighbors", std::move(sharded_nodes_ids), [projection] (Shard &local_shard, const std::vector<uint64_t>& grouped_node_ids) {
+                        return local_shard.NodesGet(grouped_node_ids, projection);
                  });
-                 futures.push_back(std::move(future));
-               }
+          });
+      }
+      case IN: {
+        return PeerOn("NodeGetNeighbors", node_shard_id, [type, key, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedIncomingNodeIDs(type, key, rel_type_id); })
+          .then([projection, this](std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids) {
+                 return PeerScatter<Node>("NodeGetNeighbors", std::move(sharded_nodes_ids), [projection] (Shard &local_shard, const std::vector<uint64_t>& grouped_node_ids) {
+                        return local_shard.NodesGet(grouped_node_ids, projection);
+                 });
+          });
+      }
+      default:
+        return NodeGetNeighborsPeered(type, key, rel_type_id, projection);
+      }
+    }
 
-               auto p = make_shared(std::move(futures));
-               return seastar::when_all_succeed(p->begin(), p->end()).then([](const std::vector<std::vector<Node>> &results) {
-                      std::vector<Node> combined;
+    return seastar::make_ready_future<std::vector<Node>>();
+  }
 
-                      for (const std::vector<Node> &sharded : results) {
-                        combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                      }
-                      return combined;
+  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(const std::string& type, const std::string& key, Direction direction, uint16_t rel_type_id, NodeProjection projection) {
+    uint16_t node_shard_id = CalculateShardId(type, key);
+    if (rel_type_id != 0) {
+      switch (direction) {
+      case OUT: {
+        return PeerOn("NodeGetNeighbors", node_shard_id, [type, key, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedOutgoingNodeIDs(type, key, rel_type_id); })
+          .then([projection, this](std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids) {
+                 return PeerScatter<Node>("NodeGetNeighbors", std::move(sharded_nodes_ids), [projection] (Shard &local_shard, const std::vector<uint64_t>& grouped_node_ids) {
+                        return local_shard.NodesGet(grouped_node_ids, projection);
+                 });
+          });
+      }
+      case IN: {
+        return PeerOn("NodeGetNeighbors", node_shard_id, [type, key, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedIncomingNodeIDs(type, key, rel_type_id); })
+          .then([projection, this](std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids) {
+                 return PeerScatter<Node>("NodeGetNeighbors", std::move(sharded_nodes_ids), [projection] (Shard &local_shard, const std::vector<uint64_t>& grouped_node_ids) {
+                        return local_shard.NodesGet(grouped_node_ids, projection);
+                 });
+          });
+      }
+      default:
+        return NodeGetNeighborsPeered(type, key, rel_type_id, projection);
+      }
+    }
+
+    return seastar::make_ready_future<std::vector<Node>>();
+  }
+
+  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(const std::string& type, const std::string& key, Direction direction, const std::vector<std::string> &rel_types, NodeProjection projection) {
+    uint16_t node_shard_id = CalculateShardId(type, key);
+
+    switch(direction) {
+    case OUT: {
+      return PeerOn("NodeGetNeighbors", node_shard_id, [type, key, rel_types](Shard &local_shard) {
+               return local_shard.NodeGetShardedOutgoingNodeIDs(type, key, rel_types); })
+        .then([projection, this] (std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids) {
+               return PeerScatter<Node>("NodeGetNeighbors", std::move(sharded_nodes_ids), [projection] (Shard &local_shard, const std::vector<uint64_t>& grouped_node_ids) {
+                      return local_shard.NodesGet(grouped_node_ids, projection);
+               });
+        });
+    }
+    case IN: {
+      return PeerOn("NodeGetNeighbors", node_shard_id, [type, key, rel_types](Shard &local_shard) {
+               return local_shard.NodeGetShardedIncomingNodeIDs(type, key, rel_types); })
+        .then([projection, this] (std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids) {
+               return PeerScatter<Node>("NodeGetNeighbors", std::move(sharded_nodes_ids), [projection] (Shard &local_shard, const std::vector<uint64_t>& grouped_node_ids) {
+                      return local_shard.NodesGet(grouped_node_ids, projection);
+               });
+        });
+    }
+    default: return NodeGetNeighborsPeered(type, key, rel_types, projection);
+    }
+  }
+
+
+  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(uint64_t external_id, Direction direction, NodeProjection projection) {
+    uint16_t node_shard_id = CalculateShardId(external_id);
+
+    switch(direction) {
+    case OUT: {
+      return PeerOn("NodeGetNeighbors", node_shard_id, [external_id](Shard &local_shard) {
+               return local_shard.NodeGetShardedOutgoingNodeIDs(external_id); })
+        .then([projection, this] (std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids) {
+               return PeerScatter<Node>("NodeGetNeighbors", std::move(sharded_nodes_ids), [projection] (Shard &local_shard, const std::vector<uint64_t>& grouped_node_ids) {
+                      return local_shard.NodesGet(grouped_node_ids, projection);
+               });
+        });
+    }
+    case IN: {
+      return PeerOn("NodeGetNeighbors", node_shard_id, [external_id](Shard &local_shard) {
+               return local_shard.NodeGetShardedIncomingNodeIDs(external_id); })
+        .then([projection, this] (std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids) {
+               return PeerScatter<Node>("NodeGetNeighbors", std::move(sharded_nodes_ids), [projection] (Shard &local_shard, const std::vector<uint64_t>& grouped_node_ids) {
+                      return local_shard.NodesGet(grouped_node_ids, projection);
+               });
+        });
+    }
+    default: return NodeGetNeighborsPeered(external_id, projection);
+    }
+  }
+
+  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(uint64_t external_id, Direction direction, const std::string& rel_type, NodeProjection projection) {
+    uint16_t node_shard_id = CalculateShardId(external_id);
+    uint16_t rel_type_id = relationship_types.getTypeId(rel_type);
+    if (rel_type_id != 0) {
+      switch (direction) {
+      case OUT: {
+        return PeerOn("NodeGetNeighbors", node_shard_id, [external_id, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedOutgoingNodeIDs(external_id, rel_type_id); })
+          .then([projection, this](std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids) {
+                 return PeerScatter<Node>("NodeGetNeighbors", std::move(sharded_nodes_ids), [projection] (Shard &local_shard, const std::vector<uint64_t>& grouped_node_ids) {
+                        return local_shard.NodesGet(grouped_node_ids, projection);
+                 });
+          });
+      }
+      case IN: {
+        return PeerOn("NodeGetNeighbors", node_shard_id, [external_id, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedIncomingNodeIDs(external_id, rel_type_id); })
+          .then([projection, this](std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids) {
+                 return PeerScatter<Node>("NodeGetNeighbors", std::move(sharded_nodes_ids), [projection] (Shard &local_shard, const std::vector<uint64_t>& grouped_node_ids) {
+                        return local_shard.NodesGet(grouped_node_ids, projection);
+                 });
+          });
+      }
+      default:
+        return NodeGetNeighborsPeered(external_id, rel_type_id, projection);
+      }
+    }
+
+    return seastar::make_ready_future<std::vector<Node>>();
+  }
+
+  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(uint64_t external_id, Direction direction, uint16_t rel_type_id, NodeProjection projection) {
+    uint16_t node_shard_id = CalculateShardId(external_id);
+    if (rel_type_id != 0) {
+      switch (direction) {
+      case OUT: {
+        return PeerOn("NodeGetNeighbors", node_shard_id, [external_id, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedOutgoingNodeIDs(external_id, rel_type_id); })
+          .then([projection, this](std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids) {
+                 return PeerScatter<Node>("NodeGetNeighbors", std::move(sharded_nodes_ids), [projection] (Shard &local_shard, const std::vector<uint64_t>& grouped_node_ids) {
+                        return local_shard.NodesGet(grouped_node_ids, projection);
+                 });
+          });
+      }
+      case IN: {
+        return PeerOn("NodeGetNeighbors", node_shard_id, [external_id, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedIncomingNodeIDs(external_id, rel_type_id); })
+          .then([projection, this](std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids) {
+                 return PeerScatter<Node>("NodeGetNeighbors", std::move(sharded_nodes_ids), [projection] (Shard &local_shard, const std::vector<uint64_t>& grouped_node_ids) {
+                        return local_shard.NodesGet(grouped_node_ids, projection);
+                 });
+          });
+      }
+      default:
+        return NodeGetNeighborsPeered(external_id, rel_type_id, projection);
+      }
+    }
+
+    return seastar::make_ready_future<std::vector<Node>>();
+  }
+
+  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(uint64_t external_id, Direction direction, const std::vector<std::string> &rel_types, NodeProjection projection) {
+    uint16_t node_shard_id = CalculateShardId(external_id);
+
+    switch(direction) {
+    case OUT: {
+      return PeerOn("NodeGetNeighbors", node_shard_id, [external_id, rel_types](Shard &local_shard) {
+               return local_shard.NodeGetShardedOutgoingNodeIDs(external_id, rel_types); })
+        .then([projection, this] (std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids) {
+               return PeerScatter<Node>("NodeGetNeighbors", std::move(sharded_nodes_ids), [projection] (Shard &local_shard, const std::vector<uint64_t>& grouped_node_ids) {
+                      return local_shard.NodesGet(grouped_node_ids, projection);
                });
         });
     }
-
-    return seastar::make_ready_future<std::vector<Node>>();
+    case IN: {
+      return PeerOn("NodeGetNeighbors", node_shard_id, [external_id, rel_types](Shard &local_shard) {
+               return local_shard.NodeGetShardedIncomingNodeIDs(external_id, rel_types); })
+        .then([projection, this] (std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids) {
+               return PeerScatter<Node>("NodeGetNeighbors", std::move(sharded_nodes_ids), [projection] (Shard &local_shard, const std::vector<uint64_t>& grouped_node_ids) {
+                      return local_shard.NodesGet(grouped_node_ids, projection);
+               });
+        });
+    }
+    default: return NodeGetNeighborsPeered(external_id, rel_types, projection);
+    }
   }
 
-  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(const std::string& type, const std::string& key, const std::vector<std::string> &rel_types) {
+  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(const std::string& type, const std::string& key, Direction direction, const std::vector<std::string> &rel_types, const std::string& node_type, const std::vector<ScanFilter>& filters, uint64_t offset, uint64_t limit, NodeProjection projection) {
     uint16_t node_shard_id = CalculateShardId(type, key);
-    return container().invoke_on(node_shard_id, [type, key, rel_types](Shard &local_shard) { return local_shard.NodeGetShardedNodeIDs(type, key, rel_types); })
-      .then([this](const std::map<uint16_t, std::vector<uint64_t>> &sharded_nodes_ids) {
-             std::vector<seastar::future<std::vector<Node>>> futures;
-             for (auto const &[their_shard, grouped_node_ids] : sharded_nodes_ids) {
-               auto future = container().invoke_on(their_shard, [grouped_node_ids = grouped_node_ids](Shard &local_shard) {
-                      return local_shard.NodesGet(grouped_node_ids);
-               });
-               futures.push_back(std::move(future));
-             }
+    uint16_t node_type_id = node_type.empty() ? 0 : node_types.getTypeId(node_type);
+    if (!node_type.empty() && node_type_id == 0) {
+      return seastar::make_ready_future<std::vector<Node>>();
+    }
+    // Without a node type or filters the node shard cuts the page out of the ids itself
+    bool cut = node_type_id == 0 && filters.empty();
+    uint64_t ids_offset = cut ? offset : 0;
+    uint64_t ids_limit = cut ? limit : std::numeric_limits<uint64_t>::max();
+
+    return PeerOn("NodeGetNeighbors", node_shard_id, [type, key, direction, rel_types, ids_offset, ids_limit](Shard &local_shard) {
+             return local_shard.NodeGetShardedNodeIDs(local_shard.NodeGetID(type, key), direction, rel_types, ids_offset, ids_limit); })
+      .then([node_type_id, filters, offset, limit, projection, this] (std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids) {
+             return NodesGetPagePeered(std::move(sharded_nodes_ids), node_type_id, filters, offset, limit, projection);
+      });
+  }
 
-             auto p = make_shared(std::move(futures));
-             return seastar::when_all_succeed(p->begin(), p->end()).then([](const std::vector<std::vector<Node>> &results) {
-                    std::vector<Node> combined;
+  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(uint64_t external_id, Direction direction, const std::vector<std::string> &rel_types, const std::string& node_type, const std::vector<ScanFilter>& filters, uint64_t offset, uint64_t limit, NodeProjection projection) {
+    uint16_t node_shard_id = CalculateShardId(external_id);
+    uint16_t node_type_id = node_type.empty() ? 0 : node_types.getTypeId(node_type);
+    if (!node_type.empty() && node_type_id == 0) {
+      return seastar::make_ready_future<std::vector<Node>>();
+    }
+    bool cut = node_type_id == 0 && filters.empty();
+    uint64_t ids_offset = cut ? offset : 0;
+    uint64_t ids_limit = cut ? limit : std::numeric_limits<uint64_t>::max();
+
+    return PeerOn("NodeGetNeighbors", node_shard_id, [external_id, direction, rel_types, ids_offset, ids_limit](Shard &local_shard) {
+             return local_shard.NodeGetShardedNodeIDs(external_id, direction, rel_types, ids_offset, ids_limit); })
+      .then([node_type_id, filters, offset, limit, projection, this] (std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids) {
+             return NodesGetPagePeered(std::move(sharded_nodes_ids), node_type_id, filters, offset, limit, projection);
+      });
+  }
 
-                    for (const std::vector<Node> &sharded : results) {
-                      combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                    }
-                    return combined;
-             });
+  seastar::future<std::vector<Node>> Shard::NodesGetPagePeered(std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids, uint16_t node_type_id, const std::vector<ScanFilter>& filters, uint64_t offset, uint64_t limit, NodeProjection projection) {
+    if (node_type_id == 0 && filters.empty()) {
+      return PeerScatter<Node>("NodeGetNeighbors", std::move(sharded_nodes_ids), [projection] (Shard &local_shard, const std::vector<uint64_t>& grouped_node_ids) {
+             return local_shard.NodesGet(grouped_node_ids, projection);
       });
+    }
+
+    // Every shard stops once it has enough for the page, which is cut from their answers in shard order
+    uint64_t wanted = limit > std::numeric_limits<uint64_t>::max() - offset ? std::numeric_limits<uint64_t>::max() : offset + limit;
+    return PeerScatter<Node>("NodeGetNeighbors", std::move(sharded_nodes_ids), [node_type_id, filters, wanted, projection] (Shard &local_shard, const std::vector<uint64_t>& grouped_node_ids) {
+           return local_shard.NodesGet(grouped_node_ids, node_type_id, filters, wanted, projection);
+    }, wanted).then([offset] (std::vector<Node> page) {
+           page.erase(page.begin(), page.begin() + std::min<uint64_t>(offset, page.size()));
+           return page;
+    });
   }
 
-  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(uint64_t external_id) {
-    uint16_t node_shard_id = CalculateShardId(external_id);
+  // Traversals
+  seastar::future<std::vector<Node>> Shard::TraversePeered(const std::vector<uint64_t>& ids, const std::vector<TraverseStep>& steps, TraverseDedup dedup) {
+    // The shard the traversal started on is in the low bits, so ids are unique across shards
+    uint64_t traversal_id = (++traversal_count << SHIFTED_BITS) + shard_id;
 
-    return container().invoke_on(node_shard_id, [external_id](Shard &local_shard) {
-             return local_shard.NodeGetShardedNodeIDs(external_id); })
-      .then([this] (const std::map<uint16_t, std::vector<uint64_t>>& sharded_nodes_ids) {
-             std::vector<seastar::future<std::vector<Node>>> futures;
-             for (auto const& [their_shard, grouped_node_ids] : sharded_nodes_ids ) {
-               auto future = container().invoke_on(their_shard, [grouped_node_ids = grouped_node_ids] (Shard &local_shard) {
-                      return local_shard.NodesGet(grouped_node_ids);
-               });
-               futures.push_back(std::move(future));
-             }
+    std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids;
+    for (uint64_t id : ids) {
+      sharded_nodes_ids[CalculateShardId(id)].push_back(id);
+    }
 
-             auto p = make_shared(std::move(futures));
-             return seastar::when_all_succeed(p->begin(), p->end()).then([] (const std::vector<std::vector<Node>>& results) {
-                    std::vector<Node> combined;
+    return seastar::do_with(std::vector<TraverseStep>(steps), size_t(0), [traversal_id, dedup, sharded_nodes_ids = std::move(sharded_nodes_ids), this] (std::vector<TraverseStep>& steps, size_t& hop) {
+      // The start nodes are hop zero of the shards that own them
+      std::vector<seastar::future<>> futures;
+      for (auto const& [their_shard, grouped_node_ids] : sharded_nodes_ids) {
+        auto future = PeerOn("Traverse", their_shard, [traversal_id, dedup, grouped_node_ids = grouped_node_ids] (Shard &local_shard) {
+               local_shard.TraverseReceive(traversal_id, 0, 0, dedup, grouped_node_ids);
+        });
+        futures.push_back(std::move(future));
+      }
 
-                    for(const std::vector<Node>& sharded : results) {
-                      combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
+      auto p = make_shared(std::move(futures));
+      return seastar::when_all_succeed(p->begin(), p->end()).then([&steps, &hop, traversal_id, dedup, this] () {
+             // Every shard expands its part of a hop before any shard starts the next one
+             return seastar::repeat([&steps, &hop, traversal_id, dedup, this] () {
+                    if (hop == steps.size()) {
+                      return seastar::make_ready_future<seastar::stop_iteration>(seastar::stop_iteration::yes);
                     }
-                    return combined;
+                    return PeerMap("TraverseExpand", [traversal_id, hop = hop, step = steps.at(hop), dedup] (Shard &local_shard) {
+                             return local_shard.TraverseExpand(traversal_id, hop, step, dedup);
+                      })
+                      .then([&steps, &hop] (std::vector<uint64_t> counts) {
+                             // Nothing was reached, so the later hops would find nothing either
+                             bool empty = accumulate(std::begin(counts), std::end(counts), uint64_t(0)) == 0;
+                             hop = empty ? steps.size() : hop + 1;
+                             return seastar::stop_iteration::no;
+                      });
              });
-      });
-  }
-
-  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(uint64_t external_id, const std::string& rel_type) {
-    uint16_t node_shard_id = CalculateShardId(external_id);
-    uint16_t rel_type_id = relationship_types.getTypeId(rel_type);
-    if (rel_type_id > 0) {
-      return container().invoke_on(node_shard_id, [external_id, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedNodeIDs(external_id, rel_type_id); })
-        .then([this](const std::map<uint16_t, std::vector<uint64_t>> &sharded_nodes_ids) {
-               std::vector<seastar::future<std::vector<Node>>> futures;
-               for (auto const &[their_shard, grouped_node_ids] : sharded_nodes_ids) {
-                 auto future = container().invoke_on(their_shard, [grouped_node_ids = grouped_node_ids](Shard &local_shard) {
-                        return local_shard.NodesGet(grouped_node_ids);
-                 });
-                 futures.push_back(std::move(future));
-               }
-
-               auto p = make_shared(std::move(futures));
-               return seastar::when_all_succeed(p->begin(), p->end()).then([](const std::vector<std::vector<Node>> &results) {
+      }).then([&hop, traversal_id, this] () {
+             return PeerMap("TraverseCollect", [traversal_id, hop = hop] (Shard &local_shard) {
+                      return local_shard.TraverseCollect(traversal_id, hop);
+               })
+               .then([] (std::vector<std::vector<Node>> results) {
                       std::vector<Node> combined;
 
-                      for (const std::vector<Node> &sharded : results) {
-                        combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
+                      for(std::vector<Node>& sharded : results) {
+                        combined.insert(std::end(combined), std::make_move_iterator(std::begin(sharded)), std::make_move_iterator(std::end(sharded)));
                       }
                       return combined;
                });
-        });
-    }
-
-    return seastar::make_ready_future<std::vector<Node>>();
+      });
+    });
   }
 
-  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(uint64_t external_id,  uint16_t rel_type_id) {
-    uint16_t node_shard_id = CalculateShardId(external_id);
-    if (rel_type_id > 0) {
-      return container().invoke_on(node_shard_id, [external_id, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedNodeIDs(external_id, rel_type_id); })
-        .then([this](const std::map<uint16_t, std::vector<uint64_t>> &sharded_nodes_ids) {
-               std::vector<seastar::future<std::vector<Node>>> futures;
-               for (auto const &[their_shard, grouped_node_ids] : sharded_nodes_ids) {
-                 auto future = container().invoke_on(their_shard, [grouped_node_ids = grouped_node_ids](Shard &local_shard) {
-                        return local_shard.NodesGet(grouped_node_ids);
-                 });
-                 futures.push_back(std::move(future));
-               }
+  seastar::future<std::vector<Node>> Shard::TraversePeered(const std::string& query) {
+    // { "ids": [...], "steps": [{ "direction": "out", "rel_types": [...], "node_type": "..." }, ...], "dedup": "hop" }
+    dom::object object;
+    dom::array id_array;
+    dom::array step_array;
+    if (parser.parse(query).get(object) || object["ids"].get(id_array) || object["steps"].get(step_array)) {
+      return seastar::make_exception_future<std::vector<Node>>(std::invalid_argument("Invalid traversal"));
+    }
 
-               auto p = make_shared(std::move(futures));
-               return seastar::when_all_succeed(p->begin(), p->end()).then([](const std::vector<std::vector<Node>> &results) {
-                      std::vector<Node> combined;
+    std::vector<uint64_t> ids;
+    for (dom::element element : id_array) {
+      uint64_t id;
+      if (!element.get(id)) {
+        ids.push_back(id);
+      }
+    }
+
+    std::vector<TraverseStep> steps;
+    for (dom::element element : step_array) {
+      dom::object step;
+      if (element.get(step)) {
+        return seastar::make_exception_future<std::vector<Node>>(std::invalid_argument("Invalid traversal step"));
+      }
+      std::string_view direction;
+      if (step["direction"].get(direction)) {
+        direction = "all";
+      }
+      std::vector<std::string> rel_types;
+      dom::array rel_type_array;
+      if (!step["rel_types"].get(rel_type_array)) {
+        for (dom::element rel_type : rel_type_array) {
+          std::string_view name;
+          if (!rel_type.get(name)) {
+            rel_types.emplace_back(name);
+          }
+        }
+      }
+      std::string_view node_type;
+      if (step["node_type"].get(node_type)) {
+        node_type = "";
+      }
+      steps.push_back(TraverseStepFor(direction, rel_types, std::string(node_type)));
+    }
 
-                      for (const std::vector<Node> &sharded : results) {
-                        combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                      }
-                      return combined;
-               });
-        });
+    std::string_view dedup;
+    if (!object["dedup"].get(dedup) && dedup == "hop") {
+      return TraversePeered(ids, steps, TraverseDedup::HOP);
     }
+    return TraversePeered(ids, steps, TraverseDedup::GLOBAL);
+  }
 
-    return seastar::make_ready_future<std::vector<Node>>();
+  // Id Maps
+  seastar::future<Roaring64Map> Shard::NodeGetNeighborIdsMapPeered(uint64_t id, Direction direction) {
+    uint16_t node_shard_id = CalculateShardId(id);
+
+    return PeerOn("NodeGetNeighborIdsMap", node_shard_id, [id, direction] (Shard &local_shard) {
+             return local_shard.NodeGetShardedNodeIdsMap(id, direction);
+      })
+      .then([] (const std::map<uint16_t, Roaring64Map>& sharded_nodes_ids) {
+             Roaring64Map combined;
+             for (auto const& [their_shard, grouped_node_ids] : sharded_nodes_ids) {
+               combined |= grouped_node_ids;
+             }
+             return combined;
+      });
   }
 
-  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(uint64_t external_id, const std::vector<std::string> &rel_types) {
-    uint16_t node_shard_id = CalculateShardId(external_id);
-    return container().invoke_on(node_shard_id, [external_id, rel_types](Shard &local_shard) { return local_shard.NodeGetShardedNodeIDs(external_id, rel_types); })
-      .then([this](const std::map<uint16_t, std::vector<uint64_t>> &sharded_nodes_ids) {
-             std::vector<seastar::future<std::vector<Node>>> futures;
-             for (auto const &[their_shard, grouped_node_ids] : sharded_nodes_ids) {
-               auto future = container().invoke_on(their_shard, [grouped_node_ids = grouped_node_ids](Shard &local_shard) {
-                      return local_shard.NodesGet(grouped_node_ids);
-               });
-               futures.push_back(std::move(future));
+  seastar::future<Roaring64Map> Shard::NodeGetNeighborIdsMapPeered(uint64_t id, Direction direction, const std::vector<std::string> &rel_types) {
+    uint16_t node_shard_id = CalculateShardId(id);
+
+    return PeerOn("NodeGetNeighborIdsMap", node_shard_id, [id, direction, rel_types] (Shard &local_shard) {
+             return local_shard.NodeGetShardedNodeIdsMap(id, direction, rel_types);
+      })
+      .then([] (const std::map<uint16_t, Roaring64Map>& sharded_nodes_ids) {
+             Roaring64Map combined;
+             for (auto const& [their_shard, grouped_node_ids] : sharded_nodes_ids) {
+               combined |= grouped_node_ids;
              }
+             return combined;
+      });
+  }
 
-             auto p = make_shared(std::move(futures));
-             return seastar::when_all_succeed(p->begin(), p->end()).then([](const std::vector<std::vector<Node>> &results) {
-                    std::vector<Node> combined;
+  seastar::future<Roaring64Map> Shard::NodeIdsMapFilterPeered(const Roaring64Map& ids, const std::string& type) {
+    // Each shard only knows the types of its own nodes
+    std::map<uint16_t, Roaring64Map> sharded_nodes_ids;
+    for (uint64_t id : ids) {
+      sharded_nodes_ids[CalculateShardId(id)].add(id);
+    }
 
-                    for (const std::vector<Node> &sharded : results) {
-                      combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                    }
-                    return combined;
-             });
+    std::vector<seastar::future<Roaring64Map>> futures;
+    for (auto& [their_shard, grouped_node_ids] : sharded_nodes_ids) {
+      auto future = PeerOn("NodeIdsMapFilter", their_shard, [grouped_node_ids = std::move(grouped_node_ids), type] (Shard &local_shard) {
+             return local_shard.NodeIdsMapFilter(grouped_node_ids, type);
+      });
+      futures.push_back(std::move(future));
+    }
+
+    auto p = make_shared(std::move(futures));
+    return seastar::when_all_succeed(p->begin(), p->end()).then([] (const std::vector<Roaring64Map>& results) {
+           Roaring64Map combined;
+           for (const Roaring64Map& sharded : results) {
+             combined |= sharded;
+           }
+           return combined;
+    });
+  }
+
+  seastar::future<Roaring64Map> Shard::AllNodeIdsMapPeered(const std::string& type) {
+    return PeerMap("AllNodeIdsMap", [type] (Shard &local_shard) {
+             return local_shard.AllNodeIdsMap(type);
+      })
+      .then([] (const std::vector<Roaring64Map>& results) {
+             Roaring64Map combined;
+             for (const Roaring64Map& sharded : results) {
+               combined |= sharded;
+             }
+             return combined;
       });
   }
 
+  seastar::future<std::vector<Node>> Shard::NodesGetPeered(const Roaring64Map& ids, NodeProjection projection) {
+    std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids;
+    for (uint64_t id : ids) {
+      sharded_nodes_ids[CalculateShardId(id)].push_back(id);
+    }
 
-  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(const std::string& type, const std::string& key, Direction direction) {
-    uint16_t node_shard_id = CalculateShardId(type, key);
+    std::vector<seastar::future<std::vector<Node>>> futures;
+    for (auto& [their_shard, grouped_node_ids] : sharded_nodes_ids) {
+      auto future = PeerOn("NodesGet", their_shard, [grouped_node_ids = std::move(grouped_node_ids), projection] (Shard &local_shard) {
+             return local_shard.NodesGet(grouped_node_ids, projection);
+      });
+      futures.push_back(std::move(future));
+    }
 
-    switch(direction) {
-    case OUT: {
-      return container().invoke_on(node_shard_id, [type, key](Shard &local_shard) {
-               return local_shard.NodeGetShardedOutgoingNodeIDs(type, key); })
-        .then([this] (const std::map<uint16_t, std::vector<uint64_t>>& sharded_nodes_ids) {
-               std::vector<seastar::future<std::vector<Node>>> futures;
-               for (auto const& [their_shard, grouped_node_ids] : sharded_nodes_ids ) {
-                 auto future = container().invoke_on(their_shard, [grouped_node_ids = grouped_node_ids] (Shard &local_shard) {
-                        return local_shard.NodesGet(grouped_node_ids);
-                 });
-                 futures.push_back(std::move(future));
-               }
+    auto p = make_shared(std::move(futures));
+    return seastar::when_all_succeed(p->begin(), p->end()).then([] (std::vector<std::vector<Node>> results) {
+           std::vector<Node> combined;
 
-               auto p = make_shared(std::move(futures));
-               return seastar::when_all_succeed(p->begin(), p->end()).then([] (const std::vector<std::vector<Node>>& results) {
-                      std::vector<Node> combined;
+           for(std::vector<Node>& sharded : results) {
+             combined.insert(std::end(combined), std::make_move_iterator(std::begin(sharded)), std::make_move_iterator(std::end(sharded)));
+           }
+           return combined;
+    });
+  }
 
-                      for(const std::vector<Node>& sharded : results) {
+  // Algorithms
+  seastar::future<std::vector<std::pair<uint64_t, double>>> Shard::AlgorithmPeered(AlgorithmKind kind, const std::vector<uint64_t>& sources, Direction direction,
+                                                                                   const std::vector<std::string>& rel_types, uint64_t iterations, double damping, const std::string& property) {
+    // The shard the algorithm started on is in the low bits, so ids are unique across shards
+    uint64_t algorithm_id = (++algorithm_count << SHIFTED_BITS) + shard_id;
+
+    std::vector<uint16_t> rel_type_ids;
+    for (const auto& rel_type : rel_types) {
+      // An unknown relationship type matches nothing, rather than everything like an empty list
+      rel_type_ids.push_back(relationship_types.getTypeId(rel_type));
+    }
+
+    return PeerOnAll("Algorithm", [algorithm_id, kind, sources] (Shard &local_shard) {
+             local_shard.AlgorithmStart(algorithm_id, kind, sources);
+      }).then([algorithm_id, direction, rel_type_ids = std::move(rel_type_ids), iterations, damping, this] () {
+             return seastar::do_with(uint64_t(0), [algorithm_id, direction, rel_type_ids, iterations, damping, this] (uint64_t& superstep) {
+                    // Every shard sends all of its messages before any shard folds them in
+                    return seastar::repeat([&superstep, algorithm_id, direction, rel_type_ids, iterations, damping, this] () {
+                           if (superstep >= iterations) {
+                             return seastar::make_ready_future<seastar::stop_iteration>(seastar::stop_iteration::yes);
+                           }
+                           return PeerOnAll("Algorithm", [algorithm_id, direction, rel_type_ids] (Shard &local_shard) {
+                                    return local_shard.AlgorithmSend(algorithm_id, direction, rel_type_ids);
+                             }).then([algorithm_id, damping, this] () {
+                                    return PeerMapReduce("Algorithm", [algorithm_id, damping] (Shard &local_shard) {
+                                             return local_shard.AlgorithmUpdate(algorithm_id, damping);
+                                      }, uint64_t(0), std::plus<uint64_t>());
+                             }).then([&superstep, iterations] (uint64_t changed) {
+                                    // Nothing changed, so the later supersteps would not change anything either
+                                    superstep = changed == 0 ? iterations : superstep + 1;
+                                    return seastar::stop_iteration::no;
+                             });
+                    });
+             });
+      }).then([algorithm_id, property, this] () {
+             return PeerMap("Algorithm", [algorithm_id, property] (Shard &local_shard) {
+                      return local_shard.AlgorithmFinish(algorithm_id, property);
+               })
+               .then([] (std::vector<std::vector<std::pair<uint64_t, double>>> results) {
+                      std::vector<std::pair<uint64_t, double>> combined;
+
+                      for(auto& sharded : results) {
                         combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
                       }
                       return combined;
                });
-        });
-    }
-    case IN: {
-      return container().invoke_on(node_shard_id, [type, key](Shard &local_shard) {
-               return local_shard.NodeGetShardedIncomingNodeIDs(type, key); })
-        .then([this] (const std::map<uint16_t, std::vector<uint64_t>>& sharded_nodes_ids) {
-               std::vector<seastar::future<std::vector<Node>>> futures;
-               for (auto const& [their_shard, grouped_node_ids] : sharded_nodes_ids ) {
-                 auto future = container().invoke_on(their_shard, [grouped_node_ids = grouped_node_ids] (Shard &local_shard) {
-                        return local_shard.NodesGet(grouped_node_ids);
-                 });
-                 futures.push_back(std::move(future));
-               }
+      });
+  }
 
-               auto p = make_shared(std::move(futures));
-               return seastar::when_all_succeed(p->begin(), p->end()).then([] (const std::vector<std::vector<Node>>& results) {
-                      std::vector<Node> combined;
+  seastar::future<std::vector<std::pair<uint64_t, double>>> Shard::PageRankPeered(uint64_t iterations, double damping, const std::vector<std::string>& rel_types, const std::string& property) {
+    return AlgorithmPeered(AlgorithmKind::PAGERANK, {}, OUT, rel_types, iterations, damping, property);
+  }
+
+  seastar::future<std::vector<std::pair<uint64_t, double>>> Shard::BreadthFirstSearchPeered(uint64_t id, Direction direction, const std::vector<std::string>& rel_types, uint64_t max_depth, const std::string& property) {
+    return AlgorithmPeered(AlgorithmKind::BFS, {id}, direction, rel_types, max_depth, 0, property);
+  }
+
+  seastar::future<std::vector<std::pair<uint64_t, double>>> Shard::ConnectedComponentsPeered(const std::vector<std::string>& rel_types, const std::string& property) {
+    return AlgorithmPeered(AlgorithmKind::WCC, {}, BOTH, rel_types, std::numeric_limits<uint64_t>::max(), 0, property);
+  }
+
+  seastar::future<std::vector<std::pair<uint64_t, double>>> Shard::TrianglesPeered(AlgorithmKind kind, const std::vector<std::string>& rel_types, const std::string& property) {
+    uint64_t algorithm_id = (++algorithm_count << SHIFTED_BITS) + shard_id;
+
+    std::vector<uint16_t> rel_type_ids;
+    for (const auto& rel_type : rel_types) {
+      rel_type_ids.push_back(relationship_types.getTypeId(rel_type));
+    }
 
-                      for(const std::vector<Node>& sharded : results) {
+    // Every shard has its larger neighbors ready before any shard asks for them, and every count is in before they are folded
+    return PeerOnAll("Algorithm", [algorithm_id, kind, rel_type_ids = std::move(rel_type_ids)] (Shard &local_shard) {
+             local_shard.TriangleStart(algorithm_id, kind, rel_type_ids);
+      }).then([algorithm_id, this] () {
+             return PeerOnAll("Algorithm", [algorithm_id] (Shard &local_shard) {
+                      return local_shard.TriangleCount(algorithm_id);
+               });
+      }).then([algorithm_id, this] () {
+             return PeerOnAll("Algorithm", [algorithm_id] (Shard &local_shard) {
+                      local_shard.AlgorithmUpdate(algorithm_id, 0);
+               });
+      }).then([algorithm_id, property, this] () {
+             return PeerMap("Algorithm", [algorithm_id, property] (Shard &local_shard) {
+                      return local_shard.AlgorithmFinish(algorithm_id, property);
+               })
+               .then([] (std::vector<std::vector<std::pair<uint64_t, double>>> results) {
+                      std::vector<std::pair<uint64_t, double>> combined;
+
+                      for(auto& sharded : results) {
                         combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
                       }
                       return combined;
                });
-        });
-    }
-    default: return NodeGetNeighborsPeered(type, key);
-    }
+      });
   }
 
-  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(const std::string& type, const std::string& key, Direction direction, const std::string& rel_type) {
-    uint16_t node_shard_id = CalculateShardId(type, key);
-    uint16_t rel_type_id = relationship_types.getTypeId(rel_type);
-    if (rel_type_id != 0) {
-      switch (direction) {
-      case OUT: {
-        return container().invoke_on(node_shard_id, [type, key, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedOutgoingNodeIDs(type, key, rel_type_id); })
-          .then([this](const std::map<uint16_t, std::vector<uint64_t>>& sharded_nodes_ids) {
-                 std::vector<seastar::future<std::vector<Node>>> futures;
-                 for (auto const &[their_shard, grouped_node_ids] : sharded_nodes_ids) {
-                   auto future = container().invoke_on(their_shard, [grouped_node_ids = grouped_node_ids](Shard &local_shard) {
-                          return local_shard.NodesGet(grouped_node_ids);
-                   });
-                   futures.push_back(std::move(future));
-                 }
-
-                 auto p = make_shared(std::move(futures));
-                 return seastar::when_all_succeed(p->begin(), p->end()).then([](const std::vector<std::vector<Node>>& results) {
-                        std::vector<Node> combined;
+  seastar::future<std::vector<std::pair<uint64_t, double>>> Shard::AlgorithmPeered(const std::string& name, const std::string& query) {
+    // { "iterations": 20, "damping": 0.85, "id": 256, "direction": "out", "max_depth": 3, "rel_types": [...], "property": "rank" }, all optional but the id of bfs
+    dom::object object;
+    if (parser.parse(query.empty() ? std::string("{}") : query).get(object)) {
+      return seastar::make_ready_future<std::vector<std::pair<uint64_t, double>>>();
+    }
 
-                        for (const std::vector<Node>& sharded : results) {
-                          combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                        }
-                        return combined;
-                 });
-          });
+    std::vector<std::string> rel_types;
+    dom::array rel_type_array;
+    if (!object["rel_types"].get(rel_type_array)) {
+      for (dom::element rel_type : rel_type_array) {
+        std::string_view rel_type_name;
+        if (!rel_type.get(rel_type_name)) {
+          rel_types.emplace_back(rel_type_name);
+        }
       }
-      case IN: {
-        return container().invoke_on(node_shard_id, [type, key, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedIncomingNodeIDs(type, key, rel_type_id); })
-          .then([this](const std::map<uint16_t, std::vector<uint64_t>>& sharded_nodes_ids) {
-                 std::vector<seastar::future<std::vector<Node>>> futures;
-                 for (auto const &[their_shard, grouped_node_ids] : sharded_nodes_ids) {
-                   auto future = container().invoke_on(their_shard, [grouped_node_ids = grouped_node_ids](Shard &local_shard) {
-                          return local_shard.NodesGet(grouped_node_ids);
-                   });
-                   futures.push_back(std::move(future));
-                 }
+    }
+    std::string_view property;
+    if (object["property"].get(property)) {
+      property = "";
+    }
 
-                 auto p = make_shared(std::move(futures));
-                 return seastar::when_all_succeed(p->begin(), p->end()).then([](const std::vector<std::vector<Node>>& results) {
-                        std::vector<Node> combined;
+    if (name == "pagerank") {
+      uint64_t iterations;
+      double damping;
+      if (object["iterations"].get(iterations)) {
+        iterations = 20;
+      }
+      if (object["damping"].get(damping)) {
+        damping = 0.85;
+      }
+      return PageRankPeered(iterations, damping, rel_types, std::string(property));
+    }
 
-                        for (const std::vector<Node>& sharded : results) {
-                          combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                        }
-                        return combined;
-                 });
-          });
+    if (name == "bfs") {
+      uint64_t id;
+      if (object["id"].get(id)) {
+        return seastar::make_ready_future<std::vector<std::pair<uint64_t, double>>>();
       }
-      default:
-        return NodeGetNeighborsPeered(type, key, rel_type_id);
+      uint64_t max_depth;
+      if (object["max_depth"].get(max_depth)) {
+        max_depth = std::numeric_limits<uint64_t>::max();
+      }
+      Direction direction = BOTH;
+      std::string_view direction_name;
+      if (!object["direction"].get(direction_name)) {
+        if (direction_name == "in") {
+          direction = IN;
+        } else if (direction_name == "out") {
+          direction = OUT;
+        }
       }
+      return BreadthFirstSearchPeered(id, direction, rel_types, max_depth, std::string(property));
     }
 
-    return seastar::make_ready_future<std::vector<Node>>();
-  }
+    if (name == "wcc") {
+      return ConnectedComponentsPeered(rel_types, std::string(property));
+    }
 
-  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(const std::string& type, const std::string& key, Direction direction, uint16_t rel_type_id) {
-    uint16_t node_shard_id = CalculateShardId(type, key);
-    if (rel_type_id != 0) {
-      switch (direction) {
-      case OUT: {
-        return container().invoke_on(node_shard_id, [type, key, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedOutgoingNodeIDs(type, key, rel_type_id); })
-          .then([this](const std::map<uint16_t, std::vector<uint64_t>>& sharded_nodes_ids) {
-                 std::vector<seastar::future<std::vector<Node>>> futures;
-                 for (auto const &[their_shard, grouped_node_ids] : sharded_nodes_ids) {
-                   auto future = container().invoke_on(their_shard, [grouped_node_ids = grouped_node_ids](Shard &local_shard) {
-                          return local_shard.NodesGet(grouped_node_ids);
-                   });
-                   futures.push_back(std::move(future));
-                 }
+    if (name == "triangles") {
+      return TrianglesPeered(AlgorithmKind::TRIANGLES, rel_types, std::string(property));
+    }
 
-                 auto p = make_shared(std::move(futures));
-                 return seastar::when_all_succeed(p->begin(), p->end()).then([](const std::vector<std::vector<Node>>& results) {
-                        std::vector<Node> combined;
+    if (name == "clustering") {
+      return TrianglesPeered(AlgorithmKind::CLUSTERING, rel_types, std::string(property));
+    }
 
-                        for (const std::vector<Node>& sharded : results) {
-                          combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                        }
-                        return combined;
-                 });
-          });
-      }
-      case IN: {
-        return container().invoke_on(node_shard_id, [type, key, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedIncomingNodeIDs(type, key, rel_type_id); })
-          .then([this](const std::map<uint16_t, std::vector<uint64_t>>& sharded_nodes_ids) {
-                 std::vector<seastar::future<std::vector<Node>>> futures;
-                 for (auto const &[their_shard, grouped_node_ids] : sharded_nodes_ids) {
-                   auto future = container().invoke_on(their_shard, [grouped_node_ids = grouped_node_ids](Shard &local_shard) {
-                          return local_shard.NodesGet(grouped_node_ids);
-                   });
-                   futures.push_back(std::move(future));
-                 }
+    return seastar::make_ready_future<std::vector<std::pair<uint64_t, double>>>();
+  }
 
-                 auto p = make_shared(std::move(futures));
-                 return seastar::when_all_succeed(p->begin(), p->end()).then([](const std::vector<std::vector<Node>>& results) {
-                        std::vector<Node> combined;
+  // Shortest Paths
 
-                        for (const std::vector<Node>& sharded : results) {
-                          combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                        }
-                        return combined;
-                 });
-          });
-      }
-      default:
-        return NodeGetNeighborsPeered(type, key, rel_type_id);
-      }
+  // Where a shortest path search is between its hops, and the path once the sides met
+  struct PathProgress {
+    uint64_t sizes[2] = {1, 1};
+    uint64_t depth = 0;
+    uint64_t meeting_id = 0;
+    uint64_t current = 0;
+    std::vector<Ids> path;
+  };
+
+  seastar::future<std::vector<Ids>> Shard::ShortestPathPeered(uint64_t id1, uint64_t id2, Direction direction, const std::vector<std::string>& rel_types, uint64_t max_depth) {
+    // The shard the search started on is in the low bits, so ids are unique across shards
+    uint64_t path_id = (++traversal_count << SHIFTED_BITS) + shard_id;
+
+    std::vector<uint16_t> rel_type_ids;
+    for (const auto& rel_type : rel_types) {
+      // An unknown relationship type matches nothing, rather than everything like an empty list
+      rel_type_ids.push_back(relationship_types.getTypeId(rel_type));
     }
+    // The end side walks the relationships backwards
+    Direction reverse = direction == OUT ? IN : direction == IN ? OUT : BOTH;
 
-    return seastar::make_ready_future<std::vector<Node>>();
+    return PeerOn("ShortestPath", CalculateShardId(id1), [path_id, id1] (Shard &local_shard) {
+             return local_shard.PathStart(path_id, 0, id1);
+      }).then([path_id, id2, this] (bool valid_start) {
+             return PeerOn("ShortestPath", CalculateShardId(id2), [path_id, id2] (Shard &local_shard) {
+                      return local_shard.PathStart(path_id, 1, id2);
+               }).then([valid_start] (bool valid_end) {
+                      return valid_start && valid_end;
+               });
+      }).then([path_id, id1, id2, direction, reverse, rel_type_ids = std::move(rel_type_ids), max_depth, this] (bool valid) {
+             return seastar::do_with(PathProgress(), [path_id, id1, id2, direction, reverse, rel_type_ids, max_depth, valid, this] (PathProgress& progress) {
+                    if (!valid) {
+                      progress.sizes[0] = 0;
+                    } else if (id1 == id2) {
+                      progress.meeting_id = id1;
+                    }
+                    return seastar::repeat([&progress, path_id, direction, reverse, rel_type_ids, max_depth, this] () {
+                           if (progress.meeting_id != 0 || progress.sizes[0] == 0 || progress.sizes[1] == 0 || progress.depth >= max_depth) {
+                             return seastar::make_ready_future<seastar::stop_iteration>(seastar::stop_iteration::yes);
+                           }
+                           // Grow the side with fewer nodes at its edge
+                           uint8_t side = progress.sizes[0] <= progress.sizes[1] ? 0 : 1;
+                           return PeerOnAll("ShortestPath", [path_id, side, side_direction = side == 0 ? direction : reverse, rel_type_ids] (Shard &local_shard) {
+                                    return local_shard.PathExpand(path_id, side, side_direction, rel_type_ids);
+                             }).then([path_id, side, this] () {
+                                    return PeerMap("ShortestPath", [path_id, side] (Shard &local_shard) {
+                                             return local_shard.PathAdvance(path_id, side);
+                                      });
+                             }).then([&progress, side] (std::vector<std::tuple<uint64_t, uint64_t, uint64_t>> results) {
+                                    uint64_t size = 0;
+                                    uint64_t meeting_length = std::numeric_limits<uint64_t>::max();
+                                    for (const auto& [shard_size, shard_meeting_length, shard_meeting_id] : results) {
+                                      size += shard_size;
+                                      if (shard_meeting_id != 0 && shard_meeting_length < meeting_length) {
+                                        meeting_length = shard_meeting_length;
+                                        progress.meeting_id = shard_meeting_id;
+                                      }
+                                    }
+                                    progress.sizes[side] = size;
+                                    progress.depth++;
+                                    return seastar::stop_iteration::no;
+                             });
+                    }).then([&progress, path_id, this] () {
+                           if (progress.meeting_id == 0) {
+                             return seastar::make_ready_future<>();
+                           }
+                           // Walk back from where the sides met to the start, one shard at a time
+                           progress.current = progress.meeting_id;
+                           return seastar::repeat([&progress, path_id, this] () {
+                                  return PeerOn("ShortestPath", CalculateShardId(progress.current), [path_id, current = progress.current] (Shard &local_shard) {
+                                           return local_shard.PathGetStep(path_id, 0, current);
+                                    }).then([&progress] (PathStep step) {
+                                           progress.path.emplace_back(progress.current, step.rel_id);
+                                           progress.current = step.node_id;
+                                           return progress.current == 0 ? seastar::stop_iteration::yes : seastar::stop_iteration::no;
+                                    });
+                             }).then([&progress, path_id, this] () {
+                                    std::reverse(std::begin(progress.path), std::end(progress.path));
+                                    // Then on to the end, each node reached over the relationship it was reached from
+                                    progress.current = progress.meeting_id;
+                                    return seastar::repeat([&progress, path_id, this] () {
+                                           return PeerOn("ShortestPath", CalculateShardId(progress.current), [path_id, current = progress.current] (Shard &local_shard) {
+                                                    return local_shard.PathGetStep(path_id, 1, current);
+                                             }).then([&progress] (PathStep step) {
+                                                    if (step.node_id == 0) {
+                                                      return seastar::stop_iteration::yes;
+                                                    }
+                                                    progress.path.emplace_back(step.node_id, step.rel_id);
+                                                    progress.current = step.node_id;
+                                                    return seastar::stop_iteration::no;
+                                             });
+                                    });
+                             });
+                    }).then([&progress, path_id, this] () {
+                           return PeerOnAll("ShortestPath", [path_id] (Shard &local_shard) {
+                                    local_shard.PathFinish(path_id);
+                             }).then([&progress] () {
+                                    return std::move(progress.path);
+                             });
+                    });
+             });
+      });
   }
 
-  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(const std::string& type, const std::string& key, Direction direction, const std::vector<std::string> &rel_types) {
-    uint16_t node_shard_id = CalculateShardId(type, key);
+  seastar::future<std::vector<Ids>> Shard::ShortestPathPeered(const std::string& type1, const std::string& key1, const std::string& type2, const std::string& key2, Direction direction,
+                                                              const std::vector<std::string>& rel_types, uint64_t max_depth) {
+    return NodeGetIDPeered(type1, key1).then([type2, key2, direction, rel_types, max_depth, this] (uint64_t id1) {
+           return NodeGetIDPeered(type2, key2).then([id1, direction, rel_types, max_depth, this] (uint64_t id2) {
+                  return ShortestPathPeered(id1, id2, direction, rel_types, max_depth);
+           });
+    });
+  }
 
-    switch(direction) {
-    case OUT: {
-      return container().invoke_on(node_shard_id, [type, key, rel_types](Shard &local_shard) {
-               return local_shard.NodeGetShardedOutgoingNodeIDs(type, key, rel_types); })
-        .then([this] (const std::map<uint16_t, std::vector<uint64_t>>& sharded_nodes_ids) {
-               std::vector<seastar::future<std::vector<Node>>> futures;
-               for (auto const& [their_shard, grouped_node_ids] : sharded_nodes_ids ) {
-                 auto future = container().invoke_on(their_shard, [grouped_node_ids = grouped_node_ids] (Shard &local_shard) {
-                        return local_shard.NodesGet(grouped_node_ids);
-                 });
-                 futures.push_back(std::move(future));
-               }
+  // Multi Get
 
-               auto p = make_shared(std::move(futures));
-               return seastar::when_all_succeed(p->begin(), p->end()).then([] (const std::vector<std::vector<Node>>& results) {
-                      std::vector<Node> combined;
+  // Each shard answers for its own entries in one call, the answers are then put back where the entries were in the request
+  template <typename T, typename K, typename Function>
+  static seastar::future<std::vector<T>> InRequestOrder(Shard& shard, const std::string& operation, const std::vector<K>& entries, const std::vector<uint16_t>& shards, Function function) {
+    std::map<uint16_t, std::pair<std::vector<K>, std::vector<size_t>>> sharded_entries;
+    for (size_t position = 0; position < entries.size(); position++) {
+      auto& [grouped_entries, positions] = sharded_entries[shards[position]];
+      grouped_entries.push_back(entries[position]);
+      positions.push_back(position);
+    }
 
-                      for(const std::vector<Node>& sharded : results) {
-                        combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                      }
-                      return combined;
-               });
-        });
+    std::vector<std::vector<size_t>> sharded_positions;
+    std::vector<seastar::future<std::vector<T>>> futures;
+    for (auto& [their_shard, grouped] : sharded_entries) {
+      sharded_positions.push_back(std::move(grouped.second));
+      auto future = shard.PeerOn(operation, their_shard, [grouped_entries = std::move(grouped.first), function] (Shard &local_shard) {
+             return function(local_shard, grouped_entries);
+      });
+      futures.push_back(std::move(future));
     }
-    case IN: {
-      return container().invoke_on(node_shard_id, [type, key, rel_types](Shard &local_shard) {
-               return local_shard.NodeGetShardedIncomingNodeIDs(type, key, rel_types); })
-        .then([this] (const std::map<uint16_t, std::vector<uint64_t>>& sharded_nodes_ids) {
-               std::vector<seastar::future<std::vector<Node>>> futures;
-               for (auto const& [their_shard, grouped_node_ids] : sharded_nodes_ids ) {
-                 auto future = container().invoke_on(their_shard, [grouped_node_ids = grouped_node_ids] (Shard &local_shard) {
-                        return local_shard.NodesGet(grouped_node_ids);
-                 });
-                 futures.push_back(std::move(future));
-               }
 
-               auto p = make_shared(std::move(futures));
-               return seastar::when_all_succeed(p->begin(), p->end()).then([] (const std::vector<std::vector<Node>>& results) {
-                      std::vector<Node> combined;
+    auto p = make_shared(std::move(futures));
+    return seastar::when_all_succeed(p->begin(), p->end()).then([sharded_positions = std::move(sharded_positions), count = entries.size()] (std::vector<std::vector<T>> results) {
+           std::vector<T> ordered(count);
+           for (size_t i = 0; i < results.size(); i++) {
+             for (size_t j = 0; j < results[i].size(); j++) {
+               ordered[sharded_positions[i][j]] = std::move(results[i][j]);
+             }
+           }
+           return ordered;
+    });
+  }
 
-                      for(const std::vector<Node>& sharded : results) {
-                        combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                      }
-                      return combined;
-               });
-        });
-    }
-    default: return NodeGetNeighborsPeered(type, key, rel_types);
+  static std::vector<uint16_t> ShardsOf(const std::vector<uint64_t>& ids) {
+    std::vector<uint16_t> shards;
+    shards.reserve(ids.size());
+    for (uint64_t id : ids) {
+      shards.push_back(Shard::CalculateShardId(id));
     }
+    return shards;
   }
 
+  // Anything that is not an id becomes zero so it still takes up its place in the results
+  static std::vector<uint64_t> IdsOf(const dom::array& id_array) {
+    std::vector<uint64_t> ids;
+    for (dom::element element : id_array) {
+      uint64_t id;
+      if (element.get(id)) {
+        id = 0;
+      }
+      ids.push_back(id);
+    }
+    return ids;
+  }
 
-  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(uint64_t external_id, Direction direction) {
-    uint16_t node_shard_id = CalculateShardId(external_id);
+  seastar::future<std::vector<Node>> Shard::NodesGetPeered(const std::vector<uint64_t>& ids, NodeProjection projection) {
+    return InRequestOrder<Node>(*this, "NodesGet", ids, ShardsOf(ids), [projection] (Shard &local_shard, const std::vector<uint64_t>& grouped_ids) {
+           return local_shard.NodesGet(grouped_ids, projection);
+    });
+  }
 
-    switch(direction) {
-    case OUT: {
-      return container().invoke_on(node_shard_id, [external_id](Shard &local_shard) {
-               return local_shard.NodeGetShardedOutgoingNodeIDs(external_id); })
-        .then([this] (const std::map<uint16_t, std::vector<uint64_t>>& sharded_nodes_ids) {
-               std::vector<seastar::future<std::vector<Node>>> futures;
-               for (auto const& [their_shard, grouped_node_ids] : sharded_nodes_ids ) {
-                 auto future = container().invoke_on(their_shard, [grouped_node_ids = grouped_node_ids] (Shard &local_shard) {
-                        return local_shard.NodesGet(grouped_node_ids);
-                 });
-                 futures.push_back(std::move(future));
-               }
+  seastar::future<std::vector<Node>> Shard::NodesGetPeered(const std::vector<std::pair<std::string, std::string>>& type_keys, NodeProjection projection) {
+    std::vector<uint16_t> shards;
+    shards.reserve(type_keys.size());
+    for (const auto& [type, key] : type_keys) {
+      shards.push_back(CalculateShardId(type, key));
+    }
 
-               auto p = make_shared(std::move(futures));
-               return seastar::when_all_succeed(p->begin(), p->end()).then([] (const std::vector<std::vector<Node>>& results) {
-                      std::vector<Node> combined;
+    return InRequestOrder<Node>(*this, "NodesGet", type_keys, shards, [projection] (Shard &local_shard, const std::vector<std::pair<std::string, std::string>>& grouped_type_keys) {
+           return local_shard.NodesGet(grouped_type_keys, projection);
+    });
+  }
 
-                      for(const std::vector<Node>& sharded : results) {
-                        combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                      }
-                      return combined;
-               });
-        });
+  seastar::future<std::vector<Node>> Shard::NodesGetPeered(const std::string& query, NodeProjection projection) {
+    // [1, 2, ...] or [{ "type": "User", "key": "one" }, ...]
+    dom::array array;
+    if (parser.parse(query).get(array)) {
+      return seastar::make_ready_future<std::vector<Node>>();
     }
-    case IN: {
-      return container().invoke_on(node_shard_id, [external_id](Shard &local_shard) {
-               return local_shard.NodeGetShardedIncomingNodeIDs(external_id); })
-        .then([this] (const std::map<uint16_t, std::vector<uint64_t>>& sharded_nodes_ids) {
-               std::vector<seastar::future<std::vector<Node>>> futures;
-               for (auto const& [their_shard, grouped_node_ids] : sharded_nodes_ids ) {
-                 auto future = container().invoke_on(their_shard, [grouped_node_ids = grouped_node_ids] (Shard &local_shard) {
-                        return local_shard.NodesGet(grouped_node_ids);
-                 });
-                 futures.push_back(std::move(future));
-               }
 
-               auto p = make_shared(std::move(futures));
-               return seastar::when_all_succeed(p->begin(), p->end()).then([] (const std::vector<std::vector<Node>>& results) {
-                      std::vector<Node> combined;
+    dom::object first;
+    if (array.size() == 0 || array.at(0).get(first)) {
+      return NodesGetPeered(IdsOf(array), projection);
+    }
 
-                      for(const std::vector<Node>& sharded : results) {
-                        combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                      }
-                      return combined;
-               });
-        });
+    std::vector<std::pair<std::string, std::string>> type_keys;
+    for (dom::element element : array) {
+      std::string_view type;
+      std::string_view key;
+      if (element["type"].get(type) || element["key"].get(key)) {
+        type_keys.emplace_back();
+      } else {
+        type_keys.emplace_back(type, key);
+      }
     }
-    default: return NodeGetNeighborsPeered(external_id);
+    return NodesGetPeered(type_keys, projection);
+  }
+
+  seastar::future<uint64_t> Shard::NodesRemoveFromJsonPeered(const std::string& json) {
+    // [1, 2, ...]
+    dom::array array;
+    if (parser.parse(json).get(array)) {
+      return seastar::make_ready_future<uint64_t>(0);
     }
+    return NodesRemovePeered(IdsOf(array));
   }
 
-  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(uint64_t external_id, Direction direction, const std::string& rel_type) {
-    uint16_t node_shard_id = CalculateShardId(external_id);
-    uint16_t rel_type_id = relationship_types.getTypeId(rel_type);
-    if (rel_type_id != 0) {
-      switch (direction) {
-      case OUT: {
-        return container().invoke_on(node_shard_id, [external_id, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedOutgoingNodeIDs(external_id, rel_type_id); })
-          .then([this](const std::map<uint16_t, std::vector<uint64_t>>& sharded_nodes_ids) {
-                 std::vector<seastar::future<std::vector<Node>>> futures;
-                 for (auto const &[their_shard, grouped_node_ids] : sharded_nodes_ids) {
-                   auto future = container().invoke_on(their_shard, [grouped_node_ids = grouped_node_ids](Shard &local_shard) {
-                          return local_shard.NodesGet(grouped_node_ids);
-                   });
-                   futures.push_back(std::move(future));
-                 }
+  seastar::future<std::vector<Relationship>> Shard::RelationshipsGetPeered(const std::vector<uint64_t>& ids) {
+    return InRequestOrder<Relationship>(*this, "RelationshipsGet", ids, ShardsOf(ids), [] (Shard &local_shard, const std::vector<uint64_t>& grouped_ids) {
+           return local_shard.RelationshipsGet(grouped_ids);
+    });
+  }
 
-                 auto p = make_shared(std::move(futures));
-                 return seastar::when_all_succeed(p->begin(), p->end()).then([](const std::vector<std::vector<Node>>& results) {
-                        std::vector<Node> combined;
+  seastar::future<std::vector<Relationship>> Shard::RelationshipsGetPeered(const std::string& query) {
+    // [1, 2, ...]
+    dom::array array;
+    if (parser.parse(query).get(array)) {
+      return seastar::make_ready_future<std::vector<Relationship>>();
+    }
+    return RelationshipsGetPeered(IdsOf(array));
+  }
 
-                        for (const std::vector<Node>& sharded : results) {
-                          combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                        }
-                        return combined;
-                 });
-          });
-      }
-      case IN: {
-        return container().invoke_on(node_shard_id, [external_id, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedIncomingNodeIDs(external_id, rel_type_id); })
-          .then([this](const std::map<uint16_t, std::vector<uint64_t>>& sharded_nodes_ids) {
-                 std::vector<seastar::future<std::vector<Node>>> futures;
-                 for (auto const &[their_shard, grouped_node_ids] : sharded_nodes_ids) {
-                   auto future = container().invoke_on(their_shard, [grouped_node_ids = grouped_node_ids](Shard &local_shard) {
-                          return local_shard.NodesGet(grouped_node_ids);
-                   });
-                   futures.push_back(std::move(future));
-                 }
+  seastar::future<std::vector<uint64_t>> Shard::NodesGetDegreePeered(const std::vector<uint64_t>& ids, Direction direction, const std::vector<std::string>& rel_types) {
+    return InRequestOrder<uint64_t>(*this, "NodesGetDegree", ids, ShardsOf(ids), [direction, rel_types] (Shard &local_shard, const std::vector<uint64_t>& grouped_ids) {
+           return local_shard.NodesGetDegree(grouped_ids, direction, rel_types);
+    });
+  }
 
-                 auto p = make_shared(std::move(futures));
-                 return seastar::when_all_succeed(p->begin(), p->end()).then([](const std::vector<std::vector<Node>>& results) {
-                        std::vector<Node> combined;
+  seastar::future<std::vector<uint64_t>> Shard::NodesGetDegreePeered(const std::string& query) {
+    // { "ids": [...], "direction": "out", "rel_types": [...] }
+    dom::object object;
+    dom::array id_array;
+    if (parser.parse(query).get(object) || object["ids"].get(id_array)) {
+      return seastar::make_ready_future<std::vector<uint64_t>>();
+    }
 
-                        for (const std::vector<Node>& sharded : results) {
-                          combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                        }
-                        return combined;
-                 });
-          });
+    Direction direction = BOTH;
+    std::string_view direction_name;
+    if (!object["direction"].get(direction_name)) {
+      if (direction_name == "in") {
+        direction = IN;
+      } else if (direction_name == "out") {
+        direction = OUT;
       }
-      default:
-        return NodeGetNeighborsPeered(external_id, rel_type_id);
+    }
+
+    std::vector<std::string> rel_types;
+    dom::array rel_type_array;
+    if (!object["rel_types"].get(rel_type_array)) {
+      for (dom::element rel_type : rel_type_array) {
+        std::string_view name;
+        if (!rel_type.get(name)) {
+          rel_types.emplace_back(name);
+        }
       }
     }
 
-    return seastar::make_ready_future<std::vector<Node>>();
+    return NodesGetDegreePeered(IdsOf(id_array), direction, rel_types);
   }
 
-  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(uint64_t external_id, Direction direction, uint16_t rel_type_id) {
-    uint16_t node_shard_id = CalculateShardId(external_id);
-    if (rel_type_id != 0) {
-      switch (direction) {
-      case OUT: {
-        return container().invoke_on(node_shard_id, [external_id, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedOutgoingNodeIDs(external_id, rel_type_id); })
-          .then([this](const std::map<uint16_t, std::vector<uint64_t>>& sharded_nodes_ids) {
-                 std::vector<seastar::future<std::vector<Node>>> futures;
-                 for (auto const &[their_shard, grouped_node_ids] : sharded_nodes_ids) {
-                   auto future = container().invoke_on(their_shard, [grouped_node_ids = grouped_node_ids](Shard &local_shard) {
-                          return local_shard.NodesGet(grouped_node_ids);
-                   });
-                   futures.push_back(std::move(future));
-                 }
-
-                 auto p = make_shared(std::move(futures));
-                 return seastar::when_all_succeed(p->begin(), p->end()).then([](const std::vector<std::vector<Node>>& results) {
-                        std::vector<Node> combined;
+  seastar::future<std::vector<std::any>> Shard::NodesGetPropertyPeered(const std::vector<uint64_t>& ids, const std::string& property) {
+    return InRequestOrder<std::any>(*this, "NodesGetProperty", ids, ShardsOf(ids), [property] (Shard &local_shard, const std::vector<uint64_t>& grouped_ids) {
+           return local_shard.NodesGetProperty(grouped_ids, property);
+    });
+  }
 
-                        for (const std::vector<Node>& sharded : results) {
-                          combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                        }
-                        return combined;
-                 });
-          });
-      }
-      case IN: {
-        return container().invoke_on(node_shard_id, [external_id, rel_type_id](Shard &local_shard) { return local_shard.NodeGetShardedIncomingNodeIDs(external_id, rel_type_id); })
-          .then([this](const std::map<uint16_t, std::vector<uint64_t>>& sharded_nodes_ids) {
-                 std::vector<seastar::future<std::vector<Node>>> futures;
-                 for (auto const &[their_shard, grouped_node_ids] : sharded_nodes_ids) {
-                   auto future = container().invoke_on(their_shard, [grouped_node_ids = grouped_node_ids](Shard &local_shard) {
-                          return local_shard.NodesGet(grouped_node_ids);
-                   });
-                   futures.push_back(std::move(future));
-                 }
+  seastar::future<std::vector<std::any>> Shard::NodesGetPropertyPeered(const std::string& query, const std::string& property) {
+    // [1, 2, ...]
+    dom::array array;
+    if (parser.parse(query).get(array)) {
+      return seastar::make_ready_future<std::vector<std::any>>();
+    }
+    return NodesGetPropertyPeered(IdsOf(array), property);
+  }
 
-                 auto p = make_shared(std::move(futures));
-                 return seastar::when_all_succeed(p->begin(), p->end()).then([](const std::vector<std::vector<Node>>& results) {
-                        std::vector<Node> combined;
+  seastar::future<std::vector<int64_t>> Shard::NodesGetIntegerPropertyPeered(const std::vector<uint64_t>& ids, const std::string& property, int64_t missing) {
+    return InRequestOrder<int64_t>(*this, "NodesGetProperty", ids, ShardsOf(ids), [property, missing] (Shard &local_shard, const std::vector<uint64_t>& grouped_ids) {
+           return local_shard.NodesGetIntegerProperty(grouped_ids, property, missing);
+    });
+  }
 
-                        for (const std::vector<Node>& sharded : results) {
-                          combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
-                        }
-                        return combined;
-                 });
-          });
-      }
-      default:
-        return NodeGetNeighborsPeered(external_id, rel_type_id);
-      }
-    }
+  seastar::future<std::vector<double>> Shard::NodesGetDoublePropertyPeered(const std::vector<uint64_t>& ids, const std::string& property, double missing) {
+    return InRequestOrder<double>(*this, "NodesGetProperty", ids, ShardsOf(ids), [property, missing] (Shard &local_shard, const std::vector<uint64_t>& grouped_ids) {
+           return local_shard.NodesGetDoubleProperty(grouped_ids, property, missing);
+    });
+  }
 
-    return seastar::make_ready_future<std::vector<Node>>();
+  seastar::future<std::vector<std::string>> Shard::NodesGetStringPropertyPeered(const std::vector<uint64_t>& ids, const std::string& property, const std::string& missing) {
+    return InRequestOrder<std::string>(*this, "NodesGetProperty", ids, ShardsOf(ids), [property, missing] (Shard &local_shard, const std::vector<uint64_t>& grouped_ids) {
+           return local_shard.NodesGetStringProperty(grouped_ids, property, missing);
+    });
   }
 
-  seastar::future<std::vector<Node>> Shard::NodeGetNeighborsPeered(uint64_t external_id, Direction direction, const std::vector<std::string> &rel_types) {
-    uint16_t node_shard_id = CalculateShardId(external_id);
+  // Sampling
 
-    switch(direction) {
-    case OUT: {
-      return container().invoke_on(node_shard_id, [external_id, rel_types](Shard &local_shard) {
-               return local_shard.NodeGetShardedOutgoingNodeIDs(external_id, rel_types); })
-        .then([this] (const std::map<uint16_t, std::vector<uint64_t>>& sharded_nodes_ids) {
-               std::vector<seastar::future<std::vector<Node>>> futures;
-               for (auto const& [their_shard, grouped_node_ids] : sharded_nodes_ids ) {
-                 auto future = container().invoke_on(their_shard, [grouped_node_ids = grouped_node_ids] (Shard &local_shard) {
-                        return local_shard.NodesGet(grouped_node_ids);
-                 });
-                 futures.push_back(std::move(future));
-               }
+  // Every walk takes its steps at the same time as the others, so each step is one batch of walkers per shard
+  struct Walks {
+    std::vector<std::vector<uint64_t>> walks;
+    std::vector<Walker> walkers;
+    uint64_t step = 0;
+  };
 
-               auto p = make_shared(std::move(futures));
-               return seastar::when_all_succeed(p->begin(), p->end()).then([] (const std::vector<std::vector<Node>>& results) {
-                      std::vector<Node> combined;
+  seastar::future<std::vector<std::vector<uint64_t>>> Shard::RandomWalkPeered(const std::vector<uint64_t>& ids, uint64_t length, Direction direction,
+                                                                               const std::vector<std::string>& rel_types, double p, double q, uint64_t seed) {
+    // Going back or going farther cannot be weighed by a p or q of zero or less
+    if (length == 0 || !(p > 0) || !(q > 0)) {
+      return seastar::make_ready_future<std::vector<std::vector<uint64_t>>>(std::vector<std::vector<uint64_t>>(ids.size()));
+    }
 
-                      for(const std::vector<Node>& sharded : results) {
-                        combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
+    std::vector<uint16_t> rel_type_ids;
+    for (const auto& rel_type : rel_types) {
+      // An unknown relationship type matches nothing, rather than everything like an empty list
+      rel_type_ids.push_back(relationship_types.getTypeId(rel_type));
+    }
+    seed = RandomSeed(seed);
+
+    auto walking = seastar::make_lw_shared<Walks>();
+    walking->walks.resize(ids.size());
+    for (uint64_t walk = 0; walk < ids.size(); walk++) {
+      if (ids[walk] > 0) {
+        walking->walks[walk].push_back(ids[walk]);
+        walking->walkers.push_back(Walker{walk, ids[walk], 0, {}});
+      }
+    }
+
+    return seastar::do_until([walking, length] { return walking->walkers.empty() || walking->step >= length; },
+                             [walking, direction, rel_type_ids = std::move(rel_type_ids), p, q, seed, this] {
+             std::map<uint16_t, std::vector<Walker>> sharded_walkers;
+             for (Walker& walker : walking->walkers) {
+               sharded_walkers[CalculateShardId(walker.current)].push_back(std::move(walker));
+             }
+             walking->walkers.clear();
+             uint64_t step = walking->step;
+             return PeerScatter<Walker>("RandomWalk", std::move(sharded_walkers), [step, direction, rel_type_ids, p, q, seed] (Shard &local_shard, const std::vector<Walker>& part) {
+                      return local_shard.RandomWalkStep(part, step, direction, rel_type_ids, p, q, seed);
+               })
+               .then([walking] (std::vector<Walker> moved) {
+                      for (Walker& walker : moved) {
+                        if (walker.current == 0) {
+                          // Only a start that is not a node comes back without a previous node
+                          if (walker.previous == 0) {
+                            walking->walks[walker.walk].clear();
+                          }
+                          continue;
+                        }
+                        walking->walks[walker.walk].push_back(walker.current);
+                        walking->walkers.push_back(std::move(walker));
                       }
-                      return combined;
+                      walking->step++;
                });
-        });
+      }).then([walking] {
+             return std::move(walking->walks);
+      });
+  }
+
+  seastar::future<> Shard::RandomWalkPeered(const std::string& query, std::function<seastar::future<>(std::vector<std::vector<uint64_t>>)> consume) {
+    dom::object object;
+    dom::array id_array;
+    if (parser.parse(query).get(object) || object["ids"].get(id_array)) {
+      return seastar::make_ready_future<>();
     }
-    case IN: {
-      return container().invoke_on(node_shard_id, [external_id, rel_types](Shard &local_shard) {
-               return local_shard.NodeGetShardedIncomingNodeIDs(external_id, rel_types); })
-        .then([this] (const std::map<uint16_t, std::vector<uint64_t>>& sharded_nodes_ids) {
-               std::vector<seastar::future<std::vector<Node>>> futures;
-               for (auto const& [their_shard, grouped_node_ids] : sharded_nodes_ids ) {
-                 auto future = container().invoke_on(their_shard, [grouped_node_ids = grouped_node_ids] (Shard &local_shard) {
-                        return local_shard.NodesGet(grouped_node_ids);
-                 });
-                 futures.push_back(std::move(future));
-               }
 
-               auto p = make_shared(std::move(futures));
-               return seastar::when_all_succeed(p->begin(), p->end()).then([] (const std::vector<std::vector<Node>>& results) {
-                      std::vector<Node> combined;
+    uint64_t length;
+    if (object["length"].get(length)) {
+      length = 10;
+    }
+    Direction direction = OUT;
+    std::string_view direction_name;
+    if (!object["direction"].get(direction_name)) {
+      if (direction_name == "in") {
+        direction = IN;
+      } else if (direction_name != "out") {
+        direction = BOTH;
+      }
+    }
+    std::vector<std::string> rel_types;
+    dom::array rel_type_array;
+    if (!object["rel_types"].get(rel_type_array)) {
+      for (dom::element rel_type : rel_type_array) {
+        std::string_view name;
+        if (!rel_type.get(name)) {
+          rel_types.emplace_back(name);
+        }
+      }
+    }
+    double p;
+    if (object["p"].get(p)) {
+      p = 1;
+    }
+    double q;
+    if (object["q"].get(q)) {
+      q = 1;
+    }
+    uint64_t seed;
+    if (object["seed"].get(seed)) {
+      seed = 0;
+    }
+    // Batches after the first draw from their own seed, and the same ones every time for the same seed
+    seed = RandomSeed(seed);
 
-                      for(const std::vector<Node>& sharded : results) {
-                        combined.insert(std::end(combined), std::begin(sharded), std::end(sharded));
+    return seastar::do_with(IdsOf(id_array), size_t(0), std::move(rel_types), std::move(consume),
+                            [length, direction, p, q, seed, this] (std::vector<uint64_t>& ids, size_t& first, std::vector<std::string>& rel_types,
+                                                                   std::function<seastar::future<>(std::vector<std::vector<uint64_t>>)>& consume) {
+             return seastar::do_until([&ids, &first] { return first >= ids.size(); }, [&ids, &first, &rel_types, &consume, length, direction, p, q, seed, this] {
+                      size_t last = std::min(ids.size(), first + WALK_BATCH);
+                      std::vector<uint64_t> batch(std::begin(ids) + first, std::begin(ids) + last);
+                      uint64_t batch_seed = first == 0 ? seed : SplitMix(seed + first);
+                      first = last;
+                      return RandomWalkPeered(batch, length, direction, rel_types, p, q, batch_seed).then([&consume] (std::vector<std::vector<uint64_t>> walks) {
+                             return consume(std::move(walks));
+                      });
+               });
+      });
+  }
+
+  seastar::future<std::vector<std::map<uint64_t, std::vector<uint64_t>>>> Shard::SampleNeighborsPeered(const std::vector<uint64_t>& ids, const std::vector<uint64_t>& fanouts, Direction direction,
+                                                                                                        const std::vector<std::string>& rel_types, uint64_t seed) {
+    std::vector<uint16_t> rel_type_ids;
+    for (const auto& rel_type : rel_types) {
+      rel_type_ids.push_back(relationship_types.getTypeId(rel_type));
+    }
+    seed = RandomSeed(seed);
+
+    // Each hop samples every node the hop before reached once, however many nodes reached it
+    struct Sampling {
+      std::vector<std::map<uint64_t, std::vector<uint64_t>>> hops;
+      std::vector<uint64_t> frontier;
+    };
+    auto sampling = seastar::make_lw_shared<Sampling>();
+    sampling->frontier = ids;
+    std::sort(std::begin(sampling->frontier), std::end(sampling->frontier));
+    sampling->frontier.erase(std::unique(std::begin(sampling->frontier), std::end(sampling->frontier)), std::end(sampling->frontier));
+
+    return seastar::do_until([sampling, hops = fanouts.size()] { return sampling->hops.size() >= hops || sampling->frontier.empty(); },
+                             [sampling, fanouts, direction, rel_type_ids = std::move(rel_type_ids), seed, this] {
+             std::map<uint16_t, std::vector<uint64_t>> sharded_ids;
+             for (uint64_t id : sampling->frontier) {
+               sharded_ids[CalculateShardId(id)].push_back(id);
+             }
+             uint64_t hop = sampling->hops.size();
+             uint64_t fanout = fanouts[hop];
+             return PeerScatter<std::pair<uint64_t, std::vector<uint64_t>>>("SampleNeighbors", std::move(sharded_ids), [fanout, hop, direction, rel_type_ids, seed] (Shard &local_shard, const std::vector<uint64_t>& part) {
+                      return local_shard.SampleNeighbors(part, fanout, hop, direction, rel_type_ids, seed);
+               })
+               .then([sampling] (std::vector<std::pair<uint64_t, std::vector<uint64_t>>> sampled) {
+                      std::map<uint64_t, std::vector<uint64_t>>& hop = sampling->hops.emplace_back();
+                      sampling->frontier.clear();
+                      for (auto& [id, neighbors] : sampled) {
+                        sampling->frontier.insert(std::end(sampling->frontier), std::begin(neighbors), std::end(neighbors));
+                        hop.emplace(id, std::move(neighbors));
                       }
-                      return combined;
+                      std::sort(std::begin(sampling->frontier), std::end(sampling->frontier));
+                      sampling->frontier.erase(std::unique(std::begin(sampling->frontier), std::end(sampling->frontier)), std::end(sampling->frontier));
                });
-        });
+      }).then([sampling] {
+             return std::move(sampling->hops);
+      });
+  }
+
+  seastar::future<std::vector<std::map<uint64_t, std::vector<uint64_t>>>> Shard::SampleNeighborsPeered(const std::string& query) {
+    dom::object object;
+    dom::array id_array;
+    dom::array fanout_array;
+    if (parser.parse(query).get(object) || object["ids"].get(id_array) || object["fanouts"].get(fanout_array)) {
+      return seastar::make_ready_future<std::vector<std::map<uint64_t, std::vector<uint64_t>>>>();
     }
-    default: return NodeGetNeighborsPeered(external_id, rel_types);
+
+    std::vector<uint64_t> fanouts;
+    for (dom::element element : fanout_array) {
+      uint64_t fanout;
+      if (!element.get(fanout)) {
+        fanouts.push_back(fanout);
+      }
+    }
+    Direction direction = OUT;
+    std::string_view direction_name;
+    if (!object["direction"].get(direction_name)) {
+      if (direction_name == "in") {
+        direction = IN;
+      } else if (direction_name != "out") {
+        direction = BOTH;
+      }
+    }
+    std::vector<std::string> rel_types;
+    dom::array rel_type_array;
+    if (!object["rel_types"].get(rel_type_array)) {
+      for (dom::element rel_type : rel_type_array) {
+        std::string_view name;
+        if (!rel_type.get(name)) {
+          rel_types.emplace_back(name);
+        }
+      }
+    }
+    uint64_t seed;
+    if (object["seed"].get(seed)) {
+      seed = 0;
     }
+
+    return SampleNeighborsPeered(IdsOf(id_array), fanouts, direction, rel_types, seed);
   }
 
   // All
@@ -6054,16 +10407,9 @@ namespace triton {
     uint64_t max = skip + limit;
 
     // Get the {Node Type Id, Count} map for each core
-    std::vector<seastar::future<std::map<uint16_t, uint64_t>>> futures;
-    for (int i=0; i<cpus; i++) {
-      auto future = container().invoke_on(i, [] (Shard &local_shard) mutable {
+    return PeerMap("AllNodeIds", [] (Shard &local_shard) {
              return local_shard.AllNodeIdCounts();
-      });
-      futures.push_back(std::move(future));
-    }
-
-    auto p = make_shared(std::move(futures));
-    return seastar::when_all_succeed(p->begin(), p->end()).then([skip, max, limit, this] (const std::vector<std::map<uint16_t, uint64_t>>& results) {
+    }).then([skip, max, limit, this] (const std::vector<std::map<uint16_t, uint64_t>>& results) {
            uint64_t current = 0;
            uint64_t next = 0;
            int current_shard_id = 0;
@@ -6085,26 +10431,15 @@ namespace triton {
              requests.insert({current_shard_id++, threaded_requests});
            }
 
-           std::vector<seastar::future<std::vector<uint64_t>>> futures;
-
-           for (const auto& request : requests) {
-             for (auto entry : request.second) {
-               auto future = container().invoke_on(request.first, [entry] (Shard &local_shard) mutable {
-                      return local_shard.AllNodeIds(entry.first, entry.second.first, entry.second.second);
-               });
-               futures.push_back(std::move(future));
-             }
-           }
-
-           auto p2 = make_shared(std::move(futures));
-           return seastar::when_all_succeed(p2->begin(), p2->end()).then([limit] (const std::vector<std::vector<uint64_t>>& results) {
-                  std::vector<uint64_t> ids;
-                  ids.reserve(limit);
-                  for (auto result : results) {
-                    ids.insert(std::end(ids), std::begin(result), std::end(result));
+           // Every shard gets all of its type windows in one call, and the results stop at the limit
+           return PeerScatter<uint64_t>("AllNodeIds", std::move(requests), [] (Shard &local_shard, const std::map<uint16_t, std::pair<uint64_t, uint64_t>>& windows) {
+                  std::vector<uint64_t> found;
+                  for (const auto& [type_id, window] : windows) {
+                    std::vector<uint64_t> typed = local_shard.AllNodeIds(type_id, window.first, window.second);
+                    found.insert(std::end(found), std::make_move_iterator(std::begin(typed)), std::make_move_iterator(std::end(typed)));
                   }
-                  return ids;
-           });
+                  return found;
+           }, limit);
     });
   }
 
@@ -6113,16 +10448,9 @@ namespace triton {
     uint64_t max = skip + limit;
 
     // Get the {Node Type Id, Count} map for each core
-    std::vector<seastar::future<uint64_t>> futures;
-    for (int i=0; i<cpus; i++) {
-      auto future = container().invoke_on(i, [node_type_id] (Shard &local_shard) mutable {
+    return PeerMap("AllNodeIds", [node_type_id] (Shard &local_shard) {
              return local_shard.AllNodeIdCounts(node_type_id);
-      });
-      futures.push_back(std::move(future));
-    }
-
-    auto p = make_shared(std::move(futures));
-    return seastar::when_all_succeed(p->begin(), p->end()).then([node_type_id, skip, max, limit, this] (const std::vector<uint64_t>& results) {
+    }).then([node_type_id, skip, max, limit, this] (const std::vector<uint64_t>& results) {
            uint64_t current = 0;
            uint64_t next = 0;
            int current_shard_id = 0;
@@ -6140,25 +10468,9 @@ namespace triton {
              current = next;
            }
 
-           std::vector<seastar::future<std::vector<uint64_t>>> futures;
-
-           for (const auto& request : requests) {
-             auto future = container().invoke_on(request.first, [node_type_id, request] (Shard &local_shard) mutable {
-                    return local_shard.AllNodeIds(node_type_id, request.second.first, request.second.second);
-             });
-             futures.push_back(std::move(future));
-
-           }
-
-           auto p2 = make_shared(std::move(futures));
-           return seastar::when_all_succeed(p2->begin(), p2->end()).then([limit] (const std::vector<std::vector<uint64_t>>& results) {
-                  std::vector<uint64_t> ids;
-                  ids.reserve(limit);
-                  for (auto result : results) {
-                    ids.insert(std::end(ids), std::begin(result), std::end(result));
-                  }
-                  return ids;
-           });
+           return PeerScatter<uint64_t>("AllNodeIds", std::move(requests), [node_type_id] (Shard &local_shard, const std::pair<uint64_t, uint64_t>& window) {
+                  return local_shard.AllNodeIds(node_type_id, window.first, window.second);
+           }, limit);
     });
   }
 
@@ -6166,16 +10478,9 @@ namespace triton {
     uint64_t max = skip + limit;
 
     // Get the {Node Type Id, Count} map for each core
-    std::vector<seastar::future<std::map<uint16_t, uint64_t>>> futures;
-    for (int i=0; i<cpus; i++) {
-      auto future = container().invoke_on(i, [] (Shard &local_shard) mutable {
+    return PeerMap("AllNodes", [] (Shard &local_shard) {
              return local_shard.AllNodeIdCounts();
-      });
-      futures.push_back(std::move(future));
-    }
-
-    auto p = make_shared(std::move(futures));
-    return seastar::when_all_succeed(p->begin(), p->end()).then([skip, max, limit, this] (const std::vector<std::map<uint16_t, uint64_t>>& results) {
+    }).then([skip, max, limit, this] (const std::vector<std::map<uint16_t, uint64_t>>& results) {
            uint64_t current = 0;
            uint64_t next = 0;
            int current_shard_id = 0;
@@ -6197,26 +10502,15 @@ namespace triton {
              requests.insert({current_shard_id++, threaded_requests});
            }
 
-           std::vector<seastar::future<std::vector<Node>>> futures;
-
-           for (const auto& request : requests) {
-             for (auto entry : request.second) {
-               auto future = container().invoke_on(request.first, [entry] (Shard &local_shard) mutable {
-                      return local_shard.AllNodes(entry.first, entry.second.first, entry.second.second);
-               });
-               futures.push_back(std::move(future));
-             }
-           }
-
-           auto p2 = make_shared(std::move(futures));
-           return seastar::when_all_succeed(p2->begin(), p2->end()).then([limit] (const std::vector<std::vector<Node>>& results) {
-                  std::vector<Node> requested_nodes;
-                  requested_nodes.reserve(limit);
-                  for (auto result : results) {
-                    requested_nodes.insert(std::end(requested_nodes), std::begin(result), std::end(result));
+           // Every shard gets all of its type windows in one call, and the results stop at the limit
+           return PeerScatter<Node>("AllNodes", std::move(requests), [] (Shard &local_shard, const std::map<uint16_t, std::pair<uint64_t, uint64_t>>& windows) {
+                  std::vector<Node> found;
+                  for (const auto& [type_id, window] : windows) {
+                    std::vector<Node> typed = local_shard.AllNodes(type_id, window.first, window.second);
+                    found.insert(std::end(found), std::make_move_iterator(std::begin(typed)), std::make_move_iterator(std::end(typed)));
                   }
-                  return requested_nodes;
-           });
+                  return found;
+           }, limit);
     });
   }
 
@@ -6225,16 +10519,9 @@ namespace triton {
     uint64_t max = skip + limit;
 
     // Get the {Node Type Id, Count} map for each core
-    std::vector<seastar::future<uint64_t>> futures;
-    for (int i=0; i<cpus; i++) {
-      auto future = container().invoke_on(i, [node_type_id] (Shard &local_shard) mutable {
+    return PeerMap("AllNodes", [node_type_id] (Shard &local_shard) {
              return local_shard.AllNodeIdCounts(node_type_id);
-      });
-      futures.push_back(std::move(future));
-    }
-
-    auto p = make_shared(std::move(futures));
-    return seastar::when_all_succeed(p->begin(), p->end()).then([node_type_id, skip, max, limit, this] (const std::vector<uint64_t>& results) {
+    }).then([node_type_id, skip, max, limit, this] (const std::vector<uint64_t>& results) {
            uint64_t current = 0;
            uint64_t next = 0;
            int current_shard_id = 0;
@@ -6252,25 +10539,9 @@ namespace triton {
              current = next;
            }
 
-           std::vector<seastar::future<std::vector<Node>>> futures;
-
-           for (const auto& request : requests) {
-             auto future = container().invoke_on(request.first, [node_type_id, request] (Shard &local_shard) mutable {
-                    return local_shard.AllNodes(node_type_id, request.second.first, request.second.second);
-             });
-             futures.push_back(std::move(future));
-
-           }
-
-           auto p2 = make_shared(std::move(futures));
-           return seastar::when_all_succeed(p2->begin(), p2->end()).then([limit] (const std::vector<std::vector<Node>>& results) {
-                  std::vector<Node> requested_nodes;
-                  requested_nodes.reserve(limit);
-                  for (auto result : results) {
-                    requested_nodes.insert(std::end(requested_nodes), std::begin(result), std::end(result));
-                  }
-                  return requested_nodes;
-           });
+           return PeerScatter<Node>("AllNodes", std::move(requests), [node_type_id] (Shard &local_shard, const std::pair<uint64_t, uint64_t>& window) {
+                  return local_shard.AllNodes(node_type_id, window.first, window.second);
+           }, limit);
     });
   }
 
@@ -6278,16 +10549,9 @@ namespace triton {
     uint64_t max = skip + limit;
 
     // Get the {Relationship Type Id, Count} map for each core
-    std::vector<seastar::future<std::map<uint16_t, uint64_t>>> futures;
-    for (int i=0; i<cpus; i++) {
-      auto future = container().invoke_on(i, [] (Shard &local_shard) mutable {
+    return PeerMap("AllRelationshipIds", [] (Shard &local_shard) {
              return local_shard.AllRelationshipIdCounts();
-      });
-      futures.push_back(std::move(future));
-    }
-
-    auto p = make_shared(std::move(futures));
-    return seastar::when_all_succeed(p->begin(), p->end()).then([skip, max, limit, this] (const std::vector<std::map<uint16_t, uint64_t>>& results) {
+    }).then([skip, max, limit, this] (const std::vector<std::map<uint16_t, uint64_t>>& results) {
            uint64_t current = 0;
            uint64_t next = 0;
            int current_shard_id = 0;
@@ -6309,26 +10573,15 @@ namespace triton {
              requests.insert({current_shard_id++, threaded_requests});
            }
 
-           std::vector<seastar::future<std::vector<uint64_t>>> futures;
-
-           for (const auto& request : requests) {
-             for (auto entry : request.second) {
-               auto future = container().invoke_on(request.first, [entry] (Shard &local_shard) mutable {
-                      return local_shard.AllRelationshipIds(entry.first, entry.second.first, entry.second.second);
-               });
-               futures.push_back(std::move(future));
-             }
-           }
-
-           auto p2 = make_shared(std::move(futures));
-           return seastar::when_all_succeed(p2->begin(), p2->end()).then([limit] (const std::vector<std::vector<uint64_t>>& results) {
-                  std::vector<uint64_t> ids;
-                  ids.reserve(limit);
-                  for (auto result : results) {
-                    ids.insert(std::end(ids), std::begin(result), std::end(result));
+           // Every shard gets all of its type windows in one call, and the results stop at the limit
+           return PeerScatter<uint64_t>("AllRelationshipIds", std::move(requests), [] (Shard &local_shard, const std::map<uint16_t, std::pair<uint64_t, uint64_t>>& windows) {
+                  std::vector<uint64_t> found;
+                  for (const auto& [type_id, window] : windows) {
+                    std::vector<uint64_t> typed = local_shard.AllRelationshipIds(type_id, window.first, window.second);
+                    found.insert(std::end(found), std::make_move_iterator(std::begin(typed)), std::make_move_iterator(std::end(typed)));
                   }
-                  return ids;
-           });
+                  return found;
+           }, limit);
     });
   }
 
@@ -6337,16 +10590,9 @@ namespace triton {
     uint64_t max = skip + limit;
 
     // Get the {Relationship Type Id, Count} map for each core
-    std::vector<seastar::future<uint64_t>> futures;
-    for (int i=0; i<cpus; i++) {
-      auto future = container().invoke_on(i, [relationship_type_id] (Shard &local_shard) mutable {
+    return PeerMap("AllRelationshipIds", [relationship_type_id] (Shard &local_shard) {
              return local_shard.AllRelationshipIdCounts(relationship_type_id);
-      });
-      futures.push_back(std::move(future));
-    }
-
-    auto p = make_shared(std::move(futures));
-    return seastar::when_all_succeed(p->begin(), p->end()).then([relationship_type_id, skip, max, limit, this] (const std::vector<uint64_t>& results) {
+    }).then([relationship_type_id, skip, max, limit, this] (const std::vector<uint64_t>& results) {
            uint64_t current = 0;
            uint64_t next = 0;
            int current_shard_id = 0;
@@ -6364,42 +10610,19 @@ namespace triton {
              current = next;
            }
 
-           std::vector<seastar::future<std::vector<uint64_t>>> futures;
-
-           for (const auto& request : requests) {
-             auto future = container().invoke_on(request.first, [relationship_type_id, request] (Shard &local_shard) mutable {
-                    return local_shard.AllRelationshipIds(relationship_type_id, request.second.first, request.second.second);
-             });
-             futures.push_back(std::move(future));
-
-           }
-
-           auto p2 = make_shared(std::move(futures));
-           return seastar::when_all_succeed(p2->begin(), p2->end()).then([limit] (const std::vector<std::vector<uint64_t>>& results) {
-                  std::vector<uint64_t> ids;
-                  ids.reserve(limit);
-                  for (auto result : results) {
-                    ids.insert(std::end(ids), std::begin(result), std::end(result));
-                  }
-                  return ids;
-           });
+           return PeerScatter<uint64_t>("AllRelationshipIds", std::move(requests), [relationship_type_id] (Shard &local_shard, const std::pair<uint64_t, uint64_t>& window) {
+                  return local_shard.AllRelationshipIds(relationship_type_id, window.first, window.second);
+           }, limit);
     });
   }
 
-  seastar::future<std::vector<Relationship>> Shard::AllRelationshipsPeered(uint64_t skip, uint64_t limit) {
+  seastar::future<std::vector<Relationship>> Shard::AllRelationshipsPeered(uint64_t skip, uint64_t limit, NodeProjection projection) {
     uint64_t max = skip + limit;
 
     // Get the {Relationship Type Id, Count} map for each core
-    std::vector<seastar::future<std::map<uint16_t, uint64_t>>> futures;
-    for (int i=0; i<cpus; i++) {
-      auto future = container().invoke_on(i, [] (Shard &local_shard) mutable {
+    return PeerMap("AllRelationships", [] (Shard &local_shard) {
              return local_shard.AllRelationshipIdCounts();
-      });
-      futures.push_back(std::move(future));
-    }
-
-    auto p = make_shared(std::move(futures));
-    return seastar::when_all_succeed(p->begin(), p->end()).then([skip, max, limit, this] (const std::vector<std::map<uint16_t, uint64_t>>& results) {
+    }).then([skip, max, limit, projection, this] (const std::vector<std::map<uint16_t, uint64_t>>& results) {
            uint64_t current = 0;
            uint64_t next = 0;
            int current_shard_id = 0;
@@ -6421,80 +10644,422 @@ namespace triton {
              requests.insert({current_shard_id++, threaded_requests});
            }
 
-           std::vector<seastar::future<std::vector<Relationship>>> futures;
+           // Every shard gets all of its type windows in one call, and the results stop at the limit
+           return PeerScatter<Relationship>("AllRelationships", std::move(requests), [projection] (Shard &local_shard, const std::map<uint16_t, std::pair<uint64_t, uint64_t>>& windows) {
+                  std::vector<Relationship> found;
+                  for (const auto& [type_id, window] : windows) {
+                    std::vector<Relationship> typed = local_shard.AllRelationships(type_id, window.first, window.second, projection);
+                    found.insert(std::end(found), std::make_move_iterator(std::begin(typed)), std::make_move_iterator(std::end(typed)));
+                  }
+                  return found;
+           }, limit);
+    });
+  }
+
+  seastar::future<std::vector<Relationship>> Shard::AllRelationshipsPeered(const std::string &rel_type, uint64_t skip, uint64_t limit, NodeProjection projection) {
+    uint16_t relationship_type_id = node_types.getTypeId(rel_type);
+    uint64_t max = skip + limit;
+
+    // Get the {Relationship Type Id, Count} map for each core
+    return PeerMap("AllRelationships", [relationship_type_id] (Shard &local_shard) {
+             return local_shard.AllRelationshipIdCounts(relationship_type_id);
+    }).then([relationship_type_id, skip, max, limit, projection, this] (const std::vector<uint64_t>& results) {
+           uint64_t current = 0;
+           uint64_t next = 0;
+           int current_shard_id = 0;
+           std::vector<uint64_t> ids;
+           std::map<uint16_t, std::pair<uint64_t , uint64_t>> requests;
+           for (const auto& count : results) {
+             next = current + count;
+             if (next > skip) {
+               std::pair<uint64_t, uint64_t> pair = std::make_pair(skip - current, limit);
+               requests.insert({ current_shard_id++, pair });
+               if (next <= max) {
+                 break; // We have everything we need
+               }
+             }
+             current = next;
+           }
+
+           return PeerScatter<Relationship>("AllRelationships", std::move(requests), [relationship_type_id, projection] (Shard &local_shard, const std::pair<uint64_t, uint64_t>& window) {
+                  return local_shard.AllRelationships(relationship_type_id, window.first, window.second, projection);
+           }, limit);
+    });
+  }
+
+  seastar::future<std::pair<std::vector<Node>, Cursor>> Shard::AllNodesPeered(Cursor cursor, uint64_t limit) {
+    if (cursor.finished || cursor.shard >= cpus) {
+      cursor.finished = true;
+      return seastar::make_ready_future<std::pair<std::vector<Node>, Cursor>>(std::make_pair(std::vector<Node>(), cursor));
+    }
+    return PeerOn("AllRelationships", cursor.shard, [cursor, limit] (Shard &local_shard) {
+             return local_shard.AllNodes(cursor, limit);
+      })
+      .then([cursor, limit, this] (std::vector<Node> some_nodes) mutable {
+             if (some_nodes.size() == limit) {
+               if (!some_nodes.empty()) {
+                 cursor.id = externalToInternal(some_nodes.back().getId());
+               }
+               return seastar::make_ready_future<std::pair<std::vector<Node>, Cursor>>(std::make_pair(std::move(some_nodes), cursor));
+             }
+             // This shard is done, fill the rest of the page from the next one
+             cursor = Cursor(cursor.shard + 1, cursor.type_id, 0, cursor.view);
+             if (cursor.shard >= cpus) {
+               cursor.finished = true;
+               return seastar::make_ready_future<std::pair<std::vector<Node>, Cursor>>(std::make_pair(std::move(some_nodes), cursor));
+             }
+             return AllNodesPeered(cursor, limit - some_nodes.size())
+               .then([some_nodes = std::move(some_nodes)] (std::pair<std::vector<Node>, Cursor> rest) mutable {
+                      some_nodes.insert(std::end(some_nodes), std::make_move_iterator(std::begin(rest.first)), std::make_move_iterator(std::end(rest.first)));
+                      return std::make_pair(std::move(some_nodes), rest.second);
+               });
+      });
+  }
+
+  seastar::future<std::pair<std::vector<Relationship>, Cursor>> Shard::AllRelationshipsPeered(Cursor cursor, uint64_t limit, NodeProjection projection) {
+    if (cursor.finished || cursor.shard >= cpus) {
+      cursor.finished = true;
+      return seastar::make_ready_future<std::pair<std::vector<Relationship>, Cursor>>(std::make_pair(std::vector<Relationship>(), cursor));
+    }
+    return PeerOn("AllRelationships", cursor.shard, [cursor, limit, projection] (Shard &local_shard) {
+             return local_shard.AllRelationships(cursor, limit, projection);
+      })
+      .then([cursor, limit, projection, this] (std::vector<Relationship> some_relationships) mutable {
+             if (some_relationships.size() == limit) {
+               if (!some_relationships.empty()) {
+                 cursor.id = externalToInternal(some_relationships.back().getId());
+               }
+               return seastar::make_ready_future<std::pair<std::vector<Relationship>, Cursor>>(std::make_pair(std::move(some_relationships), cursor));
+             }
+             // This shard is done, fill the rest of the page from the next one
+             cursor = Cursor(cursor.shard + 1, cursor.type_id, 0, cursor.view);
+             if (cursor.shard >= cpus) {
+               cursor.finished = true;
+               return seastar::make_ready_future<std::pair<std::vector<Relationship>, Cursor>>(std::make_pair(std::move(some_relationships), cursor));
+             }
+             return AllRelationshipsPeered(cursor, limit - some_relationships.size(), projection)
+               .then([some_relationships = std::move(some_relationships)] (std::pair<std::vector<Relationship>, Cursor> rest) mutable {
+                      some_relationships.insert(std::end(some_relationships), std::make_move_iterator(std::begin(rest.first)), std::make_move_iterator(std::end(rest.first)));
+                      return std::make_pair(std::move(some_relationships), rest.second);
+               });
+      });
+  }
+
+  // Bulk Import ===========================================================================================================================
+
+  seastar::future<uint64_t> Shard::NodesImportCsvPeered(std::string csv) {
+    return seastar::async([csv = std::move(csv), this] () mutable {
+      CsvStringCursor cursor(std::move(csv));
+      return NodesImportCsv(cursor);
+    });
+  }
+
+  seastar::future<uint64_t> Shard::NodesImportCsvFilePeered(const std::string &filename) {
+    return seastar::async([filename, this] () {
+      csvmonkey::MappedFileCursor cursor;
+      try {
+        cursor.open(filename.c_str());
+      } catch (const csvmonkey::Error &error) {
+        // Missing or unreadable file
+        return uint64_t(0);
+      }
+      return NodesImportCsv(cursor);
+    });
+  }
+
+  seastar::future<uint64_t> Shard::RelationshipsImportCsvPeered(std::string csv) {
+    return seastar::async([csv = std::move(csv), this] () mutable {
+      CsvStringCursor cursor(std::move(csv));
+      return RelationshipsImportCsv(cursor);
+    });
+  }
+
+  seastar::future<uint64_t> Shard::RelationshipsImportCsvFilePeered(const std::string &filename) {
+    return seastar::async([filename, this] () {
+      csvmonkey::MappedFileCursor cursor;
+      try {
+        cursor.open(filename.c_str());
+      } catch (const csvmonkey::Error &error) {
+        // Missing or unreadable file
+        return uint64_t(0);
+      }
+      return RelationshipsImportCsv(cursor);
+    });
+  }
+
+  uint64_t Shard::NodesImportCsv(csvmonkey::StreamCursor &cursor) {
+    // Make room on every shard for its share of the nodes up front instead of growing as we go
+    uint64_t lines = std::count(cursor.buf(), cursor.buf() + cursor.size(), '\n');
+    PeerOnAll("NodesImportCsv", [lines] (Shard &local_shard) {
+      local_shard.reserve(local_shard.nodes.size() + lines / local_shard.cpus, local_shard.relationships.size());
+    }).get();
 
-           for (const auto& request : requests) {
-             for (auto entry : request.second) {
-               auto future = container().invoke_on(request.first, [entry] (Shard &local_shard) mutable {
-                      return local_shard.AllRelationships(entry.first, entry.second.first, entry.second.second);
-               });
-               futures.push_back(std::move(future));
-             }
-           }
+    csvmonkey::CsvReader<csvmonkey::StreamCursor> reader(cursor);
+    if (!reader.read_row()) {
+      return 0;
+    }
 
-           auto p2 = make_shared(std::move(futures));
-           return seastar::when_all_succeed(p2->begin(), p2->end()).then([limit] (const std::vector<std::vector<Relationship>>& results) {
-                  std::vector<Relationship> requested_relationships;
-                  requested_relationships.reserve(limit);
-                  for (auto result : results) {
-                    requested_relationships.insert(std::end(requested_relationships), std::begin(result), std::end(result));
-                  }
-                  return requested_relationships;
-           });
-    });
+    // The type and key columns are required, every other column is a property
+    std::vector<std::pair<std::string, Properties::ColumnType>> header = CsvHeader(reader.row());
+    size_t type_column = CsvColumn(header, "type");
+    size_t key_column = CsvColumn(header, "key");
+    if (type_column == header.size() || key_column == header.size()) {
+      return 0;
+    }
+
+    uint64_t count = 0;
+    std::vector<std::tuple<std::string, std::string, std::map<std::string, std::any>>> batch;
+    batch.reserve(IMPORT_BATCH_SIZE);
+    auto add_batch = [&count, &batch, this] () {
+      std::vector<uint64_t> ids = NodesAddPeered(std::move(batch)).get0();
+      count += std::count_if(std::begin(ids), std::end(ids), [] (uint64_t id) { return id > 0; });
+      batch.clear();
+    };
+
+    while (reader.read_row()) {
+      csvmonkey::CsvCursor &row = reader.row();
+      // Skip rows that are missing columns
+      if (row.count < header.size()) {
+        continue;
+      }
+      batch.emplace_back(row.cells[type_column].as_str(), row.cells[key_column].as_str(), CsvProperties(header, row));
+      if (batch.size() == IMPORT_BATCH_SIZE) {
+        add_batch();
+      }
+    }
+
+    if (!batch.empty()) {
+      add_batch();
+    }
+
+    return count;
   }
 
-  seastar::future<std::vector<Relationship>> Shard::AllRelationshipsPeered(const std::string &rel_type, uint64_t skip, uint64_t limit) {
-    uint16_t relationship_type_id = node_types.getTypeId(rel_type);
-    uint64_t max = skip + limit;
+  uint64_t Shard::RelationshipsImportCsv(csvmonkey::StreamCursor &cursor) {
+    // Make room on every shard for its share of the relationships up front instead of growing as we go
+    uint64_t lines = std::count(cursor.buf(), cursor.buf() + cursor.size(), '\n');
+    PeerOnAll("RelationshipsImportCsv", [lines] (Shard &local_shard) {
+      local_shard.reserve(local_shard.nodes.size(), local_shard.relationships.size() + lines / local_shard.cpus);
+    }).get();
 
-    // Get the {Relationship Type Id, Count} map for each core
-    std::vector<seastar::future<uint64_t>> futures;
-    for (int i=0; i<cpus; i++) {
-      auto future = container().invoke_on(i, [relationship_type_id] (Shard &local_shard) mutable {
-             return local_shard.AllRelationshipIdCounts(relationship_type_id);
-      });
-      futures.push_back(std::move(future));
+    csvmonkey::CsvReader<csvmonkey::StreamCursor> reader(cursor);
+    if (!reader.read_row()) {
+      return 0;
     }
 
-    auto p = make_shared(std::move(futures));
-    return seastar::when_all_succeed(p->begin(), p->end()).then([relationship_type_id, skip, max, limit, this] (const std::vector<uint64_t>& results) {
-           uint64_t current = 0;
-           uint64_t next = 0;
-           int current_shard_id = 0;
-           std::vector<uint64_t> ids;
-           std::map<uint16_t, std::pair<uint64_t , uint64_t>> requests;
-           for (const auto& count : results) {
-             next = current + count;
-             if (next > skip) {
-               std::pair<uint64_t, uint64_t> pair = std::make_pair(skip - current, limit);
-               requests.insert({ current_shard_id++, pair });
-               if (next <= max) {
-                 break; // We have everything we need
-               }
-             }
-             current = next;
-           }
+    // The relationship type and the type and key of both nodes are required, every other column is a property
+    std::vector<std::pair<std::string, Properties::ColumnType>> header = CsvHeader(reader.row());
+    size_t rel_type_column = CsvColumn(header, "rel_type");
+    size_t type1_column = CsvColumn(header, "type");
+    size_t key1_column = CsvColumn(header, "key");
+    size_t type2_column = CsvColumn(header, "type2");
+    size_t key2_column = CsvColumn(header, "key2");
+    if (rel_type_column == header.size() || type1_column == header.size() || key1_column == header.size()
+        || type2_column == header.size() || key2_column == header.size()) {
+      return 0;
+    }
 
-           std::vector<seastar::future<std::vector<Relationship>>> futures;
+    uint64_t count = 0;
+    std::vector<std::tuple<std::string, std::string, std::string, std::string, std::string, std::map<std::string, std::any>>> batch;
+    batch.reserve(IMPORT_BATCH_SIZE);
+    auto add_batch = [&count, &batch, this] () {
+      std::vector<uint64_t> ids = RelationshipsAddPeered(std::move(batch)).get0();
+      count += std::count_if(std::begin(ids), std::end(ids), [] (uint64_t id) { return id > 0; });
+      batch.clear();
+    };
 
-           for (const auto& request : requests) {
-             auto future = container().invoke_on(request.first, [relationship_type_id, request] (Shard &local_shard) mutable {
-                    return local_shard.AllRelationships(relationship_type_id, request.second.first, request.second.second);
-             });
-             futures.push_back(std::move(future));
+    while (reader.read_row()) {
+      csvmonkey::CsvCursor &row = reader.row();
+      // Skip rows that are missing columns
+      if (row.count < header.size()) {
+        continue;
+      }
+      batch.emplace_back(row.cells[rel_type_column].as_str(), row.cells[type1_column].as_str(), row.cells[key1_column].as_str(),
+                         row.cells[type2_column].as_str(), row.cells[key2_column].as_str(), CsvProperties(header, row));
+      if (batch.size() == IMPORT_BATCH_SIZE) {
+        add_batch();
+      }
+    }
 
-           }
+    if (!batch.empty()) {
+      add_batch();
+    }
 
-           auto p2 = make_shared(std::move(futures));
-           return seastar::when_all_succeed(p2->begin(), p2->end()).then([limit] (const std::vector<std::vector<Relationship>>& results) {
-                  std::vector<Relationship> requested_relationships;
-                  requested_relationships.reserve(limit);
-                  for (auto result : results) {
-                    requested_relationships.insert(std::end(requested_relationships), std::begin(result), std::end(result));
-                  }
-                  return requested_relationships;
-           });
+    return count;
+  }
+
+  // Export
+  uint64_t Shard::NodesExport(const std::string &file_name, ExportFormat format, uint64_t view_id) {
+    ExportFile file(file_name);
+    std::string chunk;
+    std::vector<std::pair<std::string, Properties::ColumnType>> columns;
+    if (format == ExportFormat::CSV) {
+      // One header for every node type, each row only fills the columns of its own type
+      std::set<std::pair<std::string, Properties::ColumnType>> schema;
+      for (const auto &[type_id, properties] : node_properties) {
+        for (const auto &[key, type] : properties.getSchema()) {
+          if (type != Properties::ColumnType::ANY) {
+            schema.emplace(key, type);
+          }
+        }
+      }
+      columns.assign(std::begin(schema), std::end(schema));
+      chunk.append("type,key");
+      for (const auto &[key, type] : columns) {
+        chunk.push_back(',');
+        ExportFile::appendCsvCell(chunk, ExportFile::csvColumn(key, type));
+      }
+      chunk.push_back('\n');
+    } else {
+      Serializer serializer(chunk);
+      serializer.put(ExportFile::MAGIC);
+      serializer.put(ExportFile::VERSION);
+    }
+
+    uint64_t count = 0;
+    Cursor cursor(shard_id, 0, 0, view_id);
+    while (true) {
+      // A view that expired halfway would mix versions
+      if (!ReadViewExists(view_id)) {
+        throw std::runtime_error("Read view of " + file_name + " expired");
+      }
+      std::vector<Node> batch = AllNodes(cursor, EXPORT_BATCH_SIZE);
+      if (format == ExportFormat::CSV) {
+        for (Node &node : batch) {
+          ExportFile::appendCsvRow(chunk, { node_types.getType(node.getTypeId()), node.getKey() }, columns, node.getProperties());
+        }
+      } else {
+        std::map<uint16_t, ExportBlock> blocks;
+        for (Node &node : batch) {
+          ExportBlock &block = blocks[node.getTypeId()];
+          block.ids.push_back(node.getId());
+          block.keys.push_back(node.getKey());
+          block.properties.push_back(node.getProperties());
+        }
+        Serializer serializer(chunk);
+        for (auto &[type_id, block] : blocks) {
+          block.kind = ExportBlock::NODES;
+          block.type = node_types.getType(type_id);
+          block.write(serializer);
+        }
+      }
+      file.write(chunk);
+      chunk.clear();
+      count += batch.size();
+      if (batch.size() < EXPORT_BATCH_SIZE) {
+        break;
+      }
+      cursor.id = externalToInternal(batch.back().getId());
+      seastar::thread::maybe_yield();
+    }
+
+    file.close();
+    return count;
+  }
+
+  uint64_t Shard::RelationshipsExport(const std::string &file_name, ExportFormat format, uint64_t view_id) {
+    ExportFile file(file_name);
+    std::string chunk;
+    std::vector<std::pair<std::string, Properties::ColumnType>> columns;
+    if (format == ExportFormat::CSV) {
+      // Relationships keep their own properties, so the header takes a pass over all of them
+      std::set<std::pair<std::string, Properties::ColumnType>> schema;
+      for (auto &relationship : relationships) {
+        if (relationship.getId() == 0) {
+          continue;
+        }
+        for (const auto &[key, value] : relationship.getProperties()) {
+          Properties::ColumnType type = Properties::getColumnType(value);
+          if (type != Properties::ColumnType::ANY) {
+            schema.emplace(key, type);
+          }
+        }
+      }
+      columns.assign(std::begin(schema), std::end(schema));
+      chunk.append("rel_type,type,key,type2,key2");
+      for (const auto &[key, type] : columns) {
+        chunk.push_back(',');
+        ExportFile::appendCsvCell(chunk, ExportFile::csvColumn(key, type));
+      }
+      chunk.push_back('\n');
+    } else {
+      Serializer serializer(chunk);
+      serializer.put(ExportFile::MAGIC);
+      serializer.put(ExportFile::VERSION);
+    }
+
+    uint64_t count = 0;
+    Cursor cursor(shard_id, 0, 0, view_id);
+    while (true) {
+      if (!ReadViewExists(view_id)) {
+        throw std::runtime_error("Read view of " + file_name + " expired");
+      }
+      std::vector<Relationship> batch = AllRelationships(cursor, EXPORT_BATCH_SIZE);
+      if (format == ExportFormat::CSV) {
+        // The bulk import finds nodes by type and key, so both ends are looked up on their shards in one batch
+        std::vector<uint64_t> node_ids;
+        node_ids.reserve(2 * batch.size());
+        for (const auto &relationship : batch) {
+          node_ids.push_back(relationship.getStartingNodeId());
+          node_ids.push_back(relationship.getEndingNodeId());
+        }
+        std::vector<Node> ends = NodesGetPeered(node_ids, NodeProjection::KEY).get0();
+        for (size_t i = 0; i < batch.size(); i++) {
+          const Node &starting = ends[2 * i];
+          const Node &ending = ends[2 * i + 1];
+          if (starting.getId() == 0 || ending.getId() == 0) {
+            continue;
+          }
+          ExportFile::appendCsvRow(chunk, { relationship_types.getType(batch[i].getTypeId()), node_types.getType(starting.getTypeId()), starting.getKey(),
+                                            node_types.getType(ending.getTypeId()), ending.getKey() }, columns, batch[i].getProperties());
+          count++;
+        }
+      } else {
+        std::map<uint16_t, ExportBlock> blocks;
+        for (auto &relationship : batch) {
+          ExportBlock &block = blocks[relationship.getTypeId()];
+          block.ids.push_back(relationship.getId());
+          block.starting_ids.push_back(relationship.getStartingNodeId());
+          block.ending_ids.push_back(relationship.getEndingNodeId());
+          block.properties.push_back(relationship.getProperties());
+        }
+        Serializer serializer(chunk);
+        for (auto &[type_id, block] : blocks) {
+          block.kind = ExportBlock::RELATIONSHIPS;
+          block.type = relationship_types.getType(type_id);
+          block.write(serializer);
+        }
+        count += batch.size();
+      }
+      file.write(chunk);
+      chunk.clear();
+      if (batch.size() < EXPORT_BATCH_SIZE) {
+        break;
+      }
+      cursor.id = externalToInternal(batch.back().getId());
+      seastar::thread::maybe_yield();
+    }
+
+    file.close();
+    return count;
+  }
+
+  seastar::future<std::pair<uint64_t, uint64_t>> Shard::ExportPeered(const std::string &directory, ExportFormat format) {
+    std::string extension = format == ExportFormat::CSV ? ".csv" : ".bin";
+    return ReadViewOpenPeered(EXPORT_VIEW_TTL).then([directory, extension, format, this] (uint64_t view_id) {
+      return PeerMapReduce("Export", [directory, extension, format, view_id] (Shard &local_shard) {
+        return seastar::async([directory, extension, format, view_id, &local_shard] {
+          seastar::recursive_touch_directory(directory).get();
+          std::string suffix = "_" + std::to_string(local_shard.shard_id) + extension;
+          uint64_t node_count = local_shard.NodesExport(directory + "/nodes" + suffix, format, view_id);
+          uint64_t relationship_count = local_shard.RelationshipsExport(directory + "/relationships" + suffix, format, view_id);
+          return std::make_pair(node_count, relationship_count);
+        });
+      }, std::make_pair(uint64_t(0), uint64_t(0)), [] (std::pair<uint64_t, uint64_t> total, std::pair<uint64_t, uint64_t> counts) {
+        return std::make_pair(total.first + counts.first, total.second + counts.second);
+      }).finally([view_id, this] {
+        return ReadViewClosePeered(view_id).discard_result();
+      });
     });
   }
 
@@ -6573,6 +11138,10 @@ namespace triton {
     return NodeAddPeered(type, key, properties).get0();
   }
 
+  sol::as_table_t<std::vector<uint64_t>> Shard::NodesAddViaLua(const std::string& nodes) {
+    return sol::as_table(NodesAddFromJsonPeered(nodes).get0());
+  }
+
   uint64_t Shard::NodeGetIdViaLua(const std::string& type, const std::string& key) {
     return NodeGetIDPeered(type, key).get0();
   }
@@ -6593,6 +11162,18 @@ namespace triton {
     return NodeRemovePeered(id).get0();
   }
 
+  uint64_t Shard::NodesRemoveViaLua(const std::vector<uint64_t>& ids) {
+    return NodesRemovePeered(ids).get0();
+  }
+
+  uint64_t Shard::NodesRemoveForTypeViaLua(const std::string& type) {
+    return NodesRemoveForTypePeered(type).get0();
+  }
+
+  uint64_t Shard::NodeMoveViaLua(const std::string& type, const std::string& key, uint8_t node_shard_id) {
+    return NodeMovePeered(type, key, node_shard_id).get0();
+  }
+
   uint16_t Shard::NodeGetTypeIdViaLua(uint64_t id) {
     return NodeGetTypeIdPeered(id).get0();
   }
@@ -6606,116 +11187,35 @@ namespace triton {
   }
 
   // Shard::Node Properties
-  sol::object Shard::NodePropertyGetViaLua(const std::string& type, const std::string& key, const std::string& property) {
-    std::any value = NodePropertyGetPeered(type, key, property).get0();
-    const auto& value_type = value.type();
-
-    if(value_type == typeid(std::string)) {
-      return sol::make_object(state.lua_state(), std::any_cast<std::string>(value));
-    }
-
-    if(value_type == typeid(int64_t)) {
-      return sol::make_object(state.lua_state(), std::any_cast<int64_t>(value));
-    }
-
-    if(value_type == typeid(double)) {
-      return sol::make_object(state.lua_state(), std::any_cast<double>(value));
-    }
-
-    if(value_type == typeid(bool)) {
-      return sol::make_object(state.lua_state(), std::any_cast<bool>(value));
-    }
-
-    // todo: handle array and object types
-    if(value_type == typeid(std::vector<std::string>)) {
-      return sol::make_object(state.lua_state(), sol::as_table(std::any_cast<std::vector<std::string>>(value)));
-    }
-
-    if(value_type == typeid(std::vector<int64_t>)) {
-      return sol::make_object(state.lua_state(), sol::as_table(std::any_cast<std::vector<int64_t>>(value)));
-    }
-
-    if(value_type == typeid(std::vector<double>)) {
-      return sol::make_object(state.lua_state(), sol::as_table(std::any_cast<std::vector<double>>(value)));
-    }
-
-    if(value_type == typeid(std::vector<bool>)) {
-      return sol::make_object(state.lua_state(), sol::as_table(std::any_cast<std::vector<bool>>(value)));
-    }
-
-    if(value_type == typeid(std::map<std::string, std::string>)) {
-      return sol::make_object(state.lua_state(), sol::as_table(std::any_cast<std::map<std::string, std::string>>(value)));
-    }
-
-    if(value_type == typeid(std::map<std::string, int64_t>)) {
-      return sol::make_object(state.lua_state(), sol::as_table(std::any_cast<std::map<std::string, int64_t>>(value)));
-    }
-
-    if(value_type == typeid(std::map<std::string, double>)) {
-      return sol::make_object(state.lua_state(), sol::as_table(std::any_cast<std::map<std::string, double>>(value)));
-    }
-
-    if(value_type == typeid(std::map<std::string, bool>)) {
-      return sol::make_object(state.lua_state(), sol::as_table(std::any_cast<std::map<std::string, bool>>(value)));
-    }
-
-    return sol::make_object(state.lua_state(), sol::lua_nil);
+  sol::object Shard::NodePropertyGetViaLua(const std::string& type, const std::string& key, const std::string& property, sol::this_state ts) {
+    return Property::toLua(NodePropertyGetPeered(type, key, property).get0(), ts);
   }
 
-  sol::object Shard::NodePropertyGetByIdViaLua(uint64_t id, const std::string& property) {
-    std::any value = NodePropertyGetPeered(id, property).get0();
-    const auto& value_type = value.type();
-
-    if(value_type == typeid(std::string)) {
-      return sol::make_object(state.lua_state(), std::any_cast<std::string>(value));
-    }
-
-    if(value_type == typeid(int64_t)) {
-      return sol::make_object(state.lua_state(), std::any_cast<int64_t>(value));
-    }
-
-    if(value_type == typeid(double)) {
-      return sol::make_object(state.lua_state(), std::any_cast<double>(value));
-    }
-
-    if(value_type == typeid(bool)) {
-      return sol::make_object(state.lua_state(), std::any_cast<bool>(value));
-    }
-
-    // todo: handle array and object types
-    if(value_type == typeid(std::vector<std::string>)) {
-      return sol::make_object(state.lua_state(), sol::as_table(std::any_cast<std::vector<std::string>>(value)));
-    }
-
-    if(value_type == typeid(std::vector<int64_t>)) {
-      return sol::make_object(state.lua_state(), sol::as_table(std::any_cast<std::vector<int64_t>>(value)));
-    }
-
-    if(value_type == typeid(std::vector<double>)) {
-      return sol::make_object(state.lua_state(), sol::as_table(std::any_cast<std::vector<double>>(value)));
-    }
-
-    if(value_type == typeid(std::vector<bool>)) {
-      return sol::make_object(state.lua_state(), sol::as_table(std::any_cast<std::vector<bool>>(value)));
-    }
+  sol::object Shard::NodePropertyGetByIdViaLua(uint64_t id, const std::string& property, sol::this_state ts) {
+    return Property::toLua(NodePropertyGetPeered(id, property).get0(), ts);
+  }
 
-    if(value_type == typeid(std::map<std::string, std::string>)) {
-      return sol::make_object(state.lua_state(), sol::as_table(std::any_cast<std::map<std::string, std::string>>(value)));
-    }
+  sol::table Shard::NodesGetPropertyViaLua(const std::vector<uint64_t>& ids, const std::string& property, sol::this_state ts) {
+    std::vector<std::any> values = NodesGetPropertyPeered(ids, property).get0();
 
-    if(value_type == typeid(std::map<std::string, int64_t>)) {
-      return sol::make_object(state.lua_state(), sol::as_table(std::any_cast<std::map<std::string, int64_t>>(value)));
+    // Missing values leave a nil in their place, so the values stay at the position of their id
+    sol::table table = sol::state_view(ts).create_table(static_cast<int>(values.size()), 0);
+    for (size_t i = 0; i < values.size(); i++) {
+      table[i + 1] = Property::toLua(values[i], ts);
     }
+    return table;
+  }
 
-    if(value_type == typeid(std::map<std::string, double>)) {
-      return sol::make_object(state.lua_state(), sol::as_table(std::any_cast<std::map<std::string, double>>(value)));
-    }
+  sol::as_table_t<std::vector<int64_t>> Shard::NodesGetIntegerPropertyViaLua(const std::vector<uint64_t>& ids, const std::string& property, sol::optional<int64_t> missing) {
+    return sol::as_table(NodesGetIntegerPropertyPeered(ids, property, missing.value_or(0)).get0());
+  }
 
-    if(value_type == typeid(std::map<std::string, bool>)) {
-      return sol::make_object(state.lua_state(), sol::as_table(std::any_cast<std::map<std::string, bool>>(value)));
-    }
+  sol::as_table_t<std::vector<double>> Shard::NodesGetDoublePropertyViaLua(const std::vector<uint64_t>& ids, const std::string& property, sol::optional<double> missing) {
+    return sol::as_table(NodesGetDoublePropertyPeered(ids, property, missing.value_or(0)).get0());
+  }
 
-    return sol::make_object(state.lua_state(), sol::lua_nil);
+  sol::as_table_t<std::vector<std::string>> Shard::NodesGetStringPropertyViaLua(const std::vector<uint64_t>& ids, const std::string& property, sol::optional<std::string> missing) {
+    return sol::as_table(NodesGetStringPropertyPeered(ids, property, missing.value_or("")).get0());
   }
 
   bool Shard::NodePropertySetViaLua(const std::string& type, const std::string& key, const std::string& property, const sol::object& value) {
@@ -6792,6 +11292,71 @@ namespace triton {
     return NodePropertiesDeletePeered(id).get0();
   }
 
+  // Node Property Indexes
+  bool Shard::NodePropertyIndexCreateViaLua(const std::string& type, const std::string& property, sol::optional<std::string> index_type) {
+    return NodePropertyIndexCreatePeered(type, property, index_type.value_or("hash") == "sorted" ? PropertyIndex::SORTED : PropertyIndex::HASH).get0();
+  }
+
+  bool Shard::NodePropertyIndexDropViaLua(const std::string& type, const std::string& property) {
+    return NodePropertyIndexDropPeered(type, property).get0();
+  }
+
+  Roaring64Map Shard::NodePropertyIndexFindViaLua(const std::string& type, const std::string& property, const sol::object& value) {
+    return NodePropertyIndexFindPeered(type, property, LuaAny(value)).get0();
+  }
+
+  Roaring64Map Shard::NodePropertyIndexFindRangeViaLua(const std::string& type, const std::string& property, const sol::object& min, const sol::object& max) {
+    return NodePropertyIndexFindRangePeered(type, property, LuaAny(min), LuaAny(max)).get0();
+  }
+
+  // Node Property Aggregates
+  static bool LuaFilters(const sol::optional<sol::table>& filters, std::vector<ScanFilter>& scan_filters) {
+    // Filters are tables like { { "age", ">", 30 }, { "name", "==", "max" } }
+    if (filters) {
+      for (size_t i = 1; i <= filters->size(); i++) {
+        sol::table filter = filters->get<sol::table>(i);
+        ScanOperator scan_operator;
+        if (!ScanFilter::toOperator(filter.get<std::string>(2), scan_operator)) {
+          return false;
+        }
+        scan_filters.emplace_back(filter.get<std::string>(1), scan_operator, Shard::LuaAny(filter.get<sol::object>(3)));
+      }
+    }
+    return true;
+  }
+
+  Aggregate Shard::NodesAggregateViaLua(const std::string& type, const std::string& property, sol::optional<sol::table> filters) {
+    std::vector<ScanFilter> scan_filters;
+    if (!LuaFilters(filters, scan_filters)) {
+      return Aggregate();
+    }
+    return NodesAggregatePeered(type, scan_filters, property).get0();
+  }
+
+  // Node Vectors
+  bool Shard::NodeVectorPropertyCreateViaLua(const std::string& type, const std::string& property, uint32_t dimensions) {
+    return NodeVectorPropertyCreatePeered(type, property, dimensions).get0();
+  }
+
+  sol::as_table_t<std::vector<Neighbor>> Shard::NodesNearestViaLua(const std::string& type, const std::string& property, const std::vector<float>& vector, uint64_t k,
+                                                                   sol::optional<std::string> metric, sol::optional<sol::table> filters) {
+    VectorMetric vector_metric = VectorMetric::COSINE;
+    std::vector<ScanFilter> scan_filters;
+    if ((metric && !toVectorMetric(metric.value(), vector_metric)) || !LuaFilters(filters, scan_filters)) {
+      return sol::as_table(std::vector<Neighbor>());
+    }
+    return sol::as_table(NodesNearestPeered(type, property, vector, k, vector_metric, scan_filters).get0());
+  }
+
+  sol::as_table_t<std::vector<Neighbor>> Shard::NodeIdsMapNearestViaLua(const Roaring64Map& ids, const std::string& property, const std::vector<float>& vector, uint64_t k,
+                                                                        sol::optional<std::string> metric) {
+    VectorMetric vector_metric = VectorMetric::COSINE;
+    if (metric && !toVectorMetric(metric.value(), vector_metric)) {
+      return sol::as_table(std::vector<Neighbor>());
+    }
+    return sol::as_table(NodesNearestPeered(ids, property, vector, k, vector_metric).get0());
+  }
+
   // Shard::Relationships
   uint64_t Shard::RelationshipAddEmptyViaLua(const std::string& rel_type, const std::string& type1, const std::string& key1,
                                              const std::string& type2, const std::string& key2) {
@@ -6819,6 +11384,10 @@ namespace triton {
     return RelationshipAddPeered(rel_type, id1, id2, properties).get0();
   }
 
+  sol::as_table_t<std::vector<uint64_t>> Shard::RelationshipsAddViaLua(const std::string& relationships) {
+    return sol::as_table(RelationshipsAddFromJsonPeered(relationships).get0());
+  }
+
   Relationship Shard::RelationshipGetViaLua(uint64_t id) {
     return RelationshipGetPeered(id).get0();
   }
@@ -6843,61 +11412,38 @@ namespace triton {
     return RelationshipGetEndingNodeIdPeered(id).get0();
   }
 
-  // Shard::Relationship Properties
-  sol::object Shard::RelationshipPropertyGetViaLua(uint64_t id, const std::string& property) {
-    std::any value = RelationshipPropertyGetPeered(id, property).get0();
-    const auto& value_type = value.type();
-
-    if(value_type == typeid(std::string)) {
-      return sol::make_object(state.lua_state(), std::any_cast<std::string>(value));
-    }
-
-    if(value_type == typeid(int64_t)) {
-      return sol::make_object(state.lua_state(), std::any_cast<int64_t>(value));
-    }
-
-    if(value_type == typeid(double)) {
-      return sol::make_object(state.lua_state(), std::any_cast<double>(value));
-    }
-
-    if(value_type == typeid(bool)) {
-      return sol::make_object(state.lua_state(), std::any_cast<bool>(value));
-    }
-
-    // todo: handle array and object types
-    if(value_type == typeid(std::vector<std::string>)) {
-      return sol::make_object(state.lua_state(), sol::as_table(std::any_cast<std::vector<std::string>>(value)));
-    }
-
-    if(value_type == typeid(std::vector<int64_t>)) {
-      return sol::make_object(state.lua_state(), sol::as_table(std::any_cast<std::vector<int64_t>>(value)));
-    }
-
-    if(value_type == typeid(std::vector<double>)) {
-      return sol::make_object(state.lua_state(), sol::as_table(std::any_cast<std::vector<double>>(value)));
-    }
-
-    if(value_type == typeid(std::vector<bool>)) {
-      return sol::make_object(state.lua_state(), sol::as_table(std::any_cast<std::vector<bool>>(value)));
-    }
+  bool Shard::RelationshipExistsViaLua(uint64_t id1, uint64_t id2, const std::string& rel_type, Direction direction) {
+    return RelationshipExistsPeered(id1, id2, rel_type, direction).get0();
+  }
 
-    if(value_type == typeid(std::map<std::string, std::string>)) {
-      return sol::make_object(state.lua_state(), sol::as_table(std::any_cast<std::map<std::string, std::string>>(value)));
+  sol::table Shard::RelationshipsExistViaLua(const std::vector<uint64_t>& ids1, const std::vector<uint64_t>& ids2, const std::string& rel_type, Direction direction, sol::this_state ts) {
+    // Pairs are made of the same position of each table
+    std::vector<std::pair<uint64_t, uint64_t>> pairs;
+    pairs.reserve(std::min(ids1.size(), ids2.size()));
+    for (size_t i = 0; i < ids1.size() && i < ids2.size(); i++) {
+      pairs.emplace_back(ids1.at(i), ids2.at(i));
     }
+    std::vector<bool> exist = RelationshipsExistPeered(pairs, rel_type, direction).get0();
 
-    if(value_type == typeid(std::map<std::string, int64_t>)) {
-      return sol::make_object(state.lua_state(), sol::as_table(std::any_cast<std::map<std::string, int64_t>>(value)));
+    sol::table table = sol::state_view(ts).create_table(static_cast<int>(exist.size()), 0);
+    for (size_t i = 0; i < exist.size(); i++) {
+      table[i + 1] = static_cast<bool>(exist.at(i));
     }
+    return table;
+  }
 
-    if(value_type == typeid(std::map<std::string, double>)) {
-      return sol::make_object(state.lua_state(), sol::as_table(std::any_cast<std::map<std::string, double>>(value)));
-    }
+  uint64_t Shard::RelationshipMergeViaLua(const std::string& rel_type, const std::string& type1, const std::string& key1,
+                                          const std::string& type2, const std::string& key2, const std::string& properties) {
+    return RelationshipMergePeered(rel_type, type1, key1, type2, key2, properties).get0().first;
+  }
 
-    if(value_type == typeid(std::map<std::string, bool>)) {
-      return sol::make_object(state.lua_state(), sol::as_table(std::any_cast<std::map<std::string, bool>>(value)));
-    }
+  uint64_t Shard::RelationshipMergeByIdsViaLua(const std::string& rel_type, uint64_t id1, uint64_t id2, const std::string& properties) {
+    return RelationshipMergePeered(rel_type, id1, id2, properties).get0().first;
+  }
 
-    return sol::make_object(state.lua_state(), sol::lua_nil);
+  // Shard::Relationship Properties
+  sol::object Shard::RelationshipPropertyGetViaLua(uint64_t id, const std::string& property, sol::this_state ts) {
+    return Property::toLua(RelationshipPropertyGetPeered(id, property).get0(), ts);
   }
 
   bool Shard::RelationshipPropertySetViaLua(uint64_t id, const std::string& property, const sol::object& value) {
@@ -6941,6 +11487,25 @@ namespace triton {
     return RelationshipPropertiesDeletePeered(id).get0();
   }
 
+  // Shard::Relationship Recency Indexes
+  bool Shard::RelationshipRecencyIndexCreateViaLua(const std::string& rel_type, const std::string& property, sol::optional<bool> stamp, sol::optional<uint64_t> ttl) {
+    return RelationshipRecencyIndexCreatePeered(rel_type, property, stamp.value_or(false), ttl.value_or(0)).get0();
+  }
+
+  bool Shard::RelationshipRecencyIndexDropViaLua(const std::string& rel_type) {
+    return RelationshipRecencyIndexDropPeered(rel_type).get0();
+  }
+
+  sol::as_table_t<std::vector<Relationship>> Shard::NodeGetRecentRelationshipsViaLua(const std::string& type, const std::string& key, const std::string& rel_type, sol::optional<uint64_t> limit, sol::optional<int64_t> since, sol::optional<int64_t> until) {
+    return sol::as_table(NodeGetRecentRelationshipsPeered(type, key, rel_type, since.value_or(std::numeric_limits<int64_t>::min()),
+                                                          until.value_or(std::numeric_limits<int64_t>::max()), limit.value_or(LIMIT)).get0());
+  }
+
+  sol::as_table_t<std::vector<Relationship>> Shard::NodeGetRecentRelationshipsByIdViaLua(uint64_t id, const std::string& rel_type, sol::optional<uint64_t> limit, sol::optional<int64_t> since, sol::optional<int64_t> until) {
+    return sol::as_table(NodeGetRecentRelationshipsPeered(id, rel_type, since.value_or(std::numeric_limits<int64_t>::min()),
+                                                          until.value_or(std::numeric_limits<int64_t>::max()), limit.value_or(LIMIT)).get0());
+  }
+
   // Shard::Node Degree
   uint64_t Shard::NodeGetDegreeViaLua(const std::string& type, const std::string& key) {
     return NodeGetDegreePeered(type, key).get0();
@@ -7188,6 +11753,65 @@ namespace triton {
     return sol::as_table(NodeGetNeighborsPeered(id, direction, rel_types).get0());
   }
 
+  sol::as_table_t<std::vector<Node>> Shard::TraverseViaLua(const std::vector<uint64_t>& ids, const sol::table& steps, sol::optional<std::string> dedup) {
+    // Steps are tables like { direction = "out", rel_types = { "FRIENDS" }, node_type = "User" }, every field optional
+    std::vector<TraverseStep> traverse_steps;
+    for (size_t i = 1; i <= steps.size(); i++) {
+      sol::table step = steps.get<sol::table>(i);
+      std::vector<std::string> rel_types;
+      sol::optional<sol::table> rel_type_table = step.get<sol::optional<sol::table>>("rel_types");
+      if (rel_type_table) {
+        for (size_t j = 1; j <= rel_type_table->size(); j++) {
+          rel_types.push_back(rel_type_table->get<std::string>(j));
+        }
+      }
+      traverse_steps.push_back(TraverseStepFor(step.get_or<std::string>("direction", "all"), rel_types, step.get_or<std::string>("node_type", "")));
+    }
+    TraverseDedup traverse_dedup = dedup.value_or("global") == "hop" ? TraverseDedup::HOP : TraverseDedup::GLOBAL;
+    return sol::as_table(TraversePeered(ids, traverse_steps, traverse_dedup).get0());
+  }
+
+  sol::as_table_t<std::vector<Ids>> Shard::ShortestPathViaLua(uint64_t id1, uint64_t id2, sol::optional<Direction> direction, sol::optional<std::vector<std::string>> rel_types, sol::optional<uint64_t> max_depth) {
+    return sol::as_table(ShortestPathPeered(id1, id2, direction.value_or(BOTH), rel_types.value_or(std::vector<std::string>()),
+                                            max_depth.value_or(std::numeric_limits<uint64_t>::max())).get0());
+  }
+
+  sol::nested<std::vector<std::vector<uint64_t>>> Shard::RandomWalkViaLua(const std::vector<uint64_t>& ids, uint64_t length, sol::optional<Direction> direction, sol::optional<std::vector<std::string>> rel_types,
+                                                                          sol::optional<double> p, sol::optional<double> q, sol::optional<uint64_t> seed) {
+    return sol::as_nested(RandomWalkPeered(ids, length, direction.value_or(OUT), rel_types.value_or(std::vector<std::string>()),
+                                           p.value_or(1), q.value_or(1), seed.value_or(0)).get0());
+  }
+
+  sol::nested<std::vector<std::map<uint64_t, std::vector<uint64_t>>>> Shard::SampleNeighborsViaLua(const std::vector<uint64_t>& ids, const std::vector<uint64_t>& fanouts, sol::optional<Direction> direction,
+                                                                                                  sol::optional<std::vector<std::string>> rel_types, sol::optional<uint64_t> seed) {
+    return sol::as_nested(SampleNeighborsPeered(ids, fanouts, direction.value_or(OUT), rel_types.value_or(std::vector<std::string>()), seed.value_or(0)).get0());
+  }
+
+  // Id Maps
+  Roaring64Map Shard::NodeGetNeighborIdsMapByIdViaLua(uint64_t id) {
+    return NodeGetNeighborIdsMapPeered(id, BOTH).get0();
+  }
+
+  Roaring64Map Shard::NodeGetNeighborIdsMapByIdForDirectionViaLua(uint64_t id, Direction direction) {
+    return NodeGetNeighborIdsMapPeered(id, direction).get0();
+  }
+
+  Roaring64Map Shard::NodeGetNeighborIdsMapByIdForDirectionForTypesViaLua(uint64_t id, Direction direction, const std::vector<std::string> &rel_types) {
+    return NodeGetNeighborIdsMapPeered(id, direction, rel_types).get0();
+  }
+
+  Roaring64Map Shard::NodeIdsMapFilterViaLua(const Roaring64Map& ids, const std::string& type) {
+    return NodeIdsMapFilterPeered(ids, type).get0();
+  }
+
+  Roaring64Map Shard::AllNodeIdsMapForTypeViaLua(const std::string& type) {
+    return AllNodeIdsMapPeered(type).get0();
+  }
+
+  sol::as_table_t<std::vector<Node>> Shard::NodesGetByIdsMapViaLua(const Roaring64Map& ids) {
+    return sol::as_table(NodesGetPeered(ids).get0());
+  }
+
   // All
   sol::as_table_t<std::vector<uint64_t>> Shard::AllNodeIdsViaLua(uint64_t skip, uint64_t limit) {
     return sol::as_table(AllNodeIdsPeered(skip, limit).get0());
@@ -7221,4 +11845,55 @@ namespace triton {
     return sol::as_table(AllRelationshipsPeered(skip, limit).get0());
   }
 
+  // Local, for map scripts. These only read the shard the script runs on and never wait on another one
+  uint8_t Shard::LocalShardIdViaLua() const {
+    return shard_id;
+  }
+
+  uint64_t Shard::LocalNodeTypesGetCountByTypeViaLua(const std::string& type) {
+    return NodeTypesGetCount(type);
+  }
+
+  Roaring64Map Shard::LocalNodeIdsMapForTypeViaLua(const std::string& type) {
+    return AllNodeIdsMap(type);
+  }
+
+  sol::as_table_t<std::vector<Node>> Shard::LocalNodesGetViaLua(const std::vector<uint64_t>& ids) {
+    return sol::as_table(NodesGet(ids));
+  }
+
+  sol::table Shard::LocalNodesGetPropertyViaLua(const std::vector<uint64_t>& ids, const std::string& property, sol::this_state ts) {
+    std::vector<std::any> values = NodesGetProperty(ids, property);
+
+    sol::table table = sol::state_view(ts).create_table(static_cast<int>(values.size()), 0);
+    for (size_t i = 0; i < values.size(); i++) {
+      table[i + 1] = Property::toLua(values[i], ts);
+    }
+    return table;
+  }
+
+  sol::as_table_t<std::vector<int64_t>> Shard::LocalNodesGetIntegerPropertyViaLua(const std::vector<uint64_t>& ids, const std::string& property, sol::optional<int64_t> missing) {
+    return sol::as_table(NodesGetIntegerProperty(ids, property, missing.value_or(0)));
+  }
+
+  sol::as_table_t<std::vector<double>> Shard::LocalNodesGetDoublePropertyViaLua(const std::vector<uint64_t>& ids, const std::string& property, sol::optional<double> missing) {
+    return sol::as_table(NodesGetDoubleProperty(ids, property, missing.value_or(0)));
+  }
+
+  sol::as_table_t<std::vector<std::string>> Shard::LocalNodesGetStringPropertyViaLua(const std::vector<uint64_t>& ids, const std::string& property, sol::optional<std::string> missing) {
+    return sol::as_table(NodesGetStringProperty(ids, property, missing.value_or("")));
+  }
+
+  sol::as_table_t<std::vector<uint64_t>> Shard::LocalNodesGetDegreeViaLua(const std::vector<uint64_t>& ids, Direction direction, sol::optional<std::vector<std::string>> rel_types) {
+    return sol::as_table(NodesGetDegree(ids, direction, rel_types.value_or(std::vector<std::string>())));
+  }
+
+  Aggregate Shard::LocalNodesAggregateViaLua(const std::string& type, const std::string& property, sol::optional<sol::table> filters) {
+    std::vector<ScanFilter> scan_filters;
+    if (!LuaFilters(filters, scan_filters)) {
+      return Aggregate();
+    }
+    return NodesAggregate(type, scan_filters, property);
+  }
+
 } // namespace triton
\ No newline at end of file
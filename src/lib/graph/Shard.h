@@ -19,13 +19,42 @@
 
 #define SOL_ALL_SAFETIES_ON 1
 
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <random>
+#include <atomic>
+#include <unordered_set>
+#include <utility>
+#include "Algorithm.h"
+#include "CommandLog.h"
+#include "Cursor.h"
 #include "Direction.h"
+#include "Export.h"
 #include "Ids.h"
+#include "Metrics.h"
 #include "Node.h"
+#include "NodeProjection.h"
+#include "PackedGroups.h"
+#include "Placement.h"
+#include "ReadView.h"
+#include "Properties.h"
+#include "PropertyIndex.h"
+#include "PropertyKeys.h"
+#include "RecencyIndex.h"
 #include "Relationship.h"
+#include "RelationshipStore.h"
+#include "ResultCache.h"
+#include "Scan.h"
+#include "Snapshot.h"
+#include "Trace.h"
+#include "Traversal.h"
 #include "Types.h"
 #include "Group.h"
 #include <roaring/roaring64map.hh>
+#include <seastar/core/coroutine.hh>
 #include <seastar/core/file.hh>
 #include <seastar/core/fstream.hh>
 #include <seastar/core/future.hh>
@@ -33,13 +62,18 @@
 #include <seastar/core/sharded.hh>
 #include <seastar/core/smp.hh>
 #include <seastar/core/sstring.hh>
-#include <seastar/core/rwlock.hh>
+#include <seastar/core/scheduling.hh>
+#include <seastar/core/semaphore.hh>
+#include <seastar/core/shared_ptr.hh>
+#include <seastar/core/timer.hh>
 #include <seastar/core/thread.hh>
+#include <seastar/util/defer.hh>
 #include <simdjson.h>
 #include <simdjson/dom/object.h>
 #include <tsl/sparse_map.h>
+#include <lua.hpp>
 #include <sol.hpp>
-#include <utilities/csvmonkey.hpp>
+#include <utilities/CsvStringCursor.h>
 #include <seastar/core/seastar.hh>
 
 using namespace simdjson;
@@ -51,22 +85,100 @@ namespace triton {
     uint8_t cpus;
     uint8_t shard_id;
     dom::parser parser;
-    sol::state state;
+    std::vector<sol::state> lua_states;// Pool of Lua VMs, each with every function registered
+    std::vector<uint8_t> free_lua_states;// The Lua VMs not running a script
+    seastar::semaphore lua_states_available;// Scripts wait here in order when every Lua VM is busy
+    std::vector<std::unordered_map<std::string, sol::protected_function>> lua_scripts;// Compiled scripts of each Lua VM by their prelude and text
     seastar::sstring command_log_file_name;
-
-    seastar::rwlock rel_type_lock;
-    seastar::rwlock node_type_lock;
-    seastar::rwlock lua_lock;
-
-    std::map<std::string, tsl::sparse_map<std::string, uint64_t>> node_keys;// "Index" to get node id by type:key
-    std::vector<triton::Node> nodes;// Store of the properties of Nodes
-    std::vector<triton::Relationship> relationships;// Store of the properties of Relationships
+    seastar::sstring snapshot_file_name;
+    std::string command_log_directory;
+    uint64_t command_log_generation = 0;
+    bool read_only = false;// Replicas only change through the records of their primary
+    uint64_t replica_sequence = 0;// Next record of the primary to apply
+    uint64_t replica_primary_sequence = 0;// Records the primary had logged at the last contact
+    std::chrono::steady_clock::time_point replica_caught_up;// Last time every record of the primary was applied
+    ResultCache result_cache;// Results of the requests that came in on this shard
+    PublishedEpoch* mutation_epochs = nullptr;// The published epoch of every shard of the graph, indexed by shard id
+    uint64_t memory_soft_limit = 0;// Bytes of this core past which writes are turned away, zero for no limit
+    uint64_t memory_hard_limit = 0;// Bytes of this core past which scripts and other large reads are turned away as well, zero for no limit
+    std::vector<uint8_t> memory_levels;// Memory pressure of every shard as each one last announced it
+    uint64_t memory_rejections = 0;// Requests that came in on this core turned away for lack of memory
+    bool memory_estimated = false;// Hold the estimated bytes of this shard to the limits instead of everything allocated on its core
+    seastar::timer<> memory_timer;
+    std::map<uint64_t, ReadView> read_views;// Pinned versions of this shard by view id, the same ids on every shard
+    std::atomic<uint64_t> own_read_view_epochs{0};// For a shard on its own, like in the tests
+    std::atomic<uint64_t>* read_view_epochs = &own_read_view_epochs;// Views handed out on any shard of the graph, which are their ids
+    uint64_t read_view_epoch = 0;// The last of them this shard pinned
+    uint64_t read_view_copies = 0;// Nodes and relationships saved by writers for the open views
+    std::unordered_map<uint64_t, Traversal> traversals;// The part of each running traversal on this shard by traversal id
+    uint64_t traversal_count = 0;// Traversals started on this shard, to give each one its own id
+    std::unordered_map<uint64_t, PathSearch> paths;// The part of each running shortest path search on this shard by path id
+    std::unordered_map<uint64_t, Algorithm> algorithms;// The part of each running algorithm on this shard by algorithm id
+    uint64_t algorithm_count = 0;// Algorithms started on this shard, to give each one its own id
+    uint64_t compaction_position = 1;// Next node the compaction looks at
+    uint64_t compaction_passes = 0;// Times the compaction went over every node
+    uint64_t compaction_groups_dropped = 0;// Empty relationship groups removed by the compaction
+    uint64_t compaction_slots_released = 0;// Trailing deleted node and relationship slots given back by the compaction
+    uint64_t compaction_adjacency = 0;// Relationship entries counted so far in this compaction pass
+    uint64_t adjacency_entries = 0;// Relationship entries of every node as of the last compaction pass
+    uint64_t relationships_expired = 0;// Relationships removed for outliving the ttl of their recency index
+    bool expiring = false;// An expiry pass is still removing relationships, the next slice skips it
+    seastar::timer<> compaction_timer;
+    uint64_t lua_executions = 0;
+    uint64_t lua_preemptions = 0;// Times a running script gave the reactor back to other work
+    uint64_t lua_aborts = 0;// Scripts stopped for going over their instruction or memory budget
+    uint64_t lua_max_instructions = 0;// Instructions a script may run, zero for no limit
+    uint64_t lua_max_memory = 0;// Bytes a script may add to its Lua VM, zero for no limit
+    seastar::scheduling_group lua_group;// Scheduling group scripts run in, the default one unless given shares
+    // What the instruction hook of a Lua VM needs to know about the script running on it
+    struct LuaBudget {
+      Shard *shard = nullptr;
+      uint64_t instructions = 0;// Run so far, counted LUA_HOOK_INSTRUCTIONS at a time
+      uint64_t memory_base = 0;// Bytes the VM held when the script started
+    };
+    std::vector<LuaBudget> lua_budgets;// One per Lua VM, the hook finds its own in the registry of the VM
+    LatencyHistogram lua_wait;// Microseconds scripts waited for a free Lua VM
+    Metrics metrics;
+    seastar::lw_shared_ptr<Trace> tracing;// The traced request running on this shard right now, only ever set for a stretch that does not wait
+    std::unordered_map<seastar::thread_context*, seastar::lw_shared_ptr<Trace>> traced_threads;// Scripts of traced requests by the thread they run in
+    uint64_t trace_count = 0;// Traces started on this shard, to give each one its own id
+    uint64_t trace_sample = 0;// Trace one in this many requests, zero for only the ones that ask
+    uint64_t trace_seen = 0;
+    uint64_t slow_threshold = 0;// Microseconds a request may take before it goes in the slow query log, zero for never
+    uint64_t slow_sample = 1;// Keep one in this many slow requests
+    uint64_t slow_seen = 0;
+    uint64_t slow_queries = 0;// Requests over the threshold, whether or not they were kept
+    std::deque<SlowQuery> slow_log;
+
+    seastar::semaphore type_allocation{1};// Shard 0 hands out new type ids one at a time
+    seastar::semaphore node_moves{1};// Shard 0 moves nodes one at a time, so two connected nodes never move together
+    std::unordered_set<uint64_t> blocked_nodes;// Nodes on their way to another shard, the same on every shard
+    bool moving_relationships = false;// Set while a move puts back the relationships of the nodes it blocked
+
+    // Lets a node key be searched with a string_view without building a std::string
+    struct KeyHash {
+      using is_transparent = void;
+      size_t operator()(std::string_view key) const { return std::hash<std::string_view>()(key); }
+    };
+    using NodeKeys = tsl::sparse_map<std::string, uint64_t, KeyHash, std::equal_to<>>;
+    std::vector<NodeKeys> node_keys;// "Index" to get node id by key, indexed by node type id
+    std::vector<triton::Node> nodes;// Store of the type and key of Nodes
+    std::vector<uint64_t> node_property_rows;// Row of each node in the property store of its type
+    std::shared_ptr<triton::PropertyKeys> property_keys = std::make_shared<triton::PropertyKeys>();// Keys of the property stores of every type
+    std::unordered_map<uint16_t, triton::Properties> node_properties;// Columnar store of the properties of Nodes by type
+    std::unordered_map<uint16_t, std::map<std::string, triton::PropertyIndex>> node_property_indexes;// Secondary indexes of Node properties by type and property
+    triton::RelationshipStore relationships{property_keys};// Types, nodes and properties of Relationships as parallel arrays
+    std::unordered_map<uint16_t, triton::RecencyIndex> relationship_recency_indexes;// Outgoing Relationships of each node in time order by type
     std::vector<std::vector<Group>> outgoing_relationships;// Outgoing relationships of each node
     std::vector<std::vector<Group>> incoming_relationships;// Incoming relationships of each node
+    PackedGroups packed_outgoing_relationships;// Read only copy of the outgoing relationships made by freeze
+    PackedGroups packed_incoming_relationships;// Read only copy of the incoming relationships made by freeze
     Roaring64Map deleted_nodes;// Keep track of deleted nodes in order to reuse them
     Roaring64Map deleted_relationships;// Keep track of deleted relationships in order to reuse them
     triton::Types node_types;// Store string and id of node types
     triton::Types relationship_types;// Store string and id of relationship types
+    triton::Placement placement;// Shard of every node by type and key, the same on every shard
+    CommandLog command_log;// Append only log of the mutations of this shard, empty until started
 
     // Tombstone Property values
     const std::any tombstone_any = std::any();
@@ -78,214 +190,601 @@ namespace triton {
 
     inline static const uint64_t SKIP = 0;
     inline static const uint64_t LIMIT = 100;
+    inline static const uint64_t IMPORT_BATCH_SIZE = 10000;
+    inline static const uint64_t EXPORT_BATCH_SIZE = 10000;
+    inline static const uint64_t EXPORT_VIEW_TTL = 86400;// An export that has not finished in a day lets go of its read view
+    inline static const uint64_t WALK_BATCH = 1024;// Walks run together, so each step sends one batch per shard for this many
+    inline static const size_t LUA_SCRIPTS_SIZE = 1024;
+    inline static const size_t SLOW_LOG_SIZE = 256;// Slow queries kept on each shard, the oldest ones go first
+    inline static const uint64_t READ_VIEW_TTL = 3600;// Seconds a view pinned on the way lives until its open arrives with its own
+    inline static const int LUA_HOOK_INSTRUCTIONS = 1000;
+    inline static const char *const LUA_BUDGET = "triton_budget";// Registry key of the LuaBudget of a Lua VM
 
   public:
-    explicit Shard(uint8_t cpus) : cpus(cpus), shard_id(seastar::this_shard_id()) {
+    explicit Shard(uint8_t cpus, uint8_t lua_vms = 4) : cpus(cpus), shard_id(seastar::this_shard_id()), lua_states_available(std::max(lua_vms, uint8_t(1))), placement(cpus) {
       command_log_file_name = "command_" + std::to_string(shard_id) + ".log";
+      snapshot_file_name = "snapshot_" + std::to_string(shard_id) + ".db";
 
       // Always start with node and relationship Zero and use unsigned integers for ids except 0.
       nodes.emplace_back();
-      Relationship relationship = {0,0,0,0,std::map<std::string, std::any>()};
-      relationships.push_back(relationship);
+      node_property_rows.emplace_back(0);
+      relationships.set(0, 0, 0, 0);
       outgoing_relationships.emplace_back();
       incoming_relationships.emplace_back();
-
-      state.open_libraries(sol::lib::base, sol::lib::package, sol::lib::math, sol::lib::string, sol::lib::table);
-      state.require_file("json", "./src/lua/json.lua");
-
-      // todo: Create a sanitized environment to sandbox the user, and put these user types there.
-
-      state.new_usertype<Node>("Node",
-        // 3 constructors
-                                                               sol::constructors<
-                                                                 Node(),
-                                                                 Node(uint64_t, uint16_t, std::string),
-                                                                 Node(uint64_t, uint16_t, std::string, std::map<std::string, std::any>)>(),
-                                                               "getId", &Node::getId,
-                                                               "getTypeId", &Node::getTypeId,
-                                                               "getKey", &Node::getKey,
-                                                               "getProperties", &Node::getPropertiesLua,
-                                                               "setProperty", &Node::setProperty,
-                                                               "deleteProperty", &Node::deleteProperty,
-                                                               "setProperties", &Node::setProperties,
-                                                               "deleteProperties", &Node::deleteProperties);
-
-
-      state.new_usertype<Relationship>("Relationship",
-        // 3 constructors
-                                                                                       sol::constructors<
-                                                                                         Relationship(),
-                                                                                         Relationship(uint64_t, uint64_t, uint64_t, uint16_t),
-                                                                                         Relationship(uint64_t, uint64_t, uint64_t, uint16_t, std::map<std::string, std::any>)>(),
-                                                                                       "getId", &Relationship::getId,
-                                                                                       "getTypeId", &Relationship::getTypeId,
-                                                                                       "getStartingNodeId", &Relationship::getStartingNodeId,
-                                                                                       "getEndingNodeId", &Relationship::getEndingNodeId,
-                                                                                       "getProperties", &Relationship::getPropertiesLua,
-                                                                                       "setProperty", &Relationship::setProperty,
-                                                                                       "deleteProperty", &Relationship::deleteProperty,
-                                                                                       "setProperties", &Relationship::setProperties,
-                                                                                       "deleteProperties", &Relationship::deleteProperties);
-
-      state.new_usertype<Ids>("Ids",
-                                                            sol::constructors<Ids(uint64_t, uint64_t)>(),
-                                                            "node_id", &Ids::node_id,
-                                                            "rel_id", &Ids::rel_id);
-
-      state.set_function("ShardIdsGet", &Shard::ShardIdsGet, this);
-      // Lua does not like overloading, Sol warns about performance problems if we overload, so overloaded methods have been renamed.
-
-      // Relationship Types
-      state.set_function("RelationshipTypesGetCount", &Shard::RelationshipTypesGetCountViaLua, this);
-      state.set_function("RelationshipTypesGetCountByType", &Shard::RelationshipTypesGetCountByTypeViaLua, this);
-      state.set_function("RelationshipTypesGetCountById", &Shard::RelationshipTypesGetCountByIdViaLua, this);
-      state.set_function("RelationshipTypesGet", &Shard::RelationshipTypesGetViaLua, this);
-
-      // Relationship Type
-      state.set_function("RelationshipTypeGetType", &Shard::RelationshipTypeGetTypeViaLua, this);
-      state.set_function("RelationshipTypeGetTypeId", &Shard::RelationshipTypeGetTypeIdViaLua, this);
-      state.set_function("RelationshipTypeInsert", &Shard::RelationshipTypeInsertViaLua, this);
-
-      // Node Types
-      state.set_function("NodeTypesGetCount", &Shard::NodeTypesGetCountViaLua, this);
-      state.set_function("NodeTypesGetCountByType", &Shard::NodeTypesGetCountByTypeViaLua, this);
-      state.set_function("NodeTypesGetCountById", &Shard::NodeTypesGetCountByIdViaLua, this);
-      state.set_function("NodeTypesGet", &Shard::NodeTypesGetViaLua, this);
-
-      // Node Type
-      state.set_function("NodeTypeGetType", &Shard::NodeTypeGetTypeViaLua, this);
-      state.set_function("NodeTypeGetTypeId", &Shard::NodeTypeGetTypeIdViaLua, this);
-      state.set_function("NodeTypeInsert", &Shard::NodeTypeInsertViaLua, this);
-
-      //Nodes
-      state.set_function("NodeAddEmpty", &Shard::NodeAddEmptyViaLua, this);
-      state.set_function("NodeAdd", &Shard::NodeAddViaLua, this);
-      state.set_function("NodeGetId", &Shard::NodeGetIdViaLua, this);
-      state.set_function("NodeGet", &Shard::NodeGetViaLua, this);
-      state.set_function("NodeGetById", &Shard::NodeGetByIdViaLua, this);
-      state.set_function("NodeRemove", &Shard::NodeRemoveViaLua, this);
-      state.set_function("NodeRemoveById", &Shard::NodeRemoveByIdViaLua, this);
-      state.set_function("NodeGetTypeId", &Shard::NodeGetTypeIdViaLua, this);
-      state.set_function("NodeGetType", &Shard::NodeGetTypeViaLua, this);
-      state.set_function("NodeGetKey", &Shard::NodeGetKeyViaLua, this);
-
-      // Node Properties
-      state.set_function("NodePropertyGet", &Shard::NodePropertyGetViaLua, this);
-      state.set_function("NodePropertyGetById", &Shard::NodePropertyGetByIdViaLua, this);
-      state.set_function("NodePropertySet", &Shard::NodePropertySetViaLua, this);
-      state.set_function("NodePropertySetById", &Shard::NodePropertySetByIdViaLua, this);
-      state.set_function("NodePropertiesSetFromJson", &Shard::NodePropertiesSetFromJsonViaLua, this);
-      state.set_function("NodePropertiesSetFromJsonById", &Shard::NodePropertiesSetFromJsonByIdViaLua, this);
-      state.set_function("NodePropertiesResetFromJson", &Shard::NodePropertiesResetFromJsonViaLua, this);
-      state.set_function("NodePropertiesResetFromJsonById", &Shard::NodePropertiesResetFromJsonByIdViaLua, this);
-      state.set_function("NodePropertyDelete", &Shard::NodePropertyDeleteViaLua, this);
-      state.set_function("NodePropertyDeleteById", &Shard::NodePropertyDeleteByIdViaLua, this);
-      state.set_function("NodePropertiesDelete", &Shard::NodePropertiesDeleteViaLua, this);
-      state.set_function("NodePropertiesDeleteById", &Shard::NodePropertiesDeleteByIdViaLua, this);
-
-      // Relationships
-      state.set_function("RelationshipAddEmpty", &Shard::RelationshipAddEmptyViaLua, this);
-      state.set_function("RelationshipAddEmptyByTypeIdByIds", &Shard::RelationshipAddEmptyByTypeIdByIdsViaLua, this);
-      state.set_function("RelationshipAddEmptyByIds", &Shard::RelationshipAddEmptyByIdsViaLua, this);
-      state.set_function("RelationshipAdd", &Shard::RelationshipAddViaLua, this);
-      state.set_function("RelationshipAddByTypeIdByIds", &Shard::RelationshipAddByTypeIdByIdsViaLua, this);
-      state.set_function("RelationshipAddByIds", &Shard::RelationshipAddByIdsViaLua, this);
-      state.set_function("RelationshipGet", &Shard::RelationshipGetViaLua, this);
-      state.set_function("RelationshipRemove", &Shard::RelationshipRemoveViaLua, this);
-      state.set_function("RelationshipGetType", &Shard::RelationshipGetTypeViaLua, this);
-      state.set_function("RelationshipGetTypeId", &Shard::RelationshipGetTypeIdViaLua, this);
-      state.set_function("RelationshipGetStartingNodeId", &Shard::RelationshipGetStartingNodeIdViaLua, this);
-      state.set_function("RelationshipGetEndingNodeId", &Shard::RelationshipGetEndingNodeIdViaLua, this);
-
-      // Relationship Properties
-      state.set_function("RelationshipPropertyGet", &Shard::RelationshipPropertyGetViaLua, this);
-      state.set_function("RelationshipPropertySet", &Shard::RelationshipPropertySetViaLua, this);
-      state.set_function("RelationshipPropertySetFromJson", &Shard::RelationshipPropertySetFromJsonViaLua, this);
-      state.set_function("RelationshipPropertyDelete", &Shard::RelationshipPropertyDeleteViaLua, this);
-      state.set_function("RelationshipPropertiesSetFromJson", &Shard::RelationshipPropertiesSetFromJsonViaLua, this);
-      state.set_function("RelationshipPropertiesResetFromJson", &Shard::RelationshipPropertiesResetFromJsonViaLua, this);
-      state.set_function("RelationshipPropertiesDelete", &Shard::RelationshipPropertiesDeleteViaLua, this);
-
-      // Node Degree
-      state.set_function("NodeGetDegree", &Shard::NodeGetDegreeViaLua, this);
-      state.set_function("NodeGetDegreeForDirection", &Shard::NodeGetDegreeForDirectionViaLua, this);
-      state.set_function("NodeGetDegreeForDirectionForType", &Shard::NodeGetDegreeForDirectionForTypeViaLua, this);
-      state.set_function("NodeGetDegreeForType", &Shard::NodeGetDegreeForTypeViaLua, this);
-      state.set_function("NodeGetDegreeForDirectionForTypes", &Shard::NodeGetDegreeForDirectionForTypesViaLua, this);
-      state.set_function("NodeGetDegreeForTypes", &Shard::NodeGetDegreeForTypesViaLua, this);
-      state.set_function("NodeGetDegreeById", &Shard::NodeGetDegreeByIdViaLua, this);
-      state.set_function("NodeGetDegreeByIdForDirection", &Shard::NodeGetDegreeByIdForDirectionViaLua, this);
-      state.set_function("NodeGetDegreeByIdForDirectionForType", &Shard::NodeGetDegreeByIdForDirectionForTypeViaLua, this);
-      state.set_function("NodeGetDegreeByIdForType", &Shard::NodeGetDegreeByIdForTypeViaLua, this);
-      state.set_function("NodeGetDegreeByIdForDirectionForTypes", &Shard::NodeGetDegreeByIdForDirectionForTypesViaLua, this);
-      state.set_function("NodeGetDegreeByIdForTypes", &Shard::NodeGetDegreeByIdForTypesViaLua, this);
-
-      // Traversing
-      state.set_function("NodeGetRelationshipsIds", &Shard::NodeGetRelationshipsIdsViaLua, this);
-      state.set_function("NodeGetRelationshipsIdsForDirection", &Shard::NodeGetRelationshipsIdsForDirectionViaLua, this);
-      state.set_function("NodeGetRelationshipsIdsForDirectionForType", &Shard::NodeGetRelationshipsIdsForDirectionForTypeViaLua, this);
-      state.set_function("NodeGetRelationshipsIdsForDirectionForTypeId", &Shard::NodeGetRelationshipsIdsForDirectionForTypeIdViaLua, this);
-      state.set_function("NodeGetRelationshipsIdsForDirectionForTypes", &Shard::NodeGetRelationshipsIdsForDirectionForTypesViaLua, this);
-      state.set_function("NodeGetRelationshipsIdsForType", &Shard::NodeGetRelationshipsIdsForTypeViaLua, this);
-      state.set_function("NodeGetRelationshipsIdsForTypeId", &Shard::NodeGetRelationshipsIdsForTypeIdViaLua, this);
-      state.set_function("NodeGetRelationshipsIdsForTypes", &Shard::NodeGetRelationshipsIdsForTypesViaLua, this);
-      state.set_function("NodeGetRelationshipsIdsById", &Shard::NodeGetRelationshipsIdsByIdViaLua, this);
-      state.set_function("NodeGetRelationshipsIdsByIdForDirection", &Shard::NodeGetRelationshipsIdsByIdForDirectionViaLua, this);
-      state.set_function("NodeGetRelationshipsIdsByIdForDirectionForType", &Shard::NodeGetRelationshipsIdsByIdForDirectionForTypeViaLua, this);
-      state.set_function("NodeGetRelationshipsIdsByIdForDirectionForTypeId", &Shard::NodeGetRelationshipsIdsByIdForDirectionForTypeIdViaLua, this);
-      state.set_function("NodeGetRelationshipsIdsByIdForDirectionForTypes", &Shard::NodeGetRelationshipsIdsByIdForDirectionForTypesViaLua, this);
-      state.set_function("NodeGetRelationshipsIdsByIdForType", &Shard::NodeGetRelationshipsIdsByIdForTypeViaLua, this);
-      state.set_function("NodeGetRelationshipsIdsByIdForTypeId", &Shard::NodeGetRelationshipsIdsByIdForTypeIdViaLua, this);
-      state.set_function("NodeGetRelationshipsIdsByIdForTypes", &Shard::NodeGetRelationshipsIdsByIdForTypesViaLua, this);
-
-      state.set_function("NodeGetRelationships", &Shard::NodeGetRelationshipsViaLua, this);
-      state.set_function("NodeGetRelationshipsForType", &Shard::NodeGetRelationshipsForTypeViaLua, this);
-      state.set_function("NodeGetRelationshipsForTypeId", &Shard::NodeGetRelationshipsForTypeIdViaLua, this);
-      state.set_function("NodeGetRelationshipsForTypes", &Shard::NodeGetRelationshipsForTypesViaLua, this);
-      state.set_function("NodeGetRelationshipsById", &Shard::NodeGetRelationshipsByIdViaLua, this);
-      state.set_function("NodeGetRelationshipsByIdForType", &Shard::NodeGetRelationshipsByIdForTypeViaLua, this);
-      state.set_function("NodeGetRelationshipsByIdForTypeId", &Shard::NodeGetRelationshipsByIdForTypeIdViaLua, this);
-      state.set_function("NodeGetRelationshipsByIdForTypes", &Shard::NodeGetRelationshipsByIdForTypesViaLua, this);
-      state.set_function("NodeGetRelationshipsForDirection", &Shard::NodeGetRelationshipsForDirectionViaLua, this);
-      state.set_function("NodeGetRelationshipsForDirectionForType", &Shard::NodeGetRelationshipsForDirectionForTypeViaLua, this);
-      state.set_function("NodeGetRelationshipsForDirectionForTypeId", &Shard::NodeGetRelationshipsForDirectionForTypeIdViaLua, this);
-      state.set_function("NodeGetRelationshipsForDirectionForTypes", &Shard::NodeGetRelationshipsForDirectionForTypesViaLua, this);
-      state.set_function("NodeGetRelationshipsByIdForDirection", &Shard::NodeGetRelationshipsByIdForDirectionViaLua, this);
-      state.set_function("NodeGetRelationshipsByIdForDirectionForType", &Shard::NodeGetRelationshipsByIdForDirectionForTypeViaLua, this);
-      state.set_function("NodeGetRelationshipsByIdForDirectionForTypeId", &Shard::NodeGetRelationshipsByIdForDirectionForTypeIdViaLua, this);
-      state.set_function("NodeGetRelationshipsByIdForDirectionForTypes", &Shard::NodeGetRelationshipsByIdForDirectionForTypesViaLua, this);
-
-      state.set_function("NodeGetNeighbors", &Shard::NodeGetNeighborsViaLua, this);
-      state.set_function("NodeGetNeighborsForType", &Shard::NodeGetNeighborsForTypeViaLua, this);
-      state.set_function("NodeGetNeighborsForTypeId", &Shard::NodeGetNeighborsForTypeIdViaLua, this);
-      state.set_function("NodeGetNeighborsForTypes", &Shard::NodeGetNeighborsForTypesViaLua, this);
-      state.set_function("NodeGetNeighborsById", &Shard::NodeGetNeighborsByIdViaLua, this);
-      state.set_function("NodeGetNeighborsByIdForType", &Shard::NodeGetNeighborsByIdForTypeViaLua, this);
-      state.set_function("NodeGetNeighborsByIdForTypeId", &Shard::NodeGetNeighborsByIdForTypeIdViaLua, this);
-      state.set_function("NodeGetNeighborsByIdForTypes", &Shard::NodeGetNeighborsByIdForTypesViaLua, this);
-      state.set_function("NodeGetNeighborsForDirection", &Shard::NodeGetNeighborsForDirectionViaLua, this);
-      state.set_function("NodeGetNeighborsForDirectionForType", &Shard::NodeGetNeighborsForDirectionForTypeViaLua, this);
-      state.set_function("NodeGetNeighborsForDirectionForTypeId", &Shard::NodeGetNeighborsForDirectionForTypeIdViaLua, this);
-      state.set_function("NodeGetNeighborsForDirectionForTypes", &Shard::NodeGetNeighborsForDirectionForTypesViaLua, this);
-      state.set_function("NodeGetNeighborsByIdForDirection", &Shard::NodeGetNeighborsByIdForDirectionViaLua, this);
-      state.set_function("NodeGetNeighborsByIdForDirectionForType", &Shard::NodeGetNeighborsByIdForDirectionForTypeViaLua, this);
-      state.set_function("NodeGetNeighborsByIdForDirectionForTypeId", &Shard::NodeGetNeighborsByIdForDirectionForTypeIdViaLua, this);
-      state.set_function("NodeGetNeighborsByIdForDirectionForTypes", &Shard::NodeGetNeighborsByIdForDirectionForTypesViaLua, this);
-
-      state.set_function("AllNodeIds", &Shard::AllNodeIdsViaLua, this);
-      state.set_function("AllNodeIdsForType", &Shard::AllNodeIdsForTypeViaLua, this);
-      state.set_function("AllRelationshipIds", &Shard::AllRelationshipIdsViaLua, this);
-      state.set_function("AllRelationshipIdsForType", &Shard::AllRelationshipIdsForTypeViaLua, this);
-      state.set_function("AllNodes", &Shard::AllNodesViaLua, this);
-      state.set_function("AllNodesForType", &Shard::AllNodesForTypeViaLua, this);
-      state.set_function("AllRelationships", &Shard::AllRelationshipsViaLua, this);
-      state.set_function("AllRelationshipsForType", &Shard::AllRelationshipsForTypeViaLua, this);
+      memory_levels.resize(cpus);
+
+      // A pool of Lua VMs, so a script waiting on another shard does not hold up the scripts behind it
+      lua_states.reserve(std::max(lua_vms, uint8_t(1)));
+      lua_budgets.resize(std::max(lua_vms, uint8_t(1)));
+      for (uint8_t vm = 0; vm < std::max(lua_vms, uint8_t(1)); vm++) {
+        sol::state& state = lua_states.emplace_back();
+        free_lua_states.push_back(vm);
+
+        // Every few instructions the hook lets the reactor run other work and checks the budget of the script,
+        // which it can only do while the script is interpreted
+        lua_budgets[vm].shard = this;
+        lua_pushlightuserdata(state.lua_state(), &lua_budgets[vm]);
+        lua_setfield(state.lua_state(), LUA_REGISTRYINDEX, LUA_BUDGET);
+        lua_sethook(state.lua_state(), &Shard::LuaHook, LUA_MASKCOUNT, LUA_HOOK_INSTRUCTIONS);
+        luaJIT_setmode(state.lua_state(), 0, LUAJIT_MODE_ENGINE | LUAJIT_MODE_OFF);
+
+        state.open_libraries(sol::lib::base, sol::lib::package, sol::lib::math, sol::lib::string, sol::lib::table);
+        state.require_file("json", "./src/lua/json.lua");
+
+        // todo: Create a sanitized environment to sandbox the user, and put these user types there.
+
+        state.new_usertype<Node>("Node",
+          // 3 constructors
+                                                                 sol::constructors<
+                                                                   Node(),
+                                                                   Node(uint64_t, uint16_t, std::string),
+                                                                   Node(uint64_t, uint16_t, std::string, std::map<std::string, std::any>)>(),
+                                                                 "getId", &Node::getId,
+                                                                 "getTypeId", &Node::getTypeId,
+                                                                 "getKey", &Node::getKey,
+                                                                 "getProperties", &Node::getPropertiesLua,
+                                                                 "getProperty", &Node::getPropertyLua,
+                                                                 "setProperty", &Node::setProperty,
+                                                                 "deleteProperty", &Node::deleteProperty,
+                                                                 "setProperties", &Node::setProperties,
+                                                                 "deleteProperties", &Node::deleteProperties);
+
+
+        state.new_usertype<Relationship>("Relationship",
+          // 3 constructors
+                                                                                         sol::constructors<
+                                                                                           Relationship(),
+                                                                                           Relationship(uint64_t, uint64_t, uint64_t, uint16_t),
+                                                                                           Relationship(uint64_t, uint64_t, uint64_t, uint16_t, std::map<std::string, std::any>)>(),
+                                                                                         "getId", &Relationship::getId,
+                                                                                         "getTypeId", &Relationship::getTypeId,
+                                                                                         "getStartingNodeId", &Relationship::getStartingNodeId,
+                                                                                         "getEndingNodeId", &Relationship::getEndingNodeId,
+                                                                                         "getProperties", &Relationship::getPropertiesLua,
+                                                                                         "getProperty", &Relationship::getPropertyLua,
+                                                                                         "setProperty", &Relationship::setProperty,
+                                                                                         "deleteProperty", &Relationship::deleteProperty,
+                                                                                         "setProperties", &Relationship::setProperties,
+                                                                                         "deleteProperties", &Relationship::deleteProperties);
+
+        state.new_usertype<Ids>("Ids",
+                                                              sol::constructors<Ids(uint64_t, uint64_t)>(),
+                                                              "node_id", &Ids::node_id,
+                                                              "rel_id", &Ids::rel_id);
+
+        state.new_enum("Direction", "BOTH", BOTH, "IN", IN, "OUT", OUT);
+
+        state.set_function("ShardIdsGet", &Shard::ShardIdsGet, this);
+        // Lua does not like overloading, Sol warns about performance problems if we overload, so overloaded methods have been renamed.
+
+        // Relationship Types
+        state.set_function("RelationshipTypesGetCount", &Shard::RelationshipTypesGetCountViaLua, this);
+        state.set_function("RelationshipTypesGetCountByType", &Shard::RelationshipTypesGetCountByTypeViaLua, this);
+        state.set_function("RelationshipTypesGetCountById", &Shard::RelationshipTypesGetCountByIdViaLua, this);
+        state.set_function("RelationshipTypesGet", &Shard::RelationshipTypesGetViaLua, this);
+
+        // Relationship Type
+        state.set_function("RelationshipTypeGetType", &Shard::RelationshipTypeGetTypeViaLua, this);
+        state.set_function("RelationshipTypeGetTypeId", &Shard::RelationshipTypeGetTypeIdViaLua, this);
+        state.set_function("RelationshipTypeInsert", &Shard::RelationshipTypeInsertViaLua, this);
+
+        // Node Types
+        state.set_function("NodeTypesGetCount", &Shard::NodeTypesGetCountViaLua, this);
+        state.set_function("NodeTypesGetCountByType", &Shard::NodeTypesGetCountByTypeViaLua, this);
+        state.set_function("NodeTypesGetCountById", &Shard::NodeTypesGetCountByIdViaLua, this);
+        state.set_function("NodeTypesGet", &Shard::NodeTypesGetViaLua, this);
+
+        // Node Type
+        state.set_function("NodeTypeGetType", &Shard::NodeTypeGetTypeViaLua, this);
+        state.set_function("NodeTypeGetTypeId", &Shard::NodeTypeGetTypeIdViaLua, this);
+        state.set_function("NodeTypeInsert", &Shard::NodeTypeInsertViaLua, this);
+
+        //Nodes
+        state.set_function("NodeAddEmpty", &Shard::NodeAddEmptyViaLua, this);
+        state.set_function("NodeAdd", &Shard::NodeAddViaLua, this);
+        state.set_function("NodesAdd", &Shard::NodesAddViaLua, this);
+        state.set_function("NodeGetId", &Shard::NodeGetIdViaLua, this);
+        state.set_function("NodeGet", &Shard::NodeGetViaLua, this);
+        state.set_function("NodeGetById", &Shard::NodeGetByIdViaLua, this);
+        state.set_function("NodeRemove", &Shard::NodeRemoveViaLua, this);
+        state.set_function("NodeRemoveById", &Shard::NodeRemoveByIdViaLua, this);
+        state.set_function("NodesRemove", &Shard::NodesRemoveViaLua, this);
+        state.set_function("NodesRemoveForType", &Shard::NodesRemoveForTypeViaLua, this);
+        state.set_function("NodeMove", &Shard::NodeMoveViaLua, this);
+        state.set_function("NodeGetTypeId", &Shard::NodeGetTypeIdViaLua, this);
+        state.set_function("NodeGetType", &Shard::NodeGetTypeViaLua, this);
+        state.set_function("NodeGetKey", &Shard::NodeGetKeyViaLua, this);
+
+        // Node Properties
+        state.set_function("NodePropertyGet", &Shard::NodePropertyGetViaLua, this);
+        state.set_function("NodePropertyGetById", &Shard::NodePropertyGetByIdViaLua, this);
+        state.set_function("NodesGetProperty", &Shard::NodesGetPropertyViaLua, this);
+        state.set_function("NodesGetIntegerProperty", &Shard::NodesGetIntegerPropertyViaLua, this);
+        state.set_function("NodesGetDoubleProperty", &Shard::NodesGetDoublePropertyViaLua, this);
+        state.set_function("NodesGetStringProperty", &Shard::NodesGetStringPropertyViaLua, this);
+        state.set_function("NodePropertySet", &Shard::NodePropertySetViaLua, this);
+        state.set_function("NodePropertySetById", &Shard::NodePropertySetByIdViaLua, this);
+        state.set_function("NodePropertiesSetFromJson", &Shard::NodePropertiesSetFromJsonViaLua, this);
+        state.set_function("NodePropertiesSetFromJsonById", &Shard::NodePropertiesSetFromJsonByIdViaLua, this);
+        state.set_function("NodePropertiesResetFromJson", &Shard::NodePropertiesResetFromJsonViaLua, this);
+        state.set_function("NodePropertiesResetFromJsonById", &Shard::NodePropertiesResetFromJsonByIdViaLua, this);
+        state.set_function("NodePropertyDelete", &Shard::NodePropertyDeleteViaLua, this);
+        state.set_function("NodePropertyDeleteById", &Shard::NodePropertyDeleteByIdViaLua, this);
+        state.set_function("NodePropertiesDelete", &Shard::NodePropertiesDeleteViaLua, this);
+        state.set_function("NodePropertiesDeleteById", &Shard::NodePropertiesDeleteByIdViaLua, this);
+        state.set_function("NodePropertyIndexCreate", &Shard::NodePropertyIndexCreateViaLua, this);
+        state.set_function("NodePropertyIndexDrop", &Shard::NodePropertyIndexDropViaLua, this);
+        state.set_function("NodePropertyIndexFind", &Shard::NodePropertyIndexFindViaLua, this);
+        state.set_function("NodePropertyIndexFindRange", &Shard::NodePropertyIndexFindRangeViaLua, this);
+
+        // Aggregates
+        state.new_usertype<Aggregate>("Aggregate",
+                                      "count", sol::readonly(&Aggregate::count),
+                                      "sum", sol::readonly(&Aggregate::sum),
+                                      "min", sol::readonly(&Aggregate::min),
+                                      "max", sol::readonly(&Aggregate::max),
+                                      "average", &Aggregate::average);
+        state.set_function("NodesAggregate", &Shard::NodesAggregateViaLua, this);
+
+        // Vectors
+        state.new_usertype<Neighbor>("Neighbor",
+                                     "id", sol::readonly(&Neighbor::id),
+                                     "distance", sol::readonly(&Neighbor::distance));
+        state.set_function("NodeVectorPropertyCreate", &Shard::NodeVectorPropertyCreateViaLua, this);
+        state.set_function("NodesNearest", &Shard::NodesNearestViaLua, this);
+        state.set_function("NodeIdsMapNearest", &Shard::NodeIdsMapNearestViaLua, this);
+
+        // Relationships
+        state.set_function("RelationshipAddEmpty", &Shard::RelationshipAddEmptyViaLua, this);
+        state.set_function("RelationshipAddEmptyByTypeIdByIds", &Shard::RelationshipAddEmptyByTypeIdByIdsViaLua, this);
+        state.set_function("RelationshipAddEmptyByIds", &Shard::RelationshipAddEmptyByIdsViaLua, this);
+        state.set_function("RelationshipAdd", &Shard::RelationshipAddViaLua, this);
+        state.set_function("RelationshipAddByTypeIdByIds", &Shard::RelationshipAddByTypeIdByIdsViaLua, this);
+        state.set_function("RelationshipAddByIds", &Shard::RelationshipAddByIdsViaLua, this);
+        state.set_function("RelationshipsAdd", &Shard::RelationshipsAddViaLua, this);
+        state.set_function("RelationshipGet", &Shard::RelationshipGetViaLua, this);
+        state.set_function("RelationshipRemove", &Shard::RelationshipRemoveViaLua, this);
+        state.set_function("RelationshipGetType", &Shard::RelationshipGetTypeViaLua, this);
+        state.set_function("RelationshipGetTypeId", &Shard::RelationshipGetTypeIdViaLua, this);
+        state.set_function("RelationshipGetStartingNodeId", &Shard::RelationshipGetStartingNodeIdViaLua, this);
+        state.set_function("RelationshipGetEndingNodeId", &Shard::RelationshipGetEndingNodeIdViaLua, this);
+        state.set_function("RelationshipExists", &Shard::RelationshipExistsViaLua, this);
+        state.set_function("RelationshipsExist", &Shard::RelationshipsExistViaLua, this);
+        state.set_function("RelationshipMerge", &Shard::RelationshipMergeViaLua, this);
+        state.set_function("RelationshipMergeByIds", &Shard::RelationshipMergeByIdsViaLua, this);
+
+        // Relationship Properties
+        state.set_function("RelationshipPropertyGet", &Shard::RelationshipPropertyGetViaLua, this);
+        state.set_function("RelationshipPropertySet", &Shard::RelationshipPropertySetViaLua, this);
+        state.set_function("RelationshipPropertySetFromJson", &Shard::RelationshipPropertySetFromJsonViaLua, this);
+        state.set_function("RelationshipPropertyDelete", &Shard::RelationshipPropertyDeleteViaLua, this);
+        state.set_function("RelationshipPropertiesSetFromJson", &Shard::RelationshipPropertiesSetFromJsonViaLua, this);
+        state.set_function("RelationshipPropertiesResetFromJson", &Shard::RelationshipPropertiesResetFromJsonViaLua, this);
+        state.set_function("RelationshipPropertiesDelete", &Shard::RelationshipPropertiesDeleteViaLua, this);
+
+        // Relationship Recency Indexes
+        state.set_function("RelationshipRecencyIndexCreate", &Shard::RelationshipRecencyIndexCreateViaLua, this);
+        state.set_function("RelationshipRecencyIndexDrop", &Shard::RelationshipRecencyIndexDropViaLua, this);
+        state.set_function("NodeGetRecentRelationships", &Shard::NodeGetRecentRelationshipsViaLua, this);
+        state.set_function("NodeGetRecentRelationshipsById", &Shard::NodeGetRecentRelationshipsByIdViaLua, this);
+
+        // Node Degree
+        state.set_function("NodeGetDegree", &Shard::NodeGetDegreeViaLua, this);
+        state.set_function("NodeGetDegreeForDirection", &Shard::NodeGetDegreeForDirectionViaLua, this);
+        state.set_function("NodeGetDegreeForDirectionForType", &Shard::NodeGetDegreeForDirectionForTypeViaLua, this);
+        state.set_function("NodeGetDegreeForType", &Shard::NodeGetDegreeForTypeViaLua, this);
+        state.set_function("NodeGetDegreeForDirectionForTypes", &Shard::NodeGetDegreeForDirectionForTypesViaLua, this);
+        state.set_function("NodeGetDegreeForTypes", &Shard::NodeGetDegreeForTypesViaLua, this);
+        state.set_function("NodeGetDegreeById", &Shard::NodeGetDegreeByIdViaLua, this);
+        state.set_function("NodeGetDegreeByIdForDirection", &Shard::NodeGetDegreeByIdForDirectionViaLua, this);
+        state.set_function("NodeGetDegreeByIdForDirectionForType", &Shard::NodeGetDegreeByIdForDirectionForTypeViaLua, this);
+        state.set_function("NodeGetDegreeByIdForType", &Shard::NodeGetDegreeByIdForTypeViaLua, this);
+        state.set_function("NodeGetDegreeByIdForDirectionForTypes", &Shard::NodeGetDegreeByIdForDirectionForTypesViaLua, this);
+        state.set_function("NodeGetDegreeByIdForTypes", &Shard::NodeGetDegreeByIdForTypesViaLua, this);
+
+        // Traversing
+        state.set_function("NodeGetRelationshipsIds", &Shard::NodeGetRelationshipsIdsViaLua, this);
+        state.set_function("NodeGetRelationshipsIdsForDirection", &Shard::NodeGetRelationshipsIdsForDirectionViaLua, this);
+        state.set_function("NodeGetRelationshipsIdsForDirectionForType", &Shard::NodeGetRelationshipsIdsForDirectionForTypeViaLua, this);
+        state.set_function("NodeGetRelationshipsIdsForDirectionForTypeId", &Shard::NodeGetRelationshipsIdsForDirectionForTypeIdViaLua, this);
+        state.set_function("NodeGetRelationshipsIdsForDirectionForTypes", &Shard::NodeGetRelationshipsIdsForDirectionForTypesViaLua, this);
+        state.set_function("NodeGetRelationshipsIdsForType", &Shard::NodeGetRelationshipsIdsForTypeViaLua, this);
+        state.set_function("NodeGetRelationshipsIdsForTypeId", &Shard::NodeGetRelationshipsIdsForTypeIdViaLua, this);
+        state.set_function("NodeGetRelationshipsIdsForTypes", &Shard::NodeGetRelationshipsIdsForTypesViaLua, this);
+        state.set_function("NodeGetRelationshipsIdsById", &Shard::NodeGetRelationshipsIdsByIdViaLua, this);
+        state.set_function("NodeGetRelationshipsIdsByIdForDirection", &Shard::NodeGetRelationshipsIdsByIdForDirectionViaLua, this);
+        state.set_function("NodeGetRelationshipsIdsByIdForDirectionForType", &Shard::NodeGetRelationshipsIdsByIdForDirectionForTypeViaLua, this);
+        state.set_function("NodeGetRelationshipsIdsByIdForDirectionForTypeId", &Shard::NodeGetRelationshipsIdsByIdForDirectionForTypeIdViaLua, this);
+        state.set_function("NodeGetRelationshipsIdsByIdForDirectionForTypes", &Shard::NodeGetRelationshipsIdsByIdForDirectionForTypesViaLua, this);
+        state.set_function("NodeGetRelationshipsIdsByIdForType", &Shard::NodeGetRelationshipsIdsByIdForTypeViaLua, this);
+        state.set_function("NodeGetRelationshipsIdsByIdForTypeId", &Shard::NodeGetRelationshipsIdsByIdForTypeIdViaLua, this);
+        state.set_function("NodeGetRelationshipsIdsByIdForTypes", &Shard::NodeGetRelationshipsIdsByIdForTypesViaLua, this);
+
+        state.set_function("NodeGetRelationships", &Shard::NodeGetRelationshipsViaLua, this);
+        state.set_function("NodeGetRelationshipsForType", &Shard::NodeGetRelationshipsForTypeViaLua, this);
+        state.set_function("NodeGetRelationshipsForTypeId", &Shard::NodeGetRelationshipsForTypeIdViaLua, this);
+        state.set_function("NodeGetRelationshipsForTypes", &Shard::NodeGetRelationshipsForTypesViaLua, this);
+        state.set_function("NodeGetRelationshipsById", &Shard::NodeGetRelationshipsByIdViaLua, this);
+        state.set_function("NodeGetRelationshipsByIdForType", &Shard::NodeGetRelationshipsByIdForTypeViaLua, this);
+        state.set_function("NodeGetRelationshipsByIdForTypeId", &Shard::NodeGetRelationshipsByIdForTypeIdViaLua, this);
+        state.set_function("NodeGetRelationshipsByIdForTypes", &Shard::NodeGetRelationshipsByIdForTypesViaLua, this);
+        state.set_function("NodeGetRelationshipsForDirection", &Shard::NodeGetRelationshipsForDirectionViaLua, this);
+        state.set_function("NodeGetRelationshipsForDirectionForType", &Shard::NodeGetRelationshipsForDirectionForTypeViaLua, this);
+        state.set_function("NodeGetRelationshipsForDirectionForTypeId", &Shard::NodeGetRelationshipsForDirectionForTypeIdViaLua, this);
+        state.set_function("NodeGetRelationshipsForDirectionForTypes", &Shard::NodeGetRelationshipsForDirectionForTypesViaLua, this);
+        state.set_function("NodeGetRelationshipsByIdForDirection", &Shard::NodeGetRelationshipsByIdForDirectionViaLua, this);
+        state.set_function("NodeGetRelationshipsByIdForDirectionForType", &Shard::NodeGetRelationshipsByIdForDirectionForTypeViaLua, this);
+        state.set_function("NodeGetRelationshipsByIdForDirectionForTypeId", &Shard::NodeGetRelationshipsByIdForDirectionForTypeIdViaLua, this);
+        state.set_function("NodeGetRelationshipsByIdForDirectionForTypes", &Shard::NodeGetRelationshipsByIdForDirectionForTypesViaLua, this);
+
+        state.set_function("NodeGetNeighbors", &Shard::NodeGetNeighborsViaLua, this);
+        state.set_function("NodeGetNeighborsForType", &Shard::NodeGetNeighborsForTypeViaLua, this);
+        state.set_function("NodeGetNeighborsForTypeId", &Shard::NodeGetNeighborsForTypeIdViaLua, this);
+        state.set_function("NodeGetNeighborsForTypes", &Shard::NodeGetNeighborsForTypesViaLua, this);
+        state.set_function("NodeGetNeighborsById", &Shard::NodeGetNeighborsByIdViaLua, this);
+        state.set_function("NodeGetNeighborsByIdForType", &Shard::NodeGetNeighborsByIdForTypeViaLua, this);
+        state.set_function("NodeGetNeighborsByIdForTypeId", &Shard::NodeGetNeighborsByIdForTypeIdViaLua, this);
+        state.set_function("NodeGetNeighborsByIdForTypes", &Shard::NodeGetNeighborsByIdForTypesViaLua, this);
+        state.set_function("NodeGetNeighborsForDirection", &Shard::NodeGetNeighborsForDirectionViaLua, this);
+        state.set_function("NodeGetNeighborsForDirectionForType", &Shard::NodeGetNeighborsForDirectionForTypeViaLua, this);
+        state.set_function("NodeGetNeighborsForDirectionForTypeId", &Shard::NodeGetNeighborsForDirectionForTypeIdViaLua, this);
+        state.set_function("NodeGetNeighborsForDirectionForTypes", &Shard::NodeGetNeighborsForDirectionForTypesViaLua, this);
+        state.set_function("NodeGetNeighborsByIdForDirection", &Shard::NodeGetNeighborsByIdForDirectionViaLua, this);
+        state.set_function("NodeGetNeighborsByIdForDirectionForType", &Shard::NodeGetNeighborsByIdForDirectionForTypeViaLua, this);
+        state.set_function("NodeGetNeighborsByIdForDirectionForTypeId", &Shard::NodeGetNeighborsByIdForDirectionForTypeIdViaLua, this);
+        state.set_function("NodeGetNeighborsByIdForDirectionForTypes", &Shard::NodeGetNeighborsByIdForDirectionForTypesViaLua, this);
+        state.set_function("Traverse", &Shard::TraverseViaLua, this);
+        state.set_function("ShortestPath", &Shard::ShortestPathViaLua, this);
+        state.set_function("RandomWalk", &Shard::RandomWalkViaLua, this);
+        state.set_function("SampleNeighbors", &Shard::SampleNeighborsViaLua, this);
+
+        // Id maps are bitmaps of node ids, the set operations run natively instead of over Lua tables
+        state.new_usertype<Roaring64Map>("IdsMap",
+                                         sol::constructors<Roaring64Map()>(),
+                                         "add", [](Roaring64Map& ids, uint64_t id) { ids.add(id); },
+                                         "remove", [](Roaring64Map& ids, uint64_t id) { ids.remove(id); },
+                                         "contains", [](const Roaring64Map& ids, uint64_t id) { return ids.contains(id); },
+                                         "cardinality", [](const Roaring64Map& ids) { return ids.cardinality(); },
+                                         "union", [](const Roaring64Map& ids, const Roaring64Map& other) { return ids | other; },
+                                         "intersect", [](const Roaring64Map& ids, const Roaring64Map& other) { return ids & other; },
+                                         "difference", [](const Roaring64Map& ids, const Roaring64Map& other) { return ids - other; },
+                                         "getIds", [](const Roaring64Map& ids) {
+                                           std::vector<uint64_t> values;
+                                           values.reserve(ids.cardinality());
+                                           for (uint64_t id : ids) {
+                                             values.push_back(id);
+                                           }
+                                           return sol::as_table(values);
+                                         });
+        state.set_function("NodeGetNeighborIdsMapById", &Shard::NodeGetNeighborIdsMapByIdViaLua, this);
+        state.set_function("NodeGetNeighborIdsMapByIdForDirection", &Shard::NodeGetNeighborIdsMapByIdForDirectionViaLua, this);
+        state.set_function("NodeGetNeighborIdsMapByIdForDirectionForTypes", &Shard::NodeGetNeighborIdsMapByIdForDirectionForTypesViaLua, this);
+        state.set_function("NodeIdsMapFilter", &Shard::NodeIdsMapFilterViaLua, this);
+        state.set_function("AllNodeIdsMapForType", &Shard::AllNodeIdsMapForTypeViaLua, this);
+        state.set_function("NodesGetByIdsMap", &Shard::NodesGetByIdsMapViaLua, this);
+
+        state.set_function("AllNodeIds", &Shard::AllNodeIdsViaLua, this);
+        state.set_function("AllNodeIdsForType", &Shard::AllNodeIdsForTypeViaLua, this);
+        state.set_function("AllRelationshipIds", &Shard::AllRelationshipIdsViaLua, this);
+        state.set_function("AllRelationshipIdsForType", &Shard::AllRelationshipIdsForTypeViaLua, this);
+        state.set_function("AllNodes", &Shard::AllNodesViaLua, this);
+        state.set_function("AllNodesForType", &Shard::AllNodesForTypeViaLua, this);
+        state.set_function("AllRelationships", &Shard::AllRelationshipsViaLua, this);
+        state.set_function("AllRelationshipsForType", &Shard::AllRelationshipsForTypeViaLua, this);
+
+        // Local functions read only the shard the script runs on, for the map of a map reduce script
+        state.set_function("LocalShardId", &Shard::LocalShardIdViaLua, this);
+        state.set_function("LocalNodeTypesGetCountByType", &Shard::LocalNodeTypesGetCountByTypeViaLua, this);
+        state.set_function("LocalNodeIdsMapForType", &Shard::LocalNodeIdsMapForTypeViaLua, this);
+        state.set_function("LocalNodesGet", &Shard::LocalNodesGetViaLua, this);
+        state.set_function("LocalNodesGetProperty", &Shard::LocalNodesGetPropertyViaLua, this);
+        state.set_function("LocalNodesGetIntegerProperty", &Shard::LocalNodesGetIntegerPropertyViaLua, this);
+        state.set_function("LocalNodesGetDoubleProperty", &Shard::LocalNodesGetDoublePropertyViaLua, this);
+        state.set_function("LocalNodesGetStringProperty", &Shard::LocalNodesGetStringPropertyViaLua, this);
+        state.set_function("LocalNodesGetDegree", &Shard::LocalNodesGetDegreeViaLua, this);
+        state.set_function("LocalNodesAggregate", &Shard::LocalNodesAggregateViaLua, this);
+      }
+      lua_scripts.resize(lua_states.size());
     }
 
     static void speak();
     static seastar::future<> stop();
     void clear();
     void reserve(uint64_t reserved_nodes, uint64_t reserved_relationships);
+    // Compressed, the frozen copy takes a few bytes per relationship instead of sixteen and is decoded as it is read
+    void freeze(bool compress = false);
+    void thaw();
+
+    // Metrics
+    void MetricsStart(const std::string& graph);
+    LatencyHistogram& RouteLatency(const std::string& route);
+    OperationMetrics& PeerBroadcast(const std::string& operation);
+
+    // Tracing, a traced request notes every call it makes to a shard, how long the call waited there and how long it ran
+    void TraceLimits(uint64_t slow_microseconds, uint64_t slow_every, uint64_t trace_every);
+    // A new trace when the request asks for one or is sampled, null otherwise
+    seastar::lw_shared_ptr<Trace> TraceStart(bool asked);
+    // Calls made by code in the scope count against its trace, the scope must not span a wait on a future
+    class TraceScope {
+    public:
+      TraceScope(Shard& shard, seastar::lw_shared_ptr<Trace> trace) : shard(shard), previous(std::exchange(shard.tracing, std::move(trace))) {}
+      ~TraceScope() { shard.tracing = std::move(previous); }
+    private:
+      Shard& shard;
+      seastar::lw_shared_ptr<Trace> previous;
+    };
+
+    seastar::lw_shared_ptr<Trace> CurrentTrace() {
+      // A script waits in its own thread, so the thread is what knows which request it belongs to
+      if (!traced_threads.empty() && seastar::thread::running_in_thread()) {
+        auto found = traced_threads.find(seastar::thread_impl::get());
+        if (found != std::end(traced_threads)) {
+          return found->second;
+        }
+      }
+      return tracing;
+    }
+
+    // Keeps the request in the slow query log when it took too long and is sampled, or when it asked for a trace
+    void SlowQueryRecord(const std::string& route, uint64_t script_hash, std::chrono::steady_clock::time_point start, const seastar::lw_shared_ptr<Trace>& trace, bool asked);
+    // Newest first, only the one of the trace when given
+    std::vector<SlowQuery> SlowQueries(uint64_t trace_id = 0);
+    seastar::future<std::vector<SlowQuery>> SlowQueriesPeered(uint64_t trace_id = 0);
+
+    // When a peer call is answered or fails: records its latency and when its trace got the answer, and catches up with
+    // the read views the shards called have seen
+    auto PeerAnswered(OperationMetrics& entry, std::chrono::steady_clock::time_point start, TraceHop* hop) {
+      return seastar::defer([&entry, start, hop, this] () noexcept {
+        entry.latency.record(start);
+        ReadViewCatchUp();
+        if (hop != nullptr) {
+          hop->returned = Trace::now();
+        }
+      });
+    }
+
+    // Calls the function on a shard like invoke_on, counting and timing it by operation, and adding it to the trace.
+    // The operation is only read before the first co_await, so it may be a temporary of the caller
+    template <typename Func>
+    seastar::futurize_t<std::invoke_result_t<Func&, Shard&>> PeerOn(const std::string& operation, unsigned shard, Func func) {
+      OperationMetrics& entry = metrics.operation(operation);
+      entry.calls++;
+      if (shard != shard_id) {
+        entry.remote_calls++;
+      }
+      auto start = std::chrono::steady_clock::now();
+      seastar::lw_shared_ptr<Trace> trace = CurrentTrace();
+      TraceHop* hop = trace ? trace->hop(operation, shard) : nullptr;
+      auto answered = PeerAnswered(entry, start, hop);
+      co_return co_await container().invoke_on(shard, [func = std::move(func), hop] (Shard &local_shard) mutable {
+        local_shard.ReadViewCatchUp();
+        if (hop == nullptr) {
+          return seastar::futurize_invoke(func, local_shard);
+        }
+        // The shard called notes when it picked the call up and when it was done, the trace waits here for the answer
+        hop->started = Trace::now();
+        return seastar::futurize_invoke(func, local_shard).finally([hop] {
+          hop->finished = Trace::now();
+        });
+      });
+    }
+
+    // Calls the function on every shard like invoke_on_all, map and map_reduce0, counted, timed and traced like PeerOn.
+    // These are metrics and tracing wrappers over the local cores: the calls are closures, not messages, so a graph
+    // cannot be spread over more than one server
+    template <typename Func>
+    seastar::future<> PeerOnAll(const std::string& operation, Func func) {
+      OperationMetrics& entry = PeerBroadcast(operation);
+      auto start = std::chrono::steady_clock::now();
+      seastar::lw_shared_ptr<Trace> trace = CurrentTrace();
+      auto answered = PeerAnswered(entry, start, trace ? trace->hop(operation, cpus) : nullptr);
+      co_await container().invoke_on_all([func = std::move(func)] (Shard &local_shard) mutable {
+        local_shard.ReadViewCatchUp();
+        return func(local_shard);
+      });
+    }
+
+    template <typename Func>
+    auto PeerMap(const std::string& operation, Func func) -> decltype(std::declval<seastar::sharded<Shard>&>().map(std::declval<Func>())) {
+      OperationMetrics& entry = PeerBroadcast(operation);
+      auto start = std::chrono::steady_clock::now();
+      seastar::lw_shared_ptr<Trace> trace = CurrentTrace();
+      auto answered = PeerAnswered(entry, start, trace ? trace->hop(operation, cpus) : nullptr);
+      co_return co_await container().map([func = std::move(func)] (Shard &local_shard) mutable {
+        local_shard.ReadViewCatchUp();
+        return func(local_shard);
+      });
+    }
+
+    template <typename Func, typename Initial, typename Reduce>
+    seastar::future<Initial> PeerMapReduce(const std::string& operation, Func func, Initial initial, Reduce reduce) {
+      OperationMetrics& entry = PeerBroadcast(operation);
+      auto start = std::chrono::steady_clock::now();
+      seastar::lw_shared_ptr<Trace> trace = CurrentTrace();
+      auto answered = PeerAnswered(entry, start, trace ? trace->hop(operation, cpus) : nullptr);
+      co_return co_await container().map_reduce0([func = std::move(func)] (Shard &local_shard) {
+        local_shard.ReadViewCatchUp();
+        return func(local_shard);
+      }, std::move(initial), std::move(reduce));
+    }
+
+    // Sends every shard in parts its part of the work at once, calling func(shard, part) there, and gathers the vectors
+    // they return into one in shard order. Each answer lands in the bucket of its shard and is moved once into a result
+    // sized for all of them. With a limit the answers are taken in shard order as they come and the rest are dropped
+    template <typename T, typename Parts, typename Func>
+    seastar::future<std::vector<T>> PeerScatter(const std::string& operation, Parts&& parts, Func&& func, uint64_t limit = std::numeric_limits<uint64_t>::max()) {
+      if (limit < std::numeric_limits<uint64_t>::max()) {
+        auto gathered = seastar::make_lw_shared<std::vector<T>>();
+        return PeerStream<T>(operation, std::forward<Parts>(parts), std::forward<Func>(func), true, [gathered, limit] (uint16_t, std::vector<T>&& results) {
+          size_t taken = std::min(results.size(), static_cast<size_t>(limit - gathered->size()));
+          std::move(results.begin(), results.begin() + taken, std::back_inserter(*gathered));
+          return gathered->size() < limit;
+        }).then([gathered] {
+          return std::move(*gathered);
+        });
+      }
+
+      auto buckets = seastar::make_lw_shared<std::vector<std::vector<T>>>(cpus);
+      return PeerStream<T>(operation, std::forward<Parts>(parts), std::forward<Func>(func), false, [buckets] (uint16_t their_shard, std::vector<T>&& results) {
+        (*buckets)[their_shard] = std::move(results);
+        return true;
+      }).then([buckets] {
+        size_t count = 0;
+        for (const auto& bucket : *buckets) {
+          count += bucket.size();
+        }
+        std::vector<T> combined;
+        combined.reserve(count);
+        for (auto& bucket : *buckets) {
+          std::move(bucket.begin(), bucket.end(), std::back_inserter(combined));
+        }
+        return combined;
+      });
+    }
+
+    // Like PeerScatter, but hands every answer to consume(shard, results) as soon as it arrives, or when ordered, as soon
+    // as every shard before it in parts has answered too. Once consume returns false the answers still to come are dropped,
+    // the work already sent to the other shards cannot be called back
+    template <typename T, typename Parts, typename Func, typename Consume>
+    seastar::future<> PeerStream(const std::string& operation, Parts&& parts, Func&& func, bool ordered, Consume&& consume) {
+      struct Gathering {
+        std::decay_t<Consume> consume;
+        bool consuming = true;
+        std::vector<uint16_t> shards;// In the order of parts
+        std::vector<std::optional<std::vector<T>>> held;// Answers waiting on an earlier shard
+        size_t next = 0;
+      };
+      auto gathering = seastar::make_lw_shared<Gathering>(Gathering{std::forward<Consume>(consume), true, {}, std::vector<std::optional<std::vector<T>>>(parts.size()), 0});
+      size_t position = 0;
+      return seastar::parallel_for_each(parts, [&operation, &position, func = std::forward<Func>(func), ordered, gathering, this] (auto& sharded_part) {
+        uint16_t their_shard = sharded_part.first;
+        size_t their_position = position++;
+        gathering->shards.push_back(their_shard);
+        return PeerOn(operation, their_shard, [part = std::move(sharded_part.second), func] (Shard &local_shard) {
+          return func(local_shard, part);
+        }).then([their_shard, their_position, ordered, gathering] (std::vector<T> results) {
+          if (!ordered) {
+            if (gathering->consuming) {
+              gathering->consuming = gathering->consume(their_shard, std::move(results));
+            }
+            return;
+          }
+          gathering->held[their_position] = std::move(results);
+          for (; gathering->next < gathering->held.size() && gathering->held[gathering->next]; gathering->next++) {
+            if (gathering->consuming) {
+              gathering->consuming = gathering->consume(gathering->shards[gathering->next], std::move(*gathering->held[gathering->next]));
+            }
+            gathering->held[gathering->next].reset();
+          }
+        });
+      });
+    }
+
+    // Compaction
+    uint64_t Compact(uint64_t count, bool release_capacity = false);
+    void CompactionStart(seastar::scheduling_group group, uint64_t interval, uint64_t count, bool release_capacity);
+    void CompactionStop();
+    // Remove up to limit relationships past the ttl of their recency index, the number removed
+    seastar::future<uint64_t> RelationshipsExpirePeered(uint64_t limit);
+
+    // Command Log
+    seastar::future<uint64_t> CommandLogStart(const std::string& directory, uint64_t flush_interval, uint64_t flush_bytes);
+    seastar::future<> CommandLogFlush();
+    seastar::future<> CommandLogStop();
+    bool CommandReplay(Command command, Deserializer& reader);
+
+    // Replication, a replica follows the same shard of its primary by applying the records it logs
+    void ReplicationFollow(uint64_t bytes);
+    bool ReplicationRecords(uint64_t sequence, uint64_t max_bytes, Serializer& serializer);
+    bool ReplicationSnapshot(Serializer& serializer);
+    bool ReplicationApply(Deserializer& reader);
+    bool ReplicationRestore(Deserializer& reader);
+    [[nodiscard]] uint64_t ReplicationSequence() const;
+    std::map<std::string, std::any> ReplicationStatus();
+    seastar::future<std::vector<std::map<std::string, std::any>>> ReplicationStatusPeered();
+    void ReadOnly();
+    [[nodiscard]] bool IsReadOnly() const;
+
+    // Result Cache, results of the graph as of a mutation epoch that changes whenever any shard does
+    void ResultCacheResize(uint64_t max_bytes);
+    [[nodiscard]] bool ResultCacheEnabled() const;
+    bool ResultCacheGet(const std::string& key, uint64_t epoch, std::string& result);
+    void ResultCachePut(const std::string& key, uint64_t epoch, std::string result);
+    [[nodiscard]] uint64_t MutationEpoch() const;
+    // The shards of a graph publish their epochs side by side, a shard on its own only has its own
+    void MutationEpochShare(PublishedEpoch* epochs);
+    // The sum of the epochs of every shard, read here without a call to any of them. A change is published before the
+    // shard answers the call that made it, so a request that follows it sees the new sum
+    [[nodiscard]] uint64_t MutationEpochs() const;
+
+    // Memory, estimated bytes of each part of the shard and limits on the memory of its core that turn requests away before it runs out
+    inline static const uint8_t MEMORY_SOFT = 1;
+    inline static const uint8_t MEMORY_HARD = 2;
+    [[nodiscard]] uint64_t MemoryNodes() const;
+    [[nodiscard]] uint64_t MemoryRelationships() const;
+    [[nodiscard]] uint64_t MemoryProperties() const;
+    [[nodiscard]] uint64_t MemoryAdjacency() const;
+    [[nodiscard]] uint64_t MemoryKeys() const;
+    uint64_t MemoryLua();
+    uint64_t MemoryUsed();
+    std::map<std::string, std::any> MemoryStatus();
+    seastar::future<std::vector<std::map<std::string, std::any>>> MemoryStatusPeered();
+    // Limits on the core, or with estimated on this graph alone when the core is shared with other graphs
+    void MemoryLimits(uint64_t soft_limit, uint64_t hard_limit, uint64_t interval, bool estimated = false);
+    void MemoryStop();
+    [[nodiscard]] uint8_t MemoryLevel(uint64_t allocated) const;
+    void MemoryCheck();
+    void MemoryLevelSet(uint8_t from_shard, uint8_t level);
+    [[nodiscard]] uint8_t MemoryPressure() const;
+    // Counts the request as turned away when any shard is at this level or above
+    bool MemoryRejects(uint8_t level);
+
+    // Read Views, a version of every shard pinned at about the same moment for scans that must not see later writes
+    bool ReadViewOpen(uint64_t view_id, uint64_t ttl_seconds);
+    bool ReadViewClose(uint64_t view_id);
+    bool ReadViewExists(uint64_t view_id);
+    [[nodiscard]] uint64_t ReadViewCount() const;
+    // Views are handed out from one counter shared by the shards of the graph
+    void ReadViewShare(std::atomic<uint64_t>* epochs);
+    // Pins the views handed out since this shard last looked. Calls between shards do it on both ends, before the
+    // call is taken in and before its answer is, so a change a shard made after pinning a view reaches no other
+    // shard that has not pinned it too
+    void ReadViewCatchUp() {
+      uint64_t handed_out = read_view_epochs->load(std::memory_order_acquire);
+      while (read_view_epoch < handed_out) {
+        ReadViewOpen(++read_view_epoch, READ_VIEW_TTL);
+      }
+    }
+    seastar::future<uint64_t> ReadViewOpenPeered(uint64_t ttl_seconds);
+    seastar::future<bool> ReadViewClosePeered(uint64_t view_id);
+    seastar::future<bool> ReadViewExistsPeered(uint64_t view_id);
+
+    // Snapshots
+    seastar::future<bool> SnapshotSave();
+    std::vector<std::string> SnapshotSections();
+    bool SnapshotRestore(const std::vector<std::string>& sections);
+    static void SnapshotGroups(std::string& section, const std::vector<std::vector<Group>>& node_groups);
+    static bool SnapshotRestoreGroups(const std::string& section, std::vector<std::vector<Group>>& node_groups);
 
     seastar::future<uint8_t> getShardId();
     seastar::future<std::vector<uint8_t>> getShardIds();
@@ -295,6 +794,17 @@ namespace triton {
 
     // Lua
     seastar::future<std::string> RunLua(const std::string &script);
+    seastar::future<std::string> RunLua(const std::string &script, const std::map<std::string, std::any> &params);
+    // Coroutines, so they take their arguments by value to keep them while they wait
+    seastar::future<std::string> RunLuaMapReduce(std::string map, std::string reduce, std::map<std::string, std::any> params);
+    seastar::future<std::string> RunLuaScript(std::string prelude, std::string script, std::map<std::string, std::any> params, std::vector<std::string> partials);
+    // Run a script on a free Lua VM right away, RunLuaScript has already waited for one
+    std::string LuaExecute(const std::string &prelude, const std::string &script, const std::map<std::string, std::any> &params, const std::vector<std::string> &partials);
+    static std::any LuaAny(const sol::object &value);
+    // Stop scripts that run more instructions or take more memory than this, zero for no limit, and run them in group.
+    // Without a preemptive hook or either limit the VMs compile scripts with the JIT again
+    void LuaLimits(uint64_t max_instructions, uint64_t max_memory, seastar::scheduling_group group, bool preempt = true);
+    static void LuaHook(lua_State *state, lua_Debug *debug);
 
     // Ids
     uint64_t internalToExternal(uint64_t internal_id) const;
@@ -309,7 +819,7 @@ namespace triton {
     std::set<std::string> RelationshipTypesGet();
 
     // Relationship Type
-    std::string RelationshipTypeGetType(uint16_t type_id);
+    const std::string& RelationshipTypeGetType(uint16_t type_id);
     uint16_t RelationshipTypeGetTypeId(const std::string& type);
     bool RelationshipTypeInsert(const std::string& type, uint16_t type_id);
 
@@ -320,7 +830,7 @@ namespace triton {
     std::set<std::string> NodeTypesGet();
 
     // Node Type
-    std::string NodeTypeGetType(uint16_t type_id);
+    const std::string& NodeTypeGetType(uint16_t type_id);
     uint16_t NodeTypeGetTypeId(const std::string& type);
     bool NodeTypeInsert(const std::string& type, uint16_t type_id);
 
@@ -329,17 +839,126 @@ namespace triton {
     bool NodeRemoveDeleteIncoming(uint64_t id, const std::map<uint16_t, std::vector<uint64_t>>&grouped_relationships);
     std::map<uint16_t, std::map<uint16_t, std::vector<uint64_t>>> NodeRemoveGetOutgoing(uint64_t internal_id);
     bool NodeRemoveDeleteOutgoing(uint64_t id, const std::map<uint16_t, std::vector<uint64_t>>&grouped_relationships);
+    // Bulk removal: a node gives up its relationships from the end a batch at a time, handing back the neighbors that
+    // still point at it, and each neighbor drops the ones to all the nodes of a batch in a single pass
+    std::map<uint16_t, std::map<uint16_t, std::vector<uint64_t>>> NodeRemoveTakeOutgoing(uint64_t id, uint64_t limit);
+    std::map<uint16_t, std::map<uint16_t, std::vector<uint64_t>>> NodeRemoveTakeIncoming(uint64_t id, uint64_t limit);
+    bool NodesRemoveDeleteIncoming(const std::vector<uint64_t>& ids, const std::map<uint16_t, std::vector<uint64_t>>& grouped_relationships);
+    bool NodesRemoveDeleteOutgoing(const std::vector<uint64_t>& ids, const std::map<uint16_t, std::vector<uint64_t>>& grouped_relationships);
+    // Runs on the shard of the nodes, the number removed
+    seastar::future<uint64_t> NodesRemoveLocal(std::vector<uint64_t> ids);
     std::pair <uint16_t ,uint64_t> RelationshipRemoveGetIncoming(uint64_t internal_id);
     bool RelationshipRemoveIncoming(uint16_t rel_type_id, uint64_t external_id, uint64_t node_id);
+    NodeKeys* NodeKeysOf(uint16_t type_id);
+    // Claim a row and a key for a new node, the internal id or 0 when the type is unknown or the key is taken
+    uint64_t NodeInsert(uint16_t node_type, const std::string &key);
+    Properties& NodePropertyStore(uint64_t internal_id);
+    // Keep the secondary indexes of the type of a node in step with its properties, call Unindex before and Index after a change
+    void IndexNode(uint64_t internal_id);
+    void UnindexNode(uint64_t internal_id);
+    void IndexNodeProperty(uint64_t internal_id, const std::string& property);
+    void UnindexNodeProperty(uint64_t internal_id, const std::string& property);
+    void NodePropertyIndexBuild(uint16_t type_id, const std::string& property, PropertyIndex& index);
+    // Keep the recency index of the type of a relationship in step with it, call Unindex before and Index after a change
+    void IndexRelationship(uint64_t internal_id);
+    void UnindexRelationship(uint64_t internal_id);
+    void RelationshipRecencyIndexBuild(uint16_t type_id);
+    // The values with the time in the property of a stamping recency index of the type, false when they need no stamp
+    bool RelationshipStamp(uint16_t rel_type, const std::map<std::string, std::any>& values, std::map<std::string, std::any>& stamped) const;
+    Node NodeCopy(uint64_t internal_id);
+    // KEY leaves the properties in their columns and copies only the id, type and both ends
+    Relationship RelationshipCopy(uint64_t internal_id, NodeProjection projection = NodeProjection::FULL) const;
+    // Save the entity into every open read view that still sees its old version, call before changing it
+    void NodePreserve(uint64_t internal_id);
+    void RelationshipPreserve(uint64_t internal_id);
+    ReadView* ReadViewOf(uint64_t view_id);
+    void NodeGroupsChanged(uint64_t internal_id);
+    uint64_t NodeCountIds(uint64_t internal_id, Direction direction);
+    uint64_t NodeCountIds(uint64_t internal_id, Direction direction, uint16_t type_id);
+
+    // One value of each node, read by get(store, row, value) from the property store of its type
+    template <typename T, typename Getter>
+    std::vector<T> NodesGetTypedProperty(const std::vector<uint64_t>& ids, const T& missing, Getter&& get) {
+      std::vector<T> values;
+      values.reserve(ids.size());
+      for (uint64_t id : ids) {
+        T value = missing;
+        if (ValidNodeId(id)) {
+          uint64_t internal_id = externalToInternal(id);
+          get(NodePropertyStore(internal_id), node_property_rows.at(internal_id), value);
+        }
+        values.push_back(std::move(value));
+      }
+      return values;
+    }
+
+    // Visit the relationships of a node, reading the frozen copy unless the node changed after the freeze
+    template <typename Visitor>
+    void NodeVisitIds(uint64_t internal_id, Direction direction, Visitor&& visit) {
+      if (direction != IN) {
+        VisitIds(outgoing_relationships, packed_outgoing_relationships, internal_id, visit);
+      }
+      if (direction != OUT) {
+        VisitIds(incoming_relationships, packed_incoming_relationships, internal_id, visit);
+      }
+    }
+
+    template <typename Visitor>
+    void NodeVisitIds(uint64_t internal_id, Direction direction, uint16_t type_id, Visitor&& visit) {
+      if (direction != IN) {
+        VisitIds(outgoing_relationships, packed_outgoing_relationships, internal_id, type_id, visit);
+      }
+      if (direction != OUT) {
+        VisitIds(incoming_relationships, packed_incoming_relationships, internal_id, type_id, visit);
+      }
+    }
+
+    template <typename Visitor>
+    static void VisitIds(const std::vector<std::vector<Group>>& groups, const PackedGroups& packed, uint64_t internal_id, Visitor& visit) {
+      if (packed.isPacked(internal_id)) {
+        packed.visit(internal_id, visit);
+        return;
+      }
+      for (const auto& group : groups.at(internal_id)) {
+        for (const auto& ids : group.ids) {
+          visit(ids);
+        }
+      }
+    }
+
+    template <typename Visitor>
+    static void VisitIds(const std::vector<std::vector<Group>>& groups, const PackedGroups& packed, uint64_t internal_id, uint16_t type_id, Visitor& visit) {
+      if (packed.isPacked(internal_id)) {
+        packed.visit(internal_id, type_id, visit);
+        return;
+      }
+      auto group = findGroup(groups.at(internal_id), type_id);
+      if (group != std::end(groups.at(internal_id))) {
+        for (const auto& ids : group->ids) {
+          visit(ids);
+        }
+      }
+    }
 
     // Nodes
     uint64_t NodeAddEmpty(const std::string& type, uint16_t type_id, const std::string& key);
     uint64_t NodeAdd(const std::string& type, uint16_t type_id, const std::string& key, const std::string& properties);
-    uint64_t NodeGetID(const std::string& type, const std::string& key);
+    uint64_t NodeAdd(const std::string& type, uint16_t type_id, const std::string& key, const std::map<std::string, std::any>& properties);
+    std::vector<uint64_t> NodesAdd(const std::vector<std::tuple<std::string, std::string, std::map<std::string, std::any>>>& rows);
+    uint64_t NodeGetID(std::string_view type, std::string_view key);
+    uint64_t NodeGetID(uint16_t type_id, std::string_view key);
+    std::vector<uint64_t> NodeGetIDs(const std::vector<std::pair<std::string, std::string>>& keys);
     Node NodeGet(uint64_t id);
     Node NodeGet(const std::string& type, const std::string& key);
     bool NodeRemove(uint64_t id);
     bool NodeRemove(const std::string& type, const std::string& key);
+    bool NodePlace(const std::string& type, const std::string& key, uint8_t node_shard_id);
+    // Writes to a node are refused while it moves, so none are lost between copying it and removing it
+    void NodeWritesBlock(uint64_t id);
+    void NodeWritesUnblock(uint64_t id);
+    [[nodiscard]] bool NodeWritesBlocked(uint64_t id) const;
+    // The move that blocked the nodes puts their relationships back itself
+    std::vector<uint64_t> RelationshipsMoveToOutgoing(const std::vector<std::tuple<uint16_t, uint64_t, uint64_t, std::map<std::string, std::any>>>& rows);
     uint16_t NodeGetTypeId(uint64_t id);
     std::string NodeGetType(uint64_t id);
     std::string NodeGetKey(uint64_t id);
@@ -393,6 +1012,22 @@ namespace triton {
     bool NodePropertiesResetFromJson(uint64_t id, const std::string& value);
     bool NodePropertiesDelete(uint64_t id);
 
+    // Node Property Indexes
+    bool NodePropertyIndexCreate(const std::string& type, const std::string& property, PropertyIndex::IndexType index_type);
+    bool NodePropertyIndexDrop(const std::string& type, const std::string& property);
+    std::map<std::string, PropertyIndex::IndexType> NodePropertyIndexesGet(const std::string& type);
+    Roaring64Map NodePropertyIndexFind(const std::string& type, const std::string& property, const std::any& value);
+    Roaring64Map NodePropertyIndexFindRange(const std::string& type, const std::string& property, const std::any& min, const std::any& max);
+
+    // Node Property Aggregates
+    Aggregate NodesAggregate(const std::string& type, const std::vector<ScanFilter>& filters, const std::string& property);
+
+    // Node Vectors, the k nodes of this shard whose vector of the property is closest to the query
+    bool NodeVectorPropertyCreate(const std::string& type, const std::string& property, uint32_t dimensions);
+    std::vector<Neighbor> NodesNearest(const std::string& type, const std::string& property, const std::vector<float>& query, uint64_t k,
+                                       VectorMetric metric, const std::vector<ScanFilter>& filters);
+    std::vector<Neighbor> NodesNearest(const Roaring64Map& ids, const std::string& property, const std::vector<float>& query, uint64_t k, VectorMetric metric);
+
     // Relationships
     uint64_t RelationshipAddEmptySameShard(uint16_t rel_type, uint64_t id1, uint64_t id2);
     uint64_t RelationshipAddEmptySameShard(uint16_t rel_type, const std::string& type1, const std::string& key1,
@@ -401,15 +1036,22 @@ namespace triton {
     uint64_t RelationshipAddToIncoming(uint16_t rel_type, uint64_t rel_id, uint64_t id1, uint64_t id2);
 
     uint64_t RelationshipAddSameShard(uint16_t rel_type, uint64_t id1, uint64_t id2, const std::string& properties);
+    uint64_t RelationshipAddSameShard(uint16_t rel_type, uint64_t id1, uint64_t id2, const std::map<std::string, std::any>& values);
     uint64_t RelationshipAddSameShard(uint16_t rel_type, const std::string& type1, const std::string& key1,
                                            const std::string& type2, const std::string& key2, const std::string& properties);
     uint64_t RelationshipAddToOutgoing(uint16_t rel_type, uint64_t id1, uint64_t id2, const std::string& properties);
+    uint64_t RelationshipAddToOutgoing(uint16_t rel_type, uint64_t id1, uint64_t id2, const std::map<std::string, std::any>& properties);
+    std::vector<uint64_t> RelationshipsAddToOutgoing(const std::vector<std::tuple<uint16_t, uint64_t, uint64_t, std::map<std::string, std::any>>>& rows);
+    bool RelationshipsAddToIncoming(const std::vector<std::tuple<uint16_t, uint64_t, uint64_t, uint64_t>>& rows);
 
     Relationship RelationshipGet(uint64_t rel_id);
     std::string RelationshipGetType(uint64_t id);
     uint16_t RelationshipGetTypeId(uint64_t id);
     uint64_t RelationshipGetStartingNodeId(uint64_t id);
     uint64_t RelationshipGetEndingNodeId(uint64_t id);
+    uint64_t RelationshipGetID(uint64_t id1, uint64_t id2, uint16_t rel_type_id, Direction direction);
+    std::vector<bool> RelationshipsExist(const std::vector<std::pair<uint64_t, uint64_t>>& pairs, uint16_t rel_type_id, Direction direction);
+    std::pair<uint64_t, bool> RelationshipMergeToOutgoing(uint16_t rel_type_id, uint64_t id1, uint64_t id2, const std::string& properties);
 
     // Relationship Properties
     std::any RelationshipPropertyGet(uint64_t id, const std::string& property);
@@ -436,6 +1078,15 @@ namespace triton {
     bool RelationshipPropertiesResetFromJson(uint64_t id, const std::string &value);
     bool RelationshipPropertiesDelete(uint64_t id);
 
+    // Relationship Recency Indexes
+    bool RelationshipRecencyIndexCreate(const std::string& rel_type, const std::string& property, bool stamp, uint64_t ttl);
+    bool RelationshipRecencyIndexDrop(const std::string& rel_type);
+    // The outgoing relationships of the type of a node with a property from since to until, newest first
+    std::vector<Relationship> NodeGetRecentRelationships(const std::string& type, const std::string& key, const std::string& rel_type, int64_t since, int64_t until, uint64_t limit, NodeProjection projection = NodeProjection::FULL);
+    std::vector<Relationship> NodeGetRecentRelationships(uint64_t id, const std::string& rel_type, int64_t since, int64_t until, uint64_t limit, NodeProjection projection = NodeProjection::FULL);
+    // Relationships of this shard past the ttl of their recency index, oldest first
+    std::vector<uint64_t> RelationshipsExpired(uint64_t limit);
+
     // Node Degree
     uint64_t NodeGetDegree(const std::string& type, const std::string& key);
     uint64_t NodeGetDegree(const std::string& type, const std::string& key, Direction direction);
@@ -479,6 +1130,16 @@ namespace triton {
     std::map<uint16_t, std::vector<uint64_t>> NodeGetShardedNodeIDs(uint64_t id, uint16_t type_id);
     std::map<uint16_t, std::vector<uint64_t>> NodeGetShardedNodeIDs(uint64_t id, const std::vector<std::string> &rel_types);
 
+    // The neighbor or relationship ids in the shard order of the unpaged calls, every type when rel_types is empty,
+    // keeping only limit of them after skipping offset, so a page never leaves the node shard with the whole list
+    std::map<uint16_t, std::vector<uint64_t>> NodeGetShardedNodeIDs(uint64_t id, Direction direction, const std::vector<std::string> &rel_types, uint64_t offset, uint64_t limit);
+    std::map<uint16_t, std::vector<uint64_t>> NodeGetShardedRelationshipIDs(uint64_t id, Direction direction, const std::vector<std::string> &rel_types, uint64_t offset, uint64_t limit);
+
+    // Neighbor ids with one bitmap per shard, so they can be combined without copying nodes around
+    std::map<uint16_t, Roaring64Map> NodeGetShardedNodeIdsMap(uint64_t id, Direction direction);
+    std::map<uint16_t, Roaring64Map> NodeGetShardedNodeIdsMap(uint64_t id, Direction direction, const std::vector<std::string> &rel_types);
+    Roaring64Map NodeIdsMapFilter(const Roaring64Map& ids, const std::string& type);
+
     std::vector<Relationship> NodeGetOutgoingRelationships(const std::string& type, const std::string& key);
     std::vector<Relationship> NodeGetOutgoingRelationships(const std::string& type, const std::string& key, const std::string& rel_type);
     std::vector<Relationship> NodeGetOutgoingRelationships(const std::string& type, const std::string& key, uint16_t type_id);
@@ -520,7 +1181,49 @@ namespace triton {
     std::map<uint16_t, std::vector<uint64_t>> NodeGetShardedOutgoingNodeIDs(uint64_t id, const std::vector<std::string> &rel_types);
 
     std::vector<Node> NodesGet(const std::vector<uint64_t>&);
+    std::vector<Node> NodesGet(const std::vector<uint64_t>&, NodeProjection projection);
+    std::vector<Node> NodesGet(const std::vector<std::pair<std::string, std::string>>& type_keys, NodeProjection projection);
     std::vector<Relationship> RelationshipsGet(const std::vector<uint64_t>&);
+    std::vector<Relationship> RelationshipsGet(const std::vector<uint64_t>&, NodeProjection projection);
+    // Only the nodes of the node type (any type when 0) and the relationships whose properties pass every filter, at most limit of them
+    std::vector<Node> NodesGet(const std::vector<uint64_t>& ids, uint16_t node_type_id, const std::vector<ScanFilter>& filters, uint64_t limit, NodeProjection projection);
+    std::vector<Relationship> RelationshipsGet(const std::vector<uint64_t>& ids, const std::vector<ScanFilter>& filters, uint64_t limit, NodeProjection projection = NodeProjection::FULL);
+    std::vector<uint64_t> NodesGetDegree(const std::vector<uint64_t>& ids, Direction direction, const std::vector<std::string>& rel_types);
+    std::vector<std::any> NodesGetProperty(const std::vector<uint64_t>& ids, const std::string& property);
+    // One typed value per node read straight from its column, missing where a node has no value of that type, doubles also take integers
+    std::vector<int64_t> NodesGetIntegerProperty(const std::vector<uint64_t>& ids, const std::string& property, int64_t missing);
+    std::vector<double> NodesGetDoubleProperty(const std::vector<uint64_t>& ids, const std::string& property, double missing);
+    std::vector<std::string> NodesGetStringProperty(const std::vector<uint64_t>& ids, const std::string& property, const std::string& missing);
+
+    // Traversals
+    void TraverseReceive(uint64_t traversal_id, size_t hop, uint16_t node_type_id, TraverseDedup dedup, const std::vector<uint64_t>& ids);
+    seastar::future<uint64_t> TraverseExpand(uint64_t traversal_id, size_t hop, const TraverseStep& step, TraverseDedup dedup);
+    std::vector<Node> TraverseCollect(uint64_t traversal_id, size_t hop);
+    TraverseStep TraverseStepFor(std::string_view direction, const std::vector<std::string>& rel_types, const std::string& node_type);
+
+    // Sampling, only ids leave the shard and every random pick depends on the seed and what it is for alone
+    void NodeNeighborIds(uint64_t internal_id, Direction direction, const std::vector<uint16_t>& rel_type_ids, std::vector<uint64_t>& neighbors);
+    std::vector<Walker> RandomWalkStep(std::vector<Walker> walkers, uint64_t step, Direction direction, const std::vector<uint16_t>& rel_type_ids, double p, double q, uint64_t seed);
+    std::vector<std::pair<uint64_t, std::vector<uint64_t>>> SampleNeighbors(const std::vector<uint64_t>& ids, uint64_t fanout, uint64_t hop, Direction direction,
+                                                                           const std::vector<uint16_t>& rel_type_ids, uint64_t seed);
+
+    // Algorithms
+    uint64_t AlgorithmStart(uint64_t algorithm_id, AlgorithmKind kind, const std::vector<uint64_t>& sources);
+    seastar::future<> AlgorithmSend(uint64_t algorithm_id, Direction direction, const std::vector<uint16_t>& rel_type_ids);
+    void AlgorithmReceive(uint64_t algorithm_id, const std::vector<std::pair<uint64_t, double>>& messages);
+    uint64_t AlgorithmUpdate(uint64_t algorithm_id, double damping);
+    std::vector<std::pair<uint64_t, double>> AlgorithmFinish(uint64_t algorithm_id, const std::string& property);
+    uint64_t TriangleStart(uint64_t algorithm_id, AlgorithmKind kind, const std::vector<uint16_t>& rel_type_ids);
+    std::vector<std::pair<uint64_t, std::vector<uint64_t>>> TriangleNeighbors(uint64_t algorithm_id, const std::vector<uint64_t>& ids);
+    seastar::future<> TriangleCount(uint64_t algorithm_id);
+
+    // Shortest Paths, side 0 grows from the start and side 1 from the end
+    bool PathStart(uint64_t path_id, uint8_t side, uint64_t id);
+    seastar::future<> PathExpand(uint64_t path_id, uint8_t side, Direction direction, const std::vector<uint16_t>& rel_type_ids);
+    void PathReceive(uint64_t path_id, uint8_t side, const std::vector<std::tuple<uint64_t, uint64_t, uint64_t>>& reached);
+    std::tuple<uint64_t, uint64_t, uint64_t> PathAdvance(uint64_t path_id, uint8_t side);
+    PathStep PathGetStep(uint64_t path_id, uint8_t side, uint64_t id);
+    void PathFinish(uint64_t path_id);
 
     // All
 
@@ -543,6 +1246,7 @@ namespace triton {
     std::vector<Node> AllNodes(uint64_t skip = SKIP, uint64_t limit = LIMIT);
     std::vector<Node> AllNodes(const std::string& type, uint64_t skip = SKIP, uint64_t limit = LIMIT);
     std::vector<Node> AllNodes(uint16_t type_id, uint64_t skip = SKIP, uint64_t limit = LIMIT);
+    std::vector<Node> AllNodes(const Cursor& cursor, uint64_t limit = LIMIT);
 
     Roaring64Map AllRelationshipIdsMap();
     Roaring64Map AllRelationshipIdsMap(const std::string& rel_type);
@@ -554,7 +1258,8 @@ namespace triton {
 
     std::vector<Relationship> AllRelationships(uint64_t skip = SKIP, uint64_t limit = LIMIT);
     std::vector<Relationship> AllRelationships(const std::string& type, uint64_t skip = SKIP, uint64_t limit = LIMIT);
-    std::vector<Relationship> AllRelationships(uint16_t type_id, uint64_t skip = SKIP, uint64_t limit = LIMIT);
+    std::vector<Relationship> AllRelationships(uint16_t type_id, uint64_t skip = SKIP, uint64_t limit = LIMIT, NodeProjection projection = NodeProjection::FULL);
+    std::vector<Relationship> AllRelationships(const Cursor& cursor, uint64_t limit = LIMIT, NodeProjection projection = NodeProjection::FULL);
 
     // Validations
     bool ValidNodeId(uint64_t id);
@@ -562,6 +1267,29 @@ namespace triton {
 
     // Property Helper
     void convertProperties(std::map<std::string, std::any> &values, const dom::object &object) const;
+    // The scan filters of the "filters" array of a query, false when one of them is not a valid filter
+    bool convertFilters(const dom::object &object, std::vector<ScanFilter> &filters) const;
+    // The value of one JSON field, empty for nulls and for arrays of arrays, objects or nulls
+    std::any convertProperty(const dom::element &value) const;
+    void setPropertiesFromJson(Properties &store, uint64_t row, const dom::object &object) const;
+    // A new key takes one of the 65535 property key ids, a write that needs one once they are gone is refused before it changes anything
+    bool PropertyKeysFit(const std::string &key);
+    bool PropertyKeysFit(const std::map<std::string, std::any> &values);
+    bool PropertyKeysFit(const dom::object &object);
+    // The property store of a node type, made with the keys of the shard the first time
+    Properties& NodeTypePropertyStore(uint16_t type_id);
+
+    // Csv Helpers
+    static std::vector<std::pair<std::string, Properties::ColumnType>> CsvHeader(csvmonkey::CsvCursor &row);
+    static size_t CsvColumn(std::vector<std::pair<std::string, Properties::ColumnType>> &header, const std::string &name);
+    static std::map<std::string, std::any> CsvProperties(const std::vector<std::pair<std::string, Properties::ColumnType>> &header, csvmonkey::CsvCursor &row);
+    // These must run in a seastar thread
+    uint64_t NodesImportCsv(csvmonkey::StreamCursor &cursor);
+    uint64_t RelationshipsImportCsv(csvmonkey::StreamCursor &cursor);
+
+    // Export, these must run in a seastar thread and read through the view so every batch sees the same version of the shard
+    uint64_t NodesExport(const std::string& file_name, ExportFormat format, uint64_t view_id);
+    uint64_t RelationshipsExport(const std::string& file_name, ExportFormat format, uint64_t view_id);
 
 
 
@@ -576,7 +1304,7 @@ namespace triton {
     std::set<std::string> RelationshipTypesGetPeered();
 
     // Relationship Type
-    std::string RelationshipTypeGetTypePeered(uint16_t type_id);
+    const std::string& RelationshipTypeGetTypePeered(uint16_t type_id);
     uint16_t RelationshipTypeGetTypeIdPeered(const std::string& type);
     seastar::future<uint16_t> RelationshipTypeInsertPeered(const std::string& type);
 
@@ -587,19 +1315,29 @@ namespace triton {
     std::set<std::string> NodeTypesGetPeered();
 
     // Node Type
-    std::string NodeTypeGetTypePeered(uint16_t type_id);
+    const std::string& NodeTypeGetTypePeered(uint16_t type_id);
     uint16_t NodeTypeGetTypeIdPeered(const std::string& type);
     seastar::future<uint16_t> NodeTypeInsertPeered(const std::string& type);
 
     // Nodes
     seastar::future<uint64_t> NodeAddEmptyPeered(const std::string& type, const std::string& key);
     seastar::future<uint64_t> NodeAddPeered(const std::string& type, const std::string& key, const std::string& properties);
+    seastar::future<std::vector<uint64_t>> NodesAddPeered(std::vector<std::tuple<std::string, std::string, std::map<std::string, std::any>>> rows);
+    seastar::future<std::vector<uint64_t>> NodesAddFromJsonPeered(const std::string& json);
     seastar::future<uint64_t> NodeGetIDPeered(const std::string& type, const std::string& key);
+    seastar::future<std::vector<uint64_t>> NodeGetIDsPeered(std::vector<std::pair<std::string, std::string>> keys);
 
     seastar::future<Node> NodeGetPeered(const std::string& type, const std::string& key);
     seastar::future<Node> NodeGetPeered(uint64_t id);
     seastar::future<bool> NodeRemovePeered(const std::string& type, const std::string& key);
     seastar::future<bool> NodeRemovePeered(uint64_t id);
+    // Many nodes at once, each shard works through its own in bounded batches, the number removed
+    seastar::future<uint64_t> NodesRemovePeered(const std::vector<uint64_t>& ids);
+    seastar::future<uint64_t> NodesRemoveFromJsonPeered(const std::string& json);
+    seastar::future<uint64_t> NodesRemoveForTypePeered(const std::string& type);
+    seastar::future<uint64_t> NodeMovePeered(const std::string& type, const std::string& key, uint8_t node_shard_id);
+    // The move itself, on Shard 0 while it holds node_moves
+    seastar::future<uint64_t> NodeMoveLocked(const std::string& type, const std::string& key, uint8_t node_shard_id);
     seastar::future<uint16_t> NodeGetTypeIdPeered(uint64_t id);
     seastar::future<std::string> NodeGetTypePeered(uint64_t id);
     seastar::future<std::string> NodeGetKeyPeered(uint64_t id);
@@ -651,6 +1389,24 @@ namespace triton {
     seastar::future<bool> NodePropertiesResetFromJsonPeered(uint64_t id, const std::string& value);
     seastar::future<bool> NodePropertiesDeletePeered(uint64_t id);
 
+    // Node Property Indexes
+    seastar::future<bool> NodePropertyIndexCreatePeered(const std::string& type, const std::string& property, PropertyIndex::IndexType index_type);
+    seastar::future<bool> NodePropertyIndexDropPeered(const std::string& type, const std::string& property);
+    seastar::future<Roaring64Map> NodePropertyIndexFindPeered(const std::string& type, const std::string& property, const std::any& value);
+    seastar::future<Roaring64Map> NodePropertyIndexFindRangePeered(const std::string& type, const std::string& property, const std::any& min, const std::any& max);
+
+    // Node Property Aggregates, every shard scans its own columns and only the partial aggregates come back
+    seastar::future<Aggregate> NodesAggregatePeered(const std::string& type, const std::vector<ScanFilter>& filters, const std::string& property);
+    seastar::future<Aggregate> NodesAggregatePeered(const std::string& query);
+
+    // Node Vectors, every shard searches its own vectors and only its k closest come back to be merged
+    seastar::future<bool> NodeVectorPropertyCreatePeered(const std::string& type, const std::string& property, uint32_t dimensions);
+    seastar::future<std::vector<Neighbor>> NodesNearestPeered(const std::string& type, const std::string& property, const std::vector<float>& query, uint64_t k,
+                                                              VectorMetric metric, const std::vector<ScanFilter>& filters);
+    seastar::future<std::vector<Neighbor>> NodesNearestPeered(const Roaring64Map& ids, const std::string& property, const std::vector<float>& query, uint64_t k,
+                                                              VectorMetric metric);
+    seastar::future<std::vector<Neighbor>> NodesNearestPeered(const std::string& query);
+
     // Relationships
     seastar::future<uint64_t> RelationshipAddEmptyPeered(const std::string& rel_type, const std::string& type1, const std::string& key1,
                                                          const std::string& type2, const std::string& key2);
@@ -660,12 +1416,21 @@ namespace triton {
                                                     const std::string& type2, const std::string& key2, const std::string& properties);
     seastar::future<uint64_t> RelationshipAddPeered(uint16_t rel_type_id, uint64_t id1, uint64_t id2, const std::string& properties);
     seastar::future<uint64_t> RelationshipAddPeered(const std::string& rel_type, uint64_t id1, uint64_t id2, const std::string& properties);
+    seastar::future<std::vector<uint64_t>> RelationshipsAddPeered(std::vector<std::tuple<std::string, std::string, std::string, std::string, std::string, std::map<std::string, std::any>>> rows);
+    seastar::future<std::vector<uint64_t>> RelationshipsAddFromJsonPeered(const std::string& json);
     seastar::future<Relationship> RelationshipGetPeered(uint64_t id);
     seastar::future<bool> RelationshipRemovePeered(uint64_t id);
     seastar::future<std::string> RelationshipGetTypePeered(uint64_t id);
     seastar::future<uint16_t> RelationshipGetTypeIdPeered(uint64_t id);
     seastar::future<uint64_t> RelationshipGetStartingNodeIdPeered(uint64_t id);
     seastar::future<uint64_t> RelationshipGetEndingNodeIdPeered(uint64_t id);
+    seastar::future<uint64_t> RelationshipGetIDPeered(uint64_t id1, uint64_t id2, const std::string& rel_type, Direction direction);
+    seastar::future<bool> RelationshipExistsPeered(uint64_t id1, uint64_t id2, const std::string& rel_type, Direction direction);
+    seastar::future<std::vector<bool>> RelationshipsExistPeered(const std::vector<std::pair<uint64_t, uint64_t>>& pairs, const std::string& rel_type, Direction direction);
+    seastar::future<std::pair<uint64_t, bool>> RelationshipMergePeered(const std::string& rel_type, const std::string& type1, const std::string& key1,
+                                                                      const std::string& type2, const std::string& key2, const std::string& properties);
+    seastar::future<std::pair<uint64_t, bool>> RelationshipMergePeered(uint16_t rel_type_id, uint64_t id1, uint64_t id2, const std::string& properties);
+    seastar::future<std::pair<uint64_t, bool>> RelationshipMergePeered(const std::string& rel_type, uint64_t id1, uint64_t id2, const std::string& properties);
 
     // Relationship Properties
     seastar::future<std::any> RelationshipPropertyGetPeered(uint64_t id, const std::string& property);
@@ -691,6 +1456,12 @@ namespace triton {
     seastar::future<bool> RelationshipPropertiesResetFromJsonPeered(uint64_t id, const std::string &value);
     seastar::future<bool> RelationshipPropertiesDeletePeered(uint64_t id);
 
+    // Relationship Recency Indexes
+    seastar::future<bool> RelationshipRecencyIndexCreatePeered(const std::string& rel_type, const std::string& property, bool stamp, uint64_t ttl);
+    seastar::future<bool> RelationshipRecencyIndexDropPeered(const std::string& rel_type);
+    seastar::future<std::vector<Relationship>> NodeGetRecentRelationshipsPeered(const std::string& type, const std::string& key, const std::string& rel_type, int64_t since, int64_t until, uint64_t limit, NodeProjection projection = NodeProjection::FULL);
+    seastar::future<std::vector<Relationship>> NodeGetRecentRelationshipsPeered(uint64_t id, const std::string& rel_type, int64_t since, int64_t until, uint64_t limit, NodeProjection projection = NodeProjection::FULL);
+
     // Node Degree
     seastar::future<uint64_t> NodeGetDegreePeered(const std::string& type, const std::string& key);
     seastar::future<uint64_t> NodeGetDegreePeered(const std::string& type, const std::string& key, Direction direction);
@@ -748,25 +1519,94 @@ namespace triton {
     seastar::future<std::vector<Relationship>> NodeGetRelationshipsPeered(uint64_t id, Direction direction, uint16_t type_id);
     seastar::future<std::vector<Relationship>> NodeGetRelationshipsPeered(uint64_t id, Direction direction, const std::vector<std::string> &rel_types);
 
-    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(const std::string& type, const std::string& key);
-    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(const std::string& type, const std::string& key, const std::string& rel_type);
-    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(const std::string& type, const std::string& key, uint16_t type_id);
-    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(const std::string& type, const std::string& key, const std::vector<std::string> &rel_types);
-
-    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(uint64_t id);
-    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(uint64_t id, const std::string& rel_type);
-    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(uint64_t id, uint16_t type_id);
-    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(uint64_t id, const std::vector<std::string> &rel_types);
-
-    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(const std::string& type, const std::string& key, Direction direction);
-    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(const std::string& type, const std::string& key, Direction direction, const std::string& rel_type);
-    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(const std::string& type, const std::string& key, Direction direction, uint16_t type_id);
-    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(const std::string& type, const std::string& key, Direction direction, const std::vector<std::string> &rel_types);
-
-    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(uint64_t id, Direction direction);
-    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(uint64_t id, Direction direction, const std::string& rel_type);
-    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(uint64_t id, Direction direction, uint16_t type_id);
-    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(uint64_t id, Direction direction, const std::vector<std::string> &rel_types);
+    // A page of the relationships, filters are checked on the shards holding them and only the page comes back
+    seastar::future<std::vector<Relationship>> NodeGetRelationshipsPeered(const std::string& type, const std::string& key, Direction direction, const std::vector<std::string> &rel_types, const std::vector<ScanFilter>& filters, uint64_t offset, uint64_t limit, NodeProjection projection = NodeProjection::FULL);
+    seastar::future<std::vector<Relationship>> NodeGetRelationshipsPeered(uint64_t id, Direction direction, const std::vector<std::string> &rel_types, const std::vector<ScanFilter>& filters, uint64_t offset, uint64_t limit, NodeProjection projection = NodeProjection::FULL);
+    seastar::future<std::vector<Relationship>> RelationshipsGetPagePeered(std::map<uint16_t, std::vector<uint64_t>> sharded_relationships_ids, const std::vector<ScanFilter>& filters, uint64_t offset, uint64_t limit, NodeProjection projection = NodeProjection::FULL);
+
+    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(const std::string& type, const std::string& key, NodeProjection projection = NodeProjection::FULL);
+    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(const std::string& type, const std::string& key, const std::string& rel_type, NodeProjection projection = NodeProjection::FULL);
+    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(const std::string& type, const std::string& key, uint16_t type_id, NodeProjection projection = NodeProjection::FULL);
+    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(const std::string& type, const std::string& key, const std::vector<std::string> &rel_types, NodeProjection projection = NodeProjection::FULL);
+
+    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(uint64_t id, NodeProjection projection = NodeProjection::FULL);
+    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(uint64_t id, const std::string& rel_type, NodeProjection projection = NodeProjection::FULL);
+    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(uint64_t id, uint16_t type_id, NodeProjection projection = NodeProjection::FULL);
+    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(uint64_t id, const std::vector<std::string> &rel_types, NodeProjection projection = NodeProjection::FULL);
+
+    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(const std::string& type, const std::string& key, Direction direction, NodeProjection projection = NodeProjection::FULL);
+    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(const std::string& type, const std::string& key, Direction direction, const std::string& rel_type, NodeProjection projection = NodeProjection::FULL);
+    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(const std::string& type, const std::string& key, Direction direction, uint16_t type_id, NodeProjection projection = NodeProjection::FULL);
+    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(const std::string& type, const std::string& key, Direction direction, const std::vector<std::string> &rel_types, NodeProjection projection = NodeProjection::FULL);
+
+    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(uint64_t id, Direction direction, NodeProjection projection = NodeProjection::FULL);
+    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(uint64_t id, Direction direction, const std::string& rel_type, NodeProjection projection = NodeProjection::FULL);
+    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(uint64_t id, Direction direction, uint16_t type_id, NodeProjection projection = NodeProjection::FULL);
+    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(uint64_t id, Direction direction, const std::vector<std::string> &rel_types, NodeProjection projection = NodeProjection::FULL);
+
+    // A page of the neighbors, of one node type when node_type is not empty, checked on the shards holding them
+    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(const std::string& type, const std::string& key, Direction direction, const std::vector<std::string> &rel_types, const std::string& node_type, const std::vector<ScanFilter>& filters, uint64_t offset, uint64_t limit, NodeProjection projection = NodeProjection::FULL);
+    seastar::future<std::vector<Node>> NodeGetNeighborsPeered(uint64_t id, Direction direction, const std::vector<std::string> &rel_types, const std::string& node_type, const std::vector<ScanFilter>& filters, uint64_t offset, uint64_t limit, NodeProjection projection = NodeProjection::FULL);
+    seastar::future<std::vector<Node>> NodesGetPagePeered(std::map<uint16_t, std::vector<uint64_t>> sharded_nodes_ids, uint16_t node_type_id, const std::vector<ScanFilter>& filters, uint64_t offset, uint64_t limit, NodeProjection projection);
+
+    // Frontiers go from shard to shard one hop at a time, only the nodes of the last hop come back here
+    seastar::future<std::vector<Node>> TraversePeered(const std::vector<uint64_t>& ids, const std::vector<TraverseStep>& steps, TraverseDedup dedup = TraverseDedup::GLOBAL);
+    seastar::future<std::vector<Node>> TraversePeered(const std::string& query);
+
+    // Algorithms run in supersteps on every shard at once, each shard sending one batch of messages to every other shard per superstep.
+    // The {id, value} of every node comes back, or with a property the values are written to the nodes instead.
+    seastar::future<std::vector<std::pair<uint64_t, double>>> AlgorithmPeered(AlgorithmKind kind, const std::vector<uint64_t>& sources, Direction direction,
+                                                                              const std::vector<std::string>& rel_types, uint64_t iterations, double damping, const std::string& property);
+    seastar::future<std::vector<std::pair<uint64_t, double>>> PageRankPeered(uint64_t iterations = 20, double damping = 0.85, const std::vector<std::string>& rel_types = {}, const std::string& property = "");
+    seastar::future<std::vector<std::pair<uint64_t, double>>> BreadthFirstSearchPeered(uint64_t id, Direction direction = BOTH, const std::vector<std::string>& rel_types = {},
+                                                                                       uint64_t max_depth = std::numeric_limits<uint64_t>::max(), const std::string& property = "");
+    seastar::future<std::vector<std::pair<uint64_t, double>>> ConnectedComponentsPeered(const std::vector<std::string>& rel_types = {}, const std::string& property = "");
+    // Triangles ignore directions, each shard gets the neighbors it needs from every other shard once. TRIANGLES comes back with
+    // the number of triangles of every node, CLUSTERING with its local clustering coefficient
+    seastar::future<std::vector<std::pair<uint64_t, double>>> TrianglesPeered(AlgorithmKind kind, const std::vector<std::string>& rel_types = {}, const std::string& property = "");
+    seastar::future<std::vector<std::pair<uint64_t, double>>> AlgorithmPeered(const std::string& name, const std::string& query);
+
+    // Random walks of up to length steps, one per id in the same order and empty for ids that are not nodes. Every step moves
+    // each walk to the shard of its node in one batch per shard. With p or q other than 1 the walks are biased like node2vec:
+    // going back weighs 1/p, staying next to the previous node 1 and going farther 1/q. A seed of 0 picks one, the same seed
+    // gives the same walks as long as the graph does not change.
+    seastar::future<std::vector<std::vector<uint64_t>>> RandomWalkPeered(const std::vector<uint64_t>& ids, uint64_t length, Direction direction = OUT,
+                                                                         const std::vector<std::string>& rel_types = {}, double p = 1, double q = 1, uint64_t seed = 0);
+    // { "ids": [...], "length": 10, "direction": "out", "rel_types": [...], "p": 1, "q": 1, "seed": 0 }, consume gets the walks of WALK_BATCH ids at a time
+    seastar::future<> RandomWalkPeered(const std::string& query, std::function<seastar::future<>(std::vector<std::vector<uint64_t>>)> consume);
+    // GraphSAGE style neighborhoods: up to fanouts[hop] neighbors of every node reached by the hop before, by node for every hop
+    seastar::future<std::vector<std::map<uint64_t, std::vector<uint64_t>>>> SampleNeighborsPeered(const std::vector<uint64_t>& ids, const std::vector<uint64_t>& fanouts, Direction direction = OUT,
+                                                                                                  const std::vector<std::string>& rel_types = {}, uint64_t seed = 0);
+    // { "ids": [...], "fanouts": [25, 10], "direction": "out", "rel_types": [...], "seed": 0 }
+    seastar::future<std::vector<std::map<uint64_t, std::vector<uint64_t>>>> SampleNeighborsPeered(const std::string& query);
+
+    // Shortest Paths expand the smaller side of a bidirectional search one hop at a time on every shard and stop once the sides meet.
+    // The path is each node with the relationship it was reached over, zero for the first node, and empty when there is none.
+    seastar::future<std::vector<Ids>> ShortestPathPeered(uint64_t id1, uint64_t id2, Direction direction = BOTH, const std::vector<std::string>& rel_types = {},
+                                                         uint64_t max_depth = std::numeric_limits<uint64_t>::max());
+    seastar::future<std::vector<Ids>> ShortestPathPeered(const std::string& type1, const std::string& key1, const std::string& type2, const std::string& key2, Direction direction = BOTH,
+                                                         const std::vector<std::string>& rel_types = {}, uint64_t max_depth = std::numeric_limits<uint64_t>::max());
+
+    // Id Maps
+    seastar::future<Roaring64Map> NodeGetNeighborIdsMapPeered(uint64_t id, Direction direction);
+    seastar::future<Roaring64Map> NodeGetNeighborIdsMapPeered(uint64_t id, Direction direction, const std::vector<std::string> &rel_types);
+    seastar::future<Roaring64Map> NodeIdsMapFilterPeered(const Roaring64Map& ids, const std::string& type);
+    seastar::future<Roaring64Map> AllNodeIdsMapPeered(const std::string& type);
+    seastar::future<std::vector<Node>> NodesGetPeered(const Roaring64Map& ids, NodeProjection projection = NodeProjection::FULL);
+
+    // Multi Get, results come back in request order and missing entries have an id of zero
+    seastar::future<std::vector<Node>> NodesGetPeered(const std::vector<uint64_t>& ids, NodeProjection projection = NodeProjection::FULL);
+    seastar::future<std::vector<Node>> NodesGetPeered(const std::vector<std::pair<std::string, std::string>>& type_keys, NodeProjection projection = NodeProjection::FULL);
+    seastar::future<std::vector<Node>> NodesGetPeered(const std::string& query, NodeProjection projection = NodeProjection::FULL);
+    seastar::future<std::vector<Relationship>> RelationshipsGetPeered(const std::vector<uint64_t>& ids);
+    seastar::future<std::vector<Relationship>> RelationshipsGetPeered(const std::string& query);
+    seastar::future<std::vector<uint64_t>> NodesGetDegreePeered(const std::vector<uint64_t>& ids, Direction direction, const std::vector<std::string>& rel_types);
+    seastar::future<std::vector<uint64_t>> NodesGetDegreePeered(const std::string& query);
+    seastar::future<std::vector<std::any>> NodesGetPropertyPeered(const std::vector<uint64_t>& ids, const std::string& property);
+    seastar::future<std::vector<std::any>> NodesGetPropertyPeered(const std::string& query, const std::string& property);
+    seastar::future<std::vector<int64_t>> NodesGetIntegerPropertyPeered(const std::vector<uint64_t>& ids, const std::string& property, int64_t missing);
+    seastar::future<std::vector<double>> NodesGetDoublePropertyPeered(const std::vector<uint64_t>& ids, const std::string& property, double missing);
+    seastar::future<std::vector<std::string>> NodesGetStringPropertyPeered(const std::vector<uint64_t>& ids, const std::string& property, const std::string& missing);
 
     // All
     seastar::future<std::vector<uint64_t>> AllNodeIdsPeered(uint64_t skip = 0, uint64_t limit = 100);
@@ -776,8 +1616,22 @@ namespace triton {
 
     seastar::future<std::vector<Node>> AllNodesPeered(uint64_t skip = 0, uint64_t limit = 100);
     seastar::future<std::vector<Node>> AllNodesPeered(const std::string& type, uint64_t skip = 0, uint64_t limit = 100);
-    seastar::future<std::vector<Relationship>> AllRelationshipsPeered(uint64_t skip = 0, uint64_t limit = 100);
-    seastar::future<std::vector<Relationship>> AllRelationshipsPeered(const std::string& rel_type, uint64_t skip = 0, uint64_t limit = 100);
+    seastar::future<std::vector<Relationship>> AllRelationshipsPeered(uint64_t skip = 0, uint64_t limit = 100, NodeProjection projection = NodeProjection::FULL);
+    seastar::future<std::vector<Relationship>> AllRelationshipsPeered(const std::string& rel_type, uint64_t skip = 0, uint64_t limit = 100, NodeProjection projection = NodeProjection::FULL);
+    // Resume from where the last page stopped instead of counting up to skip again
+    seastar::future<std::pair<std::vector<Node>, Cursor>> AllNodesPeered(Cursor cursor, uint64_t limit = 100);
+    seastar::future<std::pair<std::vector<Relationship>, Cursor>> AllRelationshipsPeered(Cursor cursor, uint64_t limit = 100, NodeProjection projection = NodeProjection::FULL);
+
+    // Bulk Import
+    seastar::future<uint64_t> NodesImportCsvPeered(std::string csv);
+    seastar::future<uint64_t> NodesImportCsvFilePeered(const std::string& filename);
+    seastar::future<uint64_t> RelationshipsImportCsvPeered(std::string csv);
+    seastar::future<uint64_t> RelationshipsImportCsvFilePeered(const std::string& filename);
+
+    // Export
+    // Every shard writes nodes_{shard} and relationships_{shard} files to the directory at the same time, all from one read view.
+    // CSV files load back with the bulk import, binary files are columnar blocks by type. Returns the nodes and relationships written
+    seastar::future<std::pair<uint64_t, uint64_t>> ExportPeered(const std::string& directory, ExportFormat format);
 
 
     // *****************************************************************************************************************************
@@ -809,18 +1663,26 @@ namespace triton {
     //Nodes
     uint64_t NodeAddEmptyViaLua(const std::string& type, const std::string& key);
     uint64_t NodeAddViaLua(const std::string& type, const std::string& key, const std::string& properties);
+    sol::as_table_t<std::vector<uint64_t>> NodesAddViaLua(const std::string& nodes);
     uint64_t NodeGetIdViaLua(const std::string& type, const std::string& key);
     Node NodeGetViaLua(const std::string& type, const std::string& key);
     Node NodeGetByIdViaLua(uint64_t id);
     bool NodeRemoveViaLua(const std::string& type, const std::string& key);
     bool NodeRemoveByIdViaLua(uint64_t id);
+    uint64_t NodesRemoveViaLua(const std::vector<uint64_t>& ids);
+    uint64_t NodesRemoveForTypeViaLua(const std::string& type);
+    uint64_t NodeMoveViaLua(const std::string& type, const std::string& key, uint8_t node_shard_id);
     uint16_t NodeGetTypeIdViaLua(uint64_t id);
     std::string NodeGetTypeViaLua(uint64_t id);
     std::string NodeGetKeyViaLua(uint64_t id);
 
     // Node Properties
-    sol::object NodePropertyGetViaLua(const std::string& type, const std::string& key, const std::string& property);
-    sol::object NodePropertyGetByIdViaLua(uint64_t id, const std::string& property);
+    sol::object NodePropertyGetViaLua(const std::string& type, const std::string& key, const std::string& property, sol::this_state ts);
+    sol::object NodePropertyGetByIdViaLua(uint64_t id, const std::string& property, sol::this_state ts);
+    sol::table NodesGetPropertyViaLua(const std::vector<uint64_t>& ids, const std::string& property, sol::this_state ts);
+    sol::as_table_t<std::vector<int64_t>> NodesGetIntegerPropertyViaLua(const std::vector<uint64_t>& ids, const std::string& property, sol::optional<int64_t> missing);
+    sol::as_table_t<std::vector<double>> NodesGetDoublePropertyViaLua(const std::vector<uint64_t>& ids, const std::string& property, sol::optional<double> missing);
+    sol::as_table_t<std::vector<std::string>> NodesGetStringPropertyViaLua(const std::vector<uint64_t>& ids, const std::string& property, sol::optional<std::string> missing);
     bool NodePropertySetViaLua(const std::string& type, const std::string& key, const std::string& property, const sol::object& value);
     bool NodePropertySetByIdViaLua(uint64_t id, const std::string& property, const sol::object& value);
     bool NodePropertiesSetFromJsonViaLua(const std::string& type, const std::string& key, const std::string& value);
@@ -832,6 +1694,22 @@ namespace triton {
     bool NodePropertiesDeleteViaLua(const std::string& type, const std::string& key);
     bool NodePropertiesDeleteByIdViaLua(uint64_t id);
 
+    // Node Property Indexes
+    bool NodePropertyIndexCreateViaLua(const std::string& type, const std::string& property, sol::optional<std::string> index_type);
+    bool NodePropertyIndexDropViaLua(const std::string& type, const std::string& property);
+    Roaring64Map NodePropertyIndexFindViaLua(const std::string& type, const std::string& property, const sol::object& value);
+    Roaring64Map NodePropertyIndexFindRangeViaLua(const std::string& type, const std::string& property, const sol::object& min, const sol::object& max);
+
+    // Node Property Aggregates
+    Aggregate NodesAggregateViaLua(const std::string& type, const std::string& property, sol::optional<sol::table> filters);
+
+    // Node Vectors
+    bool NodeVectorPropertyCreateViaLua(const std::string& type, const std::string& property, uint32_t dimensions);
+    sol::as_table_t<std::vector<Neighbor>> NodesNearestViaLua(const std::string& type, const std::string& property, const std::vector<float>& vector, uint64_t k,
+                                                              sol::optional<std::string> metric, sol::optional<sol::table> filters);
+    sol::as_table_t<std::vector<Neighbor>> NodeIdsMapNearestViaLua(const Roaring64Map& ids, const std::string& property, const std::vector<float>& vector, uint64_t k,
+                                                                   sol::optional<std::string> metric);
+
     // Relationships
     uint64_t RelationshipAddEmptyViaLua(const std::string& rel_type, const std::string& type1, const std::string& key1,
                                         const std::string& type2, const std::string& key2);
@@ -841,15 +1719,21 @@ namespace triton {
                                    const std::string& type2, const std::string& key2, const std::string& properties);
     uint64_t RelationshipAddByTypeIdByIdsViaLua(uint16_t rel_type_id, uint64_t id1, uint64_t id2, const std::string& properties);
     uint64_t RelationshipAddByIdsViaLua(const std::string& rel_type, uint64_t id1, uint64_t id2, const std::string& properties);
+    sol::as_table_t<std::vector<uint64_t>> RelationshipsAddViaLua(const std::string& relationships);
     Relationship RelationshipGetViaLua(uint64_t id);
     bool RelationshipRemoveViaLua(uint64_t id);
     std::string RelationshipGetTypeViaLua(uint64_t id);
     uint16_t RelationshipGetTypeIdViaLua(uint64_t id);
     uint64_t RelationshipGetStartingNodeIdViaLua(uint64_t id);
     uint64_t RelationshipGetEndingNodeIdViaLua(uint64_t id);
+    bool RelationshipExistsViaLua(uint64_t id1, uint64_t id2, const std::string& rel_type, Direction direction);
+    sol::table RelationshipsExistViaLua(const std::vector<uint64_t>& ids1, const std::vector<uint64_t>& ids2, const std::string& rel_type, Direction direction, sol::this_state ts);
+    uint64_t RelationshipMergeViaLua(const std::string& rel_type, const std::string& type1, const std::string& key1,
+                                     const std::string& type2, const std::string& key2, const std::string& properties);
+    uint64_t RelationshipMergeByIdsViaLua(const std::string& rel_type, uint64_t id1, uint64_t id2, const std::string& properties);
 
     // Relationship Properties
-    sol::object RelationshipPropertyGetViaLua(uint64_t id, const std::string& property);
+    sol::object RelationshipPropertyGetViaLua(uint64_t id, const std::string& property, sol::this_state ts);
     bool RelationshipPropertySetViaLua(uint64_t id, const std::string& property, const sol::object& value);
     bool RelationshipPropertySetFromJsonViaLua(uint64_t id, const std::string& property, const std::string& value);
     bool RelationshipPropertyDeleteViaLua(uint64_t id, const std::string& property);
@@ -857,6 +1741,12 @@ namespace triton {
     bool RelationshipPropertiesResetFromJsonViaLua(uint64_t id, const std::string &value);
     bool RelationshipPropertiesDeleteViaLua(uint64_t id);
 
+    // Relationship Recency Indexes
+    bool RelationshipRecencyIndexCreateViaLua(const std::string& rel_type, const std::string& property, sol::optional<bool> stamp, sol::optional<uint64_t> ttl);
+    bool RelationshipRecencyIndexDropViaLua(const std::string& rel_type);
+    sol::as_table_t<std::vector<Relationship>> NodeGetRecentRelationshipsViaLua(const std::string& type, const std::string& key, const std::string& rel_type, sol::optional<uint64_t> limit, sol::optional<int64_t> since, sol::optional<int64_t> until);
+    sol::as_table_t<std::vector<Relationship>> NodeGetRecentRelationshipsByIdViaLua(uint64_t id, const std::string& rel_type, sol::optional<uint64_t> limit, sol::optional<int64_t> since, sol::optional<int64_t> until);
+
     // Node Degree
     uint64_t NodeGetDegreeViaLua(const std::string& type, const std::string& key);
     uint64_t NodeGetDegreeForDirectionViaLua(const std::string& type, const std::string& key, Direction direction);
@@ -934,6 +1824,21 @@ namespace triton {
     sol::as_table_t<std::vector<Node>> NodeGetNeighborsByIdForDirectionForTypeIdViaLua(uint64_t id, Direction direction, uint16_t type_id);
     sol::as_table_t<std::vector<Node>> NodeGetNeighborsByIdForDirectionForTypesViaLua(uint64_t id, Direction direction, const std::vector<std::string> &rel_types);
 
+    sol::as_table_t<std::vector<Node>> TraverseViaLua(const std::vector<uint64_t>& ids, const sol::table& steps, sol::optional<std::string> dedup);
+    sol::as_table_t<std::vector<Ids>> ShortestPathViaLua(uint64_t id1, uint64_t id2, sol::optional<Direction> direction, sol::optional<std::vector<std::string>> rel_types, sol::optional<uint64_t> max_depth);
+    sol::nested<std::vector<std::vector<uint64_t>>> RandomWalkViaLua(const std::vector<uint64_t>& ids, uint64_t length, sol::optional<Direction> direction, sol::optional<std::vector<std::string>> rel_types,
+                                                                     sol::optional<double> p, sol::optional<double> q, sol::optional<uint64_t> seed);
+    sol::nested<std::vector<std::map<uint64_t, std::vector<uint64_t>>>> SampleNeighborsViaLua(const std::vector<uint64_t>& ids, const std::vector<uint64_t>& fanouts, sol::optional<Direction> direction,
+                                                                                             sol::optional<std::vector<std::string>> rel_types, sol::optional<uint64_t> seed);
+
+    // Id Maps
+    Roaring64Map NodeGetNeighborIdsMapByIdViaLua(uint64_t id);
+    Roaring64Map NodeGetNeighborIdsMapByIdForDirectionViaLua(uint64_t id, Direction direction);
+    Roaring64Map NodeGetNeighborIdsMapByIdForDirectionForTypesViaLua(uint64_t id, Direction direction, const std::vector<std::string> &rel_types);
+    Roaring64Map NodeIdsMapFilterViaLua(const Roaring64Map& ids, const std::string& type);
+    Roaring64Map AllNodeIdsMapForTypeViaLua(const std::string& type);
+    sol::as_table_t<std::vector<Node>> NodesGetByIdsMapViaLua(const Roaring64Map& ids);
+
     // All
     sol::as_table_t<std::vector<uint64_t>> AllNodeIdsViaLua(uint64_t skip = 0, uint64_t limit = 100);
     sol::as_table_t<std::vector<uint64_t>> AllNodeIdsForTypeViaLua(const std::string& type, uint64_t skip = 0, uint64_t limit = 100);
@@ -945,6 +1850,18 @@ namespace triton {
     sol::as_table_t<std::vector<Relationship>> AllRelationshipsViaLua(uint64_t skip = 0, uint64_t limit = 100);
     sol::as_table_t<std::vector<Relationship>> AllRelationshipsForTypeViaLua(const std::string& rel_type, uint64_t skip = 0, uint64_t limit = 100);
 
+    // Local
+    uint8_t LocalShardIdViaLua() const;
+    uint64_t LocalNodeTypesGetCountByTypeViaLua(const std::string& type);
+    Roaring64Map LocalNodeIdsMapForTypeViaLua(const std::string& type);
+    sol::as_table_t<std::vector<Node>> LocalNodesGetViaLua(const std::vector<uint64_t>& ids);
+    sol::table LocalNodesGetPropertyViaLua(const std::vector<uint64_t>& ids, const std::string& property, sol::this_state ts);
+    sol::as_table_t<std::vector<int64_t>> LocalNodesGetIntegerPropertyViaLua(const std::vector<uint64_t>& ids, const std::string& property, sol::optional<int64_t> missing);
+    sol::as_table_t<std::vector<double>> LocalNodesGetDoublePropertyViaLua(const std::vector<uint64_t>& ids, const std::string& property, sol::optional<double> missing);
+    sol::as_table_t<std::vector<std::string>> LocalNodesGetStringPropertyViaLua(const std::vector<uint64_t>& ids, const std::string& property, sol::optional<std::string> missing);
+    sol::as_table_t<std::vector<uint64_t>> LocalNodesGetDegreeViaLua(const std::vector<uint64_t>& ids, Direction direction, sol::optional<std::vector<std::string>> rel_types);
+    Aggregate LocalNodesAggregateViaLua(const std::string& type, const std::string& property, sol::optional<sol::table> filters);
+
   };
 
 } // namespace triton
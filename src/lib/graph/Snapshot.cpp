@@ -0,0 +1,123 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Snapshot.h"
+#include "CommandLog.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <seastar/core/seastar.hh>
+#include <stdexcept>
+#include <tuple>
+
+namespace triton {
+
+  size_t Snapshot::aligned(size_t length) {
+    return (length + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+  }
+
+  void Snapshot::write(const std::string &file_name, std::vector<std::string> sections) {
+    std::string temporary_name = file_name + ".tmp";
+    seastar::file file = seastar::open_file_dma(temporary_name, seastar::open_flags::wo | seastar::open_flags::create | seastar::open_flags::truncate).get0();
+    auto buffer = seastar::temporary_buffer<char>::aligned(file.memory_dma_alignment(), CHUNK_SIZE);
+
+    std::string header;
+    Serializer serializer(header);
+    serializer.put(MAGIC);
+    serializer.put(VERSION);
+    serializer.put(static_cast<uint32_t>(sections.size()));
+
+    uint64_t offset = BLOCK_SIZE;
+    for (auto &section : sections) {
+      serializer.put(offset);
+      serializer.put(static_cast<uint64_t>(section.size()));
+      serializer.put(CommandLog::checksum(section.data(), section.size()));
+
+      // Copy through one aligned buffer, padding the last block of the section with zeros
+      for (size_t start = 0; start < section.size(); start += CHUNK_SIZE) {
+        size_t length = std::min(CHUNK_SIZE, section.size() - start);
+        std::memcpy(buffer.get_write(), section.data() + start, length);
+        std::memset(buffer.get_write() + length, 0, aligned(length) - length);
+        size_t written = file.dma_write(offset + start, buffer.get(), aligned(length)).get0();
+        if (written != aligned(length)) {
+          throw std::runtime_error("Short write to " + temporary_name);
+        }
+      }
+      offset += aligned(section.size());
+      // Give the memory back as soon as the section is on its way
+      std::string().swap(section);
+    }
+    serializer.put(CommandLog::checksum(header.data(), header.size()));
+
+    std::memcpy(buffer.get_write(), header.data(), header.size());
+    std::memset(buffer.get_write() + header.size(), 0, BLOCK_SIZE - header.size());
+    if (file.dma_write(0, buffer.get(), BLOCK_SIZE).get0() != BLOCK_SIZE) {
+      throw std::runtime_error("Short write to " + temporary_name);
+    }
+    file.flush().get();
+    file.close().get();
+
+    // Only a complete snapshot ever has the final name
+    seastar::rename_file(temporary_name, file_name).get();
+    seastar::sync_directory(std::filesystem::path(file_name).parent_path().string()).get();
+  }
+
+  bool Snapshot::read(const std::string &file_name, std::vector<std::string> &sections) {
+    seastar::file file = seastar::open_file_dma(file_name, seastar::open_flags::ro).get0();
+    seastar::temporary_buffer<char> header = file.dma_read_exactly<char>(0, BLOCK_SIZE).get0();
+
+    Deserializer reader(header.get(), header.size());
+    uint64_t magic = reader.getUint64();
+    uint32_t version = reader.getUint32();
+    uint32_t count = reader.getUint32();
+    bool valid = !reader.failed() && magic == MAGIC && version == VERSION && count <= (BLOCK_SIZE - 20) / 20;
+
+    std::vector<std::tuple<uint64_t, uint64_t, uint32_t>> table;
+    if (valid) {
+      for (uint32_t i = 0; i < count; i++) {
+        uint64_t offset = reader.getUint64();
+        uint64_t size = reader.getUint64();
+        uint32_t sum = reader.getUint32();
+        table.emplace_back(offset, size, sum);
+      }
+      size_t header_size = 16 + 20 * count;
+      valid = reader.getUint32() == CommandLog::checksum(header.get(), header_size) && !reader.failed();
+    }
+
+    sections.clear();
+    for (const auto &[offset, size, sum] : table) {
+      if (!valid) {
+        break;
+      }
+      std::string section;
+      section.resize(size);
+      for (size_t start = 0; start < size && valid; start += CHUNK_SIZE) {
+        size_t length = std::min(CHUNK_SIZE, size - start);
+        seastar::temporary_buffer<char> chunk = file.dma_read_exactly<char>(offset + start, aligned(length)).get0();
+        if (chunk.size() < length) {
+          valid = false;
+        } else {
+          std::memcpy(section.data() + start, chunk.get(), length);
+        }
+      }
+      valid = valid && CommandLog::checksum(section.data(), section.size()) == sum;
+      sections.emplace_back(std::move(section));
+    }
+
+    file.close().get();
+    return valid;
+  }
+}
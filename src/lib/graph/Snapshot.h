@@ -0,0 +1,46 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRITON_SNAPSHOT_H
+#define TRITON_SNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace triton {
+  // Point in time copy of one shard, made of opaque sections the shard encodes and decodes itself.
+  // The first block holds the offset, size and checksum of every section, each section starts on a block boundary
+  // so both writing and restoring are large sequential DMA transfers.
+  class Snapshot {
+  public:
+    // Writes to a temporary file and renames it once it is on disk, must run in a seastar thread
+    static void write(const std::string &file_name, std::vector<std::string> sections);
+
+    // False if the file is damaged or from another version, must run in a seastar thread
+    static bool read(const std::string &file_name, std::vector<std::string> &sections);
+
+  private:
+    inline static const uint64_t MAGIC = 0x50414E534E545254;// "TRTNSNAP"
+    inline static const uint32_t VERSION = 1;
+    inline static const size_t BLOCK_SIZE = 4096;
+    inline static const size_t CHUNK_SIZE = 8 * 1024 * 1024;
+
+    static size_t aligned(size_t length);
+  };
+}
+
+#endif//TRITON_SNAPSHOT_H
@@ -0,0 +1,65 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Trace.h"
+#include <chrono>
+
+namespace triton {
+
+  TraceHop* Trace::hop(const std::string& operation, uint16_t shard) {
+    hops.push_back(std::make_unique<TraceHop>());
+    TraceHop* added = hops.back().get();
+    added->operation = operation;
+    added->shard = shard;
+    added->sent = now();
+    return added;
+  }
+
+  void Trace::stage(const std::string& name, int64_t since) {
+    stages.push_back({name, since, now()});
+  }
+
+  int64_t Trace::now() {
+    // The steady clock is the same on every core, so the times a shard called writes line up with the ones taken here
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  SlowQuery::SlowQuery(std::string name, uint16_t shard, uint64_t microseconds, const Trace* trace)
+    : name(std::move(name)), shard(shard), microseconds(microseconds) {
+    if (trace == nullptr) {
+      return;
+    }
+    trace_id = trace->id;
+    for (const auto& hop : trace->hops) {
+      // A hop still out may be being written by the shard it went to
+      if (hop->returned == 0) {
+        continue;
+      }
+      TraceHop relative = *hop;
+      relative.sent -= trace->start;
+      relative.started = relative.started == 0 ? 0 : relative.started - trace->start;
+      relative.finished = relative.finished == 0 ? 0 : relative.finished - trace->start;
+      relative.returned -= trace->start;
+      hops.push_back(std::move(relative));
+    }
+    for (TraceStage stage : trace->stages) {
+      stage.start -= trace->start;
+      stage.finish -= trace->start;
+      stages.push_back(std::move(stage));
+    }
+  }
+
+}// namespace triton
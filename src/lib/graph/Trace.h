@@ -0,0 +1,70 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRITON_TRACE_H
+#define TRITON_TRACE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace triton {
+
+  // One call from the shard a request came in on to a shard, every time is in steady clock microseconds
+  struct TraceHop {
+    std::string operation;
+    uint16_t shard = 0;    // The number of shards for a call to all of them
+    int64_t sent = 0;
+    int64_t started = 0;   // When the shard called picked it up, zero for a call to all of them
+    int64_t finished = 0;  // When the shard called was done with it, zero for a call to all of them
+    int64_t returned = 0;  // When the answer was back, zero while it is still out
+  };
+
+  struct TraceStage {
+    std::string name;
+    int64_t start = 0;
+    int64_t finish = 0;
+  };
+
+  // The calls a traced request made to other shards and the stages it went through, kept on the shard it came in on
+  struct Trace {
+    uint64_t id = 0;
+    int64_t start = 0;
+    std::vector<std::unique_ptr<TraceHop>> hops;// The shard called fills in its times, so a hop must not move while it is out
+    std::vector<TraceStage> stages;
+
+    TraceHop* hop(const std::string& operation, uint16_t shard);
+    void stage(const std::string& name, int64_t since);
+    static int64_t now();
+  };
+
+  // A request that took longer than the slow query threshold, or asked to be traced, with the times relative to its start
+  struct SlowQuery {
+    uint64_t trace_id = 0;// Zero when it was not traced
+    std::string name;     // The route, followed by the hash of the body for a script
+    uint16_t shard = 0;
+    uint64_t microseconds = 0;
+    std::vector<TraceHop> hops;
+    std::vector<TraceStage> stages;
+
+    SlowQuery() = default;
+    SlowQuery(std::string name, uint16_t shard, uint64_t microseconds, const Trace* trace);
+  };
+
+}// namespace triton
+
+#endif//TRITON_TRACE_H
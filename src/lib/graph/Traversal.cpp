@@ -0,0 +1,22 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Traversal.h"
+
+namespace triton {
+  TraverseStep::TraverseStep(Direction direction, std::vector<uint16_t> rel_type_ids, uint16_t node_type_id) : direction(direction), rel_type_ids(std::move(rel_type_ids)), node_type_id(node_type_id) {}
+
+} // namespace triton
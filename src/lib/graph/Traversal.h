@@ -0,0 +1,87 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRITON_TRAVERSAL_H
+#define TRITON_TRAVERSAL_H
+
+#include "Direction.h"
+#include <cstdint>
+#include <limits>
+#include <roaring/roaring64map.hh>
+#include <unordered_map>
+#include <vector>
+
+namespace triton {
+
+  // HOP expands a node once per hop even if it was reached before, GLOBAL only the first time it is reached at all
+  enum class TraverseDedup {
+    HOP, GLOBAL
+  };
+
+  // One hop of a traversal, no relationship types follows all of them and node type 0 keeps nodes of every type
+  class TraverseStep {
+  public:
+    TraverseStep(Direction direction, std::vector<uint16_t> rel_type_ids, uint16_t node_type_id);
+    Direction direction;
+    std::vector<uint16_t> rel_type_ids;
+    uint16_t node_type_id;
+  };
+
+  // What a shard holds of a running traversal: the nodes it owns at each hop and, for GLOBAL, all the nodes it has reached
+  class Traversal {
+  public:
+    std::vector<Roaring64Map> frontiers;
+    Roaring64Map visited;
+  };
+
+  // How a node was reached by a shortest path search, from which node over which relationship, zero for the start
+  class PathStep {
+  public:
+    uint64_t node_id;
+    uint64_t rel_id;
+    uint64_t depth;
+  };
+
+  // One side of a shortest path search on a shard: the nodes it owns that were reached and the ones at its edge
+  class PathSide {
+  public:
+    std::unordered_map<uint64_t, PathStep> reached;
+    std::vector<uint64_t> frontier;
+    std::vector<uint64_t> next;
+    uint64_t depth = 0;
+  };
+
+  // What a shard holds of a running shortest path search, the start side, the end side and the best place they met
+  class PathSearch {
+  public:
+    PathSide sides[2];
+    uint64_t meeting_length = std::numeric_limits<uint64_t>::max();
+    uint64_t meeting_id = 0;
+  };
+
+  // Where a random walk is between its steps. Node2vec weighs each next node by its distance from the previous one,
+  // so biased walks carry the sorted neighbors of their previous node along instead of asking its shard again
+  class Walker {
+  public:
+    uint64_t walk;// Position of the walk in the results
+    uint64_t current;// Zero once the walk cannot go on
+    uint64_t previous;
+    std::vector<uint64_t> previous_neighbors;
+  };
+
+}// namespace triton
+
+#endif//TRITON_TRAVERSAL_H
@@ -17,15 +17,14 @@
 #include "Types.h"
 
 namespace triton {
-  Types::Types() : type_to_id(), id_to_type() {
+  Types::Types() : type_to_id(), id_to_type(), ids() {
     // start with empty blank type
     type_to_id.emplace("", 0);
-    id_to_type.emplace(0, "");
-    ids = std::unordered_map<uint16_t, Roaring64Map>();
-    ids.emplace(0, Roaring64Map());
+    id_to_type.emplace_back("");
+    ids.emplace_back();
   }
 
-  uint16_t Types::getTypeId(const std::string &token) {
+  uint16_t Types::getTypeId(std::string_view token) const {
     auto token_search = type_to_id.find(token);
     if (token_search != type_to_id.end()) {
       return token_search->second;
@@ -40,25 +39,27 @@ namespace triton {
       return token_search->second;
     }
     // Insert
-    uint16_t token_id = type_to_id.size();
+    uint16_t token_id = getNextTypeId();
+    if (token_id == 0) {
+      return 0;
+    }
     type_to_id.emplace(token, token_id);
-    id_to_type.emplace(token_id, token);
-    ids.emplace(token_id, Roaring64Map());
+    id_to_type.emplace_back(token);
+    ids.emplace_back();
     return token_id;
   }
 
-  std::string Types::getType(uint16_t type_id) {
-    auto token_search = id_to_type.find(type_id);
-    if (token_search != id_to_type.end()) {
-      return token_search->second;
+  const std::string& Types::getType(uint16_t type_id) const {
+    if (type_id < id_to_type.size()) {
+      return id_to_type[type_id];
     }
     // If not found return empty
-    return id_to_type.at(0);
+    return id_to_type[0];
   }
 
   bool Types::addId(uint16_t type_id, uint64_t id) {
     if (ValidTypeId(type_id)) {
-      ids.at(type_id).add(id);
+      ids[type_id].add(id);
       return true;
     }
     // If not valid return false
@@ -67,7 +68,7 @@ namespace triton {
 
   bool Types::removeId(uint16_t type_id, uint64_t id) {
     if (ValidTypeId(type_id)) {
-      ids.at(type_id).remove(id);
+      ids[type_id].remove(id);
       return true;
     }
     // If not valid return false
@@ -76,7 +77,7 @@ namespace triton {
 
   bool Types::containsId(uint16_t type_id, uint64_t id) {
     if (ValidTypeId(type_id)) {
-      return ids.at(type_id).contains(id);
+      return ids[type_id].contains(id);
     }
     // If not valid return false
     return false;
@@ -85,40 +86,63 @@ namespace triton {
   Roaring64Map Types::getIds() const {
     Roaring64Map allIds;
     for(const auto& entry : ids) {
-      allIds.operator|=(entry.second);
+      allIds.operator|=(entry);
     }
     return allIds;
   }
 
   Roaring64Map Types::getIds(uint16_t type_id) {
     if (ValidTypeId(type_id)) {
-      return ids.at(type_id);
+      return ids[type_id];
+    }
+    return ids[0];
+  }
+
+  // Only the ids of the type that are in the given map, without copying all of them first
+  Roaring64Map Types::getIds(uint16_t type_id, const Roaring64Map& filter) const {
+    if (ValidTypeId(type_id)) {
+      return filter & ids[type_id];
     }
-    return ids.at(0);
+    return Roaring64Map();
+  }
+
+  const Roaring64Map& Types::getIdsOf(uint16_t type_id) const {
+    static const Roaring64Map none;
+    if (ValidTypeId(type_id)) {
+      return ids[type_id];
+    }
+    return none;
   }
 
   bool Types::ValidTypeId(uint16_t type_id) const {
-    // TypeId must be greater than zero
-    return (type_id > 0 && type_id < id_to_type.size());
+    // TypeId must be greater than zero and not a gap left by a type that has not arrived yet
+    return (type_id > 0 && type_id < id_to_type.size() && !id_to_type[type_id].empty());
   }
 
   uint64_t Types::getCount(uint16_t type_id) {
     if (ValidTypeId(type_id)) {
-      return ids.at(type_id).cardinality();
+      return ids[type_id].cardinality();
     }
     // If not valid return 0
     return 0;
   }
 
   uint16_t Types::getSize() const {
-    return id_to_type.size() - 1;
+    return type_to_id.size() - 1;
+  }
+
+  uint16_t Types::getNextTypeId() const {
+    if (id_to_type.size() > UINT16_MAX) {
+      return 0;
+    }
+    return id_to_type.size();
   }
 
   std::set<std::string> Types::getTypes() {
     std::set<std::string> types;
-    for (auto &it : id_to_type) {
-      if (it.first > 0) {
-        types.insert(it.second);
+    for (uint16_t type_id = 1; type_id < id_to_type.size(); type_id++) {
+      if (!id_to_type[type_id].empty()) {
+        types.insert(id_to_type[type_id]);
       }
     }
 
@@ -127,9 +151,9 @@ namespace triton {
 
   std::set<uint16_t> Types::getTypeIds() {
     std::set<uint16_t> type_ids;
-    for (auto &it : id_to_type) {
-      if (it.first > 0) {
-        type_ids.insert(it.first);
+    for (uint16_t type_id = 1; type_id < id_to_type.size(); type_id++) {
+      if (!id_to_type[type_id].empty()) {
+        type_ids.insert(type_id);
       }
     }
 
@@ -138,9 +162,9 @@ namespace triton {
 
   std::map<uint16_t,uint64_t> Types::getCounts() {
     std::map<uint16_t,uint64_t> counts;
-    for (auto &it : id_to_type) {
-      if (it.first > 0) {
-        counts.insert({it.first, ids.at(it.first).cardinality()});
+    for (uint16_t type_id = 1; type_id < id_to_type.size(); type_id++) {
+      if (!id_to_type[type_id].empty()) {
+        counts.insert({type_id, ids[type_id].cardinality()});
       }
     }
 
@@ -153,16 +177,52 @@ namespace triton {
       // Type already exists
       return false;
     } else {
-      auto id_search = id_to_type.find(token_id);
-      if (id_search != id_to_type.end()) {
+      if (token_id < id_to_type.size() && (token_id == 0 || !id_to_type[token_id].empty())) {
         // Id already exists
         return false;
       }
+      // Ids may arrive out of order, so leave a gap for the ones still on their way
+      if (token_id >= id_to_type.size()) {
+        id_to_type.resize(token_id + 1);
+        ids.resize(token_id + 1);
+      }
       type_to_id.emplace(token, token_id);
-      id_to_type.emplace(token_id, token);
-      ids.emplace(token_id, Roaring64Map());
+      id_to_type[token_id] = token;
       return false;
     }
   }
 
-}// namespace triton
\ No newline at end of file
+  void Types::write(Serializer &serializer) const {
+    serializer.put(static_cast<uint64_t>(type_to_id.size()));
+    for (uint16_t type_id = 0; type_id < id_to_type.size(); type_id++) {
+      if (type_id == 0 || !id_to_type[type_id].empty()) {
+        serializer.put(type_id);
+        serializer.put(id_to_type[type_id]);
+        serializer.put(ids[type_id]);
+      }
+    }
+  }
+
+  bool Types::read(Deserializer &reader) {
+    type_to_id.clear();
+    id_to_type.clear();
+    ids.clear();
+    bool blank = false;
+    for (uint64_t count = reader.getUint64(); count > 0 && !reader.failed(); count--) {
+      uint16_t type_id = reader.getUint16();
+      std::string type = reader.getString();
+      Roaring64Map type_ids = reader.getBitmap();
+      if (type_id >= id_to_type.size()) {
+        id_to_type.resize(type_id + 1);
+        ids.resize(type_id + 1);
+      }
+      blank = blank || type_id == 0;
+      type_to_id.emplace(type, type_id);
+      id_to_type[type_id] = std::move(type);
+      ids[type_id] = std::move(type_ids);
+    }
+    // Every type store starts with the empty blank type
+    return !reader.failed() && blank;
+  }
+
+}// namespace triton
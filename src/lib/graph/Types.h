@@ -18,22 +18,25 @@
 #define TRITON_TYPES_H
 
 #include <cstdint>
+#include <functional>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
 #include <set>
 #include <roaring/roaring64map.hh>
+#include <tsl/sparse_map.h>
+#include "Serializer.h"
 
 namespace triton {
   class Types {
   public:
     Types();
 
-    uint16_t getTypeId(const std::string &);
+    uint16_t getTypeId(std::string_view) const;
 
     uint16_t insertOrGetTypeId(const std::string &);
 
-    std::string getType(uint16_t);
+    const std::string& getType(uint16_t) const;
 
     bool addId(uint16_t, uint64_t);
 
@@ -45,12 +48,20 @@ namespace triton {
 
     Roaring64Map getIds(uint16_t);
 
+    Roaring64Map getIds(uint16_t, const Roaring64Map&) const;
+
+    // The ids of the type without copying them, an empty map when the type is not valid
+    const Roaring64Map& getIdsOf(uint16_t) const;
+
     bool ValidTypeId(uint16_t) const;
 
     uint64_t getCount(uint16_t);
 
     uint16_t getSize() const;
 
+    // The slot past the highest type id, or 0 once the last one is taken
+    uint16_t getNextTypeId() const;
+
     std::set<std::string> getTypes();
 
     std::set<uint16_t> getTypeIds();
@@ -58,11 +69,19 @@ namespace triton {
     std::map<uint16_t,uint64_t> getCounts();
 
     bool addTypeId(const std::string&, uint16_t);
+    void write(Serializer&) const;
+    bool read(Deserializer&);
 
   private:
-    std::unordered_map<std::string, uint16_t> type_to_id;
-    std::unordered_map<uint16_t, std::string> id_to_type;
-    std::unordered_map<uint16_t, Roaring64Map> ids;
+    // Lets type_to_id be searched with a string_view without building a std::string
+    struct TypeHash {
+      using is_transparent = void;
+      size_t operator()(std::string_view type) const { return std::hash<std::string_view>()(type); }
+    };
+
+    tsl::sparse_map<std::string, uint16_t, TypeHash, std::equal_to<>> type_to_id;
+    std::vector<std::string> id_to_type;// Indexed by type id, an empty type is an unused id
+    std::vector<Roaring64Map> ids;// Indexed by type id
   };
 } // namespace triton
 
@@ -0,0 +1,137 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Vector.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Build each kernel for AVX-512 and AVX2 as well as the baseline, the loader picks the widest one the cpu runs
+#if defined(__x86_64__) && defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define TRITON_VECTOR_CLONES __attribute__((target_clones("avx512f", "avx2", "default")))
+#endif
+#endif
+#ifndef TRITON_VECTOR_CLONES
+#define TRITON_VECTOR_CLONES
+#endif
+
+namespace triton {
+
+  // Independent partial sums, one per lane, so the loops vectorize without reordering a single running sum
+  static const uint32_t LANES = 16;
+
+  TRITON_VECTOR_CLONES
+  static float dot(const float *left, const float *right, uint32_t dimensions) {
+    float lanes[LANES] = {};
+    uint32_t i = 0;
+    for (; i + LANES <= dimensions; i += LANES) {
+      for (uint32_t lane = 0; lane < LANES; lane++) {
+        lanes[lane] += left[i + lane] * right[i + lane];
+      }
+    }
+    float sum = 0;
+    for (; i < dimensions; i++) {
+      sum += left[i] * right[i];
+    }
+    for (float lane : lanes) {
+      sum += lane;
+    }
+    return sum;
+  }
+
+  TRITON_VECTOR_CLONES
+  static float squaredDistance(const float *left, const float *right, uint32_t dimensions) {
+    float lanes[LANES] = {};
+    uint32_t i = 0;
+    for (; i + LANES <= dimensions; i += LANES) {
+      for (uint32_t lane = 0; lane < LANES; lane++) {
+        float difference = left[i + lane] - right[i + lane];
+        lanes[lane] += difference * difference;
+      }
+    }
+    float sum = 0;
+    for (; i < dimensions; i++) {
+      float difference = left[i] - right[i];
+      sum += difference * difference;
+    }
+    for (float lane : lanes) {
+      sum += lane;
+    }
+    return sum;
+  }
+
+  bool toVectorMetric(std::string_view name, VectorMetric &metric) {
+    if (name == "dot") {
+      metric = VectorMetric::DOT;
+    } else if (name == "cosine") {
+      metric = VectorMetric::COSINE;
+    } else if (name == "l2") {
+      metric = VectorMetric::L2;
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+  double VectorDistance(const float *left, const float *right, uint32_t dimensions, VectorMetric metric) {
+    switch (metric) {
+      case VectorMetric::DOT:
+        return -static_cast<double>(dot(left, right, dimensions));
+      case VectorMetric::COSINE: {
+        double norms = std::sqrt(static_cast<double>(dot(left, left, dimensions)) * dot(right, right, dimensions));
+        // A zero vector points nowhere, so it is as far as can be from everything
+        if (norms == 0) {
+          return 2;
+        }
+        return 1 - dot(left, right, dimensions) / norms;
+      }
+      case VectorMetric::L2:
+        return squaredDistance(left, right, dimensions);
+    }
+    return 0;
+  }
+
+  NearestNeighbors::NearestNeighbors(uint64_t k) : k(k) {}
+
+  void NearestNeighbors::add(uint64_t id, double distance) {
+    Neighbor neighbor{id, distance};
+    if (heap.size() < k) {
+      heap.push_back(neighbor);
+      std::push_heap(heap.begin(), heap.end());
+      return;
+    }
+    // The farthest of the k is on top, only something closer takes its place
+    if (k > 0 && neighbor < heap.front()) {
+      std::pop_heap(heap.begin(), heap.end());
+      heap.back() = neighbor;
+      std::push_heap(heap.begin(), heap.end());
+    }
+  }
+
+  void NearestNeighbors::merge(const std::vector<Neighbor> &others) {
+    for (const Neighbor &neighbor : others) {
+      add(neighbor.id, neighbor.distance);
+    }
+  }
+
+  std::vector<Neighbor> NearestNeighbors::sorted() const {
+    std::vector<Neighbor> neighbors = heap;
+    std::sort_heap(neighbors.begin(), neighbors.end());
+    return neighbors;
+  }
+
+}// namespace triton
@@ -0,0 +1,67 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRITON_VECTOR_H
+#define TRITON_VECTOR_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace triton {
+
+  enum class VectorMetric : uint8_t {
+    DOT, COSINE, L2
+  };
+
+  // From "dot", "cosine" or "l2"
+  bool toVectorMetric(std::string_view name, VectorMetric &metric);
+
+  // How far apart two vectors are, smaller is closer for every metric: the negated dot product,
+  // one minus the cosine similarity or the squared euclidean distance
+  double VectorDistance(const float *left, const float *right, uint32_t dimensions, VectorMetric metric);
+
+  struct Neighbor {
+    uint64_t id;
+    double distance;
+
+    // Closer first, ties broken by id so every shard order merges the same way
+    bool operator<(const Neighbor &other) const {
+      return distance < other.distance || (distance == other.distance && id < other.id);
+    }
+  };
+
+  // The k closest candidates seen so far, kept in a max heap so a farther one is turned away with a single comparison.
+  // Each shard fills one and they are merged into the k closest overall
+  class NearestNeighbors {
+  public:
+    explicit NearestNeighbors(uint64_t k = 0);
+
+    void add(uint64_t id, double distance);
+    void merge(const std::vector<Neighbor> &others);
+    [[nodiscard]] size_t size() const { return heap.size(); }
+
+    // Closest first
+    [[nodiscard]] std::vector<Neighbor> sorted() const;
+
+  private:
+    uint64_t k;
+    std::vector<Neighbor> heap;
+  };
+
+}// namespace triton
+
+#endif//TRITON_VECTOR_H
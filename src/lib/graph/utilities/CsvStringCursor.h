@@ -0,0 +1,59 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRITON_CSVSTRINGCURSOR_H
+#define TRITON_CSVSTRINGCURSOR_H
+
+#include <algorithm>
+#include <string>
+#include "csvmonkey.hpp"
+
+namespace triton {
+
+  // Stream cursor over a CSV document already in memory, such as an HTTP request body.
+  // csvmonkey reads up to 16 bytes past the end of the data, so the copy is padded with NULs.
+  class CsvStringCursor : public csvmonkey::StreamCursor {
+  public:
+    explicit CsvStringCursor(std::string csv) : data(std::move(csv)), position(0), length(data.size()) {
+      data.append(PADDING, '\0');
+    }
+
+    const char *buf() override {
+      return data.c_str() + position;
+    }
+
+    size_t size() override {
+      return length - position;
+    }
+
+    void consume(size_t n) override {
+      position += std::min(n, length - position);
+    }
+
+    bool fill() override {
+      return false;
+    }
+
+  private:
+    static const size_t PADDING = 32;
+    std::string data;
+    size_t position;
+    size_t length;
+  };
+
+} // namespace triton
+
+#endif//TRITON_CSVSTRINGCURSOR_H
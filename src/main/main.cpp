@@ -15,14 +15,11 @@
  */
 
 #include "../lib/seastar/stop_signal.hh"
-#include "server/Degrees.h"
-#include "server/Lua.h"
-#include "server/NodeProperties.h"
-#include "server/Nodes.h"
-#include "server/RelationshipProperties.h"
-#include "server/Relationships.h"
-#include "server/Neighbors.h"
+#include "server/Binary.h"
+#include "server/Graphs.h"
+#include "server/Replica.h"
 #include <Graph.h>
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <seastar/core/app-template.hh>
@@ -52,9 +49,38 @@ int main(int argc, char** argv) {
   //Options
   app.add_options()("address", bpo::value<sstring>()->default_value("0.0.0.0"), "HTTP Server address");
   app.add_options()("port", bpo::value<uint16_t>()->default_value(10000), "HTTP Server port");
+  app.add_options()("shard_port", bpo::value<uint16_t>()->default_value(0), "First per core HTTP port, core n listens on shard_port + n. Set to zero in order to disable.");
+  app.add_options()("binary_shard_port", bpo::value<uint16_t>()->default_value(0), "First per core binary protocol port, core n listens on binary_shard_port + n. Set to zero in order to disable.");
+  app.add_options()("binary_port", bpo::value<uint16_t>()->default_value(0), "Binary protocol port, served on the HTTP Server address. Set to zero in order to disable.");
   app.add_options()("prometheus_port", bpo::value<uint16_t>()->default_value(9180), "Prometheus port. Set to zero in order to disable.");
   app.add_options()("prometheus_address", bpo::value<sstring>()->default_value("0.0.0.0"), "Prometheus address");
   app.add_options()("prometheus_prefix", bpo::value<sstring>()->default_value("triton_httpd"), "Prometheus metrics prefix");
+  app.add_options()("import_nodes", bpo::value<sstring>()->default_value(""), "CSV file of nodes to import on start");
+  app.add_options()("import_relationships", bpo::value<sstring>()->default_value(""), "CSV file of relationships to import on start");
+  app.add_options()("lua_vms", bpo::value<uint16_t>()->default_value(4), "Lua VMs per core, scripts wait for a free one");
+  app.add_options()("lua_max_instructions", bpo::value<uint64_t>()->default_value(0), "Lua instructions a script may run before it is stopped. Set to zero in order to disable.");
+  app.add_options()("lua_max_memory", bpo::value<uint64_t>()->default_value(0), "Bytes a script may add to its Lua VM before it is stopped. Set to zero in order to disable.");
+  app.add_options()("lua_preempt", bpo::value<bool>()->default_value(true), "Let a running script give the core back to other requests. Without it and both Lua limits, scripts are compiled by the JIT.");
+  app.add_options()("lua_shares", bpo::value<uint16_t>()->default_value(0), "Scheduler shares of Lua scripts against the rest of the requests, which have 1000. Set to zero in order to share with them.");
+  app.add_options()("command_log_directory", bpo::value<sstring>()->default_value(""), "Directory of the command logs, replayed on start. Empty in order to disable.");
+  app.add_options()("command_log_flush_interval", bpo::value<uint64_t>()->default_value(10), "Milliseconds between command log flushes");
+  app.add_options()("command_log_flush_bytes", bpo::value<uint64_t>()->default_value(1048576), "Bytes of buffered commands that force a command log flush");
+  app.add_options()("compaction_interval", bpo::value<uint64_t>()->default_value(1000), "Milliseconds between compaction slices of deleted nodes and relationships. Set to zero in order to disable.");
+  app.add_options()("compaction_nodes", bpo::value<uint64_t>()->default_value(4096), "Nodes each compaction slice looks at");
+  app.add_options()("compaction_release_capacity", bpo::value<bool>()->default_value(false), "Give back unused capacity at the end of each compaction pass, including what was reserved");
+  app.add_options()("sort_supernodes", bpo::value<bool>()->default_value(false), "Keep relationship lists larger than a segment sorted by the other node, instead of in the order they were added");
+  app.add_options()("replication_backlog", bpo::value<uint64_t>()->default_value(0), "Bytes of recent commands every core keeps for replicas to follow. Set to zero in order to disable.");
+  app.add_options()("replica_of", bpo::value<sstring>()->default_value(""), "Binary protocol ip:port of the primary to follow as a read only replica. Empty in order to disable.");
+  app.add_options()("replica_poll_interval", bpo::value<uint64_t>()->default_value(10), "Milliseconds a caught up replica waits before asking its primary for more");
+  app.add_options()("replica_batch_bytes", bpo::value<uint64_t>()->default_value(1048576), "Bytes of commands a replica asks its primary for at once");
+  app.add_options()("result_cache_bytes", bpo::value<uint64_t>()->default_value(0), "Bytes of Lua and neighbor results every core keeps until the graph changes. Set to zero in order to disable.");
+  app.add_options()("memory_soft_limit", bpo::value<uint64_t>()->default_value(0), "Bytes allocated on any core past which writes other than deletes are turned away. Set to zero in order to disable.");
+  app.add_options()("memory_hard_limit", bpo::value<uint64_t>()->default_value(0), "Bytes allocated on any core past which scripts and other reads with a body are turned away as well. Set to zero in order to disable.");
+  app.add_options()("memory_check_interval", bpo::value<uint64_t>()->default_value(100), "Milliseconds between checks of the memory each core has allocated against the limits");
+  app.add_options()("slow_query_threshold", bpo::value<uint64_t>()->default_value(0), "Microseconds a request may take before it goes in the slow query log. Set to zero in order to disable.");
+  app.add_options()("slow_query_sample", bpo::value<uint64_t>()->default_value(1), "Keep one in this many of the requests over the slow query threshold");
+  app.add_options()("trace_sample", bpo::value<uint64_t>()->default_value(0), "Trace one in this many requests on every core, the rest are traced only when they ask with trace=true. Set to zero in order to disable.");
+  app.add_options()("placement_affinity", bpo::value<std::string>()->default_value(""), "Keep nodes whose keys share the part before this separator on the same shard, whatever their type");
 
   return app.run(argc, argv, [&] {
     std::cout << "Running on " << seastar::smp::count << " cores." << '\n';
@@ -85,17 +111,110 @@ int main(int argc, char** argv) {
              }).get();
            }
 
+           // Supernode lists are sorted or not from the first relationship, so decide before any are loaded
+           IdsList::sort_segments = config["sort_supernodes"].as<bool>();
+           Placement::affinity_separator = config["placement_affinity"].as<std::string>();
+
            // Initialize Graph
-           graph.start().get();
+           graph.start(static_cast<uint8_t>(std::clamp(config["lua_vms"].as<uint16_t>(), uint16_t(1), uint16_t(255)))).get();
+
+           // Recover from the latest snapshot and the command logs before anything else changes the graph
+           std::string command_log_directory = config["command_log_directory"].as<sstring>();
+           if (!command_log_directory.empty()) {
+             uint64_t count = graph.CommandLogStart(command_log_directory,
+                                                    config["command_log_flush_interval"].as<uint64_t>(),
+                                                    config["command_log_flush_bytes"].as<uint64_t>()).get0();
+             std::cout << "Replayed " << count << " commands from " << command_log_directory << '\n';
+           }
+
+           // Budgets of Lua scripts, and their own scheduling group so long scripts take only their share of each core
+           uint64_t lua_max_instructions = config["lua_max_instructions"].as<uint64_t>();
+           uint64_t lua_max_memory = config["lua_max_memory"].as<uint64_t>();
+           bool lua_preempt = config["lua_preempt"].as<bool>();
+           uint16_t lua_shares = config["lua_shares"].as<uint16_t>();
+           seastar::scheduling_group lua_group = seastar::default_scheduling_group();
+           if (lua_shares) {
+             lua_group = seastar::create_scheduling_group("lua", lua_shares).get0();
+           }
+           graph.shard.invoke_on_all([lua_max_instructions, lua_max_memory, lua_group, lua_preempt] (Shard &local_shard) {
+             local_shard.LuaLimits(lua_max_instructions, lua_max_memory, lua_group, lua_preempt);
+           }).get();
+
+           uint64_t result_cache_bytes = config["result_cache_bytes"].as<uint64_t>();
+           if (result_cache_bytes) {
+             graph.shard.invoke_on_all([result_cache_bytes] (Shard &local_shard) {
+               local_shard.ResultCacheResize(result_cache_bytes);
+             }).get();
+           }
+
+           // Turn requests away before a core runs out of memory, checked often since a bulk write can go through it quickly
+           uint64_t memory_soft_limit = config["memory_soft_limit"].as<uint64_t>();
+           uint64_t memory_hard_limit = config["memory_hard_limit"].as<uint64_t>();
+           if (memory_soft_limit || memory_hard_limit) {
+             uint64_t memory_check_interval = config["memory_check_interval"].as<uint64_t>();
+             graph.shard.invoke_on_all([memory_soft_limit, memory_hard_limit, memory_check_interval] (Shard &local_shard) {
+               local_shard.MemoryLimits(memory_soft_limit, memory_hard_limit, memory_check_interval);
+             }).get();
+           }
+
+           // Note the requests that are slow, and the calls between shards of the ones that are traced
+           uint64_t slow_query_threshold = config["slow_query_threshold"].as<uint64_t>();
+           uint64_t slow_query_sample = config["slow_query_sample"].as<uint64_t>();
+           uint64_t trace_sample = config["trace_sample"].as<uint64_t>();
+           graph.shard.invoke_on_all([slow_query_threshold, slow_query_sample, trace_sample] (Shard &local_shard) {
+             local_shard.TraceLimits(slow_query_threshold, slow_query_sample, trace_sample);
+           }).get();
+
+           // Keep the latest commands around for replicas, or become one
+           uint64_t replication_backlog = config["replication_backlog"].as<uint64_t>();
+           if (replication_backlog) {
+             graph.shard.invoke_on_all([replication_backlog] (Shard &local_shard) {
+               local_shard.ReplicationFollow(replication_backlog);
+             }).get();
+           }
+           std::string replica_of = config["replica_of"].as<sstring>();
+           auto replica = new seastar::sharded<Replica>();
+           if (!replica_of.empty()) {
+             size_t colon = replica_of.rfind(':');
+             if (colon == std::string::npos) {
+               throw std::runtime_error("replica_of needs to be ip:port");
+             }
+             socket_address primary{net::inet_address(replica_of.substr(0, colon)), static_cast<uint16_t>(std::stoul(replica_of.substr(colon + 1)))};
+             graph.shard.invoke_on_all(&Shard::ReadOnly).get();
+             replica->start(std::ref(graph), primary, config["replica_poll_interval"].as<uint64_t>(), config["replica_batch_bytes"].as<uint64_t>()).get();
+             replica->invoke_on_all(&Replica::start).get();
+             std::cout << "Following " << replica_of << " as a read only replica\n";
+           }
+
+           // Bulk load any csv files before we start taking requests
+           std::string import_nodes = config["import_nodes"].as<sstring>();
+           if (!import_nodes.empty()) {
+             uint64_t count = graph.shard.local().NodesImportCsvFilePeered(import_nodes).get0();
+             std::cout << "Imported " << count << " nodes from " << import_nodes << '\n';
+           }
+           std::string import_relationships = config["import_relationships"].as<sstring>();
+           if (!import_relationships.empty()) {
+             uint64_t count = graph.shard.local().RelationshipsImportCsvFilePeered(import_relationships).get0();
+             std::cout << "Imported " << count << " relationships from " << import_relationships << '\n';
+           }
+
+           // Reclaim deleted slots in the background once the graph is loaded, with a small share so compaction only takes what foreground work leaves
+           GraphsConfig graphs_config;
+           graphs_config.memory_check_interval = config["memory_check_interval"].as<uint64_t>();
+           graphs_config.slow_query_threshold = slow_query_threshold;
+           graphs_config.slow_query_sample = slow_query_sample;
+           graphs_config.trace_sample = trace_sample;
+           graphs_config.compaction_interval = config["compaction_interval"].as<uint64_t>();
+           graphs_config.compaction_nodes = config["compaction_nodes"].as<uint64_t>();
+           graphs_config.compaction_release_capacity = config["compaction_release_capacity"].as<bool>();
+           if (graphs_config.compaction_interval) {
+             graphs_config.compaction_group = seastar::create_scheduling_group("compaction", 100).get0();
+             graph.CompactionStart(graphs_config.compaction_group, graphs_config.compaction_interval, graphs_config.compaction_nodes,
+                                   graphs_config.compaction_release_capacity).get();
+           }
 
            // Initialize Routes?
-           Nodes nodes = Nodes(graph);
-           Relationships relationships = Relationships(graph);
-           Degrees degrees = Degrees(graph);
-           Neighbors neighbors = Neighbors(graph);
-           NodeProperties nodeProperties = NodeProperties(graph);
-           RelationshipProperties relationshipProperties = RelationshipProperties(graph);
-           Lua lua = Lua(graph);
+           GraphRoutes graph_routes = GraphRoutes(graph);
 
            // Start Server
            net::inet_address addr(config["address"].as<sstring>());
@@ -103,19 +222,59 @@ int main(int argc, char** argv) {
            auto server = new http_server_control();
            auto rb = make_shared<api_registry_builder>("apps/httpd/");
 
+           // Every core also serves the same routes on its own port, requests for the nodes of that core then skip the hop from the accepting core
+           uint16_t sport = config["shard_port"].as<uint16_t>();
+           auto shard_server = new http_server_control();
+           std::vector<http_server_control*> servers = {server};
+           if (sport) {
+             servers.push_back(shard_server);
+           }
+           Graphs graphs = Graphs(graph, servers, graphs_config);
+
+           auto set_routes = [&] (http_server_control* http) {
+             http->set_routes([&graph_routes](routes& r) { graph_routes.set_routes(r);}).get();
+             http->set_routes([&graphs](routes& r) { graphs.set_routes(r);}).get();
+             http->set_routes([rb](routes& r){rb->set_api_doc(r);}).get();
+           };
+
            server->start().get();
-           server->set_routes([&relationshipProperties](routes& r) { relationshipProperties.set_routes(r);}).get();
-           server->set_routes([&nodeProperties](routes& r) { nodeProperties.set_routes(r);}).get();
-           server->set_routes([&degrees](routes& r) { degrees.set_routes(r);}).get();
-           server->set_routes([&neighbors](routes& r) {neighbors.set_routes(r);}).get();
-           server->set_routes([&nodes](routes& r) { nodes.set_routes(r);}).get();
-           server->set_routes([&relationships](routes& r) { relationships.set_routes(r);}).get();
-           server->set_routes([&lua](routes& r) { lua.set_routes(r);}).get();
-           server->set_routes([rb](routes& r){rb->set_api_doc(r);}).get();
+           set_routes(server);
            server->listen(socket_address{addr, port}).get();
 
            std::cout << "Triton HTTP server listening on " << addr << ":" << port << " ...\n";
-           engine().at_exit([&prometheus_server, server, pport] {
+
+           if (sport) {
+             shard_server->start("shards").get();
+             set_routes(shard_server);
+             shard_server->server().invoke_on_all([addr, sport] (http_server& http) {
+               listen_options options;
+               options.reuse_address = true;
+               options.lba = server_socket::load_balancing_algorithm::fixed;
+               options.fixed_cpu = this_shard_id();
+               return http.listen(socket_address{addr, static_cast<uint16_t>(sport + this_shard_id())}, options);
+             }).get();
+             std::cout << "Triton HTTP shard ports listening on " << addr << ":" << sport << "-" << sport + smp::count - 1 << " ...\n";
+           }
+
+           // Start the binary protocol on every core
+           uint16_t bport = config["binary_port"].as<uint16_t>();
+           uint16_t bsport = config["binary_shard_port"].as<uint16_t>();
+           auto binary = new seastar::sharded<Binary>();
+           if (bport || bsport) {
+             binary->start(std::ref(graph)).get();
+           }
+           if (bport) {
+             binary->invoke_on_all(&Binary::listen, socket_address{addr, bport}, false).get();
+             std::cout << "Triton binary protocol listening on " << addr << ":" << bport << " ...\n";
+           }
+           if (bsport) {
+             binary->invoke_on_all([addr, bsport] (Binary& local_binary) {
+               return local_binary.listen(socket_address{addr, static_cast<uint16_t>(bsport + this_shard_id())}, true);
+             }).get();
+             std::cout << "Triton binary protocol shard ports listening on " << addr << ":" << bsport << "-" << bsport + smp::count - 1 << " ...\n";
+           }
+
+           engine().at_exit([&prometheus_server, server, shard_server, sport, pport, binary, bport, bsport, replica, replica_of] {
                   return [pport, &prometheus_server] {
                          if (pport > 0) {
                            std::cout << "Stopping Prometheus server" << std::endl;
@@ -125,10 +284,29 @@ int main(int argc, char** argv) {
                   }().finally([server] {
                          std::cout << "Stopping HTTP server" << std::endl;
                          return server->stop();
+                  }).finally([shard_server, sport] {
+                         if (sport > 0) {
+                           std::cout << "Stopping HTTP shard ports" << std::endl;
+                           return shard_server->stop();
+                         }
+                         return make_ready_future<>();
+                  }).finally([binary, bport, bsport] {
+                         if (bport > 0 || bsport > 0) {
+                           std::cout << "Stopping binary protocol" << std::endl;
+                           return binary->stop();
+                         }
+                         return make_ready_future<>();
+                  }).finally([replica, replica_of] {
+                         if (!replica_of.empty()) {
+                           std::cout << "Stopping replica" << std::endl;
+                           return replica->stop();
+                         }
+                         return make_ready_future<>();
                   });
            });
 
            stop_signal.wait().get();
+           graphs.stop().get();
 
     });
   });
@@ -0,0 +1,53 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "JSON.h"
+#include "Aggregates.h"
+
+void Aggregates::set_routes(routes &routes) {
+
+  auto postAggregate = new match_rule(Server::timed(graph, "POST /aggregate", &postAggregateHandler));
+  postAggregate->add_str("/db/" + graph.GetName() + "/aggregate");
+  routes.add(postAggregate, operation_type::POST);
+
+}
+
+future<std::unique_ptr<reply>> Aggregates::PostAggregateHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  // If the query is missing
+  if (req->content.empty()) {
+    rep->write_body("json", std::move(json::stream_object("Empty aggregate")));
+    rep->set_status(reply::status_type::bad_request);
+    return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+  }
+
+  std::string body = req->content;
+  return parent.graph.shard.local().NodesAggregatePeered(body)
+    .then([rep = std::move(rep)] (const Aggregate& aggregate) mutable {
+           std::map<std::string, std::any> values;
+           values.emplace("count", static_cast<int64_t>(aggregate.count));
+           // Min and max only mean something once a value was seen
+           if (aggregate.count > 0) {
+             values.emplace("sum", aggregate.sum);
+             values.emplace("min", aggregate.min);
+             values.emplace("max", aggregate.max);
+             values.emplace("average", aggregate.average());
+           }
+           json_properties_builder json;
+           json.add_properties(values);
+           rep->write_body("json", sstring(json.as_json()));
+           return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+    });
+}
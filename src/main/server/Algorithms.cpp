@@ -0,0 +1,52 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "JSON.h"
+#include "Algorithms.h"
+
+void Algorithms::set_routes(routes &routes) {
+
+  auto postAlgorithm = new match_rule(Server::timed(graph, "POST /algorithms/{name}", &postAlgorithmHandler));
+  postAlgorithm->add_str("/db/" + graph.GetName() + "/algorithms");
+  postAlgorithm->add_param("name");
+  routes.add(postAlgorithm, operation_type::POST);
+
+}
+
+future<std::unique_ptr<reply>> Algorithms::PostAlgorithmHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  std::string name = req->param["name"];
+  if (name != "pagerank" && name != "bfs" && name != "wcc" && name != "triangles" && name != "clustering") {
+    rep->write_body("json", std::move(json::stream_object("Invalid algorithm")));
+    rep->set_status(reply::status_type::bad_request);
+    return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+  }
+
+  std::string body = req->content;
+  return parent.graph.shard.local().AlgorithmPeered(name, body)
+    .then([rep = std::move(rep), name, this] (const std::vector<std::pair<uint64_t, double>>& results) mutable {
+           json_entities_builder json(parent.graph);
+           for(const auto& [id, value] : results) {
+             // Distances, components and triangles are whole numbers
+             if (name == "pagerank" || name == "clustering") {
+               json.add_result(id, value);
+             } else {
+               json.add_result(id, static_cast<int64_t>(value));
+             }
+           }
+           rep->write_body("json", sstring(json.as_json()));
+           return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+    });
+}
@@ -0,0 +1,348 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Binary.h"
+
+#include <seastar/core/future-util.hh>
+
+namespace {
+  const std::string EXCEPTION = "An exception has occurred: ";
+
+  std::string status(Binary::Status status) {
+    std::string result;
+    Serializer(result).put(static_cast<uint8_t>(status));
+    return result;
+  }
+
+  template <typename T>
+  std::string status(Binary::Status status, const T &value) {
+    std::string result;
+    Serializer serializer(result);
+    serializer.put(static_cast<uint8_t>(status));
+    serializer.put(value);
+    return result;
+  }
+
+  template <typename T>
+  std::string ok(const T &value) {
+    return status(Binary::OK, value);
+  }
+}
+
+seastar::future<> Binary::listen(seastar::socket_address address, bool fixed) {
+  seastar::listen_options options;
+  options.reuse_address = true;
+  if (fixed) {
+    options.lba = seastar::server_socket::load_balancing_algorithm::fixed;
+    options.fixed_cpu = seastar::this_shard_id();
+  }
+  auto listener = seastar::make_lw_shared<seastar::server_socket>(seastar::listen(address, options));
+  listeners.push_back(listener);
+
+  (void)seastar::keep_doing([this, listener] {
+    return listener->accept().then([this] (seastar::accept_result accepted) {
+      (void)seastar::with_gate(connections, [this, socket = std::move(accepted.connection)] () mutable {
+        return handle(std::move(socket)).handle_exception([] (std::exception_ptr) {});
+      });
+    });
+  }).handle_exception([] (std::exception_ptr) {
+    // The listener was aborted on stop
+  });
+  return seastar::make_ready_future<>();
+}
+
+seastar::future<> Binary::stop() {
+  for (auto& listener : listeners) {
+    listener->abort_accept();
+  }
+  return connections.close();
+}
+
+seastar::future<> Binary::handle(seastar::connected_socket socket) {
+  auto connection = seastar::make_lw_shared<Connection>(std::move(socket));
+
+  return seastar::repeat([this, connection] {
+    // Stop reading once too many requests of this connection are waiting for their reply
+    return seastar::get_units(connection->requests, 1).then([this, connection] (auto units) {
+      return connection->in.read_exactly(HEADER_SIZE).then([this, connection, units = std::move(units)] (seastar::temporary_buffer<char> header) mutable {
+        if (header.size() < HEADER_SIZE) {
+          return seastar::make_ready_future<seastar::stop_iteration>(seastar::stop_iteration::yes);
+        }
+        Deserializer reader(header.get(), header.size());
+        uint32_t size = reader.getUint32();
+        if (size <= sizeof(uint32_t) || size > MAX_FRAME_SIZE) {
+          return seastar::make_ready_future<seastar::stop_iteration>(seastar::stop_iteration::yes);
+        }
+
+        return connection->in.read_exactly(size).then([this, connection, size, units = std::move(units)] (seastar::temporary_buffer<char> frame) mutable {
+          if (frame.size() < size) {
+            return seastar::stop_iteration::yes;
+          }
+          // The next frame is read while this one runs
+          (void)seastar::with_gate(connection->pending, [this, connection, frame = std::move(frame), units = std::move(units)] () mutable {
+            return process(std::move(frame)).then([connection, units = std::move(units)] (std::string result) mutable {
+              return seastar::with_semaphore(connection->write_lock, 1, [connection, result = std::move(result)] {
+                return connection->out.write(result).then([connection] {
+                  return connection->out.flush();
+                });
+              });
+            }).handle_exception([] (std::exception_ptr) {
+              // The client went away before its reply
+            });
+          });
+          return seastar::stop_iteration::no;
+        });
+      });
+    });
+  }).then([connection] {
+    return connection->pending.close();
+  }).finally([connection] {
+    return connection->out.close();
+  });
+}
+
+seastar::future<std::string> Binary::process(seastar::temporary_buffer<char> frame) {
+  Deserializer reader(frame.get(), frame.size());
+  uint32_t request_id = reader.getUint32();
+  auto operation = static_cast<Operation>(reader.getUint8());
+  if (reader.failed()) {
+    return seastar::make_ready_future<std::string>(reply(request_id, INVALID));
+  }
+
+  // The arguments are read before process returns, so the frame can go away with this call
+  return seastar::futurize_invoke([this, operation, &reader] {
+           return process(operation, reader);
+    })
+    .then([request_id] (const std::string& result) {
+           return std::string(reply(request_id, static_cast<Status>(result[0]), result.substr(1)));
+    })
+    .handle_exception([request_id] (std::exception_ptr) {
+           return reply(request_id, INVALID);
+    });
+}
+
+seastar::future<std::string> Binary::process(Operation operation, Deserializer &reader) {
+  Shard &shard = graph.shard.local();
+  // Replicas only change through the records of their primary
+  if (shard.IsReadOnly() && (operation == NODE_ADD || operation == NODE_REMOVE_BY_ID || operation == NODE_PROPERTIES_SET_BY_ID)) {
+    return seastar::make_ready_future<std::string>(status(INVALID));
+  }
+  // Removing a node gives memory back, so only adding and setting stop at the soft limit
+  if ((operation == NODE_ADD || operation == NODE_PROPERTIES_SET_BY_ID) && shard.MemoryRejects(Shard::MEMORY_SOFT)) {
+    return seastar::make_ready_future<std::string>(status(INVALID));
+  }
+  // Scripts stop at the hard limit, the same as POST /lua
+  if (operation == LUA_RUN && shard.MemoryRejects(Shard::MEMORY_HARD)) {
+    return seastar::make_ready_future<std::string>(status(INVALID));
+  }
+
+  switch (operation) {
+    case NODE_GET_ID: {
+      std::string type = reader.getString();
+      std::string key = reader.getString();
+      if (reader.failed()) {
+        break;
+      }
+      return shard.NodeGetIDPeered(type, key).then([] (uint64_t id) {
+        return id > 0 ? ok(id) : status(NOT_FOUND);
+      });
+    }
+    case NODE_GET:
+    case NODE_GET_BY_ID: {
+      seastar::future<Node> found = seastar::make_ready_future<Node>();
+      if (operation == NODE_GET) {
+        std::string type = reader.getString();
+        std::string key = reader.getString();
+        if (reader.failed()) {
+          break;
+        }
+        found = shard.NodeGetPeered(type, key);
+      } else {
+        uint64_t id = reader.getUint64();
+        if (reader.failed()) {
+          break;
+        }
+        found = shard.NodeGetPeered(id);
+      }
+      return found.then([this] (Node node) {
+        if (node.getId() == 0) {
+          return status(NOT_FOUND);
+        }
+        std::string result = status(OK);
+        Serializer serializer(result);
+        put(serializer, node, graph.shard.local().NodeTypeGetType(node.getTypeId()));
+        return result;
+      });
+    }
+    case NODE_ADD: {
+      std::string type = reader.getString();
+      std::string key = reader.getString();
+      std::map<std::string, std::any> properties = reader.getProperties();
+      if (reader.failed()) {
+        break;
+      }
+      std::vector<std::tuple<std::string, std::string, std::map<std::string, std::any>>> rows;
+      rows.emplace_back(type, key, std::move(properties));
+      return shard.NodesAddPeered(std::move(rows)).then([] (const std::vector<uint64_t>& ids) {
+        return !ids.empty() && ids.front() > 0 ? ok(ids.front()) : status(INVALID);
+      });
+    }
+    case NODE_REMOVE_BY_ID: {
+      uint64_t id = reader.getUint64();
+      if (reader.failed()) {
+        break;
+      }
+      return shard.NodeRemovePeered(id).then([] (bool removed) {
+        return ok(removed);
+      });
+    }
+    case NODE_PROPERTY_GET_BY_ID: {
+      uint64_t id = reader.getUint64();
+      std::string property = reader.getString();
+      if (reader.failed()) {
+        break;
+      }
+      return shard.NodePropertyGetPeered(id, property).then([] (const std::any& value) {
+        return value.has_value() ? ok(value) : status(NOT_FOUND);
+      });
+    }
+    case NODE_PROPERTIES_GET_BY_ID: {
+      uint64_t id = reader.getUint64();
+      if (reader.failed()) {
+        break;
+      }
+      return shard.NodePropertiesGetPeered(id).then([] (const std::map<std::string, std::any>& properties) {
+        return ok(properties);
+      });
+    }
+    case NODE_PROPERTIES_SET_BY_ID: {
+      uint64_t id = reader.getUint64();
+      std::map<std::string, std::any> properties = reader.getProperties();
+      if (reader.failed()) {
+        break;
+      }
+      return seastar::do_with(std::move(properties), [&shard, id] (std::map<std::string, std::any>& values) {
+        return shard.NodePropertiesSetPeered(id, values).then([] (bool set) {
+          return ok(set);
+        });
+      });
+    }
+    case NODE_DEGREE_BY_ID:
+    case NODE_NEIGHBORS_BY_ID:
+    case NODE_NEIGHBOR_IDS_BY_ID: {
+      uint64_t id = reader.getUint64();
+      uint8_t direction = reader.getUint8();
+      std::vector<std::string> rel_types = getStrings(reader);
+      if (reader.failed() || direction > OUT) {
+        break;
+      }
+      auto node_direction = static_cast<Direction>(direction);
+      if (operation == NODE_DEGREE_BY_ID) {
+        seastar::future<uint64_t> degree = rel_types.empty() ? shard.NodeGetDegreePeered(id, node_direction)
+                                                             : shard.NodeGetDegreePeered(id, node_direction, rel_types);
+        return degree.then([] (uint64_t count) {
+          return ok(count);
+        });
+      }
+      if (operation == NODE_NEIGHBOR_IDS_BY_ID) {
+        seastar::future<Roaring64Map> ids = rel_types.empty() ? shard.NodeGetNeighborIdsMapPeered(id, node_direction)
+                                                              : shard.NodeGetNeighborIdsMapPeered(id, node_direction, rel_types);
+        return ids.then([] (const Roaring64Map& neighbor_ids) {
+          return ok(neighbor_ids);
+        });
+      }
+      seastar::future<std::vector<Node>> neighbors = rel_types.empty() ? shard.NodeGetNeighborsPeered(id, node_direction)
+                                                                       : shard.NodeGetNeighborsPeered(id, node_direction, rel_types);
+      return neighbors.then([this] (std::vector<Node> nodes) {
+        std::string result = status(OK);
+        Serializer serializer(result);
+        serializer.put(static_cast<uint32_t>(nodes.size()));
+        uint16_t type_id = 0;
+        std::string type;
+        for (Node& node : nodes) {
+          if (node.getTypeId() != type_id || type.empty()) {
+            type_id = node.getTypeId();
+            type = graph.shard.local().NodeTypeGetType(type_id);
+          }
+          put(serializer, node, type);
+        }
+        return result;
+      });
+    }
+    case LUA_RUN: {
+      std::string script = reader.getString();
+      if (reader.failed()) {
+        break;
+      }
+      return shard.RunLua(script).then([] (const std::string& json) {
+        // Failed scripts send back their error message
+        return json.rfind(EXCEPTION, 0) == 0 ? status(INVALID, json) : ok(json);
+      });
+    }
+    case LOG_SNAPSHOT: {
+      uint8_t shard_id = reader.getUint8();
+      if (reader.failed() || shard_id >= seastar::smp::count) {
+        break;
+      }
+      return graph.shard.invoke_on(shard_id, [] (Shard &local_shard) {
+        // Replicas need as many cores as their primary, each one follows the same shard
+        std::string result = status(OK, static_cast<uint8_t>(seastar::smp::count));
+        Serializer serializer(result);
+        return local_shard.ReplicationSnapshot(serializer) ? result : status(NOT_FOUND);
+      });
+    }
+    case LOG_FOLLOW: {
+      uint8_t shard_id = reader.getUint8();
+      uint64_t sequence = reader.getUint64();
+      uint64_t max_bytes = reader.getUint64();
+      if (reader.failed() || shard_id >= seastar::smp::count) {
+        break;
+      }
+      return graph.shard.invoke_on(shard_id, [sequence, max_bytes] (Shard &local_shard) {
+        std::string result = status(OK);
+        Serializer serializer(result);
+        return local_shard.ReplicationRecords(sequence, max_bytes, serializer) ? result : status(NOT_FOUND);
+      });
+    }
+  }
+  return seastar::make_ready_future<std::string>(status(INVALID));
+}
+
+std::string Binary::reply(uint32_t request_id, Status status, const std::string &result) {
+  std::string frame;
+  Serializer serializer(frame);
+  serializer.put(static_cast<uint32_t>(sizeof(uint32_t) + sizeof(uint8_t) + result.size()));
+  serializer.put(request_id);
+  serializer.put(static_cast<uint8_t>(status));
+  frame.append(result);
+  return frame;
+}
+
+std::vector<std::string> Binary::getStrings(Deserializer &reader) {
+  std::vector<std::string> values;
+  uint16_t count = reader.getUint16();
+  for (uint16_t i = 0; i < count && !reader.failed(); i++) {
+    values.push_back(reader.getString());
+  }
+  return values;
+}
+
+void Binary::put(Serializer &serializer, Node &node, const std::string &type) {
+  serializer.put(node.getId());
+  serializer.put(type);
+  serializer.put(node.getKey());
+  serializer.put(node.getProperties());
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRITON_BINARY_H
+#define TRITON_BINARY_H
+
+#include <Graph.h>
+#include <Serializer.h>
+#include <seastar/core/gate.hh>
+#include <seastar/core/semaphore.hh>
+#include <seastar/core/shared_ptr.hh>
+#include <seastar/net/api.hh>
+
+using namespace triton;
+
+// Length prefixed binary frames over TCP, for callers that cannot afford HTTP parsing and JSON.
+// Requests are [uint32 size][uint32 request id][uint8 operation][arguments] and replies are
+// [uint32 size][uint32 request id][uint8 status][result], where size counts the bytes after it.
+// Arguments and results use the little endian encoding of the Serializer.
+// Several requests can be sent without waiting, replies carry the request id and come back as they finish.
+class Binary {
+public:
+  enum Operation : uint8_t {
+    NODE_GET_ID = 1,          // type, key -> id
+    NODE_GET,                 // type, key -> node
+    NODE_GET_BY_ID,           // id -> node
+    NODE_ADD,                 // type, key, properties -> id
+    NODE_REMOVE_BY_ID,        // id -> bool
+    NODE_PROPERTY_GET_BY_ID,  // id, property -> value
+    NODE_PROPERTIES_GET_BY_ID,// id -> properties
+    NODE_PROPERTIES_SET_BY_ID,// id, properties -> bool
+    NODE_DEGREE_BY_ID,        // id, direction, rel types -> degree
+    NODE_NEIGHBORS_BY_ID,     // id, direction, rel types -> nodes
+    NODE_NEIGHBOR_IDS_BY_ID,  // id, direction, rel types -> bitmap of ids
+    LUA_RUN,                  // script -> json
+    LOG_SNAPSHOT,             // shard -> cpus, sequence, 0, sections, NOT_FOUND when the shard keeps no records
+    LOG_FOLLOW                // shard, sequence, max bytes -> next sequence, count, records, NOT_FOUND when they are gone
+  };
+
+  enum Status : uint8_t { OK, NOT_FOUND, INVALID };
+
+  explicit Binary(Graph &graph) : graph(graph) {}
+
+  // Every core listens on the same port and serves the connections it accepts,
+  // or only on its own port when fixed, so clients can pick the core that holds their nodes
+  seastar::future<> listen(seastar::socket_address address, bool fixed = false);
+  seastar::future<> stop();
+
+private:
+  static const uint32_t HEADER_SIZE = 4;
+  static const uint32_t MAX_FRAME_SIZE = 16 * 1024 * 1024;
+  static const size_t MAX_PIPELINED = 128;
+
+  struct Connection {
+    explicit Connection(seastar::connected_socket socket) : socket(std::move(socket)), in(this->socket.input()), out(this->socket.output()) {}
+    seastar::connected_socket socket;
+    seastar::input_stream<char> in;
+    seastar::output_stream<char> out;
+    seastar::semaphore write_lock{1};
+    seastar::semaphore requests{MAX_PIPELINED};
+    seastar::gate pending;
+  };
+
+  Graph &graph;
+  std::vector<seastar::lw_shared_ptr<seastar::server_socket>> listeners;
+  seastar::gate connections;
+
+  seastar::future<> handle(seastar::connected_socket socket);
+  seastar::future<std::string> process(seastar::temporary_buffer<char> frame);
+  seastar::future<std::string> process(Operation operation, Deserializer &reader);
+
+  static std::string reply(uint32_t request_id, Status status, const std::string &result = std::string());
+  static std::vector<std::string> getStrings(Deserializer &reader);
+  static void put(Serializer &serializer, Node &node, const std::string &type);
+};
+
+#endif//TRITON_BINARY_H
@@ -18,7 +18,7 @@
 #include <boost/algorithm/string.hpp>
 
 void Degrees::set_routes(routes &routes) {
-  auto getDegree = new match_rule(&getDegreeHandler);
+  auto getDegree = new match_rule(Server::timed(graph, "GET /node/{type}/{key}/degree", &getDegreeHandler));
   getDegree->add_str("/db/" + graph.GetName() + "/node");
   getDegree->add_param("type");
   getDegree->add_param("key");
@@ -26,7 +26,7 @@ void Degrees::set_routes(routes &routes) {
   getDegree->add_param("options", true);
   routes.add(getDegree, operation_type::GET);
 
-  auto getDegreeById = new match_rule(&getDegreeByIdHandler);
+  auto getDegreeById = new match_rule(Server::timed(graph, "GET /node/{id}/degree", &getDegreeByIdHandler));
   getDegreeById->add_str("/db/" + graph.GetName() + "/node");
   getDegreeById->add_param("id");
   getDegreeById->add_str("/degree");
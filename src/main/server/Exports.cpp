@@ -0,0 +1,58 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Exports.h"
+
+void Exports::set_routes(routes &routes) {
+
+  auto postExport = new match_rule(Server::timed(graph, "POST /export", &postExportHandler));
+  postExport->add_str("/db/" + graph.GetName() + "/export");
+  routes.add(postExport, operation_type::POST);
+
+}
+
+future<std::unique_ptr<reply>> Exports::PostExportHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  // The files are written on the server, one pair per core
+  std::string directory = req->get_query_param("directory");
+  if (directory.empty()) {
+    rep->write_body("json", std::move(json::stream_object("Missing directory parameter")));
+    rep->set_status(reply::status_type::bad_request);
+    return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+  }
+
+  ExportFormat format = ExportFormat::CSV;
+  std::string format_param = req->get_query_param("format");
+  if (format_param == "binary") {
+    format = ExportFormat::BINARY;
+  } else if (!format_param.empty() && format_param != "csv") {
+    rep->write_body("json", std::move(json::stream_object("Invalid format parameter")));
+    rep->set_status(reply::status_type::bad_request);
+    return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+  }
+
+  return parent.graph.shard.local().ExportPeered(directory, format)
+    .then_wrapped([rep = std::move(rep)] (future<std::pair<uint64_t, uint64_t>> exported) mutable {
+           try {
+             auto [nodes, relationships] = exported.get0();
+             rep->write_body("json", sstring("{\"nodes\": " + std::to_string(nodes) + ", \"relationships\": " + std::to_string(relationships) + "}"));
+           } catch (const std::exception &e) {
+             // A directory that cannot be written to, or a disk that filled up
+             rep->write_body("json", std::move(json::stream_object("Export failed: " + std::string(e.what()))));
+             rep->set_status(reply::status_type::internal_server_error);
+           }
+           return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+    });
+}
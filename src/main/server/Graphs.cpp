@@ -0,0 +1,254 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "JSON.h"
+#include "Graphs.h"
+#include <algorithm>
+#include <cctype>
+
+void GraphRoutes::set_routes(routes &routes) {
+  relationshipProperties.set_routes(routes);
+  nodeProperties.set_routes(routes);
+  degrees.set_routes(routes);
+  neighbors.set_routes(routes);
+  nodes.set_routes(routes);
+  relationships.set_routes(routes);
+  lua.set_routes(routes);
+  import.set_routes(routes);
+  snapshots.set_routes(routes);
+  views.set_routes(routes);
+  exports.set_routes(routes);
+  traversals.set_routes(routes);
+  algorithms.set_routes(routes);
+  paths.set_routes(routes);
+  indexes.set_routes(routes);
+  recents.set_routes(routes);
+  aggregates.set_routes(routes);
+  vectors.set_routes(routes);
+  multiGets.set_routes(routes);
+  replication.set_routes(routes);
+  stats.set_routes(routes);
+}
+
+void Graphs::set_routes(routes &routes) {
+
+  auto getGraphs = new match_rule(&getGraphsHandler);
+  getGraphs->add_str("/db");
+  routes.add(getGraphs, operation_type::GET);
+
+  auto postGraph = new match_rule(&postGraphHandler);
+  postGraph->add_str("/db");
+  postGraph->add_param("graph");
+  routes.add(postGraph, operation_type::POST);
+
+  auto deleteGraph = new match_rule(&deleteGraphHandler);
+  deleteGraph->add_str("/db");
+  deleteGraph->add_param("graph");
+  routes.add(deleteGraph, operation_type::DELETE);
+
+}
+
+bool Graphs::validate_name(const std::string &name) {
+  // The name becomes part of every route and metric of the graph
+  return !name.empty() && name.size() <= 64 && std::all_of(name.begin(), name.end(), [] (char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '-';
+  });
+}
+
+bool Graphs::validate_options(std::unique_ptr<request> &req, std::unique_ptr<reply> &rep, GraphOptions &options) {
+  try {
+    std::string lua_vms = req->get_query_param("lua_vms");
+    if (!lua_vms.empty()) {
+      options.lua_vms = static_cast<uint8_t>(std::clamp(std::stoull(lua_vms), 1ULL, 255ULL));
+    }
+    std::string shares = req->get_query_param("shares");
+    if (!shares.empty()) {
+      options.shares = static_cast<uint16_t>(std::min(std::stoull(shares), 1000ULL));
+    }
+    std::string memory_soft_limit = req->get_query_param("memory_soft_limit");
+    if (!memory_soft_limit.empty()) {
+      options.memory_soft_limit = std::stoull(memory_soft_limit);
+    }
+    std::string memory_hard_limit = req->get_query_param("memory_hard_limit");
+    if (!memory_hard_limit.empty()) {
+      options.memory_hard_limit = std::stoull(memory_hard_limit);
+    }
+  } catch (std::exception& e) {
+    rep->write_body("json", std::move(json::stream_object("Invalid graph options")));
+    rep->set_status(reply::status_type::bad_request);
+    return false;
+  }
+  return true;
+}
+
+future<bool> Graphs::create(const std::string &name, GraphOptions options) {
+  Tenant &tenant = tenants[name];
+  if (tenant.changing || (tenant.graph && tenant.graph->Running())) {
+    return make_ready_future<bool>(false);
+  }
+  tenant.changing = true;
+  if (!tenant.graph) {
+    tenant.graph = std::make_unique<Graph>(name);
+  }
+
+  // Scheduling groups are few and cannot be given back, so a graph keeps its own across drops
+  future<> grouped = make_ready_future<>();
+  if (options.shares > 0 && tenant.own_group) {
+    tenant.group.set_shares(options.shares);
+  } else if (options.shares > 0) {
+    grouped = seastar::create_scheduling_group("graph_" + name, options.shares).then([&tenant] (seastar::scheduling_group group) {
+      tenant.group = group;
+      tenant.own_group = true;
+    });
+  }
+
+  return grouped.then([&tenant, options] {
+    return tenant.graph->start(options.lua_vms, options.shares > 0 ? tenant.group : seastar::default_scheduling_group());
+  }).then([&tenant, options, this] {
+    // The core is shared with other graphs, so the limits hold the graph to what it is estimated to use
+    return tenant.graph->shard.invoke_on_all([options, this] (Shard &local_shard) {
+      if (options.memory_soft_limit > 0 || options.memory_hard_limit > 0) {
+        local_shard.MemoryLimits(options.memory_soft_limit, options.memory_hard_limit, config.memory_check_interval, true);
+      }
+      local_shard.TraceLimits(config.slow_query_threshold, config.slow_query_sample, config.trace_sample);
+      if (config.compaction_interval > 0) {
+        local_shard.CompactionStart(config.compaction_group, config.compaction_interval, config.compaction_nodes, config.compaction_release_capacity);
+      }
+    });
+  }).then([&tenant, this] {
+    if (tenant.graph_routes) {
+      return make_ready_future<>();
+    }
+    tenant.graph_routes = std::make_unique<GraphRoutes>(*tenant.graph);
+    GraphRoutes *graph_routes = tenant.graph_routes.get();
+    return parallel_for_each(servers, [graph_routes] (http_server_control *server) {
+      return server->set_routes([graph_routes] (routes &r) { graph_routes->set_routes(r); });
+    });
+  }).then([] {
+    return true;
+  }).finally([&tenant] {
+    tenant.changing = false;
+  });
+}
+
+future<bool> Graphs::drop(const std::string &name) {
+  auto search = tenants.find(name);
+  if (search == std::end(tenants) || search->second.changing || !search->second.graph->Running()) {
+    return make_ready_future<bool>(false);
+  }
+  Tenant &tenant = search->second;
+  tenant.changing = true;
+  // Its nodes and relationships only ever lived in memory
+  return tenant.graph->stop().then([] {
+    return true;
+  }).finally([&tenant] {
+    tenant.changing = false;
+  });
+}
+
+std::vector<std::string> Graphs::names() {
+  std::vector<std::string> running = {graph.GetName()};
+  for (const auto &[name, tenant] : tenants) {
+    if (tenant.graph && tenant.graph->Running()) {
+      running.push_back(name);
+    }
+  }
+  return running;
+}
+
+future<> Graphs::stop() {
+  return parallel_for_each(tenants, [] (auto &entry) {
+    Tenant &tenant = entry.second;
+    if (!tenant.graph || !tenant.graph->Running()) {
+      return make_ready_future<>();
+    }
+    return tenant.graph->stop();
+  });
+}
+
+future<std::unique_ptr<reply>> Graphs::GetGraphsHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  return smp::submit_to(0, [this] {
+    return parent.names();
+  }).then([rep = std::move(rep)] (const std::vector<std::string>& names) mutable {
+    json_values_builder json;
+    for (const auto &name : names) {
+      json.add_value(name);
+    }
+    rep->write_body("json", sstring(json.as_json()));
+    return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+  });
+}
+
+future<std::unique_ptr<reply>> Graphs::PostGraphHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  std::string name = req->param["graph"];
+  if (!validate_name(name)) {
+    rep->write_body("json", std::move(json::stream_object("Invalid graph name")));
+    rep->set_status(reply::status_type::bad_request);
+    return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+  }
+  GraphOptions options;
+  if (!validate_options(req, rep, options)) {
+    return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+  }
+  if (name == parent.graph.GetName()) {
+    rep->write_body("json", std::move(json::stream_object("Graph already exists")));
+    rep->set_status(reply::status_type::bad_request);
+    return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+  }
+
+  // Every graph is created and dropped on core 0, one change to a graph at a time
+  return smp::submit_to(0, [name, options, this] {
+    return parent.create(name, options);
+  }).then_wrapped([rep = std::move(rep), name] (future<bool> created) mutable {
+    try {
+      if (created.get0()) {
+        rep->write_body("json", std::move(json::stream_object(name)));
+        rep->set_status(reply::status_type::created);
+      } else {
+        rep->write_body("json", std::move(json::stream_object("Graph already exists")));
+        rep->set_status(reply::status_type::bad_request);
+      }
+    } catch (const std::exception &e) {
+      // Seastar only has room for a few scheduling groups
+      rep->write_body("json", std::move(json::stream_object("Graph could not be created: " + std::string(e.what()))));
+      rep->set_status(reply::status_type::internal_server_error);
+    }
+    return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+  });
+}
+
+future<std::unique_ptr<reply>> Graphs::DeleteGraphHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  std::string name = req->param["graph"];
+  if (name == parent.graph.GetName()) {
+    // The binary protocol, replication and the command log only know the graph the server started with
+    rep->write_body("json", std::move(json::stream_object("The default graph cannot be dropped")));
+    rep->set_status(reply::status_type::bad_request);
+    return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+  }
+
+  return smp::submit_to(0, [name, this] {
+    return parent.drop(name);
+  }).then([rep = std::move(rep)] (bool dropped) mutable {
+    if (dropped) {
+      rep->write_body("json", std::move(json::stream_object(dropped)));
+    } else {
+      rep->write_body("json", std::move(json::stream_object("Graph not found")));
+      rep->set_status(reply::status_type::not_found);
+    }
+    return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+  });
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef TRITON_GRAPHS_H
+#define TRITON_GRAPHS_H
+
+#include "Aggregates.h"
+#include "Algorithms.h"
+#include "Degrees.h"
+#include "Exports.h"
+#include "Import.h"
+#include "Indexes.h"
+#include "Lua.h"
+#include "MultiGets.h"
+#include "Neighbors.h"
+#include "NodeProperties.h"
+#include "Nodes.h"
+#include "Paths.h"
+#include "Recents.h"
+#include "RelationshipProperties.h"
+#include "Relationships.h"
+#include "Replication.h"
+#include "Server.h"
+#include "Snapshots.h"
+#include "Stats.h"
+#include "Traversals.h"
+#include "Vectors.h"
+#include "Views.h"
+#include <Graph.h>
+#include <map>
+#include <memory>
+#include <seastar/http/httpd.hh>
+
+using namespace seastar;
+using namespace httpd;
+using namespace triton;
+
+// Every route of a graph under /db/{graph}, built once for each graph name and kept while the server runs
+class GraphRoutes {
+public:
+  explicit GraphRoutes(Graph &graph) : nodes(graph), relationships(graph), degrees(graph), neighbors(graph), nodeProperties(graph),
+                                       relationshipProperties(graph), lua(graph), import(graph), snapshots(graph), views(graph), exports(graph),
+                                       traversals(graph), algorithms(graph), paths(graph), indexes(graph), recents(graph), aggregates(graph), vectors(graph), multiGets(graph),
+                                       replication(graph), stats(graph) {}
+  void set_routes(routes& routes);
+
+private:
+  Nodes nodes;
+  Relationships relationships;
+  Degrees degrees;
+  Neighbors neighbors;
+  NodeProperties nodeProperties;
+  RelationshipProperties relationshipProperties;
+  Lua lua;
+  Import import;
+  Snapshots snapshots;
+  Views views;
+  Exports exports;
+  Traversals traversals;
+  Algorithms algorithms;
+  Paths paths;
+  Indexes indexes;
+  Recents recents;
+  Aggregates aggregates;
+  Vectors vectors;
+  MultiGets multiGets;
+  Replication replication;
+  Stats stats;
+};
+
+// How the graphs created at runtime run, the same for all of them
+struct GraphsConfig {
+  uint64_t memory_check_interval = 100;
+  seastar::scheduling_group compaction_group = seastar::default_scheduling_group();
+  uint64_t compaction_interval = 0;// Milliseconds between compaction slices, zero for none
+  uint64_t compaction_nodes = 4096;
+  bool compaction_release_capacity = false;
+  uint64_t slow_query_threshold = 0;// Microseconds, zero keeps no slow query log
+  uint64_t slow_query_sample = 1;
+  uint64_t trace_sample = 0;
+};
+
+// Graphs created and dropped at runtime, each with its own shards on every core, next to the graph the server started with
+class Graphs {
+
+  class GetGraphsHandler : public httpd::handler_base {
+  public:
+    explicit GetGraphsHandler(Graphs& graphs) : parent(graphs) {};
+
+  private:
+    Graphs& parent;
+    future<std::unique_ptr<reply>> handle(const sstring& path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) override;
+  };
+
+  class PostGraphHandler : public httpd::handler_base {
+  public:
+    explicit PostGraphHandler(Graphs& graphs) : parent(graphs) {};
+
+  private:
+    Graphs& parent;
+    future<std::unique_ptr<reply>> handle(const sstring& path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) override;
+  };
+
+  class DeleteGraphHandler : public httpd::handler_base {
+  public:
+    explicit DeleteGraphHandler(Graphs& graphs) : parent(graphs) {};
+
+  private:
+    Graphs& parent;
+    future<std::unique_ptr<reply>> handle(const sstring& path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) override;
+  };
+
+  // A stopped graph keeps its shards container, routes and scheduling group, so it can be created again under the same name
+  struct Tenant {
+    std::unique_ptr<Graph> graph;
+    std::unique_ptr<GraphRoutes> graph_routes;
+    seastar::scheduling_group group = seastar::default_scheduling_group();
+    bool own_group = false;
+    bool changing = false;// Being created or dropped
+  };
+
+  struct GraphOptions {
+    uint8_t lua_vms = 4;
+    uint16_t shares = 0;// Scheduler shares against the other graphs, zero to share the default group
+    uint64_t memory_soft_limit = 0;// Estimated bytes of a shard of the graph past which writes are turned away
+    uint64_t memory_hard_limit = 0;
+  };
+
+private:
+  Graph& graph;
+  std::vector<http_server_control*> servers;// Servers the routes of new graphs are added to
+  GraphsConfig config;
+  std::map<std::string, Tenant> tenants;// Only touched on core 0
+  GetGraphsHandler getGraphsHandler;
+  PostGraphHandler postGraphHandler;
+  DeleteGraphHandler deleteGraphHandler;
+
+  static bool validate_name(const std::string& name);
+  static bool validate_options(std::unique_ptr<request> &req, std::unique_ptr<reply> &rep, GraphOptions &options);
+  future<bool> create(const std::string& name, GraphOptions options);
+  future<bool> drop(const std::string& name);
+  std::vector<std::string> names();
+
+public:
+  Graphs(Graph &graph, std::vector<http_server_control*> servers, GraphsConfig config) : graph(graph), servers(std::move(servers)), config(config),
+                                                                                         getGraphsHandler(*this), postGraphHandler(*this), deleteGraphHandler(*this) {}
+  void set_routes(routes& routes);
+  // Stops every graph created at runtime, the graph the server started with stops on its own
+  future<> stop();
+};
+
+
+#endif//TRITON_GRAPHS_H
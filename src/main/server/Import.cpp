@@ -0,0 +1,65 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Import.h"
+
+void Import::set_routes(routes &routes) {
+
+  auto postNodesImport = new match_rule(Server::timed(graph, "POST /import/nodes", &postNodesImportHandler));
+  postNodesImport->add_str("/db/" + graph.GetName() + "/import/nodes");
+  routes.add(postNodesImport, operation_type::POST);
+
+  auto postRelationshipsImport = new match_rule(Server::timed(graph, "POST /import/relationships", &postRelationshipsImportHandler));
+  postRelationshipsImport->add_str("/db/" + graph.GetName() + "/import/relationships");
+  routes.add(postRelationshipsImport, operation_type::POST);
+
+}
+
+future<std::unique_ptr<reply>> Import::PostNodesImportHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  // If the csv is missing
+  if (req->content.empty()) {
+    rep->write_body("json", std::move(json::stream_object("Empty csv")));
+    rep->set_status(reply::status_type::bad_request);
+  } else {
+    std::string body = req->content;
+
+    return parent.graph.shard.local().NodesImportCsvPeered(std::move(body))
+      .then([rep = std::move(rep)] (uint64_t count) mutable {
+             rep->write_body("json", std::move(json::stream_object(count)));
+             return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+      });
+  }
+
+  return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+}
+
+future<std::unique_ptr<reply>> Import::PostRelationshipsImportHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  // If the csv is missing
+  if (req->content.empty()) {
+    rep->write_body("json", std::move(json::stream_object("Empty csv")));
+    rep->set_status(reply::status_type::bad_request);
+  } else {
+    std::string body = req->content;
+
+    return parent.graph.shard.local().RelationshipsImportCsvPeered(std::move(body))
+      .then([rep = std::move(rep)] (uint64_t count) mutable {
+             rep->write_body("json", std::move(json::stream_object(count)));
+             return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+      });
+  }
+
+  return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+}
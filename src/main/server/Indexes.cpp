@@ -0,0 +1,138 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Indexes.h"
+#include "JSON.h"
+
+void Indexes::set_routes(routes &routes) {
+
+  auto getIndexes = new match_rule(Server::timed(graph, "GET /indexes/{type}", &getIndexesHandler));
+  getIndexes->add_str("/db/" + graph.GetName() + "/indexes");
+  getIndexes->add_param("type");
+  routes.add(getIndexes, operation_type::GET);
+
+  auto getIndex = new match_rule(Server::timed(graph, "GET /index/{type}/{property}", &getIndexHandler));
+  getIndex->add_str("/db/" + graph.GetName() + "/index");
+  getIndex->add_param("type");
+  getIndex->add_param("property");
+  routes.add(getIndex, operation_type::GET);
+
+  auto postIndex = new match_rule(Server::timed(graph, "POST /index/{type}/{property}", &postIndexHandler));
+  postIndex->add_str("/db/" + graph.GetName() + "/index");
+  postIndex->add_param("type");
+  postIndex->add_param("property");
+  routes.add(postIndex, operation_type::POST);
+
+  auto deleteIndex = new match_rule(Server::timed(graph, "DELETE /index/{type}/{property}", &deleteIndexHandler));
+  deleteIndex->add_str("/db/" + graph.GetName() + "/index");
+  deleteIndex->add_param("type");
+  deleteIndex->add_param("property");
+  routes.add(deleteIndex, operation_type::DELETE);
+
+}
+
+future<std::unique_ptr<reply>> Indexes::GetIndexesHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  bool valid_type = Server::validate_parameter(Server::TYPE, req, rep, "Invalid type");
+
+  if (valid_type) {
+    // Every shard has the same indexes
+    std::map<std::string, std::any> index_types;
+    for (const auto &[property, index_type] : parent.graph.shard.local().NodePropertyIndexesGet(req->param[Server::TYPE])) {
+      index_types.emplace(property, std::string(index_type == PropertyIndex::SORTED ? "sorted" : "hash"));
+    }
+    json_properties_builder json;
+    json.add_properties(index_types);
+    rep->write_body("json", sstring(json.as_json()));
+  }
+  return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+}
+
+future<std::unique_ptr<reply>> Indexes::GetIndexHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  bool valid_type = Server::validate_parameter(Server::TYPE, req, rep, "Invalid type");
+  bool valid_property = Server::validate_parameter(Server::PROPERTY, req, rep, "Invalid property");
+
+  if (valid_type && valid_property) {
+    NodeProjection projection = Server::validate_projection(req);
+    sstring value = req->get_query_param("value");
+    sstring min = req->get_query_param("min");
+    sstring max = req->get_query_param("max");
+
+    future<Roaring64Map> found = make_ready_future<Roaring64Map>();
+    if (!value.empty()) {
+      found = parent.graph.shard.local().NodePropertyIndexFindPeered(req->param[Server::TYPE], req->param[Server::PROPERTY],
+                                                                      Server::convert_parameter_to_property(value));
+    } else if (!min.empty() && !max.empty()) {
+      found = parent.graph.shard.local().NodePropertyIndexFindRangePeered(req->param[Server::TYPE], req->param[Server::PROPERTY],
+                                                                           Server::convert_parameter_to_property(min),
+                                                                           Server::convert_parameter_to_property(max));
+    } else {
+      rep->write_body("json", std::move(json::stream_object("Missing value or min and max")));
+      rep->set_status(reply::status_type::bad_request);
+      return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+    }
+
+    return found.then([projection, this] (const Roaring64Map& ids) {
+             return parent.graph.shard.local().NodesGetPeered(ids, projection);
+      })
+      .then([rep = std::move(rep), this] (std::vector<Node> nodes) mutable {
+             json_entities_builder json(parent.graph, nodes.size());
+             for(Node& n : nodes) {
+               json.add(n);
+             }
+             rep->write_body("json", sstring(json.as_json()));
+             return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+      });
+  }
+  return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+}
+
+future<std::unique_ptr<reply>> Indexes::PostIndexHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  bool valid_type = Server::validate_parameter(Server::TYPE, req, rep, "Invalid type");
+  bool valid_property = Server::validate_parameter(Server::PROPERTY, req, rep, "Invalid property");
+
+  if (valid_type && valid_property) {
+    PropertyIndex::IndexType index_type = req->get_query_param("kind") == "sorted" ? PropertyIndex::SORTED : PropertyIndex::HASH;
+    return parent.graph.shard.local().NodePropertyIndexCreatePeered(req->param[Server::TYPE], req->param[Server::PROPERTY], index_type)
+      .then([rep = std::move(rep)] (bool created) mutable {
+             if (created) {
+               rep->set_status(reply::status_type::created);
+             } else {
+               rep->write_body("json", std::move(json::stream_object("Invalid type or the index exists with another kind")));
+               rep->set_status(reply::status_type::bad_request);
+             }
+             return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+      });
+  }
+  return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+}
+
+future<std::unique_ptr<reply>> Indexes::DeleteIndexHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  bool valid_type = Server::validate_parameter(Server::TYPE, req, rep, "Invalid type");
+  bool valid_property = Server::validate_parameter(Server::PROPERTY, req, rep, "Invalid property");
+
+  if (valid_type && valid_property) {
+    return parent.graph.shard.local().NodePropertyIndexDropPeered(req->param[Server::TYPE], req->param[Server::PROPERTY])
+      .then([rep = std::move(rep)] (bool dropped) mutable {
+             if (dropped) {
+               rep->set_status(reply::status_type::no_content);
+             } else {
+               rep->set_status(reply::status_type::not_modified);
+             }
+             return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+      });
+  }
+  return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+}
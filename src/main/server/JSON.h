@@ -17,6 +17,7 @@
 #ifndef TRITON_JSON_H
 #define TRITON_JSON_H
 
+#include <charconv>
 #include <Graph.h>
 #include <Node.h>
 #include <seastar/core/print.hh>
@@ -277,6 +278,240 @@ private:
 
 };
 
+// Writes nodes and relationships straight from their properties into one string,
+// without building a property map and json elements for each of them
+class json_entities_builder {
+public:
+  explicit json_entities_builder(Graph& graph, size_t count = 0) : graph(graph) {
+    result.reserve(2 + count * RESERVE_PER_ENTITY);
+    result.push_back(OPEN_ARRAY);
+  }
+
+  void add(const Node& node) {
+    if (node.getTypeId() != node_type_id || node_type.empty()) {
+      node_type_id = node.getTypeId();
+      node_type = graph.shard.local().NodeTypeGetType(node_type_id);
+    }
+    add(node, node_type);
+  }
+
+  void add(const Node& node, const std::string& type) {
+    separate();
+    append(result, node, type);
+  }
+
+  void add(const Relationship& relationship) {
+    if (relationship.getTypeId() != relationship_type_id || relationship_type.empty()) {
+      relationship_type_id = relationship.getTypeId();
+      relationship_type = graph.shard.local().RelationshipTypeGetType(relationship_type_id);
+    }
+    add(relationship, relationship_type);
+  }
+
+  void add(const Relationship& relationship, const std::string& type) {
+    separate();
+    append(result, relationship, type);
+  }
+
+  // Keeps the place of a missing entry in a multi get
+  void add_null() {
+    separate();
+    result.append("null");
+  }
+
+  void add_number(uint64_t value) {
+    separate();
+    append_number(result, value);
+  }
+
+  void add_value(const std::any& value) {
+    separate();
+    if (!append_any(result, value)) {
+      result.append("null");
+    }
+  }
+
+  // The {id, value} of a node from an algorithm
+  template <typename T>
+  void add_result(uint64_t id, T value) {
+    separate();
+    result.append("{\"id\": ");
+    append_number(result, id);
+    result.append(", \"value\": ");
+    append_value(result, value);
+    result.push_back(CLOSE);
+  }
+
+  std::string as_json() {
+    result.push_back(CLOSE_ARRAY);
+    return std::move(result);
+  }
+
+  static void append(std::string& out, const Node& node, const std::string& type) {
+    out.append("{\"id\": ");
+    append_number(out, node.getId());
+    out.append(", \"type\": ");
+    append_string(out, type);
+    out.append(", \"key\": ");
+    append_string(out, node.getKey());
+    out.append(", \"properties\": ");
+    append_properties(out, node.getPropertyList());
+    out.push_back(CLOSE);
+  }
+
+  static void append(std::string& out, const Relationship& relationship, const std::string& type) {
+    out.append("{\"id\": ");
+    append_number(out, relationship.getId());
+    out.append(", \"type\": ");
+    append_string(out, type);
+    out.append(", \"from\": ");
+    append_number(out, relationship.getStartingNodeId());
+    out.append(", \"to\": ");
+    append_number(out, relationship.getEndingNodeId());
+    out.append(", \"properties\": ");
+    append_properties(out, relationship.getPropertyList());
+    out.push_back(CLOSE);
+  }
+
+private:
+  static const char OPEN = '{';
+  static const char CLOSE = '}';
+  static const char OPEN_ARRAY = '[';
+  static const char CLOSE_ARRAY = ']';
+  static const size_t RESERVE_PER_ENTITY = 128;
+  Graph& graph;
+  std::string result;
+  bool first{true};
+  uint16_t node_type_id{0};
+  std::string node_type;
+  uint16_t relationship_type_id{0};
+  std::string relationship_type;
+
+  void separate() {
+    if (first) {
+      first = false;
+    } else {
+      result.append(", ");
+    }
+  }
+
+  template <typename T>
+  static void append_number(std::string& out, T value) {
+    char buffer[24];
+    auto [end, error] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, end);
+  }
+
+  static void append_string(std::string& out, const std::string& value) {
+    out.push_back('"');
+    for (char c : value) {
+      switch (c) {
+        case '"': out.append("\\\""); break;
+        case '\\': out.append("\\\\"); break;
+        case '\n': out.append("\\n"); break;
+        case '\r': out.append("\\r"); break;
+        case '\t': out.append("\\t"); break;
+        default:
+          if (static_cast<unsigned char>(c) < 0x20) {
+            static const char HEX[] = "0123456789abcdef";
+            out.append("\\u00");
+            out.push_back(HEX[c >> 4]);
+            out.push_back(HEX[c & 0xf]);
+          } else {
+            out.push_back(c);
+          }
+      }
+    }
+    out.push_back('"');
+  }
+
+  template <typename T>
+  static void append_array(std::string& out, const std::vector<T>& values) {
+    out.push_back(OPEN_ARRAY);
+    bool initial = true;
+    for (const auto& item : values) {
+      if (!initial) {
+        out.append(", ");
+      }
+      append_value(out, item);
+      initial = false;
+    }
+    out.push_back(CLOSE_ARRAY);
+  }
+
+  static void append_value(std::string& out, const std::string& value) {
+    append_string(out, value);
+  }
+
+  static void append_value(std::string& out, int64_t value) {
+    append_number(out, value);
+  }
+
+  static void append_value(std::string& out, double value) {
+    out.append(seastar::json::formatter::to_json(value));
+  }
+
+  static void append_value(std::string& out, bool value) {
+    out.append(value ? "true" : "false");
+  }
+
+  // Same value types as json_properties_builder, anything else is left out
+  static bool append_any(std::string& out, const std::any& value) {
+    if (value.type() == typeid(std::string)) {
+      append_value(out, std::any_cast<const std::string&>(value));
+    } else if (value.type() == typeid(int64_t)) {
+      append_value(out, std::any_cast<int64_t>(value));
+    } else if (value.type() == typeid(double)) {
+      append_value(out, std::any_cast<double>(value));
+    } else if (value.type() == typeid(bool)) {
+      append_value(out, std::any_cast<bool>(value));
+    } else if (value.type() == typeid(std::vector<std::string>)) {
+      append_array(out, std::any_cast<const std::vector<std::string>&>(value));
+    } else if (value.type() == typeid(std::vector<int64_t>)) {
+      append_array(out, std::any_cast<const std::vector<int64_t>&>(value));
+    } else if (value.type() == typeid(std::vector<double>)) {
+      append_array(out, std::any_cast<const std::vector<double>&>(value));
+    } else if (value.type() == typeid(std::vector<bool>)) {
+      append_array(out, std::any_cast<const std::vector<bool>&>(value));
+    } else if (value.type() == typeid(std::map<std::string, std::any>)) {
+      out.push_back(OPEN);
+      bool initial = true;
+      for (const auto& [key, nested] : std::any_cast<const std::map<std::string, std::any>&>(value)) {
+        initial = append_member(out, initial, key, nested);
+      }
+      out.push_back(CLOSE);
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+  // Returns whether nothing has been written to the object yet
+  static bool append_member(std::string& out, bool initial, const std::string& key, const std::any& value) {
+    size_t start = out.size();
+    if (!initial) {
+      out.append(", ");
+    }
+    append_string(out, key);
+    out.append(": ");
+    if (!append_any(out, value)) {
+      out.resize(start);
+      return initial;
+    }
+    return false;
+  }
+
+  static void append_properties(std::string& out, const std::vector<Property>& properties) {
+    out.push_back(OPEN);
+    bool initial = true;
+    for (const auto& property : properties) {
+      initial = append_member(out, initial, property.getKey(), property.getValue());
+    }
+    out.push_back(CLOSE);
+  }
+
+};
+
 struct properties_json : public json::jsonable {
 private:
   std::map<std::string, std::any> properties;
@@ -20,7 +20,7 @@ const std::string EXCEPTION = "An exception has occurred: ";
 
 void Lua::set_routes(routes &routes) {
 
-  auto postLua = new match_rule(&postLuaHandler);
+  auto postLua = new match_rule(Server::timed(graph, "POST /lua", Server::cached(graph, &postLuaHandler)));
   postLua->add_str("/db/" + graph.GetName() + "/lua");
   routes.add(postLua, operation_type::POST);
 
@@ -0,0 +1,129 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "JSON.h"
+#include "MultiGets.h"
+
+void MultiGets::set_routes(routes &routes) {
+
+  auto postNodes = new match_rule(Server::timed(graph, "POST /nodes/get", &postNodesHandler));
+  postNodes->add_str("/db/" + graph.GetName() + "/nodes/get");
+  routes.add(postNodes, operation_type::POST);
+
+  auto postRelationships = new match_rule(Server::timed(graph, "POST /relationships/get", &postRelationshipsHandler));
+  postRelationships->add_str("/db/" + graph.GetName() + "/relationships/get");
+  routes.add(postRelationships, operation_type::POST);
+
+  auto postDegrees = new match_rule(Server::timed(graph, "POST /nodes/degree", &postDegreesHandler));
+  postDegrees->add_str("/db/" + graph.GetName() + "/nodes/degree");
+  routes.add(postDegrees, operation_type::POST);
+
+  auto postProperties = new match_rule(Server::timed(graph, "POST /nodes/property/{property}", &postPropertiesHandler));
+  postProperties->add_str("/db/" + graph.GetName() + "/nodes/property");
+  postProperties->add_param("property");
+  routes.add(postProperties, operation_type::POST);
+
+}
+
+static bool validate_content(const std::unique_ptr<request> &req, std::unique_ptr<reply> &rep) {
+  // If the ids are missing
+  if (req->content.empty()) {
+    rep->write_body("json", std::move(json::stream_object("Empty multi get")));
+    rep->set_status(reply::status_type::bad_request);
+    return false;
+  }
+  return true;
+}
+
+future<std::unique_ptr<reply>> MultiGets::PostNodesHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  if (!validate_content(req, rep)) {
+    return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+  }
+
+  std::string body = req->content;
+  NodeProjection projection = Server::validate_projection(req);
+  return parent.graph.shard.local().NodesGetPeered(body, projection)
+    .then([rep = std::move(rep), this] (std::vector<Node> nodes) mutable {
+           json_entities_builder json(parent.graph, nodes.size());
+           for(Node& n : nodes) {
+             if (n.getId() == 0) {
+               json.add_null();
+             } else {
+               json.add(n);
+             }
+           }
+           rep->write_body("json", sstring(json.as_json()));
+           return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+    });
+}
+
+future<std::unique_ptr<reply>> MultiGets::PostRelationshipsHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  if (!validate_content(req, rep)) {
+    return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+  }
+
+  std::string body = req->content;
+  return parent.graph.shard.local().RelationshipsGetPeered(body)
+    .then([rep = std::move(rep), this] (std::vector<Relationship> relationships) mutable {
+           json_entities_builder json(parent.graph, relationships.size());
+           for(Relationship& r : relationships) {
+             if (r.getId() == 0) {
+               json.add_null();
+             } else {
+               json.add(r);
+             }
+           }
+           rep->write_body("json", sstring(json.as_json()));
+           return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+    });
+}
+
+future<std::unique_ptr<reply>> MultiGets::PostDegreesHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  if (!validate_content(req, rep)) {
+    return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+  }
+
+  std::string body = req->content;
+  return parent.graph.shard.local().NodesGetDegreePeered(body)
+    .then([rep = std::move(rep), this] (const std::vector<uint64_t>& degrees) mutable {
+           json_entities_builder json(parent.graph);
+           for(uint64_t degree : degrees) {
+             json.add_number(degree);
+           }
+           rep->write_body("json", sstring(json.as_json()));
+           return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+    });
+}
+
+future<std::unique_ptr<reply>> MultiGets::PostPropertiesHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  bool valid_property = Server::validate_parameter(Server::PROPERTY, req, rep, "Invalid property");
+
+  if (valid_property && validate_content(req, rep)) {
+    std::string body = req->content;
+    std::string property = req->param[Server::PROPERTY];
+    return parent.graph.shard.local().NodesGetPropertyPeered(body, property)
+      .then([rep = std::move(rep), this] (const std::vector<std::any>& values) mutable {
+             json_entities_builder json(parent.graph);
+             for(const std::any& value : values) {
+               json.add_value(value);
+             }
+             rep->write_body("json", sstring(json.as_json()));
+             return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+      });
+  }
+
+  return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+}
@@ -19,7 +19,7 @@
 #include <boost/algorithm/string.hpp>
 
 void Neighbors::set_routes(routes &routes) {
-  auto getNeighbors = new match_rule(&getNeighborsHandler);
+  auto getNeighbors = new match_rule(Server::timed(graph, "GET /node/{type}/{key}/neighbors", Server::cached(graph, &getNeighborsHandler)));
   getNeighbors->add_str("/db/" + graph.GetName() + "/node");
   getNeighbors->add_param("type");
   getNeighbors->add_param("key");
@@ -27,7 +27,7 @@ void Neighbors::set_routes(routes &routes) {
   getNeighbors->add_param("options", true);
   routes.add(getNeighbors, operation_type::GET);
 
-  auto getNeighborsById = new match_rule(&getNeighborsByIdHandler);
+  auto getNeighborsById = new match_rule(Server::timed(graph, "GET /node/{id}/neighbors", Server::cached(graph, &getNeighborsByIdHandler)));
   getNeighborsById->add_str("/db/" + graph.GetName() + "/node");
   getNeighborsById->add_param("id");
   getNeighborsById->add_str("/neighbors");
@@ -44,18 +44,39 @@ future<std::unique_ptr<reply>> Neighbors::GetNeighborsHandler::handle(const sstr
     // Gather Options
     std::string options_string;
     Direction direction = BOTH;
+    NodeProjection projection = Server::validate_projection(req);
+
+    // A limit, offset, node type or filter is applied on the shards holding the neighbors
+    if (Server::validate_paged(req)) {
+      std::vector<std::string> rel_types;
+      std::vector<ScanFilter> filters;
+      if (!Server::validate_options(req, rep, direction, rel_types) || !Server::validate_filters(req, rep, filters)) {
+        return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+      }
+      uint64_t limit = Server::validate_limit(req, rep);
+      uint64_t offset = Server::validate_offset(req, rep);
+      std::string node_type = req->get_query_param("node_type").c_str();
+      return parent.graph.shard.local().NodeGetNeighborsPeered(req->param[Server::TYPE], req->param[Server::KEY], direction, rel_types, node_type, filters, offset, limit, projection)
+        .then([rep = std::move(rep), this] (std::vector<Node> nodes) mutable {
+               json_entities_builder json(parent.graph, nodes.size());
+               for(Node& n : nodes) {
+                 json.add(n);
+               }
+               rep->write_body("json", sstring(json.as_json()));
+               return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+        });
+    }
     options_string = req->param.at(Server::OPTIONS).c_str();
 
     if(options_string.empty()) {
       // Get Node Neighbors
-      return parent.graph.shard.local().NodeGetNeighborsPeered(req->param[Server::TYPE], req->param[Server::KEY])
-        .then([rep = std::move(rep), this] (const std::vector<Node>& nodes) mutable {
-               std::vector<node_json> json_array;
-               json_array.reserve(nodes.size());
-               for(Node n : nodes) {
-                 json_array.emplace_back(n, parent.graph);
+      return parent.graph.shard.local().NodeGetNeighborsPeered(req->param[Server::TYPE], req->param[Server::KEY], projection)
+        .then([rep = std::move(rep), this] (std::vector<Node> nodes) mutable {
+               json_entities_builder json(parent.graph, nodes.size());
+               for(Node& n : nodes) {
+                 json.add(n);
                }
-               rep->write_body("json", std::move(json::stream_object(json_array)));
+               rep->write_body("json", sstring(json.as_json()));
                return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
         });
     }
@@ -77,14 +98,13 @@ future<std::unique_ptr<reply>> Neighbors::GetNeighborsHandler::handle(const sstr
     switch(options.size()) {
     case 1:
       // Get Node Neighbors with Direction
-      return parent.graph.shard.local().NodeGetNeighborsPeered(req->param[Server::TYPE], req->param[Server::KEY], direction)
-        .then([rep = std::move(rep), this] (const std::vector<Node>& nodes) mutable {
-               std::vector<node_json> json_array;
-               json_array.reserve(nodes.size());
-               for(Node n : nodes) {
-                 json_array.emplace_back(n, parent.graph);
+      return parent.graph.shard.local().NodeGetNeighborsPeered(req->param[Server::TYPE], req->param[Server::KEY], direction, projection)
+        .then([rep = std::move(rep), this] (std::vector<Node> nodes) mutable {
+               json_entities_builder json(parent.graph, nodes.size());
+               for(Node& n : nodes) {
+                 json.add(n);
                }
-               rep->write_body("json", std::move(json::stream_object(json_array)));
+               rep->write_body("json", sstring(json.as_json()));
                return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
         });
 
@@ -94,27 +114,25 @@ future<std::unique_ptr<reply>> Neighbors::GetNeighborsHandler::handle(const sstr
       boost::split(rel_types, options[1], [](char c){ return c == '&'; });
       // Single Relationship Type
       if (rel_types.size() == 1) {
-        return parent.graph.shard.local().NodeGetNeighborsPeered(req->param[Server::TYPE], req->param[Server::KEY], direction, rel_types[0])
-          .then([rep = std::move(rep), this] (const std::vector<Node>& nodes) mutable {
-                 std::vector<node_json> json_array;
-                 json_array.reserve(nodes.size());
-                 for(Node n : nodes) {
-                   json_array.emplace_back(n, parent.graph);
+        return parent.graph.shard.local().NodeGetNeighborsPeered(req->param[Server::TYPE], req->param[Server::KEY], direction, rel_types[0], projection)
+          .then([rep = std::move(rep), this] (std::vector<Node> nodes) mutable {
+                 json_entities_builder json(parent.graph, nodes.size());
+                 for(Node& n : nodes) {
+                   json.add(n);
                  }
-                 rep->write_body("json", std::move(json::stream_object(json_array)));
+                 rep->write_body("json", sstring(json.as_json()));
                  return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
           });
       }
 
       // Multiple Relationship Types
-      return parent.graph.shard.local().NodeGetNeighborsPeered(req->param[Server::TYPE], req->param[Server::KEY], direction, rel_types)
-        .then([rep = std::move(rep), this] (const std::vector<Node>& nodes) mutable {
-               std::vector<node_json> json_array;
-               json_array.reserve(nodes.size());
-               for(Node n : nodes) {
-                 json_array.emplace_back(n, parent.graph);
+      return parent.graph.shard.local().NodeGetNeighborsPeered(req->param[Server::TYPE], req->param[Server::KEY], direction, rel_types, projection)
+        .then([rep = std::move(rep), this] (std::vector<Node> nodes) mutable {
+               json_entities_builder json(parent.graph, nodes.size());
+               for(Node& n : nodes) {
+                 json.add(n);
                }
-               rep->write_body("json", std::move(json::stream_object(json_array)));
+               rep->write_body("json", sstring(json.as_json()));
                return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
         });
     }
@@ -135,18 +153,40 @@ future<std::unique_ptr<reply>> Neighbors::GetNeighborsByIdHandler::handle(const
   // Gather Options
   std::string options_string;
   Direction direction = BOTH;
+  NodeProjection projection = Server::validate_projection(req);
+
+  // A limit, offset, node type or filter is applied on the shards holding the neighbors
+  if (Server::validate_paged(req)) {
+    std::vector<std::string> rel_types;
+    std::vector<ScanFilter> filters;
+    if (!Server::validate_options(req, rep, direction, rel_types) || !Server::validate_filters(req, rep, filters)) {
+      return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+    }
+    uint64_t limit = Server::validate_limit(req, rep);
+    uint64_t offset = Server::validate_offset(req, rep);
+    std::string node_type = req->get_query_param("node_type").c_str();
+    return parent.graph.shard.local().NodeGetNeighborsPeered(id, direction, rel_types, node_type, filters, offset, limit, projection)
+      .then([rep = std::move(rep), this] (std::vector<Node> nodes) mutable {
+             json_entities_builder json(parent.graph, nodes.size());
+             for(Node& n : nodes) {
+               json.add(n);
+             }
+             rep->write_body("json", sstring(json.as_json()));
+             return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+      });
+  }
+
   options_string = req->param.at(Server::OPTIONS).c_str();
 
   if(options_string.empty()) {
     // Get Node Neighbors
-    return parent.graph.shard.local().NodeGetNeighborsPeered(id)
-      .then([rep = std::move(rep), this] (const std::vector<Node>& nodes) mutable {
-             std::vector<node_json> json_array;
-             json_array.reserve(nodes.size());
-             for(Node n : nodes) {
-               json_array.emplace_back(n, parent.graph);
+    return parent.graph.shard.local().NodeGetNeighborsPeered(id, projection)
+      .then([rep = std::move(rep), this] (std::vector<Node> nodes) mutable {
+             json_entities_builder json(parent.graph, nodes.size());
+             for(Node& n : nodes) {
+               json.add(n);
              }
-             rep->write_body("json", std::move(json::stream_object(json_array)));
+             rep->write_body("json", sstring(json.as_json()));
              return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
       });
   }
@@ -168,14 +208,13 @@ future<std::unique_ptr<reply>> Neighbors::GetNeighborsByIdHandler::handle(const
   switch(options.size()) {
   case 1:
     // Get Node Neighbors with Direction
-    return parent.graph.shard.local().NodeGetNeighborsPeered(id, direction)
-      .then([rep = std::move(rep), this] (const std::vector<Node>& nodes) mutable {
-             std::vector<node_json> json_array;
-             json_array.reserve(nodes.size());
-             for(Node n : nodes) {
-               json_array.emplace_back(n, parent.graph);
+    return parent.graph.shard.local().NodeGetNeighborsPeered(id, direction, projection)
+      .then([rep = std::move(rep), this] (std::vector<Node> nodes) mutable {
+             json_entities_builder json(parent.graph, nodes.size());
+             for(Node& n : nodes) {
+               json.add(n);
              }
-             rep->write_body("json", std::move(json::stream_object(json_array)));
+             rep->write_body("json", sstring(json.as_json()));
              return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
       });
   case 2: {
@@ -184,27 +223,25 @@ future<std::unique_ptr<reply>> Neighbors::GetNeighborsByIdHandler::handle(const
     boost::split(rel_types, options[1], [](char c){ return c == '&'; });
     // Single Relationship Type
     if (rel_types.size() == 1) {
-      return parent.graph.shard.local().NodeGetNeighborsPeered(id, direction, rel_types[0])
-        .then([rep = std::move(rep), this] (const std::vector<Node>& nodes) mutable {
-               std::vector<node_json> json_array;
-               json_array.reserve(nodes.size());
-               for(Node n : nodes) {
-                 json_array.emplace_back(n, parent.graph);
+      return parent.graph.shard.local().NodeGetNeighborsPeered(id, direction, rel_types[0], projection)
+        .then([rep = std::move(rep), this] (std::vector<Node> nodes) mutable {
+               json_entities_builder json(parent.graph, nodes.size());
+               for(Node& n : nodes) {
+                 json.add(n);
                }
-               rep->write_body("json", std::move(json::stream_object(json_array)));
+               rep->write_body("json", sstring(json.as_json()));
                return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
         });
     }
 
     // Multiple Relationship Types
-    return parent.graph.shard.local().NodeGetNeighborsPeered(id, direction, rel_types)
-      .then([rep = std::move(rep), this] (const std::vector<Node>& nodes) mutable {
-             std::vector<node_json> json_array;
-             json_array.reserve(nodes.size());
-             for(Node n : nodes) {
-               json_array.emplace_back(n, parent.graph);
+    return parent.graph.shard.local().NodeGetNeighborsPeered(id, direction, rel_types, projection)
+      .then([rep = std::move(rep), this] (std::vector<Node> nodes) mutable {
+             json_entities_builder json(parent.graph, nodes.size());
+             for(Node& n : nodes) {
+               json.add(n);
              }
-             rep->write_body("json", std::move(json::stream_object(json_array)));
+             rep->write_body("json", sstring(json.as_json()));
              return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
       });
   }
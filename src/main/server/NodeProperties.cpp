@@ -19,7 +19,7 @@
 #include "Server.h"
 
 void NodeProperties::set_routes(routes &routes) {
-  auto getNodeProperty = new match_rule(&getNodePropertyHandler);
+  auto getNodeProperty = new match_rule(Server::timed(graph, "GET /node/{type}/{key}/property/{property}", &getNodePropertyHandler));
   getNodeProperty->add_str("/db/" + graph.GetName() + "/node");
   getNodeProperty->add_param("type");
   getNodeProperty->add_param("key");
@@ -27,14 +27,14 @@ void NodeProperties::set_routes(routes &routes) {
   getNodeProperty->add_param("property");
   routes.add(getNodeProperty, operation_type::GET);
 
-  auto getNodePropertyById = new match_rule(&getNodePropertyByIdHandler);
+  auto getNodePropertyById = new match_rule(Server::timed(graph, "GET /node/{id}/property/{property}", &getNodePropertyByIdHandler));
   getNodePropertyById->add_str("/db/" + graph.GetName() + "/node");
   getNodePropertyById->add_param("id");
   getNodePropertyById->add_str("/property");
   getNodePropertyById->add_param("property");
   routes.add(getNodePropertyById, operation_type::GET);
 
-  auto putNodeProperty = new match_rule(&putNodePropertyHandler);
+  auto putNodeProperty = new match_rule(Server::timed(graph, "PUT /node/{type}/{key}/property/{property}", &putNodePropertyHandler));
   putNodeProperty->add_str("/db/" + graph.GetName() + "/node");
   putNodeProperty->add_param("type");
   putNodeProperty->add_param("key");
@@ -42,14 +42,14 @@ void NodeProperties::set_routes(routes &routes) {
   putNodeProperty->add_param("property");
   routes.add(putNodeProperty, operation_type::PUT);
 
-  auto putNodePropertyById = new match_rule(&putNodePropertyByIdHandler);
+  auto putNodePropertyById = new match_rule(Server::timed(graph, "PUT /node/{id}/property/{property}", &putNodePropertyByIdHandler));
   putNodePropertyById->add_str("/db/" + graph.GetName() + "/node");
   putNodePropertyById->add_param("id");
   putNodePropertyById->add_str("/property");
   putNodePropertyById->add_param("property");
   routes.add(putNodePropertyById, operation_type::PUT);
 
-  auto deleteNodeProperty = new match_rule(&deleteNodePropertyHandler);
+  auto deleteNodeProperty = new match_rule(Server::timed(graph, "DELETE /node/{type}/{key}/property/{property}", &deleteNodePropertyHandler));
   deleteNodeProperty->add_str("/db/" + graph.GetName() + "/node");
   deleteNodeProperty->add_param("type");
   deleteNodeProperty->add_param("key");
@@ -57,60 +57,60 @@ void NodeProperties::set_routes(routes &routes) {
   deleteNodeProperty->add_param("property");
   routes.add(deleteNodeProperty, operation_type::DELETE);
 
-  auto deleteNodePropertyById = new match_rule(&deleteNodePropertyByIdHandler);
+  auto deleteNodePropertyById = new match_rule(Server::timed(graph, "DELETE /node/{id}/property/{property}", &deleteNodePropertyByIdHandler));
   deleteNodePropertyById->add_str("/db/" + graph.GetName() + "/node");
   deleteNodePropertyById->add_param("id");
   deleteNodePropertyById->add_str("/property");
   deleteNodePropertyById->add_param("property");
   routes.add(deleteNodePropertyById, operation_type::DELETE);
 
-  auto getNodeProperties = new match_rule(&getNodePropertiesHandler);
+  auto getNodeProperties = new match_rule(Server::timed(graph, "GET /node/{type}/{key}/properties", &getNodePropertiesHandler));
   getNodeProperties->add_str("/db/" + graph.GetName() + "/node");
   getNodeProperties->add_param("type");
   getNodeProperties->add_param("key");
   getNodeProperties->add_str("/properties");
   routes.add(getNodeProperties, operation_type::GET);
 
-  auto getNodePropertiesById = new match_rule(&getNodePropertiesByIdHandler);
+  auto getNodePropertiesById = new match_rule(Server::timed(graph, "GET /node/{id}/properties", &getNodePropertiesByIdHandler));
   getNodePropertiesById->add_str("/db/" + graph.GetName() + "/node");
   getNodePropertiesById->add_param("id");
   getNodePropertiesById->add_str("/properties");
   routes.add(getNodePropertiesById, operation_type::GET);
 
-  auto postNodeProperties = new match_rule(&postNodePropertiesHandler);
+  auto postNodeProperties = new match_rule(Server::timed(graph, "POST /node/{type}/{key}/properties", &postNodePropertiesHandler));
   postNodeProperties->add_str("/db/" + graph.GetName() + "/node");
   postNodeProperties->add_param("type");
   postNodeProperties->add_param("key");
   postNodeProperties->add_str("/properties");
   routes.add(postNodeProperties, operation_type::POST);
 
-  auto postNodePropertiesById = new match_rule(&postNodePropertiesByIdHandler);
+  auto postNodePropertiesById = new match_rule(Server::timed(graph, "POST /node/{id}/properties", &postNodePropertiesByIdHandler));
   postNodePropertiesById->add_str("/db/" + graph.GetName() + "/node");
   postNodePropertiesById->add_param("id");
   postNodePropertiesById->add_str("/properties");
   routes.add(postNodePropertiesById, operation_type::POST);
 
-  auto putNodeProperties = new match_rule(&putNodePropertiesHandler);
+  auto putNodeProperties = new match_rule(Server::timed(graph, "PUT /node/{type}/{key}/properties", &putNodePropertiesHandler));
   putNodeProperties->add_str("/db/" + graph.GetName() + "/node");
   putNodeProperties->add_param("type");
   putNodeProperties->add_param("key");
   putNodeProperties->add_str("/properties");
   routes.add(putNodeProperties, operation_type::PUT);
 
-  auto putNodePropertiesById = new match_rule(&putNodePropertiesByIdHandler);
+  auto putNodePropertiesById = new match_rule(Server::timed(graph, "PUT /node/{id}/properties", &putNodePropertiesByIdHandler));
   putNodePropertiesById->add_str("/db/" + graph.GetName() + "/node");
   putNodePropertiesById->add_param("id");
   putNodePropertiesById->add_str("/properties");
   routes.add(putNodePropertiesById, operation_type::PUT);
 
-  auto deleteNodeProperties = new match_rule(&deleteNodePropertiesHandler);
+  auto deleteNodeProperties = new match_rule(Server::timed(graph, "DELETE /node/{type}/{key}/properties", &deleteNodePropertiesHandler));
   deleteNodeProperties->add_str("/db/" + graph.GetName() + "/node");
   deleteNodeProperties->add_param("type");
   deleteNodeProperties->add_param("key");
   deleteNodeProperties->add_str("/properties");
   routes.add(deleteNodeProperties, operation_type::DELETE);
 
-  auto deleteNodePropertiesById = new match_rule(&deleteNodePropertiesByIdHandler);
+  auto deleteNodePropertiesById = new match_rule(Server::timed(graph, "DELETE /node/{id}/properties", &deleteNodePropertiesByIdHandler));
   deleteNodePropertiesById->add_str("/db/" + graph.GetName() + "/node");
   deleteNodePropertiesById->add_param("id");
   deleteNodePropertiesById->add_str("/properties");
@@ -19,56 +19,159 @@
 
 void Nodes::set_routes(routes &routes) {
 
-  auto getNodes = new match_rule(&getNodesHandler);
+  auto getNodes = new match_rule(Server::timed(graph, "GET /nodes", &getNodesHandler));
   getNodes->add_str("/db/" + graph.GetName() + "/nodes");
   routes.add(getNodes, operation_type::GET);
 
-  auto getNodesOfType = new match_rule(&getNodesOfTypeHandler);
+  auto getNodesOfType = new match_rule(Server::timed(graph, "GET /nodes/{type}", &getNodesOfTypeHandler));
   getNodesOfType->add_str("/db/" + graph.GetName() + "/nodes");
   getNodesOfType->add_param("type");
   routes.add(getNodesOfType, operation_type::GET);
 
-  auto getNode = new match_rule(&getNodeHandler);
+  auto getNode = new match_rule(Server::timed(graph, "GET /node/{type}/{key}", &getNodeHandler));
   getNode->add_str("/db/" + graph.GetName() + "/node");
   getNode->add_param("type");
   getNode->add_param("key");
   routes.add(getNode, operation_type::GET);
 
-  auto getNodeById = new match_rule(&getNodeByIdHandler);
+  auto getNodeShard = new match_rule(Server::timed(graph, "GET /node/{type}/{key}/shard", &getNodeShardHandler));
+  getNodeShard->add_str("/db/" + graph.GetName() + "/node");
+  getNodeShard->add_param("type");
+  getNodeShard->add_param("key");
+  getNodeShard->add_str("/shard");
+  routes.add(getNodeShard, operation_type::GET);
+
+  auto putNodeShard = new match_rule(Server::timed(graph, "PUT /node/{type}/{key}/shard/{shard}", &putNodeShardHandler));
+  putNodeShard->add_str("/db/" + graph.GetName() + "/node");
+  putNodeShard->add_param("type");
+  putNodeShard->add_param("key");
+  putNodeShard->add_str("/shard");
+  putNodeShard->add_param("shard");
+  routes.add(putNodeShard, operation_type::PUT);
+
+  auto getNodeById = new match_rule(Server::timed(graph, "GET /node/{id}", &getNodeByIdHandler));
   getNodeById->add_str("/db/" + graph.GetName() + "/node");
   getNodeById->add_param("id");
   routes.add(getNodeById, operation_type::GET);
 
-  auto postNode = new match_rule(&postNodeHandler);
+  auto postNode = new match_rule(Server::timed(graph, "POST /node/{type}/{key}", &postNodeHandler));
   postNode->add_str("/db/" + graph.GetName() + "/node");
   postNode->add_param("type");
   postNode->add_param("key");
   routes.add(postNode, operation_type::POST);
 
-  auto deleteNode = new match_rule(&deleteNodeHandler);
+  auto postNodes = new match_rule(Server::timed(graph, "POST /nodes", &postNodesHandler));
+  postNodes->add_str("/db/" + graph.GetName() + "/nodes");
+  routes.add(postNodes, operation_type::POST);
+
+  auto deleteNode = new match_rule(Server::timed(graph, "DELETE /node/{type}/{key}", &deleteNodeHandler));
   deleteNode->add_str("/db/" + graph.GetName() + "/node");
   deleteNode->add_param("type");
   deleteNode->add_param("key");
   routes.add(deleteNode, operation_type::DELETE);
 
-  auto deleteNodeById = new match_rule(&deleteNodeByIdHandler);
+  auto deleteNodeById = new match_rule(Server::timed(graph, "DELETE /node/{id}", &deleteNodeByIdHandler));
   deleteNodeById->add_str("/db/" + graph.GetName() + "/node");
   deleteNodeById->add_param("id");
   routes.add(deleteNodeById, operation_type::DELETE);
+
+  auto deleteNodes = new match_rule(Server::timed(graph, "DELETE /nodes", &deleteNodesHandler));
+  deleteNodes->add_str("/db/" + graph.GetName() + "/nodes");
+  routes.add(deleteNodes, operation_type::DELETE);
+
+  auto deleteNodesOfType = new match_rule(Server::timed(graph, "DELETE /nodes/{type}", &deleteNodesOfTypeHandler));
+  deleteNodesOfType->add_str("/db/" + graph.GetName() + "/nodes");
+  deleteNodesOfType->add_param("type");
+  routes.add(deleteNodesOfType, operation_type::DELETE);
+}
+
+future<std::unique_ptr<reply>> Nodes::GetNodesFromCursor(Cursor cursor, uint64_t limit, bool stream, std::unique_ptr<reply> rep) {
+  if (cursor.view == 0) {
+    return ScanNodes(cursor, limit, stream, std::move(rep));
+  }
+  // A view that expired or was closed would otherwise read as an empty scan
+  return graph.shard.local().ReadViewExistsPeered(cursor.view)
+    .then([cursor, limit, stream, rep = std::move(rep), this] (bool exists) mutable {
+           if (!exists) {
+             rep->write_body("json", std::move(json::stream_object("Unknown view")));
+             rep->set_status(reply::status_type::not_found);
+             return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+           }
+           return ScanNodes(cursor, limit, stream, std::move(rep));
+    });
+}
+
+future<std::unique_ptr<reply>> Nodes::ScanNodes(Cursor cursor, uint64_t limit, bool stream, std::unique_ptr<reply> rep) {
+  if (stream) {
+    // Limit is the size of each page of the scan, the stream goes on until the scan is finished
+    limit = std::max(limit, uint64_t(1));
+    rep->write_body("json", [cursor, limit, this] (output_stream<char>&& output) {
+      return do_with(std::move(output), cursor, true, [limit, this] (output_stream<char>& out, Cursor& cursor, bool& first) {
+        return out.write("[").then([&out, &cursor, &first, limit, this] {
+          return repeat([&out, &cursor, &first, limit, this] {
+            return graph.shard.local().AllNodesPeered(cursor, limit).then([&out, &cursor, &first, this] (std::pair<std::vector<Node>, Cursor> page) {
+              cursor = page.second;
+              std::string chunk;
+              for(Node& n : page.first) {
+                if (!first) {
+                  chunk.append(",");
+                }
+                first = false;
+                json_entities_builder::append(chunk, n, graph.shard.local().NodeTypeGetType(n.getTypeId()));
+              }
+              return out.write(chunk).then([&out] {
+                return out.flush();
+              }).then([&cursor] {
+                return cursor.finished ? stop_iteration::yes : stop_iteration::no;
+              });
+            });
+          });
+        }).then([&out] {
+          return out.write("]");
+        }).finally([&out] {
+          return out.close();
+        });
+      });
+    });
+    return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+  }
+
+  return graph.shard.local().AllNodesPeered(cursor, limit)
+    .then([rep = std::move(rep), this] (std::pair<std::vector<Node>, Cursor> page) mutable {
+           // The next page starts from here, no header once everything has been read
+           if (!page.second.finished) {
+             rep->add_header("X-Cursor", page.second.toString());
+           }
+           json_entities_builder json(graph, page.first.size());
+           for(Node& n : page.first) {
+             json.add(n);
+           }
+           rep->write_body("json", sstring(json.as_json()));
+           return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+    });
 }
 
 future<std::unique_ptr<reply>> Nodes::GetNodesHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
   uint64_t limit = Server::validate_limit(req, rep);
   uint64_t offset = Server::validate_offset(req, rep);
 
+  bool stream = Server::validate_stream(req);
+  if (stream || !req->get_query_param("cursor").empty() || !req->get_query_param("view").empty()) {
+    Cursor cursor;
+    if (!Server::validate_cursor(req, rep, cursor)) {
+      return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+    }
+    cursor.type_id = 0;
+    return parent.GetNodesFromCursor(cursor, limit, stream, std::move(rep));
+  }
+
   return parent.graph.shard.local().AllNodesPeered(offset, limit)
-    .then([rep = std::move(rep), this](const std::vector<Node>& nodes) mutable {
-           std::vector<node_json> json_array;
-           json_array.reserve(nodes.size());
-           for(Node n : nodes) {
-             json_array.emplace_back(n, parent.graph);
+    .then([rep = std::move(rep), this](std::vector<Node> nodes) mutable {
+           json_entities_builder json(parent.graph, nodes.size());
+           for(Node& n : nodes) {
+             json.add(n);
            }
-           rep->write_body("json", std::move(json::stream_object(json_array)));
+           rep->write_body("json", sstring(json.as_json()));
            return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
     });
 }
@@ -80,16 +183,32 @@ future<std::unique_ptr<reply>> Nodes::GetNodesOfTypeHandler::handle(const sstrin
     uint64_t limit = Server::validate_limit(req, rep);
     uint64_t offset = Server::validate_offset(req, rep);
 
+    bool stream = Server::validate_stream(req);
+    if (stream || !req->get_query_param("cursor").empty() || !req->get_query_param("view").empty()) {
+      Cursor cursor;
+      uint16_t type_id = parent.graph.shard.local().NodeTypeGetTypeId(req->param[Server::TYPE]);
+      // Without the type the scan would walk every slot only to keep none of them
+      if (type_id == 0) {
+        rep->write_body("json", std::move(json::stream_object("Unknown type")));
+        rep->set_status(reply::status_type::not_found);
+        return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+      }
+      if (!Server::validate_cursor(req, rep, cursor)) {
+        return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+      }
+      cursor.type_id = type_id;
+      return parent.GetNodesFromCursor(cursor, limit, stream, std::move(rep));
+    }
+
     return parent.graph.shard.local().AllNodesPeered(req->param[Server::TYPE], offset, limit)
       .then([rep = std::move(rep), this](std::vector<Node> nodes) mutable {
-             std::vector<node_json> json_array;
-             json_array.reserve(nodes.size());
+             json_entities_builder json(parent.graph, nodes.size());
              if (!nodes.empty()) {
                std::string type = parent.graph.shard.local().NodeTypeGetType(nodes.front().getTypeId());
-               for(Node n : nodes) {
-                 json_array.emplace_back(n, type);
+               for(Node& n : nodes) {
+                 json.add(n, type);
                }
-               rep->write_body("json", std::move(json::stream_object(json_array)));
+               rep->write_body("json", sstring(json.as_json()));
                return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
              }
              return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
@@ -129,6 +248,48 @@ future<std::unique_ptr<reply>> Nodes::GetNodeHandler::handle(const sstring &path
   return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
 }
 
+future<std::unique_ptr<reply>> Nodes::GetNodeShardHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  bool valid_type = Server::validate_parameter(Server::TYPE, req, rep, "Invalid type");
+  bool valid_key = Server::validate_parameter(Server::KEY, req, rep, "Invalid key");
+
+  if(valid_type && valid_key) {
+    // Clients that know the core of a node can send its requests to the shard port of that core
+    uint64_t shard = parent.graph.shard.local().CalculateShardId(req->param[Server::TYPE], req->param[Server::KEY]);
+    rep->write_body("json", std::move(json::stream_object(shard)));
+  }
+  return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+}
+
+future<std::unique_ptr<reply>> Nodes::PutNodeShardHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  bool valid_type = Server::validate_parameter(Server::TYPE, req, rep, "Invalid type");
+  bool valid_key = Server::validate_parameter(Server::KEY, req, rep, "Invalid key");
+
+  if(valid_type && valid_key) {
+    uint64_t shard = seastar::smp::count;
+    try {
+      shard = std::stoull(req->param[Server::SHARD]);
+    } catch (std::exception& e) {
+    }
+    if (shard >= seastar::smp::count) {
+      rep->write_body("json", std::move(json::stream_object("Invalid shard")));
+      rep->set_status(reply::status_type::bad_request);
+      return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+    }
+
+    // The node and its relationships come back with new ids
+    return parent.graph.shard.local().NodeMovePeered(req->param[Server::TYPE], req->param[Server::KEY], shard)
+      .then([rep = std::move(rep), type = req->param[Server::TYPE], key = req->param[Server::KEY]](uint64_t id) mutable {
+        if (id > 0) {
+          rep->write_body("json", std::move(json::stream_object((node_json(id, type, key)))));
+        } else {
+          rep->set_status(reply::status_type::not_modified);
+        }
+        return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+    });
+  }
+  return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+}
+
 future<std::unique_ptr<reply>> Nodes::PostNodeHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
   bool valid_type = Server::validate_parameter(Server::TYPE, req, rep, "Invalid type");
   bool valid_key = Server::validate_parameter(Server::KEY, req, rep, "Invalid key");
@@ -169,6 +330,27 @@ future<std::unique_ptr<reply>> Nodes::PostNodeHandler::handle(const sstring &pat
   return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
 }
 
+future<std::unique_ptr<reply>> Nodes::PostNodesHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  // If there are no nodes
+  if (req->content.empty()) {
+    rep->write_body("json", std::move(json::stream_object("Empty nodes")));
+    rep->set_status(reply::status_type::bad_request);
+    return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+  }
+
+  return parent.graph.shard.local().NodesAddFromJsonPeered(req->content.c_str())
+    .then([rep = std::move(rep)](const std::vector<uint64_t>& ids) mutable {
+    if (ids.empty()) {
+      rep->write_body("json", std::move(json::stream_object("Invalid Request")));
+      rep->set_status(reply::status_type::bad_request);
+    } else {
+      rep->write_body("json", std::move(json::stream_object(ids)));
+      rep->set_status(reply::status_type::created);
+    }
+    return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+  });
+}
+
 future<std::unique_ptr<reply>> Nodes::DeleteNodeHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
   bool valid_type = Server::validate_parameter(Server::TYPE, req, rep, "Invalid type");
   bool valid_key = Server::validate_parameter(Server::KEY, req, rep, "Invalid key");
@@ -201,4 +383,31 @@ future<std::unique_ptr<reply>> Nodes::DeleteNodeByIdHandler::handle(const sstrin
   }
 
   return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
-}
\ No newline at end of file
+}
+
+future<std::unique_ptr<reply>> Nodes::DeleteNodesHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  // The ids come in the body, [1, 2, ...]
+  if (req->content.empty()) {
+    rep->write_body("json", std::move(json::stream_object("Empty node ids")));
+    rep->set_status(reply::status_type::bad_request);
+    return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+  }
+
+  std::string body = req->content;
+  return parent.graph.shard.local().NodesRemoveFromJsonPeered(body).then([rep = std::move(rep)] (uint64_t removed) mutable {
+         rep->write_body("json", std::move(json::stream_object(removed)));
+         return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+  });
+}
+
+future<std::unique_ptr<reply>> Nodes::DeleteNodesOfTypeHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  bool valid_type = Server::validate_parameter(Server::TYPE, req, rep, "Invalid type");
+
+  if (valid_type) {
+    return parent.graph.shard.local().NodesRemoveForTypePeered(req->param[Server::TYPE]).then([rep = std::move(rep)] (uint64_t removed) mutable {
+           rep->write_body("json", std::move(json::stream_object(removed)));
+           return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+    });
+  }
+  return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+}
@@ -53,6 +53,23 @@ class Nodes {
     future<std::unique_ptr<reply>> handle(const sstring& path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) override;
   };
 
+  class GetNodeShardHandler : public httpd::handler_base {
+  public:
+    explicit GetNodeShardHandler(Nodes& nodes) : parent(nodes) {};
+
+  private:
+    Nodes& parent;
+    future<std::unique_ptr<reply>> handle(const sstring& path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) override;
+  };
+
+  class PutNodeShardHandler : public httpd::handler_base {
+  public:
+    explicit PutNodeShardHandler(Nodes& nodes) : parent(nodes) {};
+  private:
+    Nodes& parent;
+    future<std::unique_ptr<reply>> handle(const sstring& path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) override;
+  };
+
   class GetNodeByIdHandler : public httpd::handler_base {
   public:
     explicit GetNodeByIdHandler(Nodes& nodes) : parent(nodes) {};
@@ -69,6 +86,14 @@ class Nodes {
     future<std::unique_ptr<reply>> handle(const sstring& path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) override;
   };
 
+  class PostNodesHandler : public httpd::handler_base {
+  public:
+    explicit PostNodesHandler(Nodes& nodes) : parent(nodes) {};
+  private:
+    Nodes& parent;
+    future<std::unique_ptr<reply>> handle(const sstring& path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) override;
+  };
+
   class DeleteNodeHandler : public httpd::handler_base {
   public:
     explicit DeleteNodeHandler(Nodes& nodes) : parent(nodes) {};
@@ -85,19 +110,43 @@ class Nodes {
     future<std::unique_ptr<reply>> handle(const sstring& path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) override;
   };
 
+  class DeleteNodesHandler : public httpd::handler_base {
+  public:
+    explicit DeleteNodesHandler(Nodes& nodes) : parent(nodes) {};
+  private:
+    Nodes& parent;
+    future<std::unique_ptr<reply>> handle(const sstring& path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) override;
+  };
+
+  class DeleteNodesOfTypeHandler : public httpd::handler_base {
+  public:
+    explicit DeleteNodesOfTypeHandler(Nodes& nodes) : parent(nodes) {};
+  private:
+    Nodes& parent;
+    future<std::unique_ptr<reply>> handle(const sstring& path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) override;
+  };
+
 
 private:
   Graph& graph;
+  // Pages resume from a cursor, streams write every page of the scan as it arrives
+  future<std::unique_ptr<reply>> GetNodesFromCursor(Cursor cursor, uint64_t limit, bool stream, std::unique_ptr<reply> rep);
+  future<std::unique_ptr<reply>> ScanNodes(Cursor cursor, uint64_t limit, bool stream, std::unique_ptr<reply> rep);
   GetNodesHandler getNodesHandler;
   GetNodesOfTypeHandler getNodesOfTypeHandler;
   GetNodeHandler getNodeHandler;
+  GetNodeShardHandler getNodeShardHandler;
+  PutNodeShardHandler putNodeShardHandler;
   GetNodeByIdHandler getNodeByIdHandler;
   PostNodeHandler postNodeHandler;
+  PostNodesHandler postNodesHandler;
   DeleteNodeHandler deleteNodeHandler;
   DeleteNodeByIdHandler deleteNodeByIdHandler;
+  DeleteNodesHandler deleteNodesHandler;
+  DeleteNodesOfTypeHandler deleteNodesOfTypeHandler;
 
 public:
-  explicit Nodes(Graph &graph) : graph(graph), getNodesHandler(*this), getNodesOfTypeHandler(*this), getNodeHandler(*this), getNodeByIdHandler(*this), postNodeHandler(*this), deleteNodeHandler(*this), deleteNodeByIdHandler(*this) {}
+  explicit Nodes(Graph &graph) : graph(graph), getNodesHandler(*this), getNodesOfTypeHandler(*this), getNodeHandler(*this), getNodeShardHandler(*this), putNodeShardHandler(*this), getNodeByIdHandler(*this), postNodeHandler(*this), postNodesHandler(*this), deleteNodeHandler(*this), deleteNodeByIdHandler(*this), deleteNodesHandler(*this), deleteNodesOfTypeHandler(*this) {}
   void set_routes(routes& routes);
 };
 
@@ -0,0 +1,126 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "JSON.h"
+#include "Paths.h"
+#include <boost/algorithm/string.hpp>
+
+void Paths::set_routes(routes &routes) {
+
+  auto getPath = new match_rule(Server::timed(graph, "GET /path/{type}/{key}/{type2}/{key2}", &getPathHandler));
+  getPath->add_str("/db/" + graph.GetName() + "/path");
+  getPath->add_param("type");
+  getPath->add_param("key");
+  getPath->add_param("type2");
+  getPath->add_param("key2");
+  routes.add(getPath, operation_type::GET);
+
+  auto getPathById = new match_rule(Server::timed(graph, "GET /path/{id}/{id2}", &getPathByIdHandler));
+  getPathById->add_str("/db/" + graph.GetName() + "/path");
+  getPathById->add_param("id");
+  getPathById->add_param("id2");
+  routes.add(getPathById, operation_type::GET);
+
+}
+
+// ?direction=out&rel_types=FRIENDS,LIKES&max_depth=6, every one optional
+static void validate_path_options(const std::unique_ptr<request> &req, Direction &direction, std::vector<std::string> &rel_types, uint64_t &max_depth) {
+  std::string direction_param = req->get_query_param("direction");
+  boost::algorithm::to_lower(direction_param);
+  direction = direction_param == "in" ? IN : direction_param == "out" ? OUT : BOTH;
+
+  std::string rel_types_param = req->get_query_param("rel_types");
+  if (!rel_types_param.empty()) {
+    boost::split(rel_types, rel_types_param, [](char c){ return c == ','; });
+  }
+
+  max_depth = std::numeric_limits<uint64_t>::max();
+  std::string max_depth_param = req->get_query_param("max_depth");
+  if (!max_depth_param.empty()) {
+    try {
+      max_depth = std::stoull(max_depth_param);
+    } catch (std::exception&) {
+      // Leave the depth unbounded
+    }
+  }
+}
+
+future<std::unique_ptr<reply>> Paths::write_path(std::vector<Ids> path, std::unique_ptr<reply> rep) {
+  std::vector<uint64_t> node_ids;
+  std::vector<uint64_t> rel_ids;
+  for (const Ids& ids : path) {
+    node_ids.push_back(ids.node_id);
+    // The first node was not reached over a relationship
+    if (ids.rel_id > 0) {
+      rel_ids.push_back(ids.rel_id);
+    }
+  }
+
+  return graph.shard.local().NodesGetPeered(node_ids).then([rel_ids = std::move(rel_ids), rep = std::move(rep), this] (std::vector<Node> nodes) mutable {
+         return graph.shard.local().RelationshipsGetPeered(rel_ids).then([nodes = std::move(nodes), rep = std::move(rep), this] (std::vector<Relationship> relationships) mutable {
+                json_entities_builder json_nodes(graph, nodes.size());
+                for(Node& n : nodes) {
+                  json_nodes.add(n);
+                }
+                json_entities_builder json_relationships(graph, relationships.size());
+                for(Relationship& r : relationships) {
+                  json_relationships.add(r);
+                }
+                rep->write_body("json", sstring("{\"nodes\": " + json_nodes.as_json() + ", \"relationships\": " + json_relationships.as_json() + "}"));
+                return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+         });
+  });
+}
+
+future<std::unique_ptr<reply>> Paths::GetPathHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  bool valid_type = Server::validate_parameter(Server::TYPE, req, rep, "Invalid type");
+  bool valid_key = Server::validate_parameter(Server::KEY, req, rep, "Invalid key");
+  bool valid_type2 = Server::validate_parameter(Server::TYPE2, req, rep, "Invalid type2");
+  bool valid_key2 = Server::validate_parameter(Server::KEY2, req, rep, "Invalid key2");
+
+  if(valid_type && valid_key && valid_type2 && valid_key2) {
+    Direction direction;
+    std::vector<std::string> rel_types;
+    uint64_t max_depth;
+    validate_path_options(req, direction, rel_types, max_depth);
+
+    return parent.graph.shard.local().ShortestPathPeered(req->param[Server::TYPE], req->param[Server::KEY], req->param[Server::TYPE2], req->param[Server::KEY2], direction, rel_types, max_depth)
+      .then([rep = std::move(rep), this] (std::vector<Ids> found) mutable {
+             return parent.write_path(std::move(found), std::move(rep));
+      });
+  }
+
+  return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+}
+
+future<std::unique_ptr<reply>> Paths::GetPathByIdHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  uint64_t id = Server::validate_id(req, rep);
+  uint64_t id2 = Server::validate_id2(req, rep);
+
+  if (id > 0 && id2 > 0) {
+    Direction direction;
+    std::vector<std::string> rel_types;
+    uint64_t max_depth;
+    validate_path_options(req, direction, rel_types, max_depth);
+
+    return parent.graph.shard.local().ShortestPathPeered(id, id2, direction, rel_types, max_depth)
+      .then([rep = std::move(rep), this] (std::vector<Ids> found) mutable {
+             return parent.write_path(std::move(found), std::move(rep));
+      });
+  }
+
+  return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+}
@@ -0,0 +1,166 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "JSON.h"
+#include "Recents.h"
+#include <limits>
+
+void Recents::set_routes(routes &routes) {
+
+  auto postRecent = new match_rule(Server::timed(graph, "POST /recent/{rel_type}/{property}", &postRecentHandler));
+  postRecent->add_str("/db/" + graph.GetName() + "/recent");
+  postRecent->add_param("rel_type");
+  postRecent->add_param("property");
+  routes.add(postRecent, operation_type::POST);
+
+  auto deleteRecent = new match_rule(Server::timed(graph, "DELETE /recent/{rel_type}", &deleteRecentHandler));
+  deleteRecent->add_str("/db/" + graph.GetName() + "/recent");
+  deleteRecent->add_param("rel_type");
+  routes.add(deleteRecent, operation_type::DELETE);
+
+  auto getNodeRecent = new match_rule(Server::timed(graph, "GET /node/{type}/{key}/recent/{rel_type}", &getNodeRecentHandler));
+  getNodeRecent->add_str("/db/" + graph.GetName() + "/node");
+  getNodeRecent->add_param("type");
+  getNodeRecent->add_param("key");
+  getNodeRecent->add_str("/recent");
+  getNodeRecent->add_param("rel_type");
+  routes.add(getNodeRecent, operation_type::GET);
+
+  auto getNodeRecentById = new match_rule(Server::timed(graph, "GET /node/{id}/recent/{rel_type}", &getNodeRecentByIdHandler));
+  getNodeRecentById->add_str("/db/" + graph.GetName() + "/node");
+  getNodeRecentById->add_param("id");
+  getNodeRecentById->add_str("/recent");
+  getNodeRecentById->add_param("rel_type");
+  routes.add(getNodeRecentById, operation_type::GET);
+
+}
+
+bool Recents::validate_window(const std::unique_ptr<request> &req, std::unique_ptr<reply> &rep, int64_t &since, int64_t &until) {
+  since = std::numeric_limits<int64_t>::min();
+  until = std::numeric_limits<int64_t>::max();
+  sstring since_param = req->get_query_param("since");
+  sstring until_param = req->get_query_param("until");
+  try {
+    if (!since_param.empty()) {
+      since = std::stoll(since_param);
+    }
+  } catch (std::exception& e) {
+    rep->write_body("json", std::move(json::stream_object("Invalid since parameter")));
+    rep->set_status(reply::status_type::bad_request);
+    return false;
+  }
+  try {
+    if (!until_param.empty()) {
+      until = std::stoll(until_param);
+    }
+  } catch (std::exception& e) {
+    rep->write_body("json", std::move(json::stream_object("Invalid until parameter")));
+    rep->set_status(reply::status_type::bad_request);
+    return false;
+  }
+  return true;
+}
+
+future<std::unique_ptr<reply>> Recents::RecentRelationships(future<std::vector<Relationship>> found, std::unique_ptr<reply> rep) {
+  return found.then([rep = std::move(rep), this] (const std::vector<Relationship>& relationships) mutable {
+         json_entities_builder json(graph, relationships.size());
+         for(const Relationship& r : relationships) {
+           json.add(r);
+         }
+         rep->write_body("json", sstring(json.as_json()));
+         return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+  });
+}
+
+future<std::unique_ptr<reply>> Recents::PostRecentHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  bool valid_rel_type = Server::validate_parameter(Server::REL_TYPE, req, rep, "Invalid rel_type");
+  bool valid_property = Server::validate_parameter(Server::PROPERTY, req, rep, "Invalid property");
+
+  if (valid_rel_type && valid_property) {
+    bool stamp = req->get_query_param("stamp") == "true";
+    uint64_t ttl = 0;
+    sstring ttl_param = req->get_query_param("ttl");
+    try {
+      if (!ttl_param.empty()) {
+        ttl = std::stoull(ttl_param);
+      }
+    } catch (std::exception& e) {
+      rep->write_body("json", std::move(json::stream_object("Invalid ttl parameter")));
+      rep->set_status(reply::status_type::bad_request);
+      return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+    }
+
+    return parent.graph.shard.local().RelationshipRecencyIndexCreatePeered(req->param[Server::REL_TYPE], req->param[Server::PROPERTY], stamp, ttl)
+      .then([rep = std::move(rep)] (bool created) mutable {
+             if (created) {
+               rep->set_status(reply::status_type::created);
+             } else {
+               rep->write_body("json", std::move(json::stream_object("Invalid rel_type or the index exists with another property, stamp or ttl")));
+               rep->set_status(reply::status_type::bad_request);
+             }
+             return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+      });
+  }
+  return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+}
+
+future<std::unique_ptr<reply>> Recents::DeleteRecentHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  bool valid_rel_type = Server::validate_parameter(Server::REL_TYPE, req, rep, "Invalid rel_type");
+
+  if (valid_rel_type) {
+    return parent.graph.shard.local().RelationshipRecencyIndexDropPeered(req->param[Server::REL_TYPE])
+      .then([rep = std::move(rep)] (bool dropped) mutable {
+             if (dropped) {
+               rep->set_status(reply::status_type::no_content);
+             } else {
+               rep->set_status(reply::status_type::not_modified);
+             }
+             return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+      });
+  }
+  return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+}
+
+future<std::unique_ptr<reply>> Recents::GetNodeRecentHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  bool valid_type = Server::validate_parameter(Server::TYPE, req, rep, "Invalid type");
+  bool valid_key = Server::validate_parameter(Server::KEY, req, rep, "Invalid key");
+  bool valid_rel_type = Server::validate_parameter(Server::REL_TYPE, req, rep, "Invalid rel_type");
+  int64_t since;
+  int64_t until;
+
+  if (valid_type && valid_key && valid_rel_type && validate_window(req, rep, since, until)) {
+    uint64_t limit = Server::validate_limit(req, rep);
+    NodeProjection projection = Server::validate_projection(req);
+    return parent.RecentRelationships(parent.graph.shard.local().NodeGetRecentRelationshipsPeered(req->param[Server::TYPE], req->param[Server::KEY],
+                                      req->param[Server::REL_TYPE], since, until, limit, projection), std::move(rep));
+  }
+  return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+}
+
+future<std::unique_ptr<reply>> Recents::GetNodeRecentByIdHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  uint64_t id = Server::validate_id(req, rep);
+  bool valid_rel_type = Server::validate_parameter(Server::REL_TYPE, req, rep, "Invalid rel_type");
+  int64_t since;
+  int64_t until;
+
+  if (id > 0 && valid_rel_type && validate_window(req, rep, since, until)) {
+    uint64_t limit = Server::validate_limit(req, rep);
+    NodeProjection projection = Server::validate_projection(req);
+    return parent.RecentRelationships(parent.graph.shard.local().NodeGetRecentRelationshipsPeered(id, req->param[Server::REL_TYPE], since, until, limit, projection),
+                                      std::move(rep));
+  }
+  return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRITON_RECENTS_H
+#define TRITON_RECENTS_H
+
+#include "Server.h"
+#include <Graph.h>
+#include <seastar/http/httpd.hh>
+
+using namespace seastar;
+using namespace httpd;
+using namespace triton;
+
+class Recents {
+
+  class PostRecentHandler : public httpd::handler_base {
+  public:
+    explicit PostRecentHandler(Recents& recents) : parent(recents) {};
+
+  private:
+    Recents& parent;
+    future<std::unique_ptr<reply>> handle(const sstring& path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) override;
+  };
+
+  class DeleteRecentHandler : public httpd::handler_base {
+  public:
+    explicit DeleteRecentHandler(Recents& recents) : parent(recents) {};
+
+  private:
+    Recents& parent;
+    future<std::unique_ptr<reply>> handle(const sstring& path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) override;
+  };
+
+  class GetNodeRecentHandler : public httpd::handler_base {
+  public:
+    explicit GetNodeRecentHandler(Recents& recents) : parent(recents) {};
+
+  private:
+    Recents& parent;
+    future<std::unique_ptr<reply>> handle(const sstring& path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) override;
+  };
+
+  class GetNodeRecentByIdHandler : public httpd::handler_base {
+  public:
+    explicit GetNodeRecentByIdHandler(Recents& recents) : parent(recents) {};
+
+  private:
+    Recents& parent;
+    future<std::unique_ptr<reply>> handle(const sstring& path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) override;
+  };
+
+private:
+  Graph& graph;
+  PostRecentHandler postRecentHandler;
+  DeleteRecentHandler deleteRecentHandler;
+  GetNodeRecentHandler getNodeRecentHandler;
+  GetNodeRecentByIdHandler getNodeRecentByIdHandler;
+  // The since and until query parameters, false after writing the bad request
+  static bool validate_window(const std::unique_ptr<request> &req, std::unique_ptr<reply> &rep, int64_t &since, int64_t &until);
+  future<std::unique_ptr<reply>> RecentRelationships(future<std::vector<Relationship>> found, std::unique_ptr<reply> rep);
+
+public:
+  explicit Recents(Graph &graph) : graph(graph), postRecentHandler(*this), deleteRecentHandler(*this), getNodeRecentHandler(*this), getNodeRecentByIdHandler(*this) {}
+  void set_routes(routes& routes);
+};
+
+
+#endif//TRITON_RECENTS_H
@@ -19,46 +19,46 @@
 
 void RelationshipProperties::set_routes(routes &routes) {
 
-  auto getRelationshipPropertyById = new match_rule(&getRelationshipPropertyByIdHandler);
+  auto getRelationshipPropertyById = new match_rule(Server::timed(graph, "GET /relationship/{id}/property/{property}", &getRelationshipPropertyByIdHandler));
   getRelationshipPropertyById->add_str("/db/" + graph.GetName() + "/relationship");
   getRelationshipPropertyById->add_param("id");
   getRelationshipPropertyById->add_str("/property");
   getRelationshipPropertyById->add_param("property");
   routes.add(getRelationshipPropertyById, operation_type::GET);
 
-  auto putRelationshipPropertyById = new match_rule(&putRelationshipPropertyByIdHandler);
+  auto putRelationshipPropertyById = new match_rule(Server::timed(graph, "PUT /relationship/{id}/property/{property}", &putRelationshipPropertyByIdHandler));
   putRelationshipPropertyById->add_str("/db/" + graph.GetName() + "/relationship");
   putRelationshipPropertyById->add_param("id");
   putRelationshipPropertyById->add_str("/property");
   putRelationshipPropertyById->add_param("property");
   routes.add(putRelationshipPropertyById, operation_type::PUT);
 
-  auto deleteRelationshipPropertyById = new match_rule(&deleteRelationshipPropertyByIdHandler);
+  auto deleteRelationshipPropertyById = new match_rule(Server::timed(graph, "DELETE /relationship/{id}/property/{property}", &deleteRelationshipPropertyByIdHandler));
   deleteRelationshipPropertyById->add_str("/db/" + graph.GetName() + "/relationship");
   deleteRelationshipPropertyById->add_param("id");
   deleteRelationshipPropertyById->add_str("/property");
   deleteRelationshipPropertyById->add_param("property");
   routes.add(deleteRelationshipPropertyById, operation_type::DELETE);
 
-  auto getRelationshipPropertiesById = new match_rule(&getRelationshipPropertiesByIdHandler);
+  auto getRelationshipPropertiesById = new match_rule(Server::timed(graph, "GET /relationship/{id}/properties", &getRelationshipPropertiesByIdHandler));
   getRelationshipPropertiesById->add_str("/db/" + graph.GetName() + "/relationship");
   getRelationshipPropertiesById->add_param("id");
   getRelationshipPropertiesById->add_str("/properties");
   routes.add(getRelationshipPropertiesById, operation_type::GET);
 
-  auto postRelationshipPropertiesById = new match_rule(&postRelationshipPropertiesByIdHandler);
+  auto postRelationshipPropertiesById = new match_rule(Server::timed(graph, "POST /relationship/{id}/properties", &postRelationshipPropertiesByIdHandler));
   postRelationshipPropertiesById->add_str("/db/" + graph.GetName() + "/relationship");
   postRelationshipPropertiesById->add_param("id");
   postRelationshipPropertiesById->add_str("/properties");
   routes.add(postRelationshipPropertiesById, operation_type::POST);
 
-  auto putRelationshipPropertiesById = new match_rule(&putRelationshipPropertiesByIdHandler);
+  auto putRelationshipPropertiesById = new match_rule(Server::timed(graph, "PUT /relationship/{id}/properties", &putRelationshipPropertiesByIdHandler));
   putRelationshipPropertiesById->add_str("/db/" + graph.GetName() + "/relationship");
   putRelationshipPropertiesById->add_param("id");
   putRelationshipPropertiesById->add_str("/properties");
   routes.add(putRelationshipPropertiesById, operation_type::PUT);
 
-  auto deleteRelationshipPropertiesById = new match_rule(&deleteRelationshipPropertiesByIdHandler);
+  auto deleteRelationshipPropertiesById = new match_rule(Server::timed(graph, "DELETE /relationship/{id}/properties", &deleteRelationshipPropertiesByIdHandler));
   deleteRelationshipPropertiesById->add_str("/db/" + graph.GetName() + "/relationship");
   deleteRelationshipPropertiesById->add_param("id");
   deleteRelationshipPropertiesById->add_str("/properties");
@@ -20,21 +20,21 @@
 
 void Relationships::set_routes(routes &routes) {
 
-  auto getRelationships = new match_rule(&getRelationshipsHandler);
+  auto getRelationships = new match_rule(Server::timed(graph, "GET /relationships", &getRelationshipsHandler));
   getRelationships->add_str("/db/" + graph.GetName() + "/relationships");
   routes.add(getRelationships, operation_type::GET);
 
-  auto getgetRelationshipsOfType = new match_rule(&getRelationshipsOfTypeHandler);
+  auto getgetRelationshipsOfType = new match_rule(Server::timed(graph, "GET /relationships/{type}", &getRelationshipsOfTypeHandler));
   getgetRelationshipsOfType->add_str("/db/" + graph.GetName() + "/relationships");
   getgetRelationshipsOfType->add_param("type");
   routes.add(getgetRelationshipsOfType, operation_type::GET);
 
-  auto getRelationship = new match_rule(&getRelationshipHandler);
+  auto getRelationship = new match_rule(Server::timed(graph, "GET /relationship/{id}", &getRelationshipHandler));
   getRelationship->add_str("/db/" + graph.GetName() + "/relationship");
   getRelationship->add_param("id");
   routes.add(getRelationship, operation_type::GET);
 
-  auto postRelationshipById = new match_rule(&postRelationshipByIdHandler);
+  auto postRelationshipById = new match_rule(Server::timed(graph, "POST /node/{id}/relationship/{id2}/{rel_type}", &postRelationshipByIdHandler));
   postRelationshipById->add_str("/db/" + graph.GetName() + "/node");
   postRelationshipById->add_param("id");
   postRelationshipById->add_str("/relationship");
@@ -42,7 +42,7 @@ void Relationships::set_routes(routes &routes) {
   postRelationshipById->add_param("rel_type");
   routes.add(postRelationshipById, operation_type::POST);
 
-  auto postRelationship = new match_rule(&postRelationshipHandler);
+  auto postRelationship = new match_rule(Server::timed(graph, "POST /node/{type}/{key}/relationship/{type2}/{key2}/{rel_type}", &postRelationshipHandler));
   postRelationship->add_str("/db/" + graph.GetName() + "/node");
   postRelationship->add_param("type");
   postRelationship->add_param("key");
@@ -52,12 +52,16 @@ void Relationships::set_routes(routes &routes) {
   postRelationship->add_param("rel_type");
   routes.add(postRelationship, operation_type::POST);
 
-  auto deleteRelationship = new match_rule(&deleteRelationshipHandler);
+  auto postRelationships = new match_rule(Server::timed(graph, "POST /relationships", &postRelationshipsHandler));
+  postRelationships->add_str("/db/" + graph.GetName() + "/relationships");
+  routes.add(postRelationships, operation_type::POST);
+
+  auto deleteRelationship = new match_rule(Server::timed(graph, "DELETE /relationship/{id}", &deleteRelationshipHandler));
   deleteRelationship->add_str("/db/" + graph.GetName() + "/relationship");
   deleteRelationship->add_param("id");
   routes.add(deleteRelationship, operation_type::DELETE);
 
-  auto getNodeRelationships = new match_rule(&getNodeRelationshipsHandler);
+  auto getNodeRelationships = new match_rule(Server::timed(graph, "GET /node/{type}/{key}/relationships", &getNodeRelationshipsHandler));
   getNodeRelationships->add_str("/db/" + graph.GetName() + "/node");
   getNodeRelationships->add_param("type");
   getNodeRelationships->add_param("key");
@@ -65,26 +69,129 @@ void Relationships::set_routes(routes &routes) {
   getNodeRelationships->add_param("options", true);
   routes.add(getNodeRelationships, operation_type::GET);
 
-  auto getRelationshipsById = new match_rule(&getNodeRelationshipsByIdHandler);
+  auto getRelationshipsById = new match_rule(Server::timed(graph, "GET /node/{id}/relationships", &getNodeRelationshipsByIdHandler));
   getRelationshipsById->add_str("/db/" + graph.GetName() + "/node");
   getRelationshipsById->add_param("id");
   getRelationshipsById->add_str("/relationships");
   getRelationshipsById->add_param("options", true);
   routes.add(getRelationshipsById, operation_type::GET);
+
+  // After the routes above, since "/relationship" also matches the start of "/relationships"
+  auto getRelationshipByIds = new match_rule(Server::timed(graph, "GET /node/{id}/relationship/{id2}/{rel_type}", &getRelationshipByIdsHandler));
+  getRelationshipByIds->add_str("/db/" + graph.GetName() + "/node");
+  getRelationshipByIds->add_param("id");
+  getRelationshipByIds->add_str("/relationship");
+  getRelationshipByIds->add_param("id2");
+  getRelationshipByIds->add_param("rel_type");
+  routes.add(getRelationshipByIds, operation_type::GET);
+
+  auto putRelationshipById = new match_rule(Server::timed(graph, "PUT /node/{id}/relationship/{id2}/{rel_type}", &putRelationshipByIdHandler));
+  putRelationshipById->add_str("/db/" + graph.GetName() + "/node");
+  putRelationshipById->add_param("id");
+  putRelationshipById->add_str("/relationship");
+  putRelationshipById->add_param("id2");
+  putRelationshipById->add_param("rel_type");
+  routes.add(putRelationshipById, operation_type::PUT);
+
+  auto putRelationship = new match_rule(Server::timed(graph, "PUT /node/{type}/{key}/relationship/{type2}/{key2}/{rel_type}", &putRelationshipHandler));
+  putRelationship->add_str("/db/" + graph.GetName() + "/node");
+  putRelationship->add_param("type");
+  putRelationship->add_param("key");
+  putRelationship->add_str("/relationship");
+  putRelationship->add_param("type2");
+  putRelationship->add_param("key2");
+  putRelationship->add_param("rel_type");
+  routes.add(putRelationship, operation_type::PUT);
+}
+
+future<std::unique_ptr<reply>> Relationships::GetRelationshipsFromCursor(Cursor cursor, uint64_t limit, bool stream, NodeProjection projection, std::unique_ptr<reply> rep) {
+  if (cursor.view == 0) {
+    return ScanRelationships(cursor, limit, stream, projection, std::move(rep));
+  }
+  // A view that expired or was closed would otherwise read as an empty scan
+  return graph.shard.local().ReadViewExistsPeered(cursor.view)
+    .then([cursor, limit, stream, projection, rep = std::move(rep), this] (bool exists) mutable {
+           if (!exists) {
+             rep->write_body("json", std::move(json::stream_object("Unknown view")));
+             rep->set_status(reply::status_type::not_found);
+             return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+           }
+           return ScanRelationships(cursor, limit, stream, projection, std::move(rep));
+    });
+}
+
+future<std::unique_ptr<reply>> Relationships::ScanRelationships(Cursor cursor, uint64_t limit, bool stream, NodeProjection projection, std::unique_ptr<reply> rep) {
+  if (stream) {
+    // Limit is the size of each page of the scan, the stream goes on until the scan is finished
+    limit = std::max(limit, uint64_t(1));
+    rep->write_body("json", [cursor, limit, projection, this] (output_stream<char>&& output) {
+      return do_with(std::move(output), cursor, true, [limit, projection, this] (output_stream<char>& out, Cursor& cursor, bool& first) {
+        return out.write("[").then([&out, &cursor, &first, limit, projection, this] {
+          return repeat([&out, &cursor, &first, limit, projection, this] {
+            return graph.shard.local().AllRelationshipsPeered(cursor, limit, projection).then([&out, &cursor, &first, this] (std::pair<std::vector<Relationship>, Cursor> page) {
+              cursor = page.second;
+              std::string chunk;
+              for(Relationship& r : page.first) {
+                if (!first) {
+                  chunk.append(",");
+                }
+                first = false;
+                json_entities_builder::append(chunk, r, graph.shard.local().RelationshipTypeGetType(r.getTypeId()));
+              }
+              return out.write(chunk).then([&out] {
+                return out.flush();
+              }).then([&cursor] {
+                return cursor.finished ? stop_iteration::yes : stop_iteration::no;
+              });
+            });
+          });
+        }).then([&out] {
+          return out.write("]");
+        }).finally([&out] {
+          return out.close();
+        });
+      });
+    });
+    return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+  }
+
+  return graph.shard.local().AllRelationshipsPeered(cursor, limit, projection)
+    .then([rep = std::move(rep), this] (std::pair<std::vector<Relationship>, Cursor> page) mutable {
+           // The next page starts from here, no header once everything has been read
+           if (!page.second.finished) {
+             rep->add_header("X-Cursor", page.second.toString());
+           }
+           json_entities_builder json(graph, page.first.size());
+           for(Relationship& r : page.first) {
+             json.add(r);
+           }
+           rep->write_body("json", sstring(json.as_json()));
+           return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+    });
 }
 
 future<std::unique_ptr<reply>> Relationships::GetRelationshipsHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
   uint64_t limit = Server::validate_limit(req, rep);
   uint64_t offset = Server::validate_offset(req, rep);
+  NodeProjection projection = Server::validate_projection(req);
+
+  bool stream = Server::validate_stream(req);
+  if (stream || !req->get_query_param("cursor").empty() || !req->get_query_param("view").empty()) {
+    Cursor cursor;
+    if (!Server::validate_cursor(req, rep, cursor)) {
+      return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+    }
+    cursor.type_id = 0;
+    return parent.GetRelationshipsFromCursor(cursor, limit, stream, projection, std::move(rep));
+  }
 
-    return parent.graph.shard.local().AllRelationshipsPeered(offset, limit)
+    return parent.graph.shard.local().AllRelationshipsPeered(offset, limit, projection)
       .then([rep = std::move(rep), this] (const std::vector<Relationship>& relationships) mutable {
-             std::vector<relationship_json> json_array;
-             json_array.reserve(relationships.size());
-             for(Relationship r : relationships) {
-               json_array.emplace_back(r, parent.graph);
+             json_entities_builder json(parent.graph, relationships.size());
+             for(const Relationship& r : relationships) {
+               json.add(r);
              }
-             rep->write_body("json", std::move(json::stream_object(json_array)));
+             rep->write_body("json", sstring(json.as_json()));
              return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
       });
 }
@@ -95,17 +202,34 @@ future<std::unique_ptr<reply>> Relationships::GetRelationshipsOfTypeHandler::han
   if(valid_type) {
     uint64_t limit = Server::validate_limit(req, rep);
     uint64_t offset = Server::validate_offset(req, rep);
+    NodeProjection projection = Server::validate_projection(req);
+
+    bool stream = Server::validate_stream(req);
+    if (stream || !req->get_query_param("cursor").empty() || !req->get_query_param("view").empty()) {
+      Cursor cursor;
+      uint16_t type_id = parent.graph.shard.local().RelationshipTypeGetTypeId(req->param[Server::TYPE]);
+      // Without the type the scan would walk every slot only to keep none of them
+      if (type_id == 0) {
+        rep->write_body("json", std::move(json::stream_object("Unknown type")));
+        rep->set_status(reply::status_type::not_found);
+        return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+      }
+      if (!Server::validate_cursor(req, rep, cursor)) {
+        return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+      }
+      cursor.type_id = type_id;
+      return parent.GetRelationshipsFromCursor(cursor, limit, stream, projection, std::move(rep));
+    }
 
-    return parent.graph.shard.local().AllRelationshipsPeered(req->param[Server::TYPE], offset, limit)
+    return parent.graph.shard.local().AllRelationshipsPeered(req->param[Server::TYPE], offset, limit, projection)
       .then([rep = std::move(rep), this](const std::vector<Relationship>& relationships) mutable {
-             std::vector<relationship_json> json_array;
-             json_array.reserve(relationships.size());
+             json_entities_builder json(parent.graph, relationships.size());
              if (!relationships.empty()) {
                std::string type = parent.graph.shard.local().RelationshipTypeGetType(relationships.front().getTypeId());
-               for(Relationship r : relationships) {
-                 json_array.emplace_back(r, type);
+               for(const Relationship& r : relationships) {
+                 json.add(r, type);
                }
-               rep->write_body("json", std::move(json::stream_object(json_array)));
+               rep->write_body("json", sstring(json.as_json()));
                return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
              }
              return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
@@ -222,6 +346,27 @@ future<std::unique_ptr<reply>> Relationships::PostRelationshipByIdHandler::handl
   return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
 }
 
+future<std::unique_ptr<reply>> Relationships::PostRelationshipsHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  // If there are no relationships
+  if (req->content.empty()) {
+    rep->write_body("json", std::move(json::stream_object("Empty relationships")));
+    rep->set_status(reply::status_type::bad_request);
+    return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+  }
+
+  return parent.graph.shard.local().RelationshipsAddFromJsonPeered(req->content.c_str())
+    .then([rep = std::move(rep)](const std::vector<uint64_t>& ids) mutable {
+    if (ids.empty()) {
+      rep->write_body("json", std::move(json::stream_object("Invalid Request")));
+      rep->set_status(reply::status_type::bad_request);
+    } else {
+      rep->write_body("json", std::move(json::stream_object(ids)));
+      rep->set_status(reply::status_type::created);
+    }
+    return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+  });
+}
+
 future<std::unique_ptr<reply>> Relationships::DeleteRelationshipHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
   uint64_t id = Server::validate_id(req, rep);
 
@@ -248,18 +393,39 @@ future<std::unique_ptr<reply>> Relationships::GetNodeRelationshipsHandler::handl
     // Gather Options
     std::string options_string;
     Direction direction = BOTH;
+
+    // A limit, offset or filter is applied on the shards holding the relationships
+    if (Server::validate_paged(req)) {
+      std::vector<std::string> rel_types;
+      std::vector<ScanFilter> filters;
+      if (!Server::validate_options(req, rep, direction, rel_types) || !Server::validate_filters(req, rep, filters)) {
+        return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+      }
+      uint64_t limit = Server::validate_limit(req, rep);
+      uint64_t offset = Server::validate_offset(req, rep);
+      NodeProjection projection = Server::validate_projection(req);
+      return parent.graph.shard.local().NodeGetRelationshipsPeered(req->param[Server::TYPE], req->param[Server::KEY], direction, rel_types, filters, offset, limit, projection)
+        .then([rep = std::move(rep), this] (const std::vector<Relationship>& relationships) mutable {
+               json_entities_builder json(parent.graph, relationships.size());
+               for(const Relationship& r : relationships) {
+                 json.add(r);
+               }
+               rep->write_body("json", sstring(json.as_json()));
+               return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+        });
+    }
+
     options_string = req->param.at(Server::OPTIONS).c_str();
 
     if(options_string.empty()) {
       // Get Node Relationships
       return parent.graph.shard.local().NodeGetRelationshipsPeered(req->param[Server::TYPE], req->param[Server::KEY])
         .then([rep = std::move(rep), this] (const std::vector<Relationship>& relationships) mutable {
-          std::vector<relationship_json> json_array;
-          json_array.reserve(relationships.size());
-          for(Relationship r : relationships) {
-            json_array.emplace_back(r, parent.graph);
+          json_entities_builder json(parent.graph, relationships.size());
+          for(const Relationship& r : relationships) {
+            json.add(r);
           }
-          rep->write_body("json", std::move(json::stream_object(json_array)));
+          rep->write_body("json", sstring(json.as_json()));
           return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
         });
     }
@@ -283,12 +449,11 @@ future<std::unique_ptr<reply>> Relationships::GetNodeRelationshipsHandler::handl
       // Get Node Degree with Direction
       return parent.graph.shard.local().NodeGetRelationshipsPeered(req->param[Server::TYPE], req->param[Server::KEY], direction)
         .then([rep = std::move(rep), this] (const std::vector<Relationship>& relationships) mutable {
-               std::vector<relationship_json> json_array;
-               json_array.reserve(relationships.size());
-               for(Relationship r : relationships) {
-                 json_array.emplace_back(r, parent.graph);
+               json_entities_builder json(parent.graph, relationships.size());
+               for(const Relationship& r : relationships) {
+                 json.add(r);
                }
-               rep->write_body("json", std::move(json::stream_object(json_array)));
+               rep->write_body("json", sstring(json.as_json()));
                return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
         });
     case 2: {
@@ -298,13 +463,12 @@ future<std::unique_ptr<reply>> Relationships::GetNodeRelationshipsHandler::handl
       // Single Relationship Type
       if (rel_types.size() == 1) {
         return parent.graph.shard.local().NodeGetRelationshipsPeered(req->param[Server::TYPE], req->param[Server::KEY], direction, rel_types[0])
-          .then([rep = std::move(rep), rel_type = rel_types[0]] (const std::vector<Relationship>& relationships) mutable {
-                 std::vector<relationship_json> json_array;
-                 json_array.reserve(relationships.size());
-                 for(Relationship r : relationships) {
-                   json_array.emplace_back(r, rel_type);
+          .then([rep = std::move(rep), rel_type = rel_types[0], this] (const std::vector<Relationship>& relationships) mutable {
+                 json_entities_builder json(parent.graph, relationships.size());
+                 for(const Relationship& r : relationships) {
+                   json.add(r, rel_type);
                  }
-                 rep->write_body("json", std::move(json::stream_object(json_array)));
+                 rep->write_body("json", sstring(json.as_json()));
                  return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
           });
       }
@@ -312,12 +476,11 @@ future<std::unique_ptr<reply>> Relationships::GetNodeRelationshipsHandler::handl
       // Multiple Relationship Types
       return parent.graph.shard.local().NodeGetRelationshipsPeered(req->param[Server::TYPE], req->param[Server::KEY], direction, rel_types)
         .then([rep = std::move(rep), this] (const std::vector<Relationship>& relationships) mutable {
-               std::vector<relationship_json> json_array;
-               json_array.reserve(relationships.size());
-               for(Relationship r : relationships) {
-                 json_array.emplace_back(r, parent.graph);
+               json_entities_builder json(parent.graph, relationships.size());
+               for(const Relationship& r : relationships) {
+                 json.add(r);
                }
-               rep->write_body("json", std::move(json::stream_object(json_array)));
+               rep->write_body("json", sstring(json.as_json()));
                return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
         });
     }
@@ -340,18 +503,39 @@ future<std::unique_ptr<reply>> Relationships::GetNodeRelationshipsByIdHandler::h
     // Gather Options
     std::string options_string;
     Direction direction = BOTH;
+
+    // A limit, offset or filter is applied on the shards holding the relationships
+    if (Server::validate_paged(req)) {
+      std::vector<std::string> rel_types;
+      std::vector<ScanFilter> filters;
+      if (!Server::validate_options(req, rep, direction, rel_types) || !Server::validate_filters(req, rep, filters)) {
+        return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+      }
+      uint64_t limit = Server::validate_limit(req, rep);
+      uint64_t offset = Server::validate_offset(req, rep);
+      NodeProjection projection = Server::validate_projection(req);
+      return parent.graph.shard.local().NodeGetRelationshipsPeered(id, direction, rel_types, filters, offset, limit, projection)
+        .then([rep = std::move(rep), this] (const std::vector<Relationship>& relationships) mutable {
+               json_entities_builder json(parent.graph, relationships.size());
+               for(const Relationship& r : relationships) {
+                 json.add(r);
+               }
+               rep->write_body("json", sstring(json.as_json()));
+               return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+        });
+    }
+
     options_string = req->param.at(Server::OPTIONS).c_str();
 
     if(options_string.empty()) {
       // Get Node Relationships
       return parent.graph.shard.local().NodeGetRelationshipsPeered(id)
         .then([rep = std::move(rep), this] (const std::vector<Relationship>& relationships) mutable {
-               std::vector<relationship_json> json_array;
-               json_array.reserve(relationships.size());
-               for(Relationship r : relationships) {
-                 json_array.emplace_back(r, parent.graph);
+               json_entities_builder json(parent.graph, relationships.size());
+               for(const Relationship& r : relationships) {
+                 json.add(r);
                }
-               rep->write_body("json", std::move(json::stream_object(json_array)));
+               rep->write_body("json", sstring(json.as_json()));
                return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
         });
     }
@@ -375,12 +559,11 @@ future<std::unique_ptr<reply>> Relationships::GetNodeRelationshipsByIdHandler::h
       // Get Node Degree with Direction
       return parent.graph.shard.local().NodeGetRelationshipsPeered(id, direction)
         .then([rep = std::move(rep), this] (const std::vector<Relationship>& relationships) mutable {
-               std::vector<relationship_json> json_array;
-               json_array.reserve(relationships.size());
-               for(Relationship r : relationships) {
-                 json_array.emplace_back(r, parent.graph);
+               json_entities_builder json(parent.graph, relationships.size());
+               for(const Relationship& r : relationships) {
+                 json.add(r);
                }
-               rep->write_body("json", std::move(json::stream_object(json_array)));
+               rep->write_body("json", sstring(json.as_json()));
                return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
         });
     case 2: {
@@ -390,13 +573,12 @@ future<std::unique_ptr<reply>> Relationships::GetNodeRelationshipsByIdHandler::h
       // Single Relationship Type
       if (rel_types.size() == 1) {
         return parent.graph.shard.local().NodeGetRelationshipsPeered(id, direction, rel_types[0])
-          .then([rep = std::move(rep), rel_type = rel_types[0]] (const std::vector<Relationship>& relationships) mutable {
-                 std::vector<relationship_json> json_array;
-                 json_array.reserve(relationships.size());
-                 for(Relationship r : relationships) {
-                   json_array.emplace_back(r, rel_type);
+          .then([rep = std::move(rep), rel_type = rel_types[0], this] (const std::vector<Relationship>& relationships) mutable {
+                 json_entities_builder json(parent.graph, relationships.size());
+                 for(const Relationship& r : relationships) {
+                   json.add(r, rel_type);
                  }
-                 rep->write_body("json", std::move(json::stream_object(json_array)));
+                 rep->write_body("json", sstring(json.as_json()));
                  return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
           });
       }
@@ -404,12 +586,11 @@ future<std::unique_ptr<reply>> Relationships::GetNodeRelationshipsByIdHandler::h
       // Multiple Relationship Types
       return parent.graph.shard.local().NodeGetRelationshipsPeered(id, direction, rel_types)
         .then([rep = std::move(rep), this] (const std::vector<Relationship>& relationships) mutable {
-               std::vector<relationship_json> json_array;
-               json_array.reserve(relationships.size());
-               for(Relationship r : relationships) {
-                 json_array.emplace_back(r, parent.graph);
+               json_entities_builder json(parent.graph, relationships.size());
+               for(const Relationship& r : relationships) {
+                 json.add(r);
                }
-               rep->write_body("json", std::move(json::stream_object(json_array)));
+               rep->write_body("json", sstring(json.as_json()));
                return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
         });
     }
@@ -424,3 +605,71 @@ future<std::unique_ptr<reply>> Relationships::GetNodeRelationshipsByIdHandler::h
 
   return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
 }
+
+future<std::unique_ptr<reply>> Relationships::MergedRelationship(std::pair<uint64_t, bool> merged, const std::string& rel_type, std::unique_ptr<reply> rep) {
+  if (merged.first > 0) {
+    return graph.shard.local().RelationshipGetPeered(merged.first).then([rep = std::move(rep), rel_type, created = merged.second] (Relationship relationship) mutable {
+           rep->write_body("json", std::move(json::stream_object((relationship_json(relationship, rel_type)))));
+           if (created) {
+             rep->set_status(reply::status_type::created);
+           }
+           return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+    });
+  }
+  rep->write_body("json", std::move(json::stream_object("Invalid Request")));
+  rep->set_status(reply::status_type::bad_request);
+  return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+}
+
+future<std::unique_ptr<reply>> Relationships::GetRelationshipByIdsHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  uint64_t id = Server::validate_id(req, rep);
+  uint64_t id2 = Server::validate_id2(req, rep);
+  bool valid_rel_type = Server::validate_parameter(Server::REL_TYPE, req, rep, "Invalid relationship type");
+
+  if (id > 0 && id2 > 0 && valid_rel_type) {
+    return parent.graph.shard.local().RelationshipGetIDPeered(id, id2, req->param[Server::REL_TYPE], OUT)
+      .then([rep = std::move(rep), rel_type = req->param[Server::REL_TYPE], this] (uint64_t rel_id) mutable {
+             if (rel_id > 0) {
+               return parent.graph.shard.local().RelationshipGetPeered(rel_id).then([rep = std::move(rep), rel_type] (Relationship relationship) mutable {
+                      rep->write_body("json", std::move(json::stream_object((relationship_json(relationship, rel_type)))));
+                      return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+               });
+             }
+             rep->write_body("json", std::move(json::stream_object("Relationship not found")));
+             rep->set_status(reply::status_type::not_found);
+             return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+      });
+  }
+  return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+}
+
+future<std::unique_ptr<reply>> Relationships::PutRelationshipHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  bool valid_type = Server::validate_parameter(Server::TYPE, req, rep, "Invalid type");
+  bool valid_key = Server::validate_parameter(Server::KEY, req, rep, "Invalid key");
+  bool valid_type2 = Server::validate_parameter(Server::TYPE2, req, rep, "Invalid type2");
+  bool valid_key2 = Server::validate_parameter(Server::KEY2, req, rep, "Invalid key2");
+  bool valid_rel_type = Server::validate_parameter(Server::REL_TYPE, req, rep, "Invalid relationship type");
+
+  if (valid_type && valid_key && valid_type2 && valid_key2 && valid_rel_type) {
+    return parent.graph.shard.local().RelationshipMergePeered(req->param[Server::REL_TYPE], req->param[Server::TYPE], req->param[Server::KEY],
+                                                              req->param[Server::TYPE2], req->param[Server::KEY2], req->content.c_str())
+      .then([rep = std::move(rep), rel_type = req->param[Server::REL_TYPE], this] (std::pair<uint64_t, bool> merged) mutable {
+             return parent.MergedRelationship(merged, rel_type, std::move(rep));
+      });
+  }
+  return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+}
+
+future<std::unique_ptr<reply>> Relationships::PutRelationshipByIdHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  uint64_t id = Server::validate_id(req, rep);
+  uint64_t id2 = Server::validate_id2(req, rep);
+  bool valid_rel_type = Server::validate_parameter(Server::REL_TYPE, req, rep, "Invalid relationship type");
+
+  if (id > 0 && id2 > 0 && valid_rel_type) {
+    return parent.graph.shard.local().RelationshipMergePeered(req->param[Server::REL_TYPE], id, id2, req->content.c_str())
+      .then([rep = std::move(rep), rel_type = req->param[Server::REL_TYPE], this] (std::pair<uint64_t, bool> merged) mutable {
+             return parent.MergedRelationship(merged, rel_type, std::move(rep));
+      });
+  }
+  return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+}
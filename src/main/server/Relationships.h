@@ -61,6 +61,14 @@ class Relationships {
     future<std::unique_ptr<reply>> handle(const sstring& path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) override;
   };
 
+  class PostRelationshipsHandler : public httpd::handler_base {
+  public:
+    explicit PostRelationshipsHandler(Relationships& relationships) : parent(relationships) {};
+  private:
+    Relationships& parent;
+    future<std::unique_ptr<reply>> handle(const sstring& path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) override;
+  };
+
   class PostRelationshipByIdHandler : public httpd::handler_base {
   public:
     explicit PostRelationshipByIdHandler(Relationships& relationships) : parent(relationships) {};
@@ -93,21 +101,55 @@ class Relationships {
     future<std::unique_ptr<reply>> handle(const sstring& path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) override;
   };
 
+  class GetRelationshipByIdsHandler : public httpd::handler_base {
+  public:
+    explicit GetRelationshipByIdsHandler(Relationships& relationships) : parent(relationships) {};
+  private:
+    Relationships& parent;
+    future<std::unique_ptr<reply>> handle(const sstring& path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) override;
+  };
+
+  class PutRelationshipHandler : public httpd::handler_base {
+  public:
+    explicit PutRelationshipHandler(Relationships& relationships) : parent(relationships) {};
+  private:
+    Relationships& parent;
+    future<std::unique_ptr<reply>> handle(const sstring& path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) override;
+  };
+
+  class PutRelationshipByIdHandler : public httpd::handler_base {
+  public:
+    explicit PutRelationshipByIdHandler(Relationships& relationships) : parent(relationships) {};
+  private:
+    Relationships& parent;
+    future<std::unique_ptr<reply>> handle(const sstring& path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) override;
+  };
+
 private:
   Graph& graph;
+  // Pages resume from a cursor, streams write every page of the scan as it arrives
+  future<std::unique_ptr<reply>> GetRelationshipsFromCursor(Cursor cursor, uint64_t limit, bool stream, NodeProjection projection, std::unique_ptr<reply> rep);
+  future<std::unique_ptr<reply>> ScanRelationships(Cursor cursor, uint64_t limit, bool stream, NodeProjection projection, std::unique_ptr<reply> rep);
+  // Merges answer with the relationship, created if it was added and ok if it was already there
+  future<std::unique_ptr<reply>> MergedRelationship(std::pair<uint64_t, bool> merged, const std::string& rel_type, std::unique_ptr<reply> rep);
   GetRelationshipsHandler getRelationshipsHandler;
   GetRelationshipsOfTypeHandler getRelationshipsOfTypeHandler;
   GetRelationshipHandler getRelationshipHandler;
   PostRelationshipHandler postRelationshipHandler;
   PostRelationshipByIdHandler postRelationshipByIdHandler;
+  PostRelationshipsHandler postRelationshipsHandler;
   DeleteRelationshipHandler deleteRelationshipHandler;
   GetNodeRelationshipsHandler getNodeRelationshipsHandler;
   GetNodeRelationshipsByIdHandler getNodeRelationshipsByIdHandler;
+  GetRelationshipByIdsHandler getRelationshipByIdsHandler;
+  PutRelationshipHandler putRelationshipHandler;
+  PutRelationshipByIdHandler putRelationshipByIdHandler;
 
 public:
   explicit Relationships(Graph &graph) : graph(graph), getRelationshipsHandler(*this), getRelationshipsOfTypeHandler(*this),
-                                         getRelationshipHandler(*this), postRelationshipHandler(*this), postRelationshipByIdHandler(*this),
-                                         deleteRelationshipHandler(*this), getNodeRelationshipsHandler(*this), getNodeRelationshipsByIdHandler(*this) {}
+                                         getRelationshipHandler(*this), postRelationshipHandler(*this), postRelationshipByIdHandler(*this), postRelationshipsHandler(*this),
+                                         deleteRelationshipHandler(*this), getNodeRelationshipsHandler(*this), getNodeRelationshipsByIdHandler(*this),
+                                         getRelationshipByIdsHandler(*this), putRelationshipHandler(*this), putRelationshipByIdHandler(*this) {}
   void set_routes(routes& routes);
 };
 
@@ -0,0 +1,129 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "Replica.h"
+#include <iostream>
+#include <seastar/core/sleep.hh>
+#include <seastar/core/thread.hh>
+
+seastar::future<> Replica::start() {
+  (void)seastar::with_gate(running, [this] {
+    return seastar::async([this] {
+      follow();
+    });
+  });
+  return seastar::make_ready_future<>();
+}
+
+seastar::future<> Replica::stop() {
+  stopping = true;
+  // Wake up a request waiting on the primary
+  if (socket) {
+    socket->shutdown_input();
+    socket->shutdown_output();
+  }
+  return running.close();
+}
+
+void Replica::follow() {
+  Shard &shard = graph.shard.local();
+  auto shard_id = static_cast<uint8_t>(seastar::this_shard_id());
+  bool restored = false;
+
+  while (!stopping) {
+    try {
+      socket = seastar::connect(primary).get0();
+      seastar::input_stream<char> in = socket->input();
+      seastar::output_stream<char> out = socket->output();
+
+      while (!stopping) {
+        std::string arguments;
+        Serializer serializer(arguments);
+        serializer.put(shard_id);
+        std::string result;
+
+        if (!restored) {
+          if (request(in, out, Binary::LOG_SNAPSHOT, arguments, result) != Binary::OK) {
+            std::cerr << "The primary keeps no records for replicas of shard " << static_cast<uint16_t>(shard_id) << '\n';
+            break;
+          }
+          Deserializer reader(result.data(), result.size());
+          if (reader.getUint8() != seastar::smp::count) {
+            std::cerr << "Replicas need to run on as many cores as their primary\n";
+            stopping = true;
+            break;
+          }
+          restored = shard.ReplicationRestore(reader);
+          continue;
+        }
+
+        uint64_t sequence = shard.ReplicationSequence();
+        serializer.put(sequence);
+        serializer.put(batch_bytes);
+        Binary::Status status = request(in, out, Binary::LOG_FOLLOW, arguments, result);
+        if (status != Binary::OK) {
+          // The records we need are gone, start over from a snapshot
+          restored = false;
+          continue;
+        }
+        Deserializer reader(result.data(), result.size());
+        if (!shard.ReplicationApply(reader)) {
+          restored = false;
+          continue;
+        }
+        // Caught up, wait for the primary to log more
+        if (shard.ReplicationSequence() == sequence) {
+          seastar::sleep(poll_interval).get();
+        }
+      }
+      out.close().get();
+    } catch (std::exception &e) {
+      if (!stopping) {
+        std::cerr << "Lost the primary: " << e.what() << '\n';
+      }
+    }
+    socket.reset();
+    if (!stopping) {
+      seastar::sleep(poll_interval).get();
+    }
+  }
+}
+
+Binary::Status Replica::request(seastar::input_stream<char> &in, seastar::output_stream<char> &out, Binary::Operation operation,
+                                const std::string &arguments, std::string &result) {
+  // A single request at a time, so the request id does not matter
+  std::string frame;
+  Serializer serializer(frame);
+  serializer.put(static_cast<uint32_t>(sizeof(uint32_t) + sizeof(uint8_t) + arguments.size()));
+  serializer.put(uint32_t(0));
+  serializer.put(static_cast<uint8_t>(operation));
+  frame.append(arguments);
+  out.write(frame).get();
+  out.flush().get();
+
+  seastar::temporary_buffer<char> header = in.read_exactly(sizeof(uint32_t)).get0();
+  if (header.size() < sizeof(uint32_t)) {
+    throw std::runtime_error("connection closed");
+  }
+  uint32_t size = Deserializer(header.get(), header.size()).getUint32();
+  seastar::temporary_buffer<char> reply = in.read_exactly(size).get0();
+  if (size < sizeof(uint32_t) + sizeof(uint8_t) || reply.size() < size) {
+    throw std::runtime_error("connection closed");
+  }
+  result.assign(reply.get() + sizeof(uint32_t) + sizeof(uint8_t), size - sizeof(uint32_t) - sizeof(uint8_t));
+  return static_cast<Binary::Status>(reply[sizeof(uint32_t)]);
+}
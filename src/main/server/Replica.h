@@ -0,0 +1,54 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef TRITON_REPLICA_H
+#define TRITON_REPLICA_H
+
+#include "Binary.h"
+#include <chrono>
+#include <optional>
+#include <seastar/core/gate.hh>
+#include <seastar/net/api.hh>
+
+using namespace triton;
+
+// Follows a primary over its binary protocol. Every core restores the same shard of the primary from a snapshot,
+// then applies the records that shard logs from that point on. A replica that falls further behind than the primary
+// keeps records for starts over from a new snapshot.
+class Replica {
+public:
+  Replica(Graph &graph, seastar::socket_address primary, uint64_t poll_interval, uint64_t batch_bytes)
+      : graph(graph), primary(primary), poll_interval(poll_interval), batch_bytes(batch_bytes) {}
+
+  seastar::future<> start();
+  seastar::future<> stop();
+
+private:
+  Graph &graph;
+  seastar::socket_address primary;
+  std::chrono::milliseconds poll_interval;// Wait between requests once caught up, or between attempts to reach the primary
+  uint64_t batch_bytes;                   // About how many bytes of records to ask for at once
+  bool stopping = false;
+  seastar::gate running;
+  std::optional<seastar::connected_socket> socket;
+
+  void follow();
+  static Binary::Status request(seastar::input_stream<char> &in, seastar::output_stream<char> &out, Binary::Operation operation,
+                                const std::string &arguments, std::string &result);
+};
+
+#endif//TRITON_REPLICA_H
@@ -0,0 +1,42 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "JSON.h"
+#include "Replication.h"
+
+void Replication::set_routes(routes &routes) {
+
+  auto getReplication = new match_rule(Server::timed(graph, "GET /replication", &getReplicationHandler));
+  getReplication->add_str("/db/" + graph.GetName() + "/replication");
+  routes.add(getReplication, operation_type::GET);
+
+}
+
+future<std::unique_ptr<reply>> Replication::GetReplicationHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  return parent.graph.shard.local().ReplicationStatusPeered()
+    .then([rep = std::move(rep)] (const std::vector<std::map<std::string, std::any>>& shards) mutable {
+           // Records of the primary not yet applied and milliseconds since the shard last had all of them, zero on a primary
+           json_values_builder json;
+           for (const auto& status : shards) {
+             json_properties_builder shard_json;
+             shard_json.add_properties(status);
+             json.add(shard_json.as_json());
+           }
+           rep->write_body("json", sstring(json.as_json()));
+           return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+    });
+}
@@ -16,8 +16,138 @@
 
 #include "Server.h"
 
+#include <algorithm>
+#include <boost/algorithm/string.hpp>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <set>
+#include <string_view>
 #include <utility>
 
+future<std::unique_ptr<reply>> TimedHandler::handle(const sstring& path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  // The routes of a dropped graph stay around in case it is created again
+  if (!graph.Running()) {
+    rep->write_body("json", std::move(json::stream_object("Graph not found")));
+    rep->set_status(reply::status_type::not_found);
+    return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+  }
+  if (writes && graph.shard.local().IsReadOnly()) {
+    rep->write_body("json", std::move(json::stream_object("Read only replica")));
+    rep->set_status(reply::status_type::forbidden);
+    return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+  }
+  if (rejected_at && graph.shard.local().MemoryRejects(rejected_at)) {
+    rep->write_body("json", std::move(json::stream_object("Memory limit reached")));
+    rep->set_status(reply::status_type::service_unavailable);
+    return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+  }
+  auto start = std::chrono::steady_clock::now();
+  // Opt in with trace=true, or be one of the requests sampled by trace_sample
+  bool asked = req->get_query_param("trace") == "true";
+  seastar::lw_shared_ptr<Trace> trace = graph.shard.local().TraceStart(asked);
+  if (trace) {
+    rep->add_header("X-Trace-Id", seastar::to_sstring(trace->id));
+  }
+  // Scripts are told apart in the slow query log by the hash of their body
+  uint64_t script_hash = scripted ? std::hash<std::string_view>()(std::string_view(req->content.data(), req->content.size())) : 0;
+  // Dropping the graph waits for the requests inside its gate, and each graph gets its own share of the core
+  return seastar::with_gate(graph.Requests(), [path, req = std::move(req), rep = std::move(rep), start, trace, this] () mutable {
+    return seastar::with_scheduling_group(graph.Group(), [path = std::move(path), req = std::move(req), rep = std::move(rep), trace, this] () mutable {
+      Shard::TraceScope scope(graph.shard.local(), trace);
+      return handler->handle(path, std::move(req), std::move(rep));
+    }).finally([start, trace, asked, script_hash, this] {
+      // Every core keeps its own histograms, the request finished on the core it came in on
+      graph.shard.local().RouteLatency(route).record(start);
+      graph.shard.local().SlowQueryRecord(route, script_hash, start, trace, asked);
+    });
+  });
+}
+
+httpd::handler_base* Server::timed(Graph& graph, const std::string& route, httpd::handler_base* handler) {
+  // Routes live as long as the server, so the wrapper does too
+  return new TimedHandler(graph, route, handler, writes(route), rejected_at(route), route == "POST /lua");
+}
+
+future<std::unique_ptr<reply>> CachedHandler::handle(const sstring& path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  if (!graph.shard.local().ResultCacheEnabled() || !Server::repeatable(std::string_view(req->content.data(), req->content.size()))) {
+    return handler->handle(path, std::move(req), std::move(rep));
+  }
+  // The method, the url with its query string and the body name the result
+  std::string key = std::string(req->_method.c_str(), req->_method.size()) + " " + std::string(req->_url.c_str(), req->_url.size()) + "\n" + req->content;
+  uint64_t epoch = graph.shard.local().MutationEpochs();
+  std::string result;
+  if (graph.shard.local().ResultCacheGet(key, epoch, result)) {
+    // The status, headers and body are kept together, as they were first sent
+    Deserializer reader(result.data(), result.size());
+    auto status = static_cast<reply::status_type>(reader.getUint16());
+    for (uint64_t count = reader.getUint64(); count > 0 && !reader.failed(); count--) {
+      std::string name = reader.getString();
+      std::string value = reader.getString();
+      rep->_headers[sstring(name.data(), name.size())] = sstring(value.data(), value.size());
+    }
+    std::string body = reader.getString();
+    rep->_content = sstring(body.data(), body.size());
+    rep->set_status(status);
+    return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+  }
+  return handler->handle(path, std::move(req), std::move(rep)).then([key = std::move(key), epoch, this] (std::unique_ptr<reply> rep) {
+    // Errors are worth asking again, and only what was computed while nothing changed is kept,
+    // which also leaves out scripts that changed the graph themselves
+    if (static_cast<int>(rep->_status) < 200 || static_cast<int>(rep->_status) >= 300 || graph.shard.local().MutationEpochs() != epoch) {
+      return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+    }
+    std::string result;
+    Serializer serializer(result);
+    serializer.put(static_cast<uint16_t>(rep->_status));
+    // The trace id belongs to the request that computed the result, not to the ones it is replayed to
+    uint64_t count = 0;
+    for (const auto &[name, value] : rep->_headers) {
+      count += name != "X-Trace-Id";
+    }
+    serializer.put(count);
+    for (const auto &[name, value] : rep->_headers) {
+      if (name != "X-Trace-Id") {
+        serializer.put(std::string(name.c_str(), name.size()));
+        serializer.put(std::string(value.c_str(), value.size()));
+      }
+    }
+    serializer.put(std::string(rep->_content.c_str(), rep->_content.size()));
+    graph.shard.local().ResultCachePut(key, epoch, std::move(result));
+    return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+  });
+}
+
+bool Server::repeatable(std::string_view body) {
+  // Scripts that draw random numbers answer differently every time they run, so they are never served from the cache
+  static const std::vector<std::string_view> random = {"RandomWalk", "SampleNeighbors", "math.random"};
+  return std::none_of(random.begin(), random.end(), [&body] (std::string_view name) {
+    return body.find(name) != std::string::npos;
+  });
+}
+
+httpd::handler_base* Server::cached(Graph& graph, httpd::handler_base* handler) {
+  // Routes live as long as the server, so the wrapper does too
+  return new CachedHandler(graph, handler);
+}
+
+bool Server::writes(const std::string& route) {
+  // These only read, even though their arguments come in a body
+  static const std::set<std::string> reads = {"POST /traverse", "POST /algorithms/{name}", "POST /nodes/get", "POST /relationships/get",
+                                              "POST /nodes/degree", "POST /nodes/property/{property}", "POST /lua", "POST /aggregate",
+                                              "POST /views", "DELETE /views/{id}", "POST /walks", "POST /samples", "POST /export"};
+  return route.rfind("GET ", 0) != 0 && reads.count(route) == 0;
+}
+
+uint8_t Server::rejected_at(const std::string& route) {
+  // Gets and deletes always go through, deletes give memory back
+  if (route.rfind("GET ", 0) == 0 || route.rfind("DELETE ", 0) == 0) {
+    return 0;
+  }
+  // Writes stop at the soft limit, scripts and the other reads that come with a body stop at the hard limit
+  return writes(route) ? Shard::MEMORY_SOFT : Shard::MEMORY_HARD;
+}
+
 bool Server::validate_parameter(const sstring &parameter, std::unique_ptr<request> &req, std::unique_ptr<reply> &rep, std::string message) {
   bool valid_type = req->param.exists(parameter);
   if (!valid_type) {
@@ -92,6 +222,102 @@ uint64_t Server::validate_offset(std::unique_ptr<request> &req, std::unique_ptr<
   }
 }
 
+NodeProjection Server::validate_projection(const std::unique_ptr<request> &req) {
+  // Nodes without their properties when asked with ?properties=false
+  if (req->get_query_param("properties") == "false") {
+    return NodeProjection::KEY;
+  }
+  return NodeProjection::FULL;
+}
+
+bool Server::validate_cursor(const std::unique_ptr<request> &req, std::unique_ptr<reply> &rep, Cursor &cursor) {
+  // A missing cursor starts from the beginning
+  sstring cursor_param = req->get_query_param("cursor");
+  if (!cursor_param.empty() && !Cursor::fromString(cursor_param, cursor)) {
+    rep->write_body("json", std::move(json::stream_object("Invalid cursor parameter")));
+    rep->set_status(reply::status_type::bad_request);
+    return false;
+  }
+  // A scan of a read view names it when it starts, the cursors it hands back carry it from then on
+  sstring view_param = req->get_query_param("view");
+  if (!view_param.empty()) {
+    try {
+      cursor.view = std::stoull(view_param);
+    } catch (std::exception& e) {
+      rep->write_body("json", std::move(json::stream_object("Invalid view parameter")));
+      rep->set_status(reply::status_type::bad_request);
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Server::validate_stream(const std::unique_ptr<request> &req) {
+  return req->get_query_param("stream") == "true";
+}
+
+bool Server::validate_paged(const std::unique_ptr<request> &req) {
+  // Neighbors and relationships come back a page at a time only when asked, otherwise they all come back
+  return !req->get_query_param("limit").empty() || !req->get_query_param("offset").empty()
+    || !req->get_query_param("node_type").empty() || !req->get_query_param("filter").empty();
+}
+
+bool Server::validate_options(const std::unique_ptr<request> &req, std::unique_ptr<reply> &rep, Direction &direction, std::vector<std::string> &rel_types) {
+  // From /{direction} or /{direction}/{rel_type}&{rel_type}, nothing means both directions and every type
+  direction = BOTH;
+  rel_types.clear();
+  std::string options_string = req->param.at(OPTIONS).c_str();
+  if (options_string.empty()) {
+    return true;
+  }
+
+  std::vector<std::string> options;
+  boost::split(options, options_string, [](char c){return c == '/';});
+  // Erase empty first element from leading slash
+  options.erase(options.begin());
+  if (options.empty() || options.size() > 2) {
+    rep->write_body("json", std::move(json::stream_object("Invalid request")));
+    rep->set_status(reply::status_type::bad_request);
+    return false;
+  }
+
+  boost::algorithm::to_lower(options[0]);
+  if (options[0] == "in") {
+    direction = IN;
+  } else if (options[0] == "out") {
+    direction = OUT;
+  }
+  if (options.size() == 2) {
+    boost::split(rel_types, options[1], [](char c){ return c == '&'; });
+  }
+  return true;
+}
+
+bool Server::validate_filters(const std::unique_ptr<request> &req, std::unique_ptr<reply> &rep, std::vector<ScanFilter> &filters) {
+  // From ?filter=age>=30,name=="max" where values are read like properties in the url
+  sstring filter_param = req->get_query_param("filter");
+  if (filter_param.empty()) {
+    return true;
+  }
+
+  std::vector<std::string> terms;
+  std::string filter_string = filter_param.c_str();
+  boost::split(terms, filter_string, [](char c){ return c == ','; });
+  for (const auto &term : terms) {
+    size_t start = term.find_first_of("=!<>");
+    size_t end = term.find_first_not_of("=!<>", start);
+    ScanOperator scan_operator;
+    if (start == 0 || start == std::string::npos || end == std::string::npos
+        || !ScanFilter::toOperator(std::string_view(term).substr(start, end - start), scan_operator)) {
+      rep->write_body("json", std::move(json::stream_object("Invalid filter parameter")));
+      rep->set_status(reply::status_type::bad_request);
+      return false;
+    }
+    filters.emplace_back(term.substr(0, start), scan_operator, convert_parameter_to_property(term.substr(end)));
+  }
+  return true;
+}
+
 void Server::convert_property_to_json(std::unique_ptr<reply> &rep, const std::any &property) {
   if(property.type() == typeid(std::string)) {
     rep->write_body("json", std::move(json::stream_object(std::any_cast<std::string>(property))));
@@ -109,3 +335,24 @@ void Server::convert_property_to_json(std::unique_ptr<reply> &rep, const std::an
     rep->write_body("json", std::move(json::stream_object(std::any_cast<bool>(property))));
   }
 }
+
+std::any Server::convert_parameter_to_property(const std::string &parameter) {
+  // Quoted values are always strings, otherwise booleans and numbers are recognized
+  if (parameter.size() >= 2 && parameter.front() == '"' && parameter.back() == '"') {
+    return parameter.substr(1, parameter.size() - 2);
+  }
+  if (parameter == "true" || parameter == "false") {
+    return parameter == "true";
+  }
+  int64_t integer;
+  auto [last, error] = std::from_chars(parameter.data(), parameter.data() + parameter.size(), integer);
+  if (error == std::errc() && last == parameter.data() + parameter.size()) {
+    return integer;
+  }
+  char *end;
+  double number = std::strtod(parameter.c_str(), &end);
+  if (!parameter.empty() && *end == '\0') {
+    return number;
+  }
+  return parameter;
+}
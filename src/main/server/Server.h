@@ -26,6 +26,30 @@ using namespace seastar;
 using namespace httpd;
 using namespace triton;
 
+// Hands the request to another handler and records how long the reply took under the name of its route
+class TimedHandler : public httpd::handler_base {
+public:
+  TimedHandler(Graph& graph, std::string route, httpd::handler_base* handler, bool writes, uint8_t rejected_at, bool scripted) : graph(graph), route(std::move(route)), handler(handler), writes(writes), rejected_at(rejected_at), scripted(scripted) {};
+  future<std::unique_ptr<reply>> handle(const sstring& path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) override;
+private:
+  Graph& graph;
+  std::string route;
+  httpd::handler_base* handler;
+  bool writes;// Changes the graph, so replicas turn it away
+  uint8_t rejected_at;// Memory pressure that turns it away, zero for never
+  bool scripted;// Its body is a script
+};
+
+// Answers from the result cache of the core the request came in on while no shard has changed since the result was computed
+class CachedHandler : public httpd::handler_base {
+public:
+  CachedHandler(Graph& graph, httpd::handler_base* handler) : graph(graph), handler(handler) {};
+  future<std::unique_ptr<reply>> handle(const sstring& path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) override;
+private:
+  Graph& graph;
+  httpd::handler_base* handler;
+};
+
 class Server {
 
 public:
@@ -38,13 +62,27 @@ public:
   static inline const seastar::sstring KEY2 = sstring ("key2");
   static inline const seastar::sstring REL_TYPE = sstring ("rel_type");
   static inline const seastar::sstring OPTIONS = sstring ("options");
+  static inline const seastar::sstring SHARD = sstring ("shard");
 
+  static httpd::handler_base* timed(Graph& graph, const std::string& route, httpd::handler_base* handler);
+  static httpd::handler_base* cached(Graph& graph, httpd::handler_base* handler);
+  static bool writes(const std::string& route);
+  // False for bodies whose answer may change without the graph changing
+  static bool repeatable(std::string_view body);
+  static uint8_t rejected_at(const std::string& route);
   static bool validate_parameter(const seastar::sstring& parameter, std::unique_ptr<request> &req, std::unique_ptr<reply> &rep, std::string message);
   static uint64_t validate_id(const std::unique_ptr<request> &req, std::unique_ptr<reply> &rep);
   static uint64_t validate_id2(const std::unique_ptr<request> &req, std::unique_ptr<reply> &rep);
   static uint64_t validate_limit(std::unique_ptr<request> &req, std::unique_ptr<reply> &rep);
   static uint64_t validate_offset(std::unique_ptr<request> &req, std::unique_ptr<reply> &rep);
+  static NodeProjection validate_projection(const std::unique_ptr<request> &req);
+  static bool validate_cursor(const std::unique_ptr<request> &req, std::unique_ptr<reply> &rep, Cursor &cursor);
+  static bool validate_stream(const std::unique_ptr<request> &req);
+  static bool validate_paged(const std::unique_ptr<request> &req);
+  static bool validate_options(const std::unique_ptr<request> &req, std::unique_ptr<reply> &rep, Direction &direction, std::vector<std::string> &rel_types);
+  static bool validate_filters(const std::unique_ptr<request> &req, std::unique_ptr<reply> &rep, std::vector<ScanFilter> &filters);
   static void convert_property_to_json(std::unique_ptr<reply> &rep, const std::any &property);
+  static std::any convert_parameter_to_property(const std::string &parameter);
 };
 
 
@@ -0,0 +1,39 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Snapshots.h"
+
+void Snapshots::set_routes(routes &routes) {
+
+  auto postSnapshot = new match_rule(Server::timed(graph, "POST /snapshot", &postSnapshotHandler));
+  postSnapshot->add_str("/db/" + graph.GetName() + "/snapshot");
+  routes.add(postSnapshot, operation_type::POST);
+
+}
+
+future<std::unique_ptr<reply>> Snapshots::PostSnapshotHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  return parent.graph.Snapshot()
+    .then([rep = std::move(rep)] (bool saved) mutable {
+           if (saved) {
+             rep->write_body("json", std::move(json::stream_object(saved)));
+           } else {
+             // Snapshots are kept with the command log, so it has to be enabled
+             rep->write_body("json", std::move(json::stream_object("Command log disabled")));
+             rep->set_status(reply::status_type::bad_request);
+           }
+           return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+    });
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "JSON.h"
+#include "Stats.h"
+
+void Stats::set_routes(routes &routes) {
+
+  auto getStats = new match_rule(Server::timed(graph, "GET /stats", &getStatsHandler));
+  getStats->add_str("/db/" + graph.GetName() + "/stats");
+  routes.add(getStats, operation_type::GET);
+
+  auto getSlowQueries = new match_rule(Server::timed(graph, "GET /slow", &getSlowQueriesHandler));
+  getSlowQueries->add_str("/db/" + graph.GetName() + "/slow");
+  routes.add(getSlowQueries, operation_type::GET);
+
+}
+
+future<std::unique_ptr<reply>> Stats::GetStatsHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  return parent.graph.shard.local().MemoryStatusPeered()
+    .then([rep = std::move(rep)] (const std::vector<std::map<std::string, std::any>>& shards) mutable {
+           // Bytes allocated on the core of each shard, estimated bytes of each of its parts and how close it is to the limits
+           json_values_builder json;
+           for (const auto& status : shards) {
+             json_properties_builder shard_json;
+             shard_json.add_properties(status);
+             json.add(shard_json.as_json());
+           }
+           rep->write_body("json", sstring(json.as_json()));
+           return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+    });
+}
+
+future<std::unique_ptr<reply>> Stats::GetSlowQueriesHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  // Only the request of one trace when its id is given
+  uint64_t trace_id = 0;
+  sstring id_param = req->get_query_param("id");
+  if (!id_param.empty()) {
+    try {
+      trace_id = std::stoull(id_param);
+    } catch (std::exception& e) {
+      rep->write_body("json", std::move(json::stream_object("Invalid id parameter")));
+      rep->set_status(reply::status_type::bad_request);
+      return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+    }
+  }
+
+  return parent.graph.shard.local().SlowQueriesPeered(trace_id)
+    .then([rep = std::move(rep)] (const std::vector<SlowQuery>& queries) mutable {
+           // Times are microseconds from the start of the request, a call to every shard only has the time it took
+           uint16_t cpus = seastar::smp::count;
+           json_values_builder json;
+           for (const auto& query : queries) {
+             json_properties_builder query_json;
+             query_json.add_properties({{"trace_id", static_cast<int64_t>(query.trace_id)}, {"name", query.name},
+                                        {"shard", static_cast<int64_t>(query.shard)}, {"microseconds", static_cast<int64_t>(query.microseconds)}});
+             json_values_builder hops;
+             for (const auto& hop : query.hops) {
+               json_properties_builder hop_json;
+               std::map<std::string, std::any> values = {{"operation", hop.operation}, {"sent", hop.sent}, {"returned", hop.returned}};
+               if (hop.shard < cpus) {
+                 values["shard"] = static_cast<int64_t>(hop.shard);
+                 values["queued"] = hop.started - hop.sent;
+                 values["service"] = hop.finished - hop.started;
+               } else {
+                 values["shard"] = std::string("all");
+               }
+               hop_json.add_properties(values);
+               hops.add(hop_json.as_json());
+             }
+             query_json.add("hops", hops.as_json());
+             json_values_builder stages;
+             for (const auto& stage : query.stages) {
+               json_properties_builder stage_json;
+               stage_json.add_properties({{"name", stage.name}, {"start", stage.start}, {"microseconds", stage.finish - stage.start}});
+               stages.add(stage_json.as_json());
+             }
+             query_json.add("stages", stages.as_json());
+             json.add(query_json.as_json());
+           }
+           rep->write_body("json", sstring(json.as_json()));
+           return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+    });
+}
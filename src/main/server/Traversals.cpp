@@ -0,0 +1,145 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "JSON.h"
+#include "Traversals.h"
+#include <stdexcept>
+
+void Traversals::set_routes(routes &routes) {
+
+  auto postTraverse = new match_rule(Server::timed(graph, "POST /traverse", &postTraverseHandler));
+  postTraverse->add_str("/db/" + graph.GetName() + "/traverse");
+  routes.add(postTraverse, operation_type::POST);
+
+  auto postWalks = new match_rule(Server::timed(graph, "POST /walks", &postWalksHandler));
+  postWalks->add_str("/db/" + graph.GetName() + "/walks");
+  routes.add(postWalks, operation_type::POST);
+
+  auto postSamples = new match_rule(Server::timed(graph, "POST /samples", &postSamplesHandler));
+  postSamples->add_str("/db/" + graph.GetName() + "/samples");
+  routes.add(postSamples, operation_type::POST);
+
+}
+
+// Ids as a JSON array
+static void append_ids(std::string& chunk, const std::vector<uint64_t>& ids) {
+  chunk.append("[");
+  for (size_t i = 0; i < ids.size(); i++) {
+    if (i > 0) {
+      chunk.append(",");
+    }
+    chunk.append(std::to_string(ids[i]));
+  }
+  chunk.append("]");
+}
+
+future<std::unique_ptr<reply>> Traversals::PostTraverseHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  // If the query is missing
+  if (req->content.empty()) {
+    rep->write_body("json", std::move(json::stream_object("Empty traversal")));
+    rep->set_status(reply::status_type::bad_request);
+    return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+  }
+
+  std::string body = req->content;
+  return parent.graph.shard.local().TraversePeered(body)
+    .then_wrapped([rep = std::move(rep), this] (future<std::vector<Node>> traversed) mutable {
+           try {
+             std::vector<Node> nodes = traversed.get0();
+             json_entities_builder json(parent.graph, nodes.size());
+             for(Node& n : nodes) {
+               json.add(n);
+             }
+             rep->write_body("json", sstring(json.as_json()));
+           } catch (const std::invalid_argument &e) {
+             // Bad JSON, missing ids or steps, or a step that is not an object
+             rep->write_body("json", std::move(json::stream_object(std::string(e.what()))));
+             rep->set_status(reply::status_type::bad_request);
+           }
+           return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+    });
+}
+
+future<std::unique_ptr<reply>> Traversals::PostWalksHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  // If the query is missing
+  if (req->content.empty()) {
+    rep->write_body("json", std::move(json::stream_object("Empty walk")));
+    rep->set_status(reply::status_type::bad_request);
+    return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+  }
+
+  // Walks are written out a batch at a time, so many start ids do not have to fit in one reply
+  std::string body = req->content;
+  rep->write_body("json", [body, this] (output_stream<char>&& output) {
+    return do_with(std::move(output), true, [body, this] (output_stream<char>& out, bool& first) {
+      return out.write("[").then([&out, &first, body, this] {
+        return parent.graph.shard.local().RandomWalkPeered(body, [&out, &first] (std::vector<std::vector<uint64_t>> walks) {
+          std::string chunk;
+          for (const auto& walk : walks) {
+            if (!first) {
+              chunk.append(",");
+            }
+            first = false;
+            append_ids(chunk, walk);
+          }
+          return out.write(chunk).then([&out] {
+            return out.flush();
+          });
+        });
+      }).then([&out] {
+        return out.write("]");
+      }).finally([&out] {
+        return out.close();
+      });
+    });
+  });
+  return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+}
+
+future<std::unique_ptr<reply>> Traversals::PostSamplesHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  // If the query is missing
+  if (req->content.empty()) {
+    rep->write_body("json", std::move(json::stream_object("Empty sample")));
+    rep->set_status(reply::status_type::bad_request);
+    return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+  }
+
+  std::string body = req->content;
+  return parent.graph.shard.local().SampleNeighborsPeered(body)
+    .then([rep = std::move(rep)] (const std::vector<std::map<uint64_t, std::vector<uint64_t>>>& hops) mutable {
+           // One object per hop, from each node sampled to its sampled neighbors
+           std::string json = "[";
+           for (size_t hop = 0; hop < hops.size(); hop++) {
+             if (hop > 0) {
+               json.append(",");
+             }
+             json.append("{");
+             bool first = true;
+             for (const auto& [id, neighbors] : hops[hop]) {
+               if (!first) {
+                 json.append(",");
+               }
+               first = false;
+               json.append("\"" + std::to_string(id) + "\":");
+               append_ids(json, neighbors);
+             }
+             json.append("}");
+           }
+           json.append("]");
+           rep->write_body("json", sstring(json));
+           return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+    });
+}
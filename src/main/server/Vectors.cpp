@@ -0,0 +1,85 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "JSON.h"
+#include "Vectors.h"
+
+void Vectors::set_routes(routes &routes) {
+
+  auto postVector = new match_rule(Server::timed(graph, "POST /vector/{type}/{property}", &postVectorHandler));
+  postVector->add_str("/db/" + graph.GetName() + "/vector");
+  postVector->add_param("type");
+  postVector->add_param("property");
+  routes.add(postVector, operation_type::POST);
+
+  auto postNearest = new match_rule(Server::timed(graph, "POST /nearest", &postNearestHandler));
+  postNearest->add_str("/db/" + graph.GetName() + "/nearest");
+  routes.add(postNearest, operation_type::POST);
+
+}
+
+future<std::unique_ptr<reply>> Vectors::PostVectorHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  bool valid_type = Server::validate_parameter(Server::TYPE, req, rep, "Invalid type");
+  bool valid_property = Server::validate_parameter(Server::PROPERTY, req, rep, "Invalid property");
+
+  if (valid_type && valid_property) {
+    uint32_t dimensions = 0;
+    try {
+      dimensions = std::stoul(req->get_query_param("dimensions"));
+    } catch (std::exception& e) {
+      dimensions = 0;
+    }
+    if (dimensions == 0) {
+      rep->write_body("json", std::move(json::stream_object("Invalid dimensions parameter")));
+      rep->set_status(reply::status_type::bad_request);
+      return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+    }
+
+    return parent.graph.shard.local().NodeVectorPropertyCreatePeered(req->param[Server::TYPE], req->param[Server::PROPERTY], dimensions)
+      .then([rep = std::move(rep)] (bool created) mutable {
+             if (created) {
+               rep->set_status(reply::status_type::created);
+             } else {
+               rep->write_body("json", std::move(json::stream_object("Invalid type or the property has scalars or vectors of another size")));
+               rep->set_status(reply::status_type::bad_request);
+             }
+             return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+      });
+  }
+  return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+}
+
+future<std::unique_ptr<reply>> Vectors::PostNearestHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  // If the query is missing
+  if (req->content.empty()) {
+    rep->write_body("json", std::move(json::stream_object("Empty nearest")));
+    rep->set_status(reply::status_type::bad_request);
+    return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+  }
+
+  std::string body = req->content;
+  return parent.graph.shard.local().NodesNearestPeered(body)
+    .then([rep = std::move(rep)] (const std::vector<Neighbor>& neighbors) mutable {
+           json_values_builder json;
+           for (const auto& neighbor : neighbors) {
+             json_properties_builder neighbor_json;
+             neighbor_json.add_properties({{"id", static_cast<int64_t>(neighbor.id)}, {"distance", neighbor.distance}});
+             json.add(neighbor_json.as_json());
+           }
+           rep->write_body("json", sstring(json.as_json()));
+           return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+    });
+}
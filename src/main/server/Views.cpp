@@ -0,0 +1,72 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Views.h"
+
+// Views nobody closes are dropped after an hour unless asked to live longer
+static const uint64_t VIEW_TTL = 3600;
+
+void Views::set_routes(routes &routes) {
+
+  auto postView = new match_rule(Server::timed(graph, "POST /views", &postViewHandler));
+  postView->add_str("/db/" + graph.GetName() + "/views");
+  routes.add(postView, operation_type::POST);
+
+  auto deleteView = new match_rule(Server::timed(graph, "DELETE /views/{id}", &deleteViewHandler));
+  deleteView->add_str("/db/" + graph.GetName() + "/views");
+  deleteView->add_param("id");
+  routes.add(deleteView, operation_type::DELETE);
+
+}
+
+future<std::unique_ptr<reply>> Views::PostViewHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  uint64_t ttl = VIEW_TTL;
+  sstring ttl_param = req->get_query_param("ttl");
+  if (!ttl_param.empty()) {
+    try {
+      ttl = std::stoull(ttl_param);
+    } catch (std::exception& e) {
+      rep->write_body("json", std::move(json::stream_object("Invalid ttl parameter")));
+      rep->set_status(reply::status_type::bad_request);
+      return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+    }
+  }
+
+  return parent.graph.shard.local().ReadViewOpenPeered(ttl)
+    .then([rep = std::move(rep)] (uint64_t view_id) mutable {
+           rep->write_body("json", std::move(json::stream_object(view_id)));
+           return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+    });
+}
+
+future<std::unique_ptr<reply>> Views::DeleteViewHandler::handle(const sstring &path, std::unique_ptr<request> req, std::unique_ptr<reply> rep) {
+  uint64_t id = Server::validate_id(req, rep);
+
+  if (id > 0) {
+    return parent.graph.shard.local().ReadViewClosePeered(id)
+      .then([rep = std::move(rep)] (bool closed) mutable {
+             if (closed) {
+               rep->write_body("json", std::move(json::stream_object(closed)));
+             } else {
+               rep->write_body("json", std::move(json::stream_object("Unknown view")));
+               rep->set_status(reply::status_type::not_found);
+             }
+             return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+      });
+  }
+
+  return make_ready_future<std::unique_ptr<reply>>(std::move(rep));
+}
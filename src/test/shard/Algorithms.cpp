@@ -0,0 +1,153 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../../lib/graph/Shard.h"
+#include <catch2/catch.hpp>
+
+SCENARIO("Algorithms fold their messages into flat arrays", "[algorithm]") {
+
+  GIVEN("The state of an algorithm over four nodes") {
+
+    WHEN("ranks are received and updated") {
+      triton::Algorithm algorithm(triton::AlgorithmKind::PAGERANK, 4);
+      algorithm.receive(1, 0.5);
+      algorithm.receive(1, 0.5);
+      uint64_t changed = algorithm.update(0.85);
+
+      THEN("the messages are summed and damped") {
+        REQUIRE(changed == 3);
+        REQUIRE(algorithm.values[1] == Approx(1.0));
+        REQUIRE(algorithm.values[2] == Approx(0.15));
+        REQUIRE(algorithm.messages[1] == 0.0);
+      }
+    }
+
+    WHEN("distances are received and updated") {
+      triton::Algorithm algorithm(triton::AlgorithmKind::BFS, 4);
+      algorithm.values[1] = 0;
+      algorithm.receive(2, 3);
+      algorithm.receive(2, 1);
+      algorithm.receive(1, 1);
+      uint64_t changed = algorithm.update(0);
+
+      THEN("only the smaller values are kept and those nodes send next") {
+        REQUIRE(changed == 1);
+        REQUIRE(algorithm.values[1] == 0);
+        REQUIRE(algorithm.values[2] == 1);
+        REQUIRE(algorithm.values[3] == triton::Algorithm::UNREACHED);
+        REQUIRE(algorithm.active[2] == 1);
+        REQUIRE(algorithm.active[1] == 0);
+      }
+    }
+  }
+
+  GIVEN("Two sorted lists of ids") {
+    std::vector<uint64_t> few = { 3, 40, 77 };
+    std::vector<uint64_t> many;
+    for (uint64_t id = 1; id <= 200; id += 2) {
+      many.push_back(id);
+    }
+
+    WHEN("they are intersected") {
+      std::vector<uint64_t> common;
+      triton::Algorithm::intersect(few, many, common);
+      std::vector<uint64_t> merged;
+      triton::Algorithm::intersect({ 1, 2, 3 }, { 2, 3, 4 }, merged);
+
+      THEN("only the ids in both are kept, galloping or not") {
+        REQUIRE(common == std::vector<uint64_t>({ 3, 77 }));
+        REQUIRE(merged == std::vector<uint64_t>({ 2, 3 }));
+      }
+    }
+  }
+
+  GIVEN("A shard with a triangle and a tail") {
+    triton::Shard shard(1);
+    shard.NodeTypeInsert("Node", 1);
+    shard.RelationshipTypeInsert("KNOWS", 1);
+    uint64_t one = shard.NodeAddEmpty("Node", 1, "one");
+    uint64_t two = shard.NodeAddEmpty("Node", 1, "two");
+    uint64_t three = shard.NodeAddEmpty("Node", 1, "three");
+    uint64_t four = shard.NodeAddEmpty("Node", 1, "four");
+    shard.RelationshipAddEmptySameShard(1, one, two);
+    shard.RelationshipAddEmptySameShard(1, two, one);
+    shard.RelationshipAddEmptySameShard(1, two, three);
+    shard.RelationshipAddEmptySameShard(1, three, one);
+    shard.RelationshipAddEmptySameShard(1, three, four);
+    shard.RelationshipAddEmptySameShard(1, four, four);
+
+    WHEN("triangles are started") {
+      REQUIRE(shard.TriangleStart(3, triton::AlgorithmKind::CLUSTERING, {}) == 4);
+      auto neighbors = shard.TriangleNeighbors(3, { one, three, four, 99999 });
+
+      THEN("each node keeps its larger neighbors once, without loops") {
+        REQUIRE(neighbors.size() == 3);
+        REQUIRE(neighbors[0].second == std::vector<uint64_t>({ two, three }));
+        REQUIRE(neighbors[1].second == std::vector<uint64_t>({ four }));
+        REQUIRE(neighbors[2].second.empty());
+      }
+    }
+
+    WHEN("the counts of a triangle arrive") {
+      shard.TriangleStart(4, triton::AlgorithmKind::CLUSTERING, {});
+      shard.AlgorithmReceive(4, {{one, 1}, {two, 1}, {three, 1}});
+      shard.AlgorithmUpdate(4, 0);
+      auto results = shard.AlgorithmFinish(4, "");
+
+      THEN("the coefficients follow from the degrees") {
+        REQUIRE(results.size() == 4);
+        REQUIRE(results[0].second == Approx(1.0));
+        REQUIRE(results[2].second == Approx(1.0 / 3.0));
+        REQUIRE(results[3].second == 0.0);
+      }
+    }
+  }
+
+  GIVEN("A shard with three nodes") {
+    triton::Shard shard(1);
+    shard.NodeTypeInsert("Node", 1);
+    uint64_t one = shard.NodeAddEmpty("Node", 1, "one");
+    uint64_t two = shard.NodeAddEmpty("Node", 1, "two");
+    uint64_t three = shard.NodeAddEmpty("Node", 1, "three");
+
+    WHEN("components are started and a smaller label arrives") {
+      REQUIRE(shard.AlgorithmStart(1, triton::AlgorithmKind::WCC, {}) == 3);
+      shard.AlgorithmReceive(1, {{three, static_cast<double>(one)}, {99999, 0}});
+      REQUIRE(shard.AlgorithmUpdate(1, 0) == 1);
+      auto results = shard.AlgorithmFinish(1, "");
+
+      THEN("every node has its component") {
+        REQUIRE(results.size() == 3);
+        REQUIRE(results[0] == std::pair<uint64_t, double>(one, one));
+        REQUIRE(results[1] == std::pair<uint64_t, double>(two, two));
+        REQUIRE(results[2] == std::pair<uint64_t, double>(three, one));
+      }
+    }
+
+    WHEN("a search is started and finished into a property") {
+      REQUIRE(shard.AlgorithmStart(2, triton::AlgorithmKind::BFS, {two}) == 1);
+      auto results = shard.AlgorithmFinish(2, "distance");
+
+      THEN("only the reached nodes get the property") {
+        REQUIRE(results.empty());
+        REQUIRE(shard.NodePropertyGetInteger(two, "distance") == 0);
+        REQUIRE(shard.NodePropertyGetInteger(one, "distance") == std::numeric_limits<int64_t>::min());
+        REQUIRE(shard.AlgorithmUpdate(2, 0) == 0);
+      }
+    }
+  }
+}
@@ -188,5 +188,61 @@ SCENARIO( "Shard can handle All Nodes", "[node]" ) {
         REQUIRE(it2.size() == 3);
       }
     }
+
+    WHEN( "nodes are read a page at a time from a cursor" ) {
+      shard.NodeAddEmpty("User", 2, "one");
+      shard.NodeAddEmpty("User", 2, "two");
+      shard.NodeRemove("Node", "four");
+
+      THEN( "each page starts after the last node of the previous one" ) {
+        triton::Cursor cursor;
+        std::vector<triton::Node> page = shard.AllNodes(cursor, 3);
+        REQUIRE(page.size() == 3);
+        REQUIRE(page.back().getKey() == "three");
+
+        cursor.id = shard.externalToInternal(page.back().getId());
+        page = shard.AllNodes(cursor, 3);
+        REQUIRE(page.size() == 3);
+        REQUIRE(page.front().getKey() == "five");
+
+        cursor.id = shard.externalToInternal(page.back().getId());
+        page = shard.AllNodes(cursor, 3);
+        REQUIRE(page.size() == 1);
+
+        cursor = triton::Cursor(0, 2, 0);
+        page = shard.AllNodes(cursor, 10);
+        REQUIRE(page.size() == 2);
+        REQUIRE(page.front().getKey() == "one");
+      }
+
+      THEN( "a cursor of a type pages through the nodes of that type" ) {
+        triton::Cursor cursor(0, 1, 0);
+        std::vector<triton::Node> page = shard.AllNodes(cursor, 3);
+        REQUIRE(page.size() == 3);
+        REQUIRE(page.back().getKey() == "three");
+
+        cursor.id = shard.externalToInternal(page.back().getId());
+        page = shard.AllNodes(cursor, 3);
+        REQUIRE(page.size() == 2);
+        REQUIRE(page.front().getKey() == "five");
+        REQUIRE(page.back().getKey() == "six");
+
+        REQUIRE(shard.AllNodes(triton::Cursor(0, 99, 0), 10).empty());
+      }
+
+      THEN( "the cursor can be given to a client and read back" ) {
+        triton::Cursor cursor;
+        REQUIRE(triton::Cursor::fromString(triton::Cursor(1, 2, 300).toString(), cursor));
+        REQUIRE(cursor.shard == 1);
+        REQUIRE(cursor.type_id == 2);
+        REQUIRE(cursor.id == 300);
+        REQUIRE(cursor.view == 0);
+        REQUIRE(triton::Cursor::fromString(triton::Cursor(1, 2, 300, 1025).toString(), cursor));
+        REQUIRE(cursor.view == 1025);
+        REQUIRE(triton::Cursor::fromString("0", cursor));
+        REQUIRE(cursor.id == 0);
+        REQUIRE_FALSE(triton::Cursor::fromString("not a cursor", cursor));
+      }
+    }
   }
 }
\ No newline at end of file
@@ -234,5 +234,27 @@ SCENARIO( "Shard can handle All Relationships", "[relationship]" ) {
         REQUIRE(it.size() == 3);
       }
     }
+
+    WHEN("relationships with properties are scanned without them") {
+      uint64_t knows = shard.RelationshipAddSameShard(1, "Node", "empty", "Node", "existing", R"({ "weight": 2 })");
+      shard.RelationshipAddSameShard(3, "Node", "existing", "Node", "empty", R"({ "since": "today" })");
+
+      THEN("only the ids, types and ends come back") {
+        std::vector<triton::Relationship> it = shard.AllRelationships((uint16_t)1, 0, 10, NodeProjection::KEY);
+        REQUIRE(it.size() == 1);
+        REQUIRE(it[0].getId() == knows);
+        REQUIRE(it[0].getStartingNodeId() == empty);
+        REQUIRE(it[0].getEndingNodeId() == existing);
+        REQUIRE(it[0].getProperties().empty());
+
+        it = shard.AllRelationships(triton::Cursor(), 10, NodeProjection::KEY);
+        REQUIRE(it.size() == 2);
+        REQUIRE(it[1].getTypeId() == 3);
+        REQUIRE(it[1].getProperties().empty());
+
+        it = shard.RelationshipsGet({knows}, NodeProjection::FULL);
+        REQUIRE(std::any_cast<int64_t>(it[0].getProperty("weight")) == 2);
+      }
+    }
   }
 }
\ No newline at end of file
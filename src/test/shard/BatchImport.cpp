@@ -0,0 +1,85 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../../lib/graph/Shard.h"
+#include <catch2/catch.hpp>
+
+SCENARIO( "Shard can add Nodes and Relationships in batches", "[batch]" ) {
+
+  GIVEN("A shard with a node type and a relationship type") {
+    triton::Shard shard(4);
+    shard.NodeTypeInsert("Node", 1);
+    shard.RelationshipTypeInsert("KNOWS", 1);
+
+    WHEN("a batch of nodes is added") {
+      std::vector<uint64_t> ids = shard.NodesAdd({ { "Node", "max", { { "age", int64_t(42) } } },
+                                                   { "Node", "helene", {} },
+                                                   { "Node", "max", {} },
+                                                   { "User", "tom", {} } });
+
+      THEN("the new nodes get ids in order and the invalid ones get zero") {
+        REQUIRE(ids == std::vector<uint64_t>({ 256, 512, 0, 0 }));
+        REQUIRE(shard.NodePropertyGetInteger(256, "age") == 42);
+        REQUIRE(shard.NodeGetIDs({ { "Node", "helene" }, { "Node", "max" }, { "Node", "tom" } }) == std::vector<uint64_t>({ 512, 256, 0 }));
+      }
+
+      THEN("a batch of relationships between them is added") {
+        std::vector<uint64_t> rel_ids = shard.RelationshipsAddToOutgoing({ { 1, 256, 512, { { "weight", 0.5 } } },
+                                                                          { 1, 1024, 512, {} },
+                                                                          { 2, 256, 512, {} } });
+        REQUIRE(rel_ids == std::vector<uint64_t>({ 256, 0, 0 }));
+        REQUIRE(shard.RelationshipsAddToIncoming({ { 1, 256, 256, 512 } }));
+        REQUIRE(shard.RelationshipPropertyGetDouble(256, "weight") == 0.5);
+        REQUIRE(shard.NodeGetDegree(256, Direction::OUT) == 1);
+        REQUIRE(shard.NodeGetDegree(512, Direction::IN) == 1);
+      }
+    }
+  }
+}
+
+SCENARIO( "Shard can read csv headers and properties", "[batch]" ) {
+
+  GIVEN("A csv with typed property columns") {
+    triton::CsvStringCursor cursor("type,key,name,age:int,weight:double,active:bool,note:string\nNode,max,Max,42,1.5,true,\n");
+    csvmonkey::CsvReader<csvmonkey::StreamCursor> reader(cursor);
+
+    WHEN("the header is read") {
+      REQUIRE(reader.read_row());
+      std::vector<std::pair<std::string, triton::Properties::ColumnType>> header = triton::Shard::CsvHeader(reader.row());
+      size_t type_column = triton::Shard::CsvColumn(header, "type");
+      size_t key_column = triton::Shard::CsvColumn(header, "key");
+
+      THEN("the names and types are split") {
+        REQUIRE(type_column == 0);
+        REQUIRE(key_column == 1);
+        REQUIRE(triton::Shard::CsvColumn(header, "key2") == header.size());
+        REQUIRE(header.at(3) == std::make_pair(std::string("age"), triton::Properties::ColumnType::INTEGER));
+        REQUIRE(header.at(6) == std::make_pair(std::string("note"), triton::Properties::ColumnType::STRING));
+      }
+
+      THEN("the rows are converted to properties without the claimed columns or empty cells") {
+        REQUIRE(reader.read_row());
+        std::map<std::string, std::any> properties = triton::Shard::CsvProperties(header, reader.row());
+        REQUIRE(properties.size() == 4);
+        REQUIRE(std::any_cast<std::string>(properties.at("name")) == "Max");
+        REQUIRE(std::any_cast<int64_t>(properties.at("age")) == 42);
+        REQUIRE(std::any_cast<double>(properties.at("weight")) == 1.5);
+        REQUIRE(std::any_cast<bool>(properties.at("active")));
+      }
+    }
+  }
+}
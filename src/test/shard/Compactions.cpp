@@ -0,0 +1,69 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../../lib/graph/Shard.h"
+#include <catch2/catch.hpp>
+
+SCENARIO("Shard can compact deleted nodes and relationships", "[compaction]") {
+
+  GIVEN("A shard with three nodes and two relationships") {
+    triton::Shard shard(4);
+    shard.NodeTypeInsert("Node", 1);
+    shard.RelationshipTypeInsert("KNOWS", 1);
+    int64_t one = shard.NodeAddEmpty("Node", 1, "one");
+    int64_t two = shard.NodeAddEmpty("Node", 1, "two");
+    int64_t three = shard.NodeAddEmpty("Node", 1, "three");
+    int64_t first = shard.RelationshipAddEmptySameShard(1, "Node", "one", "Node", "two");
+    int64_t second = shard.RelationshipAddEmptySameShard(1, "Node", "one", "Node", "three");
+
+    REQUIRE(three == 768);
+    REQUIRE(second == 512);
+
+    WHEN("the last relationship is removed and the shard is compacted") {
+      uint64_t internal_id = triton::Shard::externalToInternal(second);
+      std::pair <uint16_t, uint64_t> rel_type_incoming_node_id = shard.RelationshipRemoveGetIncoming(internal_id);
+      shard.RelationshipRemoveIncoming(rel_type_incoming_node_id.first, second, rel_type_incoming_node_id.second);
+
+      THEN("a short slice does not finish the pass") {
+        REQUIRE(shard.Compact(1) == 0);
+        REQUIRE(shard.Compact(1) == 0);
+        REQUIRE(shard.Compact(1) == 2);
+      }
+
+      THEN("the empty group and the trailing relationship slot are released") {
+        REQUIRE(shard.Compact(100) == 2);
+        REQUIRE(shard.Compact(100) == 0);
+        REQUIRE(shard.NodeGetDegree("Node", "one") == 1);
+        REQUIRE(shard.NodeGetDegree("Node", "three") == 0);
+        REQUIRE(shard.RelationshipGet(first).getEndingNodeId() == two);
+        REQUIRE(shard.RelationshipAddEmptySameShard(1, "Node", "two", "Node", "three") == second);
+      }
+    }
+
+    WHEN("the last node is removed and the shard is compacted") {
+      shard.NodeRemove("Node", "three");
+
+      THEN("its slot is released and the next node gets its id") {
+        REQUIRE(shard.Compact(100, true) == 2);
+        REQUIRE(shard.NodeGetDegree("Node", "one") == 1);
+        REQUIRE(shard.NodeAddEmpty("Node", 1, "four") == three);
+        REQUIRE(shard.NodeGetDegree("Node", "four") == 0);
+        REQUIRE(shard.NodeGetDegree(one) == 1);
+      }
+    }
+  }
+}
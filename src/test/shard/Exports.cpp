@@ -0,0 +1,86 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../../lib/graph/Export.h"
+#include <catch2/catch.hpp>
+
+SCENARIO("Exports write blocks and rows that read back", "[export]") {
+
+  GIVEN("A block of nodes with typed, missing and mismatched properties") {
+    triton::ExportBlock block;
+    block.kind = triton::ExportBlock::NODES;
+    block.type = "User";
+    block.ids = { 256, 512, 768 };
+    block.keys = { "one", "two", "three" };
+    block.properties = { { {"age", int64_t(42)}, {"name", std::string("max")} },
+                         { {"age", std::string("unknown")}, {"tags", std::vector<std::string>({"a", "b"})} },
+                         { {"score", 0.5}, {"active", true} } };
+
+    WHEN("it is written and read back") {
+      std::string encoded;
+      triton::Serializer serializer(encoded);
+      block.write(serializer);
+      triton::Deserializer reader(encoded.data(), encoded.size());
+      triton::ExportBlock read;
+      bool valid = read.read(reader);
+
+      THEN("every value is where it was") {
+        REQUIRE(valid);
+        REQUIRE(reader.done());
+        REQUIRE(read.type == "User");
+        REQUIRE(read.ids == block.ids);
+        REQUIRE(read.keys == block.keys);
+        REQUIRE(std::any_cast<int64_t>(read.properties[0]["age"]) == 42);
+        REQUIRE(std::any_cast<std::string>(read.properties[0]["name"]) == "max");
+        REQUIRE(std::any_cast<std::string>(read.properties[1]["age"]) == "unknown");
+        REQUIRE(std::any_cast<std::vector<std::string>>(read.properties[1]["tags"]).size() == 2);
+        REQUIRE(std::any_cast<double>(read.properties[2]["score"]) == 0.5);
+        REQUIRE(std::any_cast<bool>(read.properties[2]["active"]));
+        REQUIRE(read.properties[2].count("age") == 0);
+      }
+    }
+
+    WHEN("it is cut short") {
+      std::string encoded;
+      triton::Serializer serializer(encoded);
+      block.write(serializer);
+      triton::Deserializer reader(encoded.data(), encoded.size() / 2);
+      triton::ExportBlock read;
+
+      THEN("it does not read") {
+        REQUIRE_FALSE(read.read(reader));
+      }
+    }
+  }
+
+  GIVEN("The columns of a CSV export") {
+    std::vector<std::pair<std::string, triton::Properties::ColumnType>> columns = {
+      {"age", triton::Properties::ColumnType::INTEGER}, {"name", triton::Properties::ColumnType::STRING}, {"score", triton::Properties::ColumnType::DOUBLE} };
+
+    WHEN("rows are added") {
+      std::string line;
+      triton::ExportFile::appendCsvRow(line, { "User", "max" }, columns, { {"age", int64_t(42)}, {"name", std::string("Max, \"the\" one")} });
+      triton::ExportFile::appendCsvRow(line, { "User", "helene" }, columns, { {"age", std::string("forty")}, {"score", 0.25} });
+
+      THEN("cells are quoted only when needed and values of another type are left out") {
+        REQUIRE(triton::ExportFile::csvColumn("age", triton::Properties::ColumnType::INTEGER) == "age:int");
+        REQUIRE(triton::ExportFile::csvColumn("name", triton::Properties::ColumnType::STRING) == "name:string");
+        REQUIRE(line == "User,max,42,\"Max, \"\"the\"\" one\",\nUser,helene,,,0.25\n");
+      }
+    }
+  }
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../../lib/graph/Shard.h"
+#include <catch2/catch.hpp>
+
+SCENARIO( "Shard can freeze its relationships", "[node,relationship]" ) {
+
+  GIVEN( "A frozen shard with related nodes" ) {
+    triton::Shard shard(4);
+    shard.NodeTypeInsert("Node", 1);
+    int64_t one = shard.NodeAddEmpty("Node", 1,  "one");
+    int64_t two = shard.NodeAddEmpty("Node", 1,  "two");
+    int64_t three = shard.NodeAddEmpty("Node", 1,  "three");
+
+    shard.RelationshipTypeInsert("FRIENDS", 1);
+    shard.RelationshipTypeInsert("ENEMIES", 2);
+    shard.RelationshipAddEmptySameShard(1, one, two);
+    shard.RelationshipAddEmptySameShard(2, one, three);
+    shard.RelationshipAddEmptySameShard(1, three, one);
+    shard.freeze();
+
+    WHEN( "the degrees are requested" ) {
+      THEN( "the shard reads them from the frozen relationships" ) {
+        REQUIRE(3 == shard.NodeGetDegree(one));
+        REQUIRE(2 == shard.NodeGetDegree(one, OUT));
+        REQUIRE(1 == shard.NodeGetDegree(one, IN));
+        REQUIRE(1 == shard.NodeGetDegree(one, OUT, "ENEMIES"));
+        REQUIRE(2 == shard.NodeGetDegree(one, BOTH, "FRIENDS"));
+        REQUIRE(0 == shard.NodeGetDegree(one, BOTH, "UNKNOWN"));
+      }
+    }
+
+    WHEN( "the neighbors are requested" ) {
+      THEN( "the shard reads them from the frozen relationships" ) {
+        auto sharded = shard.NodeGetShardedOutgoingNodeIDs(one, "FRIENDS");
+        REQUIRE(sharded.size() == 1);
+        REQUIRE(sharded.begin()->second == std::vector<uint64_t>({ (uint64_t)two }));
+
+        sharded = shard.NodeGetShardedNodeIDs(one);
+        REQUIRE(sharded.begin()->second.size() == 3);
+      }
+    }
+
+    WHEN( "a relationship is added after the freeze" ) {
+      shard.RelationshipAddEmptySameShard(2, two, one);
+
+      THEN( "the shard sees it" ) {
+        REQUIRE(4 == shard.NodeGetDegree(one));
+        REQUIRE(2 == shard.NodeGetDegree(one, IN));
+        REQUIRE(1 == shard.NodeGetDegree(two, OUT, "ENEMIES"));
+        REQUIRE(shard.NodeGetShardedIncomingNodeIDs(one).begin()->second.size() == 2);
+      }
+    }
+
+    WHEN( "a node is removed after the freeze" ) {
+      shard.NodeRemove(three);
+
+      THEN( "its relationships are gone" ) {
+        REQUIRE(1 == shard.NodeGetDegree(one));
+        REQUIRE(0 == shard.NodeGetDegree(one, BOTH, "ENEMIES"));
+      }
+    }
+
+    WHEN( "the shard is thawed" ) {
+      shard.thaw();
+
+      THEN( "the degrees stay the same" ) {
+        REQUIRE(3 == shard.NodeGetDegree(one));
+        REQUIRE(2 == shard.NodeGetDegree(one, OUT));
+      }
+    }
+  }
+
+  GIVEN( "A shard frozen with compression" ) {
+    triton::Shard shard(4);
+    shard.NodeTypeInsert("Node", 1);
+    shard.RelationshipTypeInsert("FRIENDS", 1);
+    std::vector<uint64_t> ids;
+    for (int i = 0; i < 200; i++) {
+      ids.push_back(shard.NodeAddEmpty("Node", 1, std::to_string(i)));
+    }
+    // Neighbors out of order so some deltas are negative
+    std::vector<uint64_t> friends;
+    for (int i = 199; i > 0; i -= 3) {
+      shard.RelationshipAddEmptySameShard(1, ids[0], ids[i]);
+      friends.push_back(ids[i]);
+    }
+    shard.RelationshipAddEmptySameShard(1, ids[5], ids[0]);
+
+    uint64_t degree = shard.NodeGetDegree(ids[0]);
+    auto before = shard.NodeGetShardedOutgoingNodeIDs(ids[0], "FRIENDS");
+    shard.freeze(true);
+
+    WHEN( "the relationships are requested" ) {
+      THEN( "the shard decodes the same ones in the same order" ) {
+        REQUIRE(degree == shard.NodeGetDegree(ids[0]));
+        REQUIRE(1 == shard.NodeGetDegree(ids[0], IN));
+        REQUIRE(friends.size() == shard.NodeGetDegree(ids[0], OUT, "FRIENDS"));
+        auto after = shard.NodeGetShardedOutgoingNodeIDs(ids[0], "FRIENDS");
+        REQUIRE(after == before);
+        REQUIRE(after.begin()->second == friends);
+        REQUIRE(shard.NodeGetShardedIncomingNodeIDs(ids[0]).begin()->second == std::vector<uint64_t>({ ids[5] }));
+      }
+    }
+
+    WHEN( "a relationship is added after the freeze" ) {
+      shard.RelationshipAddEmptySameShard(1, ids[0], ids[2]);
+
+      THEN( "the shard sees it" ) {
+        REQUIRE(degree + 1 == shard.NodeGetDegree(ids[0]));
+      }
+    }
+  }
+}
@@ -0,0 +1,209 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../../lib/graph/IdsList.h"
+#include <algorithm>
+#include <catch2/catch.hpp>
+
+SCENARIO("Ids lists keep a single relationship inline", "[relationship]") {
+
+  GIVEN("An empty list") {
+    triton::IdsList list;
+
+    WHEN("one relationship is added") {
+      list.emplace_back(256, 512);
+
+      THEN("it stays inline") {
+        REQUIRE(list.size() == 1);
+        REQUIRE(list.capacity() == 1);
+        REQUIRE(list.bytes() == 0);
+        REQUIRE(list[0].node_id == 256);
+        REQUIRE(list[0].rel_id == 512);
+      }
+    }
+
+    WHEN("many relationships are added and most are removed") {
+      for (uint64_t i = 1; i <= 100; i++) {
+        list.emplace_back(i, i * 256);
+      }
+      triton::IdsList copy = list;
+      list.erase(std::remove_if(std::begin(list), std::end(list), [] (triton::Ids entry) {
+        return entry.node_id > 2;
+      }), std::end(list));
+
+      THEN("the list gives back its space and the copy is untouched") {
+        REQUIRE(list.size() == 2);
+        REQUIRE(list.capacity() < 100);
+        REQUIRE(list[1].rel_id == 512);
+        REQUIRE(copy.size() == 100);
+        std::vector<triton::Ids> ids = copy;
+        REQUIRE(ids.back().node_id == 100);
+      }
+    }
+
+    WHEN("a list is moved") {
+      list.emplace_back(1, 2);
+      list.emplace_back(3, 4);
+      triton::IdsList moved = std::move(list);
+      moved.erase(std::begin(moved));
+
+      THEN("the ids go with it") {
+        REQUIRE(moved.size() == 1);
+        REQUIRE(moved[0].node_id == 3);
+        REQUIRE(list.empty());
+      }
+    }
+  }
+}
+
+SCENARIO("Ids lists of supernodes are kept in segments", "[relationship]") {
+
+  GIVEN("A list larger than a segment") {
+    triton::IdsList list;
+    uint64_t size = triton::IdsList::SEGMENT_SIZE * 3;
+    for (uint64_t i = 1; i <= size; i++) {
+      list.emplace_back((i % 64) << 8, i << 8);
+    }
+
+    THEN("it is segmented and keeps the order the ids were added in") {
+      REQUIRE(list.size() == size);
+      REQUIRE(list.segmented());
+      REQUIRE_FALSE(list.sorted());
+      REQUIRE(list.capacity() == size);
+      REQUIRE(list.bytes() > size * sizeof(triton::Ids));
+      REQUIRE(list[triton::IdsList::SEGMENT_SIZE].rel_id == (triton::IdsList::SEGMENT_SIZE + 1) << 8);
+      REQUIRE(std::distance(std::begin(list), std::end(list)) == size);
+    }
+
+    WHEN("a relationship and then every relationship to one node are removed") {
+      list.erase(list.find(triton::Ids(1 << 8, 1 << 8)));
+      size_t removed = list.erase_node(2 << 8);
+
+      THEN("the rest of the list is untouched") {
+        REQUIRE(removed == size / 64);
+        REQUIRE(list.size() == size - 1 - size / 64);
+        REQUIRE(list[0].rel_id == 3 << 8);
+        REQUIRE(list.find(triton::Ids(2 << 8, 2 << 8)) == std::end(list));
+        REQUIRE(list.find(triton::Ids(3 << 8, 3 << 8)) != std::end(list));
+      }
+    }
+
+    WHEN("the relationships to several nodes are removed in one pass") {
+      uint64_t visited = 0;
+      size_t removed = list.erase_nodes({ 2 << 8, 5 << 8, 99 << 8 }, [&visited] (const triton::Ids&) {
+        visited++;
+      });
+
+      THEN("only those nodes are gone") {
+        REQUIRE(removed == 2 * size / 64);
+        REQUIRE(visited == removed);
+        REQUIRE(list.size() == size - removed);
+        REQUIRE(list.find_node(2 << 8) == std::end(list));
+        REQUIRE(list.find_node(5 << 8) == std::end(list));
+        REQUIRE(list.find_node(3 << 8) != std::end(list));
+      }
+    }
+
+    WHEN("the end of the list is taken a batch at a time") {
+      std::vector<uint64_t> rel_ids;
+      size_t taken = list.erase_back(triton::IdsList::SEGMENT_SIZE + 10, [&rel_ids] (const triton::Ids& entry) {
+        rel_ids.push_back(entry.rel_id);
+      });
+      size_t rest = list.erase_back(size, [] (const triton::Ids&) {});
+
+      THEN("the front stays in place until the rest is taken") {
+        REQUIRE(taken == triton::IdsList::SEGMENT_SIZE + 10);
+        REQUIRE(rel_ids.size() == taken);
+        REQUIRE(rel_ids.front() == (size - taken + 1) << 8);
+        REQUIRE(rel_ids.back() == size << 8);
+        REQUIRE(rest == size - taken);
+        REQUIRE(list.empty());
+      }
+    }
+
+    WHEN("most of the list is removed") {
+      list.erase(std::remove_if(std::begin(list), std::end(list), [] (triton::Ids entry) {
+        return entry.node_id != 0;
+      }), std::end(list));
+
+      THEN("it goes back to a single list") {
+        REQUIRE(list.size() == size / 64);
+        REQUIRE_FALSE(list.segmented());
+        REQUIRE(list[0].rel_id == 64 << 8);
+      }
+    }
+  }
+
+  GIVEN("A list larger than a segment that is kept sorted") {
+    triton::IdsList::sort_segments = true;
+    triton::IdsList list;
+    uint64_t size = triton::IdsList::SEGMENT_SIZE * 3;
+    for (uint64_t i = 1; i <= size; i++) {
+      list.emplace_back((i % 64) << 8, i << 8);
+    }
+    triton::IdsList::sort_segments = false;
+
+    THEN("it is ordered by the other node and then the relationship") {
+      REQUIRE(list.sorted());
+      REQUIRE(list.size() == size);
+      std::vector<triton::Ids> ids = list;
+      REQUIRE(std::is_sorted(std::begin(ids), std::end(ids), [] (triton::Ids a, triton::Ids b) {
+        return a.node_id < b.node_id || (a.node_id == b.node_id && a.rel_id < b.rel_id);
+      }));
+      REQUIRE(list[0].rel_id == 64 << 8);
+    }
+
+    WHEN("every relationship to one node is removed") {
+      std::vector<uint64_t> rel_ids;
+      size_t removed = list.erase_node(7 << 8, [&rel_ids] (const triton::Ids& entry) {
+        rel_ids.push_back(entry.rel_id);
+      });
+
+      THEN("only that node is visited and removed") {
+        REQUIRE(removed == size / 64);
+        REQUIRE(rel_ids.size() == removed);
+        REQUIRE(rel_ids.front() == 7 << 8);
+        REQUIRE(list.size() == size - removed);
+        REQUIRE(list.find(triton::Ids(7 << 8, 71 << 8)) == std::end(list));
+        REQUIRE(list.find(triton::Ids(8 << 8, 72 << 8)) != std::end(list));
+      }
+    }
+
+    WHEN("the relationships to a few nodes are removed") {
+      size_t removed = list.erase_nodes({ 3 << 8, 9 << 8 });
+
+      THEN("the list stays sorted") {
+        REQUIRE(removed == 2 * size / 64);
+        REQUIRE(list.sorted());
+        REQUIRE(list.find(triton::Ids(3 << 8, 67 << 8)) == std::end(list));
+        REQUIRE(list.find(triton::Ids(4 << 8, 68 << 8)) != std::end(list));
+      }
+    }
+
+    WHEN("a copy is made") {
+      triton::IdsList copy = list;
+      copy.emplace_back(0, 1);
+
+      THEN("it is sorted and separate") {
+        REQUIRE(copy.sorted());
+        REQUIRE(copy[0].rel_id == 1);
+        REQUIRE(copy.size() == size + 1);
+        REQUIRE(list.size() == size);
+      }
+    }
+  }
+}
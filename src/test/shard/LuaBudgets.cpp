@@ -0,0 +1,44 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../../lib/graph/Shard.h"
+#include <catch2/catch.hpp>
+
+SCENARIO("Shard stops scripts that run over their budget", "[lua]") {
+
+  GIVEN("A shard with an instruction budget") {
+    triton::Shard shard(4);
+    shard.LuaLimits(100000, 0, seastar::default_scheduling_group());
+
+    WHEN("a short loop runs") {
+      std::string result = shard.LuaExecute("", "local x = 0\nfor i = 1, 100 do x = x + i end\nx", {}, {});
+
+      THEN("it finishes") {
+        REQUIRE(result == "[5050]");
+      }
+    }
+
+    WHEN("a tight numeric loop the JIT would compile runs") {
+      std::string result = shard.LuaExecute("", "local x = 0\nfor i = 1, 1000000000 do x = x + i end\nx", {}, {});
+
+      THEN("it is stopped") {
+        REQUIRE(result.find("budget of 100000 instructions") != std::string::npos);
+        REQUIRE(shard.LuaExecute("", "1 + 1", {}, {}) == "[2]");
+      }
+    }
+  }
+}
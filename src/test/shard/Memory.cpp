@@ -0,0 +1,88 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../../lib/graph/Shard.h"
+#include <catch2/catch.hpp>
+
+SCENARIO("Shard accounts for its memory and turns requests away past its limits", "[memory]") {
+
+  GIVEN("A shard with a few nodes and relationships") {
+    triton::Shard shard(4);
+    shard.NodeTypeInsert("Node", 1);
+    shard.RelationshipTypeInsert("KNOWS", 1);
+    uint64_t max = shard.NodeAdd("Node", 1, "max", R"({ "name":"max", "age":42 })");
+    uint64_t helene = shard.NodeAdd("Node", 1, "helene", R"({ "name":"helene" })");
+    shard.RelationshipAddSameShard(1, max, helene, R"({ "since":"a long time ago in a galaxy far away" })");
+
+    WHEN("its memory status is asked for") {
+      std::map<std::string, std::any> before = shard.MemoryStatus();
+      for (int i = 0; i < 1000; i++) {
+        shard.NodeAdd("Node", 1, "a node with a key too long to fit inside its string " + std::to_string(i), R"({ "name":"someone" })");
+      }
+      std::map<std::string, std::any> after = shard.MemoryStatus();
+
+      THEN("every part is there and grows with the nodes") {
+        for (const auto& part : {"allocated", "nodes", "relationships", "properties", "adjacency", "keys", "lua", "result_cache"}) {
+          REQUIRE(before.count(part) == 1);
+          REQUIRE(std::any_cast<int64_t>(after.at(part)) >= 0);
+        }
+        REQUIRE(std::any_cast<int64_t>(before.at("relationships")) > 0);
+        REQUIRE(std::any_cast<int64_t>(before.at("lua")) > 0);
+        REQUIRE(std::any_cast<int64_t>(after.at("nodes")) > std::any_cast<int64_t>(before.at("nodes")));
+        REQUIRE(std::any_cast<int64_t>(after.at("keys")) > std::any_cast<int64_t>(before.at("keys")));
+        REQUIRE(std::any_cast<int64_t>(after.at("properties")) > std::any_cast<int64_t>(before.at("properties")));
+        REQUIRE(std::any_cast<int64_t>(after.at("level")) == 0);
+      }
+    }
+
+    WHEN("limits are set") {
+      shard.MemoryLimits(1000, 2000, 0);
+
+      THEN("allocations are leveled against them") {
+        REQUIRE(shard.MemoryLevel(999) == 0);
+        REQUIRE(shard.MemoryLevel(1000) == triton::Shard::MEMORY_SOFT);
+        REQUIRE(shard.MemoryLevel(2500) == triton::Shard::MEMORY_HARD);
+        shard.MemoryLimits(0, 0, 0);
+        REQUIRE(shard.MemoryLevel(2500) == 0);
+      }
+    }
+
+    WHEN("limits are held against the estimated bytes of the shard alone") {
+      shard.MemoryLimits(1, 0, 0, true);
+
+      THEN("the status says so and the shard is past them") {
+        REQUIRE(std::any_cast<bool>(shard.MemoryStatus().at("estimated")));
+        REQUIRE(shard.MemoryLevel(shard.MemoryUsed()) == triton::Shard::MEMORY_SOFT);
+      }
+    }
+
+    WHEN("another shard announces it is past its soft limit") {
+      shard.MemoryLevelSet(2, triton::Shard::MEMORY_SOFT);
+
+      THEN("writes are turned away and counted, and larger reads only past the hard limit") {
+        REQUIRE(shard.MemoryPressure() == triton::Shard::MEMORY_SOFT);
+        REQUIRE(shard.MemoryRejects(triton::Shard::MEMORY_SOFT));
+        REQUIRE_FALSE(shard.MemoryRejects(triton::Shard::MEMORY_HARD));
+        REQUIRE(std::any_cast<int64_t>(shard.MemoryStatus().at("rejections")) == 1);
+
+        shard.MemoryLevelSet(2, 0);
+        REQUIRE(shard.MemoryPressure() == 0);
+        REQUIRE_FALSE(shard.MemoryRejects(triton::Shard::MEMORY_SOFT));
+      }
+    }
+  }
+}
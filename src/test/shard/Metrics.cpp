@@ -0,0 +1,47 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../../lib/graph/Metrics.h"
+#include <catch2/catch.hpp>
+
+SCENARIO("Latency histograms count in doubling buckets", "[metrics]") {
+
+  GIVEN("A latency histogram") {
+    triton::LatencyHistogram latency;
+
+    WHEN("some latencies are recorded") {
+      latency.record(1);
+      latency.record(3);
+      latency.record(4);
+      latency.record(100000000);
+
+      THEN("the buckets are cumulative and the slowest land in the last one") {
+        seastar::metrics::histogram histogram = latency.histogram();
+        REQUIRE(histogram.sample_count == 4);
+        REQUIRE(histogram.sample_sum == 100000008);
+        REQUIRE(histogram.buckets.size() == triton::LatencyHistogram::BUCKETS);
+        REQUIRE(histogram.buckets[0].count == 1);
+        REQUIRE(histogram.buckets[0].upper_bound == 1);
+        REQUIRE(histogram.buckets[1].count == 1);
+        REQUIRE(histogram.buckets[2].count == 3);
+        REQUIRE(histogram.buckets[2].upper_bound == 4);
+        REQUIRE(histogram.buckets[triton::LatencyHistogram::BUCKETS - 2].count == 3);
+        REQUIRE(histogram.buckets.back().count == 4);
+      }
+    }
+  }
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../../lib/graph/Shard.h"
+#include <catch2/catch.hpp>
+
+SCENARIO("Shard can get many nodes and relationships at once", "[node,relationship]") {
+
+  GIVEN("A shard with related nodes") {
+    triton::Shard shard(1);
+    shard.NodeTypeInsert("User", 1);
+    shard.RelationshipTypeInsert("FRIENDS", 1);
+    shard.RelationshipTypeInsert("ENEMIES", 2);
+
+    uint64_t one = shard.NodeAdd("User", 1, "one", R"({ "age": 30 })");
+    uint64_t two = shard.NodeAdd("User", 1, "two", R"({ "age": 40 })");
+    uint64_t three = shard.NodeAddEmpty("User", 1, "three");
+    uint64_t friends = shard.RelationshipAddEmptySameShard(1, one, two);
+    uint64_t enemies = shard.RelationshipAddEmptySameShard(2, one, three);
+
+    WHEN("the nodes are gotten by type and key") {
+      std::vector<std::pair<std::string, std::string>> type_keys = { {"User", "two"}, {"User", "missing"}, {"User", "one"} };
+      std::vector<triton::Node> nodes = shard.NodesGet(type_keys, NodeProjection::FULL);
+
+      THEN("they are in request order with an empty node for the missing one") {
+        REQUIRE(nodes.size() == 3);
+        REQUIRE(nodes[0].getId() == two);
+        REQUIRE(nodes[1].getId() == 0);
+        REQUIRE(nodes[2].getId() == one);
+      }
+    }
+
+    WHEN("the relationships are gotten with an invalid id") {
+      std::vector<uint64_t> ids = { enemies, 99999, friends };
+      std::vector<triton::Relationship> relationships = shard.RelationshipsGet(ids);
+
+      THEN("the invalid id gets an empty relationship") {
+        REQUIRE(relationships.size() == 3);
+        REQUIRE(relationships[0].getId() == enemies);
+        REQUIRE(relationships[1].getId() == 0);
+        REQUIRE(relationships[2].getId() == friends);
+      }
+    }
+
+    WHEN("the degrees and properties of many nodes are gotten") {
+      std::vector<uint64_t> ids = { one, two, three };
+      std::vector<uint64_t> degrees = shard.NodesGetDegree(ids, BOTH, {});
+      std::vector<uint64_t> friend_degrees = shard.NodesGetDegree(ids, OUT, {"FRIENDS"});
+      std::vector<std::any> ages = shard.NodesGetProperty(ids, "age");
+
+      THEN("each one lines up with its node") {
+        REQUIRE(degrees == std::vector<uint64_t>({2, 1, 1}));
+        REQUIRE(friend_degrees == std::vector<uint64_t>({1, 0, 0}));
+        REQUIRE(ages.size() == 3);
+        REQUIRE(std::any_cast<int64_t>(ages[0]) == 30);
+        REQUIRE(std::any_cast<int64_t>(ages[1]) == 40);
+        REQUIRE(!ages[2].has_value());
+      }
+    }
+
+    WHEN("the typed values of a property of many nodes are gotten") {
+      shard.NodePropertySet(three, "name", std::string("max"));
+      std::vector<uint64_t> ids = { one, two, three, 99999 };
+      std::vector<int64_t> ages = shard.NodesGetIntegerProperty(ids, "age", -1);
+      std::vector<double> weights = shard.NodesGetDoubleProperty(ids, "age", 0.5);
+      std::vector<std::string> names = shard.NodesGetStringProperty(ids, "name", "none");
+
+      THEN("missing values are filled in so each one lines up with its node") {
+        REQUIRE(ages == std::vector<int64_t>({30, 40, -1, -1}));
+        REQUIRE(weights == std::vector<double>({30.0, 40.0, 0.5, 0.5}));
+        REQUIRE(names == std::vector<std::string>({"none", "none", "max", "none"}));
+      }
+    }
+  }
+}
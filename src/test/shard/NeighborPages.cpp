@@ -0,0 +1,102 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../../lib/graph/Shard.h"
+#include <catch2/catch.hpp>
+
+SCENARIO("Shard can page and filter neighbors and relationships", "[node,relationship]") {
+
+  GIVEN("A shard with a node related to users and a place") {
+    triton::Shard shard(1);
+    shard.NodeTypeInsert("User", 1);
+    shard.NodeTypeInsert("Place", 2);
+    shard.RelationshipTypeInsert("FRIENDS", 1);
+    shard.RelationshipTypeInsert("VISITED", 2);
+
+    uint64_t hub = shard.NodeAddEmpty("User", 1, "hub");
+    uint64_t one = shard.NodeAdd("User", 1, "one", R"({ "age": 30 })");
+    uint64_t two = shard.NodeAdd("User", 1, "two", R"({ "age": 40 })");
+    uint64_t three = shard.NodeAdd("User", 1, "three", R"({ "age": 50, "name": "max" })");
+    uint64_t place = shard.NodeAdd("Place", 2, "home", R"({ "age": 100 })");
+    shard.RelationshipAddSameShard(1, hub, one, R"({ "weight": 1 })");
+    shard.RelationshipAddSameShard(1, hub, two, R"({ "weight": 2 })");
+    shard.RelationshipAddSameShard(1, hub, three, R"({ "weight": 3 })");
+    shard.RelationshipAddSameShard(2, hub, place, R"({ "weight": 4 })");
+
+    WHEN("a window of the neighbor ids is requested") {
+      auto sharded = shard.NodeGetShardedNodeIDs(hub, OUT, {}, 1, 2);
+      auto typed = shard.NodeGetShardedNodeIDs(hub, OUT, {"VISITED"}, 0, 10);
+      auto past = shard.NodeGetShardedNodeIDs(hub, OUT, {}, 10, 10);
+
+      THEN("only the ids of the window are kept") {
+        REQUIRE(sharded.size() == 1);
+        REQUIRE(sharded.at(0) == std::vector<uint64_t>({ two, three }));
+        REQUIRE(typed.at(0) == std::vector<uint64_t>({ place }));
+        REQUIRE(past.empty());
+      }
+    }
+
+    WHEN("a window of the relationship ids is requested") {
+      auto sharded = shard.NodeGetShardedRelationshipIDs(hub, BOTH, {"FRIENDS"}, 0, 2);
+      auto incoming = shard.NodeGetShardedRelationshipIDs(hub, IN, {}, 0, 10);
+
+      THEN("only the ids of the window are kept") {
+        REQUIRE(sharded.at(0).size() == 2);
+        REQUIRE(incoming.empty());
+      }
+    }
+
+    WHEN("the neighbors are gotten with a node type and filters") {
+      std::vector<uint64_t> ids = { one, two, three, place, 99999 };
+      std::vector<triton::ScanFilter> filters = { triton::ScanFilter("age", triton::ScanOperator::GE, std::any(int64_t(40))) };
+      std::vector<triton::Node> users = shard.NodesGet(ids, 1, filters, 10, NodeProjection::FULL);
+      std::vector<triton::Node> any = shard.NodesGet(ids, 0, filters, 10, NodeProjection::KEY);
+      std::vector<triton::Node> first = shard.NodesGet(ids, 0, filters, 1, NodeProjection::FULL);
+      std::vector<triton::ScanFilter> names = { triton::ScanFilter("name", triton::ScanOperator::EQ, std::any(std::string("max"))) };
+      std::vector<triton::Node> named = shard.NodesGet(ids, 0, names, 10, NodeProjection::FULL);
+
+      THEN("only the matching nodes come back, up to the limit") {
+        REQUIRE(users.size() == 2);
+        REQUIRE(users[0].getId() == two);
+        REQUIRE(users[1].getId() == three);
+        REQUIRE(std::any_cast<int64_t>(users[1].getProperty("age")) == 50);
+        REQUIRE(any.size() == 3);
+        REQUIRE(any[2].getId() == place);
+        REQUIRE(first.size() == 1);
+        REQUIRE(first[0].getId() == two);
+        REQUIRE(named.size() == 1);
+        REQUIRE(named[0].getId() == three);
+      }
+    }
+
+    WHEN("the relationships are gotten with filters") {
+      auto sharded = shard.NodeGetShardedRelationshipIDs(hub, OUT, {}, 0, 10);
+      std::vector<triton::ScanFilter> filters = { triton::ScanFilter("weight", triton::ScanOperator::LT, std::any(2.5)) };
+      std::vector<triton::Relationship> light = shard.RelationshipsGet(sharded.at(0), filters, 10);
+      std::vector<triton::ScanFilter> missing = { triton::ScanFilter("color", triton::ScanOperator::NE, std::any(std::string("red"))) };
+
+      THEN("only the matching relationships come back") {
+        REQUIRE(light.size() == 2);
+        REQUIRE(light[0].getEndingNodeId() == one);
+        REQUIRE(light[1].getEndingNodeId() == two);
+        REQUIRE(shard.RelationshipsGet(sharded.at(0), {}, 3).size() == 3);
+        REQUIRE(shard.RelationshipsGet(sharded.at(0), missing, 10).empty());
+      }
+    }
+  }
+}
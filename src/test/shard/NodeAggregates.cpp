@@ -0,0 +1,82 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../../lib/graph/Shard.h"
+#include <catch2/catch.hpp>
+
+SCENARIO( "Shard can aggregate node properties", "[node,aggregate]" ) {
+
+  GIVEN( "A shard with nodes that have properties" ) {
+    triton::Shard shard(4);
+    shard.NodeTypeInsert("Node", 1);
+    shard.NodeTypeInsert("User", 2);
+    shard.NodeAdd("Node", 1, "max", R"({ "name":"max", "age":42, "score":10 })");
+    shard.NodeAdd("Node", 1, "helene", R"({ "name":"helene", "age":40.5, "score":20 })");
+    shard.NodeAdd("Node", 1, "tom", R"({ "name":"tom", "age":"old", "score":30 })");
+    shard.NodeAdd("Node", 1, "kim", R"({ "name":"kim" })");
+    shard.NodeAdd("User", 2, "max", R"({ "name":"max", "age":99, "score":99 })");
+
+    WHEN( "nodes are aggregated without filters" ) {
+      THEN( "every node of the type is counted and only numbers are aggregated" ) {
+        REQUIRE(shard.NodesAggregate("Node", {}, "").count == 4);
+        triton::Aggregate aggregate = shard.NodesAggregate("Node", {}, "age");
+        REQUIRE(aggregate.count == 2);
+        REQUIRE(aggregate.sum == 82.5);
+        REQUIRE(aggregate.min == 40.5);
+        REQUIRE(aggregate.max == 42);
+        REQUIRE(aggregate.average() == 41.25);
+        REQUIRE(shard.NodesAggregate("Unknown", {}, "").count == 0);
+      }
+    }
+
+    WHEN( "nodes are aggregated with filters" ) {
+      std::vector<triton::ScanFilter> filters = { triton::ScanFilter("score", triton::ScanOperator::GT, int64_t(10)) };
+
+      THEN( "only the nodes that pass every filter are aggregated" ) {
+        REQUIRE(shard.NodesAggregate("Node", filters, "").count == 2);
+        triton::Aggregate aggregate = shard.NodesAggregate("Node", filters, "age");
+        REQUIRE(aggregate.count == 1);
+        REQUIRE(aggregate.sum == 40.5);
+        filters.emplace_back("name", triton::ScanOperator::NE, std::string("tom"));
+        REQUIRE(shard.NodesAggregate("Node", filters, "score").sum == 20);
+        REQUIRE(shard.NodesAggregate("Node", { triton::ScanFilter("age", triton::ScanOperator::GE, 41.0) }, "score").sum == 10);
+        REQUIRE(shard.NodesAggregate("Node", { triton::ScanFilter("unknown", triton::ScanOperator::EQ, int64_t(1)) }, "").count == 0);
+      }
+    }
+
+    WHEN( "a node is removed" ) {
+      shard.NodeRemove("Node", "max");
+
+      THEN( "it is no longer aggregated" ) {
+        REQUIRE(shard.NodesAggregate("Node", {}, "").count == 3);
+        REQUIRE(shard.NodesAggregate("Node", {}, "score").sum == 50);
+      }
+    }
+
+    WHEN( "partial aggregates are merged" ) {
+      triton::Aggregate aggregate = shard.NodesAggregate("Node", {}, "score");
+      aggregate.merge(shard.NodesAggregate("User", {}, "score"));
+
+      THEN( "they add up" ) {
+        REQUIRE(aggregate.count == 4);
+        REQUIRE(aggregate.sum == 159);
+        REQUIRE(aggregate.min == 10);
+        REQUIRE(aggregate.max == 99);
+      }
+    }
+  }
+}
@@ -241,5 +241,40 @@ SCENARIO( "Shard can handle Node Degrees", "[node]" ) {
         REQUIRE(2 == degree);
       }
     }
+
+    WHEN( "relationships of later types are added first" ) {
+      shard.RelationshipTypeInsert("LIKES", 3);
+      shard.RelationshipAddEmptySameShard(3, four, five);
+      shard.RelationshipAddEmptySameShard(1, four, six);
+      shard.RelationshipAddEmptySameShard(2, four, three);
+      shard.RelationshipAddEmptySameShard(1, four, five);
+
+      THEN( "the shard should find each type and keep them sorted" ) {
+        REQUIRE(4 == shard.NodeGetDegree(four, OUT));
+        REQUIRE(2 == shard.NodeGetDegree(four, OUT, "FRIENDS"));
+        REQUIRE(1 == shard.NodeGetDegree(four, OUT, "ENEMIES"));
+        REQUIRE(1 == shard.NodeGetDegree(four, OUT, "LIKES"));
+        REQUIRE(3 == shard.NodeGetDegree(four, OUT, std::vector<std::string>({ "FRIENDS", "LIKES" })));
+        REQUIRE(shard.NodeGetRelationshipsIDs(four, OUT, "LIKES").size() == 1);
+      }
+    }
+  }
+}
+
+SCENARIO( "Groups are kept sorted by relationship type", "[relationship]" ) {
+
+  GIVEN( "Groups inserted out of order" ) {
+    std::vector<triton::Group> groups;
+    triton::insertGroup(groups, triton::Group(3, {}));
+    triton::insertGroup(groups, triton::Group(1, {}));
+    triton::insertGroup(groups, triton::Group(2, {}));
+
+    THEN( "they are sorted and found by type" ) {
+      REQUIRE(groups[0].rel_type_id == 1);
+      REQUIRE(groups[1].rel_type_id == 2);
+      REQUIRE(groups[2].rel_type_id == 3);
+      REQUIRE(triton::findGroup(groups, 2)->rel_type_id == 2);
+      REQUIRE(triton::findGroup(groups, 4) == std::end(groups));
+    }
   }
-}
\ No newline at end of file
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../../lib/graph/Shard.h"
+#include <catch2/catch.hpp>
+
+SCENARIO("Shard can keep neighbor ids in maps", "[node,relationship]") {
+
+  GIVEN("A shard with related nodes of two types") {
+    triton::Shard shard(1);
+    shard.NodeTypeInsert("Node", 1);
+    shard.NodeTypeInsert("User", 2);
+    shard.RelationshipTypeInsert("FRIENDS", 1);
+    shard.RelationshipTypeInsert("ENEMIES", 2);
+
+    uint64_t one = shard.NodeAddEmpty("Node", 1, "one");
+    uint64_t two = shard.NodeAddEmpty("User", 2, "two");
+    uint64_t three = shard.NodeAddEmpty("User", 2, "three");
+    uint64_t four = shard.NodeAddEmpty("Node", 1, "four");
+    shard.RelationshipAddEmptySameShard(1, one, two);
+    shard.RelationshipAddEmptySameShard(1, one, two);
+    shard.RelationshipAddEmptySameShard(2, one, three);
+    shard.RelationshipAddEmptySameShard(1, four, one);
+
+    WHEN("the neighbor ids are requested") {
+      auto all = shard.NodeGetShardedNodeIdsMap(one, BOTH);
+      auto outgoing = shard.NodeGetShardedNodeIdsMap(one, OUT, { "FRIENDS", "UNKNOWN" });
+
+      THEN("each neighbor is in the map of its shard once") {
+        REQUIRE(all.size() == 1);
+        REQUIRE(all.at(0).cardinality() == 3);
+        REQUIRE(all.at(0).contains(four));
+        REQUIRE(outgoing.at(0).cardinality() == 1);
+        REQUIRE(outgoing.at(0).contains(two));
+        REQUIRE(shard.NodeGetShardedNodeIdsMap(99999, BOTH).empty());
+      }
+    }
+
+    WHEN("the neighbor ids are filtered by type") {
+      Roaring64Map users = shard.NodeIdsMapFilter(shard.NodeGetShardedNodeIdsMap(one, BOTH).at(0), "User");
+
+      THEN("only the ids of that type are left") {
+        REQUIRE(users.cardinality() == 2);
+        REQUIRE(users.contains(two));
+        REQUIRE(users.contains(three));
+        REQUIRE(shard.NodeIdsMapFilter(users, "UNKNOWN").isEmpty());
+      }
+    }
+  }
+}
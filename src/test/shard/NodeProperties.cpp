@@ -563,5 +563,35 @@ SCENARIO( "Shard can handle Node Properties", "[node,properties]" ) {
 
       }
     }
+
+    WHEN("all properties are set from JSON by id") {
+      bool set = shard.NodePropertiesSetFromJson(existing, R"({ "name":"helene", "eyes":"brown", "height":5.11 })");
+      THEN("the fields sent replace or join the ones the node has") {
+        REQUIRE(set);
+        REQUIRE("helene" == shard.NodePropertyGetString(existing, "name"));
+        REQUIRE("brown" == shard.NodePropertyGetString(existing, "eyes"));
+        REQUIRE(5.11 == shard.NodePropertyGetDouble(existing, "height"));
+        REQUIRE(99 == shard.NodePropertyGetInteger(existing, "age"));
+      }
+    }
+
+    WHEN("all properties are reset from JSON by id") {
+      bool reset = shard.NodePropertiesResetFromJson(existing, R"({ "eyes":"brown", "vector":[5,6] })");
+      THEN("only the fields sent are left") {
+        REQUIRE(reset);
+        auto properties = shard.NodePropertiesGet(existing);
+        REQUIRE(properties.size() == 2);
+        REQUIRE("brown" == std::any_cast<std::string>(properties.at("eyes")));
+        REQUIRE(std::any_cast<std::vector<int64_t>>(properties.at("vector")) == std::vector<int64_t>({5, 6}));
+      }
+    }
+
+    WHEN("all properties are set from invalid JSON by id") {
+      bool set = shard.NodePropertiesSetFromJson(existing, R"({ "name": )");
+      THEN("the shard leaves them alone") {
+        REQUIRE_FALSE(set);
+        REQUIRE("max" == shard.NodePropertyGetString(existing, "name"));
+      }
+    }
   }
 }
\ No newline at end of file
@@ -77,6 +77,26 @@ SCENARIO( "Shard can handle Node Types", "[node_types]" ) {
       }
     }
 
+    WHEN("we add a node type before the one under it arrives") {
+      shard.NodeTypeInsert("Person", 1);
+      shard.NodeTypeInsert("Place", 3);
+
+      THEN("it should leave a gap for the missing id") {
+        REQUIRE(shard.NodeTypesGetCount() == 2);
+        REQUIRE(shard.NodeTypesGet() == std::set<std::string>({"Person", "Place"}));
+        REQUIRE(shard.NodeTypeGetTypeId("Place") == 3);
+        REQUIRE(shard.NodeTypeGetType(3) == "Place");
+        REQUIRE(shard.NodeTypeGetType(2).empty());
+      }
+
+      THEN("it should fill the gap when the missing type arrives") {
+        shard.NodeTypeInsert("Thing", 2);
+        REQUIRE(shard.NodeTypesGetCount() == 3);
+        REQUIRE(shard.NodeTypeGetTypeId("Thing") == 2);
+        REQUIRE(shard.NodeTypeGetType(2) == "Thing");
+      }
+    }
+
     WHEN("we add two node types") {
       shard.NodeTypeInsert("Person", 1);
       shard.NodeTypeInsert("User", 2);
@@ -156,4 +176,30 @@ SCENARIO( "Shard can handle Node Types", "[node_types]" ) {
   }
 
 
-}
\ No newline at end of file
+}
+
+SCENARIO("Types hand out the next unused id", "[node_types]") {
+  GIVEN("Types with a gap under the highest id") {
+    triton::Types types;
+    types.addTypeId("Person", 1);
+    types.addTypeId("Place", 3);
+
+    THEN("the next id is past the highest one, not past the count") {
+      REQUIRE(types.getSize() == 2);
+      REQUIRE(types.getNextTypeId() == 4);
+      REQUIRE(types.insertOrGetTypeId("Thing") == 4);
+      REQUIRE(types.getType(3) == "Place");
+    }
+
+    WHEN("the last id is taken") {
+      types.addTypeId("Last", UINT16_MAX);
+
+      THEN("no more ids are handed out instead of wrapping to 0") {
+        REQUIRE(types.getNextTypeId() == 0);
+        REQUIRE(types.insertOrGetTypeId("Overflow") == 0);
+        REQUIRE(types.getTypeId("Overflow") == 0);
+        REQUIRE(types.getType(UINT16_MAX) == "Last");
+      }
+    }
+  }
+}
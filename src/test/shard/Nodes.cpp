@@ -72,6 +72,21 @@ SCENARIO("Shard can handle Nodes", "[node]") {
       }
     }
 
+    WHEN("nodes are gotten with only their keys") {
+      std::vector<uint64_t> ids = { 256, 512 };
+      std::vector<triton::Node> full = shard.NodesGet(ids);
+      std::vector<triton::Node> keys = shard.NodesGet(ids, NodeProjection::KEY);
+
+      THEN("the properties are left behind") {
+        REQUIRE(keys.size() == 2);
+        REQUIRE(keys[1].getId() == 512);
+        REQUIRE(keys[1].getTypeId() == full[1].getTypeId());
+        REQUIRE(keys[1].getKey() == "existing");
+        REQUIRE(keys[1].getProperties().empty());
+        REQUIRE(full[1].getProperties().size() == 2);
+      }
+    }
+
     WHEN("a node with properties is added, removed and readded") {
       shard.NodeAdd("Node", 1, "withProperties",
                     R"({ "name":"max de marzi", "email":"maxdemarzi@gmail.com" })");
@@ -104,6 +119,25 @@ SCENARIO("Shard can handle Nodes", "[node]") {
       }
     }
 
+    WHEN("a node is looked up by its type id and key") {
+      std::string_view key = "existing";
+
+      THEN("the shard finds it only under its own type") {
+        REQUIRE(shard.NodeGetID(1, key) == existing);
+        REQUIRE(shard.NodeGetID("Node", key) == existing);
+        REQUIRE(shard.NodeGetID(2, key) == 0);
+        REQUIRE(shard.NodeGetID(99, key) == 0);
+      }
+    }
+
+    WHEN("a missing key is removed") {
+      bool removed = shard.NodeRemove("Node", "not_there");
+      THEN("the shard does not remove anything") {
+        REQUIRE(!removed);
+        REQUIRE(shard.NodeGetID("Node", "existing") == existing);
+      }
+    }
+
     WHEN("a node is removed by id") {
       int64_t added = shard.NodeAddEmpty("Node", 1, "remove_me_by_id");
       triton::Node addedNode = shard.NodeGet(added);
@@ -181,5 +215,71 @@ SCENARIO("Shard can handle Nodes", "[node]") {
         REQUIRE(degree == 0);
       }
     }
+
+    WHEN("a node with relationships is taken apart in batches") {
+      int64_t added = shard.NodeAddEmpty("Node", 1, "remove_me_in_batches");
+      shard.RelationshipTypeInsert("KNOWS", 1);
+      int64_t toExisting = shard.RelationshipAddEmptySameShard(1, added, existing);
+      int64_t toEmpty = shard.RelationshipAddEmptySameShard(1, added, empty);
+      int64_t fromExisting = shard.RelationshipAddEmptySameShard(1, existing, added);
+
+      auto first = shard.NodeRemoveTakeOutgoing(added, 1);
+      auto rest = shard.NodeRemoveTakeOutgoing(added, 10);
+      auto incoming = shard.NodeRemoveTakeIncoming(added, 10);
+      std::vector<uint64_t> batch = { static_cast<uint64_t>(added) };
+      shard.NodesRemoveDeleteIncoming(batch, first[0]);
+      shard.NodesRemoveDeleteIncoming(batch, rest[0]);
+      shard.NodesRemoveDeleteOutgoing(batch, incoming[0]);
+      bool removed = shard.NodeRemove(added);
+
+      THEN("each batch comes off the end and the neighbors let go of it") {
+        REQUIRE(first[0][1] == std::vector<uint64_t>({ static_cast<uint64_t>(empty) }));
+        REQUIRE(rest[0][1] == std::vector<uint64_t>({ static_cast<uint64_t>(existing) }));
+        REQUIRE(incoming[0][1] == std::vector<uint64_t>({ static_cast<uint64_t>(existing) }));
+        REQUIRE(removed);
+        REQUIRE(shard.NodeGet(added).getId() == 0);
+        REQUIRE(shard.RelationshipGet(toExisting).getId() == 0);
+        REQUIRE(shard.RelationshipGet(toEmpty).getId() == 0);
+        REQUIRE(shard.RelationshipGet(fromExisting).getId() == 0);
+        REQUIRE(shard.NodeGetDegree(existing) == 0);
+        REQUIRE(shard.NodeGetDegree(empty) == 0);
+      }
+    }
+  }
+}
+
+SCENARIO("Shard refuses writes to a node while it moves", "[node]") {
+
+  GIVEN("A shard with two nodes") {
+    triton::Shard shard(4);
+    shard.NodeTypeInsert("Node", 1);
+    shard.RelationshipTypeInsert("KNOWS", 1);
+    uint64_t one = shard.NodeAdd("Node", 1, "one", R"({ "name":"one" })");
+    uint64_t two = shard.NodeAddEmpty("Node", 1, "two");
+
+    WHEN("one of them starts moving") {
+      shard.NodeWritesBlock(one);
+
+      THEN("its properties and relationships are left as they were") {
+        REQUIRE(shard.NodeWritesBlocked(one));
+        REQUIRE_FALSE(shard.NodePropertySet(one, "name", std::string("changed")));
+        REQUIRE_FALSE(shard.NodePropertiesDelete(one));
+        REQUIRE(shard.RelationshipAddEmptySameShard(1, one, two) == 0);
+        REQUIRE(shard.RelationshipAddEmptySameShard(1, two, one) == 0);
+        REQUIRE(std::any_cast<std::string>(shard.NodePropertyGet(one, "name")) == "one");
+        REQUIRE(shard.NodePropertySet(two, "name", std::string("two")));
+      }
+    }
+
+    WHEN("the move fails and lets go of it") {
+      shard.NodeWritesBlock(one);
+      shard.NodeWritesUnblock(one);
+
+      THEN("it can be written again") {
+        REQUIRE_FALSE(shard.NodeWritesBlocked(one));
+        REQUIRE(shard.NodePropertySet(one, "name", std::string("changed")));
+        REQUIRE(shard.RelationshipAddEmptySameShard(1, one, two) > 0);
+      }
+    }
   }
-}
\ No newline at end of file
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "../../lib/graph/Placement.h"
+#include <catch2/catch.hpp>
+
+SCENARIO("Placement puts nodes on shards", "[shard]") {
+
+  GIVEN("A placement over four shards") {
+    triton::Placement placement(4);
+
+    WHEN("nodes are placed by their type and key") {
+      THEN("they go where the hash of type-key puts them") {
+        for (int i = 0; i < 100; i++) {
+          std::string key = "key" + std::to_string(i);
+          uint64_t x64 = std::hash<std::string>()("User-" + key);
+          REQUIRE(placement.getShardId("User", key) == (uint8_t)(((__uint128_t)x64 * (__uint128_t)4) >> 64));
+        }
+        std::string long_key(300, 'x');
+        uint64_t x64 = std::hash<std::string>()("User-" + long_key);
+        REQUIRE(placement.getShardId("User", long_key) == (uint8_t)(((__uint128_t)x64 * (__uint128_t)4) >> 64));
+      }
+    }
+
+    WHEN("an affinity separator is set") {
+      triton::Placement::affinity_separator = ":";
+      THEN("keys that share the part before it go together whatever their type") {
+        for (int i = 0; i < 100; i++) {
+          std::string prefix = "tenant" + std::to_string(i);
+          uint8_t shard_id = placement.getShardId("User", prefix + ":alice");
+          REQUIRE(placement.getShardId("Invoice", prefix + ":7") == shard_id);
+          REQUIRE(placement.getShardId("User", prefix + ":bob") == shard_id);
+        }
+        REQUIRE(placement.getShardId("User", "alice") == triton::Placement(4).getShardId("User", "alice"));
+      }
+      triton::Placement::affinity_separator = "";
+    }
+
+    WHEN("a node is moved") {
+      uint8_t shard_id = placement.getShardId("User", "alice");
+      uint8_t moved_shard_id = (shard_id + 1) % 4;
+      placement.setShardId("User", "alice", moved_shard_id);
+
+      THEN("it stays where it was moved") {
+        REQUIRE(placement.getShardId("User", "alice") == moved_shard_id);
+        REQUIRE(placement.getMovedCount() == 1);
+      }
+
+      THEN("moving it back removes the pin") {
+        placement.setShardId("User", "alice", shard_id);
+        REQUIRE(placement.getShardId("User", "alice") == shard_id);
+        REQUIRE(placement.getMovedCount() == 0);
+      }
+
+      THEN("the pin survives being written and read") {
+        std::string buffer;
+        triton::Serializer serializer(buffer);
+        placement.write(serializer);
+
+        triton::Placement restored(4);
+        triton::Deserializer reader(buffer.data(), buffer.size());
+        REQUIRE(restored.read(reader));
+        REQUIRE(reader.done());
+        REQUIRE(restored.getShardId("User", "alice") == moved_shard_id);
+        REQUIRE(restored.getMovedCount() == 1);
+      }
+
+      THEN("clearing removes the pin") {
+        placement.clear();
+        REQUIRE(placement.getShardId("User", "alice") == shard_id);
+        REQUIRE(placement.getMovedCount() == 0);
+      }
+    }
+  }
+}
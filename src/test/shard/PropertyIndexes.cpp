@@ -0,0 +1,101 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../../lib/graph/Shard.h"
+#include <catch2/catch.hpp>
+
+SCENARIO( "Shard can index node properties", "[node,index]" ) {
+
+  GIVEN( "A shard with nodes that have properties" ) {
+    triton::Shard shard(4);
+    shard.NodeTypeInsert("Node", 1);
+    shard.NodeTypeInsert("User", 2);
+    uint64_t max = shard.NodeAdd("Node", 1, "max", R"({ "name":"max", "age":42 })");
+    uint64_t helene = shard.NodeAdd("Node", 1, "helene", R"({ "name":"helene", "age":40.5 })");
+    uint64_t tom = shard.NodeAdd("Node", 1, "tom", R"({ "name":"tom", "age":"old" })");
+    shard.NodeAdd("User", 2, "max", R"({ "name":"max", "age":42 })");
+
+    REQUIRE(shard.NodePropertyIndexCreate("Node", "name", triton::PropertyIndex::HASH));
+    REQUIRE(shard.NodePropertyIndexCreate("Node", "age", triton::PropertyIndex::SORTED));
+
+    WHEN( "an index is created again" ) {
+      THEN( "only the same kind of index is accepted" ) {
+        REQUIRE(shard.NodePropertyIndexCreate("Node", "name", triton::PropertyIndex::HASH));
+        REQUIRE_FALSE(shard.NodePropertyIndexCreate("Node", "name", triton::PropertyIndex::SORTED));
+        REQUIRE_FALSE(shard.NodePropertyIndexCreate("Unknown", "name", triton::PropertyIndex::HASH));
+        REQUIRE(shard.NodePropertyIndexesGet("Node").size() == 2);
+      }
+    }
+
+    WHEN( "the existing nodes are looked up" ) {
+      THEN( "the index was built from their properties" ) {
+        Roaring64Map found = shard.NodePropertyIndexFind("Node", "name", std::string("max"));
+        REQUIRE(found.cardinality() == 1);
+        REQUIRE(found.contains(max));
+        REQUIRE(shard.NodePropertyIndexFind("Node", "age", 42.0).contains(max));
+        REQUIRE(shard.NodePropertyIndexFind("Node", "age", std::string("old")).contains(tom));
+        REQUIRE(shard.NodePropertyIndexFind("Node", "unindexed", std::string("max")).isEmpty());
+      }
+    }
+
+    WHEN( "a range is looked up" ) {
+      Roaring64Map found = shard.NodePropertyIndexFindRange("Node", "age", int64_t(40), int64_t(42));
+
+      THEN( "integers and doubles inside it are found" ) {
+        REQUIRE(found.cardinality() == 2);
+        REQUIRE(found.contains(max));
+        REQUIRE(found.contains(helene));
+        REQUIRE(shard.NodePropertyIndexFindRange("Node", "age", 40.6, int64_t(100)).cardinality() == 1);
+        REQUIRE(shard.NodePropertyIndexFindRange("Node", "name", std::string("a"), std::string("m")).contains(helene));
+      }
+    }
+
+    WHEN( "properties change and nodes are removed" ) {
+      shard.NodePropertySet(max, "name", std::string("maximus"));
+      shard.NodePropertyDelete(helene, "age");
+      shard.NodePropertiesReset(tom, { { "name", std::string("max") } });
+      shard.NodeRemove("Node", "max");
+
+      THEN( "the indexes follow them" ) {
+        REQUIRE(shard.NodePropertyIndexFind("Node", "name", std::string("maximus")).isEmpty());
+        REQUIRE(shard.NodePropertyIndexFind("Node", "name", std::string("max")).contains(tom));
+        REQUIRE(shard.NodePropertyIndexFindRange("Node", "age", int64_t(0), int64_t(100)).isEmpty());
+        REQUIRE(shard.NodePropertyIndexFind("Node", "age", std::string("old")).isEmpty());
+      }
+    }
+
+    WHEN( "the shard is restored from a snapshot" ) {
+      triton::Shard restored(4);
+      bool valid = restored.SnapshotRestore(shard.SnapshotSections());
+
+      THEN( "the indexes are rebuilt" ) {
+        REQUIRE(valid);
+        REQUIRE(restored.NodePropertyIndexesGet("Node").at("age") == triton::PropertyIndex::SORTED);
+        REQUIRE(restored.NodePropertyIndexFind("Node", "name", std::string("helene")).contains(helene));
+      }
+    }
+
+    WHEN( "an index is dropped" ) {
+      REQUIRE(shard.NodePropertyIndexDrop("Node", "name"));
+
+      THEN( "it finds nothing" ) {
+        REQUIRE_FALSE(shard.NodePropertyIndexDrop("Node", "name"));
+        REQUIRE(shard.NodePropertyIndexFind("Node", "name", std::string("max")).isEmpty());
+      }
+    }
+  }
+}
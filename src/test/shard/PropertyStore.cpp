@@ -0,0 +1,190 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../../lib/graph/Properties.h"
+#include "../../lib/graph/PropertyKeys.h"
+#include <catch2/catch.hpp>
+#include <memory>
+
+SCENARIO( "Properties can store node properties in typed columns", "[node,properties]" ) {
+
+  GIVEN("A property store with two rows") {
+    triton::Properties properties;
+    uint64_t first = properties.addRow();
+    uint64_t second = properties.addRow();
+    properties.setProperties(first, {{"name", std::string("max")}, {"age", int64_t(99)}, {"weight", 230.5}, {"bald", true}});
+
+    REQUIRE( first == 0 );
+    REQUIRE( second == 1 );
+
+    WHEN("the schema is requested") {
+      THEN("it is discovered from the first values") {
+        auto schema = properties.getSchema();
+        REQUIRE(schema.size() == 4);
+        REQUIRE(schema.at("name") == triton::Properties::STRING);
+        REQUIRE(schema.at("age") == triton::Properties::INTEGER);
+        REQUIRE(schema.at("weight") == triton::Properties::DOUBLE);
+        REQUIRE(schema.at("bald") == triton::Properties::BOOLEAN);
+      }
+    }
+
+    WHEN("typed properties are requested") {
+      THEN("they are read from their columns") {
+        int64_t age;
+        double weight;
+        bool bald;
+        std::string name;
+        REQUIRE(properties.getIntegerProperty(first, "age", age));
+        REQUIRE(age == 99);
+        REQUIRE(properties.getDoubleProperty(first, "weight", weight));
+        REQUIRE(weight == 230.5);
+        REQUIRE(properties.getBooleanProperty(first, "bald", bald));
+        REQUIRE(bald);
+        REQUIRE(properties.getStringProperty(first, "name", name));
+        REQUIRE(name == "max");
+      }
+    }
+
+    WHEN("a property is requested from a row without it") {
+      THEN("it is not found") {
+        int64_t age;
+        REQUIRE_FALSE(properties.getIntegerProperty(second, "age", age));
+        REQUIRE_FALSE(properties.getProperty(second, "age").has_value());
+        REQUIRE(properties.getProperties(second).empty());
+      }
+    }
+
+    WHEN("a property is set with a different type than its column") {
+      properties.setProperty(second, "age", std::string("old"));
+      THEN("the value is kept and the column type is unchanged") {
+        int64_t age;
+        std::string old;
+        REQUIRE_FALSE(properties.getIntegerProperty(second, "age", age));
+        REQUIRE(properties.getStringProperty(second, "age", old));
+        REQUIRE(old == "old");
+        REQUIRE(properties.getSchema().at("age") == triton::Properties::INTEGER);
+        REQUIRE(properties.getIntegerProperty(first, "age", age));
+        REQUIRE(age == 99);
+      }
+    }
+
+    WHEN("typed properties are set") {
+      std::string_view key = "age";
+      properties.setIntegerProperty(second, key, 42);
+      properties.setStringProperty(second, "nickname", std::string_view("maxi"));
+      properties.setBooleanProperty(second, "weight", true);
+      THEN("they go into their columns or on the side when the column has another type") {
+        int64_t age;
+        std::string nickname;
+        bool weight;
+        REQUIRE(properties.getIntegerProperty(second, "age", age));
+        REQUIRE(age == 42);
+        REQUIRE(properties.getStringProperty(second, "nickname", nickname));
+        REQUIRE(nickname == "maxi");
+        REQUIRE(properties.getBooleanProperty(second, "weight", weight));
+        REQUIRE(weight);
+        REQUIRE(properties.getSchema().at("weight") == triton::Properties::DOUBLE);
+      }
+    }
+
+    WHEN("an array property is set") {
+      properties.setProperty(first, "vector", std::vector<int64_t>({1, 2, 3, 4}));
+      THEN("it is stored as is") {
+        auto value = properties.getProperty(first, "vector");
+        REQUIRE(value.type() == typeid(std::vector<int64_t>));
+        REQUIRE(std::any_cast<std::vector<int64_t>>(value).size() == 4);
+        REQUIRE(properties.getSchema().at("vector") == triton::Properties::ANY);
+      }
+    }
+
+    WHEN("a property is deleted") {
+      THEN("it is gone") {
+        REQUIRE(properties.deleteProperty(first, "name"));
+        REQUIRE_FALSE(properties.deleteProperty(first, "name"));
+        REQUIRE_FALSE(properties.getProperty(first, "name").has_value());
+        REQUIRE(properties.getProperties(first).size() == 3);
+      }
+    }
+
+    WHEN("a row is removed") {
+      properties.removeRow(first);
+      THEN("its properties are gone and the row is reused") {
+        REQUIRE(properties.getProperties(first).empty());
+        REQUIRE(properties.addRow() == first);
+        REQUIRE(properties.addRow() == 2);
+      }
+    }
+  }
+}
+
+SCENARIO( "Property keys are given dense ids once", "[properties]" ) {
+
+  GIVEN("The keys of a shard with one key added") {
+    triton::PropertyKeys keys;
+    uint16_t key_id = keys.insertKey("interned");
+
+    THEN("the key keeps its id and resolves back to itself") {
+      REQUIRE(key_id == 1);
+      REQUIRE(keys.insertKey("interned") == key_id);
+      REQUIRE(keys.getKeyId("interned") == key_id);
+      REQUIRE(keys.getKey(key_id) == "interned");
+      REQUIRE(keys.getSize() == 1);
+    }
+
+    THEN("keys never seen have no id") {
+      REQUIRE(keys.getKeyId("never seen before") == 0);
+      REQUIRE(keys.getKey(0).empty());
+      REQUIRE(keys.getSize() == 1);
+    }
+
+    THEN("a new key is refused once every id is taken") {
+      while (keys.getSize() < 65535) {
+        REQUIRE(keys.insertKey("key" + std::to_string(keys.getSize())) > 0);
+      }
+      REQUIRE(keys.insertKey("one too many") == 0);
+      REQUIRE(keys.insertKey("interned") == key_id);
+    }
+  }
+
+  GIVEN("Two property stores sharing the keys of a shard") {
+    auto keys = std::make_shared<triton::PropertyKeys>();
+    triton::Properties people(keys);
+    triton::Properties places(keys);
+    uint64_t person = people.addRow();
+    uint64_t place = places.addRow();
+    people.setProperty(person, "name", std::string("max"));
+    places.setProperties(place, {{"name", std::string("austin")}, {"population", int64_t(950000)}});
+
+    THEN("a key used by both takes one id") {
+      REQUIRE(keys->getSize() == 2);
+      REQUIRE(keys->getKeyId("name") == 1);
+      REQUIRE(keys->getKeyId("population") == 2);
+    }
+
+    THEN("each store keeps its own values under the shared ids") {
+      REQUIRE(std::any_cast<std::string>(people.getProperty(person, "name")) == "max");
+      REQUIRE(std::any_cast<std::string>(places.getProperty(place, "name")) == "austin");
+      REQUIRE(people.getProperties(person).size() == 1);
+      REQUIRE(places.getProperties(place).size() == 2);
+    }
+
+    THEN("a key only the other store has is not a column here") {
+      REQUIRE_FALSE(people.getProperty(person, "population").has_value());
+      REQUIRE_FALSE(people.deleteProperty(person, "population"));
+    }
+  }
+}
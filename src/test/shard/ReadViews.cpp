@@ -0,0 +1,144 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../../lib/graph/Shard.h"
+#include <catch2/catch.hpp>
+
+SCENARIO( "Shard can scan a read view while it changes", "[node,relationship]" ) {
+
+  GIVEN( "A shard with a read view open" ) {
+    triton::Shard shard(4);
+    shard.NodeTypeInsert("Node", 1);
+    shard.RelationshipTypeInsert("KNOWS", 1);
+    uint64_t one = shard.NodeAdd("Node", 1, "one", R"({ "name":"one" })");
+    uint64_t two = shard.NodeAddEmpty("Node", 1, "two");
+    uint64_t three = shard.NodeAddEmpty("Node", 1, "three");
+    uint64_t knows = shard.RelationshipAddSameShard(1, one, two, R"({ "weight":1 })");
+
+    REQUIRE(shard.ReadViewOpen(1024, 60));
+    REQUIRE_FALSE(shard.ReadViewOpen(1024, 60));
+    triton::Cursor cursor(0, 0, 0, 1024);
+
+    WHEN( "nodes are changed, removed and added after it opened" ) {
+      shard.NodePropertySet(one, "name", std::string("changed"));
+      shard.NodeRemove(three);
+      shard.NodeAddEmpty("Node", 1, "four");
+      shard.NodeAddEmpty("Node", 1, "five");
+
+      THEN( "the view sees the nodes as they were" ) {
+        std::vector<triton::Node> page = shard.AllNodes(cursor, 10);
+        REQUIRE(page.size() == 3);
+        REQUIRE(page[0].getProperties().at("name").type() == typeid(std::string));
+        REQUIRE(std::any_cast<std::string>(page[0].getProperties().at("name")) == "one");
+        REQUIRE(page[2].getKey() == "three");
+      }
+
+      THEN( "the live graph sees the changes" ) {
+        std::vector<triton::Node> page = shard.AllNodes(triton::Cursor(), 10);
+        REQUIRE(page.size() == 4);
+        REQUIRE(std::any_cast<std::string>(page[0].getProperties().at("name")) == "changed");
+        REQUIRE(page[2].getKey() == "four");
+      }
+
+      THEN( "a scan of the view by type keeps the nodes removed since it opened" ) {
+        triton::Cursor typed(0, 1, 0, 1024);
+        std::vector<triton::Node> page = shard.AllNodes(typed, 2);
+        REQUIRE(page.size() == 2);
+        REQUIRE(std::any_cast<std::string>(page[0].getProperties().at("name")) == "one");
+
+        typed.id = shard.externalToInternal(page.back().getId());
+        page = shard.AllNodes(typed, 2);
+        REQUIRE(page.size() == 1);
+        REQUIRE(page[0].getKey() == "three");
+      }
+    }
+
+    WHEN( "relationships are changed and added after it opened" ) {
+      shard.RelationshipPropertySet(knows, "weight", int64_t(2));
+      shard.RelationshipAddEmptySameShard(1, two, three);
+
+      THEN( "the view sees the relationships as they were" ) {
+        std::vector<triton::Relationship> page = shard.AllRelationships(cursor, 10);
+        REQUIRE(page.size() == 1);
+        REQUIRE(std::any_cast<int64_t>(page[0].getProperties().at("weight")) == 1);
+        REQUIRE(shard.AllRelationships(triton::Cursor(), 10).size() == 2);
+      }
+
+      THEN( "a scan of the view by type sees them as they were too" ) {
+        std::vector<triton::Relationship> page = shard.AllRelationships(triton::Cursor(0, 1, 0, 1024), 10);
+        REQUIRE(page.size() == 1);
+        REQUIRE(std::any_cast<int64_t>(page[0].getProperties().at("weight")) == 1);
+        REQUIRE(shard.AllRelationships(triton::Cursor(0, 1, 0), 10).size() == 2);
+      }
+    }
+
+    WHEN( "a node is changed twice" ) {
+      shard.NodePropertySet(one, "name", std::string("first"));
+      shard.NodePropertySet(one, "name", std::string("second"));
+
+      THEN( "the view keeps the version from before the first change" ) {
+        std::vector<triton::Node> page = shard.AllNodes(cursor, 1);
+        REQUIRE(std::any_cast<std::string>(page[0].getProperties().at("name")) == "one");
+      }
+    }
+
+    WHEN( "the view is closed" ) {
+      REQUIRE(shard.ReadViewClose(1024));
+
+      THEN( "it has nothing to scan" ) {
+        REQUIRE_FALSE(shard.ReadViewExists(1024));
+        REQUIRE_FALSE(shard.ReadViewClose(1024));
+        REQUIRE(shard.ReadViewCount() == 0);
+        REQUIRE(shard.AllNodes(cursor, 10).empty());
+      }
+    }
+
+    WHEN( "a view expires" ) {
+      REQUIRE(shard.ReadViewOpen(2048, 0));
+
+      THEN( "it is gone" ) {
+        REQUIRE_FALSE(shard.ReadViewExists(2048));
+        REQUIRE(shard.ReadViewExists(1024));
+      }
+    }
+  }
+}
+
+SCENARIO( "Shard pins the read views other shards handed out before it takes in their calls", "[node]" ) {
+
+  GIVEN( "A shard sharing its view ids with the rest of the graph" ) {
+    std::atomic<uint64_t> epochs{0};
+    triton::Shard shard(4);
+    shard.ReadViewShare(&epochs);
+    shard.NodeTypeInsert("Node", 1);
+    shard.NodeAddEmpty("Node", 1, "one");
+
+    WHEN( "another shard hands out a view and this one hears of it" ) {
+      epochs++;
+      REQUIRE_FALSE(shard.ReadViewExists(1));
+      shard.ReadViewCatchUp();
+      shard.NodeAddEmpty("Node", 1, "two");
+
+      THEN( "the view holds what the shard had when it heard of it" ) {
+        REQUIRE(shard.ReadViewExists(1));
+        REQUIRE(shard.AllNodes(triton::Cursor(0, 0, 0, 1), 10).size() == 1);
+        shard.ReadViewCatchUp();
+        REQUIRE(shard.ReadViewCount() == 1);
+      }
+    }
+  }
+}
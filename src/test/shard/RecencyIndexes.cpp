@@ -0,0 +1,175 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../lib/graph/RecencyIndex.h"
+#include "../../lib/graph/Shard.h"
+#include <catch2/catch.hpp>
+
+SCENARIO( "RecencyIndex keeps the relationships of each node in key order", "[relationship,recency]" ) {
+
+  GIVEN("An index with relationships of two nodes added out of order") {
+    triton::RecencyIndex index("at", false, 1000);
+    index.add(256, 30, 3);
+    index.add(256, 10, 1);
+    index.add(256, 20, 2);
+    index.add(256, 20, 4);
+    index.add(512, 15, 5);
+
+    THEN("the newest come back first and a window keeps only its keys") {
+      REQUIRE(index.size() == 5);
+      std::vector<triton::RecencyIndex::Entry> newest = index.newest(256, std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max(), 3);
+      REQUIRE(newest.size() == 3);
+      REQUIRE(newest[0].rel_id == 3);
+      REQUIRE(newest[1].rel_id == 4);
+      REQUIRE(newest[2].rel_id == 2);
+
+      std::vector<triton::RecencyIndex::Entry> window = index.newest(256, 15, 20, 10);
+      REQUIRE(window.size() == 2);
+      REQUIRE(window[0].key == 20);
+      REQUIRE(window[1].key == 20);
+      REQUIRE(index.newest(256, 40, 50, 10).empty());
+      REQUIRE(index.newest(768, 0, 100, 10).empty());
+    }
+
+    THEN("the oldest of every node are found before a cutoff") {
+      std::vector<triton::RecencyIndex::Entry> old = index.before(20, 10);
+      REQUIRE(old.size() == 2);
+      REQUIRE(old[0].rel_id == 1);
+      REQUIRE(old[1].rel_id == 5);
+      REQUIRE(index.before(100, 1).size() == 1);
+    }
+
+    WHEN("entries are removed") {
+      REQUIRE(index.remove(256, 20, 2));
+      REQUIRE(index.remove(512, 15, 5));
+      REQUIRE_FALSE(index.remove(256, 20, 2));
+      REQUIRE_FALSE(index.remove(256, 11, 1));
+
+      THEN("they are gone from both orders") {
+        REQUIRE(index.size() == 3);
+        REQUIRE(index.newest(512, 0, 100, 10).empty());
+        REQUIRE(index.before(25, 10).size() == 2);
+      }
+    }
+  }
+
+  GIVEN("Property values") {
+    int64_t key = 0;
+
+    THEN("integers and whole doubles are keys") {
+      REQUIRE(triton::RecencyIndex::toKey(std::any(int64_t(42)), key));
+      REQUIRE(key == 42);
+      REQUIRE(triton::RecencyIndex::toKey(std::any(7.0), key));
+      REQUIRE(key == 7);
+      REQUIRE_FALSE(triton::RecencyIndex::toKey(std::any(7.5), key));
+      REQUIRE_FALSE(triton::RecencyIndex::toKey(std::any(std::string("yesterday")), key));
+      REQUIRE_FALSE(triton::RecencyIndex::toKey(std::any(), key));
+    }
+  }
+}
+
+SCENARIO( "Shard can find the recent relationships of a node", "[relationship,recency]" ) {
+
+  GIVEN("A shard with timed relationships from one node") {
+    triton::Shard shard(4);
+    shard.NodeTypeInsert("Node", 1);
+    shard.RelationshipTypeInsert("LIKES", 1);
+    shard.RelationshipTypeInsert("KNOWS", 2);
+    uint64_t max = shard.NodeAddEmpty("Node", 1, "max");
+    shard.NodeAddEmpty("Node", 1, "helene");
+    uint64_t first = shard.RelationshipAddSameShard(1, "Node", "max", "Node", "helene", R"({ "at":100 })");
+    uint64_t second = shard.RelationshipAddSameShard(1, "Node", "max", "Node", "helene", R"({ "at":300 })");
+    uint64_t third = shard.RelationshipAddSameShard(1, "Node", "max", "Node", "helene", R"({ "at":200 })");
+    shard.RelationshipAddSameShard(1, "Node", "max", "Node", "helene", R"({ "at":"later" })");
+
+    REQUIRE(shard.RelationshipRecencyIndexCreate("LIKES", "at", false, 0));
+
+    THEN("the existing relationships were indexed, newest first") {
+      std::vector<triton::Relationship> recent = shard.NodeGetRecentRelationships("Node", "max", "LIKES", 0, 1000, 10);
+      REQUIRE(recent.size() == 3);
+      REQUIRE(recent[0].getId() == second);
+      REQUIRE(recent[1].getId() == third);
+      REQUIRE(recent[2].getId() == first);
+      REQUIRE(shard.NodeGetRecentRelationships(max, "LIKES", 150, 250, 10).size() == 1);
+      REQUIRE(shard.NodeGetRecentRelationships(max, "LIKES", 0, 1000, 1, NodeProjection::KEY)[0].getProperties().empty());
+      REQUIRE(shard.NodeGetRecentRelationships(max, "KNOWS", 0, 1000, 10).empty());
+    }
+
+    THEN("only the same index can be created again") {
+      REQUIRE(shard.RelationshipRecencyIndexCreate("LIKES", "at", false, 0));
+      REQUIRE_FALSE(shard.RelationshipRecencyIndexCreate("LIKES", "when", false, 0));
+      REQUIRE_FALSE(shard.RelationshipRecencyIndexCreate("UNKNOWN", "at", false, 0));
+    }
+
+    WHEN("relationships are added, changed and removed") {
+      uint64_t fourth = shard.RelationshipAddSameShard(1, "Node", "max", "Node", "helene", R"({ "at":400 })");
+      shard.RelationshipPropertySet(first, "at", int64_t(500));
+      shard.RelationshipPropertyDelete(third, "at");
+      shard.RelationshipRemoveGetIncoming(triton::Shard::externalToInternal(second));
+
+      THEN("the index follows them") {
+        std::vector<triton::Relationship> recent = shard.NodeGetRecentRelationships(max, "LIKES", 0, 1000, 10);
+        REQUIRE(recent.size() == 2);
+        REQUIRE(recent[0].getId() == first);
+        REQUIRE(recent[1].getId() == fourth);
+      }
+    }
+
+    WHEN("the shard is restored from a snapshot") {
+      triton::Shard restored(4);
+      bool valid = restored.SnapshotRestore(shard.SnapshotSections());
+
+      THEN("the index is rebuilt") {
+        REQUIRE(valid);
+        REQUIRE(restored.NodeGetRecentRelationships(max, "LIKES", 0, 1000, 10).size() == 3);
+      }
+    }
+
+    WHEN("the index is dropped") {
+      REQUIRE(shard.RelationshipRecencyIndexDrop("LIKES"));
+
+      THEN("nothing is found") {
+        REQUIRE_FALSE(shard.RelationshipRecencyIndexDrop("LIKES"));
+        REQUIRE(shard.NodeGetRecentRelationships(max, "LIKES", 0, 1000, 10).empty());
+      }
+    }
+  }
+
+  GIVEN("A stamping index with a ttl") {
+    triton::Shard shard(4);
+    shard.NodeTypeInsert("Node", 1);
+    shard.RelationshipTypeInsert("VISITED", 1);
+    uint64_t max = shard.NodeAddEmpty("Node", 1, "max");
+    shard.NodeAddEmpty("Node", 1, "helene");
+    REQUIRE(shard.RelationshipRecencyIndexCreate("VISITED", "at", true, 60000));
+
+    int64_t before = triton::RecencyIndex::now();
+    uint64_t stamped = shard.RelationshipAddEmptySameShard(1, "Node", "max", "Node", "helene");
+    uint64_t old = shard.RelationshipAddSameShard(1, "Node", "max", "Node", "helene", R"({ "at":1000 })");
+
+    THEN("relationships without the property get the time they arrived") {
+      REQUIRE(shard.RelationshipPropertyGetInteger(stamped, "at") >= before);
+      REQUIRE(shard.RelationshipPropertyGetInteger(old, "at") == 1000);
+      REQUIRE(shard.NodeGetRecentRelationships(max, "VISITED", before, std::numeric_limits<int64_t>::max(), 10)[0].getId() == stamped);
+    }
+
+    THEN("only the ones past the ttl have expired") {
+      std::vector<uint64_t> expired = shard.RelationshipsExpired(10);
+      REQUIRE(expired.size() == 1);
+      REQUIRE(expired[0] == old);
+    }
+  }
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../../lib/graph/Shard.h"
+#include <catch2/catch.hpp>
+
+SCENARIO("Shard can check and merge relationships between two nodes", "[relationship]") {
+
+  GIVEN("A shard with three nodes and a relationship") {
+    triton::Shard shard(4);
+    shard.NodeTypeInsert("Node", 1);
+    shard.RelationshipTypeInsert("KNOWS", 1);
+    shard.RelationshipTypeInsert("LIKES", 2);
+    int64_t one = shard.NodeAddEmpty("Node", 1, "one");
+    int64_t two = shard.NodeAddEmpty("Node", 1, "two");
+    int64_t three = shard.NodeAddEmpty("Node", 1, "three");
+    int64_t knows = shard.RelationshipAddEmptySameShard(1, one, two);
+
+    THEN("the relationship is found in its direction only") {
+      REQUIRE(shard.RelationshipGetID(one, two, 1, OUT) == knows);
+      REQUIRE(shard.RelationshipGetID(one, two, 1, IN) == 0);
+      REQUIRE(shard.RelationshipGetID(two, one, 1, IN) == knows);
+      REQUIRE(shard.RelationshipGetID(two, one, 1, BOTH) == knows);
+      REQUIRE(shard.RelationshipGetID(one, two, 2, BOTH) == 0);
+      REQUIRE(shard.RelationshipGetID(one, three, 1, BOTH) == 0);
+      REQUIRE(shard.RelationshipGetID(0, two, 1, BOTH) == 0);
+    }
+
+    THEN("a batch is answered in order") {
+      std::vector<bool> exist = shard.RelationshipsExist({{one, two}, {one, three}, {two, one}}, 1, OUT);
+      REQUIRE(exist == std::vector<bool>{true, false, false});
+    }
+
+    WHEN("an existing relationship is merged") {
+      std::pair<uint64_t, bool> merged = shard.RelationshipMergeToOutgoing(1, one, two, R"({ "weight": 2 })");
+
+      THEN("the existing one is returned untouched") {
+        REQUIRE(merged.first == knows);
+        REQUIRE_FALSE(merged.second);
+        REQUIRE(shard.NodeGetDegree(one) == 1);
+        REQUIRE(shard.RelationshipPropertiesGet(knows).empty());
+      }
+    }
+
+    WHEN("a missing relationship is merged twice") {
+      std::pair<uint64_t, bool> merged = shard.RelationshipMergeToOutgoing(1, one, three, R"({ "weight": 2 })");
+      std::pair<uint64_t, bool> again = shard.RelationshipMergeToOutgoing(1, one, three, "");
+
+      THEN("it is added once") {
+        REQUIRE(merged.first > 0);
+        REQUIRE(merged.second);
+        REQUIRE(again.first == merged.first);
+        REQUIRE_FALSE(again.second);
+        REQUIRE(shard.NodeGetDegree(one) == 2);
+        REQUIRE(shard.NodeGetDegree(three) == 1);
+        REQUIRE(shard.RelationshipGetID(three, one, 1, IN) == merged.first);
+        REQUIRE(shard.RelationshipPropertyGetInteger(merged.first, "weight") == 2);
+      }
+    }
+
+    WHEN("a node has more relationships than a segment") {
+      for (uint64_t i = 0; i < triton::IdsList::SEGMENT_SIZE * 2; i++) {
+        shard.RelationshipAddEmptySameShard(2, one, three);
+      }
+      shard.RelationshipAddEmptySameShard(2, one, two);
+
+      THEN("the relationships past the first segment are found") {
+        REQUIRE(shard.RelationshipGetID(one, two, 2, OUT) > 0);
+        REQUIRE(shard.RelationshipGetID(one, one, 2, OUT) == 0);
+        REQUIRE(shard.NodeGetDegree(one, OUT, "LIKES") == triton::IdsList::SEGMENT_SIZE * 2 + 1);
+      }
+    }
+  }
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../lib/graph/RelationshipStore.h"
+#include <catch2/catch.hpp>
+
+SCENARIO( "RelationshipStore keeps relationships as parallel arrays", "[relationship]" ) {
+
+  GIVEN("A store with the zero relationship and two typed ones") {
+    triton::RelationshipStore store;
+    store.set(0, 0, 0, 0);
+    store.set(1, 1, 256, 512, {{"weight", int64_t(3)}});
+    store.set(2, 2, 512, 256, {{"since", std::string("yesterday")}});
+
+    THEN("the types and both ends are read without the properties") {
+      REQUIRE(store.size() == 3);
+      REQUIRE(store.getTypeId(1) == 1);
+      REQUIRE(store.getStartingNodeId(1) == 256);
+      REQUIRE(store.getEndingNodeId(1) == 512);
+      REQUIRE(store.getTypeId(2) == 2);
+
+      triton::Relationship ends = store.getEndpoints(1, 256);
+      REQUIRE(ends.getId() == 256);
+      REQUIRE(ends.getStartingNodeId() == 256);
+      REQUIRE(ends.getEndingNodeId() == 512);
+      REQUIRE(ends.getProperties().empty());
+    }
+
+    THEN("a copy comes back with the properties of its type") {
+      triton::Relationship relationship = store.get(1, 256);
+      REQUIRE(relationship.getTypeId() == 1);
+      REQUIRE(std::any_cast<int64_t>(relationship.getProperty("weight")) == 3);
+      REQUIRE(std::any_cast<std::string>(store.getProperty(2, "since")) == "yesterday");
+      REQUIRE_FALSE(store.getProperty(1, "since").has_value());
+    }
+
+    WHEN("properties are changed") {
+      store.setProperty(1, "weight", int64_t(5));
+      store.setProperties(2, {{"active", true}});
+      REQUIRE(store.deleteProperty(1, "weight"));
+
+      THEN("only that relationship sees them") {
+        REQUIRE(std::any_cast<bool>(store.getProperty(2, "active")));
+        REQUIRE_FALSE(store.getProperty(1, "weight").has_value());
+        REQUIRE_FALSE(store.getProperty(1, "active").has_value());
+      }
+    }
+
+    WHEN("a relationship is removed and its slot reused") {
+      store.remove(1);
+
+      THEN("the empty slot reads as the zero relationship") {
+        REQUIRE(store.getTypeId(1) == 0);
+        REQUIRE(store.get(1, 256).getId() == 0);
+        REQUIRE(store.getProperties(1).empty());
+      }
+
+      store.set(1, 1, 768, 256);
+
+      THEN("the new relationship does not get the old properties") {
+        REQUIRE(store.getStartingNodeId(1) == 768);
+        REQUIRE_FALSE(store.getProperty(1, "weight").has_value());
+      }
+    }
+
+    WHEN("a relationship is set past the end") {
+      store.set(5, 1, 256, 256);
+
+      THEN("the slots in between are empty") {
+        REQUIRE(store.size() == 6);
+        REQUIRE(store.getTypeId(3) == 0);
+        REQUIRE(store.getTypeId(4) == 0);
+        REQUIRE(store.getTypeId(5) == 1);
+      }
+    }
+
+    THEN("the bytes count the arrays and the columns") {
+      REQUIRE(store.bytes() >= 3 * (sizeof(uint16_t) + 3 * sizeof(uint64_t)));
+    }
+  }
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../../lib/graph/Shard.h"
+#include <catch2/catch.hpp>
+
+SCENARIO( "Replicas follow a shard through the records it logs", "[replication]" ) {
+
+  GIVEN("A shard keeping its records for replicas") {
+    triton::Shard shard(4);
+    shard.ReplicationFollow(1024 * 1024);
+    shard.NodeTypeInsert("Node", 1);
+    shard.RelationshipTypeInsert("KNOWS", 1);
+    uint64_t max = shard.NodeAdd("Node", 1, "max", R"({ "name":"max", "age":42 })");
+
+    WHEN("a replica restores its snapshot and applies the records logged since") {
+      std::string snapshot;
+      triton::Serializer snapshot_serializer(snapshot);
+      REQUIRE(shard.ReplicationSnapshot(snapshot_serializer));
+      triton::Shard replica(4);
+      replica.ReadOnly();
+      triton::Deserializer snapshot_reader(snapshot.data(), snapshot.size());
+      bool restored = replica.ReplicationRestore(snapshot_reader);
+
+      uint64_t helene = shard.NodeAdd("Node", 1, "helene", R"({ "name":"helene" })");
+      uint64_t knows = shard.RelationshipAddSameShard(1, "Node", "max", "Node", "helene", "");
+      shard.NodePropertySet(max, "age", int64_t(43));
+
+      std::string records;
+      triton::Serializer records_serializer(records);
+      REQUIRE(shard.ReplicationRecords(replica.ReplicationSequence(), 1024, records_serializer));
+      triton::Deserializer records_reader(records.data(), records.size());
+      bool applied = replica.ReplicationApply(records_reader);
+
+      THEN("it holds the same graph") {
+        REQUIRE(restored);
+        REQUIRE(applied);
+        REQUIRE(replica.NodeGetID("Node", "max") == max);
+        REQUIRE(replica.NodeGetID("Node", "helene") == helene);
+        REQUIRE(replica.NodePropertyGetInteger(max, "age") == 43);
+        REQUIRE(replica.RelationshipGetEndingNodeId(knows) == helene);
+        REQUIRE(std::any_cast<int64_t>(replica.ReplicationStatus().at("sequence")) == std::any_cast<int64_t>(shard.ReplicationStatus().at("sequence")));
+        REQUIRE(std::any_cast<int64_t>(replica.ReplicationStatus().at("lag")) == 0);
+      }
+    }
+
+    WHEN("more is logged than the shard keeps") {
+      shard.ReplicationFollow(64);
+      for (int i = 0; i < 10; i++) {
+        shard.NodeAddEmpty("Node", 1, "node" + std::to_string(i));
+      }
+      std::string records;
+      triton::Serializer serializer(records);
+
+      THEN("the oldest records are gone") {
+        REQUIRE_FALSE(shard.ReplicationRecords(0, 1024, serializer));
+      }
+    }
+  }
+
+  GIVEN("A shard that keeps no records") {
+    triton::Shard shard(4);
+    std::string records;
+    triton::Serializer serializer(records);
+
+    THEN("replicas cannot follow it") {
+      REQUIRE_FALSE(shard.ReplicationRecords(0, 1024, serializer));
+      REQUIRE_FALSE(shard.ReplicationSnapshot(serializer));
+    }
+  }
+}
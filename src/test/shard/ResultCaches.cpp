@@ -0,0 +1,130 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "../../lib/graph/ResultCache.h"
+#include "../../lib/graph/Shard.h"
+#include <catch2/catch.hpp>
+
+SCENARIO("Result cache keeps results until the graph changes", "[shard]") {
+
+  GIVEN("A disabled result cache") {
+    triton::ResultCache cache;
+
+    THEN("it keeps nothing") {
+      std::string result;
+      cache.put("GET /neighbors", 1, "[]");
+      REQUIRE_FALSE(cache.enabled());
+      REQUIRE_FALSE(cache.get("GET /neighbors", 1, result));
+      REQUIRE(cache.getSize() == 0);
+    }
+  }
+
+  GIVEN("A result cache of 64 bytes") {
+    triton::ResultCache cache(64);
+
+    WHEN("a result is put") {
+      cache.put("GET /neighbors", 1, "[1,2,3]");
+
+      THEN("it is found at the same epoch") {
+        std::string result;
+        REQUIRE(cache.get("GET /neighbors", 1, result));
+        REQUIRE(result == "[1,2,3]");
+        REQUIRE(cache.getHits() == 1);
+        REQUIRE(cache.getBytes() == 21);
+      }
+
+      THEN("it is stale at any other epoch and dropped") {
+        std::string result;
+        REQUIRE_FALSE(cache.get("GET /neighbors", 2, result));
+        REQUIRE(cache.getMisses() == 1);
+        REQUIRE(cache.getSize() == 0);
+        REQUIRE(cache.getBytes() == 0);
+      }
+
+      THEN("putting it again replaces it") {
+        std::string result;
+        cache.put("GET /neighbors", 2, "[4]");
+        REQUIRE(cache.getSize() == 1);
+        REQUIRE(cache.get("GET /neighbors", 2, result));
+        REQUIRE(result == "[4]");
+        REQUIRE(cache.getBytes() == 17);
+      }
+    }
+
+    WHEN("more results are put than fit") {
+      std::string result;
+      cache.put("a", 1, std::string(25, 'a'));
+      cache.put("b", 1, std::string(25, 'b'));
+      REQUIRE(cache.get("a", 1, result));
+      cache.put("c", 1, std::string(25, 'c'));
+
+      THEN("the least recently used ones are evicted") {
+        REQUIRE(cache.getEvictions() == 1);
+        REQUIRE(cache.getSize() == 2);
+        REQUIRE(cache.get("a", 1, result));
+        REQUIRE(cache.get("c", 1, result));
+        REQUIRE_FALSE(cache.get("b", 1, result));
+      }
+    }
+
+    WHEN("a result larger than the cache is put") {
+      cache.put("big", 1, std::string(100, 'x'));
+
+      THEN("it is not kept") {
+        std::string result;
+        REQUIRE_FALSE(cache.get("big", 1, result));
+        REQUIRE(cache.getBytes() == 0);
+      }
+    }
+
+    WHEN("the cache is shrunk") {
+      cache.put("a", 1, std::string(20, 'a'));
+      cache.put("b", 1, std::string(20, 'b'));
+      cache.resize(30);
+
+      THEN("it evicts until the rest fits") {
+        std::string result;
+        REQUIRE(cache.getSize() == 1);
+        REQUIRE(cache.get("b", 1, result));
+        cache.resize(0);
+        REQUIRE(cache.getSize() == 0);
+        REQUIRE_FALSE(cache.enabled());
+      }
+    }
+  }
+}
+
+SCENARIO("Shards publish their mutation epochs for the result cache", "[shard]") {
+
+  GIVEN("A shard sharing its epoch with another one") {
+    triton::PublishedEpoch epochs[2];
+    triton::Shard shard(2);
+    shard.MutationEpochShare(epochs);
+    uint64_t before = shard.MutationEpochs();
+
+    WHEN("both shards change") {
+      shard.NodeTypeInsert("Node", 1);
+      epochs[1].epoch = 5;
+
+      THEN("the sum is read without asking either of them") {
+        REQUIRE(shard.MutationEpoch() == before + 1);
+        REQUIRE(epochs[0].epoch == shard.MutationEpoch());
+        REQUIRE(shard.MutationEpochs() == before + 6);
+      }
+    }
+  }
+}
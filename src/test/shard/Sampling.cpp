@@ -0,0 +1,81 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../../lib/graph/Shard.h"
+#include <catch2/catch.hpp>
+
+SCENARIO("Shard can take its part of random walks and samples", "[sampling]") {
+
+  GIVEN("A shard with one node that knows three others") {
+    triton::Shard shard(1);
+    shard.NodeTypeInsert("Node", 1);
+    shard.RelationshipTypeInsert("KNOWS", 1);
+
+    uint64_t one = shard.NodeAddEmpty("Node", 1, "one");
+    uint64_t two = shard.NodeAddEmpty("Node", 1, "two");
+    uint64_t three = shard.NodeAddEmpty("Node", 1, "three");
+    uint64_t four = shard.NodeAddEmpty("Node", 1, "four");
+    shard.RelationshipAddEmptySameShard(1, one, two);
+    shard.RelationshipAddEmptySameShard(1, one, three);
+    shard.RelationshipAddEmptySameShard(1, one, four);
+    shard.RelationshipAddEmptySameShard(1, two, one);
+    std::vector<uint16_t> all;
+
+    WHEN("walkers take a step") {
+      std::vector<triton::Walker> walkers = { {0, one, 0, {}}, {1, three, 0, {}}, {2, 99999, 0, {}} };
+      std::vector<triton::Walker> stepped = shard.RandomWalkStep(walkers, 0, OUT, all, 1, 1, 7);
+      std::vector<triton::Walker> again = shard.RandomWalkStep(walkers, 0, OUT, all, 1, 1, 7);
+
+      THEN("they move to a neighbor, end at a dead end and reject a start that is not a node") {
+        REQUIRE(stepped.size() == 3);
+        REQUIRE((stepped[0].current == two || stepped[0].current == three || stepped[0].current == four));
+        REQUIRE(stepped[0].previous == one);
+        REQUIRE(stepped[0].current == again[0].current);
+        REQUIRE(stepped[1].current == 0);
+        REQUIRE(stepped[1].previous == three);
+        REQUIRE(stepped[2].current == 0);
+        REQUIRE(stepped[2].previous == 0);
+      }
+    }
+
+    WHEN("a biased walker that came from a neighbor takes a step") {
+      std::vector<triton::Walker> walkers = { {0, one, two, {one}} };
+      std::vector<triton::Walker> stepped = shard.RandomWalkStep(walkers, 1, OUT, all, 0.000001, 1, 7);
+
+      THEN("a small p sends it back and it carries the neighbors it left") {
+        REQUIRE(stepped[0].current == two);
+        REQUIRE(stepped[0].previous == one);
+        REQUIRE(stepped[0].previous_neighbors == std::vector<uint64_t>({ two, three, four }));
+      }
+    }
+
+    WHEN("neighbors are sampled") {
+      auto few = shard.SampleNeighbors({ one, 99999 }, 2, 0, OUT, all, 7);
+      auto many = shard.SampleNeighbors({ one }, 5, 0, OUT, all, 7);
+      auto same = shard.SampleNeighbors({ one }, 2, 0, OUT, all, 7);
+
+      THEN("no more than the fanout are taken, each only once") {
+        REQUIRE(few.size() == 1);
+        REQUIRE(few[0].first == one);
+        REQUIRE(few[0].second.size() == 2);
+        REQUIRE(few[0].second[0] != few[0].second[1]);
+        REQUIRE(many[0].second.size() == 3);
+        REQUIRE(same[0].second == few[0].second);
+      }
+    }
+  }
+}
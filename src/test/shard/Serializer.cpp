@@ -0,0 +1,63 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../lib/graph/Serializer.h"
+#include <catch2/catch.hpp>
+
+SCENARIO( "Serializer can write the arguments of a command and read them back", "[command_log]" ) {
+
+  GIVEN("A buffer with ids, strings and properties") {
+    std::string buffer;
+    triton::Serializer serializer(buffer);
+    serializer.put(uint16_t(3));
+    serializer.put(uint64_t(1024));
+    serializer.put(std::string("Node"));
+    std::map<std::string, std::any> properties = {{"name", std::string("max")}, {"age", int64_t(99)}, {"weight", 230.5},
+                                                  {"bald", true}, {"tags", std::vector<std::string>({"a", "b"})}};
+    serializer.put(properties);
+    serializer.put(std::map<uint16_t, std::vector<uint64_t>>({{1, {256, 513}}}));
+
+    WHEN("it is read back") {
+      triton::Deserializer reader(buffer.data(), buffer.size());
+      THEN("the same values come out in the same order") {
+        REQUIRE(reader.getUint16() == 3);
+        REQUIRE(reader.getUint64() == 1024);
+        REQUIRE(reader.getString() == "Node");
+        std::map<std::string, std::any> read = reader.getProperties();
+        REQUIRE(read.size() == 5);
+        REQUIRE(std::any_cast<std::string>(read.at("name")) == "max");
+        REQUIRE(std::any_cast<int64_t>(read.at("age")) == 99);
+        REQUIRE(std::any_cast<double>(read.at("weight")) == 230.5);
+        REQUIRE(std::any_cast<bool>(read.at("bald")) == true);
+        REQUIRE(std::any_cast<std::vector<std::string>>(read.at("tags")) == std::vector<std::string>({"a", "b"}));
+        std::map<uint16_t, std::vector<uint64_t>> grouped = reader.getGroupedIds();
+        REQUIRE(grouped.at(1) == std::vector<uint64_t>({256, 513}));
+        REQUIRE(reader.done());
+        REQUIRE_FALSE(reader.failed());
+      }
+    }
+
+    WHEN("it is cut short") {
+      triton::Deserializer reader(buffer.data(), 12);
+      THEN("reading past the end fails instead of throwing") {
+        REQUIRE(reader.getUint16() == 3);
+        REQUIRE(reader.getUint64() == 1024);
+        reader.getString();
+        REQUIRE(reader.failed());
+      }
+    }
+  }
+}
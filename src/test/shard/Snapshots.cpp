@@ -0,0 +1,68 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../../lib/graph/Shard.h"
+#include <catch2/catch.hpp>
+
+SCENARIO( "Shard can be copied into snapshot sections and restored from them", "[snapshot]" ) {
+
+  GIVEN("A shard with nodes, relationships and a deleted node") {
+    triton::Shard shard(4);
+    shard.NodeTypeInsert("Node", 1);
+    shard.RelationshipTypeInsert("KNOWS", 1);
+    uint64_t max = shard.NodeAdd("Node", 1, "max", R"({ "name":"max", "age":42 })");
+    uint64_t helene = shard.NodeAdd("Node", 1, "helene", R"({ "name":"helene", "tags":["a","b"] })");
+    uint64_t gone = shard.NodeAddEmpty("Node", 1, "gone");
+    uint64_t knows = shard.RelationshipAddSameShard(1, "Node", "max", "Node", "helene", R"({ "weight":0.5 })");
+    shard.NodeRemove("Node", "gone");
+
+    WHEN("the sections are restored into a new shard") {
+      std::vector<std::string> sections = shard.SnapshotSections();
+      triton::Shard restored(4);
+      bool valid = restored.SnapshotRestore(sections);
+
+      THEN("it holds the same graph") {
+        REQUIRE(valid);
+        REQUIRE(restored.NodeTypesGetCount("Node") == 2);
+        REQUIRE(restored.NodeGetID("Node", "max") == max);
+        REQUIRE(restored.NodeGetID("Node", "helene") == helene);
+        REQUIRE(restored.NodeGetID("Node", "gone") == 0);
+        REQUIRE(restored.NodePropertyGetInteger(max, "age") == 42);
+        REQUIRE(restored.NodePropertiesGet(helene).size() == 2);
+        REQUIRE(restored.RelationshipGetStartingNodeId(knows) == max);
+        REQUIRE(restored.RelationshipGetEndingNodeId(knows) == helene);
+        REQUIRE(restored.RelationshipPropertyGetDouble(knows, "weight") == 0.5);
+        REQUIRE(restored.NodeGetDegree(max, Direction::OUT) == 1);
+        REQUIRE(restored.NodeGetDegree(helene, Direction::IN) == 1);
+      }
+
+      THEN("deleted ids are reused") {
+        REQUIRE(restored.NodeAddEmpty("Node", 1, "new") == gone);
+      }
+    }
+
+    WHEN("a section is damaged") {
+      std::vector<std::string> sections = shard.SnapshotSections();
+      sections[1].resize(sections[1].size() / 2);
+      triton::Shard restored(4);
+
+      THEN("the restore fails") {
+        REQUIRE_FALSE(restored.SnapshotRestore(sections));
+      }
+    }
+  }
+}
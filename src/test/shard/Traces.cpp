@@ -0,0 +1,80 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../../lib/graph/Shard.h"
+#include <catch2/catch.hpp>
+
+SCENARIO("Shard keeps slow and traced requests", "[trace]") {
+
+  GIVEN("A shard with a slow query threshold") {
+    triton::Shard shard(4);
+    shard.TraceLimits(1000, 2, 0);
+    auto long_ago = std::chrono::steady_clock::now() - std::chrono::milliseconds(5);
+
+    WHEN("requests that did not ask to be traced come in") {
+      auto trace = shard.TraceStart(false);
+      shard.SlowQueryRecord("GET /node/{id}", 0, std::chrono::steady_clock::now(), trace, false);
+      shard.SlowQueryRecord("POST /lua", 0xabc, long_ago, trace, false);
+      shard.SlowQueryRecord("POST /lua", 0xabc, long_ago, trace, false);
+
+      THEN("they are not traced and only one in two of the slow ones is kept") {
+        REQUIRE(!trace);
+        std::vector<triton::SlowQuery> queries = shard.SlowQueries();
+        REQUIRE(queries.size() == 1);
+        REQUIRE(queries[0].name == "POST /lua abc");
+        REQUIRE(queries[0].trace_id == 0);
+        REQUIRE(queries[0].microseconds >= 5000);
+      }
+    }
+
+    WHEN("a request asks to be traced") {
+      auto trace = shard.TraceStart(true);
+      triton::TraceHop* hop = trace->hop("NodeGet", 1);
+      hop->started = hop->sent + 10;
+      hop->finished = hop->sent + 30;
+      hop->returned = hop->sent + 35;
+      trace->hop("NodesGet", 2);
+      trace->stage("lua_wait", trace->start);
+      shard.SlowQueryRecord("GET /node/{id}", 0, std::chrono::steady_clock::now(), trace, true);
+
+      THEN("it is kept with the calls that came back, whatever it took") {
+        REQUIRE(trace->id == 256);
+        std::vector<triton::SlowQuery> queries = shard.SlowQueries(trace->id);
+        REQUIRE(queries.size() == 1);
+        REQUIRE(queries[0].hops.size() == 1);
+        REQUIRE(queries[0].hops[0].operation == "NodeGet");
+        REQUIRE(queries[0].hops[0].started - queries[0].hops[0].sent == 10);
+        REQUIRE(queries[0].hops[0].finished - queries[0].hops[0].started == 20);
+        REQUIRE(queries[0].stages.size() == 1);
+        REQUIRE(queries[0].stages[0].start == 0);
+        REQUIRE(shard.SlowQueries(trace->id + 256).empty());
+      }
+    }
+
+    WHEN("calls are made in a trace scope") {
+      auto trace = shard.TraceStart(true);
+      {
+        triton::Shard::TraceScope scope(shard, trace);
+        REQUIRE(shard.CurrentTrace() == trace);
+      }
+
+      THEN("the trace is only current inside it") {
+        REQUIRE(!shard.CurrentTrace());
+      }
+    }
+  }
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../../lib/graph/Shard.h"
+#include <catch2/catch.hpp>
+
+SCENARIO("Shard can hold its part of a traversal", "[traversal]") {
+
+  GIVEN("A shard with nodes of two types") {
+    triton::Shard shard(1);
+    shard.NodeTypeInsert("Node", 1);
+    shard.NodeTypeInsert("User", 2);
+    shard.RelationshipTypeInsert("FRIENDS", 1);
+
+    uint64_t one = shard.NodeAddEmpty("Node", 1, "one");
+    uint64_t two = shard.NodeAddEmpty("User", 2, "two");
+    uint64_t three = shard.NodeAddEmpty("User", 2, "three");
+
+    WHEN("nodes reach it for a hop") {
+      shard.TraverseReceive(1, 1, 2, triton::TraverseDedup::GLOBAL, { one, two, two, three, 99999 });
+
+      THEN("it keeps each node of the right type once") {
+        std::vector<triton::Node> found = shard.TraverseCollect(1, 1);
+        REQUIRE(found.size() == 2);
+        REQUIRE(found[0].getKey() == "two");
+        REQUIRE(found[1].getKey() == "three");
+        REQUIRE(shard.TraverseCollect(1, 1).empty());
+      }
+    }
+
+    WHEN("nodes reach it again in a later hop") {
+      shard.TraverseReceive(2, 0, 0, triton::TraverseDedup::GLOBAL, { one, two });
+      shard.TraverseReceive(2, 1, 0, triton::TraverseDedup::GLOBAL, { one, three });
+      shard.TraverseReceive(3, 0, 0, triton::TraverseDedup::HOP, { one, two });
+      shard.TraverseReceive(3, 1, 0, triton::TraverseDedup::HOP, { one, three });
+
+      THEN("only hop dedup keeps the ones it has seen before") {
+        REQUIRE(shard.TraverseCollect(2, 1).size() == 1);
+        REQUIRE(shard.TraverseCollect(3, 1).size() == 2);
+      }
+    }
+
+    WHEN("steps are given by name") {
+      triton::TraverseStep step = shard.TraverseStepFor("out", { "FRIENDS" }, "User");
+      triton::TraverseStep any = shard.TraverseStepFor("all", {}, "");
+
+      THEN("they are resolved to ids") {
+        REQUIRE(step.direction == OUT);
+        REQUIRE(step.rel_type_ids == std::vector<uint16_t>({ 1 }));
+        REQUIRE(step.node_type_id == 2);
+        REQUIRE(any.direction == BOTH);
+        REQUIRE(any.rel_type_ids.empty());
+        REQUIRE(any.node_type_id == 0);
+      }
+    }
+  }
+}
+
+SCENARIO("Shard can hold its part of a shortest path search", "[traversal]") {
+
+  GIVEN("A shard with four nodes") {
+    triton::Shard shard(1);
+    shard.NodeTypeInsert("Node", 1);
+
+    uint64_t one = shard.NodeAddEmpty("Node", 1, "one");
+    uint64_t two = shard.NodeAddEmpty("Node", 1, "two");
+    uint64_t three = shard.NodeAddEmpty("Node", 1, "three");
+    uint64_t four = shard.NodeAddEmpty("Node", 1, "four");
+
+    WHEN("both sides start and reach each other") {
+      REQUIRE(shard.PathStart(1, 0, one));
+      REQUIRE(shard.PathStart(1, 1, four));
+      REQUIRE(!shard.PathStart(1, 1, 99999));
+      shard.PathReceive(1, 0, { {two, one, 10}, {two, one, 11}, {three, one, 12} });
+      auto start_side = shard.PathAdvance(1, 0);
+      shard.PathReceive(1, 1, { {three, four, 13}, {one, four, 14} });
+      auto end_side = shard.PathAdvance(1, 1);
+
+      THEN("each node keeps the first way it was reached and the shortest meeting wins") {
+        REQUIRE(std::get<0>(start_side) == 2);
+        REQUIRE(std::get<2>(start_side) == 0);
+        REQUIRE(std::get<0>(end_side) == 2);
+        REQUIRE(std::get<1>(end_side) == 1);
+        REQUIRE(std::get<2>(end_side) == one);
+        REQUIRE(shard.PathGetStep(1, 0, two).rel_id == 10);
+        REQUIRE(shard.PathGetStep(1, 1, three).node_id == four);
+        REQUIRE(shard.PathGetStep(1, 0, one).node_id == 0);
+        shard.PathFinish(1);
+        REQUIRE(shard.PathGetStep(1, 0, two).rel_id == 0);
+      }
+    }
+  }
+}
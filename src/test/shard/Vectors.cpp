@@ -0,0 +1,179 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../../lib/graph/Shard.h"
+#include <catch2/catch.hpp>
+
+SCENARIO( "Vectors are compared with each metric", "[vector]" ) {
+
+  GIVEN("Two vectors longer than a run of lanes") {
+    std::vector<float> left(19, 1.0F);
+    std::vector<float> right(19, 2.0F);
+
+    THEN("the distances are the negated dot product, one minus the cosine and the squared euclidean distance") {
+      REQUIRE(triton::VectorDistance(left.data(), right.data(), 19, triton::VectorMetric::DOT) == Approx(-38));
+      REQUIRE(triton::VectorDistance(left.data(), right.data(), 19, triton::VectorMetric::COSINE) == Approx(0).margin(1e-6));
+      REQUIRE(triton::VectorDistance(left.data(), right.data(), 19, triton::VectorMetric::L2) == Approx(19));
+    }
+
+    THEN("metrics are read from their names") {
+      triton::VectorMetric metric;
+      REQUIRE(triton::toVectorMetric("l2", metric));
+      REQUIRE(metric == triton::VectorMetric::L2);
+      REQUIRE(!triton::toVectorMetric("manhattan", metric));
+    }
+  }
+
+  GIVEN("Nearest neighbors kept for the two closest") {
+    triton::NearestNeighbors neighbors(2);
+    neighbors.add(1, 3.0);
+    neighbors.add(2, 1.0);
+    neighbors.add(3, 2.0);
+    neighbors.merge({{4, 0.5}, {5, 4.0}});
+
+    THEN("only the closest two are left, closest first") {
+      std::vector<triton::Neighbor> sorted = neighbors.sorted();
+      REQUIRE(sorted.size() == 2);
+      REQUIRE(sorted[0].id == 4);
+      REQUIRE(sorted[1].id == 2);
+    }
+  }
+}
+
+SCENARIO( "Properties keep arrays of numbers in vector columns", "[vector,properties]" ) {
+
+  GIVEN("A property store with an array set before its vector column was made") {
+    triton::Properties properties;
+    uint64_t first = properties.addRow();
+    uint64_t second = properties.addRow();
+    uint64_t third = properties.addRow();
+    properties.setProperty(first, "embedding", std::vector<double>({1.0, 0.0, 0.0}));
+
+    REQUIRE(properties.addVectorColumn("embedding", 3));
+    properties.setProperty(second, "embedding", std::vector<int64_t>({0, 1, 0}));
+    properties.setProperty(third, "embedding", std::vector<double>({1.0, 1.0}));
+
+    WHEN("the schema and the values are requested") {
+      THEN("the arrays of the right size are vectors and read back as arrays") {
+        REQUIRE(properties.getSchema().at("embedding") == triton::Properties::VECTOR);
+        REQUIRE(properties.getVectorDimensions("embedding") == 3);
+        REQUIRE(std::any_cast<std::vector<double>>(properties.getProperty(first, "embedding")) == std::vector<double>({1.0, 0.0, 0.0}));
+        REQUIRE(std::any_cast<std::vector<double>>(properties.getProperty(second, "embedding")) == std::vector<double>({0.0, 1.0, 0.0}));
+        REQUIRE(std::any_cast<std::vector<double>>(properties.getProperty(third, "embedding")) == std::vector<double>({1.0, 1.0}));
+      }
+    }
+
+    WHEN("the vector column is made again") {
+      THEN("only the same size is accepted") {
+        REQUIRE(properties.addVectorColumn("embedding", 3));
+        REQUIRE(!properties.addVectorColumn("embedding", 4));
+      }
+    }
+
+    WHEN("the nearest rows are searched") {
+      triton::NearestNeighbors neighbors(5);
+      properties.nearest("embedding", {0.9F, 0.1F, 0.0F}, triton::VectorMetric::L2, {}, neighbors);
+      std::vector<triton::Neighbor> sorted = neighbors.sorted();
+
+      THEN("vectors of another size are left out") {
+        REQUIRE(sorted.size() == 2);
+        REQUIRE(sorted[0].id == first);
+        REQUIRE(sorted[1].id == second);
+        double distance;
+        REQUIRE(properties.vectorDistance(second, "embedding", {0.0F, 1.0F, 0.0F}, triton::VectorMetric::L2, distance));
+        REQUIRE(distance == 0);
+        REQUIRE(!properties.vectorDistance(third, "embedding", {0.0F, 1.0F, 0.0F}, triton::VectorMetric::L2, distance));
+      }
+    }
+
+    WHEN("the store is written and read back") {
+      std::string buffer;
+      triton::Serializer serializer(buffer);
+      properties.write(serializer);
+      triton::Deserializer reader(buffer.data(), buffer.size());
+      triton::Properties restored;
+
+      THEN("the vectors come back") {
+        REQUIRE(restored.read(reader));
+        REQUIRE(restored.getVectorDimensions("embedding") == 3);
+        REQUIRE(std::any_cast<std::vector<double>>(restored.getProperty(second, "embedding")) == std::vector<double>({0.0, 1.0, 0.0}));
+      }
+    }
+  }
+}
+
+SCENARIO( "Shard finds the nodes with the closest vectors", "[vector,node]" ) {
+
+  GIVEN( "A shard with nodes that have embeddings" ) {
+    triton::Shard shard(4);
+    shard.NodeTypeInsert("Node", 1);
+    shard.NodeTypeInsert("User", 2);
+    uint64_t north = shard.NodeAdd("Node", 1, "north", R"({ "embedding":[0.0, 1.0], "score":10 })");
+    uint64_t east = shard.NodeAdd("Node", 1, "east", R"({ "embedding":[1, 0], "score":20 })");
+    uint64_t north_east = shard.NodeAdd("Node", 1, "north_east", R"({ "embedding":[0.7, 0.7], "score":30 })");
+    shard.NodeAdd("Node", 1, "flat", R"({ "embedding":[1.0, 1.0, 1.0] })");
+    shard.NodeAdd("User", 2, "max", R"({ "embedding":[0.0, 1.0] })");
+
+    REQUIRE(shard.NodeVectorPropertyCreate("Node", "embedding", 2));
+
+    WHEN( "the vector property is created again" ) {
+      THEN( "only the same size is accepted" ) {
+        REQUIRE(shard.NodeVectorPropertyCreate("Node", "embedding", 2));
+        REQUIRE(!shard.NodeVectorPropertyCreate("Node", "embedding", 3));
+        REQUIRE(!shard.NodeVectorPropertyCreate("Node", "score", 2));
+        REQUIRE(!shard.NodeVectorPropertyCreate("Unknown", "embedding", 2));
+      }
+    }
+
+    WHEN( "the nearest nodes of the type are searched" ) {
+      std::vector<triton::Neighbor> nearest = shard.NodesNearest("Node", "embedding", {0.1F, 1.0F}, 2, triton::VectorMetric::COSINE, {});
+
+      THEN( "the closest come back by node id, closest first" ) {
+        REQUIRE(nearest.size() == 2);
+        REQUIRE(nearest[0].id == north);
+        REQUIRE(nearest[1].id == north_east);
+        REQUIRE(shard.NodesNearest("User", "embedding", {0.1F, 1.0F}, 2, triton::VectorMetric::COSINE, {}).empty());
+        REQUIRE(shard.NodesNearest("Node", "embedding", {0.1F, 1.0F, 0.0F}, 2, triton::VectorMetric::COSINE, {}).empty());
+      }
+    }
+
+    WHEN( "the nearest nodes are searched with filters" ) {
+      std::vector<triton::ScanFilter> filters = { triton::ScanFilter("score", triton::ScanOperator::GT, int64_t(10)) };
+      std::vector<triton::Neighbor> nearest = shard.NodesNearest("Node", "embedding", {0.0F, 1.0F}, 3, triton::VectorMetric::L2, filters);
+
+      THEN( "only the nodes that pass every filter are ranked" ) {
+        REQUIRE(nearest.size() == 2);
+        REQUIRE(nearest[0].id == north_east);
+        REQUIRE(nearest[1].id == east);
+        REQUIRE(nearest[1].distance == Approx(2));
+      }
+    }
+
+    WHEN( "the nearest of a set of nodes are searched" ) {
+      Roaring64Map ids;
+      ids.add(east);
+      ids.add(north_east);
+      std::vector<triton::Neighbor> nearest = shard.NodesNearest(ids, "embedding", {0.0F, 1.0F}, 1, triton::VectorMetric::DOT);
+
+      THEN( "only those nodes are ranked" ) {
+        REQUIRE(nearest.size() == 1);
+        REQUIRE(nearest[0].id == north_east);
+        REQUIRE(nearest[0].distance == Approx(-0.7));
+      }
+    }
+  }
+}